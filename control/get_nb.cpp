@@ -1498,6 +1498,35 @@ magma_int_t magma_get_zbulge_mgpu_nb( magma_int_t n )
 }
 
 
+/******************************************************************************/
+// Shared by the c and z trevc3 heuristics: one thread per block of 128
+// eigenvectors (the trevc3 nbmax), once there are at least 2 blocks.
+static magma_int_t get_trevc3_nthread( magma_int_t n )
+{
+    magma_int_t nthread = 1;
+    if ( n >= 256 ) {
+        nthread = min( magma_get_parallel_numthreads(), magma_ceildiv( n, 128 ));
+    }
+    return max( nthread, 1 );
+}
+
+/// @return number of threads for the parallel back-transform in ctrevc3,
+/// or 1 for the single-threaded path.
+/// Limited by magma_get_parallel_numthreads() and by the number of blocks of
+/// 128 eigenvectors; n < 256 uses the single-threaded path.
+magma_int_t magma_get_ctrevc3_nthread( magma_int_t n )
+{
+    return get_trevc3_nthread( n );
+}
+
+/// @return number of threads for the parallel back-transform in ztrevc3,
+/// or 1 for the single-threaded path.
+/// @see magma_get_ctrevc3_nthread
+magma_int_t magma_get_ztrevc3_nthread( magma_int_t n )
+{
+    return get_trevc3_nthread( n );
+}
+
 // =============================================================================
 /// @}
 // end group magma_tuning
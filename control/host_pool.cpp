@@ -0,0 +1,703 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "host_pool.hpp"
+#include "magma_internal.h"
+
+// -----------------------------------------------------------------------------
+// constants
+
+static const unsigned int magma_block_live = 0x6d61676d;  // "magm"
+static const unsigned int magma_block_free = 0x66726565;  // "free"
+
+// per thread: blocks of classes up to 1 MiB, at most 64 per class, 4 MiB total
+static const size_t    thread_class_max = size_t(1) << 20;
+static const int       thread_count_max = 64;
+static const size_t    thread_cache_max = size_t(4) << 20;
+
+// per pool: at most 64 MiB in the central cache, beyond that blocks are freed
+static const long long central_cache_max = 64LL << 20;
+
+// shards report live bytes to the pool's peak tracking in batches of 64 KiB
+static const long long pending_max = 64LL << 10;
+
+static const size_t hugepage_size = size_t(2) << 20;
+
+static inline size_t hugepage_roundup( size_t bytes )
+{
+    return ((bytes + hugepage_size - 1) / hugepage_size) * hugepage_size;
+}
+
+// The tag ties a header to its address, so data in front of a foreign
+// pointer is not taken for a header, and a header copied elsewhere is not
+// valid there.
+static inline size_t magma_block_tag( const magma_block_header* block )
+{
+    return size_t( block ) ^ size_t( 0x9e3779b97f4a7c15ULL );
+}
+
+// Whether the 64 bytes in front of ptr are in the same page as ptr, and
+// ptr has the alignment of the pool's pointers, so its header can be read.
+static inline bool magma_block_readable( const void* ptr )
+{
+    return size_t( ptr ) % magma_block_header_size == 0
+        && size_t( ptr ) % magma_block_page_size >= magma_block_header_size;
+}
+
+
+/***************************************************************************//**
+    Blocks cached by one thread for one pool, and that thread's counters.
+    The destructor, run when the thread exits, hands cached blocks back to
+    the central cache and folds the counters into the pool's totals.
+*******************************************************************************/
+struct magma_pool_cache
+{
+    magma_host_pool*    pool;
+    magma_pool_shard*   shard;
+    magma_block_header* head [ magma_host_pool::nclasses ];
+    int                 count[ magma_host_pool::nclasses ];
+    size_t              bytes;
+
+    magma_pool_cache():
+        pool ( NULL ),
+        shard( NULL ),
+        bytes( 0 )
+    {
+        for (int k = 0; k < magma_host_pool::nclasses; ++k) {
+            head [k] = NULL;
+            count[k] = 0;
+        }
+    }
+
+    ~magma_pool_cache()
+    {
+        if ( pool != NULL ) {
+            flush_all();
+            pool->retire_shard( shard );
+        }
+    }
+
+    void attach( magma_host_pool* in_pool )
+    {
+        if ( pool == NULL ) {
+            pool  = in_pool;
+            shard = pool->new_shard();
+        }
+    }
+
+    // Keeps the first (most recently freed) keep blocks of class k,
+    // and moves the rest to the central cache.
+    void flush( int k, int keep, bool force )
+    {
+        magma_block_header** link = &head[k];
+        for (int i = 0; i < keep && *link != NULL; ++i) {
+            link = &(*link)->next;
+        }
+        magma_block_header* block = *link;
+        *link = NULL;
+        while ( block != NULL ) {
+            magma_block_header* next = block->next;
+            count[k] -= 1;
+            bytes    -= block->bytes;
+            pool->central_push( block, force );
+            block = next;
+        }
+        shard->cached.store( bytes, std::memory_order_relaxed );
+    }
+
+    void flush_all()
+    {
+        for (int k = 0; k < magma_host_pool::nclasses; ++k) {
+            flush( k, 0, true );
+        }
+    }
+};
+
+static thread_local magma_pool_cache g_pool_cache[ magma_host_pool::max_pools ];
+
+
+/******************************************************************************/
+// single-writer increment; readers on other threads only load
+static inline void shard_add( std::atomic< long long >& counter, long long value )
+{
+    counter.store( counter.load( std::memory_order_relaxed ) + value,
+                   std::memory_order_relaxed );
+}
+
+
+/***************************************************************************//**
+    Creates an empty pool.
+
+    @param[in] id       Index of the pool's thread caches; 0 <= id < max_pools.
+    @param[in] name     Name used in error messages, e.g., "CPU".
+    @param[in] alloc    Backing allocator; must return 64-byte aligned memory.
+    @param[in] free     Frees memory from alloc.
+*******************************************************************************/
+magma_host_pool::magma_host_pool(
+    int id, const char* name,
+    backing_alloc_t alloc, backing_free_t free ):
+    id__     ( id ),
+    name__   ( name ),
+    alloc__  ( alloc ),
+    free__   ( free ),
+    central_cached( 0 ),
+    live     ( 0 ),
+    peak     ( 0 ),
+    reset_nalloc( 0 ),
+    reset_nfree ( 0 ),
+    reset_time  ( magma_wtime() )
+{
+    assert( 0 <= id && id < max_pools );
+    for (int k = 0; k < nclasses; ++k) {
+        class_head[k] = NULL;
+    }
+    for (int i = 0; i < 4; ++i) {
+        retired[i] = 0;
+    }
+}
+
+
+/***************************************************************************//**
+    Maps size to its size class. Classes are 64 bytes, then 4 classes
+    per power of two, each a quarter of the power of two apart,
+    up to max_class. Rounding up wastes at most 25%.
+
+    @param[in]  size        Bytes requested.
+    @param[out] class_size  Bytes in a block of the class.
+    @return class index, or -1 if size > max_class.
+*******************************************************************************/
+int magma_host_pool::size_class( size_t size, size_t* class_size )
+{
+    if ( size <= 64 ) {
+        *class_size = 64;
+        return 0;
+    }
+    if ( size > max_class ) {
+        *class_size = size;
+        return -1;
+    }
+    // 2^e < size <= 2^(e+1), e >= 6
+    int e = 0;
+    for (size_t s = size - 1; s > 1; s >>= 1) {
+        e += 1;
+    }
+    size_t step = size_t(1) << (e - 2);
+    size_t k    = (size - 1 - (size_t(1) << e)) / step;  // 0, ..., 3
+    *class_size = (size_t(1) << e) + (k + 1)*step;
+    return int( 1 + (e - 6)*4 + k );
+}
+
+
+/***************************************************************************//**
+    @return 64-byte aligned block of at least size bytes, or NULL if the
+    backing allocator fails.
+*******************************************************************************/
+void* magma_host_pool::allocate( size_t size )
+{
+    magma_pool_cache& cache = g_pool_cache[ id__ ];
+    cache.attach( this );
+
+    size_t class_size;
+    int k = size_class( size, &class_size );
+
+    magma_block_header* block = NULL;
+    if ( k >= 0 ) {
+        if ( cache.head[k] != NULL ) {
+            block = cache.head[k];
+            cache.head[k]   = block->next;
+            cache.count[k] -= 1;
+            cache.bytes    -= block->bytes;
+            cache.shard->cached.store( cache.bytes, std::memory_order_relaxed );
+        }
+        else {
+            block = central_pop( k );
+        }
+    }
+    if ( block == NULL ) {
+        block = new_block( k, class_size );
+        if ( block == NULL ) {
+            return NULL;
+        }
+    }
+    block->magic = magma_block_live;
+    block->size  = size;
+    block->next  = NULL;
+
+    magma_pool_shard* shard = cache.shard;
+    shard_add( shard->nalloc, 1 );
+    shard_add( shard->bytes_alloc, size );
+    shard->pending += size;
+    if ( shard->pending >= pending_max ) {
+        flush_pending( shard );
+    }
+
+    void* ptr = (char*) block + magma_block_header_size;
+
+    #ifdef DEBUG_MEMORY
+    int s = (int)( (size_t(ptr) >> 6) % npointer_shards );
+    pointers_mutex[s].lock();
+    pointers[s][ ptr ] = size;
+    pointers_mutex[s].unlock();
+    #endif
+
+    return ptr;
+}
+
+
+/***************************************************************************//**
+    Returns ptr to the pool.
+    @return false if ptr was not allocated by this pool (e.g., by malloc),
+    in which case the caller must free it; true otherwise.
+    Ownership is checked with the tag in the block's header, which is read
+    only if it is in the same page as ptr (see magma_block_header), so the
+    memory in front of a foreign ptr is read only where it cannot fault.
+    No lock is taken unless the block moves to the central cache.
+    A second free of the same block, while the pool still holds it,
+    prints an error and is ignored.
+*******************************************************************************/
+bool magma_host_pool::deallocate( void* ptr )
+{
+    if ( ! magma_block_readable( ptr )) {
+        return false;
+    }
+    magma_block_header* block =
+        (magma_block_header*)( (char*) ptr - magma_block_header_size );
+    if ( block->tag != magma_block_tag( block ) || block->pool != id__ ) {
+        return false;
+    }
+    if ( block->magic == magma_block_free ) {
+        fprintf( stderr, "Error: %s memory %p freed twice.\n", name__, ptr );
+        return true;
+    }
+    if ( block->magic != magma_block_live ) {
+        return false;
+    }
+    block->magic = magma_block_free;
+
+    #ifdef DEBUG_MEMORY
+    int s = (int)( (size_t(ptr) >> 6) % npointer_shards );
+    pointers_mutex[s].lock();
+    pointers[s].erase( ptr );
+    pointers_mutex[s].unlock();
+    #endif
+
+    magma_pool_cache& cache = g_pool_cache[ id__ ];
+    cache.attach( this );
+
+    magma_pool_shard* shard = cache.shard;
+    shard_add( shard->nfree, 1 );
+    shard_add( shard->bytes_free, block->size );
+    shard->pending -= block->size;
+    if ( shard->pending <= -pending_max ) {
+        flush_pending( shard );
+    }
+
+    int k = block->klass;
+    if ( k < 0 ) {
+        backing_free( block );
+    }
+    else if ( block->bytes - magma_block_header_size <= thread_class_max ) {
+        block->next = cache.head[k];
+        cache.head[k]   = block;
+        cache.count[k] += 1;
+        cache.bytes    += block->bytes;
+        if ( cache.count[k] > thread_count_max || cache.bytes > thread_cache_max ) {
+            // keep the most recently freed half, which is likely still in cache
+            cache.flush( k, cache.count[k] / 2, false );
+        }
+        cache.shard->cached.store( cache.bytes, std::memory_order_relaxed );
+    }
+    else {
+        central_push( block, false );
+    }
+    return true;
+}
+
+
+/******************************************************************************/
+magma_block_header* magma_host_pool::central_pop( int k )
+{
+    std::lock_guard< std::mutex > lock( class_mutex[k] );
+    magma_block_header* block = class_head[k];
+    if ( block != NULL ) {
+        class_head[k] = block->next;
+        central_cached -= block->bytes;
+    }
+    return block;
+}
+
+
+/***************************************************************************//**
+    Adds block to the central cache of its class, or frees it if the central
+    cache is full, unless force is set (used when a thread exits, when the
+    backing allocator may no longer be usable).
+*******************************************************************************/
+void magma_host_pool::central_push( magma_block_header* block, bool force )
+{
+    if ( ! force && central_cached.load() + (long long) block->bytes > central_cache_max ) {
+        backing_free( block );
+        return;
+    }
+    int k = block->klass;
+    std::lock_guard< std::mutex > lock( class_mutex[k] );
+    block->next = class_head[k];
+    class_head[k] = block;
+    central_cached += block->bytes;
+}
+
+
+/***************************************************************************//**
+    @return new block of class k from the backing allocator, or NULL.
+    If the user pointer of the allocation would be page aligned, it is
+    allocated again with room to move the header by 64 bytes, so the header
+    is in the page of the user pointer (see magma_block_header).
+*******************************************************************************/
+magma_block_header* magma_host_pool::new_block( int k, size_t class_size )
+{
+    int mapped = 0;
+    size_t bytes = class_size + magma_block_header_size;
+    size_t shift = 0;
+    char* base = (char*) alloc__( bytes, &mapped );
+    if ( base != NULL && ! magma_block_readable( base + magma_block_header_size )) {
+        free__( base, bytes, mapped );
+        bytes += magma_block_header_size;
+        base = (char*) alloc__( bytes, &mapped );
+        if ( base != NULL && ! magma_block_readable( base + magma_block_header_size )) {
+            shift = magma_block_header_size;
+        }
+    }
+    if ( base == NULL ) {
+        return NULL;
+    }
+    magma_block_header* block = (magma_block_header*)( base + shift );
+    block->klass  = k;
+    block->bytes  = bytes;
+    block->pool   = id__;
+    block->mapped = mapped;
+    block->shift  = shift;
+    block->tag    = magma_block_tag( block );
+    return block;
+}
+
+
+/******************************************************************************/
+void magma_host_pool::backing_free( magma_block_header* block )
+{
+    // a stale header in memory reused by malloc must not look valid
+    char*  base   = (char*) block - block->shift;
+    size_t bytes  = block->bytes;
+    int    mapped = block->mapped;
+    block->tag   = 0;
+    block->magic = 0;
+    free__( base, bytes, mapped );
+}
+
+
+/***************************************************************************//**
+    Returns the calling thread's cached blocks and all centrally cached
+    blocks to the backing allocator. Blocks cached by other threads are kept.
+    Called by magma_finalize.
+*******************************************************************************/
+void magma_host_pool::release()
+{
+    magma_pool_cache& cache = g_pool_cache[ id__ ];
+    if ( cache.pool != NULL ) {
+        cache.flush_all();
+    }
+    for (int k = 0; k < nclasses; ++k) {
+        magma_block_header* block;
+        {
+            std::lock_guard< std::mutex > lock( class_mutex[k] );
+            block = class_head[k];
+            class_head[k] = NULL;
+        }
+        while ( block != NULL ) {
+            magma_block_header* next = block->next;
+            central_cached -= block->bytes;
+            backing_free( block );
+            block = next;
+        }
+    }
+}
+
+
+/******************************************************************************/
+magma_pool_shard* magma_host_pool::new_shard()
+{
+    magma_pool_shard* shard = new magma_pool_shard;
+    shard->nalloc      = 0;
+    shard->nfree       = 0;
+    shard->bytes_alloc = 0;
+    shard->bytes_free  = 0;
+    shard->cached      = 0;
+    shard->pending     = 0;
+
+    std::lock_guard< std::mutex > lock( shard_mutex );
+    shards.push_back( shard );
+    return shard;
+}
+
+
+/******************************************************************************/
+void magma_host_pool::retire_shard( magma_pool_shard* shard )
+{
+    flush_pending( shard );
+
+    std::lock_guard< std::mutex > lock( shard_mutex );
+    retired[0] += shard->nalloc;
+    retired[1] += shard->nfree;
+    retired[2] += shard->bytes_alloc;
+    retired[3] += shard->bytes_free;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        if ( shards[i] == shard ) {
+            shards.erase( shards.begin() + i );
+            break;
+        }
+    }
+    delete shard;
+}
+
+
+/***************************************************************************//**
+    Adds the shard's pending live bytes to the pool-wide count and updates
+    the high-water mark. Batching keeps the shared atomic off the common
+    path, at the cost of peak_bytes missing up to pending_max per thread.
+*******************************************************************************/
+void magma_host_pool::flush_pending( magma_pool_shard* shard )
+{
+    long long now = live.fetch_add( shard->pending ) + shard->pending;
+    shard->pending = 0;
+    long long old = peak.load();
+    while ( now > old && ! peak.compare_exchange_weak( old, now )) {
+        // old updated by compare_exchange_weak
+    }
+}
+
+
+/***************************************************************************//**
+    Sums the counters of all threads.
+*******************************************************************************/
+void magma_host_pool::get_stats( magma_mem_stats_t* stats )
+{
+    long long nalloc, nfree, bytes_alloc, bytes_free, cached;
+    double    t0;
+    {
+        std::lock_guard< std::mutex > lock( shard_mutex );
+        nalloc      = retired[0];
+        nfree       = retired[1];
+        bytes_alloc = retired[2];
+        bytes_free  = retired[3];
+        cached      = central_cached.load();
+        for (size_t i = 0; i < shards.size(); ++i) {
+            nalloc      += shards[i]->nalloc     .load( std::memory_order_relaxed );
+            nfree       += shards[i]->nfree      .load( std::memory_order_relaxed );
+            bytes_alloc += shards[i]->bytes_alloc.load( std::memory_order_relaxed );
+            bytes_free  += shards[i]->bytes_free .load( std::memory_order_relaxed );
+            cached      += shards[i]->cached     .load( std::memory_order_relaxed );
+        }
+        nalloc -= reset_nalloc;
+        nfree  -= reset_nfree;
+        t0      = reset_time;
+    }
+    long long live_bytes = max( 0LL, bytes_alloc - bytes_free );
+    double    elapsed    = magma_wtime() - t0;
+
+    stats->live_bytes   = size_t( live_bytes );
+    stats->peak_bytes   = size_t( max( peak.load(), live_bytes ));
+    stats->cached_bytes = size_t( max( 0LL, cached ));
+    stats->nalloc       = size_t( nalloc );
+    stats->nfree        = size_t( nfree );
+    stats->alloc_rate   = (elapsed > 0 ? nalloc / elapsed : 0);
+}
+
+
+/***************************************************************************//**
+    Restarts nalloc, nfree, alloc_rate, and peak_bytes from now.
+*******************************************************************************/
+void magma_host_pool::reset_stats()
+{
+    magma_mem_stats_t stats;
+    get_stats( &stats );
+
+    std::lock_guard< std::mutex > lock( shard_mutex );
+    reset_nalloc += stats.nalloc;
+    reset_nfree  += stats.nfree;
+    reset_time    = magma_wtime();
+    peak.store( stats.live_bytes );
+}
+
+
+#ifdef DEBUG_MEMORY
+/***************************************************************************//**
+    Adds the pool's live blocks to pointers, for magma_warn_leaks.
+*******************************************************************************/
+void magma_host_pool::get_pointers( std::map< void*, size_t >& in_pointers )
+{
+    for (int s = 0; s < npointer_shards; ++s) {
+        std::lock_guard< std::mutex > lock( pointers_mutex[s] );
+        in_pointers.insert( pointers[s].begin(), pointers[s].end() );
+    }
+}
+#endif
+
+
+// =============================================================================
+// CPU pool
+
+/******************************************************************************/
+// Set MAGMA_HUGEPAGES=1 in the environment to back CPU blocks of 2 MiB or
+// more with transparent huge pages (Linux only).
+static bool magma_use_hugepages()
+{
+    static const bool use = []() {
+        const char* str = getenv( "MAGMA_HUGEPAGES" );
+        return str != NULL && atoi( str ) > 0;
+    }();
+    return use;
+}
+
+
+/******************************************************************************/
+static void* magma_cpu_backing_alloc( size_t bytes, int* mapped )
+{
+    *mapped = 0;
+    #if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if ( bytes >= hugepage_size && magma_use_hugepages() ) {
+        size_t len = hugepage_roundup( bytes );
+        void* ptr = mmap( NULL, len, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+        if ( ptr != MAP_FAILED ) {
+            madvise( ptr, len, MADV_HUGEPAGE );
+            *mapped = 1;
+            return ptr;
+        }
+        // else fall back to posix_memalign
+    }
+    #endif
+
+    void* ptr;
+    #if defined( _WIN32 ) || defined( _WIN64 )
+    ptr = _aligned_malloc( bytes, 64 );
+    #else
+    if ( posix_memalign( &ptr, 64, bytes ) != 0 ) {
+        ptr = NULL;
+    }
+    #endif
+    return ptr;
+}
+
+
+/******************************************************************************/
+static void magma_cpu_backing_free( void* ptr, size_t bytes, int mapped )
+{
+    #if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if ( mapped ) {
+        munmap( ptr, hugepage_roundup( bytes ));
+        return;
+    }
+    #endif
+    MAGMA_UNUSED( bytes );
+    MAGMA_UNUSED( mapped );
+
+    #if defined( _WIN32 ) || defined( _WIN64 )
+    _aligned_free( ptr );
+    #else
+    free( ptr );
+    #endif
+}
+
+
+/***************************************************************************//**
+    @return pool behind magma_malloc_cpu. Never deleted, so it outlives
+    the thread caches of every thread, including the main thread's.
+*******************************************************************************/
+magma_host_pool* magma_host_pool_cpu()
+{
+    static magma_host_pool* pool = new magma_host_pool(
+        0, "CPU", magma_cpu_backing_alloc, magma_cpu_backing_free );
+    return pool;
+}
+
+
+// =============================================================================
+// C interface
+
+/***************************************************************************//**
+    Gets counters for memory from magma_malloc_cpu(): live and peak bytes,
+    bytes cached in the pool, and the number and rate of allocations.
+    Counters are kept per thread and summed here, so they are cheap enough
+    to leave on in production. peak_bytes may miss up to 64 KiB per thread.
+
+    @param[out]
+    stats   On output, the counters.
+
+    @return MAGMA_SUCCESS
+
+    @ingroup magma_malloc_cpu
+*******************************************************************************/
+extern "C" magma_int_t
+magma_mem_stats_cpu( magma_mem_stats_t* stats )
+{
+    magma_host_pool_cpu()->get_stats( stats );
+    return MAGMA_SUCCESS;
+}
+
+
+/***************************************************************************//**
+    Gets counters for memory from magma_malloc_pinned();
+    see magma_mem_stats_cpu().
+
+    @param[out]
+    stats   On output, the counters.
+
+    @return MAGMA_SUCCESS
+
+    @ingroup magma_malloc_pinned
+*******************************************************************************/
+extern "C" magma_int_t
+magma_mem_stats_pinned( magma_mem_stats_t* stats )
+{
+    magma_host_pool_pinned()->get_stats( stats );
+    return MAGMA_SUCCESS;
+}
+
+
+/***************************************************************************//**
+    Restarts the allocation counts, rate, and peak of both the CPU and
+    pinned pools from the current time and live bytes.
+
+    @ingroup magma_malloc_cpu
+*******************************************************************************/
+extern "C" void
+magma_mem_stats_reset()
+{
+    magma_host_pool_cpu()   ->reset_stats();
+    magma_host_pool_pinned()->reset_stats();
+}
+
+
+/***************************************************************************//**
+    Frees blocks that magma_free_cpu() and magma_free_pinned() kept cached
+    for reuse. Blocks cached by threads other than the caller are kept
+    until those threads exit. Called by magma_finalize().
+
+    @ingroup magma_malloc_cpu
+*******************************************************************************/
+extern "C" void
+magma_mem_pool_release()
+{
+    magma_host_pool_cpu()   ->release();
+    magma_host_pool_pinned()->release();
+}
@@ -0,0 +1,152 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+
+#ifndef MAGMA_HOST_POOL_HPP
+#define MAGMA_HOST_POOL_HPP
+
+#include <atomic>
+#include <mutex>  // requires C++11
+#include <vector>
+
+#ifdef DEBUG_MEMORY
+#include <map>
+#endif
+
+#include "magma_v2.h"  // not magma_internal.h, so this can precede other STL headers
+
+
+/***************************************************************************//**
+    Header in front of every block handed out by a magma_host_pool.
+    It occupies one 64-byte cache line, so the user pointer that follows
+    keeps the 64-byte alignment of the backing allocation.
+    The user pointer is never page aligned, so the header is in the same
+    page as the user pointer, and deallocate can read the header in front
+    of any pointer that is not page aligned without faulting.
+    @ingroup magma_malloc_cpu
+*******************************************************************************/
+struct magma_block_header
+{
+    unsigned int         magic;  ///<  magma_block_live or magma_block_free
+    int                  klass;  ///<  size class, or -1 if not pooled
+    size_t               size;   ///<  bytes requested by the user
+    size_t               bytes;  ///<  bytes of the backing allocation, incl. header
+    magma_block_header*  next;   ///<  free list link while cached
+    int                  pool;   ///<  id of the owning pool
+    int                  mapped; ///<  backing allocation flag, e.g., from mmap
+    size_t               shift;  ///<  offset of the header in the backing allocation
+    size_t               tag;    ///<  address of the header, scrambled; see magma_block_tag
+};
+
+const size_t magma_block_header_size = 64;
+
+// smallest page size of the supported systems
+const size_t magma_block_page_size = 4096;
+
+
+/***************************************************************************//**
+    Per-thread counters of one pool. Only the owning thread writes them,
+    so updates are relaxed stores with no read-modify-write; readers sum
+    over all threads.
+    @ingroup magma_malloc_cpu
+*******************************************************************************/
+struct magma_pool_shard
+{
+    std::atomic< long long > nalloc;
+    std::atomic< long long > nfree;
+    std::atomic< long long > bytes_alloc;
+    std::atomic< long long > bytes_free;
+    std::atomic< long long > cached;  ///<  bytes in this thread's cache
+    long long                pending; ///<  live bytes not yet added to the pool's peak tracking
+};
+
+
+/***************************************************************************//**
+    Size-class pool of 64-byte aligned host blocks, with a cache per thread
+    in front of a central cache per size class. Blocks larger than the
+    largest class go straight to the backing allocator.
+    Used by magma_malloc_cpu and magma_malloc_pinned, which differ only in
+    their backing allocators.
+    @ingroup magma_malloc_cpu
+*******************************************************************************/
+class magma_host_pool
+{
+public:
+    /// Returns 64-byte aligned memory of at least bytes, or NULL;
+    /// may set *mapped for the matching backing_free_t.
+    typedef void* (*backing_alloc_t)( size_t bytes, int* mapped );
+    typedef void  (*backing_free_t) ( void* ptr, size_t bytes, int mapped );
+
+    static const int    max_pools     = 2;  ///<  CPU and pinned
+    static const int    nclasses      = 65; ///<  64 bytes to 4 MiB, 4 classes per power of 2
+    static const size_t max_class     = size_t(4) << 20;
+
+    magma_host_pool( int id, const char* name,
+                     backing_alloc_t alloc, backing_free_t free );
+
+    void* allocate( size_t size );
+    bool  deallocate( void* ptr );
+    void  release();
+
+    void  get_stats( magma_mem_stats_t* stats );
+    void  reset_stats();
+
+    #ifdef DEBUG_MEMORY
+    void  get_pointers( std::map< void*, size_t >& pointers );
+    #endif
+
+    const char* name() const { return name__; }
+
+protected:
+    friend struct magma_pool_cache;
+
+    static int size_class( size_t size, size_t* class_size );
+
+    magma_block_header* new_block   ( int klass, size_t class_size );
+    magma_block_header* central_pop ( int klass );
+    void                central_push( magma_block_header* block, bool force );
+    void                backing_free( magma_block_header* block );
+
+    magma_pool_shard*   new_shard();
+    void                retire_shard( magma_pool_shard* shard );
+    void                flush_pending( magma_pool_shard* shard );
+
+private:
+    int                 id__;
+    const char*         name__;
+    backing_alloc_t     alloc__;
+    backing_free_t      free__;
+
+    // central cache, one lock per size class
+    std::mutex          class_mutex[ nclasses ];
+    magma_block_header* class_head [ nclasses ];
+    std::atomic< long long > central_cached;  ///<  bytes in central cache
+
+    // live-byte high-water mark, from shards' batched deltas
+    std::atomic< long long > live;
+    std::atomic< long long > peak;
+
+    // shards of threads that are running, and totals of those that exited
+    std::mutex                       shard_mutex;
+    std::vector< magma_pool_shard* > shards;
+    long long                        retired[4];  ///<  nalloc, nfree, bytes_alloc, bytes_free
+    long long                        reset_nalloc;
+    long long                        reset_nfree;
+    double                           reset_time;
+
+    #ifdef DEBUG_MEMORY
+    static const int npointer_shards = 16;
+    std::mutex                pointers_mutex[ npointer_shards ];
+    std::map< void*, size_t > pointers      [ npointer_shards ];
+    #endif
+};
+
+
+magma_host_pool* magma_host_pool_cpu();
+magma_host_pool* magma_host_pool_pinned();  // defined with the backend's alloc.cpp
+
+#endif        //  #ifndef MAGMA_HOST_POOL_HPP
@@ -0,0 +1,346 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       Hardware counters (cycles, instructions, LLC misses, flops) via Linux
+       perf_event_open, without PAPI. See magma_counters_t in magma_timer.h.
+*/
+#include <string.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "magma_internal.h"
+#include "magma_timer.h"
+
+#if defined(__linux__)
+
+// -----------------------------------------------------------------------------
+// Which magma_counters_t field an event adds to.
+enum {
+    Cycles = 0,
+    Instructions,
+    LLCMisses,
+    FpOps,
+    NumFields
+};
+
+struct counter_event {
+    uint32_t  type;
+    uint64_t  config;
+    int       field;
+    long long weight;   // e.g., flops per packed instruction
+};
+
+// Open counter: file descriptor and index into g_events.
+struct counter_fd {
+    int fd;
+    int event;
+};
+
+static std::vector< counter_event > g_events;
+static std::vector< counter_fd >    g_fds;     // all threads' counters
+static std::mutex g_fds_mutex;
+static std::mutex g_init_mutex;
+static bool       g_init = false;
+static bool       g_have[ NumFields ];         // opened on the initial thread
+
+// > 0 while the counters are open; a new value for each magma_counters_init,
+// so magma_counters_open_thread() opens them again after a finalize
+static std::atomic< int > g_epoch( 0 );
+static int        g_ninit = 0;
+
+
+// -----------------------------------------------------------------------------
+// Returns vendor_id from /proc/cpuinfo, e.g., "GenuineIntel", or "".
+static std::string cpu_vendor()
+{
+    std::string vendor;
+    FILE* f = fopen( "/proc/cpuinfo", "r" );
+    if ( f != NULL ) {
+        char line[ 1024 ];
+        while( fgets( line, sizeof(line), f ) != NULL ) {
+            if ( strncmp( line, "vendor_id", 9 ) == 0 ) {
+                char* val = strchr( line, ':' );
+                if ( val != NULL ) {
+                    val += strspn( val + 1, " \t" ) + 1;
+                    val[ strcspn( val, "\n" ) ] = '\0';
+                    vendor = val;
+                }
+                break;
+            }
+        }
+        fclose( f );
+    }
+    return vendor;
+}
+
+
+// -----------------------------------------------------------------------------
+// Sets g_events. Cycles, instructions, and cache misses are generic perf
+// events (cache misses map to LLC misses on x86); flops need raw events.
+static void setup_events()
+{
+    counter_event generic[] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES,   Cycles,       1 },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, Instructions, 1 },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, LLCMisses,    1 },
+    };
+    g_events.assign( generic, generic + 3 );
+
+    std::string vendor = cpu_vendor();
+    if ( vendor == "GenuineIntel" ) {
+        // FP_ARITH_INST_RETIRED (event 0xc7), by umask: scalar double and
+        // single, then 128, 256, 512-bit packed double and single.
+        // It counts FMA twice, so weights are flops per instruction.
+        const uint64_t umask [] = { 0x03, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+        const long long weight[] = {    1,    2,    4,    4,    8,    8,   16 };
+        for( int i = 0; i < 7; ++i ) {
+            counter_event e = { PERF_TYPE_RAW, (umask[i] << 8) | 0xc7, FpOps, weight[i] };
+            g_events.push_back( e );
+        }
+    }
+    else if ( vendor == "AuthenticAMD" ) {
+        // RETIRED_SSE_AVX_FLOPS (event 0x03, all umasks) counts flops directly
+        counter_event e = { PERF_TYPE_RAW, 0xff03, FpOps, 1 };
+        g_events.push_back( e );
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+// Opens all events for the calling thread and adds them to g_fds.
+// Without inherit, each counter counts only its own thread, so no thread is
+// counted twice; a thread's counters stay readable after it exits.
+// Events the kernel or CPU does not support are skipped.
+static void open_thread( bool* have )
+{
+    for( size_t i = 0; i < g_events.size(); ++i ) {
+        struct perf_event_attr attr;
+        memset( &attr, 0, sizeof(attr) );
+        attr.size           = sizeof(attr);
+        attr.type           = g_events[i].type;
+        attr.config         = g_events[i].config;
+        attr.inherit        = 0;
+        attr.exclude_kernel = 1;  // allowed with perf_event_paranoid <= 2
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED
+                            | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        int fd = int( syscall( __NR_perf_event_open, &attr, 0, -1, -1, 0 ));
+        if ( fd < 0 )
+            continue;
+
+        counter_fd cfd = { fd, int(i) };
+        std::lock_guard< std::mutex > lock( g_fds_mutex );
+        g_fds.push_back( cfd );
+        if ( have != NULL ) {
+            have[ g_events[i].field ] = true;
+        }
+    }
+}
+
+#endif  // __linux__
+
+
+/***************************************************************************//**
+    Opens the hardware counters read by magma_counters_read(), on the calling
+    thread and on each OpenMP thread. The workers of the MAGMA thread pool
+    (bulge chasing, applying Q2, trevc) open their own counters before their
+    next job; see magma_counters_open_thread().
+    Other threads are not counted: OpenMP threads created later, e.g., for a
+    larger number of threads, and threads created directly with pthreads.
+    So call this early, before running multi-threaded code; testers call it
+    for --counters. Otherwise it is called on first use. Calling it again
+    does nothing.
+
+    Counters not supported by the CPU, kernel, or perf_event_paranoid setting
+    read as -1. On non-Linux systems, all counters read as -1.
+
+    @return MAGMA_SUCCESS if any counter is available,
+            MAGMA_ERR_NOT_SUPPORTED otherwise.
+
+    @ingroup magma_timer
+*******************************************************************************/
+extern "C"
+magma_int_t magma_counters_init()
+{
+    #if defined(__linux__)
+    std::lock_guard< std::mutex > lock( g_init_mutex );
+    if ( ! g_init ) {
+        g_init = true;
+        setup_events();
+
+        // open on the OpenMP threads first, which creates them if needed,
+        // so the calling thread's counters don't also inherit them
+        #ifdef _OPENMP
+        #pragma omp parallel
+        {
+            if ( omp_get_thread_num() != 0 ) {
+                open_thread( NULL );
+            }
+        }
+        #endif
+        open_thread( g_have );
+        g_ninit += 1;
+        g_epoch.store( g_ninit, std::memory_order_release );
+    }
+    for( int i = 0; i < NumFields; ++i ) {
+        if ( g_have[i] )
+            return MAGMA_SUCCESS;
+    }
+    #endif
+    return MAGMA_ERR_NOT_SUPPORTED;
+}
+
+
+/***************************************************************************//**
+    Closes the hardware counters. A later magma_counters_read() reopens them.
+
+    @ingroup magma_timer
+*******************************************************************************/
+extern "C"
+void magma_counters_finalize()
+{
+    #if defined(__linux__)
+    std::lock_guard< std::mutex > lock( g_init_mutex );
+    std::lock_guard< std::mutex > lock_fds( g_fds_mutex );
+    for( size_t i = 0; i < g_fds.size(); ++i ) {
+        close( g_fds[i].fd );
+    }
+    g_fds.clear();
+    g_events.clear();
+    memset( g_have, 0, sizeof(g_have) );
+    g_init = false;
+    g_epoch.store( 0, std::memory_order_release );
+    #endif
+}
+
+
+/***************************************************************************//**
+    Opens the hardware counters on the calling thread, if they are open
+    (see magma_counters_init) and not yet opened on this thread. Long-lived
+    worker threads call it before each job, e.g., the MAGMA thread pool
+    workers, so their counts are read while they run; it costs one atomic
+    load if there is nothing to do.
+
+    @ingroup magma_timer
+*******************************************************************************/
+extern "C"
+void magma_counters_open_thread()
+{
+    #if defined(__linux__)
+    static thread_local int t_epoch = 0;
+    int epoch = g_epoch.load( std::memory_order_acquire );
+    if ( epoch == 0 || epoch == t_epoch ) {
+        return;
+    }
+    std::lock_guard< std::mutex > lock( g_init_mutex );
+    if ( g_epoch.load( std::memory_order_relaxed ) == epoch ) {
+        open_thread( NULL );
+    }
+    t_epoch = epoch;
+    #endif
+}
+
+
+/***************************************************************************//**
+    @param[out]
+    counters    Current hardware counters, summed over all counted threads;
+                see magma_counters_init(). Unavailable counters are -1.
+                Counters that the kernel multiplexed are scaled up by
+                (time enabled / time running), so are estimates.
+
+    Use differences of two reads; see counters_start() and counters_stop().
+
+    @ingroup magma_timer
+*******************************************************************************/
+extern "C"
+void magma_counters_read( magma_counters_t* counters )
+{
+    long long sum[ 4 ] = { -1, -1, -1, -1 };
+
+    #if defined(__linux__)
+    if ( ! g_init ) {
+        magma_counters_init();
+    }
+
+    std::lock_guard< std::mutex > lock( g_fds_mutex );
+    for( size_t i = 0; i < g_fds.size(); ++i ) {
+        // value, time enabled, time running
+        uint64_t buf[ 3 ];
+        if ( read( g_fds[i].fd, buf, sizeof(buf) ) != sizeof(buf) )
+            continue;
+        const counter_event& e = g_events[ g_fds[i].event ];
+        double value = double( buf[0] );
+        if ( buf[2] > 0 && buf[2] < buf[1] ) {
+            value *= double( buf[1] ) / double( buf[2] );
+        }
+        if ( sum[ e.field ] < 0 ) {
+            sum[ e.field ] = 0;
+        }
+        sum[ e.field ] += (long long)( value ) * e.weight;
+    }
+    #endif
+
+    counters->cycles       = sum[0];
+    counters->instructions = sum[1];
+    counters->llc_misses   = sum[2];
+    counters->fp_ops       = sum[3];
+}
+
+
+/***************************************************************************//**
+    Formats the rates derived from counters measured over time seconds:
+    achieved Gflop/s (from fp_ops), bytes/flop (LLC misses times 64 byte
+    lines, i.e., memory traffic, per flop), and instructions per cycle.
+    Unavailable rates are printed as "--".
+
+    @param[out]
+    str         Output string.
+
+    @param[in]
+    size        Size of str.
+
+    @param[in]
+    counters    Counts in the measured interval, as from counters_stop().
+
+    @param[in]
+    time        Time of the measured interval, in seconds.
+
+    @return As snprintf.
+
+    @ingroup magma_timer
+*******************************************************************************/
+extern "C"
+int magma_counters_snprintf( char* str, size_t size,
+                             const magma_counters_t* counters, double time )
+{
+    char gflops[ 32 ] = "--", bpf[ 32 ] = "--", ipc[ 32 ] = "--";
+    const magma_counters_t& c = *counters;
+    if ( c.fp_ops >= 0 && time > 0 ) {
+        snprintf( gflops, sizeof(gflops), "%.2f", c.fp_ops / time * 1e-9 );
+    }
+    if ( c.fp_ops > 0 && c.llc_misses >= 0 ) {
+        snprintf( bpf, sizeof(bpf), "%.3f", 64. * c.llc_misses / c.fp_ops );
+    }
+    if ( c.cycles > 0 && c.instructions >= 0 ) {
+        snprintf( ipc, sizeof(ipc), "%.2f", double( c.instructions ) / c.cycles );
+    }
+    return snprintf( str, size, "%.4f sec, %s Gflop/s, %s bytes/flop, %s IPC",
+                     time, gflops, bpf, ipc );
+}
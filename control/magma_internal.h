@@ -65,8 +65,14 @@
 #include "magma_operators.h"
 #include "magma_threadsetting.h"
 
+#ifdef MAGMA_HAVE_HOST
+// in-order CPU execution context; see interface_host/host_stream.hpp
+struct magma_host_stream;
+#endif
+
 /***************************************************************************//**
-    Define magma_queue structure, which wraps around CUDA and OpenCL queues.
+    Define magma_queue structure, which wraps around CUDA and OpenCL queues,
+    or a magma_host_stream in the host backend.
     In C, this is a simple struct.
     In C++, it is a class with getter member functions.
     For both C/C++, use magma_queue_create() and magma_queue_destroy()
@@ -129,6 +135,11 @@ public:
 
     #endif
 
+    #ifdef MAGMA_HAVE_HOST
+    /// @return host execution context associated with this queue; requires host backend.
+    magma_host_stream* host_stream()   { return stream__; }
+    #endif
+
 
     /// @return the pointer array dAarray__.
     void** get_dAarray() {
@@ -209,6 +220,10 @@ protected:
     hipsparseHandle_t hipsparse__;
 
     #endif
+
+    #ifdef MAGMA_HAVE_HOST
+    magma_host_stream* stream__;    // worker thread and task FIFO
+    #endif
 };
 
 #ifdef __cplusplus
@@ -0,0 +1,144 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       Counter-based random numbers, Philox4x32-10, from
+       Salmon, Moraes, Dror, Shaw, Parallel random numbers: as easy as 1, 2, 3,
+       SC 2011. Used by magma_zlarnv.
+*/
+
+#ifndef MAGMA_PHILOX_H
+#define MAGMA_PHILOX_H
+
+#include <stdint.h>
+#include <math.h>
+
+#include "magma_v2.h"
+
+/***************************************************************************//**
+    Philox4x32-10 bijection: replaces the 128-bit counter ctr with 128 random
+    bits, which depend only on ctr and the 64-bit key.
+*******************************************************************************/
+static inline void magma_philox4x32(
+    uint32_t ctr[4], uint32_t key0, uint32_t key1 )
+{
+    for (int round = 0; round < 10; ++round) {
+        uint64_t p0 = uint64_t( 0xD2511F53 ) * ctr[0];
+        uint64_t p1 = uint64_t( 0xCD9E8D57 ) * ctr[2];
+        uint32_t c0 = uint32_t( p1 >> 32 ) ^ ctr[1] ^ key0;
+        uint32_t c2 = uint32_t( p0 >> 32 ) ^ ctr[3] ^ key1;
+        ctr[0] = c0;
+        ctr[1] = uint32_t( p1 );
+        ctr[2] = c2;
+        ctr[3] = uint32_t( p0 );
+        key0 += 0x9E3779B9;
+        key1 += 0xBB67AE85;
+    }
+}
+
+
+/***************************************************************************//**
+    @return uniform in (0, 1) from 2 random words, with 53 random bits.
+*******************************************************************************/
+static inline double magma_philox_uniform( uint32_t hi, uint32_t lo )
+{
+    uint64_t bits = (uint64_t( hi ) << 21) ^ (lo >> 11);
+    return (double( bits ) + 0.5) * (1. / 9007199254740992.);  // 2^53
+}
+
+
+/***************************************************************************//**
+    Sets the Philox key from LAPACK's iseed (4 integers in [0, 4095]).
+*******************************************************************************/
+static inline void magma_philox_key(
+    const magma_int_t iseed[4], uint32_t* key0, uint32_t* key1 )
+{
+    uint64_t seed = ((uint64_t( iseed[0] ) * 4096 + uint64_t( iseed[1] )) * 4096
+                    + uint64_t( iseed[2] )) * 4096 + uint64_t( iseed[3] );
+    *key0 = uint32_t( seed );
+    *key1 = uint32_t( seed >> 32 );
+}
+
+
+/***************************************************************************//**
+    Replaces iseed with a new seed that depends only on iseed, so the next
+    fill uses a different stream. Keeps iseed valid for LAPACK's larnv:
+    entries in [0, 4095], iseed[3] odd.
+*******************************************************************************/
+static inline void magma_philox_next_seed( magma_int_t iseed[4] )
+{
+    uint32_t key0, key1;
+    magma_philox_key( iseed, &key0, &key1 );
+    uint32_t ctr[4] = { 0, 0, 0, 0xffffffff };  // counter not used by fills
+    magma_philox4x32( ctr, key0, key1 );
+    for (int i = 0; i < 4; ++i) {
+        iseed[i] = ctr[i] % 4096;
+    }
+    iseed[3] |= 1;
+}
+
+
+/***************************************************************************//**
+    Sets x[i] = component r0 + i of the stream given by key, for i < len.
+
+    Each 128-bit counter c yields 2 uniforms, u1 and u2, which make
+    components 2c and 2c+1, so a complex entry (re, im) is a pair of
+    components, as in zlarnv:
+        idist 1: u1, u2, uniform (0, 1)
+        idist 2: 2 u1 - 1, 2 u2 - 1, uniform (-1, 1)
+        idist 3: R cos(2 pi u2), R sin(2 pi u2), with R = sqrt( -2 log(u1) );
+                 normal (0, 1) by Box-Muller.
+    Values are computed in double, so float streams equal double streams
+    rounded. Blocks of counters are generated in SIMD-friendly loops.
+*******************************************************************************/
+template< typename real_t >
+void magma_philox_fill(
+    magma_int_t idist, uint32_t key0, uint32_t key1,
+    uint64_t r0, int64_t len, real_t* x )
+{
+    const double twopi = 6.2831853071795864769;
+    const int nb = 128;  // components per block
+    double u1[ nb/2 + 1 ], u2[ nb/2 + 1 ];
+
+    for (int64_t i0 = 0; i0 < len; i0 += nb) {
+        int ib = int( len - i0 < nb ? len - i0 : nb );
+        uint64_t r_first = r0 + i0;
+        uint64_t c_first = r_first >> 1;
+        int nc = int( ((r_first + ib - 1) >> 1) - c_first + 1 );
+
+        #pragma omp simd
+        for (int c = 0; c < nc; ++c) {
+            uint64_t k = c_first + c;
+            uint32_t ctr[4] = { uint32_t( k ), uint32_t( k >> 32 ), 0, 0 };
+            magma_philox4x32( ctr, key0, key1 );
+            u1[c] = magma_philox_uniform( ctr[0], ctr[1] );
+            u2[c] = magma_philox_uniform( ctr[2], ctr[3] );
+        }
+
+        int shift = int( r_first & 1 );  // first component is 2nd of its pair
+        if (idist == 3) {
+            #pragma omp simd
+            for (int i = 0; i < ib; ++i) {
+                int c = (i + shift) >> 1;
+                double r = sqrt( -2 * log( u1[c] ));
+                double t = twopi * u2[c];
+                x[ i0 + i ] = real_t( ((i + shift) & 1) ? r * sin( t ) : r * cos( t ));
+            }
+        }
+        else {
+            double scale = (idist == 2 ? 2 :  1);
+            double shift0 = (idist == 2 ? 1 : 0);
+            #pragma omp simd
+            for (int i = 0; i < ib; ++i) {
+                int c = (i + shift) >> 1;
+                double u = ((i + shift) & 1) ? u2[c] : u1[c];
+                x[ i0 + i ] = real_t( scale*u - shift0 );
+            }
+        }
+    }
+}
+
+#endif // MAGMA_PHILOX_H
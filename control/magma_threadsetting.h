@@ -24,6 +24,8 @@ magma_int_t magma_get_lapack_numthreads();
 magma_int_t magma_get_parallel_numthreads();
 magma_int_t magma_get_omp_numthreads();
 
+void magma_thread_pool_shutdown();
+
 #ifdef __cplusplus
 }
 #endif
@@ -18,6 +18,39 @@
 typedef double    magma_timer_t;
 typedef long long magma_flops_t;
 
+/***************************************************************************//**
+    Hardware counters, read via Linux perf_event; see magma_counters_read().
+    A counter that is not available on this machine is -1.
+
+    fp_ops counts floating point operations: packed instructions are weighted
+    by their vector width, and FMA counts as 2. It is available on Intel
+    (FP_ARITH_INST_RETIRED) and AMD (RETIRED_SSE_AVX_FLOPS) CPUs that expose
+    those events; x87 instructions are not counted.
+
+    @ingroup magma_timer
+*******************************************************************************/
+typedef struct {
+    long long cycles;
+    long long instructions;
+    long long llc_misses;   // last level cache misses, of 64 byte lines
+    long long fp_ops;
+} magma_counters_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+magma_int_t magma_counters_init();
+void magma_counters_finalize();
+void magma_counters_open_thread();
+void magma_counters_read( magma_counters_t* counters );
+int  magma_counters_snprintf( char* str, size_t size,
+                              const magma_counters_t* counters, double time );
+
+#ifdef __cplusplus
+}
+#endif
+
 #if defined(ENABLE_TIMER)
     #include <stdio.h>
     #include <stdarg.h>
@@ -139,11 +172,12 @@ static inline magma_timer_t timer_sync_stop( magma_timer_t &t, magma_queue_t que
     @param[out]
     flops   On output, set to current flop counter.
     
-    Requires global gPAPI_flops_set to be setup by testing/magma_util.cpp
-    Note that newer CPUs may not support flop counts; see
-    https://icl.cs.utk.edu/projects/papi/wiki/PAPITopics:SandyFlops
+    With HAVE_PAPI, requires global gPAPI_flops_set to be setup by
+    testing/magma_util.cpp. Note that newer CPUs may not support PAPI flop
+    counts; see https://icl.cs.utk.edu/projects/papi/wiki/PAPITopics:SandyFlops
+    Without HAVE_PAPI, uses the fp_ops hardware counter; see magma_counters_t.
     
-    If ENABLE_TIMER and HAVE_PAPI are not both defined, does nothing.
+    If ENABLE_TIMER is not defined, does nothing.
     
     @ingroup magma_timer
 *******************************************************************************/
@@ -151,6 +185,10 @@ static inline void flops_start( magma_flops_t &flops )
 {
     #if defined(ENABLE_TIMER) && defined(HAVE_PAPI)
     PAPI_read( gPAPI_flops_set, &flops );
+    #elif defined(ENABLE_TIMER)
+    magma_counters_t c;
+    magma_counters_read( &c );
+    flops = c.fp_ops;
     #endif
 }
 
@@ -162,7 +200,7 @@ static inline void flops_start( magma_flops_t &flops )
     
     @return flops, so you can sum up; see timer_stop().
     
-    If ENABLE_TIMER and HAVE_PAPI are not both defined, returns 0.
+    If ENABLE_TIMER is not defined, returns 0.
     
     @ingroup magma_timer
 *******************************************************************************/
@@ -173,12 +211,129 @@ static inline magma_flops_t flops_stop( magma_flops_t &flops )
     PAPI_read( gPAPI_flops_set, &end );
     flops = end - flops;
     return flops;
+    #elif defined(ENABLE_TIMER)
+    magma_counters_t c;
+    magma_counters_read( &c );
+    flops = (c.fp_ops < 0 ? 0 : c.fp_ops - flops);
+    return flops;
     #else
     return 0;
     #endif
 }
 
 
+/***************************************************************************//**
+    @param[in,out]
+    c       On input, counters at the start.
+            On output, set to (end - c), i.e., counts in between.
+
+    @param[in]
+    end     Counters at the end.
+
+    Unavailable counters (-1) stay -1. Not affected by ENABLE_TIMER.
+
+    @ingroup magma_timer
+*******************************************************************************/
+static inline void magma_counters_sub( magma_counters_t &c, const magma_counters_t &end )
+{
+    c.cycles       = (c.cycles       < 0 || end.cycles       < 0 ? -1 : end.cycles       - c.cycles);
+    c.instructions = (c.instructions < 0 || end.instructions < 0 ? -1 : end.instructions - c.instructions);
+    c.llc_misses   = (c.llc_misses   < 0 || end.llc_misses   < 0 ? -1 : end.llc_misses   - c.llc_misses);
+    c.fp_ops       = (c.fp_ops       < 0 || end.fp_ops       < 0 ? -1 : end.fp_ops       - c.fp_ops);
+}
+
+
+/***************************************************************************//**
+    @param[in,out]
+    sum     On output, set to (sum + c). Unavailable counters stay -1.
+
+    @param[in]
+    c       Counts to add, as returned by counters_stop().
+
+    Not affected by ENABLE_TIMER.
+
+    @ingroup magma_timer
+*******************************************************************************/
+static inline void magma_counters_add( magma_counters_t &sum, const magma_counters_t &c )
+{
+    sum.cycles       = (sum.cycles       < 0 || c.cycles       < 0 ? -1 : sum.cycles       + c.cycles);
+    sum.instructions = (sum.instructions < 0 || c.instructions < 0 ? -1 : sum.instructions + c.instructions);
+    sum.llc_misses   = (sum.llc_misses   < 0 || c.llc_misses   < 0 ? -1 : sum.llc_misses   + c.llc_misses);
+    sum.fp_ops       = (sum.fp_ops       < 0 || c.fp_ops       < 0 ? -1 : sum.fp_ops       + c.fp_ops);
+}
+
+
+/***************************************************************************//**
+    @param[out]
+    c       On output, set to current hardware counters.
+
+    Like flops_start(), but reads all counters in magma_counters_t,
+    without PAPI. Counters are opened on first use; for multi-threaded code,
+    see magma_counters_init().
+
+    If ENABLE_TIMER is not defined, does nothing.
+
+    @ingroup magma_timer
+*******************************************************************************/
+static inline void counters_start( magma_counters_t &c )
+{
+    #if defined(ENABLE_TIMER)
+    magma_counters_read( &c );
+    #endif
+}
+
+
+/***************************************************************************//**
+    @param[in,out]
+    c       On input, counters when counters_start() was called.
+            On output, set to (current counters - start counters).
+
+    @return c, so you can sum up with magma_counters_add().
+
+    If ENABLE_TIMER is not defined, does nothing.
+
+    @ingroup magma_timer
+*******************************************************************************/
+static inline magma_counters_t& counters_stop( magma_counters_t &c )
+{
+    #if defined(ENABLE_TIMER)
+    magma_counters_t end;
+    magma_counters_read( &end );
+    magma_counters_sub( c, end );
+    #endif
+    return c;
+}
+
+
+/***************************************************************************//**
+    If ENABLE_TIMER is defined, prints name, time, and the rates derived from
+    counters c: Gflop/s, bytes/flop (LLC miss traffic), and instructions per
+    cycle; see magma_counters_snprintf(). Else does nothing (returns 0).
+
+        magma_timer_t    time;
+        magma_counters_t counters;
+        timer_start( time );
+        counters_start( counters );
+        ...do timed operations...
+        counters_stop( counters );
+        timer_stop( time );
+        counters_printf( "zhetrd_hb2st", counters, time );
+
+    @ingroup magma_timer
+*******************************************************************************/
+static inline int counters_printf( const char* name, const magma_counters_t &c,
+                                   magma_timer_t time )
+{
+    int len = 0;
+    #if defined(ENABLE_TIMER)
+    char buf[ 256 ];
+    magma_counters_snprintf( buf, sizeof(buf), &c, time );
+    len = printf( "%s: %s\n", name, buf );
+    #endif
+    return len;
+}
+
+
 /***************************************************************************//**
     If ENABLE_TIMER is defined, same as printf;
     else does nothing (returns 0).
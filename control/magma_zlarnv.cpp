@@ -0,0 +1,148 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+#include "magma_internal.h"
+#include "magma_philox.h"
+
+#define COMPLEX
+
+#ifdef COMPLEX
+    #define MAGMA_REAL_PER_ELEM 2
+#else
+    #define MAGMA_REAL_PER_ELEM 1
+#endif
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZLARNV_SKIP sets x to elements offset, ..., offset + n - 1 of the random
+    vector given by iseed, i.e., to x( offset : offset + n - 1 ) had all
+    offset + n elements been generated by magma_zlarnv.
+
+    Unlike LAPACK's zlarnv, elements are from a counter-based generator
+    (Philox4x32-10), so each element depends only on iseed and its index.
+    The fill is done in parallel with OpenMP and SIMD loops, and results are
+    identical for any number of threads and any split of a vector into
+    pieces. Complex elements have the same real and imaginary parts as
+    consecutive elements of the real vector from magma_dlarnv, and single
+    precision equals double precision rounded.
+
+    Arguments
+    ---------
+    @param[in]
+    idist   INTEGER
+            Specifies the distribution of the random numbers:
+      -     = 1: real and imaginary parts each uniform (0,1)
+      -     = 2: real and imaginary parts each uniform (-1,1)
+      -     = 3: real and imaginary parts each normal (0,1)
+            Other values fall back to LAPACK's zlarnv, which is sequential
+            and does not support offset > 0.
+
+    @param[in]
+    iseed   INTEGER array, dimension (4)
+            Seed of the random vector, as for LAPACK's zlarnv:
+            entries between 0 and 4095, and iseed(4) odd.
+
+    @param[in]
+    offset  INTEGER
+            Index of the first element to generate. offset >= 0.
+
+    @param[in]
+    n       INTEGER
+            Number of random numbers to generate.
+
+    @param[out]
+    x       COMPLEX_16 array, dimension (n)
+            The generated random numbers.
+
+    @ingroup magma_larnv
+*******************************************************************************/
+extern "C" void
+magma_zlarnv_skip(
+    magma_int_t idist, const magma_int_t iseed[4],
+    magma_int_t offset, magma_int_t n,
+    magmaDoubleComplex *x )
+{
+    if (n <= 0)
+        return;
+
+    if (idist < 1 || idist > 3) {
+        magma_int_t iseed_copy[4] = { iseed[0], iseed[1], iseed[2], iseed[3] };
+        lapackf77_zlarnv( &idist, iseed_copy, &n, x );
+        return;
+    }
+
+    uint32_t key0, key1;
+    magma_philox_key( iseed, &key0, &key1 );
+
+    // x as an array of real components; chunks are independent
+    double *xr = (double*) x;
+    const int64_t len = int64_t( n ) * MAGMA_REAL_PER_ELEM;
+    const uint64_t r0 = uint64_t( offset ) * MAGMA_REAL_PER_ELEM;
+    const int64_t nb = 4096;
+    const int64_t nchunk = magma_ceildiv( len, nb );
+
+    #pragma omp parallel for schedule(static)
+    for (int64_t k = 0; k < nchunk; ++k) {
+        int64_t i0 = k*nb;
+        int64_t ib = (len - i0 < nb ? len - i0 : nb);
+        magma_philox_fill( idist, key0, key1, r0 + i0, ib, &xr[ i0 ] );
+    }
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZLARNV returns a vector of n random complex numbers from a uniform or
+    normal distribution, then updates iseed, so successive calls give
+    different vectors. A parallel replacement for LAPACK's zlarnv, with the
+    same arguments; see magma_zlarnv_skip for the generator.
+    Results differ from LAPACK's zlarnv, but are identical for any number
+    of threads.
+
+    Arguments
+    ---------
+    @param[in]
+    idist   INTEGER
+            Specifies the distribution of the random numbers:
+      -     = 1: real and imaginary parts each uniform (0,1)
+      -     = 2: real and imaginary parts each uniform (-1,1)
+      -     = 3: real and imaginary parts each normal (0,1)
+
+    @param[in,out]
+    iseed   INTEGER array, dimension (4)
+            On entry, the seed of the random number generator; entries
+            between 0 and 4095, and iseed(4) odd.
+            On exit, the seed is updated.
+
+    @param[in]
+    n       INTEGER
+            Number of random numbers to generate.
+
+    @param[out]
+    x       COMPLEX_16 array, dimension (n)
+            The generated random numbers.
+
+    @ingroup magma_larnv
+*******************************************************************************/
+extern "C" void
+magma_zlarnv(
+    magma_int_t idist, magma_int_t iseed[4], magma_int_t n,
+    magmaDoubleComplex *x )
+{
+    if (idist < 1 || idist > 3) {
+        lapackf77_zlarnv( &idist, iseed, &n, x );
+        return;
+    }
+    magma_zlarnv_skip( idist, iseed, 0, n, x );
+    magma_philox_next_seed( iseed );
+}
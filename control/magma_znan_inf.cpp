@@ -11,6 +11,9 @@
 */
 #include <limits>
 
+#include <stdint.h>
+#include <string.h>
+
 #include "magma_internal.h"
 
 #define COMPLEX
@@ -75,6 +78,110 @@ int magma_z_isnan_inf( magmaDoubleComplex x )
 }
 
 
+/******************************************************************************/
+// Matrices are scanned in tiles of nan_inf_mb rows by nan_inf_nb columns,
+// in parallel over tiles. Counts don't depend on the number of threads.
+const magma_int_t nan_inf_mb = 4096;
+const magma_int_t nan_inf_nb = 16;
+
+// Unsigned integer the size of a real value, for bitwise tests.
+template< int size > struct nan_inf_uint;
+template<> struct nan_inf_uint<4> { typedef uint32_t type; };
+template<> struct nan_inf_uint<8> { typedef uint64_t type; };
+
+typedef nan_inf_uint< sizeof(double) >::type bits_t;
+
+
+/******************************************************************************/
+// Returns bits of |x|. In IEEE format, x is INF if these bits equal those of
+// INF (all-ones exponent, zero mantissa), and NAN if they are greater
+// (all-ones exponent, nonzero mantissa).
+static inline bits_t abs_bits( double x )
+{
+    bits_t b;
+    memcpy( &b, &x, sizeof(b) );
+    return b & (bits_t(-1) >> 1);
+}
+
+
+/******************************************************************************/
+// Adds numbers of NAN and INF in vector x of length len to c_nan and c_inf.
+// An entry is NAN if either part is NAN, otherwise INF if either part is INF.
+// Loops are branch free, so the compiler vectorizes them.
+static inline void znan_inf_vector(
+    magma_int_t len, const magmaDoubleComplex *x,
+    magma_int_t *c_nan, magma_int_t *c_inf )
+{
+    const bits_t inf = abs_bits( std::numeric_limits<double>::infinity() );
+    const double *xr = (const double*) x;
+
+    // quick pass, usually the only one: is any exponent all ones?
+    // Tests the high 32 bits, which hold the exponent, of each real value.
+    const int shift = 8*sizeof(bits_t) - 32;
+    const uint32_t exp = uint32_t( inf >> shift );
+    #ifdef COMPLEX
+    const magma_int_t len_r = 2*len;
+    #else
+    const magma_int_t len_r = len;
+    #endif
+    int any = 0;
+    #pragma omp simd reduction(|:any)
+    for (magma_int_t i = 0; i < len_r; ++i) {
+        any |= ((uint32_t( abs_bits( xr[i] ) >> shift ) & exp) == exp);
+    }
+    if (! any) {
+        return;
+    }
+
+    // count NAN and INF
+    magma_int_t s_nan = 0;
+    magma_int_t s_inf = 0;
+
+    #pragma omp simd reduction(+:s_nan, s_inf)
+    for (magma_int_t i = 0; i < len; ++i) {
+        #ifdef COMPLEX
+        bits_t re = abs_bits( xr[ 2*i     ] );
+        bits_t im = abs_bits( xr[ 2*i + 1 ] );
+        int is_nan = (re >  inf) | (im >  inf);
+        int is_inf = (re == inf) | (im == inf);
+        #else
+        bits_t re = abs_bits( xr[ i ] );
+        int is_nan = (re >  inf);
+        int is_inf = (re == inf);
+        #endif
+        s_nan += is_nan;
+        s_inf += is_inf & ! is_nan;
+    }
+    *c_nan += s_nan;
+    *c_inf += s_inf;
+}
+
+
+/******************************************************************************/
+// Adds numbers of NAN and INF in the uplo part of tile A(i1:i2-1, j1:j2-1)
+// to c_nan and c_inf.
+static void znan_inf_tile(
+    magma_uplo_t uplo,
+    magma_int_t i1, magma_int_t i2, magma_int_t j1, magma_int_t j2,
+    const magmaDoubleComplex *A, magma_int_t lda,
+    magma_int_t *c_nan, magma_int_t *c_inf )
+{
+    for (magma_int_t j = j1; j < j2; ++j) {
+        magma_int_t ib = i1;
+        magma_int_t ie = i2;
+        if (uplo == MagmaLower) {
+            ib = max( ib, j );      // i >= j
+        }
+        else if (uplo == MagmaUpper) {
+            ie = min( ie, j + 1 );  // i <= j
+        }
+        if (ib < ie) {
+            znan_inf_vector( ie - ib, &A[ ib + j*lda ], c_nan, c_inf );
+        }
+    }
+}
+
+
 /***************************************************************************//**
     Purpose
     -------
@@ -84,6 +191,11 @@ int magma_z_isnan_inf( magmaDoubleComplex x )
     NAN is created by 0/0 and similar.
     INF is created by x/0 and similar, where x != 0.
 
+    Entries are tested bitwise on the exponent, in vectorized loops, and the
+    matrix is scanned in parallel with OpenMP for large matrices.
+    To stop at the first NAN or INF, see magma_znan_inf_any;
+    for counts per tile, see magma_znan_inf_tiles.
+
     Arguments
     ---------
     @param[in]
@@ -103,7 +215,7 @@ int magma_z_isnan_inf( magmaDoubleComplex x )
 
     @param[in]
     A       COMPLEX_16 array, dimension (lda,n), on the CPU host.
-            The m-by-n matrix to be printed.
+            The m-by-n matrix to be checked.
 
     @param[in]
     lda     INTEGER
@@ -131,8 +243,91 @@ magma_int_t magma_znan_inf(
     magma_int_t *cnt_nan,
     magma_int_t *cnt_inf )
 {
-    #define A(i_, j_) (A + (i_) + (j_)*lda)
+    magma_int_t info = 0;
+    if (uplo != MagmaLower && uplo != MagmaUpper && uplo != MagmaFull)
+        info = -1;
+    else if (m < 0)
+        info = -2;
+    else if (n < 0)
+        info = -3;
+    else if (lda < m)
+        info = -5;
+    
+    if (info != 0) {
+        magma_xerbla( __func__, -(info) );
+        return info;
+    }
     
+    magma_int_t c_nan = 0;
+    magma_int_t c_inf = 0;
+    
+    magma_int_t mt = magma_ceildiv( m, nan_inf_mb );
+    magma_int_t nt = magma_ceildiv( n, nan_inf_nb );
+    #pragma omp parallel for schedule(dynamic) reduction(+:c_nan, c_inf) if (mt*nt > 1)
+    for (magma_int_t k = 0; k < mt*nt; ++k) {
+        magma_int_t i1 = (k % mt) * nan_inf_mb;
+        magma_int_t j1 = (k / mt) * nan_inf_nb;
+        znan_inf_tile( uplo, i1, min( i1 + nan_inf_mb, m ),
+                             j1, min( j1 + nan_inf_nb, n ),
+                       A, lda, &c_nan, &c_inf );
+    }
+    
+    if (cnt_nan != NULL) { *cnt_nan = c_nan; }
+    if (cnt_inf != NULL) { *cnt_inf = c_inf; }
+    
+    return (c_nan + c_inf);
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    magma_znan_inf_any checks whether a matrix that is located on the CPU
+    host has any NAN (not-a-number) or INF (infinity) values.
+    Unlike magma_znan_inf, it stops once a NAN or INF is found, so is cheap
+    as a guard on results that are usually finite, and quick when not.
+
+    The matrix is scanned in memory order, in tiles of 4096 x 16 entries,
+    in parallel with OpenMP; threads stop after the tile in which any
+    thread finds a NAN or INF.
+
+    Arguments
+    ---------
+    @param[in]
+    uplo    magma_uplo_t
+            Specifies what part of the matrix A to check.
+      -     = MagmaUpper:  Upper triangular part of A
+      -     = MagmaLower:  Lower triangular part of A
+      -     = MagmaFull:   All of A
+
+    @param[in]
+    m       INTEGER
+            The number of rows of the matrix A. m >= 0.
+
+    @param[in]
+    n       INTEGER
+            The number of columns of the matrix A. n >= 0.
+
+    @param[in]
+    A       COMPLEX_16 array, dimension (lda,n), on the CPU host.
+            The m-by-n matrix to be checked.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of the array A. lda >= m.
+
+    @return
+      -     = 1:   A has a NAN or INF value.
+      -     = 0:   A has no NAN or INF values.
+      -     <  0:  If it returns -i, the i-th argument had an illegal value.
+
+    @ingroup magma_nan_inf
+*******************************************************************************/
+extern "C"
+magma_int_t magma_znan_inf_any(
+    magma_uplo_t uplo, magma_int_t m, magma_int_t n,
+    const magmaDoubleComplex *A, magma_int_t lda )
+{
     magma_int_t info = 0;
     if (uplo != MagmaLower && uplo != MagmaUpper && uplo != MagmaFull)
         info = -1;
@@ -148,46 +343,161 @@ magma_int_t magma_znan_inf(
         return info;
     }
     
-    int c_nan = 0;
-    int c_inf = 0;
+    int found = 0;
     
-    if (uplo == MagmaLower) {
-        for (int j = 0; j < n; ++j) {
-            for (int i = j; i < m; ++i) {  // i >= j
-                if      (magma_z_isnan( *A(i,j) )) { c_nan++; }
-                else if (magma_z_isinf( *A(i,j) )) { c_inf++; }
-            }
+    magma_int_t mt = magma_ceildiv( m, nan_inf_mb );
+    magma_int_t nt = magma_ceildiv( n, nan_inf_nb );
+    #pragma omp parallel for schedule(dynamic) if (mt*nt > 1)
+    for (magma_int_t k = 0; k < mt*nt; ++k) {
+        int done;
+        #pragma omp atomic read
+        done = found;
+        if (done) {
+            continue;
         }
-    }
-    else if (uplo == MagmaUpper) {
-        for (int j = 0; j < n; ++j) {
-            for (int i = 0; i < m && i <= j; ++i) {  // i <= j
-                if      (magma_z_isnan( *A(i,j) )) { c_nan++; }
-                else if (magma_z_isinf( *A(i,j) )) { c_inf++; }
-            }
+        
+        magma_int_t c_nan = 0;
+        magma_int_t c_inf = 0;
+        magma_int_t i1 = (k % mt) * nan_inf_mb;
+        magma_int_t j1 = (k / mt) * nan_inf_nb;
+        znan_inf_tile( uplo, i1, min( i1 + nan_inf_mb, m ),
+                             j1, min( j1 + nan_inf_nb, n ),
+                       A, lda, &c_nan, &c_inf );
+        if (c_nan + c_inf > 0) {
+            #pragma omp atomic write
+            found = 1;
         }
     }
-    else if (uplo == MagmaFull) {
-        for (int j = 0; j < n; ++j) {
-            for (int i = 0; i < m; ++i) {
-                if      (magma_z_isnan( *A(i,j) )) { c_nan++; }
-                else if (magma_z_isinf( *A(i,j) )) { c_inf++; }
-            }
-        }
+    
+    return found;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    magma_znan_inf_tiles counts NAN (not-a-number) and INF (infinity) values
+    in each mb-by-nb tile of a matrix that is located on the CPU host,
+    e.g., to locate which blocks of a tiled factorization went bad.
+    Tiles are scanned in parallel with OpenMP.
+
+    Arguments
+    ---------
+    @param[in]
+    uplo    magma_uplo_t
+            Specifies what part of the matrix A to check.
+            Tiles, or parts of tiles, outside it are not checked.
+      -     = MagmaUpper:  Upper triangular part of A
+      -     = MagmaLower:  Lower triangular part of A
+      -     = MagmaFull:   All of A
+
+    @param[in]
+    m       INTEGER
+            The number of rows of the matrix A. m >= 0.
+
+    @param[in]
+    n       INTEGER
+            The number of columns of the matrix A. n >= 0.
+
+    @param[in]
+    A       COMPLEX_16 array, dimension (lda,n), on the CPU host.
+            The m-by-n matrix to be checked.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of the array A. lda >= m.
+
+    @param[in]
+    mb      INTEGER
+            The number of rows in each tile. mb > 0.
+            The last tile row has m - (mt-1)*mb rows, where mt = ceil( m/mb ).
+
+    @param[in]
+    nb      INTEGER
+            The number of columns in each tile. nb > 0.
+            The last tile column has n - (nt-1)*nb columns, where nt = ceil( n/nb ).
+
+    @param[out]
+    cnt_nan INTEGER array, dimension (ldcnt,nt)
+            If non-NULL, on exit cnt_nan(i,j) contains the number of NAN
+            values in tile (i,j), that is,
+            in A( i*mb : (i+1)*mb - 1, j*nb : (j+1)*nb - 1 ), for i < mt, j < nt.
+
+    @param[out]
+    cnt_inf INTEGER array, dimension (ldcnt,nt)
+            If non-NULL, on exit cnt_inf(i,j) contains the number of INF
+            values in tile (i,j).
+
+    @param[in]
+    ldcnt   INTEGER
+            The leading dimension of the arrays cnt_nan and cnt_inf.
+            ldcnt >= max( 1, mt ).
+
+    @return
+      -     >= 0:  Returns number of NAN + number of INF values in all tiles.
+      -     <  0:  If it returns -i, the i-th argument had an illegal value.
+
+    @ingroup magma_nan_inf
+*******************************************************************************/
+extern "C"
+magma_int_t magma_znan_inf_tiles(
+    magma_uplo_t uplo, magma_int_t m, magma_int_t n,
+    const magmaDoubleComplex *A, magma_int_t lda,
+    magma_int_t mb, magma_int_t nb,
+    magma_int_t *cnt_nan,
+    magma_int_t *cnt_inf, magma_int_t ldcnt )
+{
+    magma_int_t mt = (mb > 0 ? magma_ceildiv( m, mb ) : 0);
+    magma_int_t nt = (nb > 0 ? magma_ceildiv( n, nb ) : 0);
+    
+    magma_int_t info = 0;
+    if (uplo != MagmaLower && uplo != MagmaUpper && uplo != MagmaFull)
+        info = -1;
+    else if (m < 0)
+        info = -2;
+    else if (n < 0)
+        info = -3;
+    else if (lda < m)
+        info = -5;
+    else if (mb <= 0)
+        info = -6;
+    else if (nb <= 0)
+        info = -7;
+    else if (ldcnt < max( 1, mt ))
+        info = -10;
+    
+    if (info != 0) {
+        magma_xerbla( __func__, -(info) );
+        return info;
     }
     
-    if (cnt_nan != NULL) { *cnt_nan = c_nan; }
-    if (cnt_inf != NULL) { *cnt_inf = c_inf; }
+    magma_int_t total = 0;
     
-    return (c_nan + c_inf);
+    #pragma omp parallel for schedule(dynamic) reduction(+:total) if (mt*nt > 1)
+    for (magma_int_t k = 0; k < mt*nt; ++k) {
+        magma_int_t it = k % mt;
+        magma_int_t jt = k / mt;
+        magma_int_t c_nan = 0;
+        magma_int_t c_inf = 0;
+        znan_inf_tile( uplo, it*mb, min( (it + 1)*mb, m ),
+                             jt*nb, min( (jt + 1)*nb, n ),
+                       A, lda, &c_nan, &c_inf );
+        if (cnt_nan != NULL) { cnt_nan[ it + jt*ldcnt ] = c_nan; }
+        if (cnt_inf != NULL) { cnt_inf[ it + jt*ldcnt ] = c_inf; }
+        total += c_nan + c_inf;
+    }
+    
+    return total;
 }
 
 
 /***************************************************************************//**
     Purpose
     -------
-    magma_znan_inf checks a matrix that is located on the CPU host
+    magma_znan_inf_gpu checks a matrix that is located on the GPU device
     for NAN (not-a-number) and INF (infinity) values.
+    The matrix is checked on the device (see magmablas_znan_inf);
+    only the two counts are copied to the CPU host.
 
     NAN is created by 0/0 and similar.
     INF is created by x/0 and similar, where x != 0.
@@ -211,7 +521,7 @@ magma_int_t magma_znan_inf(
 
     @param[in]
     dA      COMPLEX_16 array, dimension (ldda,n), on the GPU device.
-            The m-by-n matrix to be printed.
+            The m-by-n matrix to be checked.
 
     @param[in]
     ldda    INTEGER
@@ -259,14 +569,24 @@ magma_int_t magma_znan_inf_gpu(
         return info;
     }
     
-    magma_int_t lda = m;
-    magmaDoubleComplex* A;
-    magma_zmalloc_cpu( &A, lda*n );
-
-    magma_zgetmatrix( m, n, dA, ldda, A, lda, queue );
-    
-    magma_int_t cnt = magma_znan_inf( uplo, m, n, A, lda, cnt_nan, cnt_inf );
-    
-    magma_free_cpu( A );
-    return cnt;
+    #ifdef MAGMA_HAVE_HOST
+        // device memory is host memory
+        return magma_znan_inf( uplo, m, n, dA, ldda, cnt_nan, cnt_inf );
+    #else
+        magma_int_t cnt[2] = { 0, 0 };
+        magmaInt_ptr dcnt;
+        if (MAGMA_SUCCESS != magma_imalloc( &dcnt, 2 )) {
+            return MAGMA_ERR_DEVICE_ALLOC;
+        }
+        
+        magma_isetvector( 2, cnt, 1, dcnt, 1, queue );
+        magmablas_znan_inf( uplo, m, n, dA, ldda, dcnt, queue );
+        magma_igetvector( 2, dcnt, 1, cnt, 1, queue );
+        magma_free( dcnt );
+        
+        if (cnt_nan != NULL) { *cnt_nan = cnt[0]; }
+        if (cnt_inf != NULL) { *cnt_inf = cnt[1]; }
+        
+        return (cnt[0] + cnt[1]);
+    #endif
 }
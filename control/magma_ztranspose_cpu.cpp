@@ -0,0 +1,580 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+       Host transpose and symmetrize, cache-oblivious: matrices are split
+       recursively in half along the larger dimension down to leaf tiles,
+       which are done in 4x4 micro-tiles. Independent halves of large
+       matrices are OpenMP tasks.
+*/
+#include "magma_internal.h"
+
+#define COMPLEX
+
+// leaf tiles are at most leaf_nb x leaf_nb; splits are multiples of micro_nb
+const magma_int_t leaf_nb  = 32;
+const magma_int_t micro_nb = 4;
+
+// halves with at least task_min entries are done as OpenMP tasks;
+// matrices with at least parallel_min entries start a parallel region
+const double task_min     = 128*128;
+const double parallel_min = 256*256;
+
+
+/******************************************************************************/
+// Returns x, or conj( x ) if conj.
+template< bool conj >
+static inline magmaDoubleComplex op( magmaDoubleComplex x )
+{
+    return (conj ? MAGMA_Z_CONJ( x ) : x);
+}
+
+
+/******************************************************************************/
+// Splits a dimension m > leaf_nb about in half, at a multiple of leaf_nb/2
+// when possible so leaves are full, otherwise of micro_nb.
+static inline magma_int_t split( magma_int_t m )
+{
+    magma_int_t m1 = (m / leaf_nb) * (leaf_nb / 2);
+    if (m1 == 0 || m1 >= m) {
+        m1 = ((m/2 + micro_nb - 1) / micro_nb) * micro_nb;
+    }
+    return m1;
+}
+
+
+/******************************************************************************/
+// Leaf of out-of-place transpose: AT = op( A ), A is m-by-n,
+// m, n <= leaf_nb. Full micro-tiles have fixed trip counts, so the
+// compiler unrolls them and vectorizes with shuffles.
+template< bool conj >
+static void transpose_leaf(
+    magma_int_t m, magma_int_t n,
+    const magmaDoubleComplex *A,  magma_int_t lda,
+    magmaDoubleComplex       *AT, magma_int_t ldat )
+{
+    #define A(i_, j_)  A [ (i_) + (j_)*lda  ]
+    #define AT(i_, j_) AT[ (i_) + (j_)*ldat ]
+
+    magma_int_t m4 = (m / micro_nb) * micro_nb;
+    magma_int_t n4 = (n / micro_nb) * micro_nb;
+    for (magma_int_t j = 0; j < n4; j += micro_nb) {
+        for (magma_int_t i = 0; i < m4; i += micro_nb) {
+            for (int jj = 0; jj < micro_nb; ++jj) {
+                for (int ii = 0; ii < micro_nb; ++ii) {
+                    AT( j+jj, i+ii ) = op<conj>( A( i+ii, j+jj ) );
+                }
+            }
+        }
+        for (magma_int_t i = m4; i < m; ++i) {
+            for (int jj = 0; jj < micro_nb; ++jj) {
+                AT( j+jj, i ) = op<conj>( A( i, j+jj ) );
+            }
+        }
+    }
+    for (magma_int_t j = n4; j < n; ++j) {
+        for (magma_int_t i = 0; i < m; ++i) {
+            AT( j, i ) = op<conj>( A( i, j ) );
+        }
+    }
+
+    #undef A
+    #undef AT
+}
+
+
+/******************************************************************************/
+// Out-of-place transpose: AT = op( A ), A is m-by-n.
+template< bool conj >
+static void transpose_rec(
+    magma_int_t m, magma_int_t n,
+    const magmaDoubleComplex *A,  magma_int_t lda,
+    magmaDoubleComplex       *AT, magma_int_t ldat )
+{
+    if (m <= leaf_nb && n <= leaf_nb) {
+        transpose_leaf<conj>( m, n, A, lda, AT, ldat );
+    }
+    else if (m >= n) {
+        // [ A1 ]^T = [ A1^T  A2^T ]
+        // [ A2 ]
+        magma_int_t m1 = split( m );
+        #pragma omp task if (double(m1)*n >= task_min)
+        transpose_rec<conj>( m1, n, A, lda, AT, ldat );
+        transpose_rec<conj>( m - m1, n, A + m1, lda, AT + m1*ldat, ldat );
+        #pragma omp taskwait
+    }
+    else {
+        // [ A1  A2 ]^T = [ A1^T ]
+        //                [ A2^T ]
+        magma_int_t n1 = split( n );
+        #pragma omp task if (double(m)*n1 >= task_min)
+        transpose_rec<conj>( m, n1, A, lda, AT, ldat );
+        transpose_rec<conj>( m, n - n1, A + n1*lda, lda, AT + n1, ldat );
+        #pragma omp taskwait
+    }
+}
+
+
+/******************************************************************************/
+// Leaf of swap-transpose: A, B = op( B^T ), op( A^T ), A is m-by-n,
+// B is n-by-m, m, n <= leaf_nb.
+template< bool conj >
+static void swap_leaf(
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magmaDoubleComplex *B, magma_int_t ldb )
+{
+    #define A(i_, j_) A[ (i_) + (j_)*lda ]
+    #define B(i_, j_) B[ (i_) + (j_)*ldb ]
+
+    magma_int_t m4 = (m / micro_nb) * micro_nb;
+    magma_int_t n4 = (n / micro_nb) * micro_nb;
+    for (magma_int_t j = 0; j < n4; j += micro_nb) {
+        for (magma_int_t i = 0; i < m4; i += micro_nb) {
+            for (int jj = 0; jj < micro_nb; ++jj) {
+                for (int ii = 0; ii < micro_nb; ++ii) {
+                    magmaDoubleComplex tmp = A( i+ii, j+jj );
+                    A( i+ii, j+jj ) = op<conj>( B( j+jj, i+ii ) );
+                    B( j+jj, i+ii ) = op<conj>( tmp );
+                }
+            }
+        }
+        for (magma_int_t i = m4; i < m; ++i) {
+            for (int jj = 0; jj < micro_nb; ++jj) {
+                magmaDoubleComplex tmp = A( i, j+jj );
+                A( i, j+jj ) = op<conj>( B( j+jj, i ) );
+                B( j+jj, i ) = op<conj>( tmp );
+            }
+        }
+    }
+    for (magma_int_t j = n4; j < n; ++j) {
+        for (magma_int_t i = 0; i < m; ++i) {
+            magmaDoubleComplex tmp = A( i, j );
+            A( i, j ) = op<conj>( B( j, i ) );
+            B( j, i ) = op<conj>( tmp );
+        }
+    }
+
+    #undef A
+    #undef B
+}
+
+
+/******************************************************************************/
+// Swap-transpose: A, B = op( B^T ), op( A^T ), A is m-by-n, B is n-by-m.
+template< bool conj >
+static void swap_rec(
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magmaDoubleComplex *B, magma_int_t ldb )
+{
+    if (m <= leaf_nb && n <= leaf_nb) {
+        swap_leaf<conj>( m, n, A, lda, B, ldb );
+    }
+    else if (m >= n) {
+        magma_int_t m1 = split( m );
+        #pragma omp task if (double(m1)*n >= task_min)
+        swap_rec<conj>( m1, n, A, lda, B, ldb );
+        swap_rec<conj>( m - m1, n, A + m1, lda, B + m1*ldb, ldb );
+        #pragma omp taskwait
+    }
+    else {
+        magma_int_t n1 = split( n );
+        #pragma omp task if (double(m)*n1 >= task_min)
+        swap_rec<conj>( m, n1, A, lda, B, ldb );
+        swap_rec<conj>( m, n - n1, A + n1*lda, lda, B + n1, ldb );
+        #pragma omp taskwait
+    }
+}
+
+
+/******************************************************************************/
+// In-place transpose: A = op( A^T ), A is n-by-n.
+//     [ A11  A12 ] = [ A11^T  A21^T ]
+//     [ A21  A22 ]   [ A12^T  A22^T ]
+template< bool conj >
+static void transpose_inplace_rec(
+    magma_int_t n,
+    magmaDoubleComplex *A, magma_int_t lda )
+{
+    #define A(i_, j_) A[ (i_) + (j_)*lda ]
+
+    if (n <= leaf_nb) {
+        for (magma_int_t j = 0; j < n; ++j) {
+            A( j, j ) = op<conj>( A( j, j ) );
+            for (magma_int_t i = j+1; i < n; ++i) {
+                magmaDoubleComplex tmp = A( i, j );
+                A( i, j ) = op<conj>( A( j, i ) );
+                A( j, i ) = op<conj>( tmp );
+            }
+        }
+    }
+    else {
+        magma_int_t n1 = split( n );
+        magma_int_t n2 = n - n1;
+        #pragma omp task if (double(n1)*n1 >= task_min)
+        transpose_inplace_rec<conj>( n1, &A( 0, 0 ), lda );
+        #pragma omp task if (double(n2)*n2 >= task_min)
+        transpose_inplace_rec<conj>( n2, &A( n1, n1 ), lda );
+        swap_rec<conj>( n2, n1, &A( n1, 0 ), lda, &A( 0, n1 ), lda );
+        #pragma omp taskwait
+    }
+
+    #undef A
+}
+
+
+/******************************************************************************/
+// Symmetrize: copies the uplo triangle of A to the other triangle,
+// A = tril( A ) + op( tril( A, -1 )^T ) for Lower, likewise for Upper.
+// If conj, sets the diagonal to be real.
+template< bool conj >
+static void symmetrize_rec(
+    magma_uplo_t uplo, magma_int_t n,
+    magmaDoubleComplex *A, magma_int_t lda )
+{
+    #define A(i_, j_) A[ (i_) + (j_)*lda ]
+
+    if (n <= leaf_nb) {
+        for (magma_int_t j = 0; j < n; ++j) {
+            if (conj) {
+                A( j, j ) = MAGMA_Z_MAKE( MAGMA_Z_REAL( A( j, j ) ), 0 );
+            }
+            for (magma_int_t i = j+1; i < n; ++i) {
+                if (uplo == MagmaLower)
+                    A( j, i ) = op<conj>( A( i, j ) );
+                else
+                    A( i, j ) = op<conj>( A( j, i ) );
+            }
+        }
+    }
+    else {
+        magma_int_t n1 = split( n );
+        magma_int_t n2 = n - n1;
+        #pragma omp task if (double(n1)*n1 >= task_min)
+        symmetrize_rec<conj>( uplo, n1, &A( 0, 0 ), lda );
+        #pragma omp task if (double(n2)*n2 >= task_min)
+        symmetrize_rec<conj>( uplo, n2, &A( n1, n1 ), lda );
+        if (uplo == MagmaLower)
+            transpose_rec<conj>( n2, n1, &A( n1, 0 ), lda, &A( 0, n1 ), lda );
+        else
+            transpose_rec<conj>( n1, n2, &A( 0, n1 ), lda, &A( n1, 0 ), lda );
+        #pragma omp taskwait
+    }
+
+    #undef A
+}
+
+
+/******************************************************************************/
+// Out-of-place transpose driver; starts a parallel region for large matrices.
+template< bool conj >
+static void transpose_driver(
+    magma_int_t m, magma_int_t n,
+    const magmaDoubleComplex *A,  magma_int_t lda,
+    magmaDoubleComplex       *AT, magma_int_t ldat )
+{
+    #pragma omp parallel if (double(m)*n >= parallel_min)
+    #pragma omp single nowait
+    transpose_rec<conj>( m, n, A, lda, AT, ldat );
+}
+
+
+/******************************************************************************/
+// In-place transpose driver; starts a parallel region for large matrices.
+template< bool conj >
+static void transpose_inplace_driver(
+    magma_int_t n,
+    magmaDoubleComplex *A, magma_int_t lda )
+{
+    #pragma omp parallel if (double(n)*n >= parallel_min)
+    #pragma omp single nowait
+    transpose_inplace_rec<conj>( n, A, lda );
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ztranspose_cpu copies and transposes a matrix on the CPU host:
+    AT = A^T. The matrix is split recursively into tiles that fit in cache
+    (cache-oblivious), and large matrices are done in parallel with OpenMP,
+    so it avoids the cache and TLB misses of a loop over all entries.
+    See magmablas_ztranspose for the GPU version.
+
+    Arguments
+    ---------
+    @param[in]
+    m       INTEGER
+            The number of rows of the matrix A.  M >= 0.
+
+    @param[in]
+    n       INTEGER
+            The number of columns of the matrix A.  N >= 0.
+
+    @param[in]
+    A       COMPLEX_16 array, dimension (LDA,N)
+            The M-by-N matrix A.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of the array A.  LDA >= max(1,M).
+
+    @param[out]
+    AT      COMPLEX_16 array, dimension (LDAT,M)
+            The N-by-M matrix AT. AT must not overlap A.
+
+    @param[in]
+    ldat    INTEGER
+            The leading dimension of the array AT.  LDAT >= max(1,N).
+
+    @ingroup magma_transpose
+*******************************************************************************/
+extern "C" void
+magma_ztranspose_cpu(
+    magma_int_t m, magma_int_t n,
+    const magmaDoubleComplex *A,  magma_int_t lda,
+    magmaDoubleComplex       *AT, magma_int_t ldat )
+{
+    magma_int_t info = 0;
+    if ( m < 0 )
+        info = -1;
+    else if ( n < 0 )
+        info = -2;
+    else if ( lda < max(1,m) )
+        info = -4;
+    else if ( ldat < max(1,n) )
+        info = -6;
+
+    if ( info != 0 ) {
+        magma_xerbla( __func__, -(info) );
+        return;
+    }
+
+    if ( m == 0 || n == 0 )
+        return;
+
+    transpose_driver<false>( m, n, A, lda, AT, ldat );
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ztranspose_inplace_cpu transposes a square N-by-N matrix in-place on the
+    CPU host: A = A^T. Uses the same cache-oblivious, parallel method as
+    magma_ztranspose_cpu, swapping the off-diagonal blocks.
+    See magmablas_ztranspose_inplace for the GPU version.
+
+    Arguments
+    ---------
+    @param[in]
+    n       INTEGER
+            The number of rows and columns of the matrix A.  N >= 0.
+
+    @param[in,out]
+    A       COMPLEX_16 array, dimension (LDA,N)
+            The N-by-N matrix A.
+            On exit, A = A^T.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of the array A.  LDA >= max(1,N).
+
+    @ingroup magma_transpose
+*******************************************************************************/
+extern "C" void
+magma_ztranspose_inplace_cpu(
+    magma_int_t n,
+    magmaDoubleComplex *A, magma_int_t lda )
+{
+    magma_int_t info = 0;
+    if ( n < 0 )
+        info = -1;
+    else if ( lda < max(1,n) )
+        info = -3;
+
+    if ( info != 0 ) {
+        magma_xerbla( __func__, -(info) );
+        return;
+    }
+
+    if ( n == 0 )
+        return;
+
+    transpose_inplace_driver<false>( n, A, lda );
+}
+
+
+#ifdef COMPLEX
+/***************************************************************************//**
+    Purpose
+    -------
+    ztranspose_conj_cpu copies and conjugate-transposes a matrix on the
+    CPU host: AT = A^H. See magma_ztranspose_cpu.
+
+    Arguments
+    ---------
+    @param[in]
+    m       INTEGER
+            The number of rows of the matrix A.  M >= 0.
+
+    @param[in]
+    n       INTEGER
+            The number of columns of the matrix A.  N >= 0.
+
+    @param[in]
+    A       COMPLEX_16 array, dimension (LDA,N)
+            The M-by-N matrix A.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of the array A.  LDA >= max(1,M).
+
+    @param[out]
+    AT      COMPLEX_16 array, dimension (LDAT,M)
+            The N-by-M matrix AT. AT must not overlap A.
+
+    @param[in]
+    ldat    INTEGER
+            The leading dimension of the array AT.  LDAT >= max(1,N).
+
+    @ingroup magma_transpose
+*******************************************************************************/
+extern "C" void
+magma_ztranspose_conj_cpu(
+    magma_int_t m, magma_int_t n,
+    const magmaDoubleComplex *A,  magma_int_t lda,
+    magmaDoubleComplex       *AT, magma_int_t ldat )
+{
+    magma_int_t info = 0;
+    if ( m < 0 )
+        info = -1;
+    else if ( n < 0 )
+        info = -2;
+    else if ( lda < max(1,m) )
+        info = -4;
+    else if ( ldat < max(1,n) )
+        info = -6;
+
+    if ( info != 0 ) {
+        magma_xerbla( __func__, -(info) );
+        return;
+    }
+
+    if ( m == 0 || n == 0 )
+        return;
+
+    transpose_driver<true>( m, n, A, lda, AT, ldat );
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ztranspose_conj_inplace_cpu conjugate-transposes a square N-by-N matrix
+    in-place on the CPU host: A = A^H. See magma_ztranspose_inplace_cpu.
+
+    Arguments
+    ---------
+    @param[in]
+    n       INTEGER
+            The number of rows and columns of the matrix A.  N >= 0.
+
+    @param[in,out]
+    A       COMPLEX_16 array, dimension (LDA,N)
+            The N-by-N matrix A.
+            On exit, A = A^H.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of the array A.  LDA >= max(1,N).
+
+    @ingroup magma_transpose
+*******************************************************************************/
+extern "C" void
+magma_ztranspose_conj_inplace_cpu(
+    magma_int_t n,
+    magmaDoubleComplex *A, magma_int_t lda )
+{
+    magma_int_t info = 0;
+    if ( n < 0 )
+        info = -1;
+    else if ( lda < max(1,n) )
+        info = -3;
+
+    if ( info != 0 ) {
+        magma_xerbla( __func__, -(info) );
+        return;
+    }
+
+    if ( n == 0 )
+        return;
+
+    transpose_inplace_driver<true>( n, A, lda );
+}
+#endif // COMPLEX
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    zsymmetrize_cpu copies the lower triangle to the upper triangle, or
+    vice-versa, to make A a general representation of a Hermitian
+    (symmetric in real) matrix, on the CPU host.
+    In Complex, it conjugates and sets the diagonal to be Real.
+    Uses the same cache-oblivious, parallel method as magma_ztranspose_cpu.
+    See magmablas_zsymmetrize for the GPU version.
+
+    Arguments
+    ---------
+    @param[in]
+    uplo    magma_uplo_t
+            Specifies the part of the matrix A that is valid on input.
+      -     = MagmaUpper:      Upper triangular part
+      -     = MagmaLower:      Lower triangular part
+
+    @param[in]
+    n       INTEGER
+            The number of rows and columns of the matrix A.  N >= 0.
+
+    @param[in,out]
+    A       COMPLEX_16 array, dimension (LDA,N)
+            The N-by-N matrix A.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of the array A.  LDA >= max(1,N).
+
+    @ingroup magma_symmetrize
+*******************************************************************************/
+extern "C" void
+magma_zsymmetrize_cpu(
+    magma_uplo_t uplo, magma_int_t n,
+    magmaDoubleComplex *A, magma_int_t lda )
+{
+    magma_int_t info = 0;
+    if ( uplo != MagmaLower && uplo != MagmaUpper )
+        info = -1;
+    else if ( n < 0 )
+        info = -2;
+    else if ( lda < max(1,n) )
+        info = -4;
+
+    if ( info != 0 ) {
+        magma_xerbla( __func__, -(info) );
+        return;
+    }
+
+    if ( n == 0 )
+        return;
+
+    #pragma omp parallel if (double(n)*n >= parallel_min)
+    #pragma omp single nowait
+    symmetrize_rec<true>( uplo, n, A, lda );
+}
@@ -0,0 +1,434 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+
+#include <errno.h>  // EBUSY
+
+#include "thread_pool.hpp"
+#include "magma_timer.h"
+
+#ifndef MAGMA_NOAFFINITY
+#include <unistd.h>  // sysconf
+#include "affinity.h"
+#endif
+
+// If err, prints error and throws exception.
+static void check( int err )
+{
+    if ( err != 0 ) {
+        fprintf( stderr, "Error: %s (%d)\n", strerror(err), err );
+        throw std::exception();
+    }
+}
+
+
+/***************************************************************************//**
+    @class magma_barrier
+
+    Purpose
+    -------
+    Barrier for a fixed number of threads that can be reused, and re-sized
+    with init() when no thread is waiting, without the cost of destroying and
+    creating a pthread barrier on every call.
+*******************************************************************************/
+
+/***************************************************************************//**
+    Creates barrier for 1 thread. Use init() to set number of threads.
+*******************************************************************************/
+magma_barrier::magma_barrier():
+    count     ( 1 ),
+    nwaiting  ( 0 ),
+    generation( 0 )
+{
+    check( pthread_mutex_init( &mutex, NULL ));
+    check( pthread_cond_init(  &cond,  NULL ));
+}
+
+
+/******************************************************************************/
+magma_barrier::~magma_barrier()
+{
+    check( pthread_mutex_destroy( &mutex ));
+    check( pthread_cond_destroy( &cond ));
+}
+
+
+/***************************************************************************//**
+    Sets number of threads that must call wait() before it returns.
+    Must not be called while threads are waiting.
+    @param[in] in_count    Number of threads, >= 1.
+*******************************************************************************/
+void magma_barrier::init( magma_int_t in_count )
+{
+    check( pthread_mutex_lock( &mutex ));
+    assert( nwaiting == 0 );
+    count = max( 1, in_count );
+    check( pthread_mutex_unlock( &mutex ));
+}
+
+
+/***************************************************************************//**
+    Blocks until count threads have called wait().
+*******************************************************************************/
+void magma_barrier::wait()
+{
+    check( pthread_mutex_lock( &mutex ));
+    magma_int_t my_generation = generation;
+    nwaiting += 1;
+    if ( nwaiting == count ) {
+        nwaiting = 0;
+        generation += 1;
+        check( pthread_cond_broadcast( &cond ));
+    }
+    else {
+        while ( my_generation == generation ) {
+            check( pthread_cond_wait( &cond, &mutex ));
+        }
+    }
+    check( pthread_mutex_unlock( &mutex ));
+}
+
+
+/***************************************************************************//**
+    @class magma_thread_pool
+
+    Purpose
+    -------
+    Process-wide pool of worker threads. Workers are created the first time
+    they are needed and then persist, waiting for work, until
+    magma_thread_pool_shutdown() (called by magma_finalize).
+    If MAGMA is compiled with affinity, each worker is bound once to the core
+    matching its id, when it is created. As there is only one pool, no two
+    workers are bound to the same core.
+
+    A routine borrows the pool for one parallel region:
+
+        magma_thread_pool* pool = magma_thread_pool::get();
+        nthread = pool->begin( nthread );   // per-call limit; may grant fewer
+        data.barrier = pool->barrier( nthread );
+        for (i = 0; i < nthread; ++i) args[i] = { i, &data };
+        pool->run( parallel_section, args, sizeof(args[0]) );
+        pool->end();
+
+    run() executes parallel_section( &args[i] ) on workers i = 1, ..., nthread-1
+    and on the calling thread for i = 0, and returns when all are done.
+    Alternatively, start() and wait() run only the workers, leaving the calling
+    thread free, e.g., to push tasks to a magma_thread_queue.
+
+    Only one region uses the workers at a time. Nested use (from a worker, or
+    from inside a region), and use while another thread has the pool, is
+    granted 1 thread, so it runs inline on the calling thread instead of
+    waiting for the pool.
+*******************************************************************************/
+
+// > 0 if this thread is a pool worker or is inside a region.
+static thread_local int t_pool_depth = 0;
+
+// > 0 if this thread is inside a region that runs inline, with 1 thread.
+static thread_local int t_pool_inline = 0;
+
+static magma_thread_pool* g_pool = NULL;
+static pthread_mutex_t g_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// arguments to magma_thread_pool_main
+struct magma_thread_pool_worker_arg
+{
+    magma_thread_pool* pool;
+    magma_int_t id;
+    magma_int_t generation;  ///<  last job before the worker was created
+};
+
+
+/***************************************************************************//**
+    Worker thread's main routine, executed by pthread_create.
+    @param[in] arg    magma_thread_pool_worker_arg, deleted here.
+*******************************************************************************/
+extern "C"
+void* magma_thread_pool_main( void* arg )
+{
+    magma_thread_pool_worker_arg* warg = (magma_thread_pool_worker_arg*) arg;
+    magma_thread_pool* pool = warg->pool;
+    magma_int_t id = warg->id;
+    magma_int_t generation = warg->generation;
+    delete warg;
+
+    t_pool_depth = 1;
+    pool->worker( id, generation );
+    return NULL;
+}
+
+
+/***************************************************************************//**
+    @return process-wide pool, creating it (with no workers) if needed.
+*******************************************************************************/
+magma_thread_pool* magma_thread_pool::get()
+{
+    check( pthread_mutex_lock( &g_pool_mutex ));
+    if ( g_pool == NULL ) {
+        g_pool = new magma_thread_pool();
+    }
+    magma_thread_pool* pool = g_pool;
+    check( pthread_mutex_unlock( &g_pool_mutex ));
+    return pool;
+}
+
+
+/***************************************************************************//**
+    Exits and joins all workers and deletes the pool.
+    A later get() creates a new pool.
+    Must not be called while a region is active.
+*******************************************************************************/
+void magma_thread_pool::shutdown()
+{
+    check( pthread_mutex_lock( &g_pool_mutex ));
+    if ( g_pool != NULL ) {
+        delete g_pool;
+        g_pool = NULL;
+    }
+    check( pthread_mutex_unlock( &g_pool_mutex ));
+}
+
+
+/******************************************************************************/
+magma_thread_pool::magma_thread_pool():
+    threads   (),
+    barriers  (),
+    nbarrier  ( 0     ),
+    func      ( NULL  ),
+    args      ( NULL  ),
+    arg_size  ( 0     ),
+    nthread   ( 1     ),
+    generation( 0     ),
+    nbusy     ( 0     ),
+    quit_flag ( false )
+{
+    check( pthread_mutex_init( &region,    NULL ));
+    check( pthread_mutex_init( &mutex,     NULL ));
+    check( pthread_cond_init(  &cond,      NULL ));
+    check( pthread_cond_init(  &cond_done, NULL ));
+}
+
+
+/***************************************************************************//**
+    Sets quit_flag, wakes and joins all workers, then deallocates data.
+*******************************************************************************/
+magma_thread_pool::~magma_thread_pool()
+{
+    check( pthread_mutex_lock( &mutex ));
+    quit_flag = true;
+    check( pthread_cond_broadcast( &cond ));
+    check( pthread_mutex_unlock( &mutex ));
+
+    for( size_t i=0; i < threads.size(); ++i ) {
+        check( pthread_join( threads[i], NULL ));
+    }
+    for( size_t i=0; i < barriers.size(); ++i ) {
+        delete barriers[i];
+    }
+    check( pthread_mutex_destroy( &region ));
+    check( pthread_mutex_destroy( &mutex ));
+    check( pthread_cond_destroy( &cond ));
+    check( pthread_cond_destroy( &cond_done ));
+}
+
+
+/***************************************************************************//**
+    Creates workers, so there are at least in_nworker.
+    Called with region held, so no job is running.
+*******************************************************************************/
+void magma_thread_pool::grow( magma_int_t in_nworker )
+{
+    while ( (magma_int_t) threads.size() < in_nworker ) {
+        magma_thread_pool_worker_arg* warg = new magma_thread_pool_worker_arg;
+        warg->pool = this;
+        warg->id   = threads.size() + 1;
+        warg->generation = generation;
+        pthread_t thread;
+        check( pthread_create( &thread, NULL, magma_thread_pool_main, warg ));
+        threads.push_back( thread );
+    }
+}
+
+
+/***************************************************************************//**
+    Worker loop: waits for a new job (generation changes), runs it if its id
+    is less than nthread, and signals when done.
+    @param[in] id       Worker id, >= 1.
+    @param[in] seen     Generation when the worker was created. The first job
+                        may start before the worker thread gets here.
+*******************************************************************************/
+void magma_thread_pool::worker( magma_int_t id, magma_int_t seen )
+{
+    #ifndef MAGMA_NOAFFINITY
+    // bind once, instead of on every call; if oversubscribed, leave unbound
+    if ( id < sysconf( _SC_NPROCESSORS_ONLN )) {
+        affinity_set new_set( id );
+        if ( new_set.set_affinity() != 0 ) {
+            fprintf( stderr, "Error in sched_setaffinity (thread pool worker %lld)\n", (long long) id );
+        }
+    }
+    #endif
+
+    check( pthread_mutex_lock( &mutex ));
+    while ( true ) {
+        while ( seen == generation && ! quit_flag ) {
+            check( pthread_cond_wait( &cond, &mutex ));
+        }
+        if ( quit_flag ) {
+            break;
+        }
+        seen = generation;
+        if ( id < nthread ) {
+            void* (*my_func)( void* ) = func;
+            void* my_arg = args + id*arg_size;
+            check( pthread_mutex_unlock( &mutex ));
+
+            // count this worker in magma_counters_read, if counters are open
+            magma_counters_open_thread();
+            my_func( my_arg );
+
+            check( pthread_mutex_lock( &mutex ));
+            nbusy -= 1;
+            if ( nbusy == 0 ) {
+                check( pthread_cond_broadcast( &cond_done ));
+            }
+        }
+    }
+    check( pthread_mutex_unlock( &mutex ));
+}
+
+
+/***************************************************************************//**
+    Starts a parallel region on the pool.
+    @param[in] in_nthread    Number of threads requested, including the caller.
+    @return number of threads granted: in_nthread,
+            or 1 if called from a worker, from inside a region,
+            or while another thread has the pool.
+*******************************************************************************/
+magma_int_t magma_thread_pool::begin( magma_int_t in_nthread )
+{
+    if ( t_pool_depth == 0 ) {
+        int err = pthread_mutex_trylock( &region );
+        if ( err == 0 ) {
+            t_pool_depth = 1;
+            nthread  = max( 1, in_nthread );
+            nbarrier = 0;
+            grow( nthread - 1 );
+            return nthread;
+        }
+        if ( err != EBUSY ) {
+            check( err );
+        }
+    }
+    t_pool_depth  += 1;
+    t_pool_inline += 1;
+    return 1;
+}
+
+
+/***************************************************************************//**
+    @return barrier for count threads, valid until end().
+    Barriers are reused by later regions.
+*******************************************************************************/
+magma_barrier* magma_thread_pool::barrier( magma_int_t count )
+{
+    static thread_local magma_barrier* nested_barrier = NULL;
+    if ( t_pool_inline > 0 ) {
+        // inline region has 1 thread; use a private barrier.
+        if ( nested_barrier == NULL ) {
+            nested_barrier = new magma_barrier();
+        }
+        nested_barrier->init( count );
+        return nested_barrier;
+    }
+    if ( nbarrier == (magma_int_t) barriers.size() ) {
+        barriers.push_back( new magma_barrier() );
+    }
+    magma_barrier* b = barriers[ nbarrier ];
+    nbarrier += 1;
+    b->init( count );
+    return b;
+}
+
+
+/***************************************************************************//**
+    Starts in_func( in_args + i*in_arg_size ) on workers i = 1, ..., nthread-1.
+    Returns immediately; use wait() to wait for them.
+*******************************************************************************/
+void magma_thread_pool::start( void* (*in_func)( void* ), void* in_args, size_t in_arg_size )
+{
+    if ( t_pool_inline > 0 || nthread <= 1 ) {
+        return;
+    }
+    check( pthread_mutex_lock( &mutex ));
+    func     = in_func;
+    args     = (char*) in_args;
+    arg_size = in_arg_size;
+    nbusy    = nthread - 1;
+    generation += 1;
+    check( pthread_cond_broadcast( &cond ));
+    check( pthread_mutex_unlock( &mutex ));
+}
+
+
+/***************************************************************************//**
+    Waits for the workers started by start() to finish.
+*******************************************************************************/
+void magma_thread_pool::wait()
+{
+    if ( t_pool_inline > 0 || nthread <= 1 ) {
+        return;
+    }
+    check( pthread_mutex_lock( &mutex ));
+    while ( nbusy > 0 ) {
+        check( pthread_cond_wait( &cond_done, &mutex ));
+    }
+    check( pthread_mutex_unlock( &mutex ));
+}
+
+
+/***************************************************************************//**
+    Runs in_func( in_args + i*in_arg_size ) for i = 0, ..., nthread-1,
+    with i = 0 on the calling thread, and waits for all to finish.
+*******************************************************************************/
+void magma_thread_pool::run( void* (*in_func)( void* ), void* in_args, size_t in_arg_size )
+{
+    start( in_func, in_args, in_arg_size );
+    in_func( in_args );
+    wait();
+}
+
+
+/***************************************************************************//**
+    Ends the parallel region started by begin().
+*******************************************************************************/
+void magma_thread_pool::end()
+{
+    if ( t_pool_inline > 0 ) {
+        t_pool_inline -= 1;
+        t_pool_depth  -= 1;
+        return;
+    }
+    t_pool_depth = 0;
+    check( pthread_mutex_unlock( &region ));
+}
+
+
+/***************************************************************************//**
+    Exits the worker threads of the thread pool used by the multi-threaded
+    CPU parts of MAGMA, such as magma_zhetrd_hb2st, magma_zbulge_back, and
+    magma_ztrevc3_mt. It is called by magma_finalize; the pool is re-created
+    if needed later.
+    Must not be called while a MAGMA routine is running.
+
+    @ingroup magma_thread
+*******************************************************************************/
+extern "C"
+void magma_thread_pool_shutdown()
+{
+    magma_thread_pool::shutdown();
+}
@@ -0,0 +1,89 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+
+#ifndef MAGMA_THREAD_POOL_HPP
+#define MAGMA_THREAD_POOL_HPP
+
+#include <vector>
+
+#include "magma_internal.h"
+
+
+/***************************************************************************//**
+    Reusable barrier. Unlike pthread_barrier_t, the count can be changed
+    with init() without destroying it, and it is available on all platforms.
+    @ingroup magma_thread
+*******************************************************************************/
+class magma_barrier
+{
+public:
+    magma_barrier();
+    ~magma_barrier();
+
+    void init( magma_int_t in_count );
+    void wait();
+
+private:
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+    magma_int_t     count;       ///<  number of threads to wait for
+    magma_int_t     nwaiting;    ///<  number of threads currently waiting
+    magma_int_t     generation;  ///<  incremented each time the barrier opens
+};
+
+
+/******************************************************************************/
+extern "C"
+void* magma_thread_pool_main( void* arg );
+
+
+/***************************************************************************//**
+    Process-wide pool of worker threads, used by the multi-threaded CPU
+    parts of MAGMA (bulge chasing, applying Q2, trevc). A caller that finds
+    the pool in use runs its region inline instead of waiting.
+    @ingroup magma_thread
+*******************************************************************************/
+class magma_thread_pool
+{
+public:
+    static magma_thread_pool* get();
+    static void shutdown();
+
+    magma_int_t begin( magma_int_t in_nthread );
+    magma_barrier* barrier( magma_int_t count );
+    void start( void* (*in_func)( void* ), void* in_args, size_t in_arg_size );
+    void wait();
+    void run( void* (*in_func)( void* ), void* in_args, size_t in_arg_size );
+    void end();
+
+protected:
+    friend void* magma_thread_pool_main( void* arg );
+    magma_thread_pool();
+    ~magma_thread_pool();
+    void grow( magma_int_t in_nworker );
+    void worker( magma_int_t id, magma_int_t seen );
+
+private:
+    pthread_mutex_t region;       ///<  held from begin() to end() by the thread using the workers
+    pthread_mutex_t mutex;        ///<  mutex lock for job, generation, nbusy, quit_flag
+    pthread_cond_t  cond;         ///<  signals a new job or quit to workers
+    pthread_cond_t  cond_done;    ///<  signals that workers finished the job
+    std::vector< pthread_t > threads;  ///<  workers have ids 1, ..., threads.size()
+    std::vector< magma_barrier* > barriers;  ///<  reusable barriers for the current region
+    magma_int_t     nbarrier;     ///<  number of barriers handed out in the current region
+
+    void*         (*func)( void* );
+    char*           args;
+    size_t          arg_size;
+    magma_int_t     nthread;      ///<  threads in the current region, including the caller
+    magma_int_t     generation;   ///<  incremented for each job
+    magma_int_t     nbusy;        ///<  workers still running the current job
+    bool            quit_flag;
+};
+
+#endif        //  #ifndef MAGMA_THREAD_POOL_HPP
@@ -9,6 +9,7 @@
 */
 
 #include "thread_queue.hpp"
+#include "thread_pool.hpp"
 
 // If err, prints error and throws exception.
 static void check( int err )
@@ -122,7 +123,8 @@ magma_thread_queue::magma_thread_queue():
     quit_flag( false ),
     ntask    ( 0     ),
     threads  ( NULL  ),
-    nthread  ( 0     )
+    nthread  ( 0     ),
+    pooled   ( false )
 {
     check( pthread_mutex_init( &mutex,      NULL ));
     check( pthread_cond_init(  &cond,       NULL ));
@@ -143,16 +145,27 @@ magma_thread_queue::~magma_thread_queue()
 
 
 /***************************************************************************//**
-    Creates threads.
+    Starts threads. These are borrowed from the persistent magma_thread_pool,
+    if it is available; otherwise (e.g., when called from a pool thread)
+    new threads are created.
     @param[in] in_nthread    Number of threads to launch.
 *******************************************************************************/
 void magma_thread_queue::launch( magma_int_t in_nthread )
 {
-    assert( threads == NULL );  // else launch was called previously
+    assert( threads == NULL && ! pooled );  // else launch was called previously
     nthread = in_nthread;
     if ( nthread < 1 ) {
         nthread = 1;
     }
+    // pool workers 1, ..., nthread each run magma_thread_main( this ),
+    // since arg_size = 0; the calling thread (0) remains free to push tasks.
+    magma_thread_pool* pool = magma_thread_pool::get();
+    if ( pool->begin( nthread + 1 ) == nthread + 1 ) {
+        pooled = true;
+        pool->start( magma_thread_main, this, 0 );
+        return;
+    }
+    pool->end();
     threads = new pthread_t[ nthread ];
     for( magma_int_t i=0; i < nthread; ++i ) {
         check( pthread_create( &threads[i], NULL, magma_thread_main, this ));
@@ -264,8 +277,14 @@ void magma_thread_queue::quit()
     check( pthread_mutex_unlock( &mutex ));
     
     // next, join all threads
-    if ( join ) {
-        assert( threads != NULL );
+    if ( join && pooled ) {
+        // return borrowed threads to the pool
+        magma_thread_pool* pool = magma_thread_pool::get();
+        pool->wait();
+        pool->end();
+        pooled = false;
+    }
+    else if ( join && threads != NULL ) {
         for( magma_int_t i=0; i < nthread; ++i ) {
             check( pthread_join( threads[i], NULL ));
             //printf( "joined %d (%lx)\n", i, (long) threads[i] );
@@ -275,16 +294,3 @@ void magma_thread_queue::quit()
     }
 }
 
-
-/***************************************************************************//**
-    Mostly for debugging, returns thread index in range 0, ..., nthread-1.
-*******************************************************************************/
-magma_int_t magma_thread_queue::get_thread_index( pthread_t thread ) const
-{
-    for( magma_int_t i=0; i < nthread; ++i ) {
-        if ( pthread_equal( thread, threads[i] )) {
-            return i;
-        }
-    }
-    return -1;
-}
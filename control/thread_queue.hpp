@@ -53,8 +53,6 @@ protected:
     magma_task* pop_task();
     void task_done();
     
-    magma_int_t get_thread_index( pthread_t thread ) const;
-    
 private:
     std::queue< magma_task* > q;  ///<  queue of tasks
     bool            quit_flag;    ///<  quit() sets this to true; after this, pop returns NULL
@@ -62,8 +60,9 @@ private:
     pthread_mutex_t mutex;        ///<  mutex lock for queue, quit, ntask
     pthread_cond_t  cond;         ///<  condition variable for changes to queue and quit (see push, pop, quit)
     pthread_cond_t  cond_ntask;   ///<  condition variable for changes to ntask (see sync, task_done)
-    pthread_t*      threads;      ///<  array of threads
+    pthread_t*      threads;      ///<  array of threads, if not using the thread pool
     magma_int_t     nthread;      ///<  number of threads
+    bool            pooled;       ///<  true if threads are borrowed from magma_thread_pool
 };
 
 #endif        //  #ifndef MAGMA_THREAD_HPP
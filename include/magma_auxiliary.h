@@ -118,6 +118,30 @@ magma_memset(void * ptr, int value, size_t count);
 magma_int_t
 magma_memset_async(void * ptr, int value, size_t count, magma_queue_t queue);
 
+/// Counters for the pools behind magma_malloc_cpu and magma_malloc_pinned.
+/// @see magma_mem_stats_cpu
+typedef struct magma_mem_stats
+{
+    size_t live_bytes;    ///< bytes allocated and not yet freed (as requested)
+    size_t peak_bytes;    ///< high-water mark of live_bytes
+    size_t cached_bytes;  ///< freed bytes held by the pool for reuse
+    size_t nalloc;        ///< number of allocations
+    size_t nfree;         ///< number of frees
+    double alloc_rate;    ///< allocations per second
+} magma_mem_stats_t;
+
+magma_int_t
+magma_mem_stats_cpu( magma_mem_stats_t* stats );
+
+magma_int_t
+magma_mem_stats_pinned( magma_mem_stats_t* stats );
+
+void
+magma_mem_stats_reset();
+
+void
+magma_mem_pool_release();
+
 // type-safe convenience functions to avoid using (void**) cast and sizeof(...)
 // here n is the number of elements (floats, doubles, etc.) not the number of bytes.
 /******************************************************************************/
@@ -24,7 +24,8 @@
 
 
 // each implementation of MAGMA defines HAVE_* appropriately.
-#if ! defined(MAGMA_HAVE_CUDA) && ! defined(MAGMA_HAVE_OPENCL) && ! defined(HAVE_MIC) && ! defined(MAGMA_HAVE_HIP)
+#if ! defined(MAGMA_HAVE_CUDA) && ! defined(MAGMA_HAVE_OPENCL) && ! defined(HAVE_MIC) && ! defined(MAGMA_HAVE_HIP) \
+    && ! defined(MAGMA_HAVE_HOST)
 // Pytorch requires that the error commented out below is not produced and that MAGMA_HAVE_CUDA is defined:
 // #error No 'HAVE_*' macros were set! (defaulting to CUBLAS)
 #define MAGMA_HAVE_CUDA
@@ -302,6 +303,114 @@ typedef double real_Double_t;
     }
     #endif 
 
+#elif defined(MAGMA_HAVE_HOST)
+    // host (CPU-only) backend: "device" memory is host memory, and a queue
+    // is a CPU execution context; see interface_host/interface.cpp
+    #include <math.h>
+
+    // there is no device code, so CUDA's function qualifiers are no-ops
+    #ifndef __host__
+    #define __host__
+    #endif
+    #ifndef __device__
+    #define __device__
+    #endif
+
+    #ifdef __cplusplus
+    extern "C" {
+    #endif
+
+    // opaque queue and event struct types
+    struct magma_queue;
+    typedef struct magma_queue* magma_queue_t;
+    struct magma_event;
+    typedef struct magma_event* magma_event_t;
+    typedef int                 magma_device_t;
+
+    typedef short            magmaHalf;    // placeholder; no FP16 on host
+
+    /* double complex, binary compatible with Fortran COMPLEX*16 */
+    typedef struct {
+        double x, y;
+    } magmaDoubleComplex;
+
+    #define MAGMA_Z_MAKE(r, i)   ((magmaDoubleComplex){(double)(r), (double)(i)})
+    #define MAGMA_Z_REAL(a) (a).x
+    #define MAGMA_Z_IMAG(a) (a).y
+    #define MAGMA_Z_ADD(a, b) magmaCadd(a, b)
+    #define MAGMA_Z_SUB(a, b) magmaCsub(a, b)
+    #define MAGMA_Z_MUL(a, b) magmaCmul(a, b)
+    #define MAGMA_Z_DIV(a, b) magmaCdiv(a, b)
+    #define MAGMA_Z_ABS(a) (hypot(MAGMA_Z_REAL(a), MAGMA_Z_IMAG(a)))
+    #define MAGMA_Z_ABS1(a) (fabs(MAGMA_Z_REAL(a)) + fabs(MAGMA_Z_IMAG(a)))
+    #define MAGMA_Z_CONJ(a) magmaConj(a)
+
+    static inline magmaDoubleComplex magmaCadd(magmaDoubleComplex a, magmaDoubleComplex b) {
+        return MAGMA_Z_MAKE(a.x+b.x, a.y+b.y);
+    }
+    static inline magmaDoubleComplex magmaCsub(magmaDoubleComplex a, magmaDoubleComplex b) {
+        return MAGMA_Z_MAKE(a.x-b.x, a.y-b.y);
+    }
+    static inline magmaDoubleComplex magmaCmul(magmaDoubleComplex a, magmaDoubleComplex b) {
+        return MAGMA_Z_MAKE(a.x*b.x - a.y*b.y, a.x*b.y + a.y*b.x);
+    }
+    static inline magmaDoubleComplex magmaCdiv(magmaDoubleComplex a, magmaDoubleComplex b) {
+        double sqabs = b.x*b.x + b.y*b.y;
+        return MAGMA_Z_MAKE(
+            (a.x * b.x + a.y * b.y) / sqabs,
+            (a.y * b.x - a.x * b.y) / sqabs
+        );
+    }
+    static inline magmaDoubleComplex magmaConj(magmaDoubleComplex a) {
+        return MAGMA_Z_MAKE(a.x, -a.y);
+    }
+    static inline magmaDoubleComplex magmaCfma(magmaDoubleComplex a, magmaDoubleComplex b, magmaDoubleComplex c) {
+        return magmaCadd(magmaCmul(a, b), c);
+    }
+
+    /* float complex, binary compatible with Fortran COMPLEX */
+    typedef struct {
+        float x, y;
+    } magmaFloatComplex;
+
+    #define MAGMA_C_MAKE(r, i)   ((magmaFloatComplex){(float)(r), (float)(i)})
+    #define MAGMA_C_REAL(a) (a).x
+    #define MAGMA_C_IMAG(a) (a).y
+    #define MAGMA_C_ADD(a, b) magmaCaddf(a, b)
+    #define MAGMA_C_SUB(a, b) magmaCsubf(a, b)
+    #define MAGMA_C_MUL(a, b) magmaCmulf(a, b)
+    #define MAGMA_C_DIV(a, b) magmaCdivf(a, b)
+    #define MAGMA_C_ABS(a) (hypotf(MAGMA_C_REAL(a), MAGMA_C_IMAG(a)))
+    #define MAGMA_C_ABS1(a) (fabsf(MAGMA_C_REAL(a)) + fabsf(MAGMA_C_IMAG(a)))
+    #define MAGMA_C_CONJ(a) magmaConjf(a)
+
+    static inline magmaFloatComplex magmaCaddf(magmaFloatComplex a, magmaFloatComplex b) {
+        return MAGMA_C_MAKE(a.x+b.x, a.y+b.y);
+    }
+    static inline magmaFloatComplex magmaCsubf(magmaFloatComplex a, magmaFloatComplex b) {
+        return MAGMA_C_MAKE(a.x-b.x, a.y-b.y);
+    }
+    static inline magmaFloatComplex magmaCmulf(magmaFloatComplex a, magmaFloatComplex b) {
+        return MAGMA_C_MAKE(a.x*b.x - a.y*b.y, a.x*b.y + a.y*b.x);
+    }
+    static inline magmaFloatComplex magmaCdivf(magmaFloatComplex a, magmaFloatComplex b) {
+        float sqabs = b.x*b.x + b.y*b.y;
+        return MAGMA_C_MAKE(
+            (a.x * b.x + a.y * b.y) / sqabs,
+            (a.y * b.x - a.x * b.y) / sqabs
+        );
+    }
+    static inline magmaFloatComplex magmaConjf(magmaFloatComplex a) {
+        return MAGMA_C_MAKE(a.x, -a.y);
+    }
+    static inline magmaFloatComplex magmaCfmaf(magmaFloatComplex a, magmaFloatComplex b, magmaFloatComplex c) {
+        return magmaCaddf(magmaCmulf(a, b), c);
+    }
+
+    #ifdef __cplusplus
+    }
+    #endif
+
 #elif defined(MAGMA_HAVE_OPENCL)
     #include <clBLAS.h>
 
@@ -385,7 +494,7 @@ typedef double real_Double_t;
     }
     #endif
 #else
-    #error "One of MAGMA_HAVE_CUDA, MAGMA_HAVE_HIP, MAGMA_HAVE_OPENCL, or HAVE_MIC must be defined. For example, add -DMAGMA_HAVE_CUDA to CFLAGS, or #define MAGMA_HAVE_CUDA before #include <magma.h>. In MAGMA, this happens in Makefile."
+    #error "One of MAGMA_HAVE_CUDA, MAGMA_HAVE_HIP, MAGMA_HAVE_HOST, MAGMA_HAVE_OPENCL, or HAVE_MIC must be defined. For example, add -DMAGMA_HAVE_CUDA to CFLAGS, or #define MAGMA_HAVE_CUDA before #include <magma.h>. In MAGMA, this happens in Makefile."
 #endif
 
 #ifdef __cplusplus
@@ -767,7 +876,8 @@ typedef enum {
     Magma_VBJACOBI     = 508,
     Magma_PARDISO      = 509,
     Magma_SYNCFREESOLVE= 510,
-    Magma_ILUT         = 511
+    Magma_ILUT         = 511,
+    Magma_SCHWARZ      = 512
 } magma_solver_type;
 
 typedef enum {
@@ -807,6 +917,7 @@ typedef enum {
     Magma_UNITCOL      = 514,
     Magma_UNITROWCOL   = 515, // to be deprecated
     Magma_UNITDIAGCOL  = 516, // to be deprecated
+    Magma_RUIZ         = 517
 } magma_scale_t;
 
 
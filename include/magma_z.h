@@ -48,6 +48,10 @@ magma_int_t magma_get_zhetrd_nb( magma_int_t n );
 magma_int_t magma_get_zhegst_nb( magma_int_t n );
 magma_int_t magma_get_zhegst_m_nb( magma_int_t n );
 
+#ifdef MAGMA_COMPLEX
+magma_int_t magma_get_ztrevc3_nthread( magma_int_t n );
+#endif
+
 // SVD
 magma_int_t magma_get_zgebrd_nb( magma_int_t m, magma_int_t n );
 magma_int_t magma_get_zgesvd_nb( magma_int_t m, magma_int_t n );
@@ -636,6 +640,20 @@ magma_zheevd(
     magma_int_t *iwork, magma_int_t liwork,
     magma_int_t *info);
 
+magma_int_t
+magma_zheevd_batched_cpu(
+    magma_vec_t jobz, magma_uplo_t uplo, magma_int_t n,
+    magmaDoubleComplex **A_array, magma_int_t lda,
+    double **w_array,
+    magma_int_t *info_array, magma_int_t batchCount);
+
+magma_int_t
+magma_zheevd_vbatched_cpu(
+    magma_vec_t jobz, magma_uplo_t uplo, magma_int_t *n,
+    magmaDoubleComplex **A_array, magma_int_t *lda,
+    double **w_array,
+    magma_int_t *info_array, magma_int_t batchCount);
+
 // CUDA MAGMA only
 magma_int_t
 magma_zheevd_gpu(
@@ -1286,6 +1304,14 @@ magma_zlaqtrsd(
     double *x,       magma_int_t ldx,
     const double *cnorm,
     magma_int_t *info);
+
+magma_int_t
+magma_zlaqtrsd3(
+    magma_trans_t trans, magma_int_t n,
+    const double *T, magma_int_t ldt,
+    magma_int_t nv, const magma_int_t *kv,
+    double *X,       magma_int_t ldx,
+    magma_int_t *info);
 #endif
 
 // CUDA MAGMA only
@@ -1360,6 +1386,17 @@ magma_zlatrsd(
     magmaDoubleComplex *x,
     double *scale, double *cnorm,
     magma_int_t *info);
+
+magma_int_t
+magma_zlatrsd3(
+    magma_uplo_t uplo, magma_trans_t trans, magma_diag_t diag,
+    magma_int_t n, magma_int_t nrhs,
+    const magmaDoubleComplex *A, magma_int_t lda,
+    const magmaDoubleComplex *lambda,
+    const magma_int_t *order,
+    magmaDoubleComplex *X, magma_int_t ldx,
+    double *scale,
+    magma_int_t *info);
 #endif
 
 magma_int_t
@@ -1806,6 +1843,19 @@ magma_znan_inf(
     magma_int_t *cnt_nan,
     magma_int_t *cnt_inf);
 
+magma_int_t
+magma_znan_inf_any(
+    magma_uplo_t uplo, magma_int_t m, magma_int_t n,
+    const magmaDoubleComplex *A, magma_int_t lda );
+
+magma_int_t
+magma_znan_inf_tiles(
+    magma_uplo_t uplo, magma_int_t m, magma_int_t n,
+    const magmaDoubleComplex *A, magma_int_t lda,
+    magma_int_t mb, magma_int_t nb,
+    magma_int_t *cnt_nan,
+    magma_int_t *cnt_inf, magma_int_t ldcnt );
+
 magma_int_t
 magma_znan_inf_gpu(
     magma_uplo_t uplo, magma_int_t m, magma_int_t n,
@@ -1814,6 +1864,44 @@ magma_znan_inf_gpu(
     magma_int_t *cnt_inf,
     magma_queue_t queue);
 
+void
+magma_zlarnv(
+    magma_int_t idist, magma_int_t iseed[4], magma_int_t n,
+    magmaDoubleComplex *x );
+
+void
+magma_zlarnv_skip(
+    magma_int_t idist, const magma_int_t iseed[4],
+    magma_int_t offset, magma_int_t n,
+    magmaDoubleComplex *x );
+
+void
+magma_ztranspose_cpu(
+    magma_int_t m, magma_int_t n,
+    const magmaDoubleComplex *A,  magma_int_t lda,
+    magmaDoubleComplex       *AT, magma_int_t ldat );
+
+void
+magma_ztranspose_conj_cpu(
+    magma_int_t m, magma_int_t n,
+    const magmaDoubleComplex *A,  magma_int_t lda,
+    magmaDoubleComplex       *AT, magma_int_t ldat );
+
+void
+magma_ztranspose_inplace_cpu(
+    magma_int_t n,
+    magmaDoubleComplex *A, magma_int_t lda );
+
+void
+magma_ztranspose_conj_inplace_cpu(
+    magma_int_t n,
+    magmaDoubleComplex *A, magma_int_t lda );
+
+void
+magma_zsymmetrize_cpu(
+    magma_uplo_t uplo, magma_int_t n,
+    magmaDoubleComplex *A, magma_int_t lda );
+
 void magma_zprint(
     magma_int_t m, magma_int_t n,
     const magmaDoubleComplex *A, magma_int_t lda);
@@ -30,6 +30,25 @@ magma_zcgeqrsv_gpu(
     magma_int_t *iter,
     magma_int_t *info);
 
+magma_int_t
+magma_zcfgmres_cpu(
+    magma_trans_t trans, magma_uplo_t uplo, magma_int_t n,
+    const magmaDoubleComplex *A, magma_int_t lda,
+    const magmaFloatComplex *SA, magma_int_t ldsa, const magma_int_t *ipiv,
+    const magmaDoubleComplex *b, magmaDoubleComplex *x,
+    magma_int_t maxiter, magma_int_t restrt, double tol,
+    magma_int_t *niter );
+
+magma_int_t
+magma_zcgesv(
+    magma_trans_t trans, magma_int_t n, magma_int_t nrhs,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magma_int_t *ipiv,
+    magmaDoubleComplex *B, magma_int_t ldb,
+    magmaDoubleComplex *X, magma_int_t ldx,
+    magma_int_t *iter,
+    magma_int_t *info);
+
 magma_int_t
 magma_zcgesv_gpu(
     magma_trans_t trans, magma_int_t n, magma_int_t nrhs,
@@ -65,6 +84,15 @@ magma_zchesv_gpu(
     magma_int_t *iter,
     magma_int_t *info);
 
+magma_int_t
+magma_zcposv(
+    magma_uplo_t uplo, magma_int_t n, magma_int_t nrhs,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magmaDoubleComplex *B, magma_int_t ldb,
+    magmaDoubleComplex *X, magma_int_t ldx,
+    magma_int_t *iter,
+    magma_int_t *info);
+
 magma_int_t
 magma_zcposv_gpu(
     magma_uplo_t uplo, magma_int_t n, magma_int_t nrhs,
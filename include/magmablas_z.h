@@ -475,6 +475,13 @@ magma_zlaswp_columnserial(
     magma_int_t k1, magma_int_t k2,
     magma_int_t *dipiv, magma_queue_t queue);
 
+void
+magmablas_znan_inf(
+    magma_uplo_t uplo, magma_int_t m, magma_int_t n,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaInt_ptr dcnt,
+    magma_queue_t queue );
+
 void
 magmablas_zsymmetrize(
     magma_uplo_t uplo, magma_int_t m,
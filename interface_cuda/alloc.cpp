@@ -19,6 +19,7 @@
 #include <cuda_runtime.h>
 
 #include "magma_v2.h"
+#include "host_pool.hpp"
 #include "magma_internal.h"
 #include "error.h"
 
@@ -28,8 +29,6 @@
 #ifdef DEBUG_MEMORY
 std::mutex                g_pointers_mutex;  // requires C++11
 std::map< void*, size_t > g_pointers_dev;
-std::map< void*, size_t > g_pointers_cpu;
-std::map< void*, size_t > g_pointers_pin;
 #endif
 
 
@@ -117,9 +116,12 @@ magma_free_internal( magma_ptr ptr,
 /***************************************************************************//**
     Allocate size bytes on CPU.
     The purpose of using this instead of malloc is to properly align arrays
-    for vector (SSE, AVX) instructions. The default implementation uses
-    posix_memalign (on Linux, MacOS, etc.) or _aligned_malloc (on Windows)
-    to align memory to a 64 byte boundary (typical cache line size).
+    for vector (SSE, AVX) instructions. Memory is aligned to a 64 byte
+    boundary (typical cache line size).
+    Blocks come from a pool of size classes, with a cache per thread, so
+    repeated allocations of similar sizes don't go to the system allocator;
+    see magma_host_pool. Set MAGMA_HUGEPAGES=1 in the environment to back
+    allocations of 2 MiB or more with transparent huge pages (Linux).
     Use magma_free_cpu() to free this memory.
 
     @param[out]
@@ -139,6 +141,7 @@ magma_free_internal( magma_ptr ptr,
     @see magma_zmalloc_cpu
     @see magma_imalloc_cpu
     @see magma_index_malloc_cpu
+    @see magma_mem_stats_cpu
 
     @ingroup magma_malloc_cpu
 *******************************************************************************/
@@ -148,75 +151,82 @@ magma_malloc_cpu( void** ptrPtr, size_t size )
     // malloc and free sometimes don't work for size=0, so allocate some minimal size
     if ( size == 0 )
         size = sizeof(magmaDoubleComplex);
-#if 1
-#if defined( _WIN32 ) || defined( _WIN64 )
-    *ptrPtr = _aligned_malloc( size, 64 );
+    *ptrPtr = magma_host_pool_cpu()->allocate( size );
     if ( *ptrPtr == NULL ) {
         return MAGMA_ERR_HOST_ALLOC;
     }
-#else
-    int err = posix_memalign( ptrPtr, 64, size );
-    if ( err != 0 ) {
-        *ptrPtr = NULL;
-        return MAGMA_ERR_HOST_ALLOC;
-    }
-#endif
-#else
-    *ptrPtr = malloc( size );
-    if ( *ptrPtr == NULL ) {
-        return MAGMA_ERR_HOST_ALLOC;
-    }
-#endif
-
-    #ifdef DEBUG_MEMORY
-    g_pointers_mutex.lock();
-    g_pointers_cpu[ *ptrPtr ] = size;
-    g_pointers_mutex.unlock();
-    #endif
-
     return MAGMA_SUCCESS;
 }
 
 
 /***************************************************************************//**
-    Frees CPU memory previously allocated by magma_malloc_cpu().
-    The default implementation uses free(),
-    which works for both malloc and posix_memalign.
-    For Windows, _aligned_free() is used.
+    Frees CPU memory previously allocated by magma_malloc_cpu(),
+    returning it to the pool for reuse.
+    For compatibility, memory from malloc() is passed to free()
+    (_aligned_free() on Windows).
 
     @param[in]
     ptr     Pointer to free.
 
     @return MAGMA_SUCCESS
-    @return MAGMA_ERR_INVALID_PTR on failure
 
     @ingroup magma_malloc_cpu
 *******************************************************************************/
 extern "C" magma_int_t
 magma_free_cpu( void* ptr )
 {
-    #ifdef DEBUG_MEMORY
-    g_pointers_mutex.lock();
-    if ( ptr != NULL && g_pointers_cpu.count( ptr ) == 0 ) {
+    if ( ptr != NULL && ! magma_host_pool_cpu()->deallocate( ptr )) {
+        #ifdef DEBUG_MEMORY
         fprintf( stderr, "magma_free_cpu( %p ) that wasn't allocated with magma_malloc_cpu.\n", ptr );
+        #endif
+        #if defined( _WIN32 ) || defined( _WIN64 )
+        _aligned_free( ptr );
+        #else
+        free( ptr );
+        #endif
     }
-    else {
-        g_pointers_cpu.erase( ptr );
+    return MAGMA_SUCCESS;
+}
+
+
+/******************************************************************************/
+// backing allocator of the pinned pool
+static void* magma_pinned_backing_alloc( size_t bytes, int* mapped )
+{
+    *mapped = 0;
+    void* ptr;
+    if ( cudaSuccess != cudaHostAlloc( &ptr, bytes, cudaHostAllocPortable )) {
+        return NULL;
     }
-    g_pointers_mutex.unlock();
-    #endif
+    return ptr;
+}
 
-#if defined( _WIN32 ) || defined( _WIN64 )
-    _aligned_free( ptr );
-#else
-    free( ptr );
-#endif
-    return MAGMA_SUCCESS;
+
+/******************************************************************************/
+static void magma_pinned_backing_free( void* ptr, size_t bytes, int mapped )
+{
+    MAGMA_UNUSED( bytes );
+    MAGMA_UNUSED( mapped );
+    cudaError_t err = cudaFreeHost( ptr );
+    check_error( err );
+}
+
+
+/***************************************************************************//**
+    @return pool behind magma_malloc_pinned; see magma_host_pool_cpu.
+*******************************************************************************/
+magma_host_pool* magma_host_pool_pinned()
+{
+    static magma_host_pool* pool = new magma_host_pool(
+        1, "CPU pinned", magma_pinned_backing_alloc, magma_pinned_backing_free );
+    return pool;
 }
 
 
 /***************************************************************************//**
     Allocates memory on the CPU in pinned memory.
+    Like magma_malloc_cpu(), blocks come from a pool, so freed pinned memory
+    is reused instead of being unregistered; magma_finalize() releases it.
     Use magma_free_pinned() to free this memory.
 
     @param[out]
@@ -236,6 +246,7 @@ magma_free_cpu( void* ptr )
     @see magma_zmalloc_pinned
     @see magma_imalloc_pinned
     @see magma_index_malloc_pinned
+    @see magma_mem_stats_pinned
 
     @ingroup magma_malloc_pinned
 *******************************************************************************/
@@ -246,16 +257,10 @@ magma_malloc_pinned( void** ptrPtr, size_t size )
     // (for pinned memory, the error is detected in free)
     if ( size == 0 )
         size = sizeof(magmaDoubleComplex);
-    if ( cudaSuccess != cudaHostAlloc( ptrPtr, size, cudaHostAllocPortable )) {
+    *ptrPtr = magma_host_pool_pinned()->allocate( size );
+    if ( *ptrPtr == NULL ) {
         return MAGMA_ERR_HOST_ALLOC;
     }
-
-    #ifdef DEBUG_MEMORY
-    g_pointers_mutex.lock();
-    g_pointers_pin[ *ptrPtr ] = size;
-    g_pointers_mutex.unlock();
-    #endif
-
     return MAGMA_SUCCESS;
 }
 
@@ -277,17 +282,14 @@ extern "C" magma_int_t
 magma_free_pinned_internal( void* ptr,
     const char* func, const char* file, int line )
 {
-    #ifdef DEBUG_MEMORY
-    g_pointers_mutex.lock();
-    if ( ptr != NULL && g_pointers_pin.count( ptr ) == 0 ) {
-        fprintf( stderr, "magma_free_pinned( %p ) that wasn't allocated with magma_malloc_pinned.\n", ptr );
+    if ( ptr == NULL || magma_host_pool_pinned()->deallocate( ptr )) {
+        return MAGMA_SUCCESS;
     }
-    else {
-        g_pointers_pin.erase( ptr );
-    }
-    g_pointers_mutex.unlock();
-    #endif
 
+    // not from the pool, e.g., from cudaHostAlloc
+    #ifdef DEBUG_MEMORY
+    fprintf( stderr, "magma_free_pinned( %p ) that wasn't allocated with magma_malloc_pinned.\n", ptr );
+    #endif
     cudaError_t err = cudaFreeHost( ptr );
     check_xerror( err, func, file, line );
     if ( cudaSuccess != err ) {
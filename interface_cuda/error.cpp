@@ -1,4 +1,8 @@
+// the host backend shares this file, but has no CUDA runtime
+#include "magma_config.h"
+#ifndef MAGMA_HAVE_HOST
 #include <cuda_runtime.h>
+#endif
 
 #include "magma_internal.h"
 #include "error.h"
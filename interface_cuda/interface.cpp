@@ -37,6 +37,7 @@
 // need lapack here, but we want acml.h for the acmlversion() function.
 #define MAGMA_LAPACK_H
 
+#include "host_pool.hpp"
 #include "magma_internal.h"
 #include "error.h"
 
@@ -47,8 +48,6 @@
 #ifdef DEBUG_MEMORY
 // defined in alloc.cpp
 extern std::map< void*, size_t > g_pointers_dev;
-extern std::map< void*, size_t > g_pointers_cpu;
-extern std::map< void*, size_t > g_pointers_pin;
 #endif
 
 // -----------------------------------------------------------------------------
@@ -275,6 +274,9 @@ magma_finalize()
             if ( g_init == 0 ) {
                 info = 0;
 
+                // exit CPU worker threads (bulge chasing, trevc, etc.)
+                magma_thread_pool_shutdown();
+
                 if ( g_magma_devices != NULL ) {
                     magma_free_cpu( g_magma_devices );
                     g_magma_devices = NULL;
@@ -297,9 +299,15 @@ magma_finalize()
 
                 #ifdef DEBUG_MEMORY
                 magma_warn_leaks( g_pointers_dev, "device" );
-                magma_warn_leaks( g_pointers_cpu, "CPU" );
-                magma_warn_leaks( g_pointers_pin, "CPU pinned" );
+                std::map< void*, size_t > pointers_cpu, pointers_pin;
+                magma_host_pool_cpu()   ->get_pointers( pointers_cpu );
+                magma_host_pool_pinned()->get_pointers( pointers_pin );
+                magma_warn_leaks( pointers_cpu, "CPU" );
+                magma_warn_leaks( pointers_pin, "CPU pinned" );
                 #endif
+
+                // free host blocks cached for reuse
+                magma_mem_pool_release();
             }
         }
     }
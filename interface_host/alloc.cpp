@@ -0,0 +1,338 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef DEBUG_MEMORY
+#include <map>
+#include <mutex>  // requires C++11
+#endif
+
+#include "host_pool.hpp"
+#include "host_stream.hpp"
+
+
+#ifdef DEBUG_MEMORY
+std::mutex                g_pointers_mutex;  // requires C++11
+std::map< void*, size_t > g_pointers_dev;
+#endif
+
+
+/******************************************************************************/
+// Allocates size bytes aligned to a 64 byte boundary (typical cache line size).
+// In the host backend, device memory and the pinned pool's blocks are
+// allocated this way.
+static magma_int_t
+magma_malloc_aligned( void** ptrPtr, size_t size )
+{
+    // malloc and free sometimes don't work for size=0, so allocate some minimal size
+    if ( size == 0 )
+        size = sizeof(magmaDoubleComplex);
+#if defined( _WIN32 ) || defined( _WIN64 )
+    *ptrPtr = _aligned_malloc( size, 64 );
+    if ( *ptrPtr == NULL ) {
+        return MAGMA_ERR_HOST_ALLOC;
+    }
+#else
+    int err = posix_memalign( ptrPtr, 64, size );
+    if ( err != 0 ) {
+        *ptrPtr = NULL;
+        return MAGMA_ERR_HOST_ALLOC;
+    }
+#endif
+    return MAGMA_SUCCESS;
+}
+
+
+/******************************************************************************/
+static void
+magma_free_aligned( void* ptr )
+{
+#if defined( _WIN32 ) || defined( _WIN64 )
+    _aligned_free( ptr );
+#else
+    free( ptr );
+#endif
+}
+
+
+/***************************************************************************//**
+    Allocates "device" memory, which in the host backend is host memory.
+    Use magma_free() to free this memory.
+
+    @param[out]
+    ptrPtr  On output, set to the pointer that was allocated.
+            NULL on failure.
+
+    @param[in]
+    size    Size in bytes to allocate. If size = 0, allocates some minimal size.
+
+    @return MAGMA_SUCCESS
+    @return MAGMA_ERR_DEVICE_ALLOC on failure
+
+    @ingroup magma_malloc
+*******************************************************************************/
+extern "C" magma_int_t
+magma_malloc( magma_ptr* ptrPtr, size_t size )
+{
+    if ( MAGMA_SUCCESS != magma_malloc_aligned( ptrPtr, size )) {
+        return MAGMA_ERR_DEVICE_ALLOC;
+    }
+
+    #ifdef DEBUG_MEMORY
+    g_pointers_mutex.lock();
+    g_pointers_dev[ *ptrPtr ] = size;
+    g_pointers_mutex.unlock();
+    #endif
+
+    return MAGMA_SUCCESS;
+}
+
+
+/***************************************************************************//**
+    @fn magma_free( ptr )
+
+    Frees memory previously allocated by magma_malloc().
+
+    @param[in]
+    ptr     Pointer to free.
+
+    @return MAGMA_SUCCESS
+
+    @ingroup magma_malloc
+*******************************************************************************/
+extern "C" magma_int_t
+magma_free_internal( magma_ptr ptr,
+    const char* func, const char* file, int line )
+{
+    MAGMA_UNUSED( func );
+    MAGMA_UNUSED( file );
+    MAGMA_UNUSED( line );
+
+    #ifdef DEBUG_MEMORY
+    g_pointers_mutex.lock();
+    if ( ptr != NULL && g_pointers_dev.count( ptr ) == 0 ) {
+        fprintf( stderr, "magma_free( %p ) that wasn't allocated with magma_malloc.\n", ptr );
+    }
+    else {
+        g_pointers_dev.erase( ptr );
+    }
+    g_pointers_mutex.unlock();
+    #endif
+
+    magma_free_aligned( ptr );
+    return MAGMA_SUCCESS;
+}
+
+
+/***************************************************************************//**
+    Allocate size bytes on CPU, aligned to a 64 byte boundary,
+    from the size-class pool in control/host_pool.cpp.
+    Use magma_free_cpu() to free this memory.
+
+    @param[out]
+    ptrPtr  On output, set to the pointer that was allocated.
+            NULL on failure.
+
+    @param[in]
+    size    Size in bytes to allocate. If size = 0, allocates some minimal size.
+
+    @return MAGMA_SUCCESS
+    @return MAGMA_ERR_HOST_ALLOC on failure
+
+    @ingroup magma_malloc_cpu
+*******************************************************************************/
+extern "C" magma_int_t
+magma_malloc_cpu( void** ptrPtr, size_t size )
+{
+    if ( size == 0 )
+        size = sizeof(magmaDoubleComplex);
+    *ptrPtr = magma_host_pool_cpu()->allocate( size );
+    if ( *ptrPtr == NULL ) {
+        return MAGMA_ERR_HOST_ALLOC;
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/***************************************************************************//**
+    Frees CPU memory previously allocated by magma_malloc_cpu().
+    For compatibility, memory from malloc() is passed to free().
+
+    @param[in]
+    ptr     Pointer to free.
+
+    @return MAGMA_SUCCESS
+
+    @ingroup magma_malloc_cpu
+*******************************************************************************/
+extern "C" magma_int_t
+magma_free_cpu( void* ptr )
+{
+    if ( ptr != NULL && ! magma_host_pool_cpu()->deallocate( ptr )) {
+        #ifdef DEBUG_MEMORY
+        fprintf( stderr, "magma_free_cpu( %p ) that wasn't allocated with magma_malloc_cpu.\n", ptr );
+        #endif
+        magma_free_aligned( ptr );
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/******************************************************************************/
+// backing allocator of the pinned pool
+static void* magma_pinned_backing_alloc( size_t bytes, int* mapped )
+{
+    *mapped = 0;
+    void* ptr;
+    if ( MAGMA_SUCCESS != magma_malloc_aligned( &ptr, bytes )) {
+        return NULL;
+    }
+    return ptr;
+}
+
+
+/******************************************************************************/
+static void magma_pinned_backing_free( void* ptr, size_t bytes, int mapped )
+{
+    MAGMA_UNUSED( bytes );
+    MAGMA_UNUSED( mapped );
+    magma_free_aligned( ptr );
+}
+
+
+/***************************************************************************//**
+    @return pool behind magma_malloc_pinned; see magma_host_pool_cpu.
+*******************************************************************************/
+magma_host_pool* magma_host_pool_pinned()
+{
+    static magma_host_pool* pool = new magma_host_pool(
+        1, "CPU pinned", magma_pinned_backing_alloc, magma_pinned_backing_free );
+    return pool;
+}
+
+
+/***************************************************************************//**
+    Allocates "pinned" memory on the CPU. The host backend does no DMA,
+    so this is ordinary aligned host memory, pooled like magma_malloc_cpu().
+    Use magma_free_pinned() to free this memory.
+
+    @param[out]
+    ptrPtr  On output, set to the pointer that was allocated.
+            NULL on failure.
+
+    @param[in]
+    size    Size in bytes to allocate. If size = 0, allocates some minimal size.
+
+    @return MAGMA_SUCCESS
+    @return MAGMA_ERR_HOST_ALLOC on failure
+
+    @ingroup magma_malloc_pinned
+*******************************************************************************/
+extern "C" magma_int_t
+magma_malloc_pinned( void** ptrPtr, size_t size )
+{
+    if ( size == 0 )
+        size = sizeof(magmaDoubleComplex);
+    *ptrPtr = magma_host_pool_pinned()->allocate( size );
+    if ( *ptrPtr == NULL ) {
+        return MAGMA_ERR_HOST_ALLOC;
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/***************************************************************************//**
+    @fn magma_free_pinned( ptr )
+
+    Frees CPU pinned memory previously allocated by magma_malloc_pinned().
+
+    @param[in]
+    ptr     Pointer to free.
+
+    @return MAGMA_SUCCESS
+
+    @ingroup magma_malloc_pinned
+*******************************************************************************/
+extern "C" magma_int_t
+magma_free_pinned_internal( void* ptr,
+    const char* func, const char* file, int line )
+{
+    MAGMA_UNUSED( func );
+    MAGMA_UNUSED( file );
+    MAGMA_UNUSED( line );
+
+    if ( ptr != NULL && ! magma_host_pool_pinned()->deallocate( ptr )) {
+        #ifdef DEBUG_MEMORY
+        fprintf( stderr, "magma_free_pinned( %p ) that wasn't allocated with magma_malloc_pinned.\n", ptr );
+        #endif
+        magma_free_aligned( ptr );
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/***************************************************************************//**
+    @fn magma_mem_info( free, total )
+
+    Sets the parameters 'free' and 'total' to the free and total memory in the
+    system (in bytes).
+
+    @param[in]
+    free    Address of the result for 'free' bytes on the system
+    total   Address of the result for 'total' bytes on the system
+
+    @return MAGMA_SUCCESS
+
+*******************************************************************************/
+extern "C" magma_int_t
+magma_mem_info(size_t * freeMem, size_t * totalMem) {
+    size_t page = sysconf( _SC_PAGE_SIZE );
+    *totalMem = page * sysconf( _SC_PHYS_PAGES );
+    *freeMem  = page * sysconf( _SC_AVPHYS_PAGES );
+    return MAGMA_SUCCESS;
+}
+
+
+/******************************************************************************/
+// Task that sets count bytes of ptr to value.
+class magma_memset_task: public magma_task
+{
+public:
+    magma_memset_task( void* ptr, int value, size_t count ):
+        m_ptr( ptr ),
+        m_value( value ),
+        m_count( count )
+    {}
+
+    virtual void run()
+    {
+        memset( m_ptr, m_value, m_count );
+    }
+
+private:
+    void*  m_ptr;
+    int    m_value;
+    size_t m_count;
+};
+
+
+extern "C" magma_int_t
+magma_memset(void * ptr, int value, size_t count) {
+    memset( ptr, value, count );
+    return MAGMA_SUCCESS;
+}
+
+extern "C" magma_int_t
+magma_memset_async(void * ptr, int value, size_t count, magma_queue_t queue) {
+    queue->host_stream()->push_task( new magma_memset_task( ptr, value, count ));
+    return MAGMA_SUCCESS;
+}
@@ -0,0 +1,667 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include "magma_internal.h"
+
+#define COMPLEX
+
+// BLAS for the host backend. "Device" arrays are host memory, so each
+// routine syncs the queue, so earlier async copies have finished,
+// then calls the host BLAS on the calling thread.
+// See interface_cuda/blas_z_v2.cpp for documentation of the arguments.
+
+#ifdef REAL
+// modified Givens rotations, which MAGMA's LAPACK headers don't declare
+#define blasf77_zrotm   FORTRAN_NAME( zrotm,  ZROTM  )
+#define blasf77_zrotmg  FORTRAN_NAME( zrotmg, ZROTMG )
+
+extern "C" {
+void blasf77_zrotm(  const magma_int_t *n,
+                     double *x, const magma_int_t *incx,
+                     double *y, const magma_int_t *incy,
+                     const double *param );
+
+void blasf77_zrotmg( double *d1, double *d2,
+                     double *x1, const double *y1,
+                     double *param );
+}
+#endif // REAL
+
+
+/******************************************************************************/
+extern "C" magma_int_t
+magma_izamax(
+    magma_int_t n,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    return blasf77_izamax( &n, dx, &incx );
+}
+
+
+/******************************************************************************/
+extern "C" magma_int_t
+magma_izamin(
+    magma_int_t n,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    // same definition of |x_i| as izamax, |Re(x_i)| + |Im(x_i)|
+    magma_int_t imin = 0;
+    if ( n > 0 && incx > 0 ) {
+        double xmin = MAGMA_Z_ABS1( dx[0] );
+        imin = 1;
+        for( magma_int_t i=1; i < n; ++i ) {
+            double xi = MAGMA_Z_ABS1( dx[ i*incx ] );
+            if ( xi < xmin ) {
+                xmin = xi;
+                imin = i + 1;
+            }
+        }
+    }
+    return imin;
+}
+
+
+/******************************************************************************/
+extern "C" double
+magma_dzasum(
+    magma_int_t n,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    return magma_cblas_dzasum( n, dx, incx );
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_zaxpy(
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_ptr       dy, magma_int_t incy,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zaxpy( &n, &alpha, dx, &incx, dy, &incy );
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_zcopy(
+    magma_int_t n,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_ptr       dy, magma_int_t incy,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zcopy( &n, dx, &incx, dy, &incy );
+}
+
+
+#ifdef COMPLEX
+/******************************************************************************/
+extern "C"
+magmaDoubleComplex magma_zdotc(
+    magma_int_t n,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_const_ptr dy, magma_int_t incy,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    return magma_cblas_zdotc( n, dx, incx, dy, incy );
+}
+#endif // COMPLEX
+
+
+/******************************************************************************/
+extern "C"
+magmaDoubleComplex magma_zdotu(
+    magma_int_t n,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_const_ptr dy, magma_int_t incy,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    return magma_cblas_zdotu( n, dx, incx, dy, incy );
+}
+
+
+/******************************************************************************/
+extern "C" double
+magma_dznrm2(
+    magma_int_t n,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    return magma_cblas_dznrm2( n, dx, incx );
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_zrot(
+    magma_int_t n,
+    magmaDoubleComplex_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_ptr dy, magma_int_t incy,
+    double c, magmaDoubleComplex s,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zrot( &n, dx, &incx, dy, &incy, &c, &s );
+}
+
+
+#ifdef COMPLEX
+/******************************************************************************/
+extern "C" void
+magma_zdrot(
+    magma_int_t n,
+    magmaDoubleComplex_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_ptr dy, magma_int_t incy,
+    double c, double s,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zdrot( &n, dx, &incx, dy, &incy, &c, &s );
+}
+#endif // COMPLEX
+
+
+/******************************************************************************/
+extern "C" void
+magma_zrotg(
+    magmaDoubleComplex *a, magmaDoubleComplex *b,
+    double             *c, magmaDoubleComplex *s,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zrotg( a, b, c, s );
+}
+
+
+#ifdef REAL
+/******************************************************************************/
+extern "C" void
+magma_zrotm(
+    magma_int_t n,
+    double *dx, magma_int_t incx,
+    double *dy, magma_int_t incy,
+    const double *param,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zrotm( &n, dx, &incx, dy, &incy, param );
+}
+#endif // REAL
+
+
+#ifdef REAL
+/******************************************************************************/
+extern "C" void
+magma_zrotmg(
+    double *d1, double       *d2,
+    double *x1, const double *y1,
+    double *param,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zrotmg( d1, d2, x1, y1, param );
+}
+#endif // REAL
+
+
+/******************************************************************************/
+extern "C" void
+magma_zscal(
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_ptr dx, magma_int_t incx,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zscal( &n, &alpha, dx, &incx );
+}
+
+
+#ifdef COMPLEX
+/******************************************************************************/
+extern "C" void
+magma_zdscal(
+    magma_int_t n,
+    double alpha,
+    magmaDoubleComplex_ptr dx, magma_int_t incx,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zdscal( &n, &alpha, dx, &incx );
+}
+#endif // COMPLEX
+
+
+/******************************************************************************/
+extern "C" void
+magma_zswap(
+    magma_int_t n,
+    magmaDoubleComplex_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_ptr dy, magma_int_t incy,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zswap( &n, dx, &incx, dy, &incy );
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_zgemv(
+    magma_trans_t transA,
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr       dy, magma_int_t incy,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zgemv( lapack_trans_const( transA ), &m, &n,
+                   &alpha, dA, &ldda,
+                           dx, &incx,
+                   &beta,  dy, &incy );
+}
+
+
+#ifdef COMPLEX
+/******************************************************************************/
+extern "C" void
+magma_zgerc(
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_const_ptr dy, magma_int_t incy,
+    magmaDoubleComplex_ptr       dA, magma_int_t ldda,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zgerc( &m, &n, &alpha, dx, &incx, dy, &incy, dA, &ldda );
+}
+#endif // COMPLEX
+
+
+/******************************************************************************/
+extern "C" void
+magma_zgeru(
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_const_ptr dy, magma_int_t incy,
+    magmaDoubleComplex_ptr       dA, magma_int_t ldda,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zgeru( &m, &n, &alpha, dx, &incx, dy, &incy, dA, &ldda );
+}
+
+
+#ifdef COMPLEX
+/******************************************************************************/
+extern "C" void
+magma_zhemv(
+    magma_uplo_t uplo,
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr       dy, magma_int_t incy,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zhemv( lapack_uplo_const( uplo ), &n,
+                   &alpha, dA, &ldda,
+                           dx, &incx,
+                   &beta,  dy, &incy );
+}
+#endif // COMPLEX
+
+
+#ifdef COMPLEX
+/******************************************************************************/
+extern "C" void
+magma_zher(
+    magma_uplo_t uplo,
+    magma_int_t n,
+    double alpha,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_ptr       dA, magma_int_t ldda,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zher( lapack_uplo_const( uplo ), &n, &alpha, dx, &incx, dA, &ldda );
+}
+#endif // COMPLEX
+
+
+#ifdef COMPLEX
+/******************************************************************************/
+extern "C" void
+magma_zher2(
+    magma_uplo_t uplo,
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_const_ptr dy, magma_int_t incy,
+    magmaDoubleComplex_ptr       dA, magma_int_t ldda,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zher2( lapack_uplo_const( uplo ), &n, &alpha, dx, &incx, dy, &incy, dA, &ldda );
+}
+#endif // COMPLEX
+
+
+/******************************************************************************/
+extern "C" void
+magma_zsymv(
+    magma_uplo_t uplo,
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr       dy, magma_int_t incy,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    #ifdef COMPLEX
+    lapackf77_zsymv( lapack_uplo_const( uplo ), &n,
+                     &alpha, dA, &ldda,
+                             dx, &incx,
+                     &beta,  dy, &incy );
+    #else
+    blasf77_zhemv( lapack_uplo_const( uplo ), &n,
+                   &alpha, dA, &ldda,
+                           dx, &incx,
+                   &beta,  dy, &incy );
+    #endif
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_zsyr(
+    magma_uplo_t uplo,
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_ptr       dA, magma_int_t ldda,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    #ifdef COMPLEX
+    lapackf77_zsyr( lapack_uplo_const( uplo ), &n, &alpha, dx, &incx, dA, &ldda );
+    #else
+    blasf77_zher( lapack_uplo_const( uplo ), &n, &alpha, dx, &incx, dA, &ldda );
+    #endif
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_zsyr2(
+    magma_uplo_t uplo,
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_const_ptr dy, magma_int_t incy,
+    magmaDoubleComplex_ptr       dA, magma_int_t ldda,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    #ifdef COMPLEX
+    // no complex symmetric rank-2 update in BLAS or LAPACK; use syr2k with
+    // k = 1, viewing x and y as 1-by-n matrices with leading dimension inc.
+    const magmaDoubleComplex c_one = MAGMA_Z_ONE;
+    const magma_int_t ione = 1;
+    blasf77_zsyr2k( lapack_uplo_const( uplo ), MagmaTransStr, &n, &ione,
+                    &alpha, dx, &incx,
+                            dy, &incy,
+                    &c_one, dA, &ldda );
+    #else
+    blasf77_zher2( lapack_uplo_const( uplo ), &n, &alpha, dx, &incx, dy, &incy, dA, &ldda );
+    #endif
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_ztrmv(
+    magma_uplo_t uplo, magma_trans_t trans, magma_diag_t diag,
+    magma_int_t n,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_ptr       dx, magma_int_t incx,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_ztrmv( lapack_uplo_const( uplo ), lapack_trans_const( trans ),
+                   lapack_diag_const( diag ),
+                   &n, dA, &ldda, dx, &incx );
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_ztrsv(
+    magma_uplo_t uplo, magma_trans_t trans, magma_diag_t diag,
+    magma_int_t n,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_ptr       dx, magma_int_t incx,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_ztrsv( lapack_uplo_const( uplo ), lapack_trans_const( trans ),
+                   lapack_diag_const( diag ),
+                   &n, dA, &ldda, dx, &incx );
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_zgemm(
+    magma_trans_t transA, magma_trans_t transB,
+    magma_int_t m, magma_int_t n, magma_int_t k,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_const_ptr dB, magma_int_t lddb,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr       dC, magma_int_t lddc,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zgemm( lapack_trans_const( transA ), lapack_trans_const( transB ),
+                   &m, &n, &k,
+                   &alpha, dA, &ldda,
+                           dB, &lddb,
+                   &beta,  dC, &lddc );
+}
+
+
+#ifdef COMPLEX
+/******************************************************************************/
+extern "C" void
+magma_zhemm(
+    magma_side_t side, magma_uplo_t uplo,
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_const_ptr dB, magma_int_t lddb,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr       dC, magma_int_t lddc,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zhemm( lapack_side_const( side ), lapack_uplo_const( uplo ),
+                   &m, &n,
+                   &alpha, dA, &ldda,
+                           dB, &lddb,
+                   &beta,  dC, &lddc );
+}
+#endif // COMPLEX
+
+
+#ifdef COMPLEX
+/******************************************************************************/
+extern "C" void
+magma_zherk(
+    magma_uplo_t uplo, magma_trans_t trans,
+    magma_int_t n, magma_int_t k,
+    double alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    double beta,
+    magmaDoubleComplex_ptr       dC, magma_int_t lddc,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zherk( lapack_uplo_const( uplo ), lapack_trans_const( trans ),
+                   &n, &k,
+                   &alpha, dA, &ldda,
+                   &beta,  dC, &lddc );
+}
+#endif // COMPLEX
+
+
+#ifdef COMPLEX
+/******************************************************************************/
+extern "C" void
+magma_zher2k(
+    magma_uplo_t uplo, magma_trans_t trans,
+    magma_int_t n, magma_int_t k,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_const_ptr dB, magma_int_t lddb,
+    double beta,
+    magmaDoubleComplex_ptr       dC, magma_int_t lddc,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zher2k( lapack_uplo_const( uplo ), lapack_trans_const( trans ),
+                    &n, &k,
+                    &alpha, dA, &ldda,
+                            dB, &lddb,
+                    &beta,  dC, &lddc );
+}
+#endif // COMPLEX
+
+
+/******************************************************************************/
+extern "C" void
+magma_zsymm(
+    magma_side_t side, magma_uplo_t uplo,
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_const_ptr dB, magma_int_t lddb,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr       dC, magma_int_t lddc,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zsymm( lapack_side_const( side ), lapack_uplo_const( uplo ),
+                   &m, &n,
+                   &alpha, dA, &ldda,
+                           dB, &lddb,
+                   &beta,  dC, &lddc );
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_zsyrk(
+    magma_uplo_t uplo, magma_trans_t trans,
+    magma_int_t n, magma_int_t k,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr       dC, magma_int_t lddc,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zsyrk( lapack_uplo_const( uplo ), lapack_trans_const( trans ),
+                   &n, &k,
+                   &alpha, dA, &ldda,
+                   &beta,  dC, &lddc );
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_zsyr2k(
+    magma_uplo_t uplo, magma_trans_t trans,
+    magma_int_t n, magma_int_t k,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_const_ptr dB, magma_int_t lddb,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr       dC, magma_int_t lddc,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_zsyr2k( lapack_uplo_const( uplo ), lapack_trans_const( trans ),
+                    &n, &k,
+                    &alpha, dA, &ldda,
+                            dB, &lddb,
+                    &beta,  dC, &lddc );
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_ztrmm(
+    magma_side_t side, magma_uplo_t uplo, magma_trans_t trans, magma_diag_t diag,
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_ptr       dB, magma_int_t lddb,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_ztrmm( lapack_side_const( side ), lapack_uplo_const( uplo ),
+                   lapack_trans_const( trans ), lapack_diag_const( diag ),
+                   &m, &n,
+                   &alpha, dA, &ldda,
+                           dB, &lddb );
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_ztrsm(
+    magma_side_t side, magma_uplo_t uplo, magma_trans_t trans, magma_diag_t diag,
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_ptr       dB, magma_int_t lddb,
+    magma_queue_t queue )
+{
+    magma_queue_sync( queue );
+    blasf77_ztrsm( lapack_side_const( side ), lapack_uplo_const( uplo ),
+                   lapack_trans_const( trans ), lapack_diag_const( diag ),
+                   &m, &n,
+                   &alpha, dA, &ldda,
+                           dB, &lddb );
+}
+
+#undef COMPLEX
@@ -0,0 +1,299 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+#include <string.h>
+
+#include "host_stream.hpp"
+
+// Generic, type-independent routines to copy data, for the host backend.
+// Type-safe versions which avoid the user needing sizeof(...) are in headers;
+// see magma_{s,d,c,z,i,index_}{set,get,copy}{matrix,vector}
+//
+// Host and "device" memory are both host memory, so set, get, and copy are
+// the same operation. Synchronous versions sync the queue, then copy on the
+// calling thread; async versions push the copy to the queue's worker thread.
+// As with CUDA, the source must not be modified, and the destination not
+// read, until the queue is synced or an event recorded after the copy
+// has triggered.
+// Vectors are copied as 1-by-n matrices with leading dimension inc.
+
+
+/******************************************************************************/
+// B = A, where A and B are m-by-n matrices of elemSize-byte elements.
+static void
+magma_copy_host(
+    magma_int_t m, magma_int_t n, magma_int_t elemSize,
+    const void* A, magma_int_t lda,
+    void*       B, magma_int_t ldb )
+{
+    if ( m <= 0 || n <= 0 ) {
+        return;
+    }
+    const char* src = (const char*) A;
+    char*       dst = (char*) B;
+    if ( m == lda && m == ldb ) {
+        memcpy( dst, src, size_t(m) * size_t(n) * size_t(elemSize) );
+    }
+    else {
+        for( magma_int_t j=0; j < n; ++j ) {
+            memcpy( dst + size_t(j) * size_t(ldb) * size_t(elemSize),
+                    src + size_t(j) * size_t(lda) * size_t(elemSize),
+                    size_t(m) * size_t(elemSize) );
+        }
+    }
+}
+
+
+/******************************************************************************/
+// Task that does magma_copy_host on a queue's worker thread.
+class magma_copy_task: public magma_task
+{
+public:
+    magma_copy_task(
+        magma_int_t m, magma_int_t n, magma_int_t elemSize,
+        const void* A, magma_int_t lda,
+        void*       B, magma_int_t ldb ):
+        m_m( m ), m_n( n ), m_elemSize( elemSize ),
+        m_A( A ), m_lda( lda ),
+        m_B( B ), m_ldb( ldb )
+    {}
+
+    virtual void run()
+    {
+        magma_copy_host( m_m, m_n, m_elemSize, m_A, m_lda, m_B, m_ldb );
+    }
+
+private:
+    magma_int_t m_m, m_n, m_elemSize;
+    const void* m_A;
+    magma_int_t m_lda;
+    void*       m_B;
+    magma_int_t m_ldb;
+};
+
+
+/******************************************************************************/
+// Synchronous copy: waits for earlier work in queue, then copies.
+static void
+magma_copy_sync(
+    magma_int_t m, magma_int_t n, magma_int_t elemSize,
+    const void* A, magma_int_t lda,
+    void*       B, magma_int_t ldb,
+    magma_queue_t queue )
+{
+    if ( queue != NULL ) {
+        queue->host_stream()->sync();
+    }
+    magma_copy_host( m, n, elemSize, A, lda, B, ldb );
+}
+
+
+/******************************************************************************/
+// Asynchronous copy: pushes the copy to queue.
+// For backwards compatability, accepts NULL queue and copies synchronously.
+static void
+magma_copy_async(
+    magma_int_t m, magma_int_t n, magma_int_t elemSize,
+    const void* A, magma_int_t lda,
+    void*       B, magma_int_t ldb,
+    magma_queue_t queue, const char* func )
+{
+    if ( queue == NULL ) {
+        fprintf( stderr, "Warning: %s got NULL queue\n", func );
+        magma_copy_host( m, n, elemSize, A, lda, B, ldb );
+    }
+    else if ( m > 0 && n > 0 ) {
+        queue->host_stream()->push_task(
+            new magma_copy_task( m, n, elemSize, A, lda, B, ldb ));
+    }
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_setvector_internal(
+    magma_int_t n, magma_int_t elemSize,
+    void const* hx_src, magma_int_t incx,
+    magma_ptr   dy_dst, magma_int_t incy,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    MAGMA_UNUSED( file );
+    MAGMA_UNUSED( line );
+    MAGMA_UNUSED( func );
+    magma_copy_sync( 1, n, elemSize, hx_src, incx, dy_dst, incy, queue );
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_setvector_async_internal(
+    magma_int_t n, magma_int_t elemSize,
+    void const* hx_src, magma_int_t incx,
+    magma_ptr   dy_dst, magma_int_t incy,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    MAGMA_UNUSED( file );
+    MAGMA_UNUSED( line );
+    magma_copy_async( 1, n, elemSize, hx_src, incx, dy_dst, incy, queue, func );
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_getvector_internal(
+    magma_int_t n, magma_int_t elemSize,
+    magma_const_ptr dx_src, magma_int_t incx,
+    void*           hy_dst, magma_int_t incy,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    MAGMA_UNUSED( file );
+    MAGMA_UNUSED( line );
+    MAGMA_UNUSED( func );
+    magma_copy_sync( 1, n, elemSize, dx_src, incx, hy_dst, incy, queue );
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_getvector_async_internal(
+    magma_int_t n, magma_int_t elemSize,
+    magma_const_ptr dx_src, magma_int_t incx,
+    void*           hy_dst, magma_int_t incy,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    MAGMA_UNUSED( file );
+    MAGMA_UNUSED( line );
+    magma_copy_async( 1, n, elemSize, dx_src, incx, hy_dst, incy, queue, func );
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_copyvector_internal(
+    magma_int_t n, magma_int_t elemSize,
+    magma_const_ptr dx_src, magma_int_t incx,
+    magma_ptr       dy_dst, magma_int_t incy,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    MAGMA_UNUSED( file );
+    MAGMA_UNUSED( line );
+    MAGMA_UNUSED( func );
+    magma_copy_sync( 1, n, elemSize, dx_src, incx, dy_dst, incy, queue );
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_copyvector_async_internal(
+    magma_int_t n, magma_int_t elemSize,
+    magma_const_ptr dx_src, magma_int_t incx,
+    magma_ptr       dy_dst, magma_int_t incy,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    MAGMA_UNUSED( file );
+    MAGMA_UNUSED( line );
+    magma_copy_async( 1, n, elemSize, dx_src, incx, dy_dst, incy, queue, func );
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_setmatrix_internal(
+    magma_int_t m, magma_int_t n, magma_int_t elemSize,
+    void const* hA_src, magma_int_t lda,
+    magma_ptr   dB_dst, magma_int_t lddb,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    MAGMA_UNUSED( file );
+    MAGMA_UNUSED( line );
+    MAGMA_UNUSED( func );
+    magma_copy_sync( m, n, elemSize, hA_src, lda, dB_dst, lddb, queue );
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_setmatrix_async_internal(
+    magma_int_t m, magma_int_t n, magma_int_t elemSize,
+    void const* hA_src, magma_int_t lda,
+    magma_ptr   dB_dst, magma_int_t lddb,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    MAGMA_UNUSED( file );
+    MAGMA_UNUSED( line );
+    magma_copy_async( m, n, elemSize, hA_src, lda, dB_dst, lddb, queue, func );
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_getmatrix_internal(
+    magma_int_t m, magma_int_t n, magma_int_t elemSize,
+    magma_const_ptr dA_src, magma_int_t ldda,
+    void*           hB_dst, magma_int_t ldb,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    MAGMA_UNUSED( file );
+    MAGMA_UNUSED( line );
+    MAGMA_UNUSED( func );
+    magma_copy_sync( m, n, elemSize, dA_src, ldda, hB_dst, ldb, queue );
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_getmatrix_async_internal(
+    magma_int_t m, magma_int_t n, magma_int_t elemSize,
+    magma_const_ptr dA_src, magma_int_t ldda,
+    void*           hB_dst, magma_int_t ldb,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    MAGMA_UNUSED( file );
+    MAGMA_UNUSED( line );
+    magma_copy_async( m, n, elemSize, dA_src, ldda, hB_dst, ldb, queue, func );
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_copymatrix_internal(
+    magma_int_t m, magma_int_t n, magma_int_t elemSize,
+    magma_const_ptr dA_src, magma_int_t ldda,
+    magma_ptr       dB_dst, magma_int_t lddb,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    MAGMA_UNUSED( file );
+    MAGMA_UNUSED( line );
+    MAGMA_UNUSED( func );
+    magma_copy_sync( m, n, elemSize, dA_src, ldda, dB_dst, lddb, queue );
+}
+
+
+/******************************************************************************/
+extern "C" void
+magma_copymatrix_async_internal(
+    magma_int_t m, magma_int_t n, magma_int_t elemSize,
+    magma_const_ptr dA_src, magma_int_t ldda,
+    magma_ptr       dB_dst, magma_int_t lddb,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    MAGMA_UNUSED( file );
+    MAGMA_UNUSED( line );
+    magma_copy_async( m, n, elemSize, dA_src, ldda, dB_dst, lddb, queue, func );
+}
@@ -0,0 +1,189 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+
+#include "host_stream.hpp"
+
+// If err, prints error and throws exception.
+static void check( int err )
+{
+    if ( err != 0 ) {
+        fprintf( stderr, "Error: %s (%d)\n", strerror(err), err );
+        throw std::exception();
+    }
+}
+
+
+/***************************************************************************//**
+    Worker's main routine, executed by pthread_create.
+    @param[in,out] arg    magma_host_stream to run tasks from.
+*******************************************************************************/
+extern "C"
+void* magma_host_stream_main( void* arg )
+{
+    magma_host_stream* stream = (magma_host_stream*) arg;
+    stream->worker();
+    return NULL;  // implicitly does pthread_exit
+}
+
+
+/***************************************************************************//**
+    Creates stream with no worker; the worker is created by the first push.
+*******************************************************************************/
+magma_host_stream::magma_host_stream():
+    q        (),
+    started  ( false ),
+    quit_flag( false ),
+    nsubmit  ( 0 ),
+    ncomplete( 0 ),
+    nref     ( 1 )
+{
+    check( pthread_mutex_init( &mutex,     NULL ));
+    check( pthread_cond_init(  &cond,      NULL ));
+    check( pthread_cond_init(  &cond_done, NULL ));
+}
+
+
+/***************************************************************************//**
+    Finishes all tasks, joins the worker, then deallocates data.
+*******************************************************************************/
+magma_host_stream::~magma_host_stream()
+{
+    shutdown();
+    check( pthread_mutex_destroy( &mutex ));
+    check( pthread_cond_destroy( &cond ));
+    check( pthread_cond_destroy( &cond_done ));
+}
+
+
+/***************************************************************************//**
+    Runs tasks in order until the queue is empty and quit is set.
+*******************************************************************************/
+void magma_host_stream::worker()
+{
+    while( true ) {
+        check( pthread_mutex_lock( &mutex ));
+        while( q.empty() && ! quit_flag ) {
+            check( pthread_cond_wait( &cond, &mutex ));
+        }
+        if ( q.empty() ) {
+            check( pthread_mutex_unlock( &mutex ));
+            break;
+        }
+        magma_task* task = q.front();
+        q.pop();
+        check( pthread_mutex_unlock( &mutex ));
+
+        task->run();
+        delete task;
+
+        check( pthread_mutex_lock( &mutex ));
+        ncomplete += 1;
+        check( pthread_cond_broadcast( &cond_done ));
+        check( pthread_mutex_unlock( &mutex ));
+    }
+}
+
+
+/***************************************************************************//**
+    Adds task to the end of the stream. Task must be allocated with C++ new;
+    the worker deletes it after running it.
+    @return ticket of the task, for wait().
+*******************************************************************************/
+long magma_host_stream::push_task( magma_task* task )
+{
+    check( pthread_mutex_lock( &mutex ));
+    if ( ! started ) {
+        check( pthread_create( &thread, NULL, magma_host_stream_main, this ));
+        started = true;
+    }
+    q.push( task );
+    nsubmit += 1;
+    long ticket = nsubmit;
+    check( pthread_cond_broadcast( &cond ));
+    check( pthread_mutex_unlock( &mutex ));
+    return ticket;
+}
+
+
+/***************************************************************************//**
+    @return ticket of the most recently pushed task, or 0 if none.
+*******************************************************************************/
+long magma_host_stream::last_ticket()
+{
+    check( pthread_mutex_lock( &mutex ));
+    long ticket = nsubmit;
+    check( pthread_mutex_unlock( &mutex ));
+    return ticket;
+}
+
+
+/***************************************************************************//**
+    Blocks until the task with the given ticket, and all tasks before it,
+    have finished.
+*******************************************************************************/
+void magma_host_stream::wait( long ticket )
+{
+    check( pthread_mutex_lock( &mutex ));
+    while( ncomplete < ticket ) {
+        check( pthread_cond_wait( &cond_done, &mutex ));
+    }
+    check( pthread_mutex_unlock( &mutex ));
+}
+
+
+/***************************************************************************//**
+    Blocks until all tasks pushed so far have finished.
+*******************************************************************************/
+void magma_host_stream::sync()
+{
+    wait( last_ticket() );
+}
+
+
+/***************************************************************************//**
+    Finishes all tasks and joins the worker. Afterwards, every ticket has
+    finished, so wait() returns at once; no tasks may be pushed.
+*******************************************************************************/
+void magma_host_stream::shutdown()
+{
+    check( pthread_mutex_lock( &mutex ));
+    quit_flag = true;
+    bool join = started;
+    started = false;
+    check( pthread_cond_broadcast( &cond ));
+    check( pthread_mutex_unlock( &mutex ));
+    if ( join ) {
+        check( pthread_join( thread, NULL ));
+    }
+}
+
+
+/***************************************************************************//**
+    Adds a reference to the stream.
+*******************************************************************************/
+void magma_host_stream::retain()
+{
+    check( pthread_mutex_lock( &mutex ));
+    nref += 1;
+    check( pthread_mutex_unlock( &mutex ));
+}
+
+
+/***************************************************************************//**
+    Drops a reference to the stream; deletes it if that was the last one.
+*******************************************************************************/
+void magma_host_stream::release()
+{
+    check( pthread_mutex_lock( &mutex ));
+    nref -= 1;
+    bool last = (nref == 0);
+    check( pthread_mutex_unlock( &mutex ));
+    if ( last ) {
+        delete this;
+    }
+}
@@ -0,0 +1,83 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+
+#ifndef MAGMA_HOST_STREAM_HPP
+#define MAGMA_HOST_STREAM_HPP
+
+#include <queue>
+
+#include "magma_internal.h"
+#include "thread_queue.hpp"  // magma_task
+
+
+/******************************************************************************/
+extern "C"
+void* magma_host_stream_main( void* arg );
+
+
+/***************************************************************************//**
+    In-order execution context behind a magma_queue_t in the host backend.
+    Tasks pushed to the stream run one at a time, in order, on a single
+    worker thread that is created on the first push. Each task gets a
+    ticket, numbered from 1; wait( ticket ) blocks until that task and all
+    tasks before it have finished, which is how queue sync and events are
+    implemented.
+    The stream is reference counted: the queue and each event recorded in
+    it hold a reference, so an event can still be waited on after its queue
+    is destroyed. The queue calls shutdown(), which finishes all tasks and
+    joins the worker, then release(); the last release() deletes the stream.
+    @ingroup magma_thread
+*******************************************************************************/
+struct magma_host_stream
+{
+public:
+    magma_host_stream();
+
+    long push_task( magma_task* task );
+    long last_ticket();
+    void wait( long ticket );
+    void sync();
+    void shutdown();
+
+    void retain();
+    void release();
+
+protected:
+    friend void* magma_host_stream_main( void* arg );
+    void worker();
+
+    ~magma_host_stream();  // use release()
+
+private:
+    std::queue< magma_task* > q;  ///<  tasks not yet started
+    pthread_mutex_t mutex;        ///<  mutex lock for q, nsubmit, ncomplete, quit_flag
+    pthread_cond_t  cond;         ///<  signals a new task or quit to the worker
+    pthread_cond_t  cond_done;    ///<  signals that ncomplete increased
+    pthread_t       thread;
+    bool            started;      ///<  worker thread has been created
+    bool            quit_flag;
+    long            nsubmit;      ///<  tickets handed out
+    long            ncomplete;    ///<  tickets finished; tasks finish in order
+    long            nref;         ///<  references: queue, events, wait tasks
+};
+
+
+/***************************************************************************//**
+    Event recorded in a magma_host_stream: it has occurred once the stream's
+    task with the given ticket has finished. An event that was never
+    recorded (stream == NULL) has always occurred. The event holds a
+    reference to the stream while it is recorded there.
+    @ingroup magma_event
+*******************************************************************************/
+struct magma_event
+{
+    magma_host_stream* stream;
+    long               ticket;
+};
+
+#endif        //  #ifndef MAGMA_HOST_STREAM_HPP
@@ -0,0 +1,634 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <map>
+#include <mutex>  // requires C++11
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#if defined(MAGMA_WITH_MKL)
+#include <mkl_service.h>
+#endif
+
+#include "host_pool.hpp"
+#include "host_stream.hpp"
+
+#define MAX_BATCHCOUNT    (65534)
+
+#ifdef DEBUG_MEMORY
+// defined in alloc.cpp
+extern std::map< void*, size_t > g_pointers_dev;
+
+// -----------------------------------------------------------------------------
+// prototypes
+extern "C" void
+magma_warn_leaks( const std::map< void*, size_t >& pointers, const char* type );
+#endif
+
+
+// -----------------------------------------------------------------------------
+// globals
+static std::mutex g_mutex;
+
+// count of (init - finalize) calls
+static int g_init = 0;
+
+
+// =============================================================================
+// initialization
+
+/***************************************************************************//**
+    Initializes the MAGMA library.
+    In the host backend there is a single "device", the CPU, so this only
+    counts init calls; queues create their worker threads lazily.
+
+    Every magma_init call must be paired with a magma_finalize call.
+
+    @retval MAGMA_SUCCESS
+
+    @see magma_finalize
+
+    @ingroup magma_init
+*******************************************************************************/
+extern "C" magma_int_t
+magma_init()
+{
+    g_mutex.lock();
+    g_init += 1;  // increment (init - finalize) count
+    g_mutex.unlock();
+    return MAGMA_SUCCESS;
+}
+
+
+/***************************************************************************//**
+    Frees information used by the MAGMA library.
+    @see magma_init
+
+    @ingroup magma_init
+*******************************************************************************/
+extern "C" magma_int_t
+magma_finalize()
+{
+    magma_int_t info = 0;
+
+    g_mutex.lock();
+    {
+        if ( g_init <= 0 ) {
+            info = MAGMA_ERR_NOT_INITIALIZED;
+        }
+        else {
+            g_init -= 1;  // decrement (init - finalize) count
+            if ( g_init == 0 ) {
+                // exit CPU worker threads (bulge chasing, trevc, etc.)
+                magma_thread_pool_shutdown();
+
+                #ifdef DEBUG_MEMORY
+                magma_warn_leaks( g_pointers_dev, "device" );
+                std::map< void*, size_t > pointers_cpu, pointers_pin;
+                magma_host_pool_cpu()   ->get_pointers( pointers_cpu );
+                magma_host_pool_pinned()->get_pointers( pointers_pin );
+                magma_warn_leaks( pointers_cpu, "CPU" );
+                magma_warn_leaks( pointers_pin, "CPU pinned" );
+                #endif
+
+                // free host blocks cached for reuse
+                magma_mem_pool_release();
+            }
+        }
+    }
+    g_mutex.unlock();
+
+    return info;
+}
+
+
+// =============================================================================
+// testing and debugging support
+
+#ifdef DEBUG_MEMORY
+/***************************************************************************//**
+    If DEBUG_MEMORY is defined at compile time, prints warnings when
+    magma_finalize() is called for any device, CPU, or CPU pinned
+    allocations that were not freed.
+
+    @param[in]
+    pointers    Hash table mapping allocated pointers to size.
+
+    @param[in]
+    type        String describing type of pointers (device, CPU, etc.)
+
+    @ingroup magma_testing
+*******************************************************************************/
+extern "C" void
+magma_warn_leaks( const std::map< void*, size_t >& pointers, const char* type )
+{
+    if ( pointers.size() > 0 ) {
+        fprintf( stderr, "Warning: MAGMA detected memory leak of %llu %s pointers:\n",
+                 (long long unsigned) pointers.size(), type );
+        std::map< void*, size_t >::const_iterator iter;
+        for( iter = pointers.begin(); iter != pointers.end(); ++iter ) {
+            fprintf( stderr, "    pointer %p, size %lu\n", iter->first, iter->second );
+        }
+    }
+}
+#endif
+
+
+/***************************************************************************//**
+    Print MAGMA version, backend, LAPACK/BLAS library version,
+    number of threads, date, etc.
+    Used in testing.
+    @ingroup magma_testing
+*******************************************************************************/
+extern "C" void
+magma_print_environment()
+{
+    magma_int_t major, minor, micro;
+    magma_version( &major, &minor, &micro );
+
+    printf( "%% MAGMA %lld.%lld.%lld %s %lld-bit magma_int_t, %lld-bit pointer.\n",
+            (long long) major, (long long) minor, (long long) micro,
+            MAGMA_VERSION_STAGE,
+            (long long) (8*sizeof(magma_int_t)),
+            (long long) (8*sizeof(void*)) );
+
+    printf( "%% Host backend (no GPU). " );
+
+#if defined(_OPENMP)
+    int omp_threads = 0;
+    #pragma omp parallel
+    {
+        omp_threads = omp_get_num_threads();
+    }
+    printf( "OpenMP threads %d. ", omp_threads );
+#else
+    printf( "MAGMA not compiled with OpenMP. " );
+#endif
+
+#if defined(MAGMA_WITH_MKL)
+    MKLVersion mkl_version;
+    mkl_get_version( &mkl_version );
+    printf( "MKL %d.%d.%d, MKL threads %d. ",
+            mkl_version.MajorVersion,
+            mkl_version.MinorVersion,
+            mkl_version.UpdateVersion,
+            mkl_get_max_threads() );
+#endif
+
+    printf( "\n" );
+
+    printf( "%% device 0: host, %lld cores, %.1f MiB memory\n",
+            (long long) magma_getdevice_multiprocessor_count(),
+            magma_mem_size( NULL ) / (1024.*1024.) );
+
+    time_t t = time( NULL );
+    printf( "%% %s", ctime( &t ));
+}
+
+
+/***************************************************************************//**
+    For debugging purposes, determines whether a pointer points to CPU or GPU memory.
+    In the host backend, all memory is host memory.
+
+    @param[in] A    pointer to test
+
+    @return  0:  host pointer, always.
+
+    @ingroup magma_util
+*******************************************************************************/
+extern "C" magma_int_t
+magma_is_devptr( const void* A )
+{
+    MAGMA_UNUSED( A );
+    return 0;
+}
+
+
+// =============================================================================
+// device support
+
+/***************************************************************************//**
+    @return 0; the host backend has no CUDA architecture, so code paths
+    that depend on it take their most conservative branch.
+
+    @ingroup magma_device
+*******************************************************************************/
+extern "C" magma_int_t
+magma_getdevice_arch()
+{
+    return 0;
+}
+
+
+/***************************************************************************//**
+    Fills in devices array with the available devices.
+    The host backend has exactly one device, 0.
+
+    @param[out]
+    devices     Array of dimension (size).
+                On output, devices[0, ..., num_dev-1] contain device IDs.
+                Entries >= num_dev are not touched.
+
+    @param[in]
+    size        Dimension of the array devices.
+
+    @param[out]
+    num_dev     Number of devices, limited to size.
+
+    @ingroup magma_device
+*******************************************************************************/
+extern "C" void
+magma_getdevices(
+    magma_device_t* devices,
+    magma_int_t  size,
+    magma_int_t* num_dev )
+{
+    *num_dev = 0;
+    if ( size >= 1 ) {
+        devices[0] = 0;
+        *num_dev = 1;
+    }
+}
+
+
+/***************************************************************************//**
+    Get the current device, which is always 0 in the host backend.
+
+    @param[out]
+    device      On output, device ID of the current device.
+
+    @ingroup magma_device
+*******************************************************************************/
+extern "C" void
+magma_getdevice( magma_device_t* device )
+{
+    *device = 0;
+}
+
+
+/***************************************************************************//**
+    Set the current device. The host backend has only device 0.
+
+    @param[in]
+    device      Device ID to set as the current device.
+
+    @ingroup magma_device
+*******************************************************************************/
+extern "C" void
+magma_setdevice( magma_device_t device )
+{
+    if ( device != 0 ) {
+        fprintf( stderr, "Warning: %s( %lld ): host backend has only device 0\n",
+                 __func__, (long long) device );
+    }
+}
+
+
+/***************************************************************************//**
+    @return the number of online CPU cores, which plays the role of the
+    multiprocessor count in the host backend.
+
+    @ingroup magma_device
+*******************************************************************************/
+extern "C" magma_int_t
+magma_getdevice_multiprocessor_count()
+{
+    long ncore = sysconf( _SC_NPROCESSORS_ONLN );
+    return max( 1, (magma_int_t) ncore );
+}
+
+
+/***************************************************************************//**
+    @return 0; there is no shared memory in the host backend.
+
+    @ingroup magma_device
+*******************************************************************************/
+extern "C" size_t
+magma_getdevice_shmem_block()
+{
+    return 0;
+}
+
+
+/***************************************************************************//**
+    @return 0; there is no shared memory in the host backend.
+
+    @ingroup magma_device
+*******************************************************************************/
+extern "C" size_t
+magma_getdevice_shmem_multiprocessor()
+{
+    return 0;
+}
+
+
+/***************************************************************************//**
+    @param[in]
+    queue           Queue to query; unused.
+
+    @return         Amount of free host memory in bytes.
+
+    @ingroup magma_queue
+*******************************************************************************/
+extern "C" size_t
+magma_mem_size( magma_queue_t queue )
+{
+    MAGMA_UNUSED( queue );
+    size_t freeMem, totalMem;
+    magma_mem_info( &freeMem, &totalMem );
+    return freeMem;
+}
+
+
+// =============================================================================
+// queue support
+
+/***************************************************************************//**
+    @param[in]
+    queue       Queue to query.
+
+    @return Device ID associated with the MAGMA queue.
+
+    @ingroup magma_queue
+*******************************************************************************/
+extern "C"
+magma_int_t
+magma_queue_get_device( magma_queue_t queue )
+{
+    return queue->device();
+}
+
+
+/***************************************************************************//**
+    @fn magma_queue_create( device, queue_ptr )
+
+    magma_queue_create( device, queue_ptr ) is the preferred alias to this
+    function.
+
+    Creates a new MAGMA queue. In the host backend, the queue owns a
+    magma_host_stream: async copies and memsets are pushed to its worker
+    thread and run in order; BLAS calls and synchronous copies first sync
+    the queue, then run on the calling thread.
+
+    @param[in]
+    device          Device to create queue on; must be 0.
+
+    @param[out]
+    queue_ptr       On output, the newly created queue.
+
+    @ingroup magma_queue
+*******************************************************************************/
+extern "C" void
+magma_queue_create_internal(
+    magma_device_t device, magma_queue_t* queue_ptr,
+    const char* func, const char* file, int line )
+{
+    MAGMA_UNUSED( func );
+    MAGMA_UNUSED( file );
+    MAGMA_UNUSED( line );
+
+    magma_queue_t queue;
+    magma_malloc_cpu( (void**)&queue, sizeof(*queue) );
+    assert( queue != NULL );
+    *queue_ptr = queue;
+
+    queue->own__      = 0;
+    queue->device__   = device;
+    queue->ptrArray__ = NULL;
+    queue->dAarray__  = NULL;
+    queue->dBarray__  = NULL;
+    queue->dCarray__  = NULL;
+    queue->maxbatch__ = MAX_BATCHCOUNT;
+
+    magma_setdevice( device );
+
+    queue->stream__ = new magma_host_stream();
+}
+
+
+/***************************************************************************//**
+    @fn magma_queue_destroy( queue )
+
+    Finishes all work in the queue, then destroys it and its worker thread.
+
+    @param[in]
+    queue           Queue to destroy.
+
+    @ingroup magma_queue
+*******************************************************************************/
+extern "C" void
+magma_queue_destroy_internal(
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    MAGMA_UNUSED( func );
+    MAGMA_UNUSED( file );
+    MAGMA_UNUSED( line );
+
+    if ( queue != NULL ) {
+        // events recorded in the queue keep the stream until destroyed
+        queue->stream__->shutdown();
+        queue->stream__->release();
+
+        if ( queue->ptrArray__ != NULL ) magma_free( queue->ptrArray__ );
+
+        queue->device__   = -1;
+        queue->stream__   = NULL;
+        queue->ptrArray__ = NULL;
+        queue->dAarray__  = NULL;
+        queue->dBarray__  = NULL;
+        queue->dCarray__  = NULL;
+
+        magma_free_cpu( queue );
+    }
+}
+
+
+/***************************************************************************//**
+    @fn magma_queue_sync( queue )
+
+    Synchronizes with a queue. The CPU blocks until all operations on the queue
+    are finished. A NULL queue has no pending operations.
+
+    @param[in]
+    queue           Queue to synchronize.
+
+    @ingroup magma_queue
+*******************************************************************************/
+extern "C" void
+magma_queue_sync_internal(
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    MAGMA_UNUSED( func );
+    MAGMA_UNUSED( file );
+    MAGMA_UNUSED( line );
+
+    if ( queue != NULL ) {
+        queue->host_stream()->sync();
+    }
+}
+
+
+// =============================================================================
+// event support
+
+/***************************************************************************//**
+    Creates an event.
+
+    @param[in]
+    event           On output, the newly created event.
+
+    @ingroup magma_event
+*******************************************************************************/
+extern "C" void
+magma_event_create( magma_event_t* event )
+{
+    magma_malloc_cpu( (void**) event, sizeof(**event) );
+    assert( *event != NULL );
+    (*event)->stream = NULL;
+    (*event)->ticket = 0;
+}
+
+
+/***************************************************************************//**
+    Creates an event. Events never record timing in the host backend,
+    so this is the same as magma_event_create.
+
+    @param[in]
+    event           On output, the newly created event.
+
+    @ingroup magma_event
+*******************************************************************************/
+extern "C" void
+magma_event_create_untimed( magma_event_t* event )
+{
+    magma_event_create( event );
+}
+
+
+/***************************************************************************//*
+    Destroys an event, freeing its resources.
+
+    @param[in]
+    event           Event to destroy.
+
+    @ingroup magma_event
+*******************************************************************************/
+extern "C" void
+magma_event_destroy( magma_event_t event )
+{
+    if ( event->stream != NULL ) {
+        event->stream->release();
+    }
+    magma_free_cpu( event );
+}
+
+
+/***************************************************************************//**
+    Records an event into the queue's execution stream.
+    The event will trigger when all previous operations on this queue finish.
+    The event keeps the queue's stream, so it stays valid if the queue is
+    destroyed first; it has then triggered.
+
+    @param[in]
+    event           Event to record.
+
+    @param[in]
+    queue           Queue to execute in.
+
+    @ingroup magma_event
+*******************************************************************************/
+extern "C" void
+magma_event_record( magma_event_t event, magma_queue_t queue )
+{
+    magma_host_stream* stream = queue->host_stream();
+    stream->retain();
+    if ( event->stream != NULL ) {
+        event->stream->release();
+    }
+    event->stream = stream;
+    event->ticket = stream->last_ticket();
+}
+
+
+/***************************************************************************//**
+    Synchronizes with an event. The CPU blocks until the event triggers.
+
+    @param[in]
+    event           Event to synchronize with.
+
+    @ingroup magma_event
+*******************************************************************************/
+extern "C" void
+magma_event_sync( magma_event_t event )
+{
+    if ( event->stream != NULL ) {
+        event->stream->wait( event->ticket );
+    }
+}
+
+
+/******************************************************************************/
+// Task that blocks a stream's worker until an event in another stream triggers.
+// It holds a reference to the other stream, which the event may drop first.
+class magma_wait_event_task: public magma_task
+{
+public:
+    magma_wait_event_task( magma_host_stream* stream, long ticket ):
+        m_stream( stream ),
+        m_ticket( ticket )
+    {
+        m_stream->retain();
+    }
+
+    virtual ~magma_wait_event_task()
+    {
+        m_stream->release();
+    }
+
+    virtual void run()
+    {
+        m_stream->wait( m_ticket );
+    }
+
+private:
+    magma_host_stream* m_stream;
+    long               m_ticket;
+};
+
+
+/***************************************************************************//**
+    Synchronizes a queue with an event. The queue blocks until the event
+    triggers. The CPU does not block.
+
+    @param[in]
+    event           Event to synchronize with.
+
+    @param[in]
+    queue           Queue to synchronize.
+
+    @ingroup magma_event
+*******************************************************************************/
+extern "C" void
+magma_queue_wait_event( magma_queue_t queue, magma_event_t event )
+{
+    // events in the same stream have already triggered by the time the
+    // queue reaches this point, since the stream is in order
+    if ( event->stream != NULL && event->stream != queue->host_stream() ) {
+        queue->host_stream()->push_task(
+            new magma_wait_event_task( event->stream, event->ticket ));
+    }
+}
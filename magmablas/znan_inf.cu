@@ -0,0 +1,171 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+#include "magma_internal.h"
+#include "magma_templates.h"
+
+#define COMPLEX
+
+// grid.y is limited to 64K-1; more block-columns loop in the kernel.
+const magma_int_t max_blocks = 65535;
+
+#define NB_X 64
+#define NB_Y 32
+
+
+/******************************************************************************/
+// Adds val to *x; magma_int_t is 64-bit with ILP64.
+static __device__ void
+nan_inf_atomic_add( magma_int_t* x, magma_int_t val )
+{
+    #if defined(MAGMA_ILP64) || defined(MKL_ILP64)
+        atomicAdd( (unsigned long long*) x, (unsigned long long) val );
+    #else
+        atomicAdd( x, val );
+    #endif
+}
+
+
+/******************************************************************************/
+/*
+    Divides matrix into ceil( m/NB_X ) x ceil( n/NB_Y ) blocks.
+    Each block has NB_X threads; each thread loops across one row of NB_Y
+    entries, counting only entries in the uplo part of A.
+    Block counts are reduced in shared memory, then added to dcnt[0] (NAN)
+    and dcnt[1] (INF), so each block does 2 atomics.
+*/
+__global__ void
+znan_inf_kernel(
+    magma_uplo_t uplo, int m, int n,
+    const magmaDoubleComplex *A, int lda,
+    magma_int_t *dcnt )
+{
+    __shared__ int s_nan[ NB_X ];
+    __shared__ int s_inf[ NB_X ];
+
+    int tx = threadIdx.x;
+    int i  = blockIdx.x*NB_X + tx;
+    int c_nan = 0;
+    int c_inf = 0;
+
+    for (int jb = blockIdx.y*NB_Y; jb < n; jb += gridDim.y*NB_Y) {
+        if (i < m) {
+            // uplo part of row i in this block-column: [jstart, jend)
+            int jstart = jb;
+            int jend   = min( jb + NB_Y, n );
+            if (uplo == MagmaLower) {
+                jend = min( jend, i + 1 );      // j <= i
+            }
+            else if (uplo == MagmaUpper) {
+                jstart = max( jstart, i );      // j >= i
+            }
+            for (int j = jstart; j < jend; ++j) {
+                magmaDoubleComplex a = A[ i + j*lda ];
+                #ifdef COMPLEX
+                bool is_nan = isnan( MAGMA_Z_REAL( a )) || isnan( MAGMA_Z_IMAG( a ));
+                bool is_inf = isinf( MAGMA_Z_REAL( a )) || isinf( MAGMA_Z_IMAG( a ));
+                #else
+                bool is_nan = isnan( a );
+                bool is_inf = isinf( a );
+                #endif
+                c_nan += is_nan;
+                c_inf += (! is_nan && is_inf);
+            }
+        }
+    }
+
+    s_nan[ tx ] = c_nan;
+    s_inf[ tx ] = c_inf;
+    magma_sum_reduce< NB_X >( tx, s_nan );
+    magma_sum_reduce< NB_X >( tx, s_inf );
+    if (tx == 0) {
+        if (s_nan[0] > 0) { nan_inf_atomic_add( &dcnt[0], s_nan[0] ); }
+        if (s_inf[0] > 0) { nan_inf_atomic_add( &dcnt[1], s_inf[0] ); }
+    }
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    magmablas_znan_inf counts NAN (not-a-number) and INF (infinity) values
+    in a matrix on the GPU device, without copying it to the CPU host.
+    An entry is counted as NAN if either its real or imaginary part is NAN,
+    otherwise as INF if either part is INF, as in magma_znan_inf.
+
+    Arguments
+    ---------
+    @param[in]
+    uplo    magma_uplo_t
+            Specifies what part of the matrix dA to check.
+      -     = MagmaUpper:  Upper triangular part of dA
+      -     = MagmaLower:  Lower triangular part of dA
+      -     = MagmaFull:   All of dA
+
+    @param[in]
+    m       INTEGER
+            The number of rows of the matrix dA. m >= 0.
+
+    @param[in]
+    n       INTEGER
+            The number of columns of the matrix dA. n >= 0.
+
+    @param[in]
+    dA      COMPLEX_16 array, dimension (ldda,n), on the GPU device.
+            The m-by-n matrix to check.
+
+    @param[in]
+    ldda    INTEGER
+            The leading dimension of the array dA. ldda >= max(1,m).
+
+    @param[in,out]
+    dcnt    INTEGER array, dimension (2), on the GPU device.
+            On exit, the number of NAN values in dA is added to dcnt[0],
+            and the number of INF values is added to dcnt[1].
+            Initialize to zero before the first call.
+
+    @param[in]
+    queue   magma_queue_t
+            Queue to execute in.
+
+    @ingroup magma_nan_inf
+*******************************************************************************/
+extern "C" void
+magmablas_znan_inf(
+    magma_uplo_t uplo, magma_int_t m, magma_int_t n,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaInt_ptr dcnt,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    if ( uplo != MagmaLower && uplo != MagmaUpper && uplo != MagmaFull )
+        info = -1;
+    else if ( m < 0 )
+        info = -2;
+    else if ( n < 0 )
+        info = -3;
+    else if ( ldda < max(1,m) )
+        info = -5;
+
+    if (info != 0) {
+        magma_xerbla( __func__, -(info) );
+        return;
+    }
+
+    if ( m == 0 || n == 0 ) {
+        return;
+    }
+
+    dim3 threads( NB_X, 1 );
+    dim3 grid( magma_ceildiv( m, NB_X ),
+               min( magma_ceildiv( n, NB_Y ), max_blocks ) );
+    znan_inf_kernel<<< grid, threads, 0, queue->cuda_stream() >>>
+        ( uplo, m, n, dA, ldda, dcnt );
+}
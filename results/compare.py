@@ -0,0 +1,80 @@
+#!/usr/bin/env python
+#
+# Compares two result files written by a tester with --output json,
+# e.g., before and after a change:
+#
+#     ./testing/testing_dgetrf -N 1000:9000:1000 --repeat 5 --output json --output-file old.json
+#     (change, rebuild)
+#     ./testing/testing_dgetrf -N 1000:9000:1000 --repeat 5 --output json --output-file new.json
+#     ./results/compare.py old.json new.json
+#
+# Rows are matched by their integer fields (sizes such as M, N, K), and each
+# *_time_median is compared. Prints the ratio new/old, and marks ratios above
+# 1 + threshold as slower. Exits with status 1 if any timing is slower.
+
+from __future__ import print_function
+
+import sys
+import json
+import argparse
+
+
+# integer fields that are measurements, not sizes; see --counters
+counter_fields = ('_nrepeat', '_cycles', '_instructions', '_llc_misses', '_fp_ops')
+
+
+# --------------------
+def row_key( row ):
+    '''Returns the size fields of a row, e.g., (('M', 100), ('N', 100)).'''
+    return tuple( (k, v) for (k, v) in row.items()
+                  if isinstance( v, int ) and not k.endswith( counter_fields ) )
+
+
+# --------------------
+def main():
+    parser = argparse.ArgumentParser( description='Compare MAGMA tester JSON results.' )
+    parser.add_argument( 'old' )
+    parser.add_argument( 'new' )
+    parser.add_argument( '--threshold', type=float, default=0.05,
+                         help='relative slowdown reported as slower, default 0.05' )
+    args = parser.parse_args()
+
+    old = json.load( open( args.old ))
+    new = json.load( open( args.new ))
+    if ( old['routine'] != new['routine'] ):
+        print( 'warning: routines differ:', old['routine'], new['routine'] )
+    for key in ('device', 'cpu', 'omp_threads', 'blas'):
+        if ( old['host'].get( key ) != new['host'].get( key )):
+            print( 'warning: host %s differs: %s vs. %s'
+                   % (key, old['host'].get( key ), new['host'].get( key )) )
+
+    old_rows = dict( (row_key( row ), row) for row in old['results'] )
+    slower = 0
+    for row in new['results']:
+        key = row_key( row )
+        if ( key not in old_rows ):
+            continue
+        sizes = ' '.join( '%s=%d' % kv for kv in key )
+        for field in sorted( row ):
+            if ( not field.endswith( '_time_median' ) or field not in old_rows[key] ):
+                continue
+            t_old = old_rows[key][field]
+            t_new = row[field]
+            if ( not t_old or not t_new ):
+                continue
+            ratio = t_new / t_old
+            mark = ''
+            if ( ratio > 1 + args.threshold ):
+                mark = 'slower'
+                slower += 1
+            elif ( ratio < 1 - args.threshold ):
+                mark = 'faster'
+            print( '%-30s %-20s %10.3e %10.3e %6.3f %s'
+                   % (sizes, field[ :-len('_time_median') ], t_old, t_new, ratio, mark) )
+
+    return (1 if slower else 0)
+# end
+
+
+if ( __name__ == '__main__' ):
+    sys.exit( main() )
@@ -139,7 +139,9 @@ magma_z_spmv(
     magma_z_matrix dx={Magma_CSR};
     magma_z_matrix dy={Magma_CSR};
 
+#if ! defined(MAGMA_HAVE_HOST)
     cusparseHandle_t cusparseHandle = 0;
+#endif
     cusparseMatDescr_t descr = 0;
     // make sure RHS is a dense matrix
     if ( x.storage_type != Magma_DENSE ) {
@@ -157,6 +159,36 @@ magma_z_spmv(
         goto cleanup;
     }
 
+#if defined(MAGMA_HAVE_HOST)
+    // no device kernels: "device" memory is host memory, so the CSR
+    // formats use the CPU kernels on the device arrays
+    if ( A.memory_location == Magma_DEV ) {
+        if ( ( A.storage_type == Magma_CSR   ||
+               A.storage_type == Magma_CUCSR ||
+               A.storage_type == Magma_CSRL  ||
+               A.storage_type == Magma_CSRU  ||
+               A.storage_type == Magma_CSRCOO ) &&
+             A.num_cols == x.num_rows ) {
+            if ( x.num_cols == 1 ) {
+                CHECK( magma_zgecsrmv_cpu( MagmaNoTrans, A.num_rows, A.num_cols, alpha,
+                                           A.dval, A.drow, A.dcol, x.dval, beta, y.dval, queue ));
+            }
+            else {
+                magma_order_t order = ( x.major == MagmaRowMajor ? MagmaRowMajor : MagmaColMajor );
+                CHECK( magma_zgecsrmm_cpu( MagmaNoTrans, order, A.num_rows, A.num_cols, x.num_cols,
+                                           alpha, A.dval, A.drow, A.dcol,
+                                           x.dval, ( order == MagmaRowMajor ? x.num_cols : x.num_rows ),
+                                           beta,
+                                           y.dval, ( order == MagmaRowMajor ? y.num_cols : y.num_rows ),
+                                           queue ));
+            }
+        }
+        else {
+            printf("error: format not supported.\n");
+            info = MAGMA_ERR_NOT_SUPPORTED;
+        }
+    }
+#else
     // DEV case
     if ( A.memory_location == Magma_DEV ) {
         if ( A.num_cols == x.num_rows && x.num_cols == 1 ) {
@@ -322,7 +354,24 @@ magma_z_spmv(
             }
         }
     }
-    // CPU case missing!
+#endif
+    // CPU case: CSR on the host
+    else if ( A.storage_type == Magma_CSR && x.num_cols == 1 &&
+              A.num_cols == x.num_rows ) {
+        CHECK( magma_zgecsrmv_cpu( MagmaNoTrans, A.num_rows, A.num_cols, alpha,
+                                   A.val, A.row, A.col, x.val, beta, y.val, queue ));
+    }
+    else if ( A.storage_type == Magma_CSR && x.num_cols > 1 &&
+              A.num_cols == x.num_rows ) {
+        magma_order_t order = ( x.major == MagmaRowMajor ? MagmaRowMajor : MagmaColMajor );
+        CHECK( magma_zgecsrmm_cpu( MagmaNoTrans, order, A.num_rows, A.num_cols, x.num_cols,
+                                   alpha, A.val, A.row, A.col,
+                                   x.val, ( order == MagmaRowMajor ? x.num_cols : x.num_rows ),
+                                   beta,
+                                   y.val, ( order == MagmaRowMajor ? y.num_cols : y.num_rows ),
+                                   queue ));
+    }
+    // other CPU cases
     else {
         CHECK( magma_zmtransfer( x, &dx, x.memory_location, Magma_DEV, queue ));
         CHECK( magma_zmtransfer( y, &dy, y.memory_location, Magma_DEV, queue ));
@@ -434,6 +483,12 @@ magma_z_spmv_shift(
     }
 
     // DEV case
+#if defined(MAGMA_HAVE_HOST)
+    if ( A.memory_location == Magma_DEV ) {
+        printf("error: no device kernels in the host backend.\n");
+        info = MAGMA_ERR_NOT_SUPPORTED;
+    }
+#else
     if ( A.memory_location == Magma_DEV ) {
         if ( A.storage_type == Magma_CSR ) {
             //printf("using CSR kernel for SpMV: ");
@@ -461,6 +516,7 @@ magma_z_spmv_shift(
             info = MAGMA_ERR_NOT_SUPPORTED;
         }
     }
+#endif
     // CPU case missing!
     else {
         printf("error: CPU not yet supported.\n");
@@ -479,6 +535,9 @@ cleanup:
     For a given input matrix A and B and scalar alpha,
     the wrapper determines the suitable SpMV computing
               C = alpha * A * B.
+    Matrices on the device use cuSPARSE, with C scaled by alpha afterwards;
+    matrices on the CPU use the host SpGEMM magma_zspgemm_cpu.
+    
     Arguments
     ---------
 
@@ -514,9 +573,7 @@ magma_z_spmm(
     magma_queue_t queue )
 {
     magma_int_t info = 0;
-    magma_z_matrix dA = {Magma_CSR};
-    magma_z_matrix dB = {Magma_CSR};
-    magma_z_matrix dC = {Magma_CSR};
+    magma_z_matrix hA={Magma_CSR}, hB={Magma_CSR}, hC={Magma_CSR};
     
     if ( A.memory_location != B.memory_location ) {
         printf("error: linear algebra objects are not located in same memory!\n");
@@ -533,7 +590,19 @@ magma_z_spmm(
                  A.storage_type == Magma_CSRL ||
                  A.storage_type == Magma_CSRU ||
                  A.storage_type == Magma_CSRCOO ) {
+               #if defined(MAGMA_HAVE_HOST)
+               // no cuSPARSE: multiply on the CPU
+               CHECK( magma_zmtransfer( A, &hA, Magma_DEV, Magma_CPU, queue ));
+               CHECK( magma_zmtransfer( B, &hB, Magma_DEV, Magma_CPU, queue ));
+               CHECK( magma_zspgemm_cpu( alpha, hA, hB, &hC, queue ));
+               CHECK( magma_zmtransfer( hC, C, Magma_CPU, Magma_DEV, queue ));
+               #else
+               // cuSPARSE computes A * B; alpha scales the values of C
                CHECK( magma_zcuspmm( A, B, C, queue ));
+               if ( ! MAGMA_Z_EQUAL( alpha, MAGMA_Z_ONE ) ) {
+                   magma_zscal( C->nnz, alpha, C->dval, 1, queue );
+               }
+               #endif
             }
             else {
                 printf("error: format not supported.\n");
@@ -541,19 +610,23 @@ magma_z_spmm(
             }
         }
     }
-    // CPU case missing!
+    // CPU case
     else {
-        A.storage_type = Magma_CSR;
-        B.storage_type = Magma_CSR;
-        CHECK( magma_zmtransfer( A, &dA, Magma_CPU, Magma_DEV, queue ) );
-        CHECK( magma_zmtransfer( B, &dB, Magma_CPU, Magma_DEV, queue ) );
-        CHECK(  magma_zcuspmm( dA, dB, &dC, queue ) );
-        CHECK( magma_zmtransfer( dC, C, Magma_DEV, Magma_CPU, queue ) );
+        if ( A.storage_type == Magma_CSR  ||
+             A.storage_type == Magma_CSRL ||
+             A.storage_type == Magma_CSRU ||
+             A.storage_type == Magma_CSRCOO ) {
+            CHECK( magma_zspgemm_cpu( alpha, A, B, C, queue ));
+        }
+        else {
+            printf("error: format not supported.\n");
+            info = MAGMA_ERR_NOT_SUPPORTED;
+        }
     }
     
 cleanup:
-    magma_zmfree( &dA, queue );
-    magma_zmfree( &dB, queue );
-    magma_zmfree( &dC, queue );
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &hB, queue );
+    magma_zmfree( &hC, queue );
     return info;
 }
@@ -0,0 +1,346 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+#include "magmasparse_internal.h"
+
+/*
+    Replacements for the device kernels and cuSPARSE wrappers of the sparse
+    library in the host backend, which has no device kernels. Device memory
+    is host memory there, so the d* arrays are read and written directly.
+
+    The Jacobi kernels and the triangular solves of the ILU and IC
+    preconditioners are a few lines on the CPU and are implemented here,
+    and the merged solvers fall back to their unmerged versions. The
+    remaining routines, mostly the ISAI and cuSPARSE preconditioner setups
+    and the solvers without an unmerged version, are not in the host build:
+    magma_z_solver and magma_z_precondsetup report them as not supported,
+    and direct callers fail to link.
+
+    This file is compiled only for BACKEND=host, in place of the .cu files
+    and the cuSPARSE wrappers.
+*/
+
+
+/******************************************************************************/
+// Solves op(T) x = b for the CSR triangular matrix T with nonunit diagonal,
+// for the num_rows*num_cols/T.num_rows columns of b, as cusparseZcsrsm_solve.
+// lower: whether T is lower triangular; trans: whether op(T) = T^T.
+static magma_int_t
+zhost_trisolve(
+    magma_z_matrix T,
+    bool lower,
+    bool trans,
+    magma_z_matrix b,
+    magma_z_matrix *x )
+{
+    const magma_int_t n = T.num_rows;
+    const magma_int_t nrhs = ( n > 0 ) ? b.num_rows*b.num_cols/n : 0;
+
+    for( magma_int_t r=0; r < nrhs; r++ ) {
+        const magmaDoubleComplex *bval = b.dval + r*n;
+        magmaDoubleComplex *xval = x->dval + r*n;
+        if ( ! trans ) {
+            // row oriented: forward for lower, backward for upper
+            for( magma_int_t l=0; l < n; l++ ) {
+                magma_int_t i = lower ? l : n-1-l;
+                magmaDoubleComplex s = bval[i], diag = MAGMA_Z_ZERO;
+                for( magma_index_t k=T.drow[i]; k < T.drow[i+1]; k++ ) {
+                    magma_index_t j = T.dcol[k];
+                    if ( j == i ) {
+                        diag = T.dval[k];
+                    } else if ( lower ? j < i : j > i ) {
+                        s -= T.dval[k] * xval[j];
+                    }
+                }
+                if ( MAGMA_Z_EQUAL( diag, MAGMA_Z_ZERO )) {
+                    return MAGMA_ERR_BADPRECOND;
+                }
+                xval[i] = s / diag;
+            }
+        }
+        else {
+            // column oriented: T^T is upper for lower T, so backward
+            for( magma_int_t i=0; i < n; i++ ) {
+                xval[i] = bval[i];
+            }
+            for( magma_int_t l=0; l < n; l++ ) {
+                magma_int_t i = lower ? n-1-l : l;
+                magmaDoubleComplex diag = MAGMA_Z_ZERO;
+                for( magma_index_t k=T.drow[i]; k < T.drow[i+1]; k++ ) {
+                    if ( T.dcol[k] == i ) {
+                        diag = T.dval[k];
+                    }
+                }
+                if ( MAGMA_Z_EQUAL( diag, MAGMA_Z_ZERO )) {
+                    return MAGMA_ERR_BADPRECOND;
+                }
+                xval[i] = xval[i] / diag;
+                for( magma_index_t k=T.drow[i]; k < T.drow[i+1]; k++ ) {
+                    magma_index_t j = T.dcol[k];
+                    if ( lower ? j < i : j > i ) {
+                        xval[j] -= T.dval[k] * xval[i];
+                    }
+                }
+            }
+        }
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/******************************************************************************/
+// Jacobi kernels, see zjacobisetup.cu
+
+extern "C" magma_int_t
+magma_zjacobisetup_vector_gpu(
+    magma_int_t num_rows,
+    magma_z_matrix b,
+    magma_z_matrix d,
+    magma_z_matrix c,
+    magma_z_matrix *x,
+    magma_queue_t queue )
+{
+    magma_int_t num_vecs = b.num_rows / num_rows;
+    #pragma omp parallel for
+    for( magma_int_t row=0; row < num_rows; row++ ) {
+        for( magma_int_t i=0; i < num_vecs; i++ ) {
+            c.dval[row+i*num_rows] = b.dval[row+i*num_rows] / d.dval[row];
+            x->dval[row+i*num_rows] = c.dval[row+i*num_rows];
+        }
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+extern "C" magma_int_t
+magma_zjacobi_diagscal(
+    magma_int_t num_rows,
+    magma_z_matrix d,
+    magma_z_matrix b,
+    magma_z_matrix *c,
+    magma_queue_t queue )
+{
+    magma_int_t num_vecs = b.num_rows*b.num_cols/num_rows;
+    #pragma omp parallel for
+    for( magma_int_t row=0; row < num_rows; row++ ) {
+        for( magma_int_t i=0; i < num_vecs; i++ ) {
+            c->dval[row+i*num_rows] = b.dval[row+i*num_rows] * d.dval[row];
+        }
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+extern "C" magma_int_t
+magma_zjacobiupdate(
+    magma_z_matrix t,
+    magma_z_matrix b,
+    magma_z_matrix d,
+    magma_z_matrix *x,
+    magma_queue_t queue )
+{
+    const magma_int_t n = t.num_rows;
+    #pragma omp parallel for
+    for( magma_int_t row=0; row < n; row++ ) {
+        for( magma_int_t i=0; i < t.num_cols; i++ ) {
+            x->dval[row+i*n] += (b.dval[row+i*n] - t.dval[row+i*n]) * d.dval[row];
+        }
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+// The device kernel merges the SpMV and the update and is asynchronous;
+// here each iteration is a synchronous Jacobi step, t = A*x, x += d.*(b-t).
+extern "C" magma_int_t
+magma_zjacobispmvupdate(
+    magma_int_t maxiter,
+    magma_z_matrix A,
+    magma_z_matrix t,
+    magma_z_matrix b,
+    magma_z_matrix d,
+    magma_z_matrix *x,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+
+    for( magma_int_t i=0; i < maxiter; i++ ) {
+        CHECK( magma_z_spmv( c_one, A, *x, c_zero, t, queue ));
+        CHECK( magma_zjacobiupdate( t, b, d, x, queue ));
+    }
+
+cleanup:
+    return info;
+}
+
+
+/******************************************************************************/
+// ILU and IC triangular solves, see zilu.cpp. There is no analysis phase.
+
+extern "C" magma_int_t
+magma_zcumilugeneratesolverinfo(
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    return MAGMA_SUCCESS;
+}
+
+
+extern "C" magma_int_t
+magma_zcumicgeneratesolverinfo(
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    return MAGMA_SUCCESS;
+}
+
+
+extern "C" magma_int_t
+magma_zapplycumilu_l(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    return zhost_trisolve( precond->L, true, false, b, x );
+}
+
+
+extern "C" magma_int_t
+magma_zapplycumilu_r(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    return zhost_trisolve( precond->U, false, false, b, x );
+}
+
+
+extern "C" magma_int_t
+magma_zapplycumicc_l(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    return zhost_trisolve( precond->M, true, false, b, x );
+}
+
+
+extern "C" magma_int_t
+magma_zapplycumicc_r(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    return zhost_trisolve( precond->M, true, true, b, x );
+}
+
+
+/******************************************************************************/
+// Iterative solvers built on device kernels. The merged CG, BiCGSTAB, CGS
+// and TFQMR fuse the vector updates into device kernels; here they are the
+// unmerged solvers, which use only magma_z_spmv and the BLAS interface.
+
+extern "C" magma_int_t
+magma_zbicgstab_merge(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_queue_t queue )
+{
+    return magma_zbicgstab( A, b, x, solver_par, queue );
+}
+
+extern "C" magma_int_t
+magma_zcg_merge(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_queue_t queue )
+{
+    return magma_zcg( A, b, x, solver_par, queue );
+}
+
+extern "C" magma_int_t
+magma_zcgs_merge(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_queue_t queue )
+{
+    return magma_zcgs( A, b, x, solver_par, queue );
+}
+
+extern "C" magma_int_t
+magma_ztfqmr_merge(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_queue_t queue )
+{
+    return magma_ztfqmr( A, b, x, solver_par, queue );
+}
+
+extern "C" magma_int_t
+magma_zpbicgstab_merge(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue )
+{
+    return magma_zpbicgstab( A, b, x, solver_par, precond_par, queue );
+}
+
+extern "C" magma_int_t
+magma_zpcg_merge(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue )
+{
+    return magma_zpcg( A, b, x, solver_par, precond_par, queue );
+}
+
+extern "C" magma_int_t
+magma_zpcgs_merge(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue )
+{
+    return magma_zpcgs( A, b, x, solver_par, precond_par, queue );
+}
+
+extern "C" magma_int_t
+magma_zptfqmr_merge(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue )
+{
+    return magma_zptfqmr( A, b, x, solver_par, precond_par, queue );
+}
@@ -0,0 +1,291 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+#include <algorithm>
+#include "magmasparse_internal.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*
+    Host Jaccard weights. The weight of edge (i, j) is
+    |N(i) & N(j)| / |N(i) | N(j)|, where N(i) is the column pattern of row i
+    of A, so each edge costs one intersection.
+
+    Edges of a row i are consecutive in J, so each thread marks N(i) in a
+    bitmap once per row, and intersects by looking up each entry of N(j):
+    O( |N(j)| ) per edge, instead of O( |N(i)| + |N(j)| ) for a merge, which
+    matters for the many edges of hubs in power-law graphs. If N(j) is much
+    longer than N(i) (an edge to a hub), each entry of N(i) is instead
+    searched in N(j) by galloping (exponential then binary search), for
+    O( |N(i)| log |N(j)| ).
+
+    The edges of J are split into blocks, and blocks into chunks of equal
+    estimated cost, which threads take dynamically, so edges between hubs
+    do not all fall to the same thread.
+*/
+
+// edges per block; chunks are contiguous blocks
+const magma_int_t jaccard_block = 256;
+
+// chunks per thread, for dynamic scheduling
+const magma_int_t jaccard_chunks_per_thread = 16;
+
+// gallop if N(j) is this many times longer than N(i)
+const magma_int_t jaccard_gallop_ratio = 32;
+
+
+/******************************************************************************/
+// Returns ceil( log2( n + 1 )).
+static inline magma_int_t
+jaccard_log2( magma_int_t n )
+{
+    magma_int_t k = 0;
+    while ( n > 0 ) {
+        n >>= 1;
+        k++;
+    }
+    return k;
+}
+
+
+/******************************************************************************/
+// Returns whether the intersection of N(i) and N(j), of lengths ni and nj,
+// gallops instead of using the bitmap of N(i).
+static inline bool
+jaccard_gallop( magma_int_t ni, magma_int_t nj )
+{
+    return nj > jaccard_gallop_ratio * ni;
+}
+
+
+/******************************************************************************/
+// Returns the estimated cost of edge (i, j), for rows of lengths ni and nj.
+static inline int64_t
+jaccard_cost( magma_int_t ni, magma_int_t nj )
+{
+    if ( jaccard_gallop( ni, nj )) {
+        return int64_t( ni ) * jaccard_log2( nj ) + 1;
+    }
+    return int64_t( nj ) + 1;
+}
+
+
+/******************************************************************************/
+// Returns the number of common entries of sorted arrays a and b,
+// b much longer than a, by galloping in b.
+static inline magma_int_t
+jaccard_intersect_gallop(
+    const magma_index_t *a, magma_int_t na,
+    const magma_index_t *b, magma_int_t nb )
+{
+    magma_int_t count = 0;
+    // b[lo] is the first entry not yet passed
+    magma_int_t lo = 0;
+    for( magma_int_t ia=0; ia < na && lo < nb; ia++ ) {
+        magma_index_t x = a[ia];
+        magma_int_t step = 1, hi = lo;
+        while ( hi < nb && b[hi] < x ) {
+            lo = hi + 1;
+            hi += step;
+            step *= 2;
+        }
+        lo = std::lower_bound( b + lo, b + min( hi+1, nb ), x ) - b;
+        if ( lo < nb && b[lo] == x ) {
+            count++;
+            lo++;
+        }
+    }
+    return count;
+}
+
+
+/******************************************************************************/
+// Sets (on = true) or clears the bits of the n columns in col.
+static inline void
+jaccard_mark( uint64_t *bits, const magma_index_t *col, magma_int_t n, bool on )
+{
+    for( magma_int_t k=0; k < n; k++ ) {
+        if ( on )
+            bits[ col[k] >> 6 ] |=   uint64_t(1) << (col[k] & 63);
+        else
+            bits[ col[k] >> 6 ] &= ~(uint64_t(1) << (col[k] & 63));
+    }
+}
+
+
+/******************************************************************************/
+// Returns the number of the n columns in col that are set in bits.
+static inline magma_int_t
+jaccard_count( const uint64_t *bits, const magma_index_t *col, magma_int_t n )
+{
+    magma_int_t count = 0;
+    for( magma_int_t k=0; k < n; k++ ) {
+        count += (bits[ col[k] >> 6 ] >> (col[k] & 63)) & 1;
+    }
+    return count;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes Jaccard weights for a matrix on the CPU. For each entry (i, j)
+    of J, i != j, sets J(i, j) to the Jaccard similarity of rows i and j of
+    A: the number of columns in both rows over the number of columns in
+    either row, or zero if both rows are empty. Diagonal entries of J are
+    set to one. Only the patterns of A and J are used; columns in each row
+    of A must be sorted and unique.
+
+    Edges are processed in parallel, balanced by the estimated cost of
+    their intersections.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix in CSR (or CSRCOO), on the CPU
+
+    @param[in,out]
+    J           magma_z_matrix*
+                On entry, the pattern of the weights in CSR or CSRCOO,
+                on the CPU, e.g., the pattern of A.
+                On exit, J->val has the Jaccard weights.
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+extern "C"
+magma_int_t
+magma_zjaccard_weights_cpu(
+    magma_z_matrix A,
+    magma_z_matrix *J,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    int64_t *cost = NULL;
+    uint64_t *bitmaps = NULL;
+    magma_int_t words;
+    magma_int_t nnz = J->nnz;
+    magma_int_t num_blocks = magma_ceildiv( nnz, jaccard_block );
+    magma_int_t num_threads = 1, num_chunks;
+
+    if ( A.memory_location != Magma_CPU || J->memory_location != Magma_CPU ) {
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+    if ( nnz == 0 ) {
+        goto cleanup;
+    }
+
+    #ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    #endif
+    num_chunks = min( num_blocks, jaccard_chunks_per_thread * num_threads );
+
+    // cost[b+1] is the estimated cost of block b, then the prefix sum
+    CHECK( magma_malloc_cpu( (void**) &cost, (num_blocks+1)*sizeof(int64_t) ));
+    cost[0] = 0;
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t b=0; b < num_blocks; b++ ) {
+        magma_int_t k = b*jaccard_block;
+        magma_int_t kend = min( k + jaccard_block, nnz );
+        magma_int_t i = magma_int_t( std::upper_bound( J->row, J->row + J->num_rows + 1, k ) - J->row ) - 1;
+        int64_t c = 0;
+        for( ; k < kend; k++ ) {
+            while ( J->row[ i+1 ] <= k ) {
+                i++;
+            }
+            magma_index_t j = J->col[k];
+            c += jaccard_cost( A.row[ i+1 ] - A.row[i], A.row[ j+1 ] - A.row[j] );
+        }
+        cost[ b+1 ] = c;
+    }
+    for( magma_int_t b=0; b < num_blocks; b++ ) {
+        cost[ b+1 ] += cost[b];
+    }
+
+    // bitmaps of columns, one per thread, cleared after each row
+    words = magma_ceildiv( A.num_cols, 64 );
+    CHECK( magma_malloc_cpu( (void**) &bitmaps, num_threads*words*sizeof(uint64_t) ));
+    memset( bitmaps, 0, num_threads*words*sizeof(uint64_t) );
+
+    // chunk c is blocks [ first block with prefix >= c*total/num_chunks, ... )
+    #pragma omp parallel
+    {
+        uint64_t *bits = bitmaps;
+        #ifdef _OPENMP
+        bits += omp_get_thread_num() * words;
+        #endif
+
+        #pragma omp for schedule(dynamic,1)
+        for( magma_int_t c=0; c < num_chunks; c++ ) {
+            int64_t lo = cost[ num_blocks ] / num_chunks * c;
+            int64_t hi = (c == num_chunks-1 ? cost[ num_blocks ] + 1
+                                            : cost[ num_blocks ] / num_chunks * (c+1));
+            magma_int_t bstart = magma_int_t( std::lower_bound( cost, cost + num_blocks, lo ) - cost );
+            magma_int_t bend   = magma_int_t( std::lower_bound( cost, cost + num_blocks, hi ) - cost );
+            magma_int_t k    = bstart*jaccard_block;
+            magma_int_t kend = min( bend*jaccard_block, nnz );
+            if ( k >= kend ) {
+                continue;
+            }
+            magma_int_t i = magma_int_t( std::upper_bound( J->row, J->row + J->num_rows + 1, k ) - J->row ) - 1;
+            magma_int_t marked = -1;  // row marked in bits, if any
+            for( ; k < kend; k++ ) {
+                while ( J->row[ i+1 ] <= k ) {
+                    i++;
+                }
+                magma_index_t j = J->col[k];
+                if ( i == j ) {
+                    J->val[k] = MAGMA_Z_ONE;
+                    continue;
+                }
+                const magma_index_t *coli = &A.col[ A.row[i] ];
+                const magma_index_t *colj = &A.col[ A.row[j] ];
+                magma_int_t ni = A.row[ i+1 ] - A.row[i];
+                magma_int_t nj = A.row[ j+1 ] - A.row[j];
+                magma_int_t common;
+                if ( jaccard_gallop( ni, nj )) {
+                    common = jaccard_intersect_gallop( coli, ni, colj, nj );
+                }
+                else {
+                    if ( marked != i ) {
+                        if ( marked >= 0 ) {
+                            jaccard_mark( bits, &A.col[ A.row[marked] ],
+                                          A.row[ marked+1 ] - A.row[marked], false );
+                        }
+                        jaccard_mark( bits, coli, ni, true );
+                        marked = i;
+                    }
+                    common = jaccard_count( bits, colj, nj );
+                }
+                magma_int_t total = ni + nj - common;
+                J->val[k] = MAGMA_Z_MAKE( (total > 0 ? double( common ) / total : 0.0), 0.0 );
+            }
+            if ( marked >= 0 ) {
+                jaccard_mark( bits, &A.col[ A.row[marked] ],
+                              A.row[ marked+1 ] - A.row[marked], false );
+            }
+        }
+    }
+
+cleanup:
+    magma_free_cpu( cost );
+    magma_free_cpu( bitmaps );
+    return info;
+}
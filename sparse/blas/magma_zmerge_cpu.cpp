@@ -0,0 +1,731 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+#include "magmasparse_internal.h"
+
+#include <omp.h>
+
+/*
+    Host counterparts of the merged kernels in zmergecg.cu and
+    zmergebicgstab.cu. Each routine makes a single sweep over its vectors:
+    the vector update that precedes an SpMV is evaluated on the fly while
+    gathering the SpMV input (so no separate pass writes it first), and the
+    dot products needed next are accumulated in the same loop.
+
+    Dot products are accumulated as separate real and imaginary parts so
+    OpenMP can reduce them.
+*/
+
+
+/**
+    Purpose
+    -------
+
+    Computes y = alpha * A * x + beta * y on the host for a matrix A in CSR
+    format, using OpenMP over the rows.
+
+    Arguments
+    ---------
+
+    @param[in]
+    transA      magma_trans_t
+                transposition parameter for A; only MagmaNoTrans is supported
+
+    @param[in]
+    m           magma_int_t
+                number of rows in A
+
+    @param[in]
+    n           magma_int_t
+                number of columns in A
+
+    @param[in]
+    alpha       magmaDoubleComplex
+                scalar multiplier
+
+    @param[in]
+    val         magmaDoubleComplex*
+                array containing values of A in CSR
+
+    @param[in]
+    rowptr      magma_index_t*
+                rowpointer of A in CSR
+
+    @param[in]
+    colind      magma_index_t*
+                columnindices of A in CSR
+
+    @param[in]
+    x           magmaDoubleComplex*
+                input vector x
+
+    @param[in]
+    beta        magmaDoubleComplex
+                scalar multiplier
+
+    @param[out]
+    y           magmaDoubleComplex*
+                input/output vector y
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zblas
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zgecsrmv_cpu(
+    magma_trans_t transA,
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex *val,
+    magma_index_t *rowptr,
+    magma_index_t *colind,
+    magmaDoubleComplex *x,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex *y,
+    magma_queue_t queue )
+{
+    MAGMA_UNUSED( n );
+    MAGMA_UNUSED( queue );
+
+    if ( transA != MagmaNoTrans ) {
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
+
+    bool beta_zero = MAGMA_Z_EQUAL( beta, MAGMA_Z_ZERO );
+
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i < m; i++ ) {
+        magmaDoubleComplex sum = MAGMA_Z_ZERO;
+        for( magma_index_t j=rowptr[i]; j < rowptr[i+1]; j++ ) {
+            sum += val[j] * x[ colind[j] ];
+        }
+        // don't read y if beta = 0, so it may be uninitialized
+        y[i] = beta_zero ? alpha * sum : alpha * sum + beta * y[i];
+    }
+
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes C = alpha * A * B + beta * C on the host for a matrix A in CSR
+    format and dense blocks B and C of num_vecs vectors, using OpenMP over
+    the rows. Each entry of A is loaded once and applied to all vectors.
+
+    Arguments
+    ---------
+
+    @param[in]
+    transA      magma_trans_t
+                transposition parameter for A; only MagmaNoTrans is supported
+
+    @param[in]
+    order       magma_order_t
+                layout of B and C: MagmaColMajor, B(i,k) = B[ i + k*ldb ],
+                or MagmaRowMajor, B(i,k) = B[ i*ldb + k ]
+
+    @param[in]
+    m           magma_int_t
+                number of rows in A
+
+    @param[in]
+    n           magma_int_t
+                number of columns in A
+
+    @param[in]
+    num_vecs    magma_int_t
+                number of vectors
+
+    @param[in]
+    alpha       magmaDoubleComplex
+                scalar multiplier
+
+    @param[in]
+    val         magmaDoubleComplex*
+                array containing values of A in CSR
+
+    @param[in]
+    rowptr      magma_index_t*
+                rowpointer of A in CSR
+
+    @param[in]
+    colind      magma_index_t*
+                columnindices of A in CSR
+
+    @param[in]
+    B           magmaDoubleComplex*
+                input vectors
+
+    @param[in]
+    ldb         magma_int_t
+                leading dimension of B
+
+    @param[in]
+    beta        magmaDoubleComplex
+                scalar multiplier
+
+    @param[in,out]
+    C           magmaDoubleComplex*
+                input/output vectors
+
+    @param[in]
+    ldc         magma_int_t
+                leading dimension of C
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zblas
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zgecsrmm_cpu(
+    magma_trans_t transA,
+    magma_order_t order,
+    magma_int_t m, magma_int_t n,
+    magma_int_t num_vecs,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex *val,
+    magma_index_t *rowptr,
+    magma_index_t *colind,
+    magmaDoubleComplex *B, magma_int_t ldb,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex *C, magma_int_t ldc,
+    magma_queue_t queue )
+{
+    MAGMA_UNUSED( n );
+    MAGMA_UNUSED( queue );
+
+    if ( transA != MagmaNoTrans ) {
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
+
+    bool beta_zero = MAGMA_Z_EQUAL( beta, MAGMA_Z_ZERO );
+
+    // strides between rows and between vectors
+    magma_int_t bi = 1, bk = ldb, ci = 1, ck = ldc;
+    if ( order == MagmaRowMajor ) {
+        bi = ldb;  bk = 1;
+        ci = ldc;  ck = 1;
+    }
+
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i < m; i++ ) {
+        magmaDoubleComplex *Ci = C + i*ci;
+        for( magma_int_t k=0; k < num_vecs; k++ ) {
+            // don't read C if beta = 0, so it may be uninitialized
+            Ci[ k*ck ] = beta_zero ? MAGMA_Z_ZERO : beta * Ci[ k*ck ];
+        }
+        for( magma_index_t j=rowptr[i]; j < rowptr[i+1]; j++ ) {
+            magmaDoubleComplex a = alpha * val[j];
+            magmaDoubleComplex *Bj = B + colind[j]*bi;
+            for( magma_int_t k=0; k < num_vecs; k++ ) {
+                Ci[ k*ck ] += a * Bj[ k*bk ];
+            }
+        }
+    }
+
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Merges the search direction update, the SpMV and the dot product of CG
+    into one sweep over the rows of A:
+
+        dnew = h + beta * d
+        z    = A * dnew
+        skp  = dnew' * z
+
+    Row i gathers h and d at the column indices of A, so d is not modified
+    in place; dnew is a separate vector the caller swaps with d afterwards.
+    For the first iteration use beta = 0 (d must be finite, e.g., zero).
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                system matrix in CSR format on the CPU
+
+    @param[in]
+    beta        magmaDoubleComplex
+                scalar
+
+    @param[in]
+    h           magmaDoubleComplex*
+                (preconditioned) residual
+
+    @param[in]
+    d           magmaDoubleComplex*
+                search direction of the previous iteration
+
+    @param[out]
+    dnew        magmaDoubleComplex*
+                new search direction
+
+    @param[out]
+    z           magmaDoubleComplex*
+                z = A * dnew
+
+    @param[out]
+    skp         magmaDoubleComplex*
+                on output, dnew' * z
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgegpuk
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zcgmerge_spmv1_cpu(
+    magma_z_matrix A,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex *h,
+    magmaDoubleComplex *d,
+    magmaDoubleComplex *dnew,
+    magmaDoubleComplex *z,
+    magmaDoubleComplex *skp,
+    magma_queue_t queue )
+{
+    MAGMA_UNUSED( queue );
+
+    magma_int_t n = A.num_rows;
+    double dz_re = 0.0, dz_im = 0.0;
+
+    #pragma omp parallel for schedule(static) reduction(+:dz_re, dz_im)
+    for( magma_int_t i=0; i < n; i++ ) {
+        magmaDoubleComplex sum = MAGMA_Z_ZERO;
+        for( magma_index_t j=A.row[i]; j < A.row[i+1]; j++ ) {
+            magma_index_t col = A.col[j];
+            sum += A.val[j] * (h[col] + beta * d[col]);
+        }
+        magmaDoubleComplex di = h[i] + beta * d[i];
+        magmaDoubleComplex dot = MAGMA_Z_CONJ( di ) * sum;
+        dnew[i] = di;
+        z[i] = sum;
+        dz_re += MAGMA_Z_REAL( dot );
+        dz_im += MAGMA_Z_IMAG( dot );
+    }
+    *skp = MAGMA_Z_MAKE( dz_re, dz_im );
+
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Merges the solution and residual updates of (P)CG with the dot products
+    for the next iteration into one sweep:
+
+        x  = x + alpha * d
+        r  = r - alpha * z
+        h  = diag .* r          (if diag != NULL, Jacobi preconditioner)
+        rh = r' * h
+        rr = r' * r
+
+    If diag is NULL, h is not written (pass h = r) and rh = rr.
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                dimension n
+
+    @param[in]
+    alpha       magmaDoubleComplex
+                scalar
+
+    @param[in]
+    diag        magmaDoubleComplex*
+                inverse of the diagonal of A, or NULL
+
+    @param[in,out]
+    x           magmaDoubleComplex*
+                solution approximation
+
+    @param[in,out]
+    r           magmaDoubleComplex*
+                residual
+
+    @param[out]
+    h           magmaDoubleComplex*
+                preconditioned residual
+
+    @param[in]
+    d           magmaDoubleComplex*
+                search direction
+
+    @param[in]
+    z           magmaDoubleComplex*
+                z = A * d
+
+    @param[out]
+    rh          double*
+                on output, real part of r' * h
+
+    @param[out]
+    rr          double*
+                on output, r' * r
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgegpuk
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zcgmerge_xrbeta_cpu(
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex *diag,
+    magmaDoubleComplex *x,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *h,
+    magmaDoubleComplex *d,
+    magmaDoubleComplex *z,
+    double *rh,
+    double *rr,
+    magma_queue_t queue )
+{
+    MAGMA_UNUSED( queue );
+
+    double sum_rh = 0.0, sum_rr = 0.0;
+
+    if ( diag == NULL ) {
+        #pragma omp parallel for schedule(static) reduction(+:sum_rr)
+        for( magma_int_t i=0; i < n; i++ ) {
+            magmaDoubleComplex ri = r[i] - alpha * z[i];
+            x[i] += alpha * d[i];
+            r[i] = ri;
+            sum_rr += MAGMA_Z_REAL( MAGMA_Z_CONJ( ri ) * ri );
+        }
+        sum_rh = sum_rr;
+    }
+    else {
+        #pragma omp parallel for schedule(static) reduction(+:sum_rh, sum_rr)
+        for( magma_int_t i=0; i < n; i++ ) {
+            magmaDoubleComplex ri = r[i] - alpha * z[i];
+            magmaDoubleComplex hi = diag[i] * ri;
+            x[i] += alpha * d[i];
+            r[i] = ri;
+            h[i] = hi;
+            sum_rh += MAGMA_Z_REAL( MAGMA_Z_CONJ( ri ) * hi );
+            sum_rr += MAGMA_Z_REAL( MAGMA_Z_CONJ( ri ) * ri );
+        }
+    }
+    *rh = sum_rh;
+    *rr = sum_rr;
+
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Merges the search direction update, the first SpMV and the dot product
+    of BiCGSTAB into one sweep over the rows of A:
+
+        pnew = r + beta * ( p - omega * v )
+        vnew = A * pnew
+        skp  = rr' * vnew
+
+    As in magma_zcgmerge_spmv1_cpu, p and v are only read; pnew and vnew are
+    separate vectors the caller swaps with p and v afterwards.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                system matrix in CSR format on the CPU
+
+    @param[in]
+    beta        magmaDoubleComplex
+                scalar
+
+    @param[in]
+    omega       magmaDoubleComplex
+                scalar
+
+    @param[in]
+    rr          magmaDoubleComplex*
+                shadow residual
+
+    @param[in]
+    r           magmaDoubleComplex*
+                residual
+
+    @param[in]
+    p           magmaDoubleComplex*
+                search direction of the previous iteration
+
+    @param[in]
+    v           magmaDoubleComplex*
+                v = A * p of the previous iteration
+
+    @param[out]
+    pnew        magmaDoubleComplex*
+                new search direction
+
+    @param[out]
+    vnew        magmaDoubleComplex*
+                vnew = A * pnew
+
+    @param[out]
+    skp         magmaDoubleComplex*
+                on output, rr' * vnew
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgegpuk
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zbicgmerge_spmv1_cpu(
+    magma_z_matrix A,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex omega,
+    magmaDoubleComplex *rr,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *p,
+    magmaDoubleComplex *v,
+    magmaDoubleComplex *pnew,
+    magmaDoubleComplex *vnew,
+    magmaDoubleComplex *skp,
+    magma_queue_t queue )
+{
+    MAGMA_UNUSED( queue );
+
+    magma_int_t n = A.num_rows;
+    double dot_re = 0.0, dot_im = 0.0;
+
+    #pragma omp parallel for schedule(static) reduction(+:dot_re, dot_im)
+    for( magma_int_t i=0; i < n; i++ ) {
+        magmaDoubleComplex sum = MAGMA_Z_ZERO;
+        for( magma_index_t j=A.row[i]; j < A.row[i+1]; j++ ) {
+            magma_index_t col = A.col[j];
+            sum += A.val[j] * (r[col] + beta * (p[col] - omega * v[col]));
+        }
+        pnew[i] = r[i] + beta * (p[i] - omega * v[i]);
+        vnew[i] = sum;
+        magmaDoubleComplex dot = MAGMA_Z_CONJ( rr[i] ) * sum;
+        dot_re += MAGMA_Z_REAL( dot );
+        dot_im += MAGMA_Z_IMAG( dot );
+    }
+    *skp = MAGMA_Z_MAKE( dot_re, dot_im );
+
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Merges the intermediate residual, the second SpMV and the dot products
+    of BiCGSTAB into one sweep over the rows of A:
+
+        s = r - alpha * v
+        t = A * s
+        skp[0] = t' * s
+        skp[1] = t' * t
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                system matrix in CSR format on the CPU
+
+    @param[in]
+    alpha       magmaDoubleComplex
+                scalar
+
+    @param[in]
+    r           magmaDoubleComplex*
+                residual
+
+    @param[in]
+    v           magmaDoubleComplex*
+                v = A * p
+
+    @param[out]
+    s           magmaDoubleComplex*
+                intermediate residual
+
+    @param[out]
+    t           magmaDoubleComplex*
+                t = A * s
+
+    @param[out]
+    skp         magmaDoubleComplex[2]
+                on output, t' * s and t' * t
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgegpuk
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zbicgmerge_spmv2_cpu(
+    magma_z_matrix A,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *v,
+    magmaDoubleComplex *s,
+    magmaDoubleComplex *t,
+    magmaDoubleComplex *skp,
+    magma_queue_t queue )
+{
+    MAGMA_UNUSED( queue );
+
+    magma_int_t n = A.num_rows;
+    double ts_re = 0.0, ts_im = 0.0, tt = 0.0;
+
+    #pragma omp parallel for schedule(static) reduction(+:ts_re, ts_im, tt)
+    for( magma_int_t i=0; i < n; i++ ) {
+        magmaDoubleComplex sum = MAGMA_Z_ZERO;
+        for( magma_index_t j=A.row[i]; j < A.row[i+1]; j++ ) {
+            magma_index_t col = A.col[j];
+            sum += A.val[j] * (r[col] - alpha * v[col]);
+        }
+        magmaDoubleComplex si = r[i] - alpha * v[i];
+        magmaDoubleComplex dot = MAGMA_Z_CONJ( sum ) * si;
+        s[i] = si;
+        t[i] = sum;
+        ts_re += MAGMA_Z_REAL( dot );
+        ts_im += MAGMA_Z_IMAG( dot );
+        tt    += MAGMA_Z_REAL( MAGMA_Z_CONJ( sum ) * sum );
+    }
+    skp[0] = MAGMA_Z_MAKE( ts_re, ts_im );
+    skp[1] = MAGMA_Z_MAKE( tt, 0.0 );
+
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Merges the solution and residual updates of BiCGSTAB with the dot
+    products for the next iteration into one sweep:
+
+        x = x + alpha * p + omega * s
+        r = s - omega * t
+        skp[0] = rr' * r
+        skp[1] = r' * r
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                dimension n
+
+    @param[in]
+    alpha       magmaDoubleComplex
+                scalar
+
+    @param[in]
+    omega       magmaDoubleComplex
+                scalar
+
+    @param[in]
+    rr          magmaDoubleComplex*
+                shadow residual
+
+    @param[out]
+    r           magmaDoubleComplex*
+                residual
+
+    @param[in]
+    p           magmaDoubleComplex*
+                search direction
+
+    @param[in]
+    s           magmaDoubleComplex*
+                intermediate residual
+
+    @param[in]
+    t           magmaDoubleComplex*
+                t = A * s
+
+    @param[in,out]
+    x           magmaDoubleComplex*
+                solution approximation
+
+    @param[out]
+    skp         magmaDoubleComplex[2]
+                on output, rr' * r and r' * r
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgegpuk
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zbicgmerge_xrbeta_cpu(
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex omega,
+    magmaDoubleComplex *rr,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *p,
+    magmaDoubleComplex *s,
+    magmaDoubleComplex *t,
+    magmaDoubleComplex *x,
+    magmaDoubleComplex *skp,
+    magma_queue_t queue )
+{
+    MAGMA_UNUSED( queue );
+
+    double rho_re = 0.0, rho_im = 0.0, nrm = 0.0;
+
+    #pragma omp parallel for schedule(static) reduction(+:rho_re, rho_im, nrm)
+    for( magma_int_t i=0; i < n; i++ ) {
+        magmaDoubleComplex ri = s[i] - omega * t[i];
+        magmaDoubleComplex dot = MAGMA_Z_CONJ( rr[i] ) * ri;
+        x[i] += alpha * p[i] + omega * s[i];
+        r[i] = ri;
+        rho_re += MAGMA_Z_REAL( dot );
+        rho_im += MAGMA_Z_IMAG( dot );
+        nrm    += MAGMA_Z_REAL( MAGMA_Z_CONJ( ri ) * ri );
+    }
+    skp[0] = MAGMA_Z_MAKE( rho_re, rho_im );
+    skp[1] = MAGMA_Z_MAKE( nrm, 0.0 );
+
+    return MAGMA_SUCCESS;
+}
@@ -0,0 +1,750 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+#include "magmasparse_internal.h"
+
+#include <omp.h>
+
+/*
+    Multi-vector versions of the kernels in magma_zmerge_cpu.cpp, used by
+    the host block solvers for many right-hand sides.
+
+    Blocks of nv vectors are stored row-major: entry (i,k) is at [ i*nv + k ],
+    so a row of A gathers nv contiguous entries per nonzero, and A is streamed
+    once per sweep for all vectors. Unlike the single-vector kernels, the
+    updated vector block is written first, in the same parallel region, so
+    the SpMM gathers from one block instead of recomputing the update from
+    two or three blocks per nonzero. Each vector has its own scalars
+    (alpha[k], beta[k], ...).
+
+    Dot products are accumulated per thread in part, of size
+    omp_get_max_threads() * ndot * nv, and summed in thread order afterwards.
+*/
+
+
+/******************************************************************************/
+// Allocates and zeros the per-thread partial sums for ndot dot products per
+// vector; returns the number of threads in *nthreads.
+static magma_int_t
+magma_zbpartial_alloc(
+    magma_int_t ndot, magma_int_t nv,
+    magmaDoubleComplex **part, magma_int_t *nthreads )
+{
+    magma_int_t info = 0;
+    *nthreads = omp_get_max_threads();
+    magma_int_t count = (*nthreads) * ndot * nv;
+    CHECK( magma_zmalloc_cpu( part, count ));
+    for( magma_int_t i=0; i < count; i++ ) {
+        (*part)[i] = MAGMA_Z_ZERO;
+    }
+cleanup:
+    return info;
+}
+
+
+/******************************************************************************/
+// Sums the per-thread partial sums into skp[ ndot*nv ] and frees part.
+static void
+magma_zbpartial_reduce(
+    magma_int_t ndot, magma_int_t nv, magma_int_t nthreads,
+    magmaDoubleComplex *part, magmaDoubleComplex *skp )
+{
+    for( magma_int_t k=0; k < ndot*nv; k++ ) {
+        magmaDoubleComplex sum = MAGMA_Z_ZERO;
+        for( magma_int_t t=0; t < nthreads; t++ ) {
+            sum += part[ t*ndot*nv + k ];
+        }
+        skp[k] = sum;
+    }
+    magma_free_cpu( part );
+}
+
+
+/**
+    Purpose
+    -------
+
+    Block version of magma_zcgmerge_spmv1_cpu. For each vector k of the
+    row-major blocks:
+
+        Dnew(:,k) = H(:,k) + beta[k] * D(:,k)
+        Z(:,k)    = A * Dnew(:,k)
+        skp[k]    = Dnew(:,k)' * Z(:,k)
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                system matrix in CSR format on the CPU
+
+    @param[in]
+    nv          magma_int_t
+                number of vectors
+
+    @param[in]
+    beta        magmaDoubleComplex[nv]
+                scalars
+
+    @param[in]
+    H           magmaDoubleComplex*
+                (preconditioned) residuals
+
+    @param[in]
+    D           magmaDoubleComplex*
+                search directions of the previous iteration
+
+    @param[out]
+    Dnew        magmaDoubleComplex*
+                new search directions
+
+    @param[out]
+    Z           magmaDoubleComplex*
+                Z = A * Dnew
+
+    @param[out]
+    skp         magmaDoubleComplex[nv]
+                on output, Dnew(:,k)' * Z(:,k)
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgegpuk
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zbcgmerge_spmm1_cpu(
+    magma_z_matrix A,
+    magma_int_t nv,
+    magmaDoubleComplex *beta,
+    magmaDoubleComplex *H,
+    magmaDoubleComplex *D,
+    magmaDoubleComplex *Dnew,
+    magmaDoubleComplex *Z,
+    magmaDoubleComplex *skp,
+    magma_queue_t queue )
+{
+    MAGMA_UNUSED( queue );
+    magma_int_t info = 0;
+
+    magma_int_t n = A.num_rows, nthreads;
+    magmaDoubleComplex *part = NULL;
+    CHECK( magma_zbpartial_alloc( 1, nv, &part, &nthreads ));
+
+    #pragma omp parallel
+    {
+        magmaDoubleComplex * __restrict__ dot = part + omp_get_thread_num()*nv;
+        #pragma omp for schedule(static)
+        for( magma_int_t i=0; i < n; i++ ) {
+            for( magma_int_t k=0; k < nv; k++ ) {
+                Dnew[ i*nv+k ] = H[ i*nv+k ] + beta[k] * D[ i*nv+k ];
+            }
+        }
+        #pragma omp for schedule(static)
+        for( magma_int_t i=0; i < n; i++ ) {
+            magmaDoubleComplex * __restrict__ Zi = Z + i*nv;
+            for( magma_int_t k=0; k < nv; k++ ) {
+                Zi[k] = MAGMA_Z_ZERO;
+            }
+            for( magma_index_t j=A.row[i]; j < A.row[i+1]; j++ ) {
+                magmaDoubleComplex a = A.val[j];
+                const magmaDoubleComplex * __restrict__ Dj = Dnew + A.col[j]*nv;
+                for( magma_int_t k=0; k < nv; k++ ) {
+                    Zi[k] += a * Dj[k];
+                }
+            }
+            for( magma_int_t k=0; k < nv; k++ ) {
+                dot[k] += MAGMA_Z_CONJ( Dnew[ i*nv+k ] ) * Zi[k];
+            }
+        }
+    }
+    magma_zbpartial_reduce( 1, nv, nthreads, part, skp );
+
+cleanup:
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Block version of magma_zcgmerge_xrbeta_cpu. For each vector k:
+
+        X(:,k) = X(:,k) + alpha[k] * D(:,k)
+        R(:,k) = R(:,k) - alpha[k] * Z(:,k)
+        H(:,k) = diag .* R(:,k)     (if diag != NULL, Jacobi preconditioner)
+        rh[k]  = R(:,k)' * H(:,k)
+        rr[k]  = R(:,k)' * R(:,k)
+
+    If diag is NULL, H is not written (pass H = R) and rh = rr.
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                dimension n
+
+    @param[in]
+    nv          magma_int_t
+                number of vectors
+
+    @param[in]
+    alpha       magmaDoubleComplex[nv]
+                scalars
+
+    @param[in]
+    diag        magmaDoubleComplex*
+                inverse of the diagonal of A, or NULL
+
+    @param[in,out]
+    X           magmaDoubleComplex*
+                solution approximations
+
+    @param[in,out]
+    R           magmaDoubleComplex*
+                residuals
+
+    @param[out]
+    H           magmaDoubleComplex*
+                preconditioned residuals
+
+    @param[in]
+    D           magmaDoubleComplex*
+                search directions
+
+    @param[in]
+    Z           magmaDoubleComplex*
+                Z = A * D
+
+    @param[out]
+    rh          double[nv]
+                on output, real part of R(:,k)' * H(:,k)
+
+    @param[out]
+    rr          double[nv]
+                on output, R(:,k)' * R(:,k)
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgegpuk
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zbcgmerge_xrbeta_cpu(
+    magma_int_t n,
+    magma_int_t nv,
+    magmaDoubleComplex *alpha,
+    magmaDoubleComplex *diag,
+    magmaDoubleComplex *X,
+    magmaDoubleComplex *R,
+    magmaDoubleComplex *H,
+    magmaDoubleComplex *D,
+    magmaDoubleComplex *Z,
+    double *rh,
+    double *rr,
+    magma_queue_t queue )
+{
+    MAGMA_UNUSED( queue );
+    magma_int_t info = 0;
+
+    magma_int_t nthreads;
+    magmaDoubleComplex *part = NULL, *skp = NULL;
+    CHECK( magma_zmalloc_cpu( &skp, 2*nv ));
+    CHECK( magma_zbpartial_alloc( 2, nv, &part, &nthreads ));
+
+    #pragma omp parallel
+    {
+        magmaDoubleComplex * __restrict__ dot = part + omp_get_thread_num()*2*nv;
+        #pragma omp for schedule(static)
+        for( magma_int_t i=0; i < n; i++ ) {
+            magmaDoubleComplex * __restrict__ Xi = X + i*nv;
+            magmaDoubleComplex * __restrict__ Ri = R + i*nv;
+            const magmaDoubleComplex * __restrict__ Di = D + i*nv;
+            const magmaDoubleComplex * __restrict__ Zi = Z + i*nv;
+            if ( diag != NULL ) {
+                magmaDoubleComplex * __restrict__ Hi = H + i*nv;
+                for( magma_int_t k=0; k < nv; k++ ) {
+                    magmaDoubleComplex ri = Ri[k] - alpha[k] * Zi[k];
+                    magmaDoubleComplex hi = diag[i] * ri;
+                    Xi[k] += alpha[k] * Di[k];
+                    Ri[k] = ri;
+                    Hi[k] = hi;
+                    dot[k]    += MAGMA_Z_CONJ( ri ) * hi;
+                    dot[nv+k] += MAGMA_Z_CONJ( ri ) * ri;
+                }
+            }
+            else {
+                for( magma_int_t k=0; k < nv; k++ ) {
+                    magmaDoubleComplex ri = Ri[k] - alpha[k] * Zi[k];
+                    Xi[k] += alpha[k] * Di[k];
+                    Ri[k] = ri;
+                    dot[k]    += MAGMA_Z_CONJ( ri ) * ri;
+                    dot[nv+k] += MAGMA_Z_CONJ( ri ) * ri;
+                }
+            }
+        }
+    }
+    magma_zbpartial_reduce( 2, nv, nthreads, part, skp );
+    for( magma_int_t k=0; k < nv; k++ ) {
+        rh[k] = MAGMA_Z_REAL( skp[k] );
+        rr[k] = MAGMA_Z_REAL( skp[nv+k] );
+    }
+
+cleanup:
+    magma_free_cpu( skp );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Block version of magma_zbicgmerge_spmv1_cpu. For each vector k:
+
+        Pnew(:,k) = R(:,k) + beta[k] * ( P(:,k) - omega[k] * V(:,k) )
+        Vnew(:,k) = A * Pnew(:,k)
+        skp[k]    = RR(:,k)' * Vnew(:,k)
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                system matrix in CSR format on the CPU
+
+    @param[in]
+    nv          magma_int_t
+                number of vectors
+
+    @param[in]
+    beta        magmaDoubleComplex[nv]
+                scalars
+
+    @param[in]
+    omega       magmaDoubleComplex[nv]
+                scalars
+
+    @param[in]
+    RR          magmaDoubleComplex*
+                shadow residuals
+
+    @param[in]
+    R           magmaDoubleComplex*
+                residuals
+
+    @param[in]
+    P           magmaDoubleComplex*
+                search directions of the previous iteration
+
+    @param[in]
+    V           magmaDoubleComplex*
+                V = A * P of the previous iteration
+
+    @param[out]
+    Pnew        magmaDoubleComplex*
+                new search directions
+
+    @param[out]
+    Vnew        magmaDoubleComplex*
+                Vnew = A * Pnew
+
+    @param[out]
+    skp         magmaDoubleComplex[nv]
+                on output, RR(:,k)' * Vnew(:,k)
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgegpuk
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zbbicgmerge_spmm1_cpu(
+    magma_z_matrix A,
+    magma_int_t nv,
+    magmaDoubleComplex *beta,
+    magmaDoubleComplex *omega,
+    magmaDoubleComplex *RR,
+    magmaDoubleComplex *R,
+    magmaDoubleComplex *P,
+    magmaDoubleComplex *V,
+    magmaDoubleComplex *Pnew,
+    magmaDoubleComplex *Vnew,
+    magmaDoubleComplex *skp,
+    magma_queue_t queue )
+{
+    MAGMA_UNUSED( queue );
+    magma_int_t info = 0;
+
+    magma_int_t n = A.num_rows, nthreads;
+    magmaDoubleComplex *part = NULL;
+    CHECK( magma_zbpartial_alloc( 1, nv, &part, &nthreads ));
+
+    #pragma omp parallel
+    {
+        magmaDoubleComplex * __restrict__ dot = part + omp_get_thread_num()*nv;
+        #pragma omp for schedule(static)
+        for( magma_int_t i=0; i < n; i++ ) {
+            for( magma_int_t k=0; k < nv; k++ ) {
+                magma_int_t ik = i*nv + k;
+                Pnew[ik] = R[ik] + beta[k] * (P[ik] - omega[k] * V[ik]);
+            }
+        }
+        #pragma omp for schedule(static)
+        for( magma_int_t i=0; i < n; i++ ) {
+            magmaDoubleComplex * __restrict__ Vi = Vnew + i*nv;
+            for( magma_int_t k=0; k < nv; k++ ) {
+                Vi[k] = MAGMA_Z_ZERO;
+            }
+            for( magma_index_t j=A.row[i]; j < A.row[i+1]; j++ ) {
+                magmaDoubleComplex a = A.val[j];
+                const magmaDoubleComplex * __restrict__ Pj = Pnew + A.col[j]*nv;
+                for( magma_int_t k=0; k < nv; k++ ) {
+                    Vi[k] += a * Pj[k];
+                }
+            }
+            for( magma_int_t k=0; k < nv; k++ ) {
+                dot[k] += MAGMA_Z_CONJ( RR[ i*nv+k ] ) * Vi[k];
+            }
+        }
+    }
+    magma_zbpartial_reduce( 1, nv, nthreads, part, skp );
+
+cleanup:
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Block version of magma_zbicgmerge_spmv2_cpu. For each vector k:
+
+        S(:,k)    = R(:,k) - alpha[k] * V(:,k)
+        T(:,k)    = A * S(:,k)
+        skp[k]    = T(:,k)' * S(:,k)
+        skp[nv+k] = T(:,k)' * T(:,k)
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                system matrix in CSR format on the CPU
+
+    @param[in]
+    nv          magma_int_t
+                number of vectors
+
+    @param[in]
+    alpha       magmaDoubleComplex[nv]
+                scalars
+
+    @param[in]
+    R           magmaDoubleComplex*
+                residuals
+
+    @param[in]
+    V           magmaDoubleComplex*
+                V = A * P
+
+    @param[out]
+    S           magmaDoubleComplex*
+                intermediate residuals
+
+    @param[out]
+    T           magmaDoubleComplex*
+                T = A * S
+
+    @param[out]
+    skp         magmaDoubleComplex[2*nv]
+                on output, T(:,k)' * S(:,k) and T(:,k)' * T(:,k)
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgegpuk
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zbbicgmerge_spmm2_cpu(
+    magma_z_matrix A,
+    magma_int_t nv,
+    magmaDoubleComplex *alpha,
+    magmaDoubleComplex *R,
+    magmaDoubleComplex *V,
+    magmaDoubleComplex *S,
+    magmaDoubleComplex *T,
+    magmaDoubleComplex *skp,
+    magma_queue_t queue )
+{
+    MAGMA_UNUSED( queue );
+    magma_int_t info = 0;
+
+    magma_int_t n = A.num_rows, nthreads;
+    magmaDoubleComplex *part = NULL;
+    CHECK( magma_zbpartial_alloc( 2, nv, &part, &nthreads ));
+
+    #pragma omp parallel
+    {
+        magmaDoubleComplex * __restrict__ dot = part + omp_get_thread_num()*2*nv;
+        #pragma omp for schedule(static)
+        for( magma_int_t i=0; i < n; i++ ) {
+            for( magma_int_t k=0; k < nv; k++ ) {
+                S[ i*nv+k ] = R[ i*nv+k ] - alpha[k] * V[ i*nv+k ];
+            }
+        }
+        #pragma omp for schedule(static)
+        for( magma_int_t i=0; i < n; i++ ) {
+            magmaDoubleComplex * __restrict__ Ti = T + i*nv;
+            for( magma_int_t k=0; k < nv; k++ ) {
+                Ti[k] = MAGMA_Z_ZERO;
+            }
+            for( magma_index_t j=A.row[i]; j < A.row[i+1]; j++ ) {
+                magmaDoubleComplex a = A.val[j];
+                const magmaDoubleComplex * __restrict__ Sj = S + A.col[j]*nv;
+                for( magma_int_t k=0; k < nv; k++ ) {
+                    Ti[k] += a * Sj[k];
+                }
+            }
+            for( magma_int_t k=0; k < nv; k++ ) {
+                dot[k]    += MAGMA_Z_CONJ( Ti[k] ) * S[ i*nv+k ];
+                dot[nv+k] += MAGMA_Z_CONJ( Ti[k] ) * Ti[k];
+            }
+        }
+    }
+    magma_zbpartial_reduce( 2, nv, nthreads, part, skp );
+
+cleanup:
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Block version of magma_zbicgmerge_xrbeta_cpu. For each vector k:
+
+        X(:,k)    = X(:,k) + alpha[k] * P(:,k) + omega[k] * S(:,k)
+        R(:,k)    = S(:,k) - omega[k] * T(:,k)
+        skp[k]    = RR(:,k)' * R(:,k)
+        skp[nv+k] = R(:,k)' * R(:,k)
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                dimension n
+
+    @param[in]
+    nv          magma_int_t
+                number of vectors
+
+    @param[in]
+    alpha       magmaDoubleComplex[nv]
+                scalars
+
+    @param[in]
+    omega       magmaDoubleComplex[nv]
+                scalars
+
+    @param[in]
+    RR          magmaDoubleComplex*
+                shadow residuals
+
+    @param[out]
+    R           magmaDoubleComplex*
+                residuals
+
+    @param[in]
+    P           magmaDoubleComplex*
+                search directions
+
+    @param[in]
+    S           magmaDoubleComplex*
+                intermediate residuals
+
+    @param[in]
+    T           magmaDoubleComplex*
+                T = A * S
+
+    @param[in,out]
+    X           magmaDoubleComplex*
+                solution approximations
+
+    @param[out]
+    skp         magmaDoubleComplex[2*nv]
+                on output, RR(:,k)' * R(:,k) and R(:,k)' * R(:,k)
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgegpuk
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zbbicgmerge_xrbeta_cpu(
+    magma_int_t n,
+    magma_int_t nv,
+    magmaDoubleComplex *alpha,
+    magmaDoubleComplex *omega,
+    magmaDoubleComplex *RR,
+    magmaDoubleComplex *R,
+    magmaDoubleComplex *P,
+    magmaDoubleComplex *S,
+    magmaDoubleComplex *T,
+    magmaDoubleComplex *X,
+    magmaDoubleComplex *skp,
+    magma_queue_t queue )
+{
+    MAGMA_UNUSED( queue );
+    magma_int_t info = 0;
+
+    magma_int_t nthreads;
+    magmaDoubleComplex *part = NULL;
+    CHECK( magma_zbpartial_alloc( 2, nv, &part, &nthreads ));
+
+    #pragma omp parallel
+    {
+        magmaDoubleComplex * __restrict__ dot = part + omp_get_thread_num()*2*nv;
+        #pragma omp for schedule(static)
+        for( magma_int_t i=0; i < n; i++ ) {
+            magmaDoubleComplex * __restrict__ Xi = X + i*nv;
+            magmaDoubleComplex * __restrict__ Ri = R + i*nv;
+            const magmaDoubleComplex * __restrict__ RRi = RR + i*nv;
+            const magmaDoubleComplex * __restrict__ Pi = P + i*nv;
+            const magmaDoubleComplex * __restrict__ Si = S + i*nv;
+            const magmaDoubleComplex * __restrict__ Ti = T + i*nv;
+            for( magma_int_t k=0; k < nv; k++ ) {
+                magmaDoubleComplex ri = Si[k] - omega[k] * Ti[k];
+                Xi[k] += alpha[k] * Pi[k] + omega[k] * Si[k];
+                Ri[k] = ri;
+                dot[k]    += MAGMA_Z_CONJ( RRi[k] ) * ri;
+                dot[nv+k] += MAGMA_Z_CONJ( ri ) * ri;
+            }
+        }
+    }
+    magma_zbpartial_reduce( 2, nv, nthreads, part, skp );
+
+cleanup:
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Copies nk vectors between dense blocks of either layout:
+
+        dst(:,dst_idx[k]) = src(:,src_idx[k]),  k = 0, ..., nk-1
+
+    where an index list of NULL means 0, ..., nk-1. A block of layout
+    MagmaColMajor has entry (i,k) at [ i + k*ld ], one of layout MagmaRowMajor
+    at [ i*ld + k ]. The block solvers use it to convert between the user's
+    column-major vectors and their row-major workspace, and to drop
+    converged vectors from the workspace.
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                number of rows
+
+    @param[in]
+    nk          magma_int_t
+                number of vectors to copy
+
+    @param[in]
+    src_order   magma_order_t
+                layout of src
+
+    @param[in]
+    src         magmaDoubleComplex*
+                source block
+
+    @param[in]
+    ldsrc       magma_int_t
+                leading dimension of src
+
+    @param[in]
+    src_idx     magma_index_t[nk]
+                vectors of src to copy, or NULL
+
+    @param[in]
+    dst_order   magma_order_t
+                layout of dst
+
+    @param[out]
+    dst         magmaDoubleComplex*
+                destination block; must not overlap src
+
+    @param[in]
+    lddst       magma_int_t
+                leading dimension of dst
+
+    @param[in]
+    dst_idx     magma_index_t[nk]
+                vectors of dst to write, or NULL
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zbcopy_cpu(
+    magma_int_t n,
+    magma_int_t nk,
+    magma_order_t src_order,
+    magmaDoubleComplex *src, magma_int_t ldsrc,
+    magma_index_t *src_idx,
+    magma_order_t dst_order,
+    magmaDoubleComplex *dst, magma_int_t lddst,
+    magma_index_t *dst_idx,
+    magma_queue_t queue )
+{
+    MAGMA_UNUSED( queue );
+
+    // strides between rows and between vectors
+    magma_int_t si = 1, sk = ldsrc, di = 1, dk = lddst;
+    if ( src_order == MagmaRowMajor ) {
+        si = ldsrc;  sk = 1;
+    }
+    if ( dst_order == MagmaRowMajor ) {
+        di = lddst;  dk = 1;
+    }
+
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i < n; i++ ) {
+        for( magma_int_t k=0; k < nk; k++ ) {
+            magma_int_t ks = (src_idx == NULL ? k : src_idx[k]);
+            magma_int_t kd = (dst_idx == NULL ? k : dst_idx[k]);
+            dst[ i*di + kd*dk ] = src[ i*si + ks*sk ];
+        }
+    }
+
+    return MAGMA_SUCCESS;
+}
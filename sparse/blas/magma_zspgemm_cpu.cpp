@@ -0,0 +1,438 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+#include <algorithm>
+#include "magmasparse_internal.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*
+    Host sparse matrix-matrix product C = alpha * A * B for CSR matrices,
+    in two phases, as in cuSPARSE's csrgemm:
+
+    - symbolic: computes the pattern of C (row pointer and sorted column
+      indices), and allocates its values.
+    - numeric:  computes the values of C for that pattern.
+
+    The symbolic phase is the expensive one, so when A and B change values
+    but not patterns (e.g., factors L and U in ParILU sweeps), it is done
+    once and only the numeric phase is repeated.
+
+    Both phases go over rows of C in parallel. Each thread accumulates its
+    row in a hash table of columns, with open addressing and linear probing,
+    sized to a power of 2 at least twice the row's entries, so its cost
+    is proportional to the row's flops, not to the number of columns.
+*/
+
+// rows per OpenMP chunk; row costs vary, so rows are scheduled dynamically
+const magma_int_t spgemm_chunk = 64;
+
+
+/******************************************************************************/
+// Returns the hash table size for up to n entries: a power of 2 >= 2n.
+static inline magma_int_t
+spgemm_table_size( magma_int_t n )
+{
+    magma_int_t size = 1;
+    while ( size < 2*n ) {
+        size *= 2;
+    }
+    return size;
+}
+
+
+/******************************************************************************/
+// Returns the initial slot for column col in a table of size mask + 1.
+// Multiplying by an odd constant is a bijection mod 2^k, so a contiguous
+// range of columns gets distinct slots.
+static inline magma_int_t
+spgemm_hash( magma_index_t col, magma_int_t mask )
+{
+    return magma_int_t( uint32_t( col ) * 2654435761u ) & mask;
+}
+
+
+/******************************************************************************/
+// Returns the number of threads used by parallel regions.
+static magma_int_t
+spgemm_num_threads()
+{
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+
+/******************************************************************************/
+// Returns the calling thread's number in a parallel region.
+static magma_int_t
+spgemm_thread_num()
+{
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes the sparsity pattern of C = A * B on the host, for matrices A
+    and B in CSR format: the row pointer and the column indices of C, sorted
+    within each row. Allocates C.val, but doesn't set it; use
+    magma_zspgemm_numeric_cpu for that, repeatedly if A and B keep their
+    patterns but change values.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A in CSR on the CPU
+
+    @param[in]
+    B           magma_z_matrix
+                input matrix B in CSR on the CPU
+
+    @param[out]
+    C           magma_z_matrix*
+                output matrix C in CSR on the CPU, with the pattern of A * B
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zblas
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zspgemm_symbolic_cpu(
+    magma_z_matrix A,
+    magma_z_matrix B,
+    magma_z_matrix *C,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_index_t *keys = NULL;
+    magma_int_t num_threads = spgemm_num_threads();
+    magma_int_t max_bound = 0, table_size;
+
+    magma_zmfree( C, queue );
+
+    if ( A.memory_location != Magma_CPU || B.memory_location != Magma_CPU ) {
+        info = MAGMA_ERR_INVALID_PTR;
+        goto cleanup;
+    }
+    if ( A.num_cols != B.num_rows ) {
+        info = MAGMA_ERR_ILLEGAL_VALUE;
+        goto cleanup;
+    }
+
+    C->ownership = MagmaTrue;
+    C->storage_type = Magma_CSR;
+    C->memory_location = Magma_CPU;
+    C->num_rows = A.num_rows;
+    C->num_cols = B.num_cols;
+
+    CHECK( magma_index_malloc_cpu( &C->row, C->num_rows+1 ));
+
+    // upper bound on each row's entries: its number of products, capped at
+    // the number of columns; store in row[i+1] for now
+    #pragma omp parallel for schedule(static) reduction(max:max_bound)
+    for( magma_int_t i=0; i < A.num_rows; i++ ) {
+        magma_int_t bound = 0;
+        for( magma_index_t j=A.row[i]; j < A.row[i+1]; j++ ) {
+            magma_index_t k = A.col[j];
+            bound += B.row[k+1] - B.row[k];
+        }
+        bound = min( bound, B.num_cols );
+        C->row[i+1] = bound;
+        max_bound = max( max_bound, bound );
+    }
+    table_size = spgemm_table_size( max_bound );
+    CHECK( magma_index_malloc_cpu( &keys, num_threads * table_size ));
+
+    // count each row's distinct columns
+    #pragma omp parallel
+    {
+        magma_index_t *table = keys + spgemm_thread_num() * table_size;
+
+        #pragma omp for schedule(dynamic, spgemm_chunk)
+        for( magma_int_t i=0; i < A.num_rows; i++ ) {
+            magma_int_t bound = C->row[i+1];
+            if ( bound <= 1 ) {
+                continue;
+            }
+            magma_int_t mask = spgemm_table_size( bound ) - 1;
+            for( magma_int_t s=0; s <= mask; s++ ) {
+                table[s] = -1;
+            }
+            magma_int_t count = 0;
+            for( magma_index_t j=A.row[i]; j < A.row[i+1]; j++ ) {
+                magma_index_t k = A.col[j];
+                for( magma_index_t l=B.row[k]; l < B.row[k+1]; l++ ) {
+                    magma_index_t col = B.col[l];
+                    magma_int_t s = spgemm_hash( col, mask );
+                    while ( table[s] != -1 && table[s] != col ) {
+                        s = (s + 1) & mask;
+                    }
+                    if ( table[s] == -1 ) {
+                        table[s] = col;
+                        count++;
+                    }
+                }
+            }
+            C->row[i+1] = count;
+        }
+    }
+
+    C->row[0] = 0;
+    CHECK( magma_zmatrix_createrowptr( C->num_rows, C->row, queue ));
+    C->nnz = C->row[ C->num_rows ];
+    C->true_nnz = C->nnz;
+
+    CHECK( magma_index_malloc_cpu( &C->col, C->nnz ));
+    CHECK( magma_zmalloc_cpu( &C->val, C->nnz ));
+
+    // write each row's columns, in insertion order, then sort them
+    #pragma omp parallel
+    {
+        magma_index_t *table = keys + spgemm_thread_num() * table_size;
+
+        #pragma omp for schedule(dynamic, spgemm_chunk)
+        for( magma_int_t i=0; i < A.num_rows; i++ ) {
+            magma_index_t *ccol = C->col + C->row[i];
+            magma_int_t len = C->row[i+1] - C->row[i];
+            if ( len == 0 ) {
+                continue;
+            }
+            magma_int_t mask = spgemm_table_size( len ) - 1;
+            for( magma_int_t s=0; s <= mask; s++ ) {
+                table[s] = -1;
+            }
+            magma_int_t count = 0;
+            for( magma_index_t j=A.row[i]; j < A.row[i+1]; j++ ) {
+                magma_index_t k = A.col[j];
+                for( magma_index_t l=B.row[k]; l < B.row[k+1]; l++ ) {
+                    magma_index_t col = B.col[l];
+                    magma_int_t s = spgemm_hash( col, mask );
+                    while ( table[s] != -1 && table[s] != col ) {
+                        s = (s + 1) & mask;
+                    }
+                    if ( table[s] == -1 ) {
+                        table[s] = col;
+                        ccol[ count++ ] = col;
+                    }
+                }
+            }
+            std::sort( ccol, ccol + len );
+        }
+    }
+
+cleanup:
+    if ( info != 0 ) {
+        magma_zmfree( C, queue );
+    }
+    magma_free_cpu( keys );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes the values of C = alpha * A * B on the host, for matrices A
+    and B in CSR format, where C has the pattern from
+    magma_zspgemm_symbolic_cpu for matrices with the same patterns as A and
+    B. Entries of C not in A * B are set to zero.
+
+    Arguments
+    ---------
+
+    @param[in]
+    alpha       magmaDoubleComplex
+                scalar alpha
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A in CSR on the CPU
+
+    @param[in]
+    B           magma_z_matrix
+                input matrix B in CSR on the CPU
+
+    @param[in,out]
+    C           magma_z_matrix*
+                On entry, matrix C with the pattern of A * B, from
+                magma_zspgemm_symbolic_cpu.
+                On exit, C.val = alpha * A * B.
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @return     MAGMA_ERR_ILLEGAL_VALUE if A * B has an entry that isn't in
+                the pattern of C.
+
+    @ingroup magmasparse_zblas
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zspgemm_numeric_cpu(
+    magmaDoubleComplex alpha,
+    magma_z_matrix A,
+    magma_z_matrix B,
+    magma_z_matrix *C,
+    magma_queue_t queue )
+{
+    MAGMA_UNUSED( queue );
+    magma_int_t info = 0;
+
+    magma_index_t *keys = NULL, *slots = NULL;
+    magma_int_t num_threads = spgemm_num_threads();
+    magma_int_t max_len = 0, table_size;
+    magma_int_t missing = 0;
+
+    if ( A.memory_location != Magma_CPU || B.memory_location != Magma_CPU
+         || C->memory_location != Magma_CPU ) {
+        info = MAGMA_ERR_INVALID_PTR;
+        goto cleanup;
+    }
+    if ( A.num_cols != B.num_rows || C->num_rows != A.num_rows
+         || C->num_cols != B.num_cols ) {
+        info = MAGMA_ERR_ILLEGAL_VALUE;
+        goto cleanup;
+    }
+
+    #pragma omp parallel for schedule(static) reduction(max:max_len)
+    for( magma_int_t i=0; i < C->num_rows; i++ ) {
+        max_len = max( max_len, magma_int_t( C->row[i+1] - C->row[i] ));
+    }
+    table_size = spgemm_table_size( max_len );
+    CHECK( magma_index_malloc_cpu( &keys,  num_threads * table_size ));
+    CHECK( magma_index_malloc_cpu( &slots, num_threads * table_size ));
+
+    // hash each row's columns of C to their positions in C.col,
+    // then accumulate products directly into C.val
+    #pragma omp parallel reduction(+:missing)
+    {
+        magma_index_t *table = keys  + spgemm_thread_num() * table_size;
+        magma_index_t *pos   = slots + spgemm_thread_num() * table_size;
+
+        #pragma omp for schedule(dynamic, spgemm_chunk)
+        for( magma_int_t i=0; i < C->num_rows; i++ ) {
+            magma_index_t start = C->row[i];
+            magma_int_t len = C->row[i+1] - start;
+            magma_int_t mask = spgemm_table_size( len ) - 1;
+            for( magma_int_t s=0; s <= mask; s++ ) {
+                table[s] = -1;
+            }
+            for( magma_int_t p=0; p < len; p++ ) {
+                magma_index_t col = C->col[ start + p ];
+                magma_int_t s = spgemm_hash( col, mask );
+                while ( table[s] != -1 ) {
+                    s = (s + 1) & mask;
+                }
+                table[s] = col;
+                pos[s] = start + p;
+                C->val[ start + p ] = MAGMA_Z_ZERO;
+            }
+            for( magma_index_t j=A.row[i]; j < A.row[i+1]; j++ ) {
+                magma_index_t k = A.col[j];
+                magmaDoubleComplex a = alpha * A.val[j];
+                for( magma_index_t l=B.row[k]; l < B.row[k+1]; l++ ) {
+                    magma_index_t col = B.col[l];
+                    magma_int_t s = spgemm_hash( col, mask );
+                    while ( table[s] != -1 && table[s] != col ) {
+                        s = (s + 1) & mask;
+                    }
+                    if ( table[s] == col ) {
+                        C->val[ pos[s] ] += a * B.val[l];
+                    }
+                    else {
+                        missing++;
+                    }
+                }
+            }
+        }
+    }
+    if ( missing > 0 ) {
+        info = MAGMA_ERR_ILLEGAL_VALUE;
+    }
+
+cleanup:
+    magma_free_cpu( keys );
+    magma_free_cpu( slots );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes C = alpha * A * B on the host for matrices A and B in CSR
+    format: magma_zspgemm_symbolic_cpu followed by
+    magma_zspgemm_numeric_cpu.
+
+    Arguments
+    ---------
+
+    @param[in]
+    alpha       magmaDoubleComplex
+                scalar alpha
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A in CSR on the CPU
+
+    @param[in]
+    B           magma_z_matrix
+                input matrix B in CSR on the CPU
+
+    @param[out]
+    C           magma_z_matrix*
+                output matrix C = alpha * A * B in CSR on the CPU
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zblas
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zspgemm_cpu(
+    magmaDoubleComplex alpha,
+    magma_z_matrix A,
+    magma_z_matrix B,
+    magma_z_matrix *C,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    CHECK( magma_zspgemm_symbolic_cpu( A, B, C, queue ));
+    CHECK( magma_zspgemm_numeric_cpu( alpha, A, B, C, queue ));
+
+cleanup:
+    if ( info != 0 ) {
+        magma_zmfree( C, queue );
+    }
+    return info;
+}
@@ -54,8 +54,8 @@ magma_zjaccardweights_kernel(
             while (il < rowptrA[i+1] && iu < rowptrA[j+1])
             {
             
-                jl = colidxJ[il];
-                ju = rowidxJ[iu];
+                jl = colidxA[il];
+                ju = colidxA[iu];
             
                 // avoid branching
                 // if there are actual values:
@@ -68,7 +68,10 @@ magma_zjaccardweights_kernel(
             
 
             
-            valJ[k] = MAGMA_Z_MAKE(MAGMA_Z_REAL(intersect) / MAGMA_Z_REAL( sum_i + sum_j - intersect), 0.0 );
+            // zero if both rows are empty
+            valJ[k] = ( MAGMA_Z_REAL( sum_i + sum_j ) > 0 )
+                ? MAGMA_Z_MAKE(MAGMA_Z_REAL(intersect) / MAGMA_Z_REAL( sum_i + sum_j - intersect), 0.0 )
+                : zero;
         } else {
             valJ[k] = MAGMA_Z_ONE;
         }
@@ -80,7 +83,11 @@ magma_zjaccardweights_kernel(
     Purpose
     -------
 
-    Computes Jaccard weights for a matrix
+    Computes Jaccard weights for a matrix: for each entry (i, j) of J,
+    i != j, the number of columns in both rows i and j of A over the number
+    of columns in either row. Diagonal entries of J are set to one.
+    Columns in each row of A must be sorted.
+    If A and J are on the CPU, calls magma_zjaccard_weights_cpu.
 
     Arguments
     ---------
@@ -108,6 +115,10 @@ magma_zjaccard_weights(
 {
     magma_int_t info = 0;
     
+    if ( A.memory_location == Magma_CPU && J->memory_location == Magma_CPU ) {
+        return magma_zjaccard_weights_cpu( A, J, queue );
+    }
+
     magma_int_t m = J->num_rows;
     magma_int_t n = J->num_rows;
     magma_int_t nnz = J->nnz;
@@ -8,10 +8,12 @@
        @author Mark Gates
 */
 
-#include <cuda.h>  // for CUDA_VERSION
-
 #include "magmasparse_internal.h"
 
+#if ! defined(MAGMA_HAVE_HOST)
+#include <cuda.h>  // for CUDA_VERSION
+#endif
+
 /**
     Maps a cuSPARSE error to a MAGMA error.
     
@@ -37,7 +39,7 @@ cusparse2magma_error( cusparseStatus_t status )
         case CUSPARSE_STATUS_MATRIX_TYPE_NOT_SUPPORTED: return MAGMA_ERR_CUSPARSE_MATRIX_TYPE_NOT_SUPPORTED; break;
         
         // added in CUDA 6.0
-        #if CUDA_VERSION >= 6000
+        #if CUDA_VERSION >= 6000 || defined(MAGMA_HAVE_HOST)
         case CUSPARSE_STATUS_ZERO_PIVOT:                return MAGMA_ERR_CUSPARSE_ZERO_PIVOT;                break;
         #endif
         
@@ -41,6 +41,7 @@ magma_zmfree(
     magma_z_matrix *A,
     magma_queue_t queue )
 {
+    magma_zmprofile_forget( A, queue );
     if ( A->memory_location == Magma_CPU ) {
         if (A->storage_type == Magma_ELL || A->storage_type == Magma_ELLPACKT) {
             if (A->ownership) {
@@ -463,20 +464,42 @@ magma_zprecondfree(
     magma_z_preconditioner *precond_par,
     magma_queue_t queue ){
 
+    // the arrays are freed directly below, not with magma_zmfree
+    magma_z_matrix *cached[] = {
+        &precond_par->M, &precond_par->L, &precond_par->LT, &precond_par->U,
+        &precond_par->UT, &precond_par->LD, &precond_par->UD,
+        &precond_par->LDT, &precond_par->UDT, &precond_par->d,
+        &precond_par->d2, &precond_par->work1, &precond_par->work2 };
+    for( size_t m=0; m < sizeof(cached) / sizeof(cached[0]); m++ ) {
+        magma_zmprofile_forget( cached[m], queue );
+    }
+
     if ( precond_par->d.val != NULL ) {
-        magma_free( precond_par->d.val );
+        if ( precond_par->d.memory_location == Magma_CPU )
+            magma_free_cpu( precond_par->d.val );
+        else
+            magma_free( precond_par->d.val );
         precond_par->d.val = NULL;
     }
     if ( precond_par->d2.val != NULL ) {
-        magma_free( precond_par->d2.val );
+        if ( precond_par->d2.memory_location == Magma_CPU )
+            magma_free_cpu( precond_par->d2.val );
+        else
+            magma_free( precond_par->d2.val );
         precond_par->d2.val = NULL;
     }
     if ( precond_par->work1.val != NULL ) {
-        magma_free( precond_par->work1.val );
+        if ( precond_par->work1.memory_location == Magma_CPU )
+            magma_free_cpu( precond_par->work1.val );
+        else
+            magma_free( precond_par->work1.val );
         precond_par->work1.val = NULL;
     }
     if ( precond_par->work2.val != NULL ) {
-        magma_free( precond_par->work2.val );
+        if ( precond_par->work2.memory_location == Magma_CPU )
+            magma_free_cpu( precond_par->work2.val );
+        else
+            magma_free( precond_par->work2.val );
         precond_par->work2.val = NULL;
     }
     if ( precond_par->M.val != NULL ) {
@@ -738,6 +761,10 @@ magma_zprecondfree(
         magma_free( precond_par->U_dgraphindegree_bak );
         precond_par->U_dgraphindegree_bak = NULL;
     }
+    // host data kept for refactorization
+    magma_zmfree( &precond_par->hA, queue );
+    magma_zmfree( &precond_par->hL, queue );
+    magma_zmfree( &precond_par->hU, queue );
 
     precond_par->solver = Magma_NONE;
     
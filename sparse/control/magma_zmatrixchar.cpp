@@ -19,7 +19,8 @@
     -------
 
     Checks the maximal number of nonzeros in a row of matrix A.
-    Inserts the data into max_nnz_row.
+    Inserts the data into max_nnz_row. For CSR, the value is taken from the
+    profile of A (see magma_zmprofile).
 
 
     Arguments
@@ -44,18 +45,14 @@ magma_zrowentries(
     
     magma_index_t *length=NULL;
     magma_index_t i,j, maxrowlength=0;
+    magma_matrix_profile profile;
     
     // check whether matrix on CPU
     if ( A->memory_location == Magma_CPU ) {
         // CSR
         if ( A->storage_type == Magma_CSR ) {
-            CHECK( magma_index_malloc_cpu( &length, A->num_rows));
-            for( i=0; i<A->num_rows; i++ ) {
-                length[i] = A->row[i+1]-A->row[i];
-                if (length[i] > maxrowlength)
-                     maxrowlength = length[i];
-            }
-            A->max_nnz_row = maxrowlength;
+            CHECK( magma_zmprofile( A, &profile, queue ));
+            A->max_nnz_row = profile.max_row;
         }
         // Dense
         else if ( A->storage_type == Magma_DENSE ) {
@@ -89,6 +86,7 @@ cleanup:
     -------
 
     Computes the diameter of a sparse matrix and stores the value in diameter.
+    For CSR, the value is taken from the profile of A (see magma_zmprofile).
 
 
     Arguments
@@ -111,25 +109,14 @@ magma_zdiameter(
     magma_int_t info = 0;
     
     magma_index_t i, j, tmp,  *dim=NULL, maxdim=0;
+    magma_matrix_profile profile;
     
     // check whether matrix on CPU
     if ( A->memory_location == Magma_CPU ) {
         // CSR
         if ( A->storage_type == Magma_CSR ) {
-            CHECK( magma_index_malloc_cpu( &dim, A->num_rows));
-            for( i=0; i<A->num_rows; i++ ) {
-                dim[i] = 0;
-                for( j=A->row[i]; j<A->row[i+1]; j++ ) {
-                   // if ( MAGMA_Z_REAL(A->val[j]) > THRESHOLD ) {
-                        tmp = abs( i - A->col[j] );
-                        if ( tmp > dim[i] )
-                            dim[i] = tmp;
-                   // }
-                }
-                if ( dim[i] > maxdim )
-                     maxdim = dim[i];
-            }
-            A->diameter = maxdim;
+            CHECK( magma_zmprofile( A, &profile, queue ));
+            A->diameter = profile.bandwidth;
         }
         // Dense
         else if ( A->storage_type == Magma_DENSE ) {
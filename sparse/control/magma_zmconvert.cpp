@@ -9,8 +9,11 @@
        @author Hartwig Anzt
 */
 #include "magmasparse_internal.h"
+#include "magma_timer.h"
 
+#if ! defined(MAGMA_HAVE_HOST)
 #include <cuda.h>  // for CUDA_VERSION
+#endif
 
 
 /* For hipSPARSE, they use a separate complex type than for hipBLAS */
@@ -195,6 +198,11 @@ magma_zmconvert(
 
     cusparseHandle_t cusparseHandle = 0;
     cusparseMatDescr_t descr = 0;
+
+    // time and hardware counters of conversions on the CPU, with ENABLE_TIMER
+    magma_timer_t time = 0;
+    magma_counters_t counters = { 0, 0, 0, 0 };
+    char name[ 64 ];
     
     // make sure the target structure is empty
     magma_zmfree( B, queue );
@@ -229,6 +237,9 @@ magma_zmconvert(
     // check whether matrix on CPU
     if ( A.memory_location == Magma_CPU )
     {
+        timer_start( time );
+        counters_start( counters );
+
         // CSR to anything
         if ( old_format == Magma_CSR )
         {
@@ -1629,6 +1640,14 @@ magma_zmconvert(
             info = MAGMA_ERR_NOT_SUPPORTED;
         }
     } // end CPU case
+#if defined(MAGMA_HAVE_HOST)
+    else if ( A.memory_location == Magma_DEV ) {
+        // no device kernels or cuSPARSE: convert on the CPU
+        CHECK( magma_zmtransfer( A, &hA, A.memory_location, Magma_CPU, queue ));
+        CHECK( magma_zmconvert( hA, &hB, old_format, new_format, queue ));
+        CHECK( magma_zmtransfer( hB, B, Magma_CPU, A.memory_location, queue ));
+    }
+#else
     else if ( A.memory_location == Magma_DEV ) {
         // CSR to CSR
         if ( old_format == Magma_CSR && new_format == Magma_CSR ) {
@@ -1954,8 +1973,16 @@ magma_zmconvert(
             CHECK( magma_zmtransfer( hB, B, Magma_CPU, A.memory_location, queue ));
         }
     }
+#endif
 
 cleanup:
+    if ( A.memory_location == Magma_CPU ) {
+        counters_stop( counters );
+        timer_stop( time );
+        timer_snprintf( name, sizeof(name), "%% zmconvert %lld -> %lld",
+                        (long long) old_format, (long long) new_format );
+        counters_printf( name, counters, time );
+    }
     cusparseDestroyMatDescr(descr);
     cusparseDestroy(cusparseHandle);
     descr = NULL;
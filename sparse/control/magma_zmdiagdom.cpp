@@ -17,8 +17,9 @@
     Purpose
     -------
     This routine takes a CSR matrix and computes the average diagonal dominance.
-    For each row i, it computes the abs(d_ii)/sum_j(abs(a_ij)).
-    It returns max, min, and average.
+    For each row i, it computes sum_{j!=i}(abs(a_ij))/abs(d_ii).
+    It returns max, min, and average over the rows with nonzero diagonal.
+    The values are taken from the profile of M (see magma_zmprofile).
 
     Arguments
     ---------
@@ -55,50 +56,17 @@ magma_zmdiagdom(
     magma_queue_t queue )
 {
     magma_int_t info = 0;
+    magma_matrix_profile profile;
     *min_dd = 0.0;
     *max_dd = 0.0;
     *avg_dd = 0.0;
-    magma_int_t count = 0;
-    
-    magma_d_matrix x={Magma_CSR};
-    magma_z_matrix A={Magma_CSR};
-    CHECK( magma_zmtransfer( M, &A, M.memory_location, Magma_CPU, queue ));
-    CHECK( magma_dvinit( &x, Magma_CPU, A.num_rows, 1, 0.0, queue ) );
-    
-    #pragma omp parallel for
-    for( magma_int_t i=0; i<A.num_rows; i++ ){
-        double diag = 0.0;
-        double offdiag = 0.0;
-        for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
-            double val = MAGMA_Z_ABS( A.val[j] );
-            if( A.col[j] == i ){
-                diag += val;
-            } else {
-                offdiag += val;    
-            }
-        }
-        x.val[i] = offdiag / diag;
-    }
-    *min_dd = 1e10;
-    *max_dd = 0.0;
-    *avg_dd =0.0;
-    for(magma_int_t i=0; i<A.num_rows; i++ ){
-        if( x.val[i] < 0.0 ){
-            ;
-        } else {
-            *min_dd = ( x.val[i] < *min_dd ) ? x.val[i] : *min_dd; 
-            *max_dd = ( x.val[i] > *max_dd ) ? x.val[i] : *max_dd; 
-            *avg_dd += x.val[i];
-            count++;
-        }
-    }
-    
-    *avg_dd = *avg_dd / ( (double) count );
-    
+
+    CHECK( magma_zmprofile( &M, &profile, queue ));
+    *min_dd = profile.dd_min;
+    *max_dd = profile.dd_max;
+    *avg_dd = profile.dd_avg;
+
 cleanup:
-    magma_dmfree(&x, queue );
-    magma_zmfree(&A, queue );
-    
     return info;
 }
 
@@ -12,6 +12,225 @@
 
 #define THRESHOLD 10e-99
 
+// rows per block of partial sums; blocks are summed pairwise
+const magma_int_t mdiff_block = 256;
+
+
+/******************************************************************************/
+// Returns |x|^2.
+static inline double
+mdiff_abs2( magmaDoubleComplex x )
+{
+    double re = MAGMA_Z_REAL( x );
+    double im = MAGMA_Z_IMAG( x );
+    return re*re + im*im;
+}
+
+
+/******************************************************************************/
+// Adds x to sum with Kahan compensation c.
+static inline void
+mdiff_kahan_add( double x, double *sum, double *c )
+{
+    double y = x - *c;
+    double t = *sum + y;
+    *c = (t - *sum) - y;
+    *sum = t;
+}
+
+
+/******************************************************************************/
+// Returns sum of x[0 : n-1], pairwise, with stride incx.
+static double
+mdiff_pairwise_sum( magma_int_t n, const double *x, magma_int_t incx )
+{
+    if ( n <= 8 ) {
+        double sum = 0;
+        for( magma_int_t i=0; i < n; i++ ) {
+            sum += x[ i*incx ];
+        }
+        return sum;
+    }
+    magma_int_t n1 = n / 2;
+    return mdiff_pairwise_sum( n1, x, incx )
+         + mdiff_pairwise_sum( n - n1, x + n1*incx, incx );
+}
+
+
+/******************************************************************************/
+// Returns whether column indices col[ start : end-1 ] are strictly increasing.
+static inline bool
+mdiff_sorted( const magma_index_t *col, magma_index_t start, magma_index_t end )
+{
+    for( magma_index_t k=start+1; k < end; k++ ) {
+        if ( col[k-1] >= col[k] ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Compares the CSR matrices A and B row by row, merging the column indices
+    of each row, so in O(nnz) time for rows with sorted column indices
+    (unsorted rows are searched instead), in parallel over rows.
+    Computes sums of squares of
+    
+        sums[0] = sum_{(i,j) in A and B}  |B_ij - A_ij|^2
+        sums[1] = sum_{(i,j) in A only}   |A_ij|^2
+        sums[2] = sum_{(i,j) in B only}   |B_ij|^2
+    
+    so ||A - B||_F^2 = sums[0] + sums[1] + sums[2], and
+    ||A - B||_F^2 on the sparsity pattern of A is sums[0] + sums[1].
+    Rows are summed in fixed blocks with compensated summation, and blocks
+    are summed pairwise, so results don't depend on the number of threads.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                sparse matrix in CSR on the CPU
+
+    @param[in,out]
+    B           magma_z_matrix*
+                sparse matrix in CSR on the CPU, with the same number of
+                rows as A.
+                If subtract, on exit B_ij = B_ij - A_ij for (i,j) in A and B.
+
+    @param[in]
+    subtract    magma_bool_t
+                whether to overwrite B with B - A on matching entries
+
+    @param[out]
+    sums        real_Double_t[3]
+                sums of squares, as above
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmdiff_merge(
+    magma_z_matrix A, magma_z_matrix *B,
+    magma_bool_t subtract,
+    real_Double_t sums[3],
+    magma_queue_t queue )
+{
+    MAGMA_UNUSED( queue );
+    magma_int_t info = 0;
+
+    double *partial = NULL;
+    magma_int_t num_rows = A.num_rows;
+    magma_int_t nblocks = magma_ceildiv( num_rows, mdiff_block );
+
+    sums[0] = sums[1] = sums[2] = 0.0;
+
+    if ( A.memory_location != Magma_CPU || B->memory_location != Magma_CPU ) {
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+    if ( A.num_rows != B->num_rows ) {
+        info = MAGMA_ERR_ILLEGAL_VALUE;
+        goto cleanup;
+    }
+    if ( num_rows == 0 ) {
+        goto cleanup;
+    }
+
+    CHECK( magma_dmalloc_cpu( &partial, 3*nblocks ));
+
+    #pragma omp parallel for schedule(dynamic)
+    for( magma_int_t ib=0; ib < nblocks; ib++ ) {
+        double sum[3] = { 0, 0, 0 }, c[3] = { 0, 0, 0 };
+        magma_int_t iend = min( (ib+1)*mdiff_block, num_rows );
+        for( magma_int_t i=ib*mdiff_block; i < iend; i++ ) {
+            magma_index_t ja = A.row[i], enda = A.row[i+1];
+            magma_index_t kb = B->row[i], endb = B->row[i+1];
+            double row[3] = { 0, 0, 0 };
+            if ( mdiff_sorted( A.col, ja, enda ) && mdiff_sorted( B->col, kb, endb )) {
+                while ( ja < enda && kb < endb ) {
+                    magma_index_t acol = A.col[ja];
+                    magma_index_t bcol = B->col[kb];
+                    if ( acol == bcol ) {
+                        magmaDoubleComplex diff = B->val[kb] - A.val[ja];
+                        if ( subtract ) {
+                            B->val[kb] = diff;
+                        }
+                        row[0] += mdiff_abs2( diff );
+                        ja++;
+                        kb++;
+                    }
+                    else if ( acol < bcol ) {
+                        row[1] += mdiff_abs2( A.val[ja] );
+                        ja++;
+                    }
+                    else {
+                        row[2] += mdiff_abs2( B->val[kb] );
+                        kb++;
+                    }
+                }
+                for( ; ja < enda; ja++ ) {
+                    row[1] += mdiff_abs2( A.val[ja] );
+                }
+                for( ; kb < endb; kb++ ) {
+                    row[2] += mdiff_abs2( B->val[kb] );
+                }
+            }
+            else {
+                // unsorted row: search B's row for each entry of A's row,
+                // then A's row for each entry of B's row
+                for( magma_index_t j=ja; j < enda; j++ ) {
+                    magma_index_t k = kb;
+                    while ( k < endb && B->col[k] != A.col[j] ) {
+                        k++;
+                    }
+                    if ( k < endb ) {
+                        magmaDoubleComplex diff = B->val[k] - A.val[j];
+                        if ( subtract ) {
+                            B->val[k] = diff;
+                        }
+                        row[0] += mdiff_abs2( diff );
+                    }
+                    else {
+                        row[1] += mdiff_abs2( A.val[j] );
+                    }
+                }
+                for( magma_index_t k=kb; k < endb; k++ ) {
+                    magma_index_t j = ja;
+                    while ( j < enda && A.col[j] != B->col[k] ) {
+                        j++;
+                    }
+                    if ( j == enda ) {
+                        row[2] += mdiff_abs2( B->val[k] );
+                    }
+                }
+            }
+            for( int t=0; t < 3; t++ ) {
+                mdiff_kahan_add( row[t], &sum[t], &c[t] );
+            }
+        }
+        for( int t=0; t < 3; t++ ) {
+            partial[ 3*ib + t ] = sum[t];
+        }
+    }
+
+    for( int t=0; t < 3; t++ ) {
+        sums[t] = mdiff_pairwise_sum( nblocks, partial + t, 3 );
+    }
+
+cleanup:
+    magma_free_cpu( partial );
+    return info;
+}
+
 
 /**
     Purpose
@@ -20,8 +239,10 @@
     Computes the Frobenius norm of the difference between the CSR matrices A
     and B. They do not need to share the same sparsity pattern!
         
-            res = ||A-B||_F = sqrt( sum_ij (A_ij-B_ij)^2 )
+            res = ||A-B||_F = sqrt( sum_ij |A_ij-B_ij|^2 )
 
+    Uses magma_zmdiff_merge, so takes O(nnz) time for rows with sorted
+    column indices.
 
     Arguments
     ---------
@@ -54,30 +275,15 @@ magma_zmdiff(
     
     if ( A.memory_location == Magma_CPU && B.memory_location == Magma_CPU
             && A.storage_type == Magma_CSR && B.storage_type == Magma_CSR ){
-        real_Double_t tmp2;
-        magma_int_t i,j,k;
-        *res = 0.0;
-        
-        for(i=0; i<A.num_rows; i++) {
-            for(j=A.row[i]; j<A.row[i+1]; j++) {
-                magma_index_t localcol = A.col[j];
-                for( k=B.row[i]; k<B.row[i+1]; k++) {
-                    if (B.col[k] == localcol) {
-                        tmp2 = (real_Double_t) fabs( MAGMA_Z_REAL(A.val[j] )
-                                                        - MAGMA_Z_REAL(B.val[k]) );
-    
-                        (*res) = (*res) + tmp2* tmp2;
-                    }
-                }
-            }
-        }
-
-        (*res) =  sqrt((*res));
+        real_Double_t sums[3];
+        CHECK( magma_zmdiff_merge( A, &B, MagmaFalse, sums, queue ));
+        *res = sqrt( sums[0] + sums[1] + sums[2] );
     }
     else {
         printf("error: mdiff only supported for CSR matrices on the CPU: %d %d %d %d.\n", 
                 int(A.memory_location), int(B.memory_location), int(A.storage_type), int(B.storage_type));
         info = MAGMA_ERR_NOT_SUPPORTED;
     }
+cleanup:
     return info;
 }
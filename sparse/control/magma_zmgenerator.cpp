@@ -8,14 +8,465 @@
        @precisions normal z -> s d c
        @author Hartwig Anzt
 */
+#include <limits>
 #include "magmasparse_internal.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define COMPLEX
+
+/*
+    The generators write CSR (or SELL-P) rows directly, in parallel over
+    rows: first each row's length is computed, which gives the row
+    pointer by a prefix sum, then each row is filled independently.
+*/
+
+
+/******************************************************************************/
+// Returns whether the total entry count fits in magma_index_t.
+static inline bool
+mgenerator_fits( real_Double_t nnz )
+{
+    return nnz <= real_Double_t( (std::numeric_limits< magma_index_t >::max)() );
+}
+
+
+/******************************************************************************/
+// Returns the calling thread's number in a parallel region.
+static inline magma_int_t
+mgenerator_thread_num()
+{
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+
+/******************************************************************************/
+// Returns the number of threads used by parallel regions.
+static inline magma_int_t
+mgenerator_num_threads()
+{
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+
+/******************************************************************************/
+// Stencil on an nx x ny x nz grid, with points sorted by their offset in
+// the node numbering, node = ix + iy*nx + iz*nx*ny, so each row's columns
+// are increasing. Constant blocks store only their nonzeros; blocks from
+// a callback are stored dense.
+struct magma_zstencil_grid {
+    magma_int_t nx, ny, nz, dof, npoints;
+    const magma_int_t *offsets;         // dx, dy, dz of each point
+    const magmaDoubleComplex *weights;  // constant blocks, or NULL
+    magma_index_t *order;               // points sorted by node offset
+    magma_index_t *count;               // entries in row a of block p, at p*dof + a
+
+    // returns whether entry (a, b) of constant block p is stored
+    bool stored( magma_int_t p, magma_int_t a, magma_int_t b ) const
+    {
+        if ( weights == NULL ) {
+            return true;
+        }
+        magmaDoubleComplex w = weights[ p*dof*dof + a + b*dof ];
+        return (MAGMA_Z_REAL( w ) != 0 || MAGMA_Z_IMAG( w ) != 0);
+    }
+
+    // returns whether point p of node (ix, iy, iz) is inside the grid
+    bool inside( magma_int_t ix, magma_int_t iy, magma_int_t iz,
+                 magma_int_t p ) const
+    {
+        magma_int_t jx = ix + offsets[ 3*p ];
+        magma_int_t jy = iy + offsets[ 3*p+1 ];
+        magma_int_t jz = iz + offsets[ 3*p+2 ];
+        return (0 <= jx && jx < nx && 0 <= jy && jy < ny && 0 <= jz && jz < nz);
+    }
+
+    // returns the node offset of point p
+    magma_int_t shift( magma_int_t p ) const
+    {
+        return offsets[ 3*p ] + nx*(offsets[ 3*p+1 ] + ny*offsets[ 3*p+2 ]);
+    }
+
+    // returns the number of entries in row a of the node
+    magma_int_t row_nnz( magma_int_t node, magma_int_t a ) const
+    {
+        magma_int_t ix = node % nx;
+        magma_int_t iy = (node / nx) % ny;
+        magma_int_t iz = node / (nx*ny);
+        magma_int_t len = 0;
+        for( magma_int_t p=0; p < npoints; p++ ) {
+            if ( inside( ix, iy, iz, p )) {
+                len += count[ p*dof + a ];
+            }
+        }
+        return len;
+    }
+};
+
+
+/******************************************************************************/
+// Fills the rows of all nodes. Entry k of row r is at pos( r, k ).
+// For SELL-P, padding up to the slice's aligned row length is zero.
+template< bool sellp >
+static void
+stencil_fill(
+    const magma_zstencil_grid& g,
+    const magmaDoubleComplex *weights,
+    magma_zstencil_coef_t coef, void *coef_data,
+    magmaDoubleComplex *work,
+    magma_z_matrix *A )
+{
+    const magma_int_t dof = g.dof;
+    const magma_int_t dof2 = dof*dof;
+    const magma_int_t num_nodes = g.nx * g.ny * g.nz;
+    const magma_int_t C = (sellp ? A->blocksize : 1);
+
+    #pragma omp parallel
+    {
+        magmaDoubleComplex *blocks = work + mgenerator_thread_num() * dof2 * g.npoints;
+
+        #pragma omp for schedule(static)
+        for( magma_int_t node=0; node < num_nodes; node++ ) {
+            magma_int_t ix = node % g.nx;
+            magma_int_t iy = (node / g.nx) % g.ny;
+            magma_int_t iz = node / (g.nx*g.ny);
+
+            // blocks of this node's points
+            const magmaDoubleComplex *w = weights;
+            if ( coef != NULL ) {
+                for( magma_int_t p=0; p < g.npoints; p++ ) {
+                    if ( g.inside( ix, iy, iz, p )) {
+                        coef( ix, iy, iz, p, &blocks[ p*dof2 ], coef_data );
+                    }
+                }
+                w = blocks;
+            }
+
+            for( magma_int_t a=0; a < dof; a++ ) {
+                magma_int_t r = node*dof + a;
+                magma_int_t start, stride;
+                if ( sellp ) {
+                    start  = A->row[ r / C ] + r % C;
+                    stride = C;
+                }
+                else {
+                    start  = A->row[ r ];
+                    stride = 1;
+                }
+                magma_int_t k = 0;
+                for( magma_int_t q=0; q < g.npoints; q++ ) {
+                    magma_int_t p = g.order[q];
+                    if ( ! g.inside( ix, iy, iz, p )) {
+                        continue;
+                    }
+                    magma_int_t col = (node + g.shift( p )) * dof;
+                    for( magma_int_t b=0; b < dof; b++ ) {
+                        if ( ! g.stored( p, a, b )) {
+                            continue;
+                        }
+                        A->col[ start + k*stride ] = col + b;
+                        A->val[ start + k*stride ] = w[ p*dof2 + a + b*dof ];
+                        k++;
+                    }
+                }
+                if ( sellp ) {
+                    magma_int_t slice = r / C;
+                    magma_int_t len = (A->row[ slice+1 ] - A->row[ slice ]) / C;
+                    for( ; k < len; k++ ) {
+                        A->col[ start + k*stride ] = 0;
+                        A->val[ start + k*stride ] = MAGMA_Z_ZERO;
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+/**
+    Purpose
+    -------
+
+    Generates the matrix of a stencil on a structured nx x ny x nz grid,
+    writing CSR (or SELL-P) rows directly, in parallel.
+    Nodes are numbered node = ix + iy*nx + iz*nx*ny, and each node has dof
+    unknowns, so row node*dof + a is unknown a of the node. Each stencil
+    point p couples the node to its neighbor at offset
+    (dx, dy, dz) = offsets[ 3*p : 3*p+2 ] with a dof x dof block, so the
+    matrix has dof x dof block structure. Points outside the grid are
+    dropped (Dirichlet boundary). Columns of each row are increasing.
+
+    The blocks are either constant, given in weights, or variable, computed
+    by the callback coef for each node and point; e.g., for variable
+    coefficients or anisotropy that varies in space.
+
+    Arguments
+    ---------
+
+    @param[in]
+    nx          magma_int_t
+                grid points in x; nx >= 1
+
+    @param[in]
+    ny          magma_int_t
+                grid points in y; ny >= 1
+
+    @param[in]
+    nz          magma_int_t
+                grid points in z; nz >= 1, e.g., nz = 1 for 2D
+
+    @param[in]
+    dof         magma_int_t
+                unknowns per node; dof >= 1. The number of rows,
+                nx*ny*nz*dof, has to fit in magma_index_t, else
+                MAGMA_ERR_NOT_SUPPORTED is returned.
+
+    @param[in]
+    npoints     magma_int_t
+                number of stencil points
+
+    @param[in]
+    offsets     magma_int_t array, dimension (3*npoints)
+                offsets dx, dy, dz of each point; must be distinct
+
+    @param[in]
+    weights     magmaDoubleComplex array, dimension (dof*dof*npoints)
+                If coef is NULL, the dof x dof block of point p, column-major:
+                entry (a, b) couples unknown a of a node to unknown b of its
+                neighbor, in weights[ p*dof*dof + a + b*dof ].
+                Zero entries are not stored.
+                Not referenced if coef is not NULL.
+
+    @param[in]
+    coef        magma_zstencil_coef_t
+                If not NULL, called as coef( ix, iy, iz, p, block, coef_data )
+                for each node (ix, iy, iz) and each point p inside the grid,
+                to set the dof x dof block of point p for this node, stored
+                as in weights. All block entries are stored, so the pattern
+                does not depend on the values.
+                Called in parallel from OpenMP threads.
+
+    @param[in]
+    coef_data   void*
+                data passed to coef
+
+    @param[in]
+    storage     magma_storage_t
+                Magma_CSR or Magma_SELLP. For Magma_SELLP, A->blocksize
+                and A->alignment must be set on entry, as for magma_zmconvert.
+
+    @param[out]
+    A           magma_z_matrix*
+                generated matrix, on the CPU
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C"
+magma_int_t
+magma_zmstencil(
+    magma_int_t nx,
+    magma_int_t ny,
+    magma_int_t nz,
+    magma_int_t dof,
+    magma_int_t npoints,
+    const magma_int_t *offsets,
+    const magmaDoubleComplex *weights,
+    magma_zstencil_coef_t coef,
+    void *coef_data,
+    magma_storage_t storage,
+    magma_z_matrix *A,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_index_t *order = NULL, *count = NULL;
+    magmaDoubleComplex *work = NULL;
+    magma_int_t num_nodes, num_rows, blocksize = 1, alignment = 1;
+    magma_int_t num_slices = 0, max_len = 0;
+    real_Double_t true_nnz = 0, stored_nnz = 0;
+    magma_zstencil_grid g;
+
+    // A is output only, as for magma_zmconvert
+    A->val = NULL;
+    A->col = NULL;
+    A->row = NULL;
+    A->storage_type = storage;
+    A->memory_location = Magma_CPU;
+
+    if ( nx < 1 || ny < 1 || nz < 1 || dof < 1 || npoints < 1
+         || (coef == NULL && weights == NULL) ) {
+        info = MAGMA_ERR_ILLEGAL_VALUE;
+        goto cleanup;
+    }
+    if ( storage == Magma_SELLP ) {
+        blocksize = A->blocksize;
+        alignment = A->alignment;
+        if ( blocksize < 1 || 256 % blocksize != 0 || alignment < 1 ) {
+            printf("error: blocksize not supported!\n");
+            info = MAGMA_ERR_NOT_SUPPORTED;
+            goto cleanup;
+        }
+    }
+    else if ( storage != Magma_CSR ) {
+        printf("error: format not supported.\n");
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+    // the nx*ny*nz*dof rows are numbered in magma_index_t; the product is
+    // formed in int64_t and checked factor by factor, so it cannot overflow
+    {
+        const int64_t index_max = (std::numeric_limits< magma_index_t >::max)();
+        const magma_int_t dims[4] = { nx, ny, nz, dof };
+        int64_t rows = 1;
+        for( int d=0; d < 4; d++ ) {
+            if ( rows > index_max / dims[d] ) {
+                info = MAGMA_ERR_NOT_SUPPORTED;
+                goto cleanup;
+            }
+            rows *= dims[d];
+        }
+    }
+
+    A->ownership = MagmaTrue;
+    A->fill_mode = MagmaFull;
+    num_nodes = nx*ny*nz;
+    num_rows = num_nodes*dof;
+    A->num_rows = num_rows;
+    A->num_cols = num_rows;
+
+    // sort points by node offset, so columns in each row are increasing
+    CHECK( magma_index_malloc_cpu( &order, npoints ));
+    g.nx = nx;  g.ny = ny;  g.nz = nz;
+    g.dof = dof;
+    g.npoints = npoints;
+    g.offsets = offsets;
+    g.weights = (coef == NULL ? weights : NULL);
+    g.order = order;
+    for( magma_int_t p=0; p < npoints; p++ ) {
+        magma_int_t q = p;
+        while ( q > 0 && g.shift( order[q-1] ) > g.shift( p )) {
+            order[q] = order[q-1];
+            q--;
+        }
+        order[q] = p;
+    }
+    // points with equal node offsets (e.g., dx = 1 and dy = 1 for nx = 1)
+    // are never both inside the grid, but points must be distinct
+    for( magma_int_t p=0; p < npoints; p++ ) {
+        for( magma_int_t q=0; q < p; q++ ) {
+            if (    offsets[ 3*p   ] == offsets[ 3*q   ]
+                 && offsets[ 3*p+1 ] == offsets[ 3*q+1 ]
+                 && offsets[ 3*p+2 ] == offsets[ 3*q+2 ] ) {
+                info = MAGMA_ERR_ILLEGAL_VALUE;
+                goto cleanup;
+            }
+        }
+    }
+
+    CHECK( magma_index_malloc_cpu( &count, npoints*dof ));
+    g.count = count;
+    for( magma_int_t p=0; p < npoints; p++ ) {
+        for( magma_int_t a=0; a < dof; a++ ) {
+            count[ p*dof + a ] = 0;
+            for( magma_int_t b=0; b < dof; b++ ) {
+                count[ p*dof + a ] += g.stored( p, a, b );
+            }
+        }
+    }
+
+    if ( storage == Magma_CSR ) {
+        CHECK( magma_index_malloc_cpu( &A->row, num_rows+1 ));
+        #pragma omp parallel for schedule(static) reduction(+:true_nnz) reduction(max:max_len)
+        for( magma_int_t r=0; r < num_rows; r++ ) {
+            magma_int_t len = g.row_nnz( r / dof, r % dof );
+            A->row[ r+1 ] = len;
+            true_nnz += len;
+            max_len = max( max_len, len );
+        }
+        stored_nnz = true_nnz;
+        if ( ! mgenerator_fits( stored_nnz )) {
+            info = MAGMA_ERR_NOT_SUPPORTED;
+            goto cleanup;
+        }
+        A->row[0] = 0;
+        CHECK( magma_zmatrix_createrowptr( num_rows, A->row, queue ));
+    }
+    else {
+        // slice s has rows s*blocksize, ..., of the slice's aligned max length
+        num_slices = magma_ceildiv( num_rows, blocksize );
+        CHECK( magma_index_malloc_cpu( &A->row, num_slices+1 ));
+        #pragma omp parallel for schedule(static) reduction(+:true_nnz,stored_nnz) reduction(max:max_len)
+        for( magma_int_t s=0; s < num_slices; s++ ) {
+            magma_int_t slice_len = 0;
+            magma_int_t rend = min( (s+1)*blocksize, num_rows );
+            for( magma_int_t r=s*blocksize; r < rend; r++ ) {
+                magma_int_t len = g.row_nnz( r / dof, r % dof );
+                true_nnz += len;
+                slice_len = max( slice_len, len );
+            }
+            slice_len = magma_roundup( slice_len, alignment );
+            A->row[ s+1 ] = slice_len * blocksize;
+            stored_nnz += slice_len * blocksize;
+            max_len = max( max_len, slice_len );
+        }
+        if ( ! mgenerator_fits( stored_nnz )) {
+            info = MAGMA_ERR_NOT_SUPPORTED;
+            goto cleanup;
+        }
+        A->row[0] = 0;
+        CHECK( magma_zmatrix_createrowptr( num_slices, A->row, queue ));
+        A->numblocks = num_slices;
+        A->blocksize = blocksize;
+        A->alignment = alignment;
+    }
+    A->nnz = magma_int_t( stored_nnz );
+    A->true_nnz = magma_int_t( true_nnz );
+    A->max_nnz_row = max_len;
+
+    CHECK( magma_index_malloc_cpu( &A->col, A->nnz ));
+    CHECK( magma_zmalloc_cpu( &A->val, A->nnz ));
+    if ( coef != NULL ) {
+        CHECK( magma_zmalloc_cpu( &work, mgenerator_num_threads() * dof*dof*npoints ));
+    }
+
+    if ( storage == Magma_CSR )
+        stencil_fill< false >( g, weights, coef, coef_data, work, A );
+    else
+        stencil_fill< true  >( g, weights, coef, coef_data, work, A );
+
+cleanup:
+    if ( info != 0 ) {
+        magma_zmfree( A, queue );
+    }
+    magma_free_cpu( order );
+    magma_free_cpu( count );
+    magma_free_cpu( work );
+    return info;
+}
+
 
 /**
     Purpose
     -------
 
     Generate a symmetric n x n CSR matrix for a stencil.
+    Entries outside the matrix and entries with value zero are dropped.
+    Rows are written directly, in parallel.
 
     Arguments
     ---------
@@ -30,7 +481,7 @@
 
     @param[in]
     diag_offset magma_int_t*
-                array containing the offsets
+                array containing the offsets, increasing
 
                                                 (length offsets+1)
     @param[in]
@@ -59,94 +510,116 @@ magma_zmgenerator(
     magma_queue_t queue )
 {
     magma_int_t info = 0;
-    
-    magma_z_matrix B={Magma_CSR};
-    
-    B.val = NULL;
-    B.col = NULL;
-    B.row = NULL;
-    B.rowidx = NULL;
-    B.blockinfo = NULL;
-    B.diag = NULL;
-    B.dval = NULL;
-    B.dcol = NULL;
-    B.drow = NULL;
-    B.drowidx = NULL;
-    B.ddiag = NULL;
-    B.list = NULL;
-    B.dlist = NULL;
-    
-    B.num_rows = n;
-    B.num_cols = n;
-    B.fill_mode = MagmaFull;
-    B.memory_location = Magma_CPU;
-    B.storage_type = Magma_ELLPACKT;
-    B.max_nnz_row = (2*offdiags+1);
-
-    CHECK( magma_zmalloc_cpu( &B.val, B.max_nnz_row*n ));
-    CHECK( magma_index_malloc_cpu( &B.col, B.max_nnz_row*n ));
-    
-    for( int i=0; i<n; i++ ) { // stride over rows
-        // stride over the number of nonzeros in each row
-        // left of diagonal
-        for( int j=0; j<offdiags; j++ ) {
-            B.val[ i*B.max_nnz_row + j ] = diag_vals[ offdiags - j ];
-            B.col[ i*B.max_nnz_row + j ] = -1 * diag_offset[ offdiags-j ] + i;
-        }
-        // elements on the diagonal
-        B.val[ i*B.max_nnz_row + offdiags ] = diag_vals[ 0 ];
-        B.col[ i*B.max_nnz_row + offdiags ] = i;
-        // right of diagonal
-        for( int j=0; j<offdiags; j++ ) {
-            B.val[ i*B.max_nnz_row + j + offdiags +1 ] = diag_vals[ j+1 ];
-            B.col[ i*B.max_nnz_row + j + offdiags +1 ] = diag_offset[ j+1 ] + i;
+
+    real_Double_t nnz = 0;
+    magma_int_t max_len = 0;
+
+    // entry d of a row, d = -offdiags, ..., offdiags, is at column
+    // i + sign(d) diag_offset[|d|] with value diag_vals[|d|]
+    #define d_offset( d_ ) ((d_) < 0 ? -diag_offset[ -(d_) ] : diag_offset[ (d_) ])
+    #define d_val( d_ )    diag_vals[ (d_) < 0 ? -(d_) : (d_) ]
+    #define d_valid( i_, d_ ) \
+        (   (i_) + d_offset( d_ ) >= 0 && (i_) + d_offset( d_ ) < n \
+         && (MAGMA_Z_REAL( d_val( d_ )) != 0 || MAGMA_Z_IMAG( d_val( d_ )) != 0) )
+
+    A->val = NULL;
+    A->col = NULL;
+    A->row = NULL;
+    A->ownership = MagmaTrue;
+    A->storage_type = Magma_CSR;
+    A->memory_location = Magma_CPU;
+    A->fill_mode = MagmaFull;
+    A->num_rows = n;
+    A->num_cols = n;
+
+    CHECK( magma_index_malloc_cpu( &A->row, n+1 ));
+    #pragma omp parallel for schedule(static) reduction(+:nnz) reduction(max:max_len)
+    for( magma_int_t i=0; i < n; i++ ) {
+        magma_int_t len = 0;
+        for( magma_int_t d=-offdiags; d <= offdiags; d++ ) {
+            len += d_valid( i, d );
         }
+        A->row[ i+1 ] = len;
+        nnz += len;
+        max_len = max( max_len, len );
     }
-
-    // set invalid entries to zero
-    for( int i=0; i<n; i++ ) { // stride over rows
-        for( int j=0; j<B.max_nnz_row; j++ ) { // nonzeros in every row
-            if ( (B.col[i*B.max_nnz_row + j] < 0) ||
-                    (B.col[i*B.max_nnz_row + j] >= n) ) {
-                B.val[ i*B.max_nnz_row + j ] = MAGMA_Z_MAKE( 0.0, 0.0 );
+    if ( ! mgenerator_fits( nnz )) {
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+    A->row[0] = 0;
+    CHECK( magma_zmatrix_createrowptr( n, A->row, queue ));
+    A->nnz = A->row[ n ];
+    A->true_nnz = A->nnz;
+    A->max_nnz_row = max_len;
+
+    CHECK( magma_index_malloc_cpu( &A->col, A->nnz ));
+    CHECK( magma_zmalloc_cpu( &A->val, A->nnz ));
+
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i < n; i++ ) {
+        magma_index_t k = A->row[i];
+        for( magma_int_t d=-offdiags; d <= offdiags; d++ ) {
+            if ( d_valid( i, d )) {
+                A->col[k] = i + d_offset( d );
+                A->val[k] = d_val( d );
+                k++;
             }
         }
     }
 
-    B.nnz = 0;
-
-    for( int i=0; i<n; i++ ) { // stride over rows
-        for( int j=0; j<B.max_nnz_row; j++ ) { // nonzeros in every row
-            if ( MAGMA_Z_REAL( B.val[i*B.max_nnz_row + j]) != 0.0 )
-                B.nnz++;
-        }
-    }
-    B.true_nnz = B.nnz;
-    // converting it to CSR will remove the invalit entries completely
-    CHECK( magma_zmconvert( B, A, Magma_ELLPACKT, Magma_CSR, queue ));
+    #undef d_offset
+    #undef d_val
+    #undef d_valid
 
 cleanup:
     if( info != 0 ){
-        magma_zmfree( &B, queue );
+        magma_zmfree( A, queue );
     }
     return info;
 }
 
 
+/******************************************************************************/
+// Sets offsets of all points (dx, dy, dz) with |dx|, |dy|, |dz| <= 1 and
+// |dx| + |dy| + |dz| <= maxdist, in x, y, z ranges of the given dimension,
+// diagonal first. Returns the number of points.
+static magma_int_t
+stencil_points( magma_int_t dim, magma_int_t maxdist, magma_int_t *offsets )
+{
+    magma_int_t np = 0;
+    magma_int_t zr = (dim == 3 ? 1 : 0);
+    for( magma_int_t dist=0; dist <= maxdist; dist++ ) {
+        for( magma_int_t dz=-zr; dz <= zr; dz++ ) {
+            for( magma_int_t dy=-1; dy <= 1; dy++ ) {
+                for( magma_int_t dx=-1; dx <= 1; dx++ ) {
+                    if ( abs(dx) + abs(dy) + abs(dz) == dist ) {
+                        offsets[ 3*np   ] = dx;
+                        offsets[ 3*np+1 ] = dy;
+                        offsets[ 3*np+2 ] = dz;
+                        np++;
+                    }
+                }
+            }
+        }
+    }
+    return np;
+}
 
 
 /**
     Purpose
     -------
 
-    Generate a 27-point stencil for a 3D FD discretization.
+    Generate a 27-point stencil for a 3D FD discretization on an
+    n x n x n grid: 26 on the diagonal, -1 for each neighbor.
 
     Arguments
     ---------
 
     @param[in]
     n           magma_int_t
-                number of rows
+                number of grid points in each dimension
 
     @param[out]
     A           magma_z_matrix*
@@ -165,110 +638,75 @@ magma_zm_27stencil(
     magma_z_matrix *A,
     magma_queue_t queue )
 {
-    magma_int_t info = 0;
-    
-    magma_int_t i,j,k;
-    magma_z_matrix hA={Magma_CSR};
-
-    
-    // generate matrix of desired structure and size (3d 27-point stencil)
-    magma_int_t nn = n*n*n;
-    magma_int_t offdiags = 13;
-    magma_index_t *diag_offset=NULL;
-    magmaDoubleComplex *diag_vals=NULL;
-    CHECK( magma_zmalloc_cpu( &diag_vals, offdiags+1 ));
-    CHECK( magma_index_malloc_cpu( &diag_offset, offdiags+1 ));
-
-    diag_offset[0] = 0;
-    diag_offset[1] = 1;
-    diag_offset[2] = n-1;
-    diag_offset[3] = n;
-    diag_offset[4] = n+1;
-    diag_offset[5] = n*n-n-1;
-    diag_offset[6] = n*n-n;
-    diag_offset[7] = n*n-n+1;
-    diag_offset[8] = n*n-1;
-    diag_offset[9] = n*n;
-    diag_offset[10] = n*n+1;
-    diag_offset[11] = n*n+n-1;
-    diag_offset[12] = n*n+n;
-    diag_offset[13] = n*n+n+1;
-
-    diag_vals[0] = MAGMA_Z_MAKE( 26.0, 0.0 );
-    diag_vals[1] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[2] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[3] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[4] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[5] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[6] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[7] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[8] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[9] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[10] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[11] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[12] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[13] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    CHECK( magma_zmgenerator( nn, offdiags, diag_offset, diag_vals, &hA, queue ));
-
-    // now set some entries to zero (boundary...)
-    for( i=0; i < n*n; i++ ) {
-        for( j=0; j < n; j++ ) {
-            magma_index_t row = i*n+j;
-            for( k=hA.row[row]; k<hA.row[row+1]; k++) {
-                if ((hA.col[k] == row-1 ||
-                    hA.col[k] == row-n-1 ||
-                    hA.col[k] == row+n-1 ||
-                    hA.col[k] == row-n*n+n-1 ||
-                    hA.col[k] == row+n*n-n-1 ||
-                    hA.col[k] == row-n*n-1 ||
-                    hA.col[k] == row+n*n-1 ||
-                    hA.col[k] == row-n*n-n-1 ||
-                    hA.col[k] == row+n*n+n-1 ) && (row+1)%n == 1 )
-                        
-                        hA.val[k] = MAGMA_Z_MAKE( 0.0, 0.0 );
-    
-                if ((hA.col[k] == row+1 ||
-                    hA.col[k] == row-n+1 ||
-                    hA.col[k] == row+n+1 ||
-                    hA.col[k] == row-n*n+n+1 ||
-                    hA.col[k] == row+n*n-n+1 ||
-                    hA.col[k] == row-n*n+1 ||
-                    hA.col[k] == row+n*n+1 ||
-                    hA.col[k] == row-n*n-n+1 ||
-                    hA.col[k] == row+n*n+n+1 ) && (row)%n ==n-1 )
-                        
-                        hA.val[k] = MAGMA_Z_MAKE( 0.0, 0.0 );
-            }
-        }
-    }
-    hA.true_nnz = hA.nnz;
-    if (A->ownership) {
-        magma_zmfree( A, queue );
-    }
-    A->ownership = MagmaTrue;
-    CHECK( magma_zmconvert( hA, A, Magma_CSR, Magma_CSR, queue ));
+    magma_int_t offsets[ 3*27 ];
+    magmaDoubleComplex weights[ 27 ];
 
-cleanup:
-    magma_free_cpu( diag_vals );
-    magma_free_cpu( diag_offset );
-    magma_zmfree( &hA, queue );
-    return info;
+    magma_int_t np = stencil_points( 3, 3, offsets );
+    weights[0] = MAGMA_Z_MAKE( 26.0, 0.0 );
+    for( magma_int_t p=1; p < np; p++ ) {
+        weights[p] = MAGMA_Z_MAKE( -1.0, 0.0 );
+    }
+    return magma_zmstencil( n, n, n, 1, np, offsets, weights, NULL, NULL,
+                            Magma_CSR, A, queue );
 }
 
 
+/**
+    Purpose
+    -------
+
+    Generate a 7-point stencil for a 3D FD discretization on an
+    n x n x n grid: 6 on the diagonal, -1 for each neighbor.
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                number of grid points in each dimension
+
+    @param[out]
+    A           magma_z_matrix*
+                matrix to generate
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C"
+magma_int_t
+magma_zm_7stencil(
+    magma_int_t n,
+    magma_z_matrix *A,
+    magma_queue_t queue )
+{
+    magma_int_t offsets[ 3*7 ];
+    magmaDoubleComplex weights[ 7 ];
+
+    magma_int_t np = stencil_points( 3, 1, offsets );
+    weights[0] = MAGMA_Z_MAKE( 6.0, 0.0 );
+    for( magma_int_t p=1; p < np; p++ ) {
+        weights[p] = MAGMA_Z_MAKE( -1.0, 0.0 );
+    }
+    return magma_zmstencil( n, n, n, 1, np, offsets, weights, NULL, NULL,
+                            Magma_CSR, A, queue );
+}
+
 
 /**
     Purpose
     -------
 
-    Generate a 5-point stencil for a 2D FD discretization.
+    Generate a 5-point stencil for a 2D FD discretization on an n x n grid.
 
     Arguments
     ---------
 
     @param[in]
     n           magma_int_t
-                number of rows
+                number of grid points in each dimension
 
     @param[out]
     A           magma_z_matrix*
@@ -287,62 +725,125 @@ magma_zm_5stencil(
     magma_z_matrix *A,
     magma_queue_t queue )
 {
-    magma_int_t info = 0;
-    
-    magma_int_t i,j,k;
-    magma_z_matrix hA={Magma_CSR};
-    
-    // generate matrix of desired structure and size (2d 5-point stencil)
-    magma_int_t nn = n*n;
-    magma_int_t offdiags = 2;
-    magma_index_t *diag_offset=NULL;
-    magmaDoubleComplex *diag_vals=NULL;
-    CHECK( magma_zmalloc_cpu( &diag_vals, offdiags+1 ));
-    CHECK( magma_index_malloc_cpu( &diag_offset, offdiags+1 ));
-    
-    magma_zmfree( A, queue );
-    A->ownership = MagmaTrue;
-    diag_offset[0] = 0;
-    diag_offset[1] = 1;
-    diag_offset[2] = n;
-    
-    #define COMPLEX
-    
+    magma_int_t offsets[ 3*5 ];
+    magmaDoubleComplex weights[ 5 ];
+
+    magma_int_t np = stencil_points( 2, 1, offsets );
     #ifdef COMPLEX
         // complex case
-        diag_vals[0] = MAGMA_Z_MAKE( 4.0, 4.0 );
-        diag_vals[1] = MAGMA_Z_MAKE( -1.0, -1.0 );
-        diag_vals[2] = MAGMA_Z_MAKE( -1.0, -1.0 );
-        
+        weights[0] = MAGMA_Z_MAKE( 4.0, 4.0 );
+        for( magma_int_t p=1; p < np; p++ ) {
+            weights[p] = MAGMA_Z_MAKE( -1.0, -1.0 );
+        }
     #else
         // real case
-        diag_vals[0] = MAGMA_Z_MAKE( 4.0, 0.0 );
-        diag_vals[1] = MAGMA_Z_MAKE( -1.0, 0.0 );
-        diag_vals[2] = MAGMA_Z_MAKE( -1.0, 0.0 );
+        weights[0] = MAGMA_Z_MAKE( 4.0, 0.0 );
+        for( magma_int_t p=1; p < np; p++ ) {
+            weights[p] = MAGMA_Z_MAKE( -1.0, 0.0 );
+        }
     #endif
-    CHECK( magma_zmgenerator( nn, offdiags, diag_offset, diag_vals, &hA, queue ));
-
-    // now set some entries to zero (boundary...)
-    for( i=0; i<n; i++ ) {
-        for( j=0; j<n; j++ ) {
-            magma_index_t row = i*n+j;
-            for( k=hA.row[row]; k<hA.row[row+1]; k++) {
-                if ((hA.col[k] == row-1 ) && (row+1)%n == 1 )
-                    hA.val[k] = MAGMA_Z_MAKE( 0.0, 0.0 );
-    
-                if ((hA.col[k] == row+1 ) && (row)%n ==n-1 )
-                    hA.val[k] = MAGMA_Z_MAKE( 0.0, 0.0 );
+    return magma_zmstencil( n, n, 1, 1, np, offsets, weights, NULL, NULL,
+                            Magma_CSR, A, queue );
+}
+
+
+/**
+    Purpose
+    -------
+
+    Generate an anisotropic 5-point (2D, nz = 1) or 7-point (3D) stencil
+    for -(cx u_xx + cy u_yy + cz u_zz) on an nx x ny x nz grid, with dof
+    uncoupled unknowns per node, so dof x dof diagonal blocks:
+    2 (cx + cy + cz) on the diagonal, -cx, -cy, -cz for the neighbors in
+    x, y, z.
+
+    Arguments
+    ---------
+
+    @param[in]
+    nx          magma_int_t
+                grid points in x
+
+    @param[in]
+    ny          magma_int_t
+                grid points in y
+
+    @param[in]
+    nz          magma_int_t
+                grid points in z; nz = 1 for 2D
+
+    @param[in]
+    cx          double
+                coefficient in x
+
+    @param[in]
+    cy          double
+                coefficient in y
+
+    @param[in]
+    cz          double
+                coefficient in z; not used for 2D
+
+    @param[in]
+    dof         magma_int_t
+                unknowns per node
+
+    @param[out]
+    A           magma_z_matrix*
+                matrix to generate
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C"
+magma_int_t
+magma_zm_anisotropic_stencil(
+    magma_int_t nx,
+    magma_int_t ny,
+    magma_int_t nz,
+    double cx,
+    double cy,
+    double cz,
+    magma_int_t dof,
+    magma_z_matrix *A,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_int_t offsets[ 3*7 ];
+    magmaDoubleComplex *weights = NULL;
+    magma_int_t dof2 = dof*dof;
+
+    if ( dof < 1 ) {
+        info = MAGMA_ERR_ILLEGAL_VALUE;
+        goto cleanup;
+    }
+
+    {
+        magma_int_t dim = (nz > 1 ? 3 : 2);
+        magma_int_t np = stencil_points( dim, 1, offsets );
+        double diag = 2*(cx + cy) + (dim == 3 ? 2*cz : 0);
+
+        CHECK( magma_zmalloc_cpu( &weights, dof2*np ));
+        for( magma_int_t p=0; p < np; p++ ) {
+            double c = (offsets[ 3*p ]   != 0 ? -cx :
+                        offsets[ 3*p+1 ] != 0 ? -cy :
+                        offsets[ 3*p+2 ] != 0 ? -cz : diag);
+            for( magma_int_t k=0; k < dof2; k++ ) {
+                weights[ p*dof2 + k ] = MAGMA_Z_ZERO;
+            }
+            for( magma_int_t a=0; a < dof; a++ ) {
+                weights[ p*dof2 + a + a*dof ] = MAGMA_Z_MAKE( c, 0.0 );
             }
         }
+        CHECK( magma_zmstencil( nx, ny, nz, dof, np, offsets, weights,
+                                NULL, NULL, Magma_CSR, A, queue ));
     }
 
-    CHECK( magma_zmconvert( hA, A, Magma_CSR, Magma_CSR, queue ));
-    magma_zmcsrcompressor( A, queue );
-    A->true_nnz = A->nnz;
-    
 cleanup:
-    magma_free_cpu( diag_vals );
-    magma_free_cpu( diag_offset );
-    magma_zmfree( &hA, queue );
+    magma_free_cpu( weights );
     return info;
 }
@@ -0,0 +1,433 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include <mutex>   // requires C++11
+#include <atomic>
+
+#include "magmasparse_internal.h"
+
+// padding (explicit zeros relative to nnz) tolerated by the ELL and SELL-P
+// recommendation of magma_zmrecommend_format
+#define PADDING_ELL   0.25
+#define PADDING_SELLP 0.25
+
+// number of matrices whose profile is cached
+#define PROFILE_CACHE 8
+
+
+/******************************************************************************/
+// Cache of profiles. A profiled matrix gets a new, never reused id in
+// A->profile_id, which shares storage with the CSR5 calibrator, so CSR5
+// matrices are not cached. magma_zmprofile_forget clears the id and drops
+// the entry; magma_zmfree and the in-place modifiers call it. The format,
+// sizes and arrays are kept as a check against copies of A whose arrays
+// were replaced. Entries are replaced round-robin.
+typedef struct
+{
+    size_t                id;             // 0 if unused
+    magma_storage_t       storage_type;
+    magma_location_t      memory_location;
+    magma_int_t           num_rows;
+    magma_int_t           num_cols;
+    magma_int_t           nnz;
+    const void            *val;
+    const void            *row;
+    const void            *col;
+    magma_matrix_profile  profile;
+} zmprofile_entry;
+
+static zmprofile_entry    zmprofile_cache[PROFILE_CACHE];
+static magma_int_t        zmprofile_next = 0;
+static size_t             zmprofile_last_id = 0;
+static std::atomic< int > zmprofile_used( 0 );   // entries with id != 0
+static std::mutex         zmprofile_mutex;
+
+
+/******************************************************************************/
+// Does the cache entry hold the profile of A?
+static bool
+zmprofile_match(
+    const zmprofile_entry *e,
+    const magma_z_matrix *A )
+{
+    return e->id != 0
+        && e->id              == A->profile_id
+        && e->storage_type    == A->storage_type
+        && e->memory_location == A->memory_location
+        && e->num_rows        == A->num_rows
+        && e->num_cols        == A->num_cols
+        && e->nnz             == A->nnz
+        && e->val             == (const void*) A->val
+        && e->row             == (const void*) A->row
+        && e->col             == (const void*) A->col;
+}
+
+
+/******************************************************************************/
+// Is (i,j) an entry of the CSR pattern? Columns sorted within rows.
+static inline bool
+zmprofile_find(
+    const magma_index_t *row,
+    const magma_index_t *col,
+    magma_index_t i,
+    magma_index_t j )
+{
+    magma_index_t lo = row[i], hi = row[i+1];
+    while ( lo < hi ) {
+        magma_index_t mid = lo + (hi - lo) / 2;
+        if ( col[mid] < j ) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo < row[i+1] && col[lo] == j;
+}
+
+
+/******************************************************************************/
+// One parallel pass over a CSR matrix on the CPU. Rows are distributed in
+// SELL-P slices so the slice padding is accumulated in the same sweep.
+static void
+zmprofile_csr(
+    magma_z_matrix A,
+    magma_matrix_profile *p )
+{
+    const magma_int_t n = A.num_rows;
+    const magma_int_t nslices = magma_ceildiv( n, MAGMA_PROFILE_SLICE );
+
+    magma_int_t min_row = ( n > 0 ) ? A.row[n] : 0, max_row = 0;
+    magma_int_t empty = 0, bandwidth = 0, missing = 0, dd_rows = 0, dd_count = 0;
+    magma_int_t hist[MAGMA_PROFILE_BINS] = { 0 };
+    real_Double_t sumsq = 0.0, dd_min = 0.0, dd_max = 0.0, dd_sum = 0.0;
+    real_Double_t offdiag_nnz = 0.0, matched = 0.0, sellp = 0.0;
+
+    #pragma omp parallel
+    {
+        magma_int_t lmin = min_row, lmax = 0, lempty = 0, lbw = 0, lmissing = 0;
+        magma_int_t ldd_rows = 0, ldd_count = 0;
+        magma_int_t lhist[MAGMA_PROFILE_BINS] = { 0 };
+        real_Double_t lsumsq = 0.0, ldd_min = 0.0, ldd_max = 0.0, ldd_sum = 0.0;
+        real_Double_t loffdiag = 0.0, lmatched = 0.0, lsellp = 0.0;
+
+        #pragma omp for schedule(static) nowait
+        for( magma_int_t s=0; s < nslices; s++ ) {
+            magma_int_t start = s * MAGMA_PROFILE_SLICE;
+            magma_int_t end = min( start + MAGMA_PROFILE_SLICE, n );
+            magma_int_t slice_max = 0;
+            for( magma_int_t i=start; i < end; i++ ) {
+                real_Double_t diag = 0.0, offdiag = 0.0;
+                for( magma_index_t k=A.row[i]; k < A.row[i+1]; k++ ) {
+                    if ( A.col[k] == i ) {
+                        diag += MAGMA_Z_ABS( A.val[k] );
+                    } else {
+                        offdiag += MAGMA_Z_ABS( A.val[k] );
+                    }
+                }
+                if ( diag == 0.0 ) {
+                    lmissing++;
+                } else {
+                    real_Double_t ratio = offdiag / diag;
+                    ldd_min = ( ldd_count == 0 || ratio < ldd_min ) ? ratio : ldd_min;
+                    ldd_max = ( ldd_count == 0 || ratio > ldd_max ) ? ratio : ldd_max;
+                    ldd_sum += ratio;
+                    ldd_count++;
+                    if ( ratio < 1.0 ) {
+                        ldd_rows++;
+                    }
+                }
+
+                magma_int_t len = A.row[i+1] - A.row[i];
+                slice_max = max( slice_max, len );
+                lmin = min( lmin, len );
+                lmax = max( lmax, len );
+                lsumsq += (real_Double_t) len * (real_Double_t) len;
+                magma_int_t bin = 0;
+                for( magma_int_t l=len; l > 0 && bin < MAGMA_PROFILE_BINS-1; l >>= 1 ) {
+                    bin++;
+                }
+                lhist[bin]++;
+                if ( len == 0 ) {
+                    lempty++;
+                }
+                for( magma_index_t k=A.row[i]; k < A.row[i+1]; k++ ) {
+                    magma_index_t j = A.col[k];
+                    lbw = max( lbw, (magma_int_t) abs( i - j ) );
+                    if ( j != i && j < n ) {
+                        loffdiag += 1.0;
+                        if ( zmprofile_find( A.row, A.col, j, i ) ) {
+                            lmatched += 1.0;
+                        }
+                    }
+                }
+            }
+            lsellp += (real_Double_t) (end - start) * slice_max
+                      - ( A.row[end] - A.row[start] );
+        }
+
+        #pragma omp critical
+        {
+            min_row = min( min_row, lmin );
+            max_row = max( max_row, lmax );
+            empty += lempty;
+            bandwidth = max( bandwidth, lbw );
+            missing += lmissing;
+            dd_rows += ldd_rows;
+            for( magma_int_t b=0; b < MAGMA_PROFILE_BINS; b++ ) {
+                hist[b] += lhist[b];
+            }
+            sumsq += lsumsq;
+            if ( ldd_count > 0 ) {
+                dd_min = ( dd_count == 0 || ldd_min < dd_min ) ? ldd_min : dd_min;
+                dd_max = ( dd_count == 0 || ldd_max > dd_max ) ? ldd_max : dd_max;
+            }
+            dd_count += ldd_count;
+            dd_sum += ldd_sum;
+            offdiag_nnz += loffdiag;
+            matched += lmatched;
+            sellp += lsellp;
+        }
+    }
+
+    p->missing_diag = missing;
+    p->dd_rows = dd_rows;
+    p->dd_min = dd_min;
+    p->dd_max = dd_max;
+    p->dd_avg = ( dd_count > 0 ) ? dd_sum / dd_count : 0.0;
+
+    real_Double_t mean = ( n > 0 ) ? (real_Double_t) A.row[n] / n : 0.0;
+    p->min_row = min_row;
+    p->max_row = max_row;
+    p->mean_row = mean;
+    p->var_row = ( n > 0 ) ? max( sumsq / n - mean * mean, 0.0 ) : 0.0;
+    for( magma_int_t b=0; b < MAGMA_PROFILE_BINS; b++ ) {
+        p->hist[b] = hist[b];
+    }
+    p->empty_rows = empty;
+    p->bandwidth = bandwidth;
+    p->pattern_symmetry = ( offdiag_nnz > 0.0 ) ? matched / offdiag_nnz : 1.0;
+    p->ell_padding = (real_Double_t) n * max_row - A.row[n];
+    p->sellp_padding = sellp;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes the structural and numerical profile of matrix A in a single
+    parallel pass over its CSR representation: the row-length histogram and
+    moments, empty rows, bandwidth, missing diagonal entries, the diagonal
+    dominance ratio sum_{j!=i} |a_ij| / |a_ii| per row, the pattern symmetry,
+    and the explicit zeros the ELL and SELL-P formats (slice height
+    MAGMA_PROFILE_SLICE, alignment 1) would store.
+
+    The profile is cached, and a later call for A returns it without
+    accessing the matrix, until magma_zmprofile_forget(A) is called.
+    magma_zmfree, the in-place scalings (magma_zmscale, magma_zmscale_apply,
+    magma_zmscale_matrix_rhs), magma_zmdiagadd and magma_zmrefill call it;
+    other code that changes the values or the pattern of A in place has to
+    call it. The cache is keyed on A->profile_id, so it applies to A and to
+    copies of the struct made after the call; CSR5 matrices are not cached.
+
+    Matrices not in CSR format or not on the CPU are profiled through a
+    CSR copy on the CPU. The pattern symmetry assumes the column indices
+    are sorted within each row.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix*
+                sparse matrix
+
+    @param[out]
+    profile     magma_matrix_profile*
+                profile of A
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmprofile(
+    magma_z_matrix *A,
+    magma_matrix_profile *profile,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hA={Magma_CSR}, CSRA={Magma_CSR};
+    magma_matrix_profile p;
+    bool cache = ( A->storage_type != Magma_CSR5 );
+
+    if ( cache && A->profile_id != 0 ) {
+        std::lock_guard< std::mutex > lock( zmprofile_mutex );
+        for( magma_int_t e=0; e < PROFILE_CACHE; e++ ) {
+            if ( zmprofile_match( &zmprofile_cache[e], A ) ) {
+                *profile = zmprofile_cache[e].profile;
+                return info;
+            }
+        }
+    }
+
+    if ( A->memory_location == Magma_CPU && A->storage_type == Magma_CSR ) {
+        zmprofile_csr( *A, &p );
+    }
+    else {
+        CHECK( magma_zmtransfer( *A, &hA, A->memory_location, Magma_CPU, queue ));
+        CHECK( magma_zmconvert( hA, &CSRA, hA.storage_type, Magma_CSR, queue ));
+        zmprofile_csr( CSRA, &p );
+    }
+
+    if ( cache ) {
+        std::lock_guard< std::mutex > lock( zmprofile_mutex );
+        zmprofile_entry *e = &zmprofile_cache[ zmprofile_next ];
+        zmprofile_next = ( zmprofile_next + 1 ) % PROFILE_CACHE;
+        if ( e->id == 0 ) {
+            zmprofile_used++;
+        }
+        zmprofile_last_id++;
+        e->id = zmprofile_last_id;
+        e->storage_type = A->storage_type;
+        e->memory_location = A->memory_location;
+        e->num_rows = A->num_rows;
+        e->num_cols = A->num_cols;
+        e->nnz = A->nnz;
+        e->val = A->val;
+        e->row = A->row;
+        e->col = A->col;
+        e->profile = p;
+        A->profile_id = e->id;
+    }
+    *profile = p;
+
+cleanup:
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &CSRA, queue );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Drops the cached profile of matrix A (see magma_zmprofile), to be
+    called before the values or the pattern of A are changed in place, or
+    its arrays are freed. Without a cached profile, it only reads A; if no
+    profile is cached at all, it takes no lock.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix*
+                sparse matrix
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmprofile_forget(
+    magma_z_matrix *A,
+    magma_queue_t queue )
+{
+    if ( A->storage_type == Magma_CSR5 || A->profile_id == 0 ) {
+        return MAGMA_SUCCESS;
+    }
+    size_t id = A->profile_id;
+    A->profile_id = 0;
+    if ( zmprofile_used == 0 ) {
+        return MAGMA_SUCCESS;
+    }
+    std::lock_guard< std::mutex > lock( zmprofile_mutex );
+    for( magma_int_t e=0; e < PROFILE_CACHE; e++ ) {
+        if ( zmprofile_cache[e].id == id ) {
+            zmprofile_cache[e].id = 0;
+            zmprofile_used--;
+        }
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Recommends a target format for magma_zmconvert based on the profile of
+    A (see magma_zmprofile):
+
+    Magma_ELL    if the rows are regular enough that ELL stores at most
+                 25% explicit zeros,
+    Magma_SELLP  if the SELL-P slices bound the padding to 25%,
+    Magma_CSR5   for irregular row lengths, as CSR5 balances the work over
+                 the nonzeros without padding,
+    Magma_CSR    for empty matrices and matrices with fewer rows than one
+                 SELL-P slice.
+
+    The recommendation targets the GPU SpMV kernels; the host kernels use
+    CSR. Whether Jacobi-type methods are viable can be read off the profile:
+    profile.dd_max < 1 with no missing diagonal entries means A is strictly
+    diagonally dominant by rows.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix*
+                sparse matrix
+
+    @param[out]
+    format      magma_storage_t*
+                recommended storage format
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmrecommend_format(
+    magma_z_matrix *A,
+    magma_storage_t *format,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_matrix_profile p;
+
+    *format = Magma_CSR;
+    CHECK( magma_zmprofile( A, &p, queue ));
+
+    if ( A->nnz == 0 || A->num_rows < MAGMA_PROFILE_SLICE ) {
+        *format = Magma_CSR;
+    }
+    else if ( p.ell_padding <= PADDING_ELL * A->nnz ) {
+        *format = Magma_ELL;
+    }
+    else if ( p.sellp_padding <= PADDING_SELLP * A->nnz ) {
+        *format = Magma_SELLP;
+    }
+    else {
+        *format = Magma_CSR5;
+    }
+
+cleanup:
+    return info;
+}
@@ -12,15 +12,323 @@
 */
 #include "magmasparse_internal.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #define RTOLERANCE     lapackf77_dlamch( "E" )
 #define ATOLERANCE     lapackf77_dlamch( "E" )
 
+/*
+    The host kernels below work on CSR (or CSRCOO) matrices on the CPU,
+    using only the row pointer, and are parallel over rows. Matrices in
+    other formats or on the device are converted to host CSR and back.
+    Scaling factors are real, stored in complex vectors.
+*/
+
+// Ruiz equilibration stops after this many sweeps, or when all row and
+// column max norms are within this tolerance of 1
+const magma_int_t ruiz_maxiter = 20;
+const double ruiz_tol = 1e-2;
+
+
+/******************************************************************************/
+// Returns whether the host kernels work on A directly.
+static bool
+zmscale_host( const magma_z_matrix *A )
+{
+    return A->memory_location == Magma_CPU
+        && (A->storage_type == Magma_CSR || A->storage_type == Magma_CSRCOO);
+}
+
+
+/******************************************************************************/
+// Sets f[i] = 1 / sqrt( sum_j real( a_ij )^2 ), the inverse row norms.
+static void
+zmscale_rownorm( const magma_z_matrix *A, magmaDoubleComplex *f )
+{
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i < A->num_rows; i++ ) {
+        double s = 0.0;
+        for( magma_int_t k=A->row[i]; k < A->row[i+1]; k++ ) {
+            s += MAGMA_Z_REAL( A->val[k] ) * MAGMA_Z_REAL( A->val[k] );
+        }
+        f[i] = MAGMA_Z_MAKE( 1.0/sqrt( s ), 0.0 );
+    }
+}
+
+
+/******************************************************************************/
+// Sets f[i] = 1 / real( a_ii ), or 1 / sqrt( real( a_ii )) if root.
+// Returns the number of zero diagonal entries.
+static magma_int_t
+zmscale_diag( const magma_z_matrix *A, bool root, magmaDoubleComplex *f )
+{
+    magma_int_t zeros = 0;
+    #pragma omp parallel for schedule(static) reduction(+:zeros)
+    for( magma_int_t i=0; i < A->num_rows; i++ ) {
+        magmaDoubleComplex d = MAGMA_Z_ZERO;
+        for( magma_int_t k=A->row[i]; k < A->row[i+1]; k++ ) {
+            if ( A->col[k] == i ) {
+                d = A->val[k];
+            }
+        }
+        if ( d == MAGMA_Z_ZERO ) {
+            zeros++;
+        }
+        double r = MAGMA_Z_REAL( d );
+        f[i] = MAGMA_Z_MAKE( 1.0/(root ? sqrt( r ) : r), 0.0 );
+    }
+    return zeros;
+}
+
+
+/******************************************************************************/
+// Sets f[i] = 1 / max_j |a_ij|, the inverse row max norms; 1 for zero rows.
+static void
+zmscale_rowmax( const magma_z_matrix *A, magmaDoubleComplex *f )
+{
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i < A->num_rows; i++ ) {
+        double m = 0.0;
+        for( magma_int_t k=A->row[i]; k < A->row[i+1]; k++ ) {
+            m = max( m, MAGMA_Z_ABS( A->val[k] ));
+        }
+        f[i] = MAGMA_Z_MAKE( (m > 0 ? 1.0/m : 1.0), 0.0 );
+    }
+}
+
+
+/******************************************************************************/
+// Scales A = diag( dr ) * A * diag( dc ); dr or dc NULL means no scaling.
+static void
+zmscale_rowcol(
+    magma_z_matrix *A,
+    const magmaDoubleComplex *dr,
+    const magmaDoubleComplex *dc )
+{
+    magma_zmprofile_forget( A, NULL );
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i < A->num_rows; i++ ) {
+        magmaDoubleComplex r = (dr != NULL ? dr[i] : MAGMA_Z_ONE);
+        if ( dc != NULL ) {
+            for( magma_int_t k=A->row[i]; k < A->row[i+1]; k++ ) {
+                A->val[k] = A->val[k] * dc[ A->col[k] ] * r;
+            }
+        }
+        else {
+            for( magma_int_t k=A->row[i]; k < A->row[i+1]; k++ ) {
+                A->val[k] = A->val[k] * r;
+            }
+        }
+    }
+}
+
+
+/******************************************************************************/
+// Scales the rows of the dense x, x = diag( d ) * x.
+static void
+zmscale_vector( const magmaDoubleComplex *d, magma_z_matrix *x )
+{
+    magma_int_t ld = ( x->ld > 0 ? x->ld
+                     : x->major == MagmaRowMajor ? x->num_cols : x->num_rows );
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i < x->num_rows; i++ ) {
+        for( magma_int_t j=0; j < x->num_cols; j++ ) {
+            magma_int_t k = ( x->major == MagmaRowMajor ? i*ld + j : i + j*ld );
+            x->val[k] = x->val[k] * d[i];
+        }
+    }
+}
+
+
+/******************************************************************************/
+// Iterative Ruiz equilibration: finds dr and dc such that all rows and
+// columns of diag( dr ) * A * diag( dc ) have max norm near 1, by repeatedly
+// dividing rows and columns by the square roots of their max norms.
+// If symmetric, dr = dc, using the larger of the row and column norms,
+// so symmetric matrices stay symmetric. A is not changed.
+static magma_int_t
+zmscale_ruiz(
+    const magma_z_matrix *A,
+    bool symmetric,
+    magmaDoubleComplex *dr,
+    magmaDoubleComplex *dc,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix Aview, AT={Magma_CSR};
+    double *r = NULL, *c = NULL, *rmax = NULL, *cmax = NULL;
+    magma_int_t m = A->num_rows, n = A->num_cols;
+
+    if ( symmetric && m != n ) {
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    // column norms are row norms of A^T
+    Aview = *A;
+    Aview.storage_type = Magma_CSR;
+    CHECK( magma_zmtranspose( Aview, &AT, queue ));
+
+    CHECK( magma_dmalloc_cpu( &r, m ));
+    CHECK( magma_dmalloc_cpu( &c, n ));
+    CHECK( magma_dmalloc_cpu( &rmax, m ));
+    CHECK( magma_dmalloc_cpu( &cmax, n ));
+    for( magma_int_t i=0; i < m; i++ ) {
+        r[i] = 1.0;
+    }
+    for( magma_int_t j=0; j < n; j++ ) {
+        c[j] = 1.0;
+    }
+
+    for( magma_int_t iter=0; iter < ruiz_maxiter; iter++ ) {
+        double err = 0.0;
+        #pragma omp parallel
+        {
+            #pragma omp for schedule(static) reduction(max:err)
+            for( magma_int_t i=0; i < m; i++ ) {
+                double s = 0.0;
+                for( magma_int_t k=A->row[i]; k < A->row[i+1]; k++ ) {
+                    s = max( s, MAGMA_Z_ABS( A->val[k] ) * c[ A->col[k] ] );
+                }
+                rmax[i] = s * r[i];
+                if ( s > 0 ) {
+                    err = max( err, fabs( 1.0 - rmax[i] ));
+                }
+            }
+            #pragma omp for schedule(static) reduction(max:err)
+            for( magma_int_t j=0; j < n; j++ ) {
+                double s = 0.0;
+                for( magma_int_t k=AT.row[j]; k < AT.row[j+1]; k++ ) {
+                    s = max( s, MAGMA_Z_ABS( AT.val[k] ) * r[ AT.col[k] ] );
+                }
+                cmax[j] = s * c[j];
+                if ( s > 0 ) {
+                    err = max( err, fabs( 1.0 - cmax[j] ));
+                }
+            }
+        }
+        if ( err <= ruiz_tol ) {
+            break;
+        }
+        if ( symmetric ) {
+            #pragma omp parallel for schedule(static)
+            for( magma_int_t i=0; i < m; i++ ) {
+                double s = max( rmax[i], cmax[i] );
+                if ( s > 0 ) {
+                    r[i] /= sqrt( s );
+                    c[i] = r[i];
+                }
+            }
+        }
+        else {
+            #pragma omp parallel for schedule(static)
+            for( magma_int_t i=0; i < m; i++ ) {
+                if ( rmax[i] > 0 ) {
+                    r[i] /= sqrt( rmax[i] );
+                }
+            }
+            #pragma omp parallel for schedule(static)
+            for( magma_int_t j=0; j < n; j++ ) {
+                if ( cmax[j] > 0 ) {
+                    c[j] /= sqrt( cmax[j] );
+                }
+            }
+        }
+    }
+
+    for( magma_int_t i=0; i < m; i++ ) {
+        dr[i] = MAGMA_Z_MAKE( r[i], 0.0 );
+    }
+    for( magma_int_t j=0; j < n; j++ ) {
+        dc[j] = MAGMA_Z_MAKE( c[j], 0.0 );
+    }
+
+cleanup:
+    magma_zmfree( &AT, queue );
+    magma_free_cpu( r );
+    magma_free_cpu( c );
+    magma_free_cpu( rmax );
+    magma_free_cpu( cmax );
+    return info;
+}
+
+
+/******************************************************************************/
+// Sets the factors f of scaling for side, as in magma_zmscale_generate,
+// for a square host CSR matrix A.
+static magma_int_t
+zmscale_factors(
+    const magma_z_matrix *A,
+    magma_scale_t scaling,
+    magma_side_t side,
+    magmaDoubleComplex *f,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix Aview, AT={Magma_CSR};
+    magmaDoubleComplex *g = NULL;
+
+    if ( scaling == Magma_UNITROW ) {
+        // scale to unit rownorm
+        zmscale_rownorm( A, f );
+    }
+    else if ( scaling == Magma_UNITDIAG ) {
+        // scale to unit diagonal, by rows or by rows and columns
+        if ( zmscale_diag( A, side == MagmaBothSides, f ) > 0 ) {
+            printf("%%error: zero diagonal element.\n");
+            info = MAGMA_ERR;
+        }
+    }
+    else if ( scaling == Magma_UNITCOL ) {
+        // scale to unit column norm
+        Aview = *A;
+        Aview.storage_type = Magma_CSR;
+        CHECK( magma_zmtranspose( Aview, &AT, queue ));
+        zmscale_rownorm( &AT, f );
+    }
+    else if ( scaling == Magma_RUIZ ) {
+        if ( side == MagmaBothSides ) {
+            // symmetric equilibration
+            CHECK( magma_zmalloc_cpu( &g, A->num_cols ));
+            CHECK( zmscale_ruiz( A, true, f, g, queue ));
+        }
+        else if ( side == MagmaLeft ) {
+            // one sweep equilibrates rows
+            zmscale_rowmax( A, f );
+        }
+        else {
+            Aview = *A;
+            Aview.storage_type = Magma_CSR;
+            CHECK( magma_zmtranspose( Aview, &AT, queue ));
+            zmscale_rowmax( &AT, f );
+        }
+    }
+    else {
+        printf( "%%error: scaling %d not supported line = %d.\n",
+          scaling, __LINE__ );
+        info = MAGMA_ERR_NOT_SUPPORTED;
+    }
+
+cleanup:
+    magma_zmfree( &AT, queue );
+    magma_free_cpu( g );
+    return info;
+}
+
+
+
 
 /**
     Purpose
     -------
 
-    Scales a matrix.
+    Scales a matrix. The scaling is symmetric, A = D * A * D, except
+    for Magma_RUIZ, which equilibrates rows and columns separately,
+    A = Dr * A * Dc (for symmetric A, Dr = Dc).
 
     Arguments
     ---------
@@ -31,7 +339,8 @@
 
     @param[in]
     scaling     magma_scale_t
-                scaling type (unit rownorm / unit diagonal)
+                scaling type (unit rownorm / unit diagonal /
+                Ruiz equilibration)
 
     @param[in]
     queue       magma_queue_t
@@ -47,62 +356,44 @@ magma_zmscale(
     magma_queue_t queue ){
     magma_int_t info = 0;
     
-    magmaDoubleComplex *tmp=NULL;
+    magmaDoubleComplex *tmp=NULL, *tmpc=NULL;
     
     magma_z_matrix hA={Magma_CSR}, CSRA={Magma_CSR};
     
-    if( A->num_rows != A->num_cols && scaling != Magma_NOSCALE ){
+    if( A->num_rows != A->num_cols && scaling != Magma_NOSCALE
+        && scaling != Magma_RUIZ ){
         printf("%% warning: non-square matrix.\n");
         printf("%% Fallback: no scaling.\n");
         scaling = Magma_NOSCALE;
     } 
         
    
-    if ( A->memory_location == Magma_CPU && A->storage_type == Magma_CSRCOO ) {
+    if ( zmscale_host( A ) ) {
         if ( scaling == Magma_NOSCALE ) {
             // no scale
             ;
         }
-        else if( A->num_rows == A->num_cols ){
-            if ( scaling == Magma_UNITROW ) {
-                // scale to unit rownorm
-                CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
-                for( magma_int_t z=0; z<A->num_rows; z++ ) {
-                    magmaDoubleComplex s = MAGMA_Z_MAKE( 0.0, 0.0 );
-                    for( magma_int_t f=A->row[z]; f<A->row[z+1]; f++ )
-                        s+= MAGMA_Z_REAL(A->val[f])*MAGMA_Z_REAL(A->val[f]);
-                    tmp[z] = MAGMA_Z_MAKE( 1.0/sqrt(  MAGMA_Z_REAL( s )  ), 0.0 );
-                }        
-                for( magma_int_t z=0; z<A->nnz; z++ ) {
-                    A->val[z] = A->val[z] * tmp[A->col[z]] * tmp[A->rowidx[z]];
-                }
-            }
-            else if (scaling == Magma_UNITDIAG ) {
-                // scale to unit diagonal
-                CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
-                for( magma_int_t z=0; z<A->num_rows; z++ ) {
-                    magmaDoubleComplex s = MAGMA_Z_MAKE( 0.0, 0.0 );
-                    for( magma_int_t f=A->row[z]; f<A->row[z+1]; f++ ) {
-                        if ( A->col[f]== z ) {
-                            // add some identity matrix
-                            //A->val[f] = A->val[f] +  MAGMA_Z_MAKE( 100000.0, 0.0 );
-                            s = A->val[f];
-                        }
-                    }
-                    if ( s == MAGMA_Z_MAKE( 0.0, 0.0 ) ){
-                        printf("%%error: zero diagonal element.\n");
-                        info = MAGMA_ERR;
-                    }
-                    tmp[z] = MAGMA_Z_MAKE( 1.0/sqrt(  MAGMA_Z_REAL( s )  ), 0.0 );
-                }
-                for( magma_int_t z=0; z<A->nnz; z++ ) {
-                    A->val[z] = A->val[z] * tmp[A->col[z]] * tmp[A->rowidx[z]];
-                }
-            }
-            else {
-                printf( "%%error: scaling not supported.\n" );
-                info = MAGMA_ERR_NOT_SUPPORTED;
+        else if ( scaling == Magma_RUIZ ) {
+            // equilibrate rows and columns
+            CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
+            CHECK( magma_zmalloc_cpu( &tmpc, A->num_cols ));
+            CHECK( zmscale_ruiz( A, false, tmp, tmpc, queue ));
+            zmscale_rowcol( A, tmp, tmpc );
+        }
+        else if ( scaling == Magma_UNITROW ) {
+            // scale to unit rownorm
+            CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
+            zmscale_rownorm( A, tmp );
+            zmscale_rowcol( A, tmp, tmp );
+        }
+        else if ( scaling == Magma_UNITDIAG ) {
+            // scale to unit diagonal
+            CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
+            if ( zmscale_diag( A, true, tmp ) > 0 ) {
+                printf("%%error: zero diagonal element.\n");
+                info = MAGMA_ERR;
             }
+            zmscale_rowcol( A, tmp, tmp );
         }
         else {
             printf( "%%error: scaling not supported.\n" );
@@ -113,18 +404,19 @@ magma_zmscale(
         magma_storage_t A_storage = A->storage_type;
         magma_location_t A_location = A->memory_location;
         CHECK( magma_zmtransfer( *A, &hA, A->memory_location, Magma_CPU, queue ));
-        CHECK( magma_zmconvert( hA, &CSRA, hA.storage_type, Magma_CSRCOO, queue ));
+        CHECK( magma_zmconvert( hA, &CSRA, hA.storage_type, Magma_CSR, queue ));
 
-        CHECK( magma_zmscale( &CSRA, scaling, queue ));
+        CHECK( magma_zmscale( &CSRA, scaling, queue ) );
 
         magma_zmfree( &hA, queue );
         magma_zmfree( A, queue );
-        CHECK( magma_zmconvert( CSRA, &hA, Magma_CSRCOO, A_storage, queue ));
+        CHECK( magma_zmconvert( CSRA, &hA, Magma_CSR, A_storage, queue ));
         CHECK( magma_zmtransfer( hA, A, Magma_CPU, A_location, queue ));
     }
     
 cleanup:
     magma_free_cpu( tmp );
+    magma_free_cpu( tmpc );
     magma_zmfree( &hA, queue );
     magma_zmfree( &CSRA, queue );
     return info;
@@ -135,6 +427,9 @@ cleanup:
     -------
 
     Scales a matrix and a right hand side vector of a Ax = b system.
+    For the scalings by rows and columns (Magma_UNITROWCOL,
+    Magma_UNITDIAGCOL, Magma_RUIZ), the solution of the scaled system
+    times scaling_factors is the solution of the original system.
 
     Arguments
     ---------
@@ -145,7 +440,7 @@ cleanup:
                 
     @param[in,out]
     b           magma_z_matrix*
-                input/output right hand side vector    
+                input/output right hand side vector, on the CPU
                 
     @param[out]
     scaling_factors   magma_z_matrix*
@@ -153,7 +448,8 @@ cleanup:
 
     @param[in]
     scaling     magma_scale_t
-                scaling type (unit rownorm / unit diagonal)
+                scaling type (unit rownorm / unit diagonal /
+                Ruiz equilibration)
 
     @param[in]
     queue       magma_queue_t
@@ -171,7 +467,7 @@ magma_zmscale_matrix_rhs(
     magma_queue_t queue ) {
     magma_int_t info = 0;
     
-    magmaDoubleComplex *tmp=NULL;
+    magmaDoubleComplex *tmp=NULL, *tmpc=NULL;
     
     magma_z_matrix hA={Magma_CSR}, CSRA={Magma_CSR};
     
@@ -184,132 +480,92 @@ magma_zmscale_matrix_rhs(
     } 
         
    
-    if ( A->memory_location == Magma_CPU && A->storage_type == Magma_CSRCOO ) {
+    if ( zmscale_host( A ) ) {
         if ( scaling == Magma_NOSCALE ) {
             // no scale
             ;
         }
-        else if( A->num_rows == A->num_cols ){
-            if ( scaling == Magma_UNITROW ) {
-                // scale to unit rownorm by rows
-                CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
-                for( magma_int_t z=0; z<A->num_rows; z++ ) {
-                    magmaDoubleComplex s = MAGMA_Z_MAKE( 0.0, 0.0 );
-                    for( magma_int_t f=A->row[z]; f<A->row[z+1]; f++ )
-                        s+= MAGMA_Z_MAKE( MAGMA_Z_REAL(A->val[f])*MAGMA_Z_REAL(A->val[f]), 0.0 );
-                    tmp[z] = MAGMA_Z_MAKE( 1.0/sqrt(  MAGMA_Z_REAL( s )  ), 0.0 );
-                }        
-                for( magma_int_t z=0; z<A->nnz; z++ ) {
-                    A->val[z] = A->val[z] * tmp[A->rowidx[z]];
-                }
-                for ( int i=0; i<A->num_rows; i++ ) {
-                  b->val[i] = b->val[i] * tmp[i];
-                }
-            }
-            else if (scaling == Magma_UNITDIAG ) {
-                // scale to unit diagonal by rows
-                CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
-                for( magma_int_t z=0; z<A->num_rows; z++ ) {
-                    magmaDoubleComplex s = MAGMA_Z_MAKE( 0.0, 0.0 );
-                    for( magma_int_t f=A->row[z]; f<A->row[z+1]; f++ ) {
-                        if ( A->col[f]== z ) {
-                            s = A->val[f];
-                        }
-                    }
-                    if ( s == MAGMA_Z_MAKE( 0.0, 0.0 ) ){
-                        printf("%%error: zero diagonal element.\n");
-                        info = MAGMA_ERR;
-                    }
-                    tmp[z] = MAGMA_Z_MAKE( 1.0/MAGMA_Z_REAL( s ), 0.0 );
-                }
-                for( magma_int_t z=0; z<A->nnz; z++ ) {
-                    A->val[z] = A->val[z] * tmp[A->rowidx[z]];
-                }
-                for ( int i=0; i<A->num_rows; i++ ) {
-                  b->val[i] = b->val[i] * tmp[i];
-                }
-            }
-            else if ( scaling == Magma_UNITROWCOL ) {
-                // scale to unit rownorm by rows and columns
-                CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
-                for( magma_int_t z=0; z<A->num_rows; z++ ) {
-                    magmaDoubleComplex s = MAGMA_Z_MAKE( 0.0, 0.0 );
-                    for( magma_int_t f=A->row[z]; f<A->row[z+1]; f++ )
-                        s+= MAGMA_Z_MAKE( MAGMA_Z_REAL(A->val[f])*MAGMA_Z_REAL(A->val[f]), 0.0 );
-                    tmp[z] = MAGMA_Z_MAKE( 1.0/sqrt(  MAGMA_Z_REAL( s )  ), 0.0 );
-                }        
-                for( magma_int_t z=0; z<A->nnz; z++ ) {
-                    A->val[z] = A->val[z] * tmp[A->col[z]] * tmp[A->rowidx[z]];
-                }
-                scaling_factors->num_rows = A->num_rows;
-                scaling_factors->num_cols = 1;
-                scaling_factors->ld = 1;
-                scaling_factors->nnz = A->num_rows;
-                scaling_factors->val = NULL;
-                CHECK( magma_zmalloc_cpu( &scaling_factors->val, A->num_rows ));
-                for ( int i=0; i<A->num_rows; i++ ) {
-                  scaling_factors->val[i] = tmp[i];
-                  b->val[i] = b->val[i] * tmp[i];
-                }
-            }
-            else if (scaling == Magma_UNITDIAGCOL ) {
-                // scale to unit diagonal by rows and columns
-                CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
-                for( magma_int_t z=0; z<A->num_rows; z++ ) {
-                    magmaDoubleComplex s = MAGMA_Z_MAKE( 0.0, 0.0 );
-                    for( magma_int_t f=A->row[z]; f<A->row[z+1]; f++ ) {
-                        if ( A->col[f]== z ) {
-                            s = A->val[f];
-                        }
-                    }
-                    if ( s == MAGMA_Z_MAKE( 0.0, 0.0 ) ){
-                        printf("%%error: zero diagonal element.\n");
-                        info = MAGMA_ERR;
-                    }
-                    tmp[z] = MAGMA_Z_MAKE( 1.0/sqrt(  MAGMA_Z_REAL( s )  ), 0.0 );
-                }
-                for( magma_int_t z=0; z<A->nnz; z++ ) {
-                    A->val[z] = A->val[z] * tmp[A->col[z]] * tmp[A->rowidx[z]];
-                }
-                scaling_factors->num_rows = A->num_rows;
-                scaling_factors->num_cols = 1;
-                scaling_factors->ld = 1;
-                scaling_factors->nnz = A->num_rows;
-                scaling_factors->val = NULL;
-                CHECK( magma_zmalloc_cpu( &scaling_factors->val, A->num_rows ));
-                for ( int i=0; i<A->num_rows; i++ ) {
-                  scaling_factors->val[i] = tmp[i];
-                  b->val[i] = b->val[i] * tmp[i];
-                }
+        else if ( scaling == Magma_UNITROW ) {
+            // scale to unit rownorm by rows
+            CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
+            zmscale_rownorm( A, tmp );
+            zmscale_rowcol( A, tmp, NULL );
+        }
+        else if ( scaling == Magma_UNITDIAG ) {
+            // scale to unit diagonal by rows
+            CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
+            if ( zmscale_diag( A, false, tmp ) > 0 ) {
+                printf("%%error: zero diagonal element.\n");
+                info = MAGMA_ERR;
             }
-            else {
-                printf( "%%error: scaling %d not supported line = %d.\n", 
-                  scaling, __LINE__ );
-                info = MAGMA_ERR_NOT_SUPPORTED;
+            zmscale_rowcol( A, tmp, NULL );
+        }
+        else if ( scaling == Magma_UNITROWCOL ) {
+            // scale to unit rownorm by rows and columns
+            CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
+            zmscale_rownorm( A, tmp );
+            zmscale_rowcol( A, tmp, tmp );
+            tmpc = tmp;
+        }
+        else if ( scaling == Magma_UNITDIAGCOL ) {
+            // scale to unit diagonal by rows and columns
+            CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
+            if ( zmscale_diag( A, true, tmp ) > 0 ) {
+                printf("%%error: zero diagonal element.\n");
+                info = MAGMA_ERR;
             }
+            zmscale_rowcol( A, tmp, tmp );
+            tmpc = tmp;
+        }
+        else if ( scaling == Magma_RUIZ ) {
+            // equilibrate rows and columns
+            CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
+            CHECK( magma_zmalloc_cpu( &tmpc, A->num_cols ));
+            CHECK( zmscale_ruiz( A, false, tmp, tmpc, queue ));
+            zmscale_rowcol( A, tmp, tmpc );
         }
         else {
             printf( "%%error: scaling %d not supported line = %d.\n", 
-                  scaling, __LINE__ );
+              scaling, __LINE__ );
             info = MAGMA_ERR_NOT_SUPPORTED;
         }
+        if ( tmp != NULL ) {
+            for ( magma_int_t i=0; i<A->num_rows; i++ ) {
+                b->val[i] = b->val[i] * tmp[i];
+            }
+        }
+        if ( tmpc != NULL ) {
+            scaling_factors->num_rows = A->num_cols;
+            scaling_factors->num_cols = 1;
+            scaling_factors->ld = 1;
+            scaling_factors->nnz = A->num_cols;
+            scaling_factors->val = NULL;
+            CHECK( magma_zmalloc_cpu( &scaling_factors->val, A->num_cols ));
+            for ( magma_int_t i=0; i<A->num_cols; i++ ) {
+                scaling_factors->val[i] = tmpc[i];
+            }
+        }
+        if ( tmpc == tmp ) {
+            tmpc = NULL;
+        }
     }
     else {
         magma_storage_t A_storage = A->storage_type;
         magma_location_t A_location = A->memory_location;
         CHECK( magma_zmtransfer( *A, &hA, A->memory_location, Magma_CPU, queue ));
-        CHECK( magma_zmconvert( hA, &CSRA, hA.storage_type, Magma_CSRCOO, queue ));
+        CHECK( magma_zmconvert( hA, &CSRA, hA.storage_type, Magma_CSR, queue ));
 
-        CHECK( magma_zmscale_matrix_rhs( &CSRA, b, scaling_factors, scaling, queue ));
+        CHECK( magma_zmscale_matrix_rhs( &CSRA, b, scaling_factors, scaling, queue ) );
 
         magma_zmfree( &hA, queue );
         magma_zmfree( A, queue );
-        CHECK( magma_zmconvert( CSRA, &hA, Magma_CSRCOO, A_storage, queue ));
+        CHECK( magma_zmconvert( CSRA, &hA, Magma_CSR, A_storage, queue ));
         CHECK( magma_zmtransfer( hA, A, Magma_CPU, A_location, queue ));
     }
     
 cleanup:
     magma_free_cpu( tmp );
+    magma_free_cpu( tmpc );
     magma_zmfree( &hA, queue );
     magma_zmfree( &CSRA, queue );
     return info;
@@ -348,6 +604,7 @@ magma_zmdiagadd(
     magma_z_matrix hA={Magma_CSR}, CSRA={Magma_CSR};
     
     if ( A->memory_location == Magma_CPU && A->storage_type == Magma_CSRCOO ) {
+        magma_zmprofile_forget( A, queue );
         for( magma_int_t z=0; z<A->nnz; z++ ) {
             if ( A->col[z]== A->rowidx[z] ) {
                 // add some identity matrix
@@ -382,6 +639,8 @@ cleanup:
     Generates n vectors of scaling factors from the A matrix 
     and stores them in the factors matrix as column vectors in 
     column major ordering.
+    For Magma_RUIZ, MagmaLeft and MagmaRight equilibrate rows and columns,
+    and MagmaBothSides is the symmetric Ruiz equilibration.
 
     Arguments
     ---------
@@ -424,8 +683,6 @@ magma_zmscale_generate(
     magma_queue_t queue  ){
     magma_int_t info = 0;
     
-    magmaDoubleComplex *tmp=NULL;
-    
     magma_z_matrix hA={Magma_CSR}, CSRA={Magma_CSR};
     
     
@@ -436,83 +693,14 @@ magma_zmscale_generate(
     } 
         
    
-    if ( A->memory_location == Magma_CPU && A->storage_type == Magma_CSRCOO ) {
+    if ( zmscale_host( A ) ) {
         for ( magma_int_t j=0; j<n; j++ ) {
-        // printf("%% scaling[%d] = %d\n", j, scaling[j]);
             if ( scaling[j] == Magma_NOSCALE ) {
                 // no scale
-            
             }
             else if( A->num_rows == A->num_cols ) {
-                if ( scaling[j] == Magma_UNITROW && side[j] != MagmaBothSides ) {
-                // scale to unit rownorm
-                    for( magma_int_t z=0; z<A->num_rows; z++ ) {
-                        magmaDoubleComplex s = MAGMA_Z_MAKE( 0.0, 0.0 );
-                        for( magma_int_t f=A->row[z]; f<A->row[z+1]; f++ )
-                            s+= MAGMA_Z_MAKE( MAGMA_Z_REAL(A->val[f])*MAGMA_Z_REAL(A->val[f]), 0.0 );
-                        scaling_factors[j].val[z] = MAGMA_Z_MAKE( 1.0/sqrt(  MAGMA_Z_REAL( s )  ), 0.0 );
-                    }        
-                }
-                else if (scaling[j] == Magma_UNITDIAG && side[j] != MagmaBothSides ) {
-                // scale to unit diagonal
-                    for( magma_int_t z=0; z<A->num_rows; z++ ) {
-                        magmaDoubleComplex s = MAGMA_Z_MAKE( 0.0, 0.0 );
-                        for( magma_int_t f=A->row[z]; f<A->row[z+1]; f++ ) {
-                            if ( A->col[f]== z ) {
-                                s = A->val[f];
-                            }
-                        }
-                        if ( s == MAGMA_Z_MAKE( 0.0, 0.0 ) ){
-                            printf("%%error: zero diagonal element.\n");
-                            info = MAGMA_ERR;
-                        }
-                        scaling_factors[j].val[z] = MAGMA_Z_MAKE( 1.0/MAGMA_Z_REAL( s ), 0.0 );
-                    }
-                }
-                else if ( scaling[j] == Magma_UNITCOL && side[j] != MagmaBothSides ) {
-                // scale to unit column norm
-                    CHECK( magma_zmtranspose( *A, &CSRA, queue ) );
-                    magma_scale_t tscale = Magma_UNITROW;
-                    magma_zmscale_generate( 1, &tscale, &side[j], &CSRA, 
-                            &scaling_factors[j], queue );
-                }
-                else if ( scaling[j] == Magma_UNITROW && side[j] == MagmaBothSides ) {
-                    // scale to unit rownorm by rows and columns
-                    for( magma_int_t z=0; z<A->num_rows; z++ ) {
-                        magmaDoubleComplex s = MAGMA_Z_MAKE( 0.0, 0.0 );
-                        for( magma_int_t f=A->row[z]; f<A->row[z+1]; f++ )
-                            s+= MAGMA_Z_MAKE( MAGMA_Z_REAL(A->val[f])*MAGMA_Z_REAL(A->val[f]), 0.0 );
-                        scaling_factors[j].val[z] = MAGMA_Z_MAKE( 1.0/sqrt(  MAGMA_Z_REAL( s )  ), 0.0 );
-                    } 
-                }
-                else if (scaling[j] == Magma_UNITDIAG && side[j] == MagmaBothSides ) {
-                    // scale to unit diagonal by rows and columns
-                    for( magma_int_t z=0; z<A->num_rows; z++ ) {
-                        magmaDoubleComplex s = MAGMA_Z_MAKE( 0.0, 0.0 );
-                        for( magma_int_t f=A->row[z]; f<A->row[z+1]; f++ ) {
-                            if ( A->col[f]== z ) {
-                                s = A->val[f];
-                            }
-                        }
-                        if ( s == MAGMA_Z_MAKE( 0.0, 0.0 ) ){
-                            printf("%%error: zero diagonal element.\n");
-                            info = MAGMA_ERR;
-                        }
-                        scaling_factors[j].val[z] = MAGMA_Z_MAKE( 1.0/sqrt(  MAGMA_Z_REAL( s )  ), 0.0 );
-                    }
-                }
-                else if ( scaling[j] == Magma_UNITCOL && side[j] == MagmaBothSides ) {
-                    // scale to unit column norm
-                    CHECK( magma_zmtranspose( *A, &CSRA, queue ) );
-                    magma_scale_t tscale = Magma_UNITROW;
-                    magma_zmscale_generate( 1, &tscale, &side[j], &CSRA, 
-                      &scaling_factors[j], queue );
-                }
-                else {
-                    printf( "%%error: scaling %d not supported line = %d.\n", 
-                      scaling[j], __LINE__ );
-                    info = MAGMA_ERR_NOT_SUPPORTED;
-                }
+                CHECK( zmscale_factors( A, scaling[j], side[j],
+                                        scaling_factors[j].val, queue ));
             }
             else {
                 printf( "%%error: scaling of non-square matrices %d not supported line = %d.\n", 
@@ -525,19 +713,18 @@ magma_zmscale_generate(
         magma_storage_t A_storage = A->storage_type;
         magma_location_t A_location = A->memory_location;
         CHECK( magma_zmtransfer( *A, &hA, A->memory_location, Magma_CPU, queue ));
-        CHECK( magma_zmconvert( hA, &CSRA, hA.storage_type, Magma_CSRCOO, queue ));
+        CHECK( magma_zmconvert( hA, &CSRA, hA.storage_type, Magma_CSR, queue ));
 
-        CHECK( magma_zmscale_generate( n, scaling, side, &CSRA, scaling_factors, queue ));
+        CHECK( magma_zmscale_generate( n, scaling, side, &CSRA, scaling_factors, queue ) );
 
         magma_zmfree( &hA, queue );
         magma_zmfree( A, queue );
-        CHECK( magma_zmconvert( CSRA, &hA, Magma_CSRCOO, A_storage, queue ));
+        CHECK( magma_zmconvert( CSRA, &hA, Magma_CSR, A_storage, queue ));
         CHECK( magma_zmtransfer( hA, A, Magma_CPU, A_location, queue ));
     }
     
     
 cleanup:
-    magma_free_cpu( tmp );
     magma_zmfree( &hA, queue );
     magma_zmfree( &CSRA, queue );
     return info;
@@ -585,35 +772,24 @@ magma_zmscale_apply(
       magma_z_matrix* A,
       magma_queue_t queue ){
     magma_int_t info = 0;
-      
-    magmaDoubleComplex *tmp=NULL;
     
     magma_z_matrix hA={Magma_CSR}, CSRA={Magma_CSR};
     
-    if ( A->memory_location == Magma_CPU && A->storage_type == Magma_CSRCOO ) {
+    if ( zmscale_host( A ) ) {
         for ( magma_int_t j=0; j<n; j++ ) {
             
             if( A->num_rows == A->num_cols ) {
                 if ( side[j] == MagmaLeft ) {
-                    // scale by rows       
-                    for( magma_int_t z=0; z<A->nnz; z++ ) {
-                        A->val[z] = A->val[z] * scaling_factors[j].val[A->rowidx[z]];
-                    }
+                    // scale by rows
+                    zmscale_rowcol( A, scaling_factors[j].val, NULL );
                 }
                 else if ( side[j] == MagmaBothSides ) {
-                    // scale by rows and columns       
-                    for( magma_int_t z=0; z<A->nnz; z++ ) {
-                        A->val[z] = A->val[z] 
-                            * scaling_factors[j].val[A->col[z]] 
-                            * scaling_factors[j].val[A->rowidx[z]];
-                    }
+                    // scale by rows and columns
+                    zmscale_rowcol( A, scaling_factors[j].val, scaling_factors[j].val );
                 }
                 else if ( side[j] == MagmaRight ) {
                     // scale by columns
-                    for( magma_int_t z=0; z<A->nnz; z++ ) {
-                        A->val[z] = A->val[z] * scaling_factors[j].val[A->rowidx[z]];
-                    }
-                    
+                    zmscale_rowcol( A, NULL, scaling_factors[j].val );
                 }
             }
         }
@@ -622,27 +798,324 @@ magma_zmscale_apply(
         magma_storage_t A_storage = A->storage_type;
         magma_location_t A_location = A->memory_location;
         CHECK( magma_zmtransfer( *A, &hA, A->memory_location, Magma_CPU, queue ));
-        CHECK( magma_zmconvert( hA, &CSRA, hA.storage_type, Magma_CSRCOO, queue ));
+        CHECK( magma_zmconvert( hA, &CSRA, hA.storage_type, Magma_CSR, queue ));
 
-        CHECK( magma_zmscale_apply( n, side, scaling_factors, &CSRA, queue ));
+        CHECK( magma_zmscale_apply( n, side, scaling_factors, &CSRA, queue ) );
 
         magma_zmfree( &hA, queue );
         magma_zmfree( A, queue );
-        CHECK( magma_zmconvert( CSRA, &hA, Magma_CSRCOO, A_storage, queue ));
+        CHECK( magma_zmconvert( CSRA, &hA, Magma_CSR, A_storage, queue ));
         CHECK( magma_zmtransfer( hA, A, Magma_CPU, A_location, queue ));
     }
     
     
 cleanup:
-    magma_free_cpu( tmp );
     magma_zmfree( &hA, queue );
     magma_zmfree( &CSRA, queue );
-  
-  
     return info;
 }
 
 
+/**
+    Purpose
+    -------
+
+    Computes the scaling factors of a matrix A, to scale A, or later
+    matrices with the same pattern and similar values (e.g., in time
+    stepping), with magma_zscaling_apply, without recomputing the factors.
+    The scaled matrix is Dr * A * Dc, with Dr = diag( S->dr ) for
+    MagmaLeft or MagmaBothSides, and Dc = diag( S->dc ) for MagmaRight or
+    MagmaBothSides.
+
+    For Magma_RUIZ and MagmaBothSides, Dr and Dc equilibrate rows and
+    columns separately; A need not be square. Otherwise, the factors are
+    those of magma_zmscale_generate for scaling and side, and Dr = Dc for
+    MagmaBothSides.
+
+    Right hand sides b of A x = b are scaled by
+    magma_zscaling_vector( *S, MagmaLeft, &b ), and solutions y of the
+    scaled system give x by magma_zscaling_vector( *S, MagmaRight, &y ).
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix
+
+    @param[in]
+    scaling     magma_scale_t
+                scaling type
+
+    @param[in]
+    side        magma_side_t
+                MagmaLeft (rows), MagmaRight (columns), or MagmaBothSides
+
+    @param[out]
+    S           magma_z_scaling*
+                scaling factors, on the CPU; free with magma_zscaling_free
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zscaling_create(
+    magma_z_matrix A,
+    magma_scale_t scaling,
+    magma_side_t side,
+    magma_z_scaling *S,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hA={Magma_CSR}, CSRA={Magma_CSR}, empty={Magma_CSR};
+    magma_z_matrix *B = &A;
+
+    S->scaling = scaling;
+    S->side = side;
+    S->dr = empty;
+    S->dc = empty;
+
+    if ( scaling == Magma_NOSCALE ) {
+        goto cleanup;
+    }
+    if ( side != MagmaLeft && side != MagmaRight && side != MagmaBothSides ) {
+        info = MAGMA_ERR_ILLEGAL_VALUE;
+        goto cleanup;
+    }
+    if ( ! zmscale_host( &A ) ) {
+        CHECK( magma_zmtransfer( A, &hA, A.memory_location, Magma_CPU, queue ));
+        CHECK( magma_zmconvert( hA, &CSRA, hA.storage_type, Magma_CSR, queue ));
+        B = &CSRA;
+    }
+
+    if ( side != MagmaRight ) {
+        CHECK( magma_zvinit( &S->dr, Magma_CPU, B->num_rows, 1, MAGMA_Z_ONE, queue ));
+    }
+    if ( side != MagmaLeft ) {
+        CHECK( magma_zvinit( &S->dc, Magma_CPU, B->num_cols, 1, MAGMA_Z_ONE, queue ));
+    }
+
+    if ( scaling == Magma_RUIZ && side == MagmaBothSides ) {
+        CHECK( zmscale_ruiz( B, false, S->dr.val, S->dc.val, queue ));
+    }
+    else if ( B->num_rows != B->num_cols ) {
+        printf( "%%error: scaling of non-square matrices %d not supported line = %d.\n",
+                scaling, __LINE__ );
+        info = MAGMA_ERR_NOT_SUPPORTED;
+    }
+    else if ( side == MagmaLeft ) {
+        CHECK( zmscale_factors( B, scaling, side, S->dr.val, queue ));
+    }
+    else if ( side == MagmaRight ) {
+        CHECK( zmscale_factors( B, scaling, side, S->dc.val, queue ));
+    }
+    else {
+        CHECK( zmscale_factors( B, scaling, side, S->dr.val, queue ));
+        for ( magma_int_t i=0; i<B->num_rows; i++ ) {
+            S->dc.val[i] = S->dr.val[i];
+        }
+    }
+
+cleanup:
+    if ( info != 0 ) {
+        magma_zscaling_free( S, queue );
+    }
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &CSRA, queue );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Scales a matrix by precomputed scaling factors:
+    A = diag( S.dr ) * A * diag( S.dc ), see magma_zscaling_create.
+    A must have the dimensions of the matrix the factors were computed for.
+
+    Arguments
+    ---------
+
+    @param[in]
+    S           magma_z_scaling
+                scaling factors
+
+    @param[in,out]
+    A           magma_z_matrix*
+                input/output matrix
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zscaling_apply(
+    magma_z_scaling S,
+    magma_z_matrix *A,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hA={Magma_CSR}, CSRA={Magma_CSR};
+
+    if ( (S.dr.val != NULL && S.dr.num_rows != A->num_rows)
+         || (S.dc.val != NULL && S.dc.num_rows != A->num_cols) ) {
+        info = MAGMA_ERR_ILLEGAL_VALUE;
+        goto cleanup;
+    }
+    if ( S.dr.val == NULL && S.dc.val == NULL ) {
+        goto cleanup;
+    }
+
+    if ( zmscale_host( A ) ) {
+        zmscale_rowcol( A, S.dr.val, S.dc.val );
+    }
+    else {
+        magma_storage_t A_storage = A->storage_type;
+        magma_location_t A_location = A->memory_location;
+        CHECK( magma_zmtransfer( *A, &hA, A->memory_location, Magma_CPU, queue ));
+        CHECK( magma_zmconvert( hA, &CSRA, hA.storage_type, Magma_CSR, queue ));
+
+        CHECK( magma_zscaling_apply( S, &CSRA, queue ) );
+
+        magma_zmfree( &hA, queue );
+        magma_zmfree( A, queue );
+        CHECK( magma_zmconvert( CSRA, &hA, Magma_CSR, A_storage, queue ));
+        CHECK( magma_zmtransfer( hA, A, Magma_CPU, A_location, queue ));
+    }
+
+cleanup:
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &CSRA, queue );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Scales a dense vector, or block of vectors, by precomputed scaling
+    factors: x = diag( S.dr ) * x for MagmaLeft, to scale the right hand
+    side of A x = b, and x = diag( S.dc ) * x for MagmaRight, to get the
+    solution of A x = b from that of the scaled system.
+    See magma_zscaling_create. If S does not scale the given side,
+    x is not changed.
+
+    Vectors on the CPU are scaled in place. Vectors on the device are
+    scaled on the CPU and copied back.
+
+    Arguments
+    ---------
+
+    @param[in]
+    S           magma_z_scaling
+                scaling factors
+
+    @param[in]
+    side        magma_side_t
+                MagmaLeft (row factors) or MagmaRight (column factors)
+
+    @param[in,out]
+    x           magma_z_matrix*
+                input/output dense vector(s), with S.dr.num_rows
+                (MagmaLeft) or S.dc.num_rows (MagmaRight) rows
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zscaling_vector(
+    magma_z_scaling S,
+    magma_side_t side,
+    magma_z_matrix *x,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hx={Magma_CSR};
+    magma_z_matrix *d = NULL;
+
+    if ( side == MagmaLeft ) {
+        d = &S.dr;
+    }
+    else if ( side == MagmaRight ) {
+        d = &S.dc;
+    }
+    else {
+        info = MAGMA_ERR_ILLEGAL_VALUE;
+        goto cleanup;
+    }
+    if ( d->val == NULL ) {
+        goto cleanup;
+    }
+    if ( x->storage_type != Magma_DENSE || x->num_rows != d->num_rows ) {
+        info = MAGMA_ERR_ILLEGAL_VALUE;
+        goto cleanup;
+    }
+
+    if ( x->memory_location == Magma_CPU ) {
+        zmscale_vector( d->val, x );
+    }
+    else {
+        magma_location_t x_location = x->memory_location;
+        CHECK( magma_zmtransfer( *x, &hx, x->memory_location, Magma_CPU, queue ));
+        zmscale_vector( d->val, &hx );
+        magma_zmfree( x, queue );
+        CHECK( magma_zmtransfer( hx, x, Magma_CPU, x_location, queue ));
+    }
+
+cleanup:
+    magma_zmfree( &hx, queue );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Frees the scaling factors of magma_zscaling_create.
+
+    Arguments
+    ---------
+
+    @param[in,out]
+    S           magma_z_scaling*
+                scaling factors
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zscaling_free(
+    magma_z_scaling *S,
+    magma_queue_t queue )
+{
+    magma_zmfree( &S->dr, queue );
+    magma_zmfree( &S->dc, queue );
+    S->scaling = Magma_NOSCALE;
+    return MAGMA_SUCCESS;
+}
+
+
 /**
     Purpose
     -------
@@ -680,12 +1153,21 @@ magma_zdimv(
     if ( vecA->memory_location == Magma_DEV && vecB->memory_location == Magma_DEV)  {
         //printf("%% magma_zdimv scaling\n");
         
+        #if defined(MAGMA_HAVE_HOST)
+        // device memory is host memory
+        for( magma_int_t j=0; j < vecB->num_cols; j++ ) {
+            for( magma_int_t i=0; i < vecB->num_rows; i++ ) {
+                vecB->val[i + j*vecB->ld] *= vecA->val[i];
+            }
+        }
+        #else
         magmablas_zlascl2( 
             vecB->fill_mode, vecB->num_rows, vecB->num_cols,
             (magmaDouble_ptr) vecA->val,
             vecB->val, vecB->ld,
             queue,
             &info );
+        #endif
     }
     else {
         //printf("%% magma_zdimv transfering vectors to device\n");
@@ -12,7 +12,9 @@
 */
 #include "magmasparse_internal.h"
 
+#if ! defined(MAGMA_HAVE_HOST)
 #include <cuda.h>  // for CUDA_VERSION
+#endif
 
 /* For hipSPARSE, they use a separate complex type than for hipBLAS */
 #ifdef MAGMA_HAVE_HIP
@@ -286,6 +288,12 @@ magma_z_cucsrtranspose(
     magma_zmfree( B, queue );
 
     if( A.storage_type == Magma_CSR && A.memory_location == Magma_DEV ) {
+#if defined(MAGMA_HAVE_HOST)
+        // no cuSPARSE: "device" memory is host memory, transpose on the CPU
+        CHECK( magma_zmtransfer( A, &ACSR, Magma_DEV, Magma_CPU, queue ));
+        CHECK( magma_zmtranspose_cpu( ACSR, &BCSR, queue ));
+        CHECK( magma_zmtransfer( BCSR, B, Magma_CPU, Magma_DEV, queue ));
+#else
         // fill in information for B
         B->storage_type    = A.storage_type;
         B->diagorder_type  = A.diagorder_type;
@@ -327,6 +335,7 @@ magma_z_cucsrtranspose(
                           (cuDoubleComplex*)A.dval, A.drow, A.dcol, (cuDoubleComplex*)B->dval, B->dcol, B->drow,
                           CUSPARSE_ACTION_NUMERIC,
                           CUSPARSE_INDEX_BASE_ZERO);
+#endif
     } else if ( A.storage_type == Magma_CSR && A.memory_location == Magma_CPU ){
         CHECK( magma_zmtransfer( A, &dA, A.memory_location, Magma_DEV, queue ));
         CHECK( magma_z_cucsrtranspose( dA, &dB, queue ));
@@ -396,6 +405,15 @@ magma_zmtransposeconjugate(
     magma_zmfree( B, queue );
 
     if( A.storage_type == Magma_CSR && A.memory_location == Magma_DEV ) {
+#if defined(MAGMA_HAVE_HOST)
+        // no cuSPARSE: "device" memory is host memory, transpose on the CPU
+        CHECK( magma_zmtransfer( A, &ACSR, Magma_DEV, Magma_CPU, queue ));
+        CHECK( magma_zmtranspose_cpu( ACSR, &BCSR, queue ));
+        for( magma_int_t k=0; k < BCSR.nnz; k++ ) {
+            BCSR.val[k] = MAGMA_Z_CONJ( BCSR.val[k] );
+        }
+        CHECK( magma_zmtransfer( BCSR, B, Magma_CPU, Magma_DEV, queue ));
+#else
         // fill in information for B
         B->storage_type    = A.storage_type;
         B->diagorder_type  = A.diagorder_type;
@@ -436,6 +454,7 @@ magma_zmtransposeconjugate(
                           CUSPARSE_ACTION_NUMERIC,
                           CUSPARSE_INDEX_BASE_ZERO);
         CHECK( magma_zmconjugate( B, queue ));
+#endif
     } else if ( A.memory_location == Magma_CPU ){
         CHECK( magma_zmtransfer( A, &dA, A.memory_location, Magma_DEV, queue ));
         CHECK( magma_zmtransposeconjugate( dA, &dB, queue ));
@@ -57,7 +57,7 @@ magma_zparic_sweep(
     magmaDoubleComplex zero = MAGMA_Z_MAKE(0.0, 0.0);
     int il, iu, jl, ju;
 
-    #pragma omp parallel for
+    #pragma omp parallel for private(i, j, il, iu, jl, ju)
     for (int k=0; k < A.nnz; k++) {
         i = A.rowidx[k];
         j = A.col[k];
@@ -134,7 +134,7 @@ magma_zparic_sweep_sync(
     magmaDoubleComplex *L_new_val = NULL, *val_swap = NULL;
     CHECK( magma_zmalloc_cpu( &L_new_val, L->nnz ));
     
-    #pragma omp parallel for
+    #pragma omp parallel for private(i, j, il, iu, jl, ju)
     for (int k=0; k < A.nnz; k++) {
         i = A.rowidx[k];
         j = A.col[k];
@@ -177,3 +177,311 @@ cleanup:
     
     return info;
 }
+
+
+/******************************************************************************/
+// Sum of |a_ij - (LL^T)_ij|^2 over the entries of A, computed as in the
+// sweeps but without updating L; all threads see the same factor.
+static double
+zparic_residual_sync(
+    magma_z_matrix A,
+    magma_z_matrix L )
+{
+    double sum = 0.0;
+    #pragma omp parallel for reduction(+:sum)
+    for (magma_int_t k=0; k < A.nnz; k++) {
+        magma_int_t i = A.rowidx[k];
+        magma_int_t j = A.col[k];
+        magma_int_t il = L.row[i];
+        magma_int_t iu = L.row[j];
+        magma_int_t jl, ju;
+        magmaDoubleComplex s = A.val[k], sp = MAGMA_Z_ZERO, r;
+
+        while (il < L.row[i+1] && iu < L.row[j+1])
+        {
+            sp = MAGMA_Z_ZERO;
+            jl = L.col[il];
+            ju = L.col[iu];
+
+            // avoid branching
+            sp = ( jl == ju ) ? L.val[il] * L.val[iu] : sp;
+            s = ( jl == ju ) ? s-sp : s;
+            il = ( jl <= ju ) ? il+1 : il;
+            iu = ( jl >= ju ) ? iu+1 : iu;
+        }
+        // undo the last operation (it must be the last)
+        s += sp;
+
+        if ( i > j ) {
+            r = s - L.val[il-1] * L.val[L.row[j+1]-1];
+        }
+        else {
+            r = s - L.val[iu-1] * L.val[iu-1];
+        }
+        sum += MAGMA_Z_REAL(r) * MAGMA_Z_REAL(r)
+             + MAGMA_Z_IMAG(r) * MAGMA_Z_IMAG(r);
+    }
+    return sum;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    This function does asynchronous ParIC sweeps (symmetric case) until
+    convergence.
+    Each thread updates a fixed part of the entries in place, sweep after
+    sweep, without synchronizing with the other threads
+    (Gauss-Seidel-like), so fast threads use the newest values of slow ones.
+
+    The residual a_ij - (LL^T)_ij of each entry is a byproduct of its update,
+    so the residual norm of each pass over the entries of a thread costs
+    nothing extra. After each pass, a thread compares the sum of the latest
+    passes of all threads (an estimate, as passes overlap) with the
+    tolerance, and once converged, lowers the number of sweeps of all
+    threads to its own.
+
+    As passes overlap, the estimate may miss updates of other threads
+    after a pass, so a converged estimate is confirmed by a synchronized
+    pass that computes the residual without updating the factors. If the
+    residual is still too large, the asynchronous sweeps continue.
+
+    The last sweep of each thread starts only after all other threads did
+    that many sweeps, so no part of the factors is left computed from old
+    values of a slower thread; fast threads may do more sweeps meanwhile.
+
+    The sweeps stop once the nonlinear residual ||A - LL^T||_F on the
+    pattern of A is at most max( atol, rtol * res0 ), with res0 the
+    estimated residual of the first sweep, or after maxsweeps sweeps.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                System matrix in COO.
+
+    @param[in,out]
+    L           magma_z_matrix*
+                Current approximation for the lower triangular factor
+                The format is sorted CSR.
+
+    @param[in]
+    maxsweeps   magma_int_t
+                Maximum number of sweeps.
+
+    @param[in]
+    atol        double
+                Absolute residual stopping criterion.
+
+    @param[in]
+    rtol        double
+                Relative residual stopping criterion.
+
+    @param[out]
+    sweeps      magma_int_t*
+                Number of sweeps done by all threads. Without convergence,
+                at least maxsweeps (exactly, for one thread).
+
+    @param[out]
+    res0        double*
+                Estimated residual in the first sweep.
+
+    @param[out]
+    res         double*
+                Residual after the last sweep; computed exactly if the
+                sweeps converged, else estimated.
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+*******************************************************************************/
+
+extern "C" magma_int_t
+magma_zparic_sweep_async(
+    magma_z_matrix A,
+    magma_z_matrix *L,
+    magma_int_t maxsweeps,
+    double atol,
+    double rtol,
+    magma_int_t *sweeps,
+    double *res0,
+    double *res,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_int_t num_threads = 1, team = 1;
+    magma_int_t *count = NULL;
+    double *first = NULL, *last = NULL;
+    magma_int_t limit = maxsweeps, done = 0;
+    double tol = -1.0;
+    bool converged = false;
+
+    *sweeps = 0;
+    *res0 = 0.0;
+    *res = 0.0;
+    if ( maxsweeps <= 0 ) {
+        goto cleanup;
+    }
+
+    #ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    #endif
+    CHECK( magma_imalloc_cpu( &count, num_threads ));
+    CHECK( magma_dmalloc_cpu( &first, num_threads ));
+    CHECK( magma_dmalloc_cpu( &last, num_threads ));
+
+    // asynchronous sweeps until the estimate converges, then a synchronized
+    // residual pass; repeated while that residual is too large
+    while ( done < maxsweeps ) {
+        for (magma_int_t t=0; t < num_threads; t++) {
+            count[t] = 0;
+            first[t] = 0.0;
+            last[t] = 0.0;
+        }
+        limit = maxsweeps - done;
+        converged = false;
+
+        #pragma omp parallel num_threads(num_threads)
+        {
+            magma_int_t t = 0, nt = 1;
+            #ifdef _OPENMP
+            t = omp_get_thread_num();
+            nt = omp_get_num_threads();
+            #endif
+            if ( t == 0 ) {
+                team = nt;
+            }
+            magma_int_t kbegin = magma_int_t( int64_t( A.nnz ) * t / nt );
+            magma_int_t kend   = magma_int_t( int64_t( A.nnz ) * (t+1) / nt );
+
+            for (magma_int_t sweep=0; ; sweep++) {
+                // the last sweep of a thread starts after all other threads
+                // did limit sweeps, so it uses their final values
+                magma_int_t lim;
+                #pragma omp atomic read
+                lim = limit;
+                bool final = false;
+                if ( sweep+1 >= lim ) {
+                    final = true;
+                    for (magma_int_t u=0; u < nt; u++) {
+                        magma_int_t c;
+                        #pragma omp atomic read
+                        c = count[u];
+                        final = final && ( u == t || c >= lim );
+                    }
+                }
+
+                double sum = 0.0;
+                for (magma_int_t k=kbegin; k < kend; k++) {
+                    magma_int_t i = A.rowidx[k];
+                    magma_int_t j = A.col[k];
+                    magma_int_t il = L->row[i];
+                    magma_int_t iu = L->row[j];
+                    magma_int_t jl, ju;
+                    magmaDoubleComplex s = A.val[k], sp = MAGMA_Z_ZERO, r;
+
+                    while (il < L->row[i+1] && iu < L->row[j+1])
+                    {
+                        sp = MAGMA_Z_ZERO;
+                        jl = L->col[il];
+                        ju = L->col[iu];
+
+                        // avoid branching
+                        sp = ( jl == ju ) ? L->val[il] * L->val[iu] : sp;
+                        s = ( jl == ju ) ? s-sp : s;
+                        il = ( jl <= ju ) ? il+1 : il;
+                        iu = ( jl >= ju ) ? iu+1 : iu;
+                    }
+                    // undo the last operation (it must be the last)
+                    s += sp;
+
+                    if ( i > j ) {    // modify l entry
+                        magmaDoubleComplex ljj = L->val[L->row[j+1]-1];
+                        r = s - L->val[il-1] * ljj;
+                        L->val[il-1] = s / ljj;
+                    }
+                    else {            // modify diagonal entry
+                        r = s - L->val[iu-1] * L->val[iu-1];
+                        L->val[iu-1] = MAGMA_Z_MAKE( sqrt( fabs( MAGMA_Z_REAL(s) )), 0.0 );
+                    }
+                    sum += MAGMA_Z_REAL(r) * MAGMA_Z_REAL(r)
+                         + MAGMA_Z_IMAG(r) * MAGMA_Z_IMAG(r);
+                }
+
+                if ( sweep == 0 ) {
+                    #pragma omp atomic write
+                    first[t] = sum;
+                }
+                #pragma omp atomic write
+                last[t] = sum;
+                #pragma omp atomic write
+                count[t] = sweep+1;
+
+                // convergence test on the latest passes of all threads
+                bool all = true;
+                double f = 0.0, l = 0.0;
+                for (magma_int_t u=0; u < nt; u++) {
+                    magma_int_t c;
+                    double fu, lu;
+                    #pragma omp atomic read
+                    c = count[u];
+                    #pragma omp atomic read
+                    fu = first[u];
+                    #pragma omp atomic read
+                    lu = last[u];
+                    all = all && c > 0;
+                    f += fu;
+                    l += lu;
+                }
+                // tol is from the first sweeps of the first round
+                double thr = ( tol >= 0.0 ? tol : max( atol, rtol * sqrt( f )));
+                if ( all && sqrt( l ) <= thr ) {
+                    // converged: no thread needs more sweeps than this one
+                    #pragma omp critical (zparic_async_limit)
+                    {
+                        converged = true;
+                        if ( sweep+1 < limit ) {
+                            #pragma omp atomic write
+                            limit = sweep+1;
+                        }
+                    }
+                }
+                if ( final ) {
+                    break;
+                }
+            }
+        }
+
+        magma_int_t nsweeps = count[0];
+        double f = 0.0, l = 0.0;
+        for (magma_int_t t=0; t < team; t++) {
+            nsweeps = min( nsweeps, count[t] );
+            f += first[t];
+            l += last[t];
+        }
+        if ( done == 0 ) {
+            *res0 = sqrt( f );
+            tol = max( atol, rtol * (*res0) );
+        }
+        done += nsweeps;
+        *res = sqrt( l );
+        if ( ! converged ) {
+            break;
+        }
+        *res = sqrt( zparic_residual_sync( A, *L ) );
+        if ( *res <= tol ) {
+            break;
+        }
+    }
+    *sweeps = done;
+
+cleanup:
+    magma_free_cpu( count );
+    magma_free_cpu( first );
+    magma_free_cpu( last );
+    return info;
+}
@@ -17,7 +17,8 @@
     -------
 
     Computes the Frobenius norm of the difference between the CSR matrices A
-    and B. They need to share the same sparsity pattern!
+    and B on the sparsity pattern of A. They need to share the same sparsity
+    pattern! Uses magma_zmdiff_merge.
 
 
     Arguments
@@ -49,27 +50,14 @@ magma_zfrobenius(
     real_Double_t *res,
     magma_queue_t queue )
 {
-    real_Double_t tmp2;
-    magma_int_t i,j,k;
-    *res = 0.0;
+    magma_int_t info = 0;
+    real_Double_t sums[3];
     
-    for(i=0; i<A.num_rows; i++){
-        for(j=A.row[i]; j<A.row[i+1]; j++){
-            magma_index_t localcol = A.col[j];
-            for( k=B.row[i]; k<B.row[i+1]; k++){
-                if(B.col[k] == localcol){
-                    tmp2 = (real_Double_t) fabs( MAGMA_Z_REAL(A.val[j] )
-                                                    - MAGMA_Z_REAL(B.val[k]) );
-
-                    (*res) = (*res) + tmp2* tmp2;
-                }
-            }
-        }
-    }
-
-    (*res) =  sqrt((*res));
+    CHECK( magma_zmdiff_merge( A, &B, MagmaFalse, sums, queue ));
+    *res = sqrt( sums[0] + sums[1] );
 
-    return MAGMA_SUCCESS;
+cleanup:
+    return info;
 }
 
 
@@ -79,7 +67,9 @@ magma_zfrobenius(
     -------
 
     Computes the nonlinear residual A - LU and returns the difference as
-    well es the Frobenius norm of the difference
+    well es the Frobenius norm of the difference on the sparsity pattern of A.
+    LU is computed with magma_z_spmm, and compared to A with
+    magma_zmdiff_merge.
 
 
     Arguments
@@ -123,62 +113,25 @@ magma_znonlinres(
 {
     magma_int_t info = 0;
 
-    real_Double_t tmp2;
-    magma_int_t i,j,k;
+    real_Double_t sums[3];
         
     magmaDoubleComplex one = MAGMA_Z_MAKE( 1.0, 0.0 );
 
-    magma_z_matrix dL={Magma_CSR}, dU={Magma_CSR}, dLU={Magma_CSR}, A_t={Magma_CSR};
-    
     // make sure the target structure is empty
     magma_zmfree( LU, queue );
 
-    CHECK( magma_zmtransfer( L, &dL, Magma_CPU, Magma_DEV, queue  ));
-    CHECK( magma_zmtransfer( U, &dU, Magma_CPU, Magma_DEV, queue  ));
-    CHECK( magma_zmtransfer( A, &A_t, Magma_CPU, Magma_CPU, queue  ));
-    CHECK( magma_z_spmm( one, dL, dU, &dLU, queue ));
-
-    CHECK( magma_zmtransfer(dLU, LU, Magma_DEV, Magma_CPU, queue ));
-    magma_zmfree( &dL, queue  );
-    magma_zmfree( &dU, queue  );
-    magma_zmfree( &dLU, queue  );
-
-    // compute Frobenius norm of A-LU
-    for(i=0; i<A.num_rows; i++){
-        for(j=A.row[i]; j<A.row[i+1]; j++){
-            magma_index_t lcol = A.col[j];
-            magmaDoubleComplex newval = MAGMA_Z_MAKE(0.0, 0.0);
-            for(k=LU->row[i]; k<LU->row[i+1]; k++){
-                if( LU->col[k] == lcol ){
-                    newval = MAGMA_Z_MAKE(
-                        MAGMA_Z_REAL( LU->val[k] )- MAGMA_Z_REAL( A.val[j] )
-                                                , 0.0 );
-                }
-            }
-            A_t.val[j] = newval;
-        }
-    }
+    CHECK( magma_z_spmm( one, L, U, LU, queue ));
 
-    for(i=0; i<A.num_rows; i++){
-        for(j=A.row[i]; j<A.row[i+1]; j++){
-            tmp2 = (real_Double_t) fabs( MAGMA_Z_REAL(A_t.val[j]) );
-            (*res) = (*res) + tmp2* tmp2;
-        }
-    }
+    // compute Frobenius norm of A-LU on the pattern of A
+    CHECK( magma_zmdiff_merge( A, LU, MagmaFalse, sums, queue ));
+    *res = sqrt( sums[0] + sums[1] );
 
     magma_zmfree( LU, queue  );
-    magma_zmfree( &A_t, queue  );
-
-    (*res) =  sqrt((*res));
     
 cleanup:
     if( info !=0 ){
         magma_zmfree( LU, queue  );
     }
-    magma_zmfree( &A_t, queue  );
-    magma_zmfree( &dL, queue  );
-    magma_zmfree( &dU, queue  );
-    magma_zmfree( &dLU, queue  );
     return info;
 }
 
@@ -187,7 +140,10 @@ cleanup:
     -------
 
     Computes the ILU residual A - LU and returns the difference as
-    well es the Frobenius norm of the difference
+    well es the Frobenius norm of the difference, and the nonlinear residual,
+    which is the Frobenius norm of the difference on the sparsity pattern
+    of A. LU is computed with magma_z_spmm, and compared to A with
+    magma_zmdiff_merge.
 
 
     Arguments
@@ -236,13 +192,12 @@ magma_zilures(
 {
     magma_int_t info = 0;
 
-    magmaDoubleComplex tmp;
-    real_Double_t tmp2;
-    magma_int_t i, j, k;
+    real_Double_t sums[3];
+    magma_int_t i, j;
     
     magmaDoubleComplex one = MAGMA_Z_MAKE( 1.0, 0.0 );
 
-    magma_z_matrix LL={Magma_CSR}, dL={Magma_CSR}, dU={Magma_CSR}, dLU={Magma_CSR};
+    magma_z_matrix LL={Magma_CSR};
     
     // make sure the target structure is empty
     magma_zmfree( LU, queue );
@@ -279,42 +234,14 @@ magma_zilures(
         printf("error: L neither lower nor strictly lower triangular!\n");
     }
 
-    CHECK( magma_zmtransfer( LL, &dL, Magma_CPU, Magma_DEV, queue  ));
-    CHECK( magma_zmtransfer( U, &dU, Magma_CPU, Magma_DEV, queue  ));
+    CHECK( magma_z_spmm( one, LL, U, LU, queue ));
     magma_zmfree( &LL, queue );
-    CHECK( magma_z_spmm( one, dL, dU, &dLU, queue ));
-
-
-
-    CHECK( magma_zmtransfer(dLU, LU, Magma_DEV, Magma_CPU, queue ));
-    magma_zmfree( &dL, queue );
-    magma_zmfree( &dU, queue );
-    magma_zmfree( &dLU, queue );
-
-    // compute Frobenius norm of A-LU
-    for(i=0; i<A.num_rows; i++){
-        for(j=A.row[i]; j<A.row[i+1]; j++){
-            magma_index_t lcol = A.col[j];
-            for(k=LU->row[i]; k<LU->row[i+1]; k++){
-                if( LU->col[k] == lcol ){
-                    tmp = MAGMA_Z_MAKE(
-                        MAGMA_Z_REAL( LU->val[k] )- MAGMA_Z_REAL( A.val[j] )
-                                                , 0.0 );
-                    LU->val[k] = tmp;
-
-                    tmp2 = (real_Double_t) fabs( MAGMA_Z_REAL(tmp) );
-                    (*nonlinres) = (*nonlinres) + tmp2*tmp2;
-                }
-            }
-        }
-    }
 
-    for(i=0; i<LU->num_rows; i++){
-        for(j=LU->row[i]; j<LU->row[i+1]; j++){
-            tmp2 = (real_Double_t) fabs( MAGMA_Z_REAL(LU->val[j]) );
-            (*res) = (*res) + tmp2* tmp2;
-        }
-    }
+    // overwrite LU with LU-A, and compute Frobenius norms of A-LU,
+    // on all entries and on the pattern of A
+    CHECK( magma_zmdiff_merge( A, LU, MagmaTrue, sums, queue ));
+    *res       = sums[0] + sums[1] + sums[2];
+    *nonlinres = sums[0] + sums[1];
 
     (*res) =  sqrt((*res));
     (*nonlinres) =  sqrt((*nonlinres));
@@ -324,9 +251,6 @@ cleanup:
         magma_zmfree( LU, queue  );
     }
     magma_zmfree( &LL, queue );
-    magma_zmfree( &dL, queue  );
-    magma_zmfree( &dU, queue  );
-    magma_zmfree( &dLU, queue  );
     return info;
 }
 
@@ -386,51 +310,23 @@ magma_zicres(
 {
     magma_int_t info = 0;
     
-    magmaDoubleComplex tmp;
-    real_Double_t tmp2;
-    magma_int_t i,j,k;
+    real_Double_t sums[3];
 
     magmaDoubleComplex one = MAGMA_Z_MAKE( 1.0, 0.0 );
     
-    magma_z_matrix dL={Magma_CSR}, dU={Magma_CSR}, dLU={Magma_CSR};
-    
     // make sure the target structure is empty
     magma_zmfree( LU, queue );
     
     *res = 0.0;
     *nonlinres = 0.0;
 
-    CHECK( magma_zmtransfer( C, &dL, Magma_CPU, Magma_DEV, queue ));
-    CHECK( magma_zmtransfer( CT, &dU, Magma_CPU, Magma_DEV, queue ));
-    CHECK( magma_z_spmm( one, dL, dU, &dLU, queue ));
-    CHECK( magma_zmtransfer(dLU, LU, Magma_DEV, Magma_CPU, queue ));
-
-    magma_zmfree( &dLU, queue );
-
-    // compute Frobenius norm of A-LU
-    for(i=0; i<A.num_rows; i++){
-        for(j=A.row[i]; j<A.row[i+1]; j++){
-            magma_index_t lcol = A.col[j];
-            for(k=LU->row[i]; k<LU->row[i+1]; k++){
-                if( LU->col[k] == lcol ){
-                    tmp = MAGMA_Z_MAKE(
-                        MAGMA_Z_REAL( LU->val[k] )- MAGMA_Z_REAL( A.val[j] )
-                                                , 0.0 );
-                    LU->val[k] = tmp;
-
-                    tmp2 = (real_Double_t) fabs( MAGMA_Z_REAL(tmp) );
-                    (*nonlinres) = (*nonlinres) + tmp2*tmp2;
-                }
-            }
-        }
-    }
+    CHECK( magma_z_spmm( one, C, CT, LU, queue ));
 
-    for(i=0; i<LU->num_rows; i++){
-        for(j=LU->row[i]; j<LU->row[i+1]; j++){
-            tmp2 = (real_Double_t) fabs( MAGMA_Z_REAL(LU->val[j]) );
-            (*res) = (*res) + tmp2* tmp2;
-        }
-    }
+    // overwrite LU with LU-A, and compute Frobenius norms of A-LU,
+    // on all entries and on the pattern of A
+    CHECK( magma_zmdiff_merge( A, LU, MagmaTrue, sums, queue ));
+    *res       = sums[0] + sums[1] + sums[2];
+    *nonlinres = sums[0] + sums[1];
 
 
     (*res) =  sqrt((*res));
@@ -440,9 +336,6 @@ cleanup:
     if( info !=0 ){
         magma_zmfree( LU, queue  );
     }
-    magma_zmfree( &dL, queue  );
-    magma_zmfree( &dU, queue  );
-    magma_zmfree( &dLU, queue  );
     return info;
 }
 
@@ -489,9 +382,8 @@ magma_zinitguess(
 
     magmaDoubleComplex one = MAGMA_Z_MAKE( 1.0, 0.0 );
     
-    magma_z_matrix hAL={Magma_CSR}, hAU={Magma_CSR}, dAL={Magma_CSR}, 
-    dAU={Magma_CSR}, dALU={Magma_CSR}, hALU={Magma_CSR}, hD={Magma_CSR}, 
-    dD={Magma_CSR}, dL={Magma_CSR}, hL={Magma_CSR};
+    magma_z_matrix hAL={Magma_CSR}, hAU={Magma_CSR}, hALU={Magma_CSR},
+    hD={Magma_CSR}, hL={Magma_CSR};
     magma_int_t i,j;
     
     magma_int_t offdiags = 0;
@@ -511,12 +403,8 @@ magma_zinitguess(
     //magma_zmconvert( A, &hAU, Magma_CSR, Magma_CSRU );
     CHECK( magma_z_cucsrtranspose(  hAL, &hAU, queue ));
     //magma_zmconvert( hAU, &hAUCOO, Magma_CSR, Magma_CSRCOO );
-    CHECK( magma_zmtransfer( hAL, &dAL, Magma_CPU, Magma_DEV, queue ));
-    CHECK( magma_z_spmm( one, dAL, dAU, &dALU, queue ));
-    CHECK( magma_zmtransfer( dALU, &hALU, Magma_DEV, Magma_CPU, queue ));
-
-    magma_zmfree( &dAU, queue);
-    magma_zmfree( &dALU, queue);
+    CHECK( magma_z_spmm( one, hAL, hAU, &hALU, queue ));
+    magma_zmfree( &hAU, queue);
 
 
     CHECK( magma_zmalloc_cpu( &diag_vals, offdiags+1 ));
@@ -524,7 +412,6 @@ magma_zinitguess(
     diag_offset[0] = 0;
     diag_vals[0] = MAGMA_Z_MAKE( 1.0, 0.0 );
     CHECK( magma_zmgenerator( hALU.num_rows, offdiags, diag_offset, diag_vals, &hD, queue ));
-    magma_zmfree( &hALU, queue );
 
     
     for(i=0; i<hALU.num_rows; i++){
@@ -539,12 +426,11 @@ magma_zinitguess(
     }
 
 
-    CHECK( magma_zmtransfer( hD, &dD, Magma_CPU, Magma_DEV, queue ));
-    magma_zmfree( &hD, queue);
+    magma_zmfree( &hALU, queue );
 
-    CHECK( magma_z_spmm( one, dD, dAL, &dL, queue ));
-    magma_zmfree( &dAL, queue );
-    magma_zmfree( &dD, queue );
+    CHECK( magma_z_spmm( one, hD, hAL, &hL, queue ));
+    magma_zmfree( &hAL, queue );
+    magma_zmfree( &hD, queue);
 
 
 
@@ -563,7 +449,6 @@ magma_zinitguess(
         }
     }
 */
-    CHECK( magma_zmtransfer( dL, &hL, Magma_DEV, Magma_CPU, queue ));
     CHECK( magma_zmconvert( hL, L, Magma_CSR, Magma_CSRCOO, queue ));
 
 
@@ -573,14 +458,11 @@ cleanup:
         magma_zmfree( L, queue  );
         magma_zmfree( U, queue  );
     }
-    magma_zmfree( &dAU, queue);
-    magma_zmfree( &dALU, queue);
-    magma_zmfree( &dL, queue );
+    magma_zmfree( &hAL, queue );
+    magma_zmfree( &hAU, queue );
+    magma_zmfree( &hALU, queue );
     magma_zmfree( &hL, queue );
-    magma_zmfree( &dAL, queue );
-    magma_zmfree( &dD, queue );
     magma_zmfree( &hD, queue);
-    magma_zmfree( &hALU, queue );
     return info;
 }
 
@@ -718,3 +600,147 @@ cleanup:
     magma_zmfree( &LL, queue );
     return info;
 }
+
+
+
+/**
+    Purpose
+    -------
+
+    Copies the values of A into the matrix B, whose sparsity pattern contains
+    the pattern of A (uplo = MagmaFull), or of the lower triangular part of A
+    (uplo = MagmaLower), e.g., the pattern of an ILU(k) factorization of A.
+    Entries of B not in A are set to zero. This updates the values of a
+    factorization pattern without recomputing the pattern.
+    The columns in each row of A and B have to be sorted.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                sparse matrix in CSR on the CPU
+
+    @param[in]
+    uplo        magma_uplo_t
+                MagmaFull or MagmaLower: part of A to copy
+
+    @param[in,out]
+    B           magma_z_matrix*
+                sparse matrix in CSR or CSRCOO on the CPU;
+                on exit, contains the values of A
+                
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @return     MAGMA_ERR_ILLEGAL_VALUE if an entry of A is not in the
+                pattern of B.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+magma_int_t
+magma_zmrefill(
+    magma_z_matrix A,
+    magma_uplo_t uplo,
+    magma_z_matrix *B,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t missing = 0;
+
+    if ( A.num_rows != B->num_rows || A.num_cols != B->num_cols ) {
+        info = MAGMA_ERR_ILLEGAL_VALUE;
+        goto cleanup;
+    }
+
+    magma_zmprofile_forget( B, queue );
+    #pragma omp parallel for reduction(+:missing)
+    for( magma_int_t i=0; i<A.num_rows; i++ ){
+        magma_int_t k = B->row[i];
+        for( magma_int_t j=B->row[i]; j<B->row[i+1]; j++ ){
+            B->val[j] = MAGMA_Z_ZERO;
+        }
+        for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+            if ( uplo == MagmaLower && A.col[j] > i ) {
+                break;
+            }
+            while ( k < B->row[i+1] && B->col[k] < A.col[j] ) {
+                k++;
+            }
+            if ( k < B->row[i+1] && B->col[k] == A.col[j] ) {
+                B->val[k] = A.val[j];
+            } else {
+                missing++;
+            }
+        }
+    }
+    if ( missing > 0 ) {
+        info = MAGMA_ERR_ILLEGAL_VALUE;
+    }
+
+cleanup:
+    return info;
+}
+
+
+
+/**
+    Purpose
+    -------
+
+    Computes the values of the transpose of the CSR matrix A, in the order
+    of A^T in CSR with sorted columns, as returned by magma_z_cucsrtranspose.
+    The pattern of A^T is not formed, which makes this cheaper than a
+    transpose when only the values of A change.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                sparse matrix in CSR on the CPU
+
+    @param[out]
+    val         magmaDoubleComplex*
+                array of length A.nnz for the values of A^T
+                
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+magma_int_t
+magma_zmtranspose_values(
+    magma_z_matrix A,
+    magmaDoubleComplex *val,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_index_t *ptr = NULL;
+
+    CHECK( magma_index_malloc_cpu( &ptr, A.num_cols+1 ));
+    for( magma_int_t j=0; j<=A.num_cols; j++ ){
+        ptr[j] = 0;
+    }
+    for( magma_int_t k=0; k<A.nnz; k++ ){
+        ptr[ A.col[k]+1 ]++;
+    }
+    for( magma_int_t j=0; j<A.num_cols; j++ ){
+        ptr[j+1] += ptr[j];
+    }
+    // rows of A in increasing order keep the columns of A^T sorted
+    for( magma_int_t i=0; i<A.num_rows; i++ ){
+        for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+            val[ ptr[ A.col[k] ]++ ] = A.val[k];
+        }
+    }
+
+cleanup:
+    magma_free_cpu( ptr );
+    return info;
+}
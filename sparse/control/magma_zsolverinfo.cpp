@@ -657,7 +657,7 @@ magma_zeigensolverinfo_init(
         CHECK( magma_zmalloc_cpu( &initial_guess, ev ));
         CHECK( magma_zmalloc( &solver_par->eigenvectors, ev ));
         magma_int_t ISEED[4] = {0,0,0,1}, ione = 1;
-        lapackf77_zlarnv( &ione, ISEED, &ev, initial_guess );
+        magma_zlarnv( ione, ISEED, ev, initial_guess );
 
         magma_zsetmatrix( solver_par->ev_length, solver_par->num_eigenvalues,
             initial_guess, solver_par->ev_length, solver_par->eigenvectors,
@@ -11,7 +11,6 @@
 
        Utilities for testing MAGMA-sparse.
 */
-#include <cuda_runtime_api.h>
 
 #include "magmasparse_internal.h"
 
@@ -28,6 +27,8 @@ static const char *usage_sparse =
 "               BAITER, IDR, PIDR, CGS, PCGS, TFQMR, PTFQMR, QMR, PQMR, BICG,\n"
 "               PBICG, BOMBARDMENT, ITERREF.\n"
 " --basic       Use non-optimized version\n"
+" --cpu         Solve on the CPU, with A and the vectors in host memory:\n"
+"               CG, PCG, BICGSTAB, PBICGSTAB.\n"
 " --ev x        For eigensolvers, set number of eigenvalues/eigenvectors to compute.\n"
 " --restart     For GMRES: possibility to choose the restart.\n"
 "               For IDR: Number of distinct subspaces (1,2,4,8).\n"
@@ -42,9 +43,11 @@ static const char *usage_sparse =
 " --mscale      Possibility to scale the original matrix:\n"
 "               NOSCALE   no scaling\n"
 "               UNITDIAG   symmetric scaling to unit diagonal\n"
+"               UNITROW    symmetric scaling to unit rownorm\n"
+"               RUIZ       Ruiz equilibration of rows and columns\n"
 " --precond x   Possibility to choose a preconditioner:\n"
-"               CG, BICGSTAB, GMRES, LOBPCG, JACOBI,\n"
-"               BAITER, IDR, CGS, TFQMR, QMR, BICG\n"
+"               CG, BICGSTAB, GMRES, LOBPCG, JACOBI, VBJACOBI (CPU),\n"
+"               SCHWARZ (CPU), BAITER, IDR, CGS, TFQMR, QMR, BICG\n"
 "               BOMBARDMENT, ITERREF, ILU, PARILU, PARILUT, NONE.\n"
 "                   --patol atol  Absolute residual stopping criterion for preconditioner.\n"
 "                   --prtol rtol  Relative residual stopping criterion for preconditioner.\n"
@@ -53,9 +56,16 @@ static const char *usage_sparse =
 "                   --triolver k  Solver for triangular ILU factors: e.g. CUSOLVE, JACOBI, ISAI.\n"
 "                   --ppattern k  Pattern used for ISAI preconditioner.\n"
 "                   --psweeps x   Number of iterative ParILU sweeps.\n"
+"                   --preuse k    Keep the ParILU/ParIC pattern for refactorization (0/1).\n"
+"                   --pverbose k  Print the ParILU/ParIC residual every k sweeps.\n"
+"                   --pasync k    Asynchronous ParILU/ParIC sweeps, stopping on --patol/--prtol (0/1).\n"
+"                   --psubsolver  Subdomain factorization for SCHWARZ: ILU or PARILUT.\n"
+"                                 --plevels gives the number of subdomains (0: threads),\n"
+"                                 --ppattern the overlap layers.\n"
 " --trisolver   Possibility to choose a triangular solver for ILU preconditioning: \n"
 "               e.g. CUSOLVE, ISPTRSV, JACOBI, VBJACOBI, ISAI.\n"
 " --ppattern k  Possibility to choose a pattern for the trisolver: ISAI(k) or Block Jacobi.\n"
+"               For VBJACOBI, the largest diagonal block size.\n"
 " --piters k    Number of preconditioner relaxation steps, e.g. for ISAI or (Block) Jacobi trisolver.\n"
 " --patol x     Set an absolute residual stopping criterion for the preconditioner.\n"
 "                      Corresponds to the relative fill-in in PARILUT.\n"
@@ -113,6 +123,7 @@ magma_zparse_opts(
     opts->output_format = Magma_CSR;
     opts->input_location = Magma_CPU;
     opts->output_location = Magma_CPU;
+    opts->compute_location = Magma_DEV;
     opts->scaling = Magma_NOSCALE;
     #if defined(PRECISION_z) | defined(PRECISION_d)
         opts->solver_par.atol = 1e-16;
@@ -141,13 +152,20 @@ magma_zparse_opts(
     opts->precond_par.sweeps = 5;
     opts->precond_par.maxiter = 1;
     opts->precond_par.pattern = 1;
+    opts->precond_par.reuse = MagmaFalse;
+    opts->precond_par.verbose = 0;
+    opts->precond_par.async = MagmaFalse;
+    opts->precond_par.subsolver = Magma_ILU;
+    {
+        magma_z_matrix empty={Magma_CSR};
+        opts->precond_par.hA = empty;
+        opts->precond_par.hL = empty;
+        opts->precond_par.hU = empty;
+    }
     opts->solver_par.solver = Magma_CGMERGE;
     
     printf( usage_sparse_short, argv[0] );
     
-    int ndevices;
-    cudaGetDeviceCount( &ndevices );
-    
     int basic = 0;
 
     for( int i = 1; i < argc; ++i ) {
@@ -186,6 +204,9 @@ magma_zparse_opts(
             else if ( strcmp("UNITROWCOL", argv[i]) == 0 ) {
                 opts->scaling = Magma_UNITROWCOL;
             }
+            else if ( strcmp("RUIZ", argv[i]) == 0 ) {
+                opts->scaling = Magma_RUIZ;
+            }
             else {
                 printf( "%%error: invalid scaling, use default.\n" );
             }
@@ -300,6 +321,12 @@ magma_zparse_opts(
             else if ( strcmp("JACOBI", argv[i]) == 0 ) {
                 opts->precond_par.solver = Magma_JACOBI;
             }
+            else if ( strcmp("VBJACOBI", argv[i]) == 0 ) {
+                opts->precond_par.solver = Magma_VBJACOBI;
+            }
+            else if ( strcmp("SCHWARZ", argv[i]) == 0 ) {
+                opts->precond_par.solver = Magma_SCHWARZ;
+            }
             else if ( strcmp("BA", argv[i]) == 0 ) {
                 opts->precond_par.solver = Magma_BAITER;
             }
@@ -409,6 +436,8 @@ magma_zparse_opts(
             }
         } else if ( strcmp("--basic", argv[i]) == 0 && i+1 < argc ) {
             basic = 1;
+        } else if ( strcmp("--cpu", argv[i]) == 0 && i+1 < argc ) {
+            opts->compute_location = Magma_CPU;
         } else if ( strcmp("--prestart", argv[i]) == 0 && i+1 < argc ) {
             opts->precond_par.restart = atoi( argv[++i] );
         } else if ( strcmp("--patol", argv[i]) == 0 && i+1 < argc ) {
@@ -423,6 +452,23 @@ magma_zparse_opts(
             opts->precond_par.sweeps = atoi( argv[++i] );
         } else if ( strcmp("--plevels", argv[i]) == 0 && i+1 < argc ) {
             opts->precond_par.levels = atoi( argv[++i] );
+        } else if ( strcmp("--preuse", argv[i]) == 0 && i+1 < argc ) {
+            opts->precond_par.reuse = ( atoi( argv[++i] ) != 0 ) ? MagmaTrue : MagmaFalse;
+        } else if ( strcmp("--pverbose", argv[i]) == 0 && i+1 < argc ) {
+            opts->precond_par.verbose = atoi( argv[++i] );
+        } else if ( strcmp("--pasync", argv[i]) == 0 && i+1 < argc ) {
+            opts->precond_par.async = ( atoi( argv[++i] ) != 0 ) ? MagmaTrue : MagmaFalse;
+        } else if ( strcmp("--psubsolver", argv[i]) == 0 && i+1 < argc ) {
+            i++;
+            if ( strcmp("ILU", argv[i]) == 0 ) {
+                opts->precond_par.subsolver = Magma_ILU;
+            }
+            else if ( strcmp("PARILUT", argv[i]) == 0 ) {
+                opts->precond_par.subsolver = Magma_PARILUT;
+            }
+            else {
+                printf( "%%error: invalid subdomain solver.\n" );
+            }
         } else if ( strcmp("--blocksize", argv[i]) == 0 && i+1 < argc ) {
             opts->blocksize = atoi( argv[++i] );
         } else if ( strcmp("--alignment", argv[i]) == 0 && i+1 < argc ) {
@@ -99,7 +99,11 @@ magma_zvinit(
     }
     else if ( mem_loc == Magma_DEV ) {
         CHECK( magma_zmalloc( &x->val, x->nnz ));
+        #if defined(MAGMA_HAVE_HOST)
+        lapackf77_zlaset( "F", &x->num_rows, &x->num_cols, &values, &values, x->val, &x->ld );
+        #else
         magmablas_zlaset( MagmaFull, x->num_rows, x->num_cols, values, values, x->val, x->num_rows, queue );
+        #endif
     }
     
 cleanup:
@@ -113,7 +117,7 @@ cleanup:
     -------
 
     Allocates memory for magma_z_matrix and initializes it
-    with random values.
+    with random values, uniform in (-1,1), from magma_zlarnv.
 
 
     Arguments
@@ -186,13 +190,11 @@ magma_zvinit_rand(
     x->major = MagmaColMajor;
     x->ld = num_rows;
     if ( mem_loc == Magma_CPU ) {
-         /* Intializes random number generator */
-         srand((unsigned) 1);
-        
+        // uniform (-1,1), in parallel; same values for any number of threads
+        magma_int_t iseed[4] = { 0, 0, 0, 1 };
+        magma_int_t idist = 2;
         CHECK( magma_zmalloc_cpu( &x->val, x->nnz ));
-        for( magma_int_t i=0; i<x->nnz; i++) {
-             x->val[i] = MAGMA_Z_MAKE( ((double)(2*rand()))/ RAND_MAX - 1., ((double)(2*rand()))/ RAND_MAX - 1. );
-        }
+        magma_zlarnv( idist, iseed, x->nnz, x->val );
     }
     else if ( mem_loc == Magma_DEV ) {
         CHECK( magma_zvinit_rand( &x_h, Magma_CPU, num_rows, num_cols, queue ));
@@ -58,6 +58,17 @@ magma_zvtranspose(
         y->num_rows = x.num_rows;
         y->num_cols = x.num_cols;
         y->storage_type = x.storage_type;
+        #if defined(MAGMA_HAVE_HOST)
+        // device memory is host memory
+        if ( x.major == MagmaColMajor) {
+            y->major = MagmaRowMajor;
+            magma_ztranspose_cpu( m, n, x.val, m, y->val, n );
+        }
+        else {
+            y->major = MagmaColMajor;
+            magma_ztranspose_cpu( n, m, x.val, n, y->val, m );
+        }
+        #else
         if ( x.major == MagmaColMajor) {
             y->major = MagmaRowMajor;
             magmablas_ztranspose( m, n, x.val, m, y->val, n, queue );
@@ -66,6 +77,7 @@ magma_zvtranspose(
             y->major = MagmaColMajor;
             magmablas_ztranspose( n, m, x.val, n, y->val, m, queue );
         }
+        #endif
     } else {
         CHECK( magma_zmtransfer( x, &dx, Magma_CPU, Magma_DEV, queue ));
         CHECK( magma_zvtranspose( dx, &dy, queue ));
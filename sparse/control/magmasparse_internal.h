@@ -19,6 +19,34 @@ extern "C" {
 #endif
 
 
+#if defined(MAGMA_HAVE_HOST)
+// The host backend has no cuSPARSE. The status codes are kept so that
+// cusparse2magma_error and CHECK_CUSPARSE compile. The device branches
+// that use cuSPARSE are replaced by CPU code, so handles, descriptors,
+// and solve-analysis info are never created on the host, and destroying
+// them is a no-op.
+typedef enum {
+    CUSPARSE_STATUS_SUCCESS                   = 0,
+    CUSPARSE_STATUS_NOT_INITIALIZED           = 1,
+    CUSPARSE_STATUS_ALLOC_FAILED              = 2,
+    CUSPARSE_STATUS_INVALID_VALUE             = 3,
+    CUSPARSE_STATUS_ARCH_MISMATCH             = 4,
+    CUSPARSE_STATUS_MAPPING_ERROR             = 5,
+    CUSPARSE_STATUS_EXECUTION_FAILED          = 6,
+    CUSPARSE_STATUS_INTERNAL_ERROR            = 7,
+    CUSPARSE_STATUS_MATRIX_TYPE_NOT_SUPPORTED = 8,
+    CUSPARSE_STATUS_ZERO_PIVOT                = 9
+} cusparseStatus_t;
+
+typedef void* cusparseHandle_t;
+typedef void* cusparseMatDescr_t;
+
+#define cusparseDestroy(handle) ((void) (handle))
+#define cusparseDestroyMatDescr(descr) ((void) (descr))
+#define cusparseDestroySolveAnalysisInfo(info) ((void) (info))
+#endif
+
+
 magma_int_t cusparse2magma_error( cusparseStatus_t status );
 
 
@@ -22,7 +22,9 @@
 #endif
 
 // includes CUDA
+#if ! defined(MAGMA_HAVE_HOST)
 #include <cusparse_v2.h>
+#endif
 
 
 /* (author: Cade Brown <cbrow216@vols.utk.edu>
@@ -79,6 +81,31 @@ extern "C" {
 
 #define MAGMA_CSR5_OMEGA 32
 
+// row-length histogram bins of magma_matrix_profile:
+// bin 0 counts empty rows, bin k counts rows with 2^(k-1) <= length < 2^k
+#define MAGMA_PROFILE_BINS 32
+// SELL-P slice height and alignment assumed for the padding estimate
+#define MAGMA_PROFILE_SLICE 32
+
+typedef struct magma_matrix_profile
+{
+    magma_int_t        min_row;                 // shortest row
+    magma_int_t        max_row;                 // longest row
+    double             mean_row;                // mean row length
+    double             var_row;                 // variance of the row length
+    magma_int_t        hist[MAGMA_PROFILE_BINS]; // row-length histogram (log2 bins)
+    magma_int_t        empty_rows;              // rows without entries
+    magma_int_t        bandwidth;               // max |i-j| over all entries
+    magma_int_t        missing_diag;            // rows without (nonzero) diagonal entry
+    magma_int_t        dd_rows;                 // strictly diagonally dominant rows
+    double             dd_min;                  // min over rows of sum_j|a_ij| / |a_ii|, j != i
+    double             dd_max;                  // max of the same ratio (< 1: Jacobi converges)
+    double             dd_avg;                  // average of the same ratio
+    double             pattern_symmetry;        // fraction of off-diagonal (i,j) with (j,i) present
+    double             ell_padding;             // explicit zeros stored by ELL
+    double             sellp_padding;           // explicit zeros stored by SELL-P
+} magma_matrix_profile;
+
 typedef struct magma_z_matrix
 {
     magma_storage_t    storage_type;            // matrix format - CSR, ELL, SELL-P, CSR5
@@ -136,6 +163,7 @@ typedef struct magma_z_matrix
     union {
         magmaDoubleComplex       *calibrator;            // opt: CSR5 calibrator CPU case
         magmaDoubleComplex_ptr   dcalibrator;            // opt: CSR5 calibrator DEV case
+        size_t                   profile_id;             // opt: cached profile, not for CSR5 (see magma_zmprofile)
     };
     magma_index_t      *blockinfo;              // opt: for BCSR format CPU case
     magma_int_t        blocksize;               // opt: info for SELL-P/BCSR
@@ -152,6 +180,14 @@ typedef struct magma_z_matrix
     magma_int_t        ld;                      // opt: leading dimension for dense
 } magma_z_matrix;
 
+typedef struct magma_z_scaling
+{
+    magma_scale_t      scaling;                 // scaling type
+    magma_side_t       side;                    // scaled side(s)
+    magma_z_matrix     dr;                      // row factors, if any
+    magma_z_matrix     dc;                      // column factors, if any
+} magma_z_scaling;
+
 typedef struct magma_c_matrix
 {
     magma_storage_t    storage_type;            // matrix format - CSR, ELL, SELL-P, CSR5
@@ -209,6 +245,7 @@ typedef struct magma_c_matrix
     union {
         magmaFloatComplex        *calibrator;            // opt: CSR5 calibrator CPU case
         magmaFloatComplex_ptr    dcalibrator;            // opt: CSR5 calibrator DEV case
+        size_t                   profile_id;             // opt: cached profile, not for CSR5 (see magma_cmprofile)
     };
     magma_index_t      *blockinfo;              // opt: for BCSR format CPU case
     magma_int_t        blocksize;               // opt: info for SELL-P/BCSR
@@ -225,6 +262,14 @@ typedef struct magma_c_matrix
     magma_int_t        ld;                      // opt: leading dimension for dense
 } magma_c_matrix;
 
+typedef struct magma_c_scaling
+{
+    magma_scale_t      scaling;                 // scaling type
+    magma_side_t       side;                    // scaled side(s)
+    magma_c_matrix     dr;                      // row factors, if any
+    magma_c_matrix     dc;                      // column factors, if any
+} magma_c_scaling;
+
 
 typedef struct magma_d_matrix
 {
@@ -283,6 +328,7 @@ typedef struct magma_d_matrix
     union {
         double                   *calibrator;            // opt: CSR5 calibrator CPU case
         magmaDouble_ptr          dcalibrator;            // opt: CSR5 calibrator DEV case
+        size_t                   profile_id;             // opt: cached profile, not for CSR5 (see magma_dmprofile)
     };
     magma_index_t      *blockinfo;              // opt: for BCSR format CPU case
     magma_int_t        blocksize;               // opt: info for SELL-P/BCSR
@@ -299,6 +345,14 @@ typedef struct magma_d_matrix
     magma_int_t        ld;                      // opt: leading dimension for dense
 } magma_d_matrix;
 
+typedef struct magma_d_scaling
+{
+    magma_scale_t      scaling;                 // scaling type
+    magma_side_t       side;                    // scaled side(s)
+    magma_d_matrix     dr;                      // row factors, if any
+    magma_d_matrix     dc;                      // column factors, if any
+} magma_d_scaling;
+
 
 typedef struct magma_s_matrix
 {
@@ -357,6 +411,7 @@ typedef struct magma_s_matrix
     union {
         float                    *calibrator;            // opt: CSR5 calibrator CPU case
         magmaFloat_ptr           dcalibrator;            // opt: CSR5 calibrator DEV case
+        size_t                   profile_id;             // opt: cached profile, not for CSR5 (see magma_smprofile)
     };
     magma_index_t      *blockinfo;              // opt: for BCSR format CPU case
     magma_int_t        blocksize;               // opt: info for SELL-P/BCSR
@@ -373,6 +428,14 @@ typedef struct magma_s_matrix
     magma_int_t        ld;                      // opt: leading dimension for dense
 } magma_s_matrix;
 
+typedef struct magma_s_scaling
+{
+    magma_scale_t      scaling;                 // scaling type
+    magma_side_t       side;                    // scaled side(s)
+    magma_s_matrix     dr;                      // row factors, if any
+    magma_s_matrix     dc;                      // column factors, if any
+} magma_s_scaling;
+
 
 // for backwards compatability, make these aliases.
 typedef magma_s_matrix magma_s_sparse_matrix;
@@ -604,7 +667,10 @@ typedef struct magma_s_solver_par
 
 //************            preconditioner parameters       ********************//
 
-#if CUDA_VERSION < 11000
+#if defined(MAGMA_HAVE_HOST)
+    // no cuSPARSE; the analysis handles of the preconditioner are unused
+    #define magma_solve_info_t void*
+#elif CUDA_VERSION < 11000
     #define magma_solve_info_t cusparseSolveAnalysisInfo_t
 #else
     #define magma_solve_info_t csrsm2Info_t
@@ -667,6 +733,13 @@ typedef struct magma_z_preconditioner
     magma_solve_info_t cuinfoUT;
     
     magma_bool_t            transpose;                 // need the transpose for the solver?
+    magma_bool_t            reuse;                     // ParILU/ParIC (CPU): refactorize on the stored pattern
+    magma_int_t             verbose;                   // ParILU/ParIC (CPU): print residual every 'verbose' sweeps
+    magma_bool_t            async;                     // ParILU/ParIC (CPU): asynchronous sweeps, stopping on atol/rtol
+    magma_z_matrix          hA;                        // stored for reuse: A on the factor pattern, CSRCOO on CPU
+    magma_z_matrix          hL;                        // stored for reuse: L factor, CSR on CPU
+    magma_z_matrix          hU;                        // stored for reuse: U factor, CSC on CPU (U^T in CSR)
+    magma_solver_type       subsolver;                 // Schwarz (CPU): subdomain factorization, Magma_ILU or Magma_PARILUT
 #if defined(MAGMA_HAVE_PASTIX)
     pastix_data_t*          pastix_data;
     magma_int_t*            iparm;
@@ -729,6 +802,13 @@ typedef struct magma_c_preconditioner
     
     
     magma_bool_t            transpose;                 // need the transpose for the solver?
+    magma_bool_t            reuse;                     // ParILU/ParIC (CPU): refactorize on the stored pattern
+    magma_int_t             verbose;                   // ParILU/ParIC (CPU): print residual every 'verbose' sweeps
+    magma_bool_t            async;                     // ParILU/ParIC (CPU): asynchronous sweeps, stopping on atol/rtol
+    magma_c_matrix          hA;                        // stored for reuse: A on the factor pattern, CSRCOO on CPU
+    magma_c_matrix          hL;                        // stored for reuse: L factor, CSR on CPU
+    magma_c_matrix          hU;                        // stored for reuse: U factor, CSC on CPU (U^T in CSR)
+    magma_solver_type       subsolver;                 // Schwarz (CPU): subdomain factorization, Magma_ILU or Magma_PARILUT
 #if defined(MAGMA_HAVE_PASTIX)
     pastix_data_t*          pastix_data;
     magma_int_t*            iparm;
@@ -790,6 +870,13 @@ typedef struct magma_d_preconditioner
     magma_solve_info_t cuinfoUT;
     
     magma_bool_t            transpose;                 // need the transpose for the solver?
+    magma_bool_t            reuse;                     // ParILU/ParIC (CPU): refactorize on the stored pattern
+    magma_int_t             verbose;                   // ParILU/ParIC (CPU): print residual every 'verbose' sweeps
+    magma_bool_t            async;                     // ParILU/ParIC (CPU): asynchronous sweeps, stopping on atol/rtol
+    magma_d_matrix          hA;                        // stored for reuse: A on the factor pattern, CSRCOO on CPU
+    magma_d_matrix          hL;                        // stored for reuse: L factor, CSR on CPU
+    magma_d_matrix          hU;                        // stored for reuse: U factor, CSC on CPU (U^T in CSR)
+    magma_solver_type       subsolver;                 // Schwarz (CPU): subdomain factorization, Magma_ILU or Magma_PARILUT
 #if defined(MAGMA_HAVE_PASTIX)
     pastix_data_t*          pastix_data;
     magma_int_t*            iparm;
@@ -851,6 +938,13 @@ typedef struct magma_s_preconditioner
     magma_solve_info_t cuinfoUT;
     
     magma_bool_t            transpose;                 // need the transpose for the solver?
+    magma_bool_t            reuse;                     // ParILU/ParIC (CPU): refactorize on the stored pattern
+    magma_int_t             verbose;                   // ParILU/ParIC (CPU): print residual every 'verbose' sweeps
+    magma_bool_t            async;                     // ParILU/ParIC (CPU): asynchronous sweeps, stopping on atol/rtol
+    magma_s_matrix          hA;                        // stored for reuse: A on the factor pattern, CSRCOO on CPU
+    magma_s_matrix          hL;                        // stored for reuse: L factor, CSR on CPU
+    magma_s_matrix          hU;                        // stored for reuse: U factor, CSC on CPU (U^T in CSR)
+    magma_solver_type       subsolver;                 // Schwarz (CPU): subdomain factorization, Magma_ILU or Magma_PARILUT
 #if defined(MAGMA_HAVE_PASTIX)
     pastix_data_t*          pastix_data;
     magma_int_t*            iparm;
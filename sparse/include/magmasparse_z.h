@@ -285,6 +285,32 @@ magma_zdimv(
   magma_z_matrix* vecB,
   magma_queue_t queue );
 
+magma_int_t
+magma_zscaling_create(
+    magma_z_matrix A,
+    magma_scale_t scaling,
+    magma_side_t side,
+    magma_z_scaling *S,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zscaling_apply(
+    magma_z_scaling S,
+    magma_z_matrix *A,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zscaling_vector(
+    magma_z_scaling S,
+    magma_side_t side,
+    magma_z_matrix *x,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zscaling_free(
+    magma_z_scaling *S,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zmslice(
     magma_int_t num_slices,
@@ -323,6 +349,14 @@ magma_zmdiff(
  real_Double_t *res,
     magma_queue_t queue );
 
+magma_int_t
+magma_zmdiff_merge(
+    magma_z_matrix A,
+    magma_z_matrix *B,
+    magma_bool_t subtract,
+    real_Double_t sums[3],
+    magma_queue_t queue );
+
 magma_int_t
 magma_zmdiagadd( 
     magma_z_matrix *A, 
@@ -582,6 +616,23 @@ magma_zrowentries(
     magma_z_matrix *A,
     magma_queue_t queue );
 
+magma_int_t
+magma_zmprofile(
+    magma_z_matrix *A,
+    magma_matrix_profile *profile,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmprofile_forget(
+    magma_z_matrix *A,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmrecommend_format(
+    magma_z_matrix *A,
+    magma_storage_t *format,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zmfree(
     magma_z_matrix *A,
@@ -614,6 +665,30 @@ magma_zresidual_slice(
     double *res,
     magma_queue_t queue );
 
+// sets the dof x dof block of stencil point for node (ix, iy, iz); see magma_zmstencil
+typedef void (*magma_zstencil_coef_t)(
+    magma_int_t ix,
+    magma_int_t iy,
+    magma_int_t iz,
+    magma_int_t point,
+    magmaDoubleComplex *block,
+    void *data );
+
+magma_int_t
+magma_zmstencil(
+    magma_int_t nx,
+    magma_int_t ny,
+    magma_int_t nz,
+    magma_int_t dof,
+    magma_int_t npoints,
+    const magma_int_t *offsets,
+    const magmaDoubleComplex *weights,
+    magma_zstencil_coef_t coef,
+    void *coef_data,
+    magma_storage_t storage,
+    magma_z_matrix *A,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zmgenerator(
     magma_int_t n,
@@ -635,6 +710,24 @@ magma_zm_5stencil(
     magma_z_matrix *A,
     magma_queue_t queue );
 
+magma_int_t
+magma_zm_7stencil(
+    magma_int_t n,
+    magma_z_matrix *A,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zm_anisotropic_stencil(
+    magma_int_t nx,
+    magma_int_t ny,
+    magma_int_t nz,
+    double cx,
+    double cy,
+    double cz,
+    magma_int_t dof,
+    magma_z_matrix *A,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zsolverinfo(
     magma_z_solver_par *solver_par, 
@@ -819,6 +912,19 @@ magma_zmLdiagadd(
     magma_z_matrix *L,
     magma_queue_t queue );
 
+magma_int_t
+magma_zmrefill(
+    magma_z_matrix A,
+    magma_uplo_t uplo,
+    magma_z_matrix *B,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmtranspose_values(
+    magma_z_matrix A,
+    magmaDoubleComplex *val,
+    magma_queue_t queue );
+
 
 /* ////////////////////////////////////////////////////////////////////////////
  -- MAGMA_SPARSE iterative dynamic ILU
@@ -1079,6 +1185,19 @@ magma_zparilu_sweep_sync(
     magma_z_matrix *U,
     magma_queue_t queue );
 
+magma_int_t
+magma_zparilu_sweep_async(
+    magma_z_matrix A,
+    magma_z_matrix *L,
+    magma_z_matrix *U,
+    magma_int_t maxsweeps,
+    double atol,
+    double rtol,
+    magma_int_t *sweeps,
+    double *res0,
+    double *res,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zparic_sweep(
     magma_z_matrix A,
@@ -1091,6 +1210,18 @@ magma_zparic_sweep_sync(
     magma_z_matrix *L,
     magma_queue_t queue );
 
+magma_int_t
+magma_zparic_sweep_async(
+    magma_z_matrix A,
+    magma_z_matrix *L,
+    magma_int_t maxsweeps,
+    double atol,
+    double rtol,
+    magma_int_t *sweeps,
+    double *res0,
+    double *res,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zparict_sweep_sync(
     magma_z_matrix *A,
@@ -1607,6 +1738,235 @@ magma_zcsr_sort_gpu(
 /* ////////////////////////////////////////////////////////////////////////////
  -- MAGMA_SPARSE function definitions / Data on CPU
 */
+magma_int_t
+magma_zcg_cpu(
+    magma_z_matrix A, magma_z_matrix b, magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zbicgstab_cpu(
+    magma_z_matrix A, magma_z_matrix b, magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zpbicgstab_cpu(
+    magma_z_matrix A, magma_z_matrix b, magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zbcg_cpu(
+    magma_z_matrix A, magma_z_matrix b, magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zbbicgstab_cpu(
+    magma_z_matrix A, magma_z_matrix b, magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zgecsrmv_cpu(
+    magma_trans_t transA,
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex *val,
+    magma_index_t *rowptr,
+    magma_index_t *colind,
+    magmaDoubleComplex *x,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex *y,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zgecsrmm_cpu(
+    magma_trans_t transA,
+    magma_order_t order,
+    magma_int_t m, magma_int_t n,
+    magma_int_t num_vecs,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex *val,
+    magma_index_t *rowptr,
+    magma_index_t *colind,
+    magmaDoubleComplex *B, magma_int_t ldb,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex *C, magma_int_t ldc,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zspgemm_symbolic_cpu(
+    magma_z_matrix A,
+    magma_z_matrix B,
+    magma_z_matrix *C,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zspgemm_numeric_cpu(
+    magmaDoubleComplex alpha,
+    magma_z_matrix A,
+    magma_z_matrix B,
+    magma_z_matrix *C,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zspgemm_cpu(
+    magmaDoubleComplex alpha,
+    magma_z_matrix A,
+    magma_z_matrix B,
+    magma_z_matrix *C,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zcgmerge_spmv1_cpu(
+    magma_z_matrix A,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex *h,
+    magmaDoubleComplex *d,
+    magmaDoubleComplex *dnew,
+    magmaDoubleComplex *z,
+    magmaDoubleComplex *skp,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zcgmerge_xrbeta_cpu(
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex *diag,
+    magmaDoubleComplex *x,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *h,
+    magmaDoubleComplex *d,
+    magmaDoubleComplex *z,
+    double *rh,
+    double *rr,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zbicgmerge_spmv1_cpu(
+    magma_z_matrix A,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex omega,
+    magmaDoubleComplex *rr,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *p,
+    magmaDoubleComplex *v,
+    magmaDoubleComplex *pnew,
+    magmaDoubleComplex *vnew,
+    magmaDoubleComplex *skp,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zbicgmerge_spmv2_cpu(
+    magma_z_matrix A,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *v,
+    magmaDoubleComplex *s,
+    magmaDoubleComplex *t,
+    magmaDoubleComplex *skp,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zbicgmerge_xrbeta_cpu(
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex omega,
+    magmaDoubleComplex *rr,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *p,
+    magmaDoubleComplex *s,
+    magmaDoubleComplex *t,
+    magmaDoubleComplex *x,
+    magmaDoubleComplex *skp,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zbcgmerge_spmm1_cpu(
+    magma_z_matrix A,
+    magma_int_t nv,
+    magmaDoubleComplex *beta,
+    magmaDoubleComplex *H,
+    magmaDoubleComplex *D,
+    magmaDoubleComplex *Dnew,
+    magmaDoubleComplex *Z,
+    magmaDoubleComplex *skp,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zbcgmerge_xrbeta_cpu(
+    magma_int_t n,
+    magma_int_t nv,
+    magmaDoubleComplex *alpha,
+    magmaDoubleComplex *diag,
+    magmaDoubleComplex *X,
+    magmaDoubleComplex *R,
+    magmaDoubleComplex *H,
+    magmaDoubleComplex *D,
+    magmaDoubleComplex *Z,
+    double *rh,
+    double *rr,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zbbicgmerge_spmm1_cpu(
+    magma_z_matrix A,
+    magma_int_t nv,
+    magmaDoubleComplex *beta,
+    magmaDoubleComplex *omega,
+    magmaDoubleComplex *RR,
+    magmaDoubleComplex *R,
+    magmaDoubleComplex *P,
+    magmaDoubleComplex *V,
+    magmaDoubleComplex *Pnew,
+    magmaDoubleComplex *Vnew,
+    magmaDoubleComplex *skp,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zbbicgmerge_spmm2_cpu(
+    magma_z_matrix A,
+    magma_int_t nv,
+    magmaDoubleComplex *alpha,
+    magmaDoubleComplex *R,
+    magmaDoubleComplex *V,
+    magmaDoubleComplex *S,
+    magmaDoubleComplex *T,
+    magmaDoubleComplex *skp,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zbbicgmerge_xrbeta_cpu(
+    magma_int_t n,
+    magma_int_t nv,
+    magmaDoubleComplex *alpha,
+    magmaDoubleComplex *omega,
+    magmaDoubleComplex *RR,
+    magmaDoubleComplex *R,
+    magmaDoubleComplex *P,
+    magmaDoubleComplex *S,
+    magmaDoubleComplex *T,
+    magmaDoubleComplex *X,
+    magmaDoubleComplex *skp,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zbcopy_cpu(
+    magma_int_t n,
+    magma_int_t nk,
+    magma_order_t src_order,
+    magmaDoubleComplex *src, magma_int_t ldsrc,
+    magma_index_t *src_idx,
+    magma_order_t dst_order,
+    magmaDoubleComplex *dst, magma_int_t lddst,
+    magma_index_t *dst_idx,
+    magma_queue_t queue );
+
 
 
 /* ////////////////////////////////////////////////////////////////////////////
@@ -2808,6 +3168,32 @@ magma_zjacobisetup_diagscal(
     magma_z_matrix A, magma_z_matrix *d,
     magma_queue_t queue );
 
+magma_int_t
+magma_zvbjacobisetup_cpu(
+    magma_z_matrix A,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zvbjacobiapply_cpu(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zschwarz_setup_cpu(
+    magma_z_matrix A,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zschwarz_apply_cpu(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
 
 //##################   kernel fusion for Krylov methods
 
@@ -3399,6 +3785,12 @@ magma_zjaccard_weights(
     magma_z_matrix *J,
     magma_queue_t queue );
 
+magma_int_t
+magma_zjaccard_weights_cpu(
+    magma_z_matrix A,
+    magma_z_matrix *J,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zthrsholdselect(
     magma_int_t sampling,
@@ -75,18 +75,24 @@ magma_z_precond(
                 CHECK( magma_zfgmres( A, b, x, &psolver_par, &pprecond, queue )); break;
         case  Magma_JACOBI:
                 CHECK( magma_zjacobi( A, b, x, &psolver_par, queue )); break;
+        #if ! defined(MAGMA_HAVE_HOST)
         case  Magma_BAITER:
                 CHECK( magma_zbaiter( A, b, x, &psolver_par, &pprecond, queue )); break;
         case  Magma_IDR:
                 CHECK( magma_zidr( A, b, x, &psolver_par, queue )); break;
+        #endif
         case  Magma_CGS:
                 CHECK( magma_zcgs( A, b, x, &psolver_par, queue )); break;
+        #if ! defined(MAGMA_HAVE_HOST)
         case  Magma_QMR:
                 CHECK( magma_zqmr( A, b, x, &psolver_par, queue )); break;
+        #endif
         case  Magma_TFQMR:
                 CHECK( magma_ztfqmr( A, b, x, &psolver_par, queue )); break;
+        #if ! defined(MAGMA_HAVE_HOST)
         case  Magma_BAITERO:
                 CHECK( magma_zbaiter_overlap( A, b, x, &psolver_par, &pprecond, queue )); break;
+        #endif
         default:
                 CHECK( magma_zcg_res( A, b, x, &psolver_par, queue )); break;
     }
@@ -160,7 +166,8 @@ magma_z_precondsetup(
         //info = magma_zpastixsetup( A, b, precond, queue );
         info = MAGMA_ERR_NOT_SUPPORTED;
     }
-    // ILU and related
+    // ILU and related; the host backend has no device setups
+    #if ! defined(MAGMA_HAVE_HOST)
     else if ( precond->solver == Magma_ILU ) {
         if ( precond->trisolver == Magma_ISAI ||
             precond->trisolver == Magma_JACOBI ||
@@ -189,12 +196,14 @@ magma_z_precondsetup(
              }
         }
     }
+    #endif
     else if ( precond->solver == Magma_ILUT ) {
         printf( "error: preconditioner requires OpenMP.\n" );
         info = MAGMA_ERR_NOT_SUPPORTED;
         //info = magma_zilut_saad( A, b, precond, queue );
     }
     
+    #if ! defined(MAGMA_HAVE_HOST)
     else if ( precond->solver == Magma_PARILUT ) {
         #ifdef _OPENMP
         /* Here, use No-Dynamic-Parallelism vresion or normal version depending on platform */
@@ -238,6 +247,7 @@ magma_z_precondsetup(
     else if ( precond->solver == Magma_PARIC ) {
         info = magma_zparic_gpu( A, b, precond, queue );
     }
+    #endif
     else if ( precond->solver == Magma_PARICT ) {
         #ifdef _OPENMP
             info = magma_zparict_cpu( A, b, precond, queue );
@@ -247,10 +257,12 @@ magma_z_precondsetup(
             info = MAGMA_ERR_NOT_SUPPORTED;
         #endif
     }
+    #if ! defined(MAGMA_HAVE_HOST)
     else if ( precond->solver == Magma_CUSTOMIC ) {
         info = magma_zcustomicsetup( A, b, precond, queue );
         precond->solver = Magma_PARIC; // handle as PARIC
     }
+    #endif
     // none case
     else if ( precond->solver == Magma_NONE ) {
         info = MAGMA_SUCCESS;
@@ -259,6 +271,7 @@ magma_z_precondsetup(
         printf( "error: preconditioner type not yet supported.\n" );
         info = MAGMA_ERR_NOT_SUPPORTED;
     }
+    #if ! defined(MAGMA_HAVE_HOST)
     if( 
         ( solver->solver == Magma_PQMR  || 
           solver->solver == Magma_PQMRMERGE  || 
@@ -280,6 +293,7 @@ magma_z_precondsetup(
                 // info = magma_ziluisaisetup_t( A, b, precond, queue );
         }
     }
+    #endif
     
     tempo2 = magma_sync_wtime( queue );
     precond->setuptime = tempo2-tempo1;
@@ -453,6 +467,7 @@ magma_z_applyprecond_left(
                     precond->trisolver == 0 ) ){
             CHECK( magma_zapplycumicc_l( b, x, precond, queue ));
         }
+        #if ! defined(MAGMA_HAVE_HOST)
         else if ( ( precond->solver == Magma_ICC ||
                     precond->solver == Magma_PARIC ) && 
                   ( precond->trisolver == Magma_ISAI ||
@@ -469,6 +484,7 @@ magma_z_applyprecond_left(
             CHECK( magma_zisai_l( b, x, precond, queue ) );
             // magma_z_spmv( MAGMA_Z_ONE, precond->L, b,MAGMA_Z_ZERO, *x, queue ); // SPAI
         }
+        #endif
         else if ( ( precond->solver == Magma_ILU ||
                     precond->solver == Magma_PARILU ) ){
             magma_z_solver( precond->L, b, x, &zopts, queue );
@@ -487,18 +503,21 @@ magma_z_applyprecond_left(
         if ( precond->solver == Magma_JACOBI ) {
             CHECK( magma_zjacobi_diagscal( b.num_rows, precond->d, b, x, queue ));
         }
+        #if ! defined(MAGMA_HAVE_HOST)
         else if ( ( precond->solver == Magma_ILU ||
                     precond->solver == Magma_PARILU ) && 
                   ( precond->trisolver == Magma_CUSOLVE ||
                     precond->trisolver == 0 ) ){
             CHECK( magma_zapplycumilu_l_transpose( b, x, precond, queue ));
         }
+        #endif
         else if ( ( precond->solver == Magma_ICC ||
                     precond->solver == Magma_PARIC ) && 
                   ( precond->trisolver == Magma_CUSOLVE ||
                     precond->trisolver == 0 ) ){
             CHECK( magma_zapplycumicc_l( b, x, precond, queue ));
         }
+        #if ! defined(MAGMA_HAVE_HOST)
         else if ( ( precond->solver == Magma_ILU ||
                     precond->solver == Magma_PARILU ) && 
                   ( precond->trisolver == Magma_ISAI ||
@@ -506,6 +525,7 @@ magma_z_applyprecond_left(
                     precond->trisolver == Magma_VBJACOBI ) ){
             CHECK( magma_zisai_l_t( b, x, precond, queue ) );
         }
+        #endif
         else if ( ( precond->solver == Magma_ILU ||
                     precond->solver == Magma_PARILU ) ){
             magma_z_solver( precond->L, b, x, &zopts, queue );
@@ -623,6 +643,7 @@ magma_z_applyprecond_right(
                     precond->trisolver == 0 ) ){
             CHECK( magma_zapplycumicc_r( b, x, precond, queue ));
         }
+        #if ! defined(MAGMA_HAVE_HOST)
         else if ( ( precond->solver == Magma_ICC ||
                     precond->solver == Magma_PARIC ) && 
                   ( precond->trisolver == Magma_ISAI ||
@@ -639,6 +660,7 @@ magma_z_applyprecond_right(
             CHECK( magma_zisai_r( b, x, precond, queue ) );
             // magma_z_spmv( MAGMA_Z_ONE, precond->L, b,MAGMA_Z_ZERO, *x, queue ); // SPAI
         }
+        #endif
         else if ( ( precond->solver == Magma_ILU ||
                     precond->solver == Magma_PARILU ) ){
             magma_z_solver( precond->U, b, x, &zopts, queue );
@@ -661,18 +683,21 @@ magma_z_applyprecond_right(
         if ( precond->solver == Magma_JACOBI ) {
             magma_zcopy( b.num_rows*b.num_cols, b.dval, 1, x->dval, 1, queue );    // x = b
         }
+        #if ! defined(MAGMA_HAVE_HOST)
         else if ( ( precond->solver == Magma_ILU ||
                     precond->solver == Magma_PARILU ) && 
                   ( precond->trisolver == Magma_CUSOLVE ||
                     precond->trisolver == 0 ) ){
             CHECK( magma_zapplycumilu_r_transpose( b, x, precond, queue ));
         }
+        #endif
         else if ( ( precond->solver == Magma_ICC ||
                     precond->solver == Magma_PARIC ) && 
                   ( precond->trisolver == Magma_CUSOLVE ||
                     precond->trisolver == 0 ) ){
             CHECK( magma_zapplycumicc_r( b, x, precond, queue ));
         }
+        #if ! defined(MAGMA_HAVE_HOST)
         else if ( ( precond->solver == Magma_ILU ||
                     precond->solver == Magma_PARILU ) && 
                   ( precond->trisolver == Magma_ISAI ||
@@ -681,6 +706,7 @@ magma_z_applyprecond_right(
             CHECK( magma_zisai_r_t( b, x, precond, queue ) );
             // magma_z_spmv( MAGMA_Z_ONE, precond->U, b,MAGMA_Z_ZERO, *x, queue ); // SPAI
         }
+        #endif
         else if ( ( precond->solver == Magma_ILU ||
                     precond->solver == Magma_PARILU ) ){
             magma_z_solver( precond->U, b, x, &zopts, queue );
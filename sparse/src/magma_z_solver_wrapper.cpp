@@ -18,6 +18,8 @@
 
     This is an interface that allows to use any iterative solver on the linear
     system Ax = b. All linear algebra objects are expected to be on the device,
+    or all on the CPU for CG, PCG (Jacobi or VBJACOBI), BiCGSTAB, and
+    PBiCGSTAB (VBJACOBI or SCHWARZ);
     the linear algebra objects are MAGMA-sparse specific structures 
     (dense matrix b, dense matrix x, sparse/dense matrix A).
     The additional parameter zopts contains information about the solver
@@ -68,6 +70,49 @@ magma_z_solver(
         printf( "error: sparse RHS not yet supported.\n" );
         return MAGMA_ERR_NOT_SUPPORTED;
     }
+    // CPU case: CG, PCG with Jacobi, BiCGSTAB, and PBiCGSTAB run on the host;
+    // the merged variants are the same solvers, as the host kernels are fused.
+    // Several RHS are solved together, sharing one sweep over A per SpMV.
+    if ( A.memory_location == Magma_CPU ) {
+        if ( b.num_cols == 1 ) {
+            switch( zopts->solver_par.solver ) {
+                case  Magma_CG:
+                case  Magma_CGMERGE:
+                        CHECK( magma_zcg_cpu( A, b, x, &zopts->solver_par, NULL, queue )); break;
+                case  Magma_PCG:
+                case  Magma_PCGMERGE:
+                        CHECK( magma_zcg_cpu( A, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
+                case  Magma_BICGSTAB:
+                case  Magma_BICGSTABMERGE:
+                        CHECK( magma_zbicgstab_cpu( A, b, x, &zopts->solver_par, queue )); break;
+                case  Magma_PBICGSTAB:
+                case  Magma_PBICGSTABMERGE:
+                        CHECK( magma_zpbicgstab_cpu( A, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
+                default:
+                        printf("error: solver class not supported on the CPU.\n");
+                        info = MAGMA_ERR_NOT_SUPPORTED;
+                        break;
+            }
+        }
+        else {
+            switch( zopts->solver_par.solver ) {
+                case  Magma_CG:
+                case  Magma_CGMERGE:
+                        CHECK( magma_zbcg_cpu( A, b, x, &zopts->solver_par, NULL, queue )); break;
+                case  Magma_PCG:
+                case  Magma_PCGMERGE:
+                        CHECK( magma_zbcg_cpu( A, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
+                case  Magma_BICGSTAB:
+                case  Magma_BICGSTABMERGE:
+                        CHECK( magma_zbbicgstab_cpu( A, b, x, &zopts->solver_par, queue )); break;
+                default:
+                        printf("error: only 1 RHS supported for this solver on the CPU.\n");
+                        info = MAGMA_ERR_NOT_SUPPORTED;
+                        break;
+            }
+        }
+        goto cleanup;
+    }
     if( b.num_cols == 1 ){
         switch( zopts->solver_par.solver ) {
             case  Magma_BICG:
@@ -98,6 +143,7 @@ magma_z_solver(
                     CHECK( magma_zpcgs( A, b, x, &zopts->solver_par, &zopts->precond_par, queue ) ); break;
             case  Magma_PCGSMERGE:
                     CHECK( magma_zpcgs_merge( A, b, x, &zopts->solver_par, &zopts->precond_par, queue ) ); break;
+            #if ! defined(MAGMA_HAVE_HOST)
             case  Magma_QMR:
                     CHECK( magma_zqmr( A, b, x, &zopts->solver_par, queue ) ); break;
             case  Magma_QMRMERGE:
@@ -106,6 +152,7 @@ magma_z_solver(
                     CHECK( magma_zpqmr( A, b, x, &zopts->solver_par, &zopts->precond_par, queue ) ); break;
             case  Magma_PQMRMERGE:
                     CHECK( magma_zpqmr_merge( A, b, x, &zopts->solver_par, &zopts->precond_par, queue ) ); break;
+            #endif
             case  Magma_TFQMR:
                     CHECK( magma_ztfqmr( A, b, x, &zopts->solver_par, queue ) ); break;
             case  Magma_TFQMRMERGE:
@@ -118,6 +165,7 @@ magma_z_solver(
                     CHECK( magma_zfgmres( A, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
             case  Magma_PGMRES:
                     CHECK( magma_zfgmres( A, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
+            #if ! defined(MAGMA_HAVE_HOST)
             case  Magma_IDR:
                     CHECK( magma_zidr( A, b, x, &zopts->solver_par, queue )); break;
             case  Magma_IDRMERGE:
@@ -130,10 +178,12 @@ magma_z_solver(
                     //CHECK( magma_zpidr_strms( A, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
             case  Magma_LOBPCG:
                     CHECK( magma_zlobpcg( A, &zopts->solver_par, &zopts->precond_par, queue )); break;
+            #endif
             case  Magma_ITERREF:
                     CHECK( magma_ziterref( A, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
             case  Magma_JACOBI:
                     CHECK( magma_zjacobi( A, b, x, &zopts->solver_par, queue )); break;
+            #if ! defined(MAGMA_HAVE_HOST)
             case  Magma_BAITER:
                     CHECK( magma_zbaiter( A, b, x, &zopts->solver_par, &zopts->precond_par, queue ) ); break;
             case  Magma_BAITERO:
@@ -142,6 +192,7 @@ magma_z_solver(
                     CHECK( magma_zbombard( A, b, x, &zopts->solver_par, queue ) ); break;
             case  Magma_BOMBARDMERGE:
                     CHECK( magma_zbombard_merge( A, b, x, &zopts->solver_par, queue ) ); break;
+            #endif
             // case  Magma_PARDISO:
             //         CHECK( magma_zpardiso( A, b, x, &zopts->solver_par, queue ) ); break;
             default:
@@ -154,8 +205,10 @@ magma_z_solver(
                     CHECK( magma_zbpcg( A, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
             case  Magma_PCG:
                     CHECK( magma_zbpcg( A, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
+            #if ! defined(MAGMA_HAVE_HOST)
             case  Magma_LOBPCG:
                     CHECK( magma_zlobpcg( A, &zopts->solver_par, &zopts->precond_par, queue )); break;
+            #endif
             default:
                     printf("error: only 1 RHS supported for this solver class.\n"); break;
         }
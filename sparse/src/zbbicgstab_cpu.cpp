@@ -0,0 +1,349 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+
+
+/**
+    Purpose
+    -------
+
+    Solves a system of linear equations with many right-hand sides
+       A * X = B
+    where A is a general N-by-N matrix A.
+    This is a CPU implementation of the Biconjugate Gradient Stabilized
+    method for all columns of B at once.
+
+    Each column keeps its own BiCGSTAB recurrence, but all columns share the
+    two sweeps over A per iteration (magma_zbbicgmerge_spmm1_cpu and
+    magma_zbbicgmerge_spmm2_cpu), so A is streamed twice per iteration
+    instead of twice per right-hand side. Columns that reach the stopping
+    criterion, or break down, are written to x and deflated, i.e., dropped
+    from the workspace.
+
+    The feedback in solver_par is the maximum over the columns, as in
+    magma_zbcg_cpu. If a column broke down, info is MAGMA_DIVERGENCE.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A on the CPU
+
+    @param[in]
+    b           magma_z_matrix
+                RHS b on the CPU, num_cols right-hand sides
+
+    @param[in,out]
+    x           magma_z_matrix*
+                solution approximation on the CPU, same size as b
+
+    @param[in,out]
+    solver_par  magma_z_solver_par*
+                solver parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgesv
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zbbicgstab_cpu(
+    magma_z_matrix A, magma_z_matrix b, magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_queue_t queue )
+{
+    magma_int_t info = MAGMA_NOTCONVERGED;
+
+    // prepare solver feedback
+    solver_par->solver = Magma_BICGSTAB;
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+
+    // local variables
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE;
+    real_Double_t tempo1, tempo2;
+    double res, maxres;
+    bool breakdown = false;
+
+    magma_int_t dofs = A.num_rows;
+    magma_int_t nrhs = b.num_cols;
+    magma_int_t nv = nrhs;   // number of active columns
+    magma_int_t nkeep, ndone;
+
+    // layouts of b and x
+    magma_order_t border = (b.major  == MagmaRowMajor ? MagmaRowMajor : MagmaColMajor);
+    magma_order_t xorder = (x->major == MagmaRowMajor ? MagmaRowMajor : MagmaColMajor);
+    magma_int_t ldb = (border == MagmaRowMajor ? nrhs : max( b.ld, dofs ));
+    magma_int_t ldx = (xorder == MagmaRowMajor ? nrhs : max( x->ld, dofs ));
+
+    // CPU workspace, row-major blocks of nv columns
+    magma_z_matrix Acsr={Magma_CSR}, X={Magma_CSR}, R={Magma_CSR}, RR={Magma_CSR},
+                   P={Magma_CSR}, V={Magma_CSR}, Pnew={Magma_CSR}, Vnew={Magma_CSR},
+                   S={Magma_CSR}, T={Magma_CSR}, W={Magma_CSR};
+    magmaDoubleComplex *swap;
+    magmaDoubleComplex *alpha=NULL, *beta=NULL, *omega=NULL, *rho_old=NULL,
+                       *rho_new=NULL, *skp=NULL;
+    double *nomb=NULL, *lastres=NULL;
+    magma_index_t *idx=NULL, *keep=NULL, *done=NULL, *done_idx=NULL;
+    bool *failed=NULL;
+
+    if ( A.memory_location != Magma_CPU || b.memory_location != Magma_CPU ||
+         x->memory_location != Magma_CPU ) {
+        info = MAGMA_ERR_INVALID_PTR;
+        goto cleanup;
+    }
+
+    if ( A.storage_type == Magma_CSR ) {
+        Acsr = A;
+    }
+    else {
+        CHECK( magma_zmconvert( A, &Acsr, A.storage_type, Magma_CSR, queue ));
+    }
+    CHECK( magma_zvinit( &X,    Magma_CPU, dofs, nrhs, c_zero, queue ));
+    CHECK( magma_zvinit( &R,    Magma_CPU, dofs, nrhs, c_zero, queue ));
+    CHECK( magma_zvinit( &RR,   Magma_CPU, dofs, nrhs, c_zero, queue ));
+    CHECK( magma_zvinit( &P,    Magma_CPU, dofs, nrhs, c_zero, queue ));
+    CHECK( magma_zvinit( &V,    Magma_CPU, dofs, nrhs, c_zero, queue ));
+    CHECK( magma_zvinit( &Pnew, Magma_CPU, dofs, nrhs, c_zero, queue ));
+    CHECK( magma_zvinit( &Vnew, Magma_CPU, dofs, nrhs, c_zero, queue ));
+    CHECK( magma_zvinit( &S,    Magma_CPU, dofs, nrhs, c_zero, queue ));
+    CHECK( magma_zvinit( &T,    Magma_CPU, dofs, nrhs, c_zero, queue ));
+    CHECK( magma_zvinit( &W,    Magma_CPU, dofs, nrhs, c_zero, queue ));
+    CHECK( magma_zmalloc_cpu( &alpha,   nrhs ));
+    CHECK( magma_zmalloc_cpu( &beta,    nrhs ));
+    CHECK( magma_zmalloc_cpu( &omega,   nrhs ));
+    CHECK( magma_zmalloc_cpu( &rho_old, nrhs ));
+    CHECK( magma_zmalloc_cpu( &rho_new, nrhs ));
+    CHECK( magma_zmalloc_cpu( &skp,     2*nrhs ));
+    CHECK( magma_dmalloc_cpu( &nomb,    nrhs ));
+    CHECK( magma_dmalloc_cpu( &lastres, nrhs ));
+    CHECK( magma_index_malloc_cpu( &idx,      nrhs ));
+    CHECK( magma_index_malloc_cpu( &keep,     nrhs ));
+    CHECK( magma_index_malloc_cpu( &done,     nrhs ));
+    CHECK( magma_index_malloc_cpu( &done_idx, nrhs ));
+    CHECK( magma_malloc_cpu( (void**) &failed, nrhs*sizeof(bool) ));
+
+    // solver setup
+    // R = B - A X, with X and R copied to row-major workspace;  RR = R
+    CHECK( magma_zbcopy_cpu( dofs, nrhs, xorder, x->val, ldx, NULL,
+                             MagmaRowMajor, X.val, nrhs, NULL, queue ));
+    CHECK( magma_zbcopy_cpu( dofs, nrhs, border, b.val, ldb, NULL,
+                             MagmaRowMajor, R.val, nrhs, NULL, queue ));
+    for( magma_int_t k=0; k < nrhs; k++ ) {
+        idx[k] = k;
+        failed[k] = false;
+        rho_old[k] = omega[k] = alpha[k] = c_one;
+        nomb[k] = magma_cblas_dznrm2( dofs, R.val + k, nrhs );
+        if ( nomb[k] == 0.0 ) {
+            nomb[k] = 1.0;
+        }
+    }
+    CHECK( magma_zgecsrmm_cpu( MagmaNoTrans, MagmaRowMajor, dofs, dofs, nrhs, -c_one,
+                               Acsr.val, Acsr.row, Acsr.col, X.val, nrhs,
+                               c_one, R.val, nrhs, queue ));
+    CHECK( magma_zbcopy_cpu( dofs, nrhs, MagmaRowMajor, R.val, nrhs, NULL,
+                             MagmaRowMajor, RR.val, nrhs, NULL, queue ));
+    solver_par->init_res = 0.0;
+    for( magma_int_t k=0; k < nrhs; k++ ) {
+        rho_new[k] = magma_cblas_zdotc( dofs, RR.val + k, nrhs, R.val + k, nrhs );
+        skp[ nrhs+k ] = MAGMA_Z_MAKE( magma_cblas_dznrm2( dofs, R.val + k, nrhs ), 0. );
+        skp[ nrhs+k ] = skp[ nrhs+k ] * skp[ nrhs+k ];
+        lastres[k] = MAGMA_Z_REAL( skp[ nrhs+k ] );
+        solver_par->init_res = max( solver_par->init_res, sqrt( lastres[k] ));
+    }
+    solver_par->final_res = solver_par->init_res;
+    solver_par->iter_res = solver_par->init_res;
+    if ( solver_par->verbose > 0 ) {
+        solver_par->res_vec[0] = (real_Double_t) solver_par->init_res;
+        solver_par->timing[0] = 0.0;
+    }
+
+    //Chronometry
+    tempo1 = magma_wtime();
+
+    // start iteration; the first pass only deflates columns that already converged
+    while ( true )
+    {
+        // deflation: write converged or failed columns to x and drop them
+        // from the workspace; skp[nv+k] holds r' r of column k
+        nkeep = ndone = 0;
+        maxres = 0.0;
+        for( magma_int_t k=0; k < nv; k++ ) {
+            res = sqrt( MAGMA_Z_REAL( skp[ nv+k ] ));
+            if ( ! failed[k] ) {
+                lastres[ idx[k] ] = res;
+            }
+            if ( failed[k] ||
+                 res < solver_par->atol || res/nomb[ idx[k] ] < solver_par->rtol ) {
+                breakdown = breakdown || failed[k];
+                done[ ndone ] = k;
+                done_idx[ ndone ] = idx[k];
+                ndone++;
+            }
+            else {
+                keep[ nkeep++ ] = k;
+                maxres = max( maxres, res );
+            }
+        }
+        if ( ndone > 0 ) {
+            CHECK( magma_zbcopy_cpu( dofs, ndone, MagmaRowMajor, X.val, nv, done,
+                                     xorder, x->val, ldx, done_idx, queue ));
+        }
+        if ( ndone > 0 && nkeep > 0 ) {
+            magma_z_matrix* blocks[] = { &X, &R, &RR, &P, &V };
+            for( magma_int_t m=0; m < 5; m++ ) {
+                CHECK( magma_zbcopy_cpu( dofs, nkeep, MagmaRowMajor, blocks[m]->val, nv, keep,
+                                         MagmaRowMajor, W.val, nkeep, NULL, queue ));
+                swap = blocks[m]->val;  blocks[m]->val = W.val;  W.val = swap;
+            }
+            for( magma_int_t k=0; k < nkeep; k++ ) {
+                idx[k]     = idx[ keep[k] ];
+                alpha[k]   = alpha[ keep[k] ];
+                omega[k]   = omega[ keep[k] ];
+                rho_old[k] = rho_old[ keep[k] ];
+                rho_new[k] = rho_new[ keep[k] ];
+                failed[k]  = false;
+            }
+        }
+        nv = nkeep;
+
+        if ( solver_par->verbose > 0 && solver_par->numiter > 0 ) {
+            tempo2 = magma_wtime();
+            if ( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) maxres;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+
+        if ( nv == 0 || solver_par->numiter+1 > solver_par->maxiter ) {
+            break;
+        }
+        solver_par->numiter++;
+
+        // a column that breaks down gets zero scalars, so its x stays finite,
+        // and is deflated at the end of the iteration
+        for( magma_int_t k=0; k < nv; k++ ) {
+            beta[k] = rho_new[k]/rho_old[k] * alpha[k]/omega[k];
+            if ( magma_z_isnan_inf( beta[k] )) {
+                failed[k] = true;
+                beta[k] = c_zero;
+            }
+        }
+
+        // P = R + beta (P - omega V);  V = A P;  skp = RR' V
+        CHECK( magma_zbbicgmerge_spmm1_cpu( Acsr, nv, beta, omega, RR.val, R.val,
+                                            P.val, V.val, Pnew.val, Vnew.val,
+                                            skp, queue ));
+        solver_par->spmv_count++;
+        swap = P.val;  P.val = Pnew.val;  Pnew.val = swap;
+        swap = V.val;  V.val = Vnew.val;  Vnew.val = swap;
+
+        for( magma_int_t k=0; k < nv; k++ ) {
+            alpha[k] = rho_new[k] / skp[k];
+            if ( failed[k] || magma_z_isnan_inf( alpha[k] )) {
+                failed[k] = true;
+                alpha[k] = c_zero;
+            }
+        }
+
+        // S = R - alpha V;  T = A S;  skp = [ T' S, T' T ]
+        CHECK( magma_zbbicgmerge_spmm2_cpu( Acsr, nv, alpha, R.val, V.val, S.val,
+                                            T.val, skp, queue ));
+        solver_par->spmv_count++;
+        for( magma_int_t k=0; k < nv; k++ ) {
+            omega[k] = skp[k] / skp[ nv+k ];          // omega = <s,t>/<t,t>
+            if ( failed[k] || magma_z_isnan_inf( omega[k] )) {
+                failed[k] = true;
+                omega[k] = c_zero;
+            }
+        }
+
+        // X = X + alpha P + omega S;  R = S - omega T;  skp = [ RR' R, R' R ]
+        CHECK( magma_zbbicgmerge_xrbeta_cpu( dofs, nv, alpha, omega, RR.val, R.val,
+                                             P.val, S.val, T.val, X.val,
+                                             skp, queue ));
+        for( magma_int_t k=0; k < nv; k++ ) {
+            rho_old[k] = rho_new[k];
+            rho_new[k] = skp[k];
+        }
+    }
+
+    // columns still active at maxiter
+    if ( nv > 0 ) {
+        CHECK( magma_zbcopy_cpu( dofs, nv, MagmaRowMajor, X.val, nv, NULL,
+                                 xorder, x->val, ldx, idx, queue ));
+    }
+
+    tempo2 = magma_wtime();
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    // R = B - A X, for the original columns
+    CHECK( magma_zbcopy_cpu( dofs, nrhs, border, b.val, ldb, NULL,
+                             MagmaRowMajor, R.val, nrhs, NULL, queue ));
+    CHECK( magma_zbcopy_cpu( dofs, nrhs, xorder, x->val, ldx, NULL,
+                             MagmaRowMajor, X.val, nrhs, NULL, queue ));
+    CHECK( magma_zgecsrmm_cpu( MagmaNoTrans, MagmaRowMajor, dofs, dofs, nrhs, -c_one,
+                               Acsr.val, Acsr.row, Acsr.col, X.val, nrhs,
+                               c_one, R.val, nrhs, queue ));
+    solver_par->iter_res = 0.0;
+    solver_par->final_res = 0.0;
+    for( magma_int_t k=0; k < nrhs; k++ ) {
+        solver_par->iter_res = max( solver_par->iter_res, lastres[k] );
+        solver_par->final_res = max( solver_par->final_res,
+                                     magma_cblas_dznrm2( dofs, R.val + k, nrhs ));
+    }
+
+    if ( breakdown ) {
+        info = MAGMA_DIVERGENCE;
+    } else if ( nv == 0 ) {
+        info = MAGMA_SUCCESS;
+    } else if ( solver_par->init_res > solver_par->final_res ) {
+        info = MAGMA_SLOW_CONVERGENCE;
+    }
+    else {
+        info = MAGMA_DIVERGENCE;
+    }
+
+cleanup:
+    if ( Acsr.val != A.val ) {
+        magma_zmfree(&Acsr, queue );
+    }
+    magma_zmfree(&X, queue );
+    magma_zmfree(&R, queue );
+    magma_zmfree(&RR, queue );
+    magma_zmfree(&P, queue );
+    magma_zmfree(&V, queue );
+    magma_zmfree(&Pnew, queue );
+    magma_zmfree(&Vnew, queue );
+    magma_zmfree(&S, queue );
+    magma_zmfree(&T, queue );
+    magma_zmfree(&W, queue );
+    magma_free_cpu( alpha );
+    magma_free_cpu( beta );
+    magma_free_cpu( omega );
+    magma_free_cpu( rho_old );
+    magma_free_cpu( rho_new );
+    magma_free_cpu( skp );
+    magma_free_cpu( nomb );
+    magma_free_cpu( lastres );
+    magma_free_cpu( idx );
+    magma_free_cpu( keep );
+    magma_free_cpu( done );
+    magma_free_cpu( done_idx );
+    magma_free_cpu( failed );
+
+    solver_par->info = info;
+    return info;
+}   /* magma_zbbicgstab_cpu */
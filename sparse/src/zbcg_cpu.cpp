@@ -0,0 +1,343 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+
+
+/**
+    Purpose
+    -------
+
+    Solves a system of linear equations with many right-hand sides
+       A * X = B
+    where A is a complex Hermitian N-by-N positive definite matrix A.
+    This is a CPU implementation of the Conjugate Gradient method for all
+    columns of B at once, optionally preconditioned by the diagonal of A
+    (precond_par->solver = Magma_JACOBI).
+
+    Each column keeps its own CG recurrence, but all columns share one
+    sweep over A per iteration (magma_zbcgmerge_spmm1_cpu), so A is streamed
+    once per iteration instead of once per right-hand side. Columns that
+    reach the stopping criterion are written to x and deflated, i.e.,
+    dropped from the workspace, so later sweeps only carry the active ones.
+    A column that breaks down, i.e., finds A not positive definite, is
+    deflated the same way, with its last iterate, and info is MAGMA_NONSPD.
+
+    The feedback in solver_par is the maximum over the columns: init_res,
+    iter_res, and final_res are the largest residual norms, numiter is the
+    number of iterations of the slowest column, and spmv_count is the
+    number of sweeps over A.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A on the CPU
+
+    @param[in]
+    b           magma_z_matrix
+                RHS b on the CPU, num_cols right-hand sides
+
+    @param[in,out]
+    x           magma_z_matrix*
+                solution approximation on the CPU, same size as b
+
+    @param[in,out]
+    solver_par  magma_z_solver_par*
+                solver parameters
+
+    @param[in]
+    precond_par magma_z_preconditioner*
+                preconditioner; Magma_NONE or Magma_JACOBI. May be NULL.
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zposv
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zbcg_cpu(
+    magma_z_matrix A, magma_z_matrix b, magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue )
+{
+    magma_int_t info = MAGMA_NOTCONVERGED;
+
+    bool jacobi = ( precond_par != NULL && precond_par->solver == Magma_JACOBI );
+
+    // prepare solver feedback
+    solver_par->solver = jacobi ? Magma_PCG : Magma_CG;
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+
+    // local variables
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE;
+    real_Double_t tempo1, tempo2;
+    double res, maxres;
+
+    magma_int_t dofs = A.num_rows;
+    magma_int_t nrhs = b.num_cols;
+    magma_int_t nv = nrhs;   // number of active columns
+    magma_int_t nkeep, ndone, nbroken = 0;
+
+    // layouts of b and x
+    magma_order_t border = (b.major  == MagmaRowMajor ? MagmaRowMajor : MagmaColMajor);
+    magma_order_t xorder = (x->major == MagmaRowMajor ? MagmaRowMajor : MagmaColMajor);
+    magma_int_t ldb = (border == MagmaRowMajor ? nrhs : max( b.ld, dofs ));
+    magma_int_t ldx = (xorder == MagmaRowMajor ? nrhs : max( x->ld, dofs ));
+
+    // CPU workspace, row-major blocks of nv columns
+    magma_z_matrix Acsr={Magma_CSR}, X={Magma_CSR}, R={Magma_CSR}, H={Magma_CSR},
+                   D={Magma_CSR}, Dnew={Magma_CSR}, Z={Magma_CSR}, W={Magma_CSR},
+                   dinv={Magma_CSR};
+    magmaDoubleComplex *swap, *Hval;
+    magmaDoubleComplex *alpha=NULL, *beta=NULL, *skp=NULL;
+    double *rh=NULL, *rh_old=NULL, *rr=NULL, *nomb=NULL, *lastres=NULL;
+    magma_index_t *idx=NULL, *keep=NULL, *done=NULL, *done_idx=NULL, *broken=NULL;
+
+    if ( A.memory_location != Magma_CPU || b.memory_location != Magma_CPU ||
+         x->memory_location != Magma_CPU ) {
+        info = MAGMA_ERR_INVALID_PTR;
+        goto cleanup;
+    }
+    if ( precond_par != NULL && precond_par->solver != Magma_NONE && ! jacobi ) {
+        printf("error: only Jacobi preconditioning is supported on the CPU.\n");
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    if ( A.storage_type == Magma_CSR ) {
+        Acsr = A;
+    }
+    else {
+        CHECK( magma_zmconvert( A, &Acsr, A.storage_type, Magma_CSR, queue ));
+    }
+    CHECK( magma_zvinit( &X,    Magma_CPU, dofs, nrhs, c_zero, queue ));
+    CHECK( magma_zvinit( &R,    Magma_CPU, dofs, nrhs, c_zero, queue ));
+    CHECK( magma_zvinit( &D,    Magma_CPU, dofs, nrhs, c_zero, queue ));
+    CHECK( magma_zvinit( &Dnew, Magma_CPU, dofs, nrhs, c_zero, queue ));
+    CHECK( magma_zvinit( &Z,    Magma_CPU, dofs, nrhs, c_zero, queue ));
+    CHECK( magma_zvinit( &W,    Magma_CPU, dofs, nrhs, c_zero, queue ));
+    CHECK( magma_zmalloc_cpu( &alpha, nrhs ));
+    CHECK( magma_zmalloc_cpu( &beta,  nrhs ));
+    CHECK( magma_zmalloc_cpu( &skp,   nrhs ));
+    CHECK( magma_dmalloc_cpu( &rh,      nrhs ));
+    CHECK( magma_dmalloc_cpu( &rh_old,  nrhs ));
+    CHECK( magma_dmalloc_cpu( &rr,      nrhs ));
+    CHECK( magma_dmalloc_cpu( &nomb,    nrhs ));
+    CHECK( magma_dmalloc_cpu( &lastres, nrhs ));
+    CHECK( magma_index_malloc_cpu( &idx,      nrhs ));
+    CHECK( magma_index_malloc_cpu( &keep,     nrhs ));
+    CHECK( magma_index_malloc_cpu( &done,     nrhs ));
+    CHECK( magma_index_malloc_cpu( &done_idx, nrhs ));
+    CHECK( magma_index_malloc_cpu( &broken,   nrhs ));
+    if ( jacobi ) {
+        CHECK( magma_zvinit( &H,    Magma_CPU, dofs, nrhs, c_zero, queue ));
+        CHECK( magma_zvinit( &dinv, Magma_CPU, dofs, 1,    c_one,  queue ));
+        for( magma_int_t i=0; i < dofs; i++ ) {
+            for( magma_index_t j=Acsr.row[i]; j < Acsr.row[i+1]; j++ ) {
+                if ( Acsr.col[j] == i && MAGMA_Z_ABS( Acsr.val[j] ) != 0.0 ) {
+                    dinv.val[i] = c_one / Acsr.val[j];
+                }
+            }
+        }
+    }
+
+    // solver setup
+    // R = B - A X, with X and R copied to row-major workspace
+    CHECK( magma_zbcopy_cpu( dofs, nrhs, xorder, x->val, ldx, NULL,
+                             MagmaRowMajor, X.val, nrhs, NULL, queue ));
+    CHECK( magma_zbcopy_cpu( dofs, nrhs, border, b.val, ldb, NULL,
+                             MagmaRowMajor, R.val, nrhs, NULL, queue ));
+    for( magma_int_t k=0; k < nrhs; k++ ) {
+        idx[k] = k;
+        broken[k] = 0;
+        alpha[k] = beta[k] = c_zero;
+        nomb[k] = magma_cblas_dznrm2( dofs, R.val + k, nrhs );
+        if ( nomb[k] == 0.0 ) {
+            nomb[k] = 1.0;
+        }
+    }
+    CHECK( magma_zgecsrmm_cpu( MagmaNoTrans, MagmaRowMajor, dofs, dofs, nrhs, -c_one,
+                               Acsr.val, Acsr.row, Acsr.col, X.val, nrhs,
+                               c_one, R.val, nrhs, queue ));
+    // H = M^{-1} R and the dot products; D = Z = 0, so X and R don't change
+    Hval = jacobi ? H.val : R.val;
+    CHECK( magma_zbcgmerge_xrbeta_cpu( dofs, nv, alpha, dinv.val, X.val, R.val,
+                                       Hval, D.val, Z.val, rh, rr, queue ));
+    solver_par->init_res = 0.0;
+    for( magma_int_t k=0; k < nrhs; k++ ) {
+        lastres[k] = sqrt( rr[k] );
+        solver_par->init_res = max( solver_par->init_res, lastres[k] );
+    }
+    solver_par->final_res = solver_par->init_res;
+    solver_par->iter_res = solver_par->init_res;
+    if ( solver_par->verbose > 0 ) {
+        solver_par->res_vec[0] = (real_Double_t) solver_par->init_res;
+        solver_par->timing[0] = 0.0;
+    }
+
+    //Chronometry
+    tempo1 = magma_wtime();
+
+    // start iteration; the first pass only deflates columns that already converged
+    while ( true )
+    {
+        // deflation: write converged and broken down columns to x and drop
+        // them from the workspace
+        nkeep = ndone = 0;
+        maxres = 0.0;
+        for( magma_int_t k=0; k < nv; k++ ) {
+            res = sqrt( rr[k] );
+            lastres[ idx[k] ] = res;
+            if ( res < solver_par->atol || res/nomb[ idx[k] ] < solver_par->rtol ||
+                 broken[ idx[k] ] ) {
+                done[ ndone ] = k;
+                done_idx[ ndone ] = idx[k];
+                ndone++;
+            }
+            else {
+                keep[ nkeep++ ] = k;
+                maxres = max( maxres, res );
+            }
+        }
+        if ( ndone > 0 ) {
+            CHECK( magma_zbcopy_cpu( dofs, ndone, MagmaRowMajor, X.val, nv, done,
+                                     xorder, x->val, ldx, done_idx, queue ));
+        }
+        if ( ndone > 0 && nkeep > 0 ) {
+            magma_z_matrix* blocks[] = { &X, &R, &D, (jacobi ? &H : NULL) };
+            for( magma_int_t m=0; m < 4; m++ ) {
+                if ( blocks[m] == NULL )
+                    continue;
+                CHECK( magma_zbcopy_cpu( dofs, nkeep, MagmaRowMajor, blocks[m]->val, nv, keep,
+                                         MagmaRowMajor, W.val, nkeep, NULL, queue ));
+                swap = blocks[m]->val;  blocks[m]->val = W.val;  W.val = swap;
+            }
+            for( magma_int_t k=0; k < nkeep; k++ ) {
+                idx[k]  = idx[ keep[k] ];
+                beta[k] = beta[ keep[k] ];
+                rh[k]   = rh[ keep[k] ];
+            }
+            Hval = jacobi ? H.val : R.val;
+        }
+        nv = nkeep;
+
+        if ( solver_par->verbose > 0 && solver_par->numiter > 0 ) {
+            tempo2 = magma_wtime();
+            if ( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) maxres;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+
+        if ( nv == 0 || solver_par->numiter+1 > solver_par->maxiter ) {
+            break;
+        }
+        solver_par->numiter++;
+
+        // D = H + beta D;  Z = A D;  skp = D' Z, for all active columns
+        CHECK( magma_zbcgmerge_spmm1_cpu( Acsr, nv, beta, Hval, D.val, Dnew.val,
+                                          Z.val, skp, queue ));
+        solver_par->spmv_count++;
+        swap = D.val;  D.val = Dnew.val;  Dnew.val = swap;
+
+        for( magma_int_t k=0; k < nv; k++ ) {
+            // check positive definite; a broken down column keeps X and R
+            // (alpha = 0) and is deflated in the next pass
+            if ( MAGMA_Z_REAL( skp[k] ) <= 0.0 ) {
+                broken[ idx[k] ] = 1;
+                nbroken++;
+                alpha[k] = c_zero;
+            }
+            else {
+                alpha[k] = MAGMA_Z_MAKE( rh[k] / MAGMA_Z_REAL( skp[k] ), 0. );
+            }
+            rh_old[k] = rh[k];
+        }
+
+        // X = X + alpha D;  R = R - alpha Z;  H = M^{-1} R;  rh = R' H;  rr = R' R
+        CHECK( magma_zbcgmerge_xrbeta_cpu( dofs, nv, alpha, dinv.val, X.val, R.val,
+                                           Hval, D.val, Z.val, rh, rr, queue ));
+        for( magma_int_t k=0; k < nv; k++ ) {
+            beta[k] = MAGMA_Z_MAKE( rh[k] / rh_old[k], 0. );
+        }
+    }
+
+    // columns still active at maxiter
+    if ( nv > 0 ) {
+        CHECK( magma_zbcopy_cpu( dofs, nv, MagmaRowMajor, X.val, nv, NULL,
+                                 xorder, x->val, ldx, idx, queue ));
+    }
+
+    tempo2 = magma_wtime();
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    // R = B - A X, for the original columns
+    CHECK( magma_zbcopy_cpu( dofs, nrhs, border, b.val, ldb, NULL,
+                             MagmaRowMajor, R.val, nrhs, NULL, queue ));
+    CHECK( magma_zbcopy_cpu( dofs, nrhs, xorder, x->val, ldx, NULL,
+                             MagmaRowMajor, X.val, nrhs, NULL, queue ));
+    CHECK( magma_zgecsrmm_cpu( MagmaNoTrans, MagmaRowMajor, dofs, dofs, nrhs, -c_one,
+                               Acsr.val, Acsr.row, Acsr.col, X.val, nrhs,
+                               c_one, R.val, nrhs, queue ));
+    solver_par->iter_res = 0.0;
+    solver_par->final_res = 0.0;
+    for( magma_int_t k=0; k < nrhs; k++ ) {
+        solver_par->iter_res = max( solver_par->iter_res, lastres[k] );
+        solver_par->final_res = max( solver_par->final_res,
+                                     magma_cblas_dznrm2( dofs, R.val + k, nrhs ));
+    }
+
+    if ( nbroken > 0 ) {
+        info = MAGMA_NONSPD;
+    } else if ( nv == 0 ) {
+        info = MAGMA_SUCCESS;
+    } else if ( solver_par->init_res > solver_par->final_res ) {
+        info = MAGMA_SLOW_CONVERGENCE;
+    }
+    else {
+        info = MAGMA_DIVERGENCE;
+    }
+
+cleanup:
+    if ( Acsr.val != A.val ) {
+        magma_zmfree(&Acsr, queue );
+    }
+    magma_zmfree(&X, queue );
+    magma_zmfree(&R, queue );
+    magma_zmfree(&H, queue );
+    magma_zmfree(&D, queue );
+    magma_zmfree(&Dnew, queue );
+    magma_zmfree(&Z, queue );
+    magma_zmfree(&W, queue );
+    magma_zmfree(&dinv, queue );
+    magma_free_cpu( alpha );
+    magma_free_cpu( beta );
+    magma_free_cpu( skp );
+    magma_free_cpu( rh );
+    magma_free_cpu( rh_old );
+    magma_free_cpu( rr );
+    magma_free_cpu( nomb );
+    magma_free_cpu( lastres );
+    magma_free_cpu( idx );
+    magma_free_cpu( keep );
+    magma_free_cpu( done );
+    magma_free_cpu( done_idx );
+    magma_free_cpu( broken );
+
+    solver_par->info = info;
+    return info;
+}   /* magma_zbcg_cpu */
@@ -0,0 +1,231 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+
+
+/**
+    Purpose
+    -------
+
+    Solves a system of linear equations
+       A * X = B
+    where A is a general N-by-N matrix A.
+    This is a CPU implementation of the Biconjugate Gradient Stabilized
+    method, for A, b, and x located on the CPU.
+
+    Each iteration makes three passes over memory: the search direction
+    update is merged into the first SpMV (magma_zbicgmerge_spmv1_cpu), the
+    intermediate residual into the second SpMV (magma_zbicgmerge_spmv2_cpu),
+    and the solution and residual updates are merged with the dot products
+    for the next iteration (magma_zbicgmerge_xrbeta_cpu).
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A on the CPU
+
+    @param[in]
+    b           magma_z_matrix
+                RHS b on the CPU
+
+    @param[in,out]
+    x           magma_z_matrix*
+                solution approximation on the CPU
+
+    @param[in,out]
+    solver_par  magma_z_solver_par*
+                solver parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgesv
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zbicgstab_cpu(
+    magma_z_matrix A, magma_z_matrix b, magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_queue_t queue )
+{
+    magma_int_t info = MAGMA_NOTCONVERGED;
+
+    // prepare solver feedback
+    solver_par->solver = Magma_BICGSTAB;
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+
+    // local variables
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE;
+    magmaDoubleComplex alpha, beta, omega, rho_old, rho_new, skp[2];
+    double nom0, betanom, nomb;
+    real_Double_t tempo1, tempo2;
+
+    magma_int_t dofs = A.num_rows;
+    const magma_int_t ione = 1;
+
+    // CPU workspace
+    magma_z_matrix Acsr={Magma_CSR}, r={Magma_CSR}, rr={Magma_CSR}, p={Magma_CSR},
+                   v={Magma_CSR}, pnew={Magma_CSR}, vnew={Magma_CSR}, s={Magma_CSR},
+                   t={Magma_CSR};
+    magmaDoubleComplex *swap;
+
+    if ( A.memory_location != Magma_CPU || b.memory_location != Magma_CPU ||
+         x->memory_location != Magma_CPU ) {
+        info = MAGMA_ERR_INVALID_PTR;
+        goto cleanup;
+    }
+
+    if ( A.storage_type == Magma_CSR ) {
+        Acsr = A;
+    }
+    else {
+        CHECK( magma_zmconvert( A, &Acsr, A.storage_type, Magma_CSR, queue ));
+    }
+    CHECK( magma_zvinit( &r,    Magma_CPU, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &rr,   Magma_CPU, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &p,    Magma_CPU, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &v,    Magma_CPU, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &pnew, Magma_CPU, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &vnew, Magma_CPU, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &s,    Magma_CPU, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &t,    Magma_CPU, dofs, 1, c_zero, queue ));
+
+    // solver setup
+    // r = b - A x;  rr = r
+    blasf77_zcopy( &dofs, b.val, &ione, r.val, &ione );
+    CHECK( magma_zgecsrmv_cpu( MagmaNoTrans, dofs, dofs, -c_one, Acsr.val, Acsr.row,
+                               Acsr.col, x->val, c_one, r.val, queue ));
+    blasf77_zcopy( &dofs, r.val, &ione, rr.val, &ione );
+    rho_new = magma_cblas_zdotc( dofs, rr.val, 1, r.val, 1 );        // rho=<rr,r>
+    rho_old = omega = alpha = c_one;
+    nom0 = betanom = magma_cblas_dznrm2( dofs, r.val, 1 );
+    solver_par->init_res = nom0;
+
+    nomb = magma_cblas_dznrm2( dofs, b.val, 1 );
+    if ( nomb == 0.0 ){
+        nomb=1.0;
+    }
+    solver_par->final_res = solver_par->init_res;
+    solver_par->iter_res = solver_par->init_res;
+    if ( solver_par->verbose > 0 ) {
+        solver_par->res_vec[0] = (real_Double_t) nom0;
+        solver_par->timing[0] = 0.0;
+    }
+    if ( nom0 < solver_par->atol ||
+         nom0/nomb < solver_par->rtol ){
+        info = MAGMA_SUCCESS;
+        goto cleanup;
+    }
+
+    //Chronometry
+    tempo1 = magma_wtime();
+
+    // start iteration
+    do
+    {
+        solver_par->numiter++;
+
+        beta = rho_new/rho_old * alpha/omega;   // beta=rho/rho_old *alpha/omega
+        if( magma_z_isnan_inf( beta ) ){
+            info = MAGMA_DIVERGENCE;
+            break;
+        }
+
+        // p = r + beta * ( p - omega * v );  v = A p;  skp = <rr,v>
+        CHECK( magma_zbicgmerge_spmv1_cpu( Acsr, beta, omega, rr.val, r.val,
+                                           p.val, v.val, pnew.val, vnew.val,
+                                           skp, queue ));
+        solver_par->spmv_count++;
+        swap = p.val;  p.val = pnew.val;  pnew.val = swap;
+        swap = v.val;  v.val = vnew.val;  vnew.val = swap;
+
+        alpha = rho_new / skp[0];
+        if( magma_z_isnan_inf( alpha ) ){
+            info = MAGMA_DIVERGENCE;
+            break;
+        }
+
+        // s = r - alpha v;  t = A s;  skp = [<t,s>, <t,t>]
+        CHECK( magma_zbicgmerge_spmv2_cpu( Acsr, alpha, r.val, v.val, s.val, t.val,
+                                           skp, queue ));
+        solver_par->spmv_count++;
+        omega = skp[0] / skp[1];                // omega = <s,t>/<t,t>
+
+        // x = x + alpha p + omega s;  r = s - omega t;  skp = [<rr,r>, <r,r>]
+        CHECK( magma_zbicgmerge_xrbeta_cpu( dofs, alpha, omega, rr.val, r.val,
+                                            p.val, s.val, t.val, x->val,
+                                            skp, queue ));
+        rho_old = rho_new;
+        rho_new = skp[0];
+        betanom = sqrt( MAGMA_Z_REAL( skp[1] ));
+
+        if ( solver_par->verbose > 0 ) {
+            tempo2 = magma_wtime();
+            if ( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) betanom;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+
+        if (  betanom  < solver_par->atol ||
+              betanom/nomb < solver_par->rtol ) {
+            break;
+        }
+    }
+    while ( solver_par->numiter+1 <= solver_par->maxiter );
+
+    tempo2 = magma_wtime();
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    // r = b - A x
+    blasf77_zcopy( &dofs, b.val, &ione, r.val, &ione );
+    CHECK( magma_zgecsrmv_cpu( MagmaNoTrans, dofs, dofs, -c_one, Acsr.val, Acsr.row,
+                               Acsr.col, x->val, c_one, r.val, queue ));
+    solver_par->iter_res = betanom;
+    solver_par->final_res = magma_cblas_dznrm2( dofs, r.val, 1 );
+
+    if ( info == MAGMA_DIVERGENCE ) {
+        // breakdown (rho or <rr,v> vanished) in the iteration; keep info
+    }
+    else if ( solver_par->numiter < solver_par->maxiter ) {
+        info = MAGMA_SUCCESS;
+    } else if ( solver_par->init_res > solver_par->final_res ) {
+        info = MAGMA_SLOW_CONVERGENCE;
+        if( solver_par->iter_res < solver_par->atol ||
+            solver_par->iter_res/solver_par->init_res < solver_par->rtol ){
+            info = MAGMA_SUCCESS;
+        }
+    }
+    else {
+        info = MAGMA_DIVERGENCE;
+    }
+
+cleanup:
+    if ( Acsr.val != A.val ) {
+        magma_zmfree(&Acsr, queue );
+    }
+    magma_zmfree(&r, queue );
+    magma_zmfree(&rr, queue );
+    magma_zmfree(&p, queue );
+    magma_zmfree(&v, queue );
+    magma_zmfree(&pnew, queue );
+    magma_zmfree(&vnew, queue );
+    magma_zmfree(&s, queue );
+    magma_zmfree(&t, queue );
+
+    solver_par->info = info;
+    return info;
+}   /* magma_zbicgstab_cpu */
@@ -0,0 +1,248 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+
+
+/**
+    Purpose
+    -------
+
+    Solves a system of linear equations
+       A * X = B
+    where A is a complex Hermitian N-by-N positive definite matrix A.
+    This is a CPU implementation of the Conjugate Gradient method, for A, b,
+    and x located on the CPU, optionally preconditioned by the diagonal of A
+    (precond_par->solver = Magma_JACOBI) or by its diagonal blocks
+    (Magma_VBJACOBI, see magma_zvbjacobisetup_cpu).
+
+    Each iteration makes two passes over memory: the search direction
+    update is merged into the SpMV (magma_zcgmerge_spmv1_cpu), and the
+    solution and residual updates are merged with the dot products
+    (magma_zcgmerge_xrbeta_cpu).
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A on the CPU
+
+    @param[in]
+    b           magma_z_matrix
+                RHS b on the CPU
+
+    @param[in,out]
+    x           magma_z_matrix*
+                solution approximation on the CPU
+
+    @param[in,out]
+    solver_par  magma_z_solver_par*
+                solver parameters
+
+    @param[in]
+    precond_par magma_z_preconditioner*
+                preconditioner; Magma_NONE, Magma_JACOBI, or Magma_VBJACOBI.
+                May be NULL.
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zposv
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zcg_cpu(
+    magma_z_matrix A, magma_z_matrix b, magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue )
+{
+    magma_int_t info = MAGMA_NOTCONVERGED;
+
+    bool jacobi = ( precond_par != NULL && precond_par->solver == Magma_JACOBI );
+    bool vbjacobi = ( precond_par != NULL && precond_par->solver == Magma_VBJACOBI );
+
+    // prepare solver feedback
+    solver_par->solver = ( jacobi || vbjacobi ) ? Magma_PCG : Magma_CG;
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+
+    // local variables
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE;
+    magmaDoubleComplex alpha, beta, skp;
+    double nom0, rh, rh_old, rr, betanom, nomb;
+    real_Double_t tempo1, tempo2;
+
+    magma_int_t dofs = A.num_rows;
+    const magma_int_t ione = 1;
+
+    // CPU workspace
+    magma_z_matrix Acsr={Magma_CSR}, r={Magma_CSR}, h={Magma_CSR}, d={Magma_CSR},
+                   dnew={Magma_CSR}, z={Magma_CSR}, dinv={Magma_CSR};
+    magmaDoubleComplex *dswap;
+
+    if ( A.memory_location != Magma_CPU || b.memory_location != Magma_CPU ||
+         x->memory_location != Magma_CPU ) {
+        info = MAGMA_ERR_INVALID_PTR;
+        goto cleanup;
+    }
+    if ( precond_par != NULL && precond_par->solver != Magma_NONE && ! jacobi && ! vbjacobi ) {
+        printf("error: only (block) Jacobi preconditioning is supported on the CPU.\n");
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    if ( A.storage_type == Magma_CSR ) {
+        Acsr = A;
+    }
+    else {
+        CHECK( magma_zmconvert( A, &Acsr, A.storage_type, Magma_CSR, queue ));
+    }
+    CHECK( magma_zvinit( &r,    Magma_CPU, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &d,    Magma_CPU, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &dnew, Magma_CPU, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &z,    Magma_CPU, dofs, 1, c_zero, queue ));
+    if ( jacobi ) {
+        CHECK( magma_zvinit( &h,    Magma_CPU, dofs, 1, c_zero, queue ));
+        CHECK( magma_zvinit( &dinv, Magma_CPU, dofs, 1, c_one,  queue ));
+        for( magma_int_t i=0; i < dofs; i++ ) {
+            for( magma_index_t j=Acsr.row[i]; j < Acsr.row[i+1]; j++ ) {
+                if ( Acsr.col[j] == i && MAGMA_Z_ABS( Acsr.val[j] ) != 0.0 ) {
+                    dinv.val[i] = c_one / Acsr.val[j];
+                }
+            }
+        }
+    }
+    if ( vbjacobi ) {
+        CHECK( magma_zvinit( &h,    Magma_CPU, dofs, 1, c_zero, queue ));
+        CHECK( magma_zvbjacobisetup_cpu( Acsr, precond_par, queue ));
+    }
+
+    // solver setup
+    // r = b - A x
+    blasf77_zcopy( &dofs, b.val, &ione, r.val, &ione );
+    CHECK( magma_zgecsrmv_cpu( MagmaNoTrans, dofs, dofs, -c_one, Acsr.val, Acsr.row,
+                               Acsr.col, x->val, c_one, r.val, queue ));
+    // h = M^{-1} r; first merged sweep with beta = 0 gives d = h
+    CHECK( magma_zcgmerge_xrbeta_cpu( dofs, c_zero, dinv.val, x->val, r.val,
+                                      (jacobi ? h.val : r.val), d.val, z.val,
+                                      &rh, &rr, queue ));
+    if ( vbjacobi ) {
+        CHECK( magma_zvbjacobiapply_cpu( r, &h, precond_par, queue ));
+        rh = MAGMA_Z_REAL( magma_cblas_zdotc( dofs, r.val, 1, h.val, 1 ));
+    }
+    nom0 = betanom = sqrt( rr );
+    beta = c_zero;
+    solver_par->init_res = nom0;
+
+    nomb = magma_cblas_dznrm2( dofs, b.val, 1 );
+    if ( nomb == 0.0 ){
+        nomb=1.0;
+    }
+    solver_par->final_res = solver_par->init_res;
+    solver_par->iter_res = solver_par->init_res;
+    if ( solver_par->verbose > 0 ) {
+        solver_par->res_vec[0] = (real_Double_t) nom0;
+        solver_par->timing[0] = 0.0;
+    }
+    if ( nom0 < solver_par->atol ||
+         nom0/nomb < solver_par->rtol ){
+        info = MAGMA_SUCCESS;
+        goto cleanup;
+    }
+
+    //Chronometry
+    tempo1 = magma_wtime();
+
+    // start iteration
+    do
+    {
+        solver_par->numiter++;
+
+        // d = h + beta d;  z = A d;  skp = d' z
+        CHECK( magma_zcgmerge_spmv1_cpu( Acsr, beta, (jacobi || vbjacobi ? h.val : r.val),
+                                         d.val, dnew.val, z.val, &skp, queue ));
+        solver_par->spmv_count++;
+        dswap = d.val;  d.val = dnew.val;  dnew.val = dswap;
+
+        // check positive definite
+        if ( MAGMA_Z_REAL( skp ) <= 0.0 ) {
+            info = MAGMA_NONSPD;
+            goto cleanup;
+        }
+        alpha = MAGMA_Z_MAKE( rh / MAGMA_Z_REAL( skp ), 0. );
+
+        // x = x + alpha d;  r = r - alpha z;  h = M^{-1} r;  rh = r' h;  rr = r' r
+        rh_old = rh;
+        CHECK( magma_zcgmerge_xrbeta_cpu( dofs, alpha, dinv.val, x->val, r.val,
+                                          (jacobi ? h.val : r.val), d.val, z.val,
+                                          &rh, &rr, queue ));
+        if ( vbjacobi ) {
+            CHECK( magma_zvbjacobiapply_cpu( r, &h, precond_par, queue ));
+            rh = MAGMA_Z_REAL( magma_cblas_zdotc( dofs, r.val, 1, h.val, 1 ));
+        }
+        betanom = sqrt( rr );
+        beta = MAGMA_Z_MAKE( rh / rh_old, 0. );
+
+        if ( solver_par->verbose > 0 ) {
+            tempo2 = magma_wtime();
+            if ( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) betanom;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+
+        if (  betanom  < solver_par->atol ||
+              betanom/nomb < solver_par->rtol ) {
+            break;
+        }
+    }
+    while ( solver_par->numiter+1 <= solver_par->maxiter );
+
+    tempo2 = magma_wtime();
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    // r = b - A x
+    blasf77_zcopy( &dofs, b.val, &ione, r.val, &ione );
+    CHECK( magma_zgecsrmv_cpu( MagmaNoTrans, dofs, dofs, -c_one, Acsr.val, Acsr.row,
+                               Acsr.col, x->val, c_one, r.val, queue ));
+    solver_par->iter_res = betanom;
+    solver_par->final_res = magma_cblas_dznrm2( dofs, r.val, 1 );
+
+    if ( solver_par->numiter < solver_par->maxiter ) {
+        info = MAGMA_SUCCESS;
+    } else if ( solver_par->init_res > solver_par->final_res ) {
+        info = MAGMA_SLOW_CONVERGENCE;
+        if( solver_par->iter_res < solver_par->atol ||
+            solver_par->iter_res/solver_par->init_res < solver_par->rtol ){
+            info = MAGMA_SUCCESS;
+        }
+    }
+    else {
+        info = MAGMA_DIVERGENCE;
+    }
+
+cleanup:
+    if ( Acsr.val != A.val ) {
+        magma_zmfree(&Acsr, queue );
+    }
+    magma_zmfree(&r, queue );
+    magma_zmfree(&h, queue );
+    magma_zmfree(&d, queue );
+    magma_zmfree(&dnew, queue );
+    magma_zmfree(&z, queue );
+    magma_zmfree(&dinv, queue );
+
+    solver_par->info = info;
+    return info;
+}   /* magma_zcg_cpu */
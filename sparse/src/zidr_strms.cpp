@@ -208,7 +208,7 @@ magma_zidr_strms(
     // P = randn(n, s)
     distr = 3;        // 1 = unif (0,1), 2 = unif (-1,1), 3 = normal (0,1) 
     dof = dP.num_rows * dP.num_cols;
-    lapackf77_zlarnv( &distr, iseed, &dof, dP.val );
+    magma_zlarnv( distr, iseed, dof, dP.val );
 
     // transfer P to device
     CHECK( magma_zmtransfer( dP, &dP1, Magma_CPU, Magma_DEV, queue ));
@@ -17,6 +17,109 @@
 
 #define PRECISION_z
 
+#if CUDA_VERSION >= 11000 || defined(MAGMA_HAVE_HIP)
+#define cusparseDestroySolveAnalysisInfo(info) cusparseDestroyCsrsm2Info(info)
+#endif
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+
+    Prints the ILU residual ||A - LU||_F of the current ParILU factors,
+    and the nonlinear residual on the pattern of the factors.
+*******************************************************************************/
+
+static magma_int_t
+zparilu_report(
+    magma_z_matrix A,
+    magma_z_preconditioner *precond,
+    magma_int_t sweep,
+    real_Double_t *nonlinres,
+    magma_queue_t queue)
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hUT={Magma_CSR}, hLU={Magma_CSR};
+    real_Double_t res = 0.0;
+
+    CHECK(magma_z_cucsrtranspose(precond->hU, &hUT, queue));
+    CHECK(magma_zilures(A, precond->hL, hUT, &hLU, &res, nonlinres, queue));
+    printf("%% ParILU sweep %4lld: ILU residual %.4e  nonlinear residual %.4e\n",
+           (long long) sweep, res, *nonlinres);
+
+cleanup:
+    magma_zmfree(&hUT, queue);
+    magma_zmfree(&hLU, queue);
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+
+    Copies the ParILU factors precond->hL and precond->hU (U^T in CSR) to
+    the device factors precond->L and precond->U, and sets up the
+    triangular solves. If update is set, the device factors already have
+    the pattern of the host factors, from an earlier call, and only their
+    values are copied; else they are allocated.
+*******************************************************************************/
+
+static magma_int_t
+zparilu_setup_device(
+    magma_int_t n,
+    magma_z_preconditioner *precond,
+    bool update,
+    magma_queue_t queue)
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hUT={Magma_CSR};
+    magmaDoubleComplex *Uval = NULL;
+
+    if (update) {
+        CHECK(magma_zmalloc_cpu(&Uval, precond->hU.nnz));
+        CHECK(magma_zmtranspose_values(precond->hU, Uval, queue));
+        magma_zsetvector(precond->hL.nnz, precond->hL.val, 1, precond->L.dval, 1, queue);
+        magma_zsetvector(precond->hU.nnz, Uval, 1, precond->U.dval, 1, queue);
+    } else {
+        CHECK(magma_z_cucsrtranspose(precond->hU, &hUT, queue));
+        CHECK(magma_zmtransfer(precond->hL, &precond->L, Magma_CPU, Magma_DEV, queue));
+        CHECK(magma_zmtransfer(hUT, &precond->U, Magma_CPU, Magma_DEV, queue));
+    }
+    
+    if (precond->trisolver == 0 || precond->trisolver == Magma_CUSOLVE) {
+        if (update) {
+            cusparseDestroySolveAnalysisInfo(precond->cuinfoL);
+            cusparseDestroySolveAnalysisInfo(precond->cuinfoU);
+        }
+        CHECK(magma_zcumilugeneratesolverinfo(precond, queue));
+    } else {
+        //prepare for iterative solves
+        if (update) {
+            magma_zmfree(&precond->d, queue);
+            magma_zmfree(&precond->d2, queue);
+        }
+
+        // extract the diagonal of L into precond->d
+        CHECK(magma_zjacobisetup_diagscal(precond->L, &precond->d, queue));
+        // extract the diagonal of U into precond->d2
+        CHECK(magma_zjacobisetup_diagscal(precond->U, &precond->d2, queue));
+        if (! update) {
+            CHECK(magma_zvinit(&precond->work1, Magma_DEV, n, 1, 
+                MAGMA_Z_ZERO, queue));
+            CHECK(magma_zvinit(&precond->work2, Magma_DEV, n, 1, 
+                MAGMA_Z_ZERO, queue));
+        }
+    }
+
+cleanup:
+    magma_zmfree(&hUT, queue);
+    magma_free_cpu(Uval);
+    return info;
+}
+
 
 /***************************************************************************//**
     Purpose
@@ -29,6 +132,30 @@
     
     This is the CPU implementation of the ParILU
 
+    If precond->reuse is set, the pattern-derived data (the ILU(k) pattern,
+    the COO form of A, and the factors on the CPU and the device) are kept in
+    precond. A later call with a matrix of the same sparsity pattern, e.g.,
+    in a time-dependent or nonlinear solve, then only copies the new values
+    of A into the stored pattern and runs the sweeps, starting from the
+    stored host factors (warm start). If the pattern of A changed, the full
+    setup is done. Then, in a separate step, the device factors are
+    updated: only their values are copied if they have the stored pattern,
+    else they are set up anew.
+
+    By default, precond->sweeps synchronous sweeps are done. If
+    precond->verbose > 0, the ILU residual is printed every precond->verbose
+    sweeps; init_res and final_res in precond are set to the nonlinear
+    residual before and after the sweeps.
+
+    If precond->async is set, the sweeps run asynchronously instead, and
+    stop early once the nonlinear residual estimated during the sweeps is
+    at most max(precond->atol, precond->rtol * the residual of the first
+    sweep). The factors then depend on the scheduling of the threads.
+    init_res and final_res are set to the estimated residual in the first
+    and last sweep, and numiter to the number of sweeps done; with
+    precond->verbose > 0, the ILU residual is also printed between chunks
+    of precond->verbose sweeps.
+
     Arguments
     ---------
 
@@ -64,78 +191,151 @@ magma_zparilu_cpu(
 #ifdef _OPENMP
     info = 0;
 
-    magma_z_matrix hAT={Magma_CSR}, hA={Magma_CSR}, hAL={Magma_CSR}, 
-    hAU={Magma_CSR}, hAUT={Magma_CSR}, hAtmp={Magma_CSR}, hACOO={Magma_CSR};
+    magma_z_matrix hAT={Magma_CSR}, hAcopy={Magma_CSR}, hAL={Magma_CSR}, 
+    hAUT={Magma_CSR}, hACSR={Magma_CSR}, hA, empty={Magma_CSR};
+    real_Double_t nonlinres = 0.0;
+    double res0 = 0.0, res = 0.0, atol, rtol;
+    magma_int_t done, nsweeps = 0;
+    bool reuse, update, stored = false;
 
-    // copy original matrix as COO to device
+    // A in CSR on the CPU; no copy if it already is
     if (A.memory_location != Magma_CPU || A.storage_type != Magma_CSR) {
         CHECK(magma_zmtransfer(A, &hAT, A.memory_location, Magma_CPU, queue));
-        CHECK(magma_zmconvert(hAT, &hA, hAT.storage_type, Magma_CSR, queue));
+        CHECK(magma_zmconvert(hAT, &hACSR, hAT.storage_type, Magma_CSR, queue));
         magma_zmfree(&hAT, queue);
+        hA = hACSR;
     } else {
-        CHECK(magma_zmtransfer(A, &hA, A.memory_location, Magma_CPU, queue));
+        hA = A;
     }
 
-    // in case using fill-in
-    if (precond->levels > 0) {
-        CHECK(magma_zsymbilu(&hA, precond->levels, &hAL, &hAUT,  queue));
-        magma_zmfree(&hAL, queue);
-        magma_zmfree(&hAUT, queue);
+    // numeric refactorization on the stored host pattern and factors,
+    // if the pattern still fits A
+    reuse = precond->reuse == MagmaTrue
+        && precond->hA.val != NULL
+        && precond->hL.val != NULL
+        && precond->hU.val != NULL
+        && magma_zmrefill(hA, MagmaFull, &precond->hA, queue) == MAGMA_SUCCESS;
+    stored = reuse;
+
+    if (! reuse) {
+        if (precond->reuse == MagmaTrue && precond->hA.val != NULL) {
+            // the pattern changed: drop the previous setup
+            if (precond->trisolver == 0 || precond->trisolver == Magma_CUSOLVE) {
+                cusparseDestroySolveAnalysisInfo(precond->cuinfoL);
+                cusparseDestroySolveAnalysisInfo(precond->cuinfoU);
+            }
+            magma_zmfree(&precond->hA, queue);
+            magma_zmfree(&precond->hL, queue);
+            magma_zmfree(&precond->hU, queue);
+            magma_zmfree(&precond->L, queue);
+            magma_zmfree(&precond->U, queue);
+            magma_zmfree(&precond->d, queue);
+            magma_zmfree(&precond->d2, queue);
+            magma_zmfree(&precond->work1, queue);
+            magma_zmfree(&precond->work2, queue);
+        }
+        precond->hA = empty;
+        precond->hL = empty;
+        precond->hU = empty;
+        stored = true;
+        CHECK(magma_zmtransfer(hA, &hAcopy, Magma_CPU, Magma_CPU, queue));
+
+        // in case using fill-in
+        if (precond->levels > 0) {
+            CHECK(magma_zsymbilu(&hAcopy, precond->levels, &hAL, &hAUT,  queue));
+            magma_zmfree(&hAL, queue);
+            magma_zmfree(&hAUT, queue);
+        }
+        CHECK(magma_zmconvert(hAcopy, &precond->hA, hAcopy.storage_type, Magma_CSRCOO, queue));
+        
+        //get L
+        CHECK(magma_zmatrix_tril(hAcopy, &precond->hL, queue));
+        // we need 1 on the main diagonal of L
+        #pragma omp parallel for
+        for (int k=0; k < precond->hL.num_rows; k++) {
+            precond->hL.val[precond->hL.row[k+1]-1] = MAGMA_Z_ONE;
+        }
+        
+        // get U
+        CHECK(magma_zmtranspose(hAcopy, &hAT, queue));
+        CHECK(magma_zmatrix_tril(hAT, &precond->hU, queue));
+        magma_zmfree(&hAT, queue);
     }
-    CHECK(magma_zmconvert(hA, &hACOO, hA.storage_type, Magma_CSRCOO, queue));
-    
-    //get L
-    magma_zmatrix_tril(hA, &hAL, queue);
-    // we need 1 on the main diagonal of L
-    #pragma omp parallel for
-    for (int k=0; k < hAL.num_rows; k++) {
-        hAL.val[hAL.row[k+1]-1] = MAGMA_Z_ONE;
+
+    if (precond->verbose > 0) {
+        CHECK(zparilu_report(hA, precond, 0, &nonlinres, queue));
+        precond->init_res = nonlinres;
     }
     
-    // get U
-    magma_zmtranspose(hA, &hAT, queue);
-    magma_zmatrix_tril(hAT, &hAU, queue);
-    magma_zmfree(&hAT, queue);
-    
     // This is the actual ParILU kernel. 
     // It can be called directly if
     // - the system matrix hACOO is available in COO format on the CPU 
     // - hAL is the lower triangular in CSR on the CPU
     // - hAU is the upper triangular in CSC on the CPU (U transpose in CSR)
-    // The kernel is located in sparse/control/magma_zparilu_kernels.cpp
+    // The kernels are located in sparse/control/magma_zparilu_kernels.cpp
     //
-    for (int i=0; i<precond->sweeps; i++) {
-        CHECK(magma_zparilu_sweep(hACOO, &hAL, &hAU, queue));
+    // The asynchronous sweeps are done in chunks of precond->verbose sweeps
+    // to report in between; the stopping criterion of the first chunk is
+    // kept as absolute tolerance for the following ones.
+    if (precond->async == MagmaTrue) {
+        done = 0;
+        atol = precond->atol;
+        rtol = precond->rtol;
+        while (done < precond->sweeps) {
+            magma_int_t chunk = precond->sweeps - done;
+            if (precond->verbose > 0) {
+                chunk = min(chunk, precond->verbose);
+            }
+            CHECK(magma_zparilu_sweep_async(precond->hA, &precond->hL, &precond->hU,
+                                            chunk, atol, rtol, &nsweeps, &res0, &res,
+                                            queue));
+            if (done == 0) {
+                precond->init_res = res0;
+                atol = max(atol, rtol * res0);
+                rtol = 0.0;
+            }
+            precond->final_res = res;
+            done += nsweeps;
+            if (precond->verbose > 0) {
+                CHECK(zparilu_report(hA, precond, done, &nonlinres, queue));
+            }
+            if (res <= atol) {
+                break;
+            }
+        }
+        precond->numiter = done;
     }
-    CHECK(magma_z_cucsrtranspose(hAU, &hAUT, queue));
-
-    CHECK(magma_zmtransfer(hAL, &precond->L, Magma_CPU, Magma_DEV, queue));
-    CHECK(magma_zmtransfer(hAUT, &precond->U, Magma_CPU, Magma_DEV, queue));
-    
-    if (precond->trisolver == 0 || precond->trisolver == Magma_CUSOLVE) {
-        CHECK(magma_zcumilugeneratesolverinfo(precond, queue));
-    } else {
-        //prepare for iterative solves
-
-        // extract the diagonal of L into precond->d
-        CHECK(magma_zjacobisetup_diagscal(precond->L, &precond->d, queue));
-        CHECK(magma_zvinit(&precond->work1, Magma_DEV, hA.num_rows, 1, 
-            MAGMA_Z_ZERO, queue));
-
-        // extract the diagonal of U into precond->d2
-        CHECK(magma_zjacobisetup_diagscal(precond->U, &precond->d2, queue));
-        CHECK(magma_zvinit(&precond->work2, Magma_DEV, hA.num_rows, 1, 
-            MAGMA_Z_ZERO, queue));
+    else {
+        for (int i=0; i<precond->sweeps; i++) {
+            CHECK(magma_zparilu_sweep(precond->hA, &precond->hL, &precond->hU, queue));
+            if (precond->verbose > 0 && 
+                ((i+1) % precond->verbose == 0 || i+1 == precond->sweeps)) {
+                CHECK(zparilu_report(hA, precond, i+1, &nonlinres, queue));
+                precond->final_res = nonlinres;
+            }
+        }
+        precond->numiter = precond->sweeps;
     }
 
+    // the device factors have the stored pattern if they are from a call
+    // with it
+    update = reuse
+        && precond->L.memory_location == Magma_DEV
+        && precond->L.nnz == precond->hL.nnz
+        && precond->U.nnz == precond->hU.nnz;
+    CHECK(zparilu_setup_device(hA.num_rows, precond, update, queue));
+
 cleanup:
+    if (stored && (info != 0 || precond->reuse != MagmaTrue)) {
+        magma_zmfree(&precond->hA, queue);
+        magma_zmfree(&precond->hL, queue);
+        magma_zmfree(&precond->hU, queue);
+    }
     magma_zmfree(&hAT, queue);
-    magma_zmfree(&hA, queue);
+    magma_zmfree(&hAcopy, queue);
+    magma_zmfree(&hACSR, queue);
     magma_zmfree(&hAL, queue);
-    magma_zmfree(&hAU, queue);
     magma_zmfree(&hAUT, queue);
-    magma_zmfree(&hAtmp, queue);
-    magma_zmfree(&hACOO, queue);
 
 #endif
     return info;
@@ -11,6 +11,7 @@
 */
 
 #include "magmasparse_internal.h"
+#include "magma_timer.h"
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -80,7 +81,9 @@ magma_zparilut_cpu(
     real_Double_t start, end;
     real_Double_t t_rm=0.0, t_add=0.0, t_res=0.0, t_sweep1=0.0, t_sweep2=0.0, 
         t_cand=0.0, t_sort=0.0, t_transpose1=0.0, t_transpose2=0.0, t_selectrm=0.0,
-        t_nrm=0.0, t_total = 0.0, accum=0.0;
+        t_nrm=0.0, t_total = 0.0, accum=0.0, t_sweeps=0.0;
+    // hardware counters of all sweeps, with ENABLE_TIMER
+    magma_counters_t c_sweep = { 0, 0, 0, 0 }, c_sweeps = { 0, 0, 0, 0 };
                     
     double sum, sumL, sumU;
 
@@ -186,7 +189,9 @@ magma_zparilut_cpu(
         
         // step 7: sweep
         start = magma_sync_wtime(queue);
+        counters_start( c_sweep );
         CHECK(magma_zparilut_sweep_sync(&hA, &L_new, &U_new, queue));
+        magma_counters_add( c_sweeps, counters_stop( c_sweep ));
         end = magma_sync_wtime(queue); t_sweep1+=end-start;
         
         
@@ -229,8 +234,11 @@ magma_zparilut_cpu(
         
         // step 10: sweep
         start = magma_sync_wtime(queue);
+        counters_start( c_sweep );
         CHECK(magma_zparilut_sweep_sync(&hA, &L, &U, queue));
+        magma_counters_add( c_sweeps, counters_stop( c_sweep ));
         end = magma_sync_wtime(queue); t_sweep2+=end-start;
+        t_sweeps += t_sweep1 + t_sweep2;
         
         if (timing == 1) {
             t_total = t_transpose1+ t_cand+ t_res+ t_sort+ t_transpose2+ t_add+ t_sweep1+ t_selectrm+ t_rm+ t_sweep2;
@@ -245,6 +253,7 @@ magma_zparilut_cpu(
 
     if (timing == 1) {
         printf("]; \n");
+        counters_printf( "% ParILUT sweeps", c_sweeps, t_sweeps );
         fflush(stdout);
     }
     //##########################################################################
@@ -0,0 +1,290 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+
+
+/******************************************************************************/
+// x = M^{-1} b for the host preconditioners.
+static magma_int_t
+zpbicgstab_cpu_precond(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    switch( precond_par->solver ) {
+        case  Magma_VBJACOBI:
+                CHECK( magma_zvbjacobiapply_cpu( b, x, precond_par, queue )); break;
+        case  Magma_SCHWARZ:
+                CHECK( magma_zschwarz_apply_cpu( b, x, precond_par, queue )); break;
+        default:
+                info = MAGMA_ERR_NOT_SUPPORTED;
+                break;
+    }
+cleanup:
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Solves a system of linear equations
+       A * X = B
+    where A is a general N-by-N matrix A.
+    This is a CPU implementation of the right-preconditioned Biconjugate
+    Gradient Stabilized method, for A, b, and x located on the CPU,
+    preconditioned by the diagonal blocks of A (Magma_VBJACOBI, see
+    magma_zvbjacobisetup_cpu) or by restricted additive Schwarz
+    (Magma_SCHWARZ, see magma_zschwarz_setup_cpu).
+
+    The preconditioner is set up here, and applied twice per iteration.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A on the CPU
+
+    @param[in]
+    b           magma_z_matrix
+                RHS b on the CPU
+
+    @param[in,out]
+    x           magma_z_matrix*
+                solution approximation on the CPU
+
+    @param[in,out]
+    solver_par  magma_z_solver_par*
+                solver parameters
+
+    @param[in,out]
+    precond_par magma_z_preconditioner*
+                preconditioner; Magma_VBJACOBI or Magma_SCHWARZ.
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgesv
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zpbicgstab_cpu(
+    magma_z_matrix A, magma_z_matrix b, magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue )
+{
+    magma_int_t info = MAGMA_NOTCONVERGED;
+
+    // prepare solver feedback
+    solver_par->solver = Magma_PBICGSTAB;
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+
+    // local variables
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE;
+    magmaDoubleComplex alpha, beta, omega, rho_old, rho_new, tmp;
+    double nom0, betanom, nomb;
+    real_Double_t tempo1, tempo2;
+
+    magma_int_t dofs = A.num_rows;
+    const magma_int_t ione = 1;
+
+    // CPU workspace
+    magma_z_matrix Acsr={Magma_CSR}, r={Magma_CSR}, rr={Magma_CSR}, p={Magma_CSR},
+                   v={Magma_CSR}, s={Magma_CSR}, t={Magma_CSR}, y={Magma_CSR},
+                   z={Magma_CSR};
+
+    if ( A.memory_location != Magma_CPU || b.memory_location != Magma_CPU ||
+         x->memory_location != Magma_CPU ) {
+        info = MAGMA_ERR_INVALID_PTR;
+        goto cleanup;
+    }
+    if ( precond_par->solver != Magma_VBJACOBI && precond_par->solver != Magma_SCHWARZ ) {
+        printf("error: only VBJACOBI and SCHWARZ preconditioning are supported for BiCGSTAB on the CPU.\n");
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    if ( A.storage_type == Magma_CSR ) {
+        Acsr = A;
+    }
+    else {
+        CHECK( magma_zmconvert( A, &Acsr, A.storage_type, Magma_CSR, queue ));
+    }
+    CHECK( magma_zvinit( &r,  Magma_CPU, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &rr, Magma_CPU, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &p,  Magma_CPU, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &v,  Magma_CPU, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &s,  Magma_CPU, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &t,  Magma_CPU, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &y,  Magma_CPU, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &z,  Magma_CPU, dofs, 1, c_zero, queue ));
+    if ( precond_par->solver == Magma_VBJACOBI ) {
+        CHECK( magma_zvbjacobisetup_cpu( Acsr, precond_par, queue ));
+    }
+    else {
+        CHECK( magma_zschwarz_setup_cpu( Acsr, precond_par, queue ));
+    }
+
+    // solver setup
+    // r = b - A x;  rr = r
+    blasf77_zcopy( &dofs, b.val, &ione, r.val, &ione );
+    CHECK( magma_zgecsrmv_cpu( MagmaNoTrans, dofs, dofs, -c_one, Acsr.val, Acsr.row,
+                               Acsr.col, x->val, c_one, r.val, queue ));
+    blasf77_zcopy( &dofs, r.val, &ione, rr.val, &ione );
+    rho_new = omega = alpha = c_one;
+    nom0 = betanom = magma_cblas_dznrm2( dofs, r.val, 1 );
+    solver_par->init_res = nom0;
+
+    nomb = magma_cblas_dznrm2( dofs, b.val, 1 );
+    if ( nomb == 0.0 ){
+        nomb=1.0;
+    }
+    solver_par->final_res = solver_par->init_res;
+    solver_par->iter_res = solver_par->init_res;
+    if ( solver_par->verbose > 0 ) {
+        solver_par->res_vec[0] = (real_Double_t) nom0;
+        solver_par->timing[0] = 0.0;
+    }
+    if ( nom0 < solver_par->atol ||
+         nom0/nomb < solver_par->rtol ){
+        info = MAGMA_SUCCESS;
+        goto cleanup;
+    }
+
+    //Chronometry
+    tempo1 = magma_wtime();
+
+    // start iteration
+    do
+    {
+        solver_par->numiter++;
+
+        rho_old = rho_new;
+        rho_new = magma_cblas_zdotc( dofs, rr.val, 1, r.val, 1 );   // rho=<rr,r>
+        beta = rho_new/rho_old * alpha/omega;   // beta=rho/rho_old *alpha/omega
+        if( magma_z_isnan_inf( beta ) ){
+            info = MAGMA_DIVERGENCE;
+            break;
+        }
+
+        // p = r + beta * ( p - omega * v );  y = M^{-1} p;  v = A y
+        #pragma omp parallel for schedule(static)
+        for( magma_int_t i=0; i < dofs; i++ ) {
+            p.val[i] = r.val[i] + beta * ( p.val[i] - omega * v.val[i] );
+        }
+        CHECK( zpbicgstab_cpu_precond( p, &y, precond_par, queue ));
+        CHECK( magma_zgecsrmv_cpu( MagmaNoTrans, dofs, dofs, c_one, Acsr.val, Acsr.row,
+                                   Acsr.col, y.val, c_zero, v.val, queue ));
+        solver_par->spmv_count++;
+
+        alpha = rho_new / magma_cblas_zdotc( dofs, rr.val, 1, v.val, 1 );
+        if( magma_z_isnan_inf( alpha ) ){
+            info = MAGMA_DIVERGENCE;
+            break;
+        }
+
+        // s = r - alpha v;  z = M^{-1} s;  t = A z
+        #pragma omp parallel for schedule(static)
+        for( magma_int_t i=0; i < dofs; i++ ) {
+            s.val[i] = r.val[i] - alpha * v.val[i];
+        }
+        CHECK( zpbicgstab_cpu_precond( s, &z, precond_par, queue ));
+        CHECK( magma_zgecsrmv_cpu( MagmaNoTrans, dofs, dofs, c_one, Acsr.val, Acsr.row,
+                                   Acsr.col, z.val, c_zero, t.val, queue ));
+        solver_par->spmv_count++;
+
+        // omega = <t,s>/<t,t>
+        tmp = magma_cblas_zdotc( dofs, t.val, 1, t.val, 1 );
+        omega = magma_cblas_zdotc( dofs, t.val, 1, s.val, 1 ) / tmp;
+        if( magma_z_isnan_inf( omega ) ){
+            // t = 0: s is the residual of x + alpha y
+            blasf77_zaxpy( &dofs, &alpha, y.val, &ione, x->val, &ione );
+            blasf77_zcopy( &dofs, s.val, &ione, r.val, &ione );
+            betanom = magma_cblas_dznrm2( dofs, r.val, 1 );
+            if ( betanom >= solver_par->atol && betanom/nomb >= solver_par->rtol ) {
+                info = MAGMA_DIVERGENCE;
+            }
+            break;
+        }
+
+        // x = x + alpha y + omega z;  r = s - omega t
+        #pragma omp parallel for schedule(static)
+        for( magma_int_t i=0; i < dofs; i++ ) {
+            x->val[i] += alpha * y.val[i] + omega * z.val[i];
+            r.val[i] = s.val[i] - omega * t.val[i];
+        }
+        betanom = magma_cblas_dznrm2( dofs, r.val, 1 );
+
+        if ( solver_par->verbose > 0 ) {
+            tempo2 = magma_wtime();
+            if ( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) betanom;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+
+        if (  betanom  < solver_par->atol ||
+              betanom/nomb < solver_par->rtol ) {
+            break;
+        }
+    }
+    while ( solver_par->numiter+1 <= solver_par->maxiter );
+
+    tempo2 = magma_wtime();
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    // r = b - A x
+    blasf77_zcopy( &dofs, b.val, &ione, r.val, &ione );
+    CHECK( magma_zgecsrmv_cpu( MagmaNoTrans, dofs, dofs, -c_one, Acsr.val, Acsr.row,
+                               Acsr.col, x->val, c_one, r.val, queue ));
+    solver_par->iter_res = betanom;
+    solver_par->final_res = magma_cblas_dznrm2( dofs, r.val, 1 );
+
+    if ( info == MAGMA_DIVERGENCE ) {
+        // breakdown in the iteration; keep info
+    }
+    else if ( solver_par->numiter < solver_par->maxiter ) {
+        info = MAGMA_SUCCESS;
+    } else if ( solver_par->init_res > solver_par->final_res ) {
+        info = MAGMA_SLOW_CONVERGENCE;
+        if( solver_par->iter_res < solver_par->atol ||
+            solver_par->iter_res/solver_par->init_res < solver_par->rtol ){
+            info = MAGMA_SUCCESS;
+        }
+    }
+    else {
+        info = MAGMA_DIVERGENCE;
+    }
+
+cleanup:
+    if ( Acsr.val != A.val ) {
+        magma_zmfree(&Acsr, queue );
+    }
+    magma_zmfree(&r, queue );
+    magma_zmfree(&rr, queue );
+    magma_zmfree(&p, queue );
+    magma_zmfree(&v, queue );
+    magma_zmfree(&s, queue );
+    magma_zmfree(&t, queue );
+    magma_zmfree(&y, queue );
+    magma_zmfree(&z, queue );
+
+    solver_par->info = info;
+    return info;
+}   /* magma_zpbicgstab_cpu */
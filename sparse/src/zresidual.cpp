@@ -19,6 +19,8 @@
     -------
 
     Computes the residual ||b-Ax|| for a solution approximation x.
+    For several right-hand sides, res gets the residual of each column.
+    If A is on the CPU, so are b and x, which may be row- or column-major.
 
     Arguments
     ---------
@@ -65,7 +67,23 @@ magma_zresidual(
     
     magma_z_matrix r = {Magma_CSR};
     
-    if ( A.num_rows == b.num_rows ) {
+    if ( A.memory_location == Magma_CPU && A.num_rows == b.num_rows ) {
+        // column i of a row-major block starts at entry i, with stride num_cols
+        magma_int_t nvecs = b.num_cols;
+        magma_int_t bstart = ( b.major == MagmaRowMajor ? 1 : dofs );
+        magma_int_t binc   = ( b.major == MagmaRowMajor ? nvecs : 1 );
+        magma_int_t rstart = ( x.major == MagmaRowMajor ? 1 : dofs );
+        magma_int_t rinc   = ( x.major == MagmaRowMajor ? nvecs : 1 );
+        CHECK( magma_zvinit( &r, Magma_CPU, A.num_rows, nvecs, c_zero, queue ));
+        r.major = x.major;
+
+        CHECK( magma_z_spmv( c_one, A, x, c_zero, r, queue ));        // r = A x
+        for( magma_int_t i=0; i < nvecs; i++) {
+            blasf77_zaxpy( &dofs, &c_neg_one, b.val + i*bstart, &binc,
+                           r.val + i*rstart, &rinc );                  // r = r - b
+            res[i] = magma_cblas_dznrm2( dofs, r.val + i*rstart, rinc ); // res = ||r||
+        }
+    } else if ( A.num_rows == b.num_rows ) {
         CHECK( magma_zvinit( &r, Magma_DEV, A.num_rows, b.num_cols, c_zero, queue ));
 
         CHECK( magma_z_spmv( c_one, A, x, c_zero, r, queue ));        // r = A x
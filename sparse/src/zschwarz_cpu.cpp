@@ -0,0 +1,671 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include "magmasparse_internal.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*
+    Host restricted additive Schwarz (RAS). The rows of A are split into
+    contiguous slices of equal size, as in magma_zmslice; subdomain d is
+    the slice d (its core rows) extended by precond->pattern layers of
+    neighbors in the graph of A. Each subdomain matrix, A restricted to the
+    rows and columns of the subdomain, is factored independently by one
+    thread.
+
+    The subdomains are stacked in an extended numbering: subdomain d has
+    the extended rows M.blockinfo[d], ..., M.blockinfo[d+1]-1, for the
+    M.numblocks subdomains, and M.blockinfo[ M.numblocks+1 + k ] is the row
+    of A of extended row k. Rows of a subdomain keep their order in A.
+    precond->M has the incomplete factors of all subdomains in this
+    numbering, as one block diagonal CSR matrix on the CPU: the strictly
+    lower part is L, with unit diagonal, and the rest is U.
+
+    The apply solves the subdomains concurrently in precond->work1, and
+    writes back only the core rows (the restricted combine), so each row
+    of x is written by exactly one subdomain, and the subdomain solves need
+    no synchronization.
+*/
+
+
+/******************************************************************************/
+// Frees A, also if it does not carry ownership, as the ParILUT helpers
+// do not set it.
+static void
+zschwarz_free( magma_z_matrix *A, magma_queue_t queue )
+{
+    A->ownership = MagmaTrue;
+    magma_zmfree( A, queue );
+}
+
+
+/******************************************************************************/
+// Sorts the columns of each row of the CSR matrix A, with their values.
+static magma_int_t
+zschwarz_sort_rows( magma_z_matrix *A, magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    for( magma_int_t i=0; i < A->num_rows; i++ ) {
+        if ( A->row[i+1] - A->row[i] > 1 ) {
+            CHECK( magma_zindexsortval( A->col, A->val, A->row[i], A->row[i+1]-1, queue ));
+        }
+    }
+cleanup:
+    return info;
+}
+
+
+/******************************************************************************/
+// Incomplete LU factorization without fill-in, in place, of the CSR matrix
+// A with sorted columns. pos is workspace of size 2*A->num_rows, with the
+// first A->num_rows entries -1 on entry; they are -1 again on exit.
+static magma_int_t
+zschwarz_ilu0( magma_z_matrix *A, magma_index_t *pos )
+{
+    magma_int_t info = 0;
+    magma_index_t *diag = pos + A->num_rows;
+
+    for( magma_int_t i=0; i < A->num_rows; i++ ) {
+        for( magma_index_t e=A->row[i]; e < A->row[i+1]; e++ ) {
+            pos[ A->col[e] ] = e;
+        }
+        diag[i] = -1;
+        for( magma_index_t e=A->row[i]; e < A->row[i+1]; e++ ) {
+            magma_index_t j = A->col[e];
+            if ( j >= i ) {
+                if ( j == i ) {
+                    diag[i] = e;
+                }
+                break;
+            }
+            // l_ij = a_ij / u_jj;  a_ik -= l_ij u_jk for k > j in the pattern
+            magmaDoubleComplex lij = A->val[e] / A->val[ diag[j] ];
+            A->val[e] = lij;
+            for( magma_index_t f=diag[j]+1; f < A->row[j+1]; f++ ) {
+                magma_index_t k = pos[ A->col[f] ];
+                if ( k >= 0 ) {
+                    A->val[k] -= lij * A->val[f];
+                }
+            }
+        }
+        for( magma_index_t e=A->row[i]; e < A->row[i+1]; e++ ) {
+            pos[ A->col[e] ] = -1;
+        }
+        if ( diag[i] < 0 || MAGMA_Z_ABS( A->val[ diag[i] ] ) == 0.0 ) {
+            info = MAGMA_ERR_BADPRECOND;
+            break;
+        }
+    }
+    return info;
+}
+
+
+/******************************************************************************/
+// Threshold ILU of the CSR matrix A with sorted columns, by the ParILUT
+// iteration in the sequence of magma_zparilut_cpu (sweeps steps, fill-in
+// ratio fill), run on the calling thread. As there, the initial guess is
+// L = tril(A) and U = triu(A). On exit, LU has the factors in CSR, with
+// the strictly lower part of L and the upper part of U.
+static magma_int_t
+zschwarz_parilut(
+    magma_z_matrix A,
+    magma_int_t sweeps,
+    double fill,
+    magma_z_matrix *LU,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix AT={Magma_CSR}, L={Magma_CSR}, U={Magma_CSR}, UT={Magma_CSR},
+        L0={Magma_CSR}, U0={Magma_CSR}, L_new={Magma_CSR}, U_new={Magma_CSR},
+        hL={Magma_CSR}, hU={Magma_CSR}, oneL={Magma_CSR}, oneU={Magma_CSR};
+    magma_int_t num_rmL, num_rmU, L0nnz, U0nnz, nnz;
+    double thrsL, thrsU;
+
+    CHECK( magma_zmatrix_tril( A, &L0, queue ));
+    CHECK( magma_zmatrix_triu( A, &U0, queue ));
+    // U is stored as U^T in CSR
+    CHECK( magma_zmatrix_tril( A, &L, queue ));
+    CHECK( magma_zmtranspose( A, &AT, queue ));
+    CHECK( magma_zmatrix_tril( AT, &U, queue ));
+    CHECK( magma_zmatrix_addrowindex( &L, queue ));
+    CHECK( magma_zmatrix_addrowindex( &U, queue ));
+    L0nnz = L.nnz;
+    U0nnz = U.nnz;
+    oneL.memory_location = Magma_CPU;
+    oneU.memory_location = Magma_CPU;
+
+    for( magma_int_t iters=0; iters < sweeps; iters++ ) {
+        // step 1: transpose U
+        zschwarz_free( &UT, queue );
+        CHECK( magma_zcsrcoo_transpose( U, &UT, queue ));
+
+        // step 2: find candidates
+        CHECK( magma_zparilut_candidates( L0, U0, L, UT, &hL, &hU, queue ));
+
+        // step 3: compute residuals
+        CHECK( magma_zparilut_residuals( A, L, U, &hL, queue ));
+        CHECK( magma_zparilut_residuals( A, L, U, &hU, queue ));
+        CHECK( magma_zmatrix_swap( &hL, &oneL, queue ));
+        zschwarz_free( &hL, queue );
+
+        // step 4: sort candidates, with their values, as magma_zmatrix_cup
+        // merges sorted rows
+        CHECK( zschwarz_sort_rows( &oneL, queue ));
+        CHECK( zschwarz_sort_rows( &hU, queue ));
+
+        // step 5: transpose candidates
+        CHECK( magma_zcsrcoo_transpose( hU, &oneU, queue ));
+        zschwarz_free( &hU, queue );
+
+        // step 6: add candidates
+        CHECK( magma_zmatrix_cup( L, oneL, &L_new, queue ));
+        CHECK( magma_zmatrix_cup( U, oneU, &U_new, queue ));
+        zschwarz_free( &oneL, queue );
+        zschwarz_free( &oneU, queue );
+
+        // step 7: sweep
+        CHECK( magma_zparilut_sweep_sync( &A, &L_new, &U_new, queue ));
+
+        // step 8: select threshold to remove elements, ignoring the diagonal
+        num_rmL = max( (magma_int_t) (L_new.nnz - L0nnz*(1 + (fill - 1.)*(iters+1)/sweeps)), 0 );
+        num_rmU = max( (magma_int_t) (U_new.nnz - U0nnz*(1 + (fill - 1.)*(iters+1)/sweeps)), 0 );
+        CHECK( magma_zparilut_preselect( 0, &L_new, &oneL, queue ));
+        CHECK( magma_zparilut_preselect( 0, &U_new, &oneU, queue ));
+        // a subdomain may have fewer off-diagonal entries than the
+        // fill-in would remove
+        num_rmL = min( num_rmL, oneL.nnz-1 );
+        num_rmU = min( num_rmU, oneU.nnz-1 );
+        thrsL = thrsU = 0.0;
+        if ( num_rmL > 0 ) {
+            CHECK( magma_zparilut_set_thrs_randomselect_approx( num_rmL, &oneL, 0, &thrsL, queue ));
+        }
+        if ( num_rmU > 0 ) {
+            CHECK( magma_zparilut_set_thrs_randomselect_approx( num_rmU, &oneU, 0, &thrsU, queue ));
+        }
+        zschwarz_free( &oneL, queue );
+        zschwarz_free( &oneU, queue );
+
+        // step 9: remove elements
+        CHECK( magma_zparilut_thrsrm( 1, &L_new, &thrsL, queue ));
+        CHECK( magma_zparilut_thrsrm( 1, &U_new, &thrsU, queue ));
+        CHECK( magma_zmatrix_swap( &L_new, &L, queue ));
+        CHECK( magma_zmatrix_swap( &U_new, &U, queue ));
+        zschwarz_free( &L_new, queue );
+        zschwarz_free( &U_new, queue );
+
+        // step 10: sweep
+        CHECK( magma_zparilut_sweep_sync( &A, &L, &U, queue ));
+    }
+
+    // merge L and U row by row
+    zschwarz_free( &UT, queue );
+    CHECK( magma_zcsrcoo_transpose( U, &UT, queue ));
+    zschwarz_free( LU, queue );
+    LU->storage_type = Magma_CSR;
+    LU->memory_location = Magma_CPU;
+    LU->ownership = MagmaTrue;
+    LU->num_rows = LU->num_cols = A.num_rows;
+    CHECK( magma_index_malloc_cpu( &LU->row, A.num_rows+1 ));
+    nnz = 0;
+    for( magma_int_t i=0; i < A.num_rows; i++ ) {
+        LU->row[i] = nnz;
+        for( magma_index_t e=L.row[i]; e < L.row[i+1]; e++ ) {
+            nnz += ( L.col[e] < i );
+        }
+        for( magma_index_t e=UT.row[i]; e < UT.row[i+1]; e++ ) {
+            nnz += ( UT.col[e] >= i );
+        }
+    }
+    LU->row[ A.num_rows ] = nnz;
+    LU->nnz = nnz;
+    CHECK( magma_zmalloc_cpu( &LU->val, max( nnz, 1 )));
+    CHECK( magma_index_malloc_cpu( &LU->col, max( nnz, 1 )));
+    for( magma_int_t i=0; i < A.num_rows; i++ ) {
+        magma_index_t k = LU->row[i];
+        for( magma_index_t e=L.row[i]; e < L.row[i+1]; e++ ) {
+            if ( L.col[e] < i ) {
+                LU->col[k] = L.col[e];
+                LU->val[k] = L.val[e];
+                k++;
+            }
+        }
+        for( magma_index_t e=UT.row[i]; e < UT.row[i+1]; e++ ) {
+            if ( UT.col[e] >= i ) {
+                LU->col[k] = UT.col[e];
+                LU->val[k] = UT.val[e];
+                k++;
+            }
+        }
+    }
+
+cleanup:
+    zschwarz_free( &AT, queue );
+    zschwarz_free( &L, queue );
+    zschwarz_free( &U, queue );
+    zschwarz_free( &UT, queue );
+    zschwarz_free( &L0, queue );
+    zschwarz_free( &U0, queue );
+    zschwarz_free( &L_new, queue );
+    zschwarz_free( &U_new, queue );
+    zschwarz_free( &hL, queue );
+    zschwarz_free( &hU, queue );
+    zschwarz_free( &oneL, queue );
+    zschwarz_free( &oneU, queue );
+    return info;
+}
+
+
+/******************************************************************************/
+// Checks that every row of the LU factors in CSR has a finite, nonzero
+// diagonal entry, the pivots of the triangular solve with U.
+static magma_int_t
+zschwarz_check_pivots( magma_z_matrix LU )
+{
+    for( magma_int_t i=0; i < LU.num_rows; i++ ) {
+        magmaDoubleComplex diag = MAGMA_Z_ZERO;
+        for( magma_index_t e=LU.row[i]; e < LU.row[i+1]; e++ ) {
+            if ( LU.col[e] == i ) {
+                diag = LU.val[e];
+            }
+        }
+        if ( MAGMA_Z_ABS( diag ) == 0.0 || magma_z_isnan_inf( diag ) ) {
+            return MAGMA_ERR_BADPRECOND;
+        }
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/******************************************************************************/
+// Builds the subdomain of the core rows [ cstart, cend ) of A plus overlap
+// layers of neighbors, and factors it into LU, in CSR in the local
+// numbering. The rows of A in the subdomain, sorted, are returned in
+// rows, of size LU->num_rows. The workspace is sized by the subdomain.
+static magma_int_t
+zschwarz_subdomain(
+    magma_z_matrix A,
+    magma_int_t cstart,
+    magma_int_t cend,
+    magma_int_t overlap,
+    magma_z_preconditioner *precond,
+    magma_index_t **rows,
+    magma_z_matrix *LU,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix Aloc={Magma_CSR};
+    magma_index_t *pos = NULL;
+    magma_int_t nloc, nnz = 0;
+    std::vector<magma_index_t> set, front, cand, added;
+
+    // core rows, then breadth-first layers of neighbors; set stays sorted
+    for( magma_int_t i=cstart; i < cend; i++ ) {
+        set.push_back( i );
+    }
+    front = set;
+    for( magma_int_t layer=0; layer < overlap && ! front.empty(); layer++ ) {
+        cand.clear();
+        for( size_t k=0; k < front.size(); k++ ) {
+            magma_index_t i = front[k];
+            cand.insert( cand.end(), A.col + A.row[i], A.col + A.row[i+1] );
+        }
+        std::sort( cand.begin(), cand.end() );
+        cand.erase( std::unique( cand.begin(), cand.end() ), cand.end() );
+        added.clear();
+        std::set_difference( cand.begin(), cand.end(), set.begin(), set.end(),
+                             std::back_inserter( added ));
+        size_t old = set.size();
+        set.insert( set.end(), added.begin(), added.end() );
+        std::inplace_merge( set.begin(), set.begin() + old, set.end() );
+        front.swap( added );
+    }
+    nloc = set.size();
+    CHECK( magma_index_malloc_cpu( rows, max( nloc, 1 )));
+    std::copy( set.begin(), set.end(), *rows );
+
+    // A restricted to the subdomain; the local numbering is increasing in
+    // the rows of A, so local rows keep the column order of A
+    Aloc.memory_location = Magma_CPU;
+    Aloc.ownership = MagmaTrue;
+    Aloc.num_rows = Aloc.num_cols = nloc;
+    CHECK( magma_index_malloc_cpu( &Aloc.row, nloc+1 ));
+    for( magma_int_t k=0; k < nloc; k++ ) {
+        magma_index_t i = set[k];
+        Aloc.row[k] = nnz;
+        for( magma_index_t e=A.row[i]; e < A.row[i+1]; e++ ) {
+            nnz += std::binary_search( set.begin(), set.end(), A.col[e] );
+        }
+    }
+    Aloc.row[ nloc ] = nnz;
+    Aloc.nnz = nnz;
+    CHECK( magma_zmalloc_cpu( &Aloc.val, max( nnz, 1 )));
+    CHECK( magma_index_malloc_cpu( &Aloc.col, max( nnz, 1 )));
+    for( magma_int_t k=0; k < nloc; k++ ) {
+        magma_index_t i = set[k], f = Aloc.row[k];
+        for( magma_index_t e=A.row[i]; e < A.row[i+1]; e++ ) {
+            std::vector<magma_index_t>::iterator it =
+                std::lower_bound( set.begin(), set.end(), A.col[e] );
+            if ( it != set.end() && *it == A.col[e] ) {
+                Aloc.col[f] = it - set.begin();
+                Aloc.val[f] = A.val[e];
+                f++;
+            }
+        }
+    }
+
+    if ( precond->subsolver == Magma_PARILUT && nloc > 0 ) {
+        CHECK( zschwarz_parilut( Aloc, precond->sweeps, precond->atol, LU, queue ));
+    }
+    else {
+        LU->memory_location = Magma_CPU;
+        LU->ownership = MagmaTrue;
+        LU->num_rows = LU->num_cols = nloc;
+        LU->nnz = nnz;
+        CHECK( magma_index_malloc_cpu( &LU->row, nloc+1 ));
+        CHECK( magma_zmalloc_cpu( &LU->val, max( nnz, 1 )));
+        CHECK( magma_index_malloc_cpu( &LU->col, max( nnz, 1 )));
+        memcpy( LU->row, Aloc.row, (nloc+1)*sizeof(magma_index_t) );
+        memcpy( LU->val, Aloc.val, nnz*sizeof(magmaDoubleComplex) );
+        memcpy( LU->col, Aloc.col, nnz*sizeof(magma_index_t) );
+        CHECK( magma_index_malloc_cpu( &pos, 2*max( nloc, 1 )));
+        for( magma_int_t k=0; k < nloc; k++ ) {
+            pos[k] = -1;
+        }
+        CHECK( zschwarz_ilu0( LU, pos ));
+    }
+    CHECK( zschwarz_check_pivots( *LU ));
+
+cleanup:
+    magma_zmfree( &Aloc, queue );
+    magma_free_cpu( pos );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Prepares the restricted additive Schwarz preconditioner on the CPU.
+    The rows of A are split into contiguous slices, as in magma_zmslice,
+    and each slice is extended by layers of neighbors in the graph of A
+    to an overlapping subdomain. The subdomain matrices are factored
+    independently, one subdomain per thread, by ILU(0) or, for
+    precond->subsolver = Magma_PARILUT, by ParILUT with precond->sweeps
+    steps and the fill-in ratio precond->atol.
+
+    The number of subdomains is precond->levels, as for the overlapping
+    block-asynchronous iteration (Magma_BAITERO); if it is 0, the number
+    of OpenMP threads. The overlap is precond->pattern layers.
+
+    The factors of all subdomains are stored in precond->M, in CSR on the
+    CPU, with the subdomain rows in precond->M.blockinfo. If a factor has
+    a zero or non-finite pivot, MAGMA_ERR_BADPRECOND is returned.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A on the CPU; the columns of each row must be
+                sorted.
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zschwarz_setup_cpu(
+    magma_z_matrix A,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix Acsr={Magma_CSR}, empty={Magma_CSR};
+    magma_z_matrix *LU = NULL;
+    magma_index_t **rows = NULL, *ptr, *map;
+    magma_int_t n = A.num_rows, num_threads = 1, ndom = 0, slice, next, nnz;
+    magma_int_t overlap = max( precond->pattern, 0 );
+
+    if ( A.memory_location != Magma_CPU ) {
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+    if ( A.storage_type == Magma_CSR ) {
+        Acsr = A;
+    }
+    else {
+        CHECK( magma_zmconvert( A, &Acsr, A.storage_type, Magma_CSR, queue ));
+    }
+
+    #ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    #endif
+    ndom = min( ( precond->levels > 0 ? precond->levels : num_threads ), n );
+    slice = magma_ceildiv( n, max( ndom, 1 ));
+
+    // factor the subdomains, each in its local numbering
+    CHECK( magma_malloc_cpu( (void**) &LU, max( ndom, 1 )*sizeof(magma_z_matrix) ));
+    CHECK( magma_malloc_cpu( (void**) &rows, max( ndom, 1 )*sizeof(magma_index_t*) ));
+    for( magma_int_t d=0; d < ndom; d++ ) {
+        LU[d] = empty;
+        rows[d] = NULL;
+    }
+    #pragma omp parallel
+    {
+        #ifdef _OPENMP
+        // the ParILUT helpers size their work by omp_get_max_threads;
+        // they run on this thread only
+        omp_set_num_threads( 1 );
+        #endif
+
+        #pragma omp for schedule(dynamic,1)
+        for( magma_int_t d=0; d < ndom; d++ ) {
+            magma_int_t dinfo = zschwarz_subdomain(
+                Acsr, min( d*slice, n ), min( (d+1)*slice, n ), overlap, precond,
+                &rows[d], &LU[d], queue );
+            if ( dinfo != 0 ) {
+                #pragma omp atomic write
+                info = dinfo;
+            }
+        }
+    }
+    if ( info != 0 ) {
+        goto cleanup;
+    }
+
+    // magma_zmfree clears blockinfo of a CSR matrix without freeing it
+    magma_free_cpu( precond->M.blockinfo );
+    precond->M.blockinfo = NULL;
+    magma_zmfree( &precond->M, queue );
+
+    // stack the subdomains in the extended numbering
+    precond->M = empty;
+    next = nnz = 0;
+    for( magma_int_t d=0; d < ndom; d++ ) {
+        next += LU[d].num_rows;
+        nnz += LU[d].nnz;
+    }
+    precond->M.memory_location = Magma_CPU;
+    precond->M.ownership = MagmaTrue;
+    precond->M.num_rows = next;
+    precond->M.num_cols = next;
+    precond->M.nnz = nnz;
+    precond->M.numblocks = ndom;
+    CHECK( magma_zmalloc_cpu( &precond->M.val, max( nnz, 1 )));
+    CHECK( magma_index_malloc_cpu( &precond->M.row, next+1 ));
+    CHECK( magma_index_malloc_cpu( &precond->M.col, max( nnz, 1 )));
+    CHECK( magma_index_malloc_cpu( &precond->M.blockinfo, ndom+1 + next ));
+    ptr = precond->M.blockinfo;
+    map = ptr + ndom+1;
+    ptr[0] = 0;
+    for( magma_int_t d=0; d < ndom; d++ ) {
+        ptr[d+1] = ptr[d] + LU[d].num_rows;
+    }
+    precond->M.row[ next ] = nnz;
+    #pragma omp parallel for schedule(dynamic,1)
+    for( magma_int_t d=0; d < ndom; d++ ) {
+        magma_index_t lo = ptr[d];
+        magma_index_t offset = 0;
+        for( magma_int_t e=0; e < d; e++ ) {
+            offset += LU[e].nnz;
+        }
+        for( magma_int_t k=0; k < LU[d].num_rows; k++ ) {
+            precond->M.row[ lo+k ] = offset + LU[d].row[k];
+            map[ lo+k ] = rows[d][k];
+        }
+        for( magma_int_t e=0; e < LU[d].nnz; e++ ) {
+            precond->M.col[ offset+e ] = lo + LU[d].col[e];
+            precond->M.val[ offset+e ] = LU[d].val[e];
+        }
+    }
+
+    // subdomain solutions
+    magma_zmfree( &precond->work1, queue );
+    CHECK( magma_zvinit( &precond->work1, Magma_CPU, max( next, 1 ), 1, MAGMA_Z_ZERO, queue ));
+
+cleanup:
+    if ( Acsr.val != A.val ) {
+        magma_zmfree( &Acsr, queue );
+    }
+    if ( info != 0 ) {
+        magma_free_cpu( precond->M.blockinfo );
+        precond->M.blockinfo = NULL;
+        magma_zmfree( &precond->M, queue );
+    }
+    if ( LU != NULL && rows != NULL ) {
+        for( magma_int_t d=0; d < ndom; d++ ) {
+            zschwarz_free( &LU[d], queue );
+            magma_free_cpu( rows[d] );
+        }
+    }
+    magma_free_cpu( LU );
+    magma_free_cpu( rows );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Applies the restricted additive Schwarz preconditioner on the CPU,
+    x = sum_d R0_d^T (L_d U_d)^{-1} R_d b, where R_d restricts to the rows
+    of subdomain d and R0_d to its core rows. The subdomains are solved
+    concurrently, each by one thread, and each row of x is written by the
+    subdomain that owns it.
+
+    Requires magma_zschwarz_setup_cpu.
+
+    Arguments
+    ---------
+
+    @param[in]
+    b           magma_z_matrix
+                RHS b on the CPU
+
+    @param[in,out]
+    x           magma_z_matrix*
+                vector x = M^{-1} b on the CPU
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters; precond->work1 is workspace
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zschwarz_apply_cpu(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix M = precond->M;
+    magma_int_t ndom = M.numblocks, n = b.num_rows;
+    magma_int_t slice = magma_ceildiv( n, max( ndom, 1 ));
+    const magma_index_t *ptr = M.blockinfo, *map = M.blockinfo + ndom+1;
+    magmaDoubleComplex *w = precond->work1.val;
+
+    if ( b.memory_location != Magma_CPU || x->memory_location != Magma_CPU ||
+         M.memory_location != Magma_CPU ) {
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    #pragma omp parallel for schedule(dynamic,1)
+    for( magma_int_t d=0; d < ndom; d++ ) {
+        magma_index_t lo = ptr[d], hi = ptr[d+1];
+        magma_index_t cstart = d*slice, cend = min( (d+1)*slice, n );
+        for( magma_index_t k=lo; k < hi; k++ ) {
+            w[k] = b.val[ map[k] ];
+        }
+        // L y = R_d b
+        for( magma_index_t k=lo; k < hi; k++ ) {
+            magmaDoubleComplex s = w[k];
+            for( magma_index_t e=M.row[k]; e < M.row[k+1]; e++ ) {
+                if ( M.col[e] < k ) {
+                    s -= M.val[e] * w[ M.col[e] ];
+                }
+            }
+            w[k] = s;
+        }
+        // U z = y
+        for( magma_index_t k=hi-1; k >= lo; k-- ) {
+            magmaDoubleComplex s = w[k], diag = MAGMA_Z_ZERO;
+            for( magma_index_t e=M.row[k]; e < M.row[k+1]; e++ ) {
+                if ( M.col[e] > k ) {
+                    s -= M.val[e] * w[ M.col[e] ];
+                }
+                else if ( M.col[e] == k ) {
+                    diag = M.val[e];
+                }
+            }
+            if ( MAGMA_Z_ABS( diag ) == 0.0 ) {
+                // not from magma_zschwarz_setup_cpu, which rejects zero pivots
+                #pragma omp atomic write
+                info = MAGMA_ERR_BADPRECOND;
+                break;
+            }
+            w[k] = s / diag;
+        }
+        // restricted combine: core rows only
+        for( magma_index_t k=lo; k < hi; k++ ) {
+            if ( map[k] >= cstart && map[k] < cend ) {
+                x->val[ map[k] ] = w[k];
+            }
+        }
+    }
+
+cleanup:
+    return info;
+}
@@ -0,0 +1,443 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*
+    Host variable-block Jacobi. The inverse of the block diagonal of A is
+    stored in precond->M as a CSR matrix on the CPU. As each row of a dense
+    diagonal block has all columns of the block, the rows of a block are
+    consecutive in M.val, and the block is stored there row-major.
+
+    The blocks are grouped by size: M.blockinfo[ k ], k < M.numblocks, is
+    the first row of the k-th block in order of increasing size, and
+    M.blockinfo[ M.numblocks + s ] is the position of the first block of
+    size s in this order, for s = 0, ..., M.blocksize+1. Each size class is
+    inverted and applied by a kernel for that size, so the loops over a
+    block are unrolled for the small sizes that dominate in practice.
+*/
+
+// default largest block size, if precond->pattern does not give one
+const magma_int_t vbjacobi_default_bs = 8;
+
+
+/******************************************************************************/
+// Inverts the row-major n x n block a in place by Gauss-Jordan elimination
+// with partial pivoting. N > 0 fixes the size at compile time.
+// Returns false if the block is singular.
+template< magma_int_t N >
+static inline bool
+zvbjacobi_invert( magma_int_t n, magmaDoubleComplex *a, magma_int_t *piv )
+{
+    const magma_int_t m = ( N > 0 ? N : n );
+
+    for( magma_int_t k=0; k < m; k++ ) {
+        // pivot
+        magma_int_t p = k;
+        double amax = MAGMA_Z_ABS1( a[ k*m + k ] );
+        for( magma_int_t i=k+1; i < m; i++ ) {
+            double ai = MAGMA_Z_ABS1( a[ i*m + k ] );
+            if ( ai > amax ) {
+                amax = ai;
+                p = i;
+            }
+        }
+        if ( amax == 0.0 ) {
+            return false;
+        }
+        piv[k] = p;
+        if ( p != k ) {
+            for( magma_int_t j=0; j < m; j++ ) {
+                magmaDoubleComplex t = a[ k*m + j ];
+                a[ k*m + j ] = a[ p*m + j ];
+                a[ p*m + j ] = t;
+            }
+        }
+        // scale row k
+        magmaDoubleComplex pinv = MAGMA_Z_ONE / a[ k*m + k ];
+        a[ k*m + k ] = MAGMA_Z_ONE;
+        for( magma_int_t j=0; j < m; j++ ) {
+            a[ k*m + j ] *= pinv;
+        }
+        // eliminate column k in the other rows
+        for( magma_int_t i=0; i < m; i++ ) {
+            if ( i != k ) {
+                magmaDoubleComplex f = a[ i*m + k ];
+                a[ i*m + k ] = MAGMA_Z_ZERO;
+                for( magma_int_t j=0; j < m; j++ ) {
+                    a[ i*m + j ] -= f * a[ k*m + j ];
+                }
+            }
+        }
+    }
+    // undo the row interchanges on the columns of the inverse
+    for( magma_int_t k=m-1; k >= 0; k-- ) {
+        magma_int_t p = piv[k];
+        if ( p != k ) {
+            for( magma_int_t i=0; i < m; i++ ) {
+                magmaDoubleComplex t = a[ i*m + k ];
+                a[ i*m + k ] = a[ i*m + p ];
+                a[ i*m + p ] = t;
+            }
+        }
+    }
+    return true;
+}
+
+
+/******************************************************************************/
+// Computes y = a * x for the row-major n x n block a.
+// N > 0 fixes the size at compile time.
+template< magma_int_t N >
+static inline void
+zvbjacobi_gemv(
+    magma_int_t n, const magmaDoubleComplex *a,
+    const magmaDoubleComplex *x, magmaDoubleComplex *y )
+{
+    const magma_int_t m = ( N > 0 ? N : n );
+
+    for( magma_int_t i=0; i < m; i++ ) {
+        magmaDoubleComplex s = MAGMA_Z_ZERO;
+        for( magma_int_t j=0; j < m; j++ ) {
+            s += a[ i*m + j ] * x[j];
+        }
+        y[i] = s;
+    }
+}
+
+
+/******************************************************************************/
+// Inverts the diagonal blocks of size n, M.blockinfo[ kbegin:kend ], in M.
+// A block that is singular is replaced by the inverse of its diagonal,
+// with ones for zero diagonal entries, as in scalar Jacobi.
+template< magma_int_t N >
+static void
+zvbjacobi_invert_batched(
+    magma_int_t n, magma_int_t kbegin, magma_int_t kend,
+    magma_z_matrix A, magma_z_matrix M )
+{
+    #pragma omp parallel
+    {
+        magma_int_t piv[ N > 0 ? N : 1 ], *ipiv = piv;
+        if ( N == 0 ) {
+            magma_imalloc_cpu( &ipiv, n );
+        }
+
+        #pragma omp for schedule(static)
+        for( magma_int_t k=kbegin; k < kend; k++ ) {
+            magma_index_t start = M.blockinfo[k];
+            magmaDoubleComplex *a = &M.val[ M.row[ start ] ];
+
+            // gather the block
+            for( magma_int_t i=0; i < n*n; i++ ) {
+                a[i] = MAGMA_Z_ZERO;
+            }
+            for( magma_int_t i=0; i < n; i++ ) {
+                for( magma_index_t j=A.row[ start+i ]; j < A.row[ start+i+1 ]; j++ ) {
+                    magma_index_t c = A.col[j] - start;
+                    if ( c >= 0 && c < n ) {
+                        a[ i*n + c ] = A.val[j];
+                    }
+                }
+            }
+
+            if ( ipiv == NULL || ! zvbjacobi_invert<N>( n, a, ipiv )) {
+                // singular block (or no workspace): scalar Jacobi
+                for( magma_int_t i=0; i < n; i++ ) {
+                    magmaDoubleComplex aii = MAGMA_Z_ZERO;
+                    for( magma_index_t j=A.row[ start+i ]; j < A.row[ start+i+1 ]; j++ ) {
+                        if ( A.col[j] == start+i ) {
+                            aii = A.val[j];
+                        }
+                    }
+                    for( magma_int_t j=0; j < n; j++ ) {
+                        a[ i*n + j ] = MAGMA_Z_ZERO;
+                    }
+                    a[ i*n + i ] = ( MAGMA_Z_ABS( aii ) != 0.0 ? MAGMA_Z_ONE / aii
+                                                               : MAGMA_Z_ONE );
+                }
+            }
+        }
+
+        if ( N == 0 ) {
+            magma_free_cpu( ipiv );
+        }
+    }
+}
+
+
+/******************************************************************************/
+// Applies the inverse diagonal blocks of size n, M.blockinfo[ kbegin:kend ],
+// to b, giving x.
+template< magma_int_t N >
+static void
+zvbjacobi_apply_batched(
+    magma_int_t n, magma_int_t kbegin, magma_int_t kend,
+    magma_z_matrix M, const magmaDoubleComplex *b, magmaDoubleComplex *x )
+{
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t k=kbegin; k < kend; k++ ) {
+        magma_index_t start = M.blockinfo[k];
+        zvbjacobi_gemv<N>( n, &M.val[ M.row[ start ] ], &b[ start ], &x[ start ] );
+    }
+}
+
+
+/**
+    Purpose
+    -------
+
+    Prepares the variable-block Jacobi preconditioner on the CPU: detects
+    diagonal blocks of rows with the same sparsity pattern (supernodes,
+    e.g., the unknowns of one mesh node in a multiphysics problem) using
+    magma_zmsupernodal, and inverts them, grouped by size, with batched
+    kernels specialized for each small block size.
+
+    The largest block size is precond->pattern, as for the block-Jacobi
+    trisolver (Magma_VBJACOBI); if it is below 2, 8 is used, the largest
+    size with a specialized kernel.
+    A singular diagonal block is replaced by the inverse of its diagonal.
+
+    The inverse of the block diagonal is stored in precond->M, in CSR on
+    the CPU, with the blocks grouped by size in precond->M.blockinfo.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A on the CPU
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zvbjacobisetup_cpu(
+    magma_z_matrix A,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix Acsr={Magma_CSR}, S={Magma_CSR}, empty={Magma_CSR};
+    magma_int_t max_bs = ( precond->pattern > 1 ? precond->pattern : vbjacobi_default_bs );
+    magma_int_t nblocks = 0, bsmax = 0, nnz = 0;
+    magma_index_t *bstart = NULL, *class_ptr = NULL;
+
+    if ( A.memory_location != Magma_CPU ) {
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+    if ( A.storage_type == Magma_CSR ) {
+        Acsr = A;
+    }
+    else {
+        CHECK( magma_zmconvert( A, &Acsr, A.storage_type, Magma_CSR, queue ));
+    }
+
+    // block structure; empty blocks are skipped
+    CHECK( magma_zmsupernodal( &max_bs, Acsr, &S, queue ));
+    CHECK( magma_index_malloc_cpu( &bstart, S.numblocks+1 ));
+    for( magma_int_t k=0; k < S.numblocks; k++ ) {
+        magma_index_t bs = S.tile_desc_offset_ptr[k+1] - S.tile_desc_offset_ptr[k];
+        if ( bs > 0 ) {
+            bstart[ nblocks ] = S.tile_desc_offset_ptr[k];
+            nblocks++;
+            bsmax = max( bsmax, bs );
+            nnz += bs*bs;
+        }
+    }
+    bstart[ nblocks ] = Acsr.num_rows;
+
+    // magma_zmfree clears blockinfo of a CSR matrix without freeing it
+    magma_free_cpu( precond->M.blockinfo );
+    precond->M.blockinfo = NULL;
+    magma_zmfree( &precond->M, queue );
+
+    // the inverse has the pattern of the block diagonal
+    precond->M = empty;
+    precond->M.memory_location = Magma_CPU;
+    precond->M.ownership = MagmaTrue;
+    precond->M.num_rows = Acsr.num_rows;
+    precond->M.num_cols = Acsr.num_rows;
+    precond->M.nnz = nnz;
+    precond->M.numblocks = nblocks;
+    precond->M.blocksize = bsmax;
+    CHECK( magma_zmalloc_cpu( &precond->M.val, nnz ));
+    CHECK( magma_index_malloc_cpu( &precond->M.row, Acsr.num_rows+1 ));
+    CHECK( magma_index_malloc_cpu( &precond->M.col, nnz ));
+    CHECK( magma_index_malloc_cpu( &precond->M.blockinfo, nblocks + bsmax + 2 ));
+
+    // row lengths are the block sizes
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t k=0; k < nblocks; k++ ) {
+        magma_index_t start = bstart[k], bs = bstart[k+1] - bstart[k];
+        for( magma_int_t i=0; i < bs; i++ ) {
+            precond->M.row[ start+i ] = bs;
+        }
+    }
+    // row pointer: exclusive scan of the row lengths
+    nnz = 0;
+    for( magma_int_t i=0; i < Acsr.num_rows; i++ ) {
+        magma_index_t len = precond->M.row[i];
+        precond->M.row[i] = nnz;
+        nnz += len;
+    }
+    precond->M.row[ Acsr.num_rows ] = nnz;
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t k=0; k < nblocks; k++ ) {
+        magma_index_t start = bstart[k], bs = bstart[k+1] - bstart[k];
+        for( magma_int_t i=0; i < bs; i++ ) {
+            for( magma_int_t j=0; j < bs; j++ ) {
+                precond->M.col[ precond->M.row[ start+i ] + j ] = start + j;
+            }
+        }
+    }
+
+    // group the blocks by size (counting sort)
+    class_ptr = precond->M.blockinfo + nblocks;
+    for( magma_int_t s=0; s < bsmax+2; s++ ) {
+        class_ptr[s] = 0;
+    }
+    for( magma_int_t k=0; k < nblocks; k++ ) {
+        class_ptr[ bstart[k+1] - bstart[k] + 1 ]++;
+    }
+    for( magma_int_t s=0; s < bsmax+1; s++ ) {
+        class_ptr[s+1] += class_ptr[s];
+    }
+    for( magma_int_t k=0; k < nblocks; k++ ) {
+        magma_index_t bs = bstart[k+1] - bstart[k];
+        precond->M.blockinfo[ class_ptr[bs]++ ] = bstart[k];
+    }
+    for( magma_int_t s=bsmax; s > 0; s-- ) {
+        class_ptr[s] = class_ptr[s-1];
+    }
+    class_ptr[0] = 0;
+
+    // invert each size class
+    for( magma_int_t s=1; s <= bsmax; s++ ) {
+        magma_int_t kbegin = class_ptr[s], kend = class_ptr[s+1];
+        if ( kbegin == kend ) {
+            continue;
+        }
+        switch( s ) {
+            case 1: zvbjacobi_invert_batched<1>( s, kbegin, kend, Acsr, precond->M ); break;
+            case 2: zvbjacobi_invert_batched<2>( s, kbegin, kend, Acsr, precond->M ); break;
+            case 3: zvbjacobi_invert_batched<3>( s, kbegin, kend, Acsr, precond->M ); break;
+            case 4: zvbjacobi_invert_batched<4>( s, kbegin, kend, Acsr, precond->M ); break;
+            case 5: zvbjacobi_invert_batched<5>( s, kbegin, kend, Acsr, precond->M ); break;
+            case 6: zvbjacobi_invert_batched<6>( s, kbegin, kend, Acsr, precond->M ); break;
+            case 7: zvbjacobi_invert_batched<7>( s, kbegin, kend, Acsr, precond->M ); break;
+            case 8: zvbjacobi_invert_batched<8>( s, kbegin, kend, Acsr, precond->M ); break;
+            default: zvbjacobi_invert_batched<0>( s, kbegin, kend, Acsr, precond->M ); break;
+        }
+    }
+
+cleanup:
+    if ( Acsr.val != A.val ) {
+        magma_zmfree( &Acsr, queue );
+    }
+    if ( info != 0 ) {
+        magma_free_cpu( precond->M.blockinfo );
+        precond->M.blockinfo = NULL;
+        magma_zmfree( &precond->M, queue );
+    }
+    magma_free_cpu( S.val );
+    magma_free_cpu( S.row );
+    magma_free_cpu( S.col );
+    magma_free_cpu( S.tile_desc_offset_ptr );
+    magma_free_cpu( bstart );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Applies the variable-block Jacobi preconditioner prepared by
+    magma_zvbjacobisetup_cpu on the CPU: x = M * b, with M the inverse of
+    the block diagonal of A. Each size class of blocks is applied by a
+    kernel for that size.
+
+    Arguments
+    ---------
+
+    @param[in]
+    b           magma_z_matrix
+                input vector b on the CPU
+
+    @param[out]
+    x           magma_z_matrix*
+                output vector x on the CPU
+
+    @param[in]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zvbjacobiapply_cpu(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix M = precond->M;
+    magma_index_t *class_ptr = M.blockinfo + M.numblocks;
+
+    if ( b.memory_location != Magma_CPU || x->memory_location != Magma_CPU ||
+         M.memory_location != Magma_CPU || M.blockinfo == NULL ) {
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    for( magma_int_t s=1; s <= M.blocksize; s++ ) {
+        magma_int_t kbegin = class_ptr[s], kend = class_ptr[s+1];
+        if ( kbegin == kend ) {
+            continue;
+        }
+        switch( s ) {
+            case 1: zvbjacobi_apply_batched<1>( s, kbegin, kend, M, b.val, x->val ); break;
+            case 2: zvbjacobi_apply_batched<2>( s, kbegin, kend, M, b.val, x->val ); break;
+            case 3: zvbjacobi_apply_batched<3>( s, kbegin, kend, M, b.val, x->val ); break;
+            case 4: zvbjacobi_apply_batched<4>( s, kbegin, kend, M, b.val, x->val ); break;
+            case 5: zvbjacobi_apply_batched<5>( s, kbegin, kend, M, b.val, x->val ); break;
+            case 6: zvbjacobi_apply_batched<6>( s, kbegin, kend, M, b.val, x->val ); break;
+            case 7: zvbjacobi_apply_batched<7>( s, kbegin, kend, M, b.val, x->val ); break;
+            case 8: zvbjacobi_apply_batched<8>( s, kbegin, kend, M, b.val, x->val ); break;
+            default: zvbjacobi_apply_batched<0>( s, kbegin, kend, M, b.val, x->val ); break;
+        }
+    }
+
+cleanup:
+    MAGMA_UNUSED( queue );
+    return info;
+}
@@ -14,6 +14,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <algorithm>
+#include <vector>
 
 // includes, project
 #include "magma_v2.h"
@@ -21,6 +23,64 @@
 #include "testings.h"
 
 
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Generates the symmetric pattern of an R-MAT graph with 2^scale
+      vertices and about 16 * 2^scale undirected edges, without self loops,
+      as a CSR matrix with unit values. R-MAT graphs have power-law degrees.
+*/
+static void
+rmat_graph( magma_int_t scale, magma_z_matrix *A )
+{
+    magma_int_t n = magma_int_t(1) << scale;
+    int64_t num_edges = int64_t( 16 ) * n;
+    std::vector< std::pair< magma_index_t, magma_index_t > > edges;
+    uint64_t state = 88172645463325252ull;
+
+    edges.reserve( 2*num_edges );
+    for (int64_t e = 0; e < num_edges; ++e) {
+        magma_index_t u = 0, v = 0;
+        for (magma_int_t bit = 0; bit < scale; ++bit) {
+            // xorshift64; quadrant probabilities 0.57, 0.19, 0.19, 0.05
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            double r = (state >> 11) * (1.0 / 9007199254740992.0);
+            magma_index_t ubit = (r >= 0.76);
+            magma_index_t vbit = (r >= 0.57 && r < 0.76) || r >= 0.95;
+            u = 2*u + ubit;
+            v = 2*v + vbit;
+        }
+        if (u != v) {
+            edges.push_back( std::make_pair( u, v ));
+            edges.push_back( std::make_pair( v, u ));
+        }
+    }
+    std::sort( edges.begin(), edges.end() );
+    edges.erase( std::unique( edges.begin(), edges.end() ), edges.end() );
+
+    A->storage_type = Magma_CSR;
+    A->memory_location = Magma_CPU;
+    A->num_rows = n;
+    A->num_cols = n;
+    A->nnz = edges.size();
+    A->true_nnz = A->nnz;
+    TESTING_CHECK( magma_index_malloc_cpu( &A->row, n+1 ));
+    TESTING_CHECK( magma_index_malloc_cpu( &A->col, A->nnz ));
+    TESTING_CHECK( magma_zmalloc_cpu( &A->val, A->nnz ));
+    for (magma_int_t i = 0; i <= n; ++i) {
+        A->row[i] = 0;
+    }
+    for (magma_int_t k = 0; k < A->nnz; ++k) {
+        A->row[ edges[k].first + 1 ]++;
+        A->col[k] = edges[k].second;
+        A->val[k] = MAGMA_Z_ONE;
+    }
+    for (magma_int_t i = 0; i < n; ++i) {
+        A->row[i+1] += A->row[i];
+    }
+}
+
+
 /* ////////////////////////////////////////////////////////////////////////////
    -- testing Jaccard weights
 */
@@ -37,7 +97,7 @@ int main(  int argc, char** argv )
     real_Double_t res;
     double resd;
     magma_z_matrix Z={Magma_CSR}, dZ={Magma_CSR}, 
-    A={Magma_CSR}, A2={Magma_CSR}, dA={Magma_CSR};
+    A={Magma_CSR}, A2={Magma_CSR}, dA={Magma_CSR}, hA={Magma_CSR};
     
     magma_index_t *comm_i=NULL;
     magmaDoubleComplex *comm_v=NULL;
@@ -51,6 +111,10 @@ int main(  int argc, char** argv )
             i++;
             magma_int_t laplace_size = atoi( argv[i] );
             TESTING_CHECK( magma_zm_5stencil(  laplace_size, &Z, queue ));
+        } else if ( strcmp("RMAT", argv[i]) == 0 && i+1 < argc ) {   // R-MAT graph
+            i++;
+            magma_int_t scale = atoi( argv[i] );
+            rmat_graph( scale, &Z );
         } else {                        // file-matrix test
             TESTING_CHECK( magma_z_csr_mtx( &Z,  argv[i], queue ));
         }
@@ -60,6 +124,14 @@ int main(  int argc, char** argv )
         
         // convert to COO
         TESTING_CHECK( magma_zmconvert( Z, &A, Magma_CSR, Magma_CSRCOO, queue ) );
+        // on the CPU
+        TESTING_CHECK( magma_zmtransfer( A, &hA, Magma_CPU, Magma_CPU, queue ));
+        start = magma_wtime();
+        for(int i=0; i<10; i++)
+            TESTING_CHECK( magma_zjaccard_weights( Z, &hA, queue ));
+        end = magma_wtime();
+        printf( " > CPU %.2e seconds.\n", (end-start)/10 );
+
         // transfer to GPU
         TESTING_CHECK( magma_zmtransfer( Z, &dZ, Magma_CPU, Magma_DEV, queue ));
         TESTING_CHECK( magma_zmtransfer( A, &dA, Magma_CPU, Magma_DEV, queue ));
@@ -75,10 +147,24 @@ int main(  int argc, char** argv )
         TESTING_CHECK( magma_zmtransfer( dA, &A2, Magma_DEV, Magma_CPU, queue ));
         
         magma_zprint_matrix(A2, queue );
+
+        // CPU and GPU weights are the same up to rounding
+        resd = 0.0;
+        for(magma_int_t k=0; k < A2.nnz; k++) {
+            resd = max( resd, MAGMA_Z_ABS( MAGMA_Z_SUB( A2.val[k], hA.val[k] )));
+        }
+        printf("%% max difference CPU - GPU: %.2e\n", resd );
+        if ( resd > 1e-6 ) {
+            printf("%% tester Jaccard weights:  failed\n");
+            info = -1;
+        } else {
+            printf("%% tester Jaccard weights:  ok\n");
+        }
         
         
         magma_zmfree(&A, queue );
         magma_zmfree(&A2, queue );
+        magma_zmfree(&hA, queue );
         magma_zmfree(&Z, queue );
         magma_zmfree(&dA, queue );
         magma_zmfree(&dZ, queue );
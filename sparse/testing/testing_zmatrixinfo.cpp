@@ -34,12 +34,17 @@ int main(  int argc, char** argv )
     magma_queue_t queue=NULL;
     magma_queue_create( 0, &queue );
     
-    magma_z_matrix Z={Magma_CSR};
+    magma_z_matrix Z={Magma_CSR}, Y={Magma_CSR};
+    magma_matrix_profile profile, scaled, fresh;
+    magma_storage_t format;
+    int status = 0;
     
     int i=1;
     TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
     printf("matrixinfo = [\n");
-    printf("%%   size (n)   ||   nonzeros (nnz)   ||   nnz/n\n");
+    printf("%%   size (n)   ||   nonzeros (nnz)   ||   nnz/n   ||   max nnz/row   ||   row variance"
+           "   ||   bandwidth   ||   empty rows   ||   max diag. dominance   ||   pattern symmetry"
+           "   ||   ELL padding   ||   SELL-P padding   ||   format\n");
     printf("%%=============================================================%%\n");
     while( i < argc ) {
         if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
@@ -50,9 +55,34 @@ int main(  int argc, char** argv )
             TESTING_CHECK( magma_z_csr_mtx( &Z,  argv[i], queue ));
         }
 
-        printf("   %10lld          %10lld          %10lld\n",
-               (long long) Z.num_rows, (long long) Z.nnz, (long long) (Z.nnz/Z.num_rows) );
+        TESTING_CHECK( magma_zmprofile( &Z, &profile, queue ));
+        TESTING_CHECK( magma_zmrecommend_format( &Z, &format, queue ));
 
+        printf("   %10lld          %10lld          %10lld          %10lld          %10.2f"
+               "          %10lld          %10lld          %10.4f          %10.4f"
+               "          %10.0f          %10.0f          %s\n",
+               (long long) Z.num_rows, (long long) Z.nnz, (long long) (Z.nnz/Z.num_rows),
+               (long long) profile.max_row, profile.var_row,
+               (long long) profile.bandwidth, (long long) profile.empty_rows,
+               profile.dd_max, profile.pattern_symmetry,
+               profile.ell_padding, profile.sellp_padding,
+               format == Magma_ELL   ? "ELL"   :
+               format == Magma_SELLP ? "SELLP" :
+               format == Magma_CSR5  ? "CSR5"  : "CSR" );
+
+        // the cached profile may not outlive in-place scaling: it has to
+        // match the profile of a copy of the scaled matrix
+        TESTING_CHECK( magma_zmscale( &Z, Magma_UNITROW, queue ));
+        TESTING_CHECK( magma_zmprofile( &Z, &scaled, queue ));
+        TESTING_CHECK( magma_zmtransfer( Z, &Y, Magma_CPU, Magma_CPU, queue ));
+        TESTING_CHECK( magma_zmprofile( &Y, &fresh, queue ));
+        bool okay = ( scaled.dd_max == fresh.dd_max && scaled.dd_min == fresh.dd_min
+                      && scaled.missing_diag == fresh.missing_diag
+                      && scaled.max_row == fresh.max_row );
+        status += ! okay;
+        printf("%%   profile after in-place scaling: %s\n", (okay ? "ok" : "failed"));
+
+        magma_zmfree(&Y, queue );
         magma_zmfree(&Z, queue );
 
         i++;
@@ -62,5 +92,5 @@ int main(  int argc, char** argv )
     
     magma_queue_destroy( queue );
     TESTING_CHECK( magma_finalize() );
-    return info;
+    return ( status != 0 ? status : info );
 }
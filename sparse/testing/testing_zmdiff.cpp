@@ -0,0 +1,236 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- the sums of magma_zmdiff_merge, from dense rows: |B-A|^2 on the entries
+      in A and B, |A|^2 on the entries in A only, |B|^2 on those in B only;
+      if D is not NULL, D has to be B - A on the entries in A and B and B
+      elsewhere, else sums[0] is set to -1
+*/
+static void
+zmdiff_ref( magma_z_matrix A, magma_z_matrix B, magma_z_matrix *D, double sums[3] )
+{
+    magmaDoubleComplex *w = NULL;
+    magma_index_t *mark = NULL;
+    bool match = true;
+
+    sums[0] = sums[1] = sums[2] = 0.0;
+    TESTING_CHECK( magma_zmalloc_cpu( &w, A.num_cols ));
+    TESTING_CHECK( magma_index_malloc_cpu( &mark, A.num_cols ));
+    for( magma_int_t j=0; j < A.num_cols; j++ ) {
+        mark[j] = -1;
+    }
+    for( magma_int_t i=0; i < A.num_rows; i++ ) {
+        for( magma_index_t j=A.row[i]; j < A.row[i+1]; j++ ) {
+            w[ A.col[j] ] = A.val[j];
+            mark[ A.col[j] ] = i;
+        }
+        for( magma_index_t k=B.row[i]; k < B.row[i+1]; k++ ) {
+            magma_index_t col = B.col[k];
+            magmaDoubleComplex d = B.val[k];
+            if ( mark[col] == i ) {
+                d = MAGMA_Z_SUB( B.val[k], w[col] );
+                sums[0] += MAGMA_Z_ABS( d ) * MAGMA_Z_ABS( d );
+                mark[col] = -2 - i;   // in A and B
+            }
+            else {
+                sums[2] += MAGMA_Z_ABS( d ) * MAGMA_Z_ABS( d );
+            }
+            if ( D != NULL ) {
+                match = match && MAGMA_Z_EQUAL( D->val[k], d );
+            }
+        }
+        for( magma_index_t j=A.row[i]; j < A.row[i+1]; j++ ) {
+            if ( mark[ A.col[j] ] == i ) {
+                sums[1] += MAGMA_Z_ABS( A.val[j] ) * MAGMA_Z_ABS( A.val[j] );
+            }
+        }
+    }
+    if ( ! match ) {
+        sums[0] = -1.0;
+    }
+    magma_free_cpu( w );
+    magma_free_cpu( mark );
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- largest relative difference of the sums x and y
+*/
+static double
+zsums_diff( const real_Double_t x[3], const double y[3] )
+{
+    double diff = 0.0;
+    for( int t=0; t < 3; t++ ) {
+        double d = fabs( x[t] - y[t] );
+        diff = max( diff, ( y[t] > 0.0 ? d / y[t] : d ));
+    }
+    return diff;
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- B = A with random values
+*/
+static void
+zrandom_values( magma_z_matrix A, magma_z_matrix *B, magma_int_t *ISEED,
+                magma_queue_t queue )
+{
+    magma_int_t ione = 1;
+    TESTING_CHECK( magma_zmtransfer( A, B, Magma_CPU, Magma_CPU, queue ));
+    magma_zlarnv( ione, ISEED, B->nnz, B->val );
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- B = A with the entries of each row in reversed order
+*/
+static void
+zreverse_rows( magma_z_matrix A, magma_z_matrix *B, magma_queue_t queue )
+{
+    TESTING_CHECK( magma_zmtransfer( A, B, Magma_CPU, Magma_CPU, queue ));
+    for( magma_int_t i=0; i < A.num_rows; i++ ) {
+        for( magma_index_t k=A.row[i]; k < A.row[i+1]; k++ ) {
+            magma_index_t r = A.row[i] + A.row[i+1]-1 - k;
+            B->col[r] = A.col[k];
+            B->val[r] = A.val[k];
+        }
+    }
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing magma_zmdiff_merge and magma_zmdiff against dense rows, for
+      matrices with different patterns, sorted and unsorted rows, with and
+      without subtracting; the sums may not depend on the number of threads
+*/
+int main(  int argc, char** argv )
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    magma_z_matrix A={Magma_CSR}, L={Magma_CSR}, U={Magma_CSR}, R={Magma_CSR};
+    magma_z_matrix Ru={Magma_CSR}, T={Magma_CSR}, D={Magma_CSR};
+    magma_z_matrix X[4], Y[4];
+    const char *casename[4] = { "A, A", "L, U", "L, R", "L, R unsorted" };
+    double tol = 100 * lapackf77_dlamch("E");
+    double ref[3], dsums, dres;
+    real_Double_t sums[3], sums1[3], res;
+    magma_int_t ISEED[4] = {0,0,0,1}, num_threads = 1;
+    int nthreads[3] = { 1, 2, 4 };
+    int status = 0;
+
+    #ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    #endif
+
+    int i=1;
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+        } else if ( strcmp("LAPLACE3D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_7stencil(  laplace_size, &A, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
+        }
+
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros\n\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz );
+
+        // L = tril(A) with random values, U = tril(T)^T with other random
+        // values, R = A with random values, and R with unsorted rows:
+        // L and U share the diagonal only, L and R the lower triangle
+        zrandom_values( A, &T, ISEED, queue );
+        TESTING_CHECK( magma_zmatrix_tril( T, &L, queue ));
+        magma_zmfree( &T, queue );
+        zrandom_values( A, &T, ISEED, queue );
+        TESTING_CHECK( magma_zmatrix_tril( T, &R, queue ));
+        TESTING_CHECK( magma_zmtranspose( R, &U, queue ));
+        magma_zmfree( &R, queue );
+        magma_zmfree( &T, queue );
+        zrandom_values( A, &R, ISEED, queue );
+        zreverse_rows( R, &Ru, queue );
+        X[0] = A;  Y[0] = A;
+        X[1] = L;  Y[1] = U;
+        X[2] = L;  Y[2] = R;
+        X[3] = L;  Y[3] = Ru;
+
+        printf("%% matrices        ||B-A||_F    sums        subtract    threads\n");
+        printf("%%===========================================================%%\n");
+        for( int c=0; c < 4; c++ ) {
+            zmdiff_ref( X[c], Y[c], NULL, ref );
+
+            TESTING_CHECK( magma_zmdiff( X[c], Y[c], &res, queue ));
+            dres = fabs( res - sqrt( ref[0] + ref[1] + ref[2] ));
+            dres = ( res > 0.0 ? dres / res : dres );
+
+            // with subtract, B is overwritten with B - A on common entries
+            TESTING_CHECK( magma_zmtransfer( Y[c], &D, Magma_CPU, Magma_CPU, queue ));
+            TESTING_CHECK( magma_zmdiff_merge( X[c], &D, MagmaTrue, sums, queue ));
+            dsums = zsums_diff( sums, ref );
+            zmdiff_ref( X[c], Y[c], &D, ref );
+            bool subok = ( ref[0] >= 0.0 );
+            magma_zmfree( &D, queue );
+
+            // the same sums, bit for bit, for any number of threads
+            bool same = true;
+            for( int t=0; t < 3; t++ ) {
+                #ifdef _OPENMP
+                omp_set_num_threads( nthreads[t] );
+                #endif
+                TESTING_CHECK( magma_zmdiff_merge( X[c], &Y[c], MagmaFalse, sums1, queue ));
+                same = same && sums1[0] == sums[0] && sums1[1] == sums[1]
+                            && sums1[2] == sums[2];
+            }
+            #ifdef _OPENMP
+            omp_set_num_threads( num_threads );
+            #endif
+
+            bool okay = ( dres <= tol && dsums <= tol && subok && same );
+            status += ! okay;
+            printf("  %-14s  %.4e   %.2e    %-8s    %-7s   %s\n",
+                   casename[c], res, dsums, (subok ? "ok" : "wrong"),
+                   (same ? "same" : "differ"), (okay ? "ok" : "failed"));
+        }
+
+        magma_zmfree( &Ru, queue );
+        magma_zmfree( &R, queue );
+        magma_zmfree( &U, queue );
+        magma_zmfree( &L, queue );
+        magma_zmfree( &A, queue );
+        i++;
+    }
+
+    magma_queue_destroy( queue );
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
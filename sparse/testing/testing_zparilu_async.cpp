@@ -0,0 +1,179 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- relative difference of the values of X and Y, which have the same pattern
+*/
+static double
+zdiff_values( magma_z_matrix X, magma_z_matrix Y )
+{
+    double diff = 0.0, nrm = 0.0;
+    for( magma_int_t k=0; k < X.nnz; k++ ) {
+        double d = MAGMA_Z_ABS( MAGMA_Z_SUB( X.val[k], Y.val[k] ));
+        double y = MAGMA_Z_ABS( Y.val[k] );
+        diff += d*d;
+        nrm  += y*y;
+    }
+    return ( nrm > 0.0 ? sqrt( diff / nrm ) : sqrt( diff ));
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing the asynchronous ParILU and ParIC sweeps on the CPU against
+      the fixed point of magma_zparilu_sweep and magma_zparic_sweep:
+      the sweeps may stop only once the exact residual is converged
+*/
+int main(  int argc, char** argv )
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    magma_z_matrix A={Magma_CSR}, AT={Magma_CSR}, Acoo={Magma_CSR}, B={Magma_CSR};
+    magma_z_matrix L0={Magma_CSR}, U0={Magma_CSR}, Lr={Magma_CSR}, Ur={Magma_CSR};
+    magma_z_matrix L={Magma_CSR}, U={Magma_CSR}, UT={Magma_CSR}, LU={Magma_CSR};
+    const magma_int_t maxsweeps = 200;
+    const double rtol = 1000 * lapackf77_dlamch("E");
+    magma_int_t sweeps, num_threads = 1;
+    int nthreads[3] = { 1, 2, 4 };
+    double res0, res, tol, diff;
+    real_Double_t ilures, nonlinres;
+    int status = 0;
+
+    #ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    #endif
+
+    int i=1;
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
+        }
+
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros\n\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz );
+
+        printf("%%         threads  sweeps   res0        res         ||A-LU||    diff\n");
+        printf("%%=====================================================================%%\n");
+
+        // ParILU: L = tril(A) with unit diagonal, U = triu(A) in CSC
+        TESTING_CHECK( magma_zmconvert( A, &Acoo, Magma_CSR, Magma_CSRCOO, queue ));
+        TESTING_CHECK( magma_zmatrix_tril( A, &L0, queue ));
+        for( magma_int_t k=0; k < L0.num_rows; k++ ) {
+            L0.val[ L0.row[k+1]-1 ] = MAGMA_Z_ONE;
+        }
+        TESTING_CHECK( magma_zmtranspose( A, &AT, queue ));
+        TESTING_CHECK( magma_zmatrix_tril( AT, &U0, queue ));
+
+        // the fixed point, from the sweeps of magma_zparilu_sweep
+        TESTING_CHECK( magma_zmtransfer( L0, &Lr, Magma_CPU, Magma_CPU, queue ));
+        TESTING_CHECK( magma_zmtransfer( U0, &Ur, Magma_CPU, Magma_CPU, queue ));
+        for( magma_int_t s=0; s < maxsweeps; s++ ) {
+            TESTING_CHECK( magma_zparilu_sweep( Acoo, &Lr, &Ur, queue ));
+        }
+
+        for( int t=0; t < 3; t++ ) {
+            #ifdef _OPENMP
+            omp_set_num_threads( nthreads[t] );
+            #endif
+            TESTING_CHECK( magma_zmtransfer( L0, &L, Magma_CPU, Magma_CPU, queue ));
+            TESTING_CHECK( magma_zmtransfer( U0, &U, Magma_CPU, Magma_CPU, queue ));
+            TESTING_CHECK( magma_zparilu_sweep_async( Acoo, &L, &U, maxsweeps, 0.0, rtol,
+                                                      &sweeps, &res0, &res, queue ));
+            TESTING_CHECK( magma_z_cucsrtranspose( U, &UT, queue ));
+            TESTING_CHECK( magma_zilures( A, L, UT, &LU, &ilures, &nonlinres, queue ));
+            tol = rtol * res0;
+            diff = max( zdiff_values( L, Lr ), zdiff_values( U, Ur ));
+            bool okay = ( sweeps < maxsweeps && nonlinres <= 1.01*tol
+                          && fabs( res - nonlinres ) <= 0.01*tol
+                          && diff <= 100*rtol );
+            status += ! okay;
+            printf("  ParILU  %7d  %6lld   %.4e  %.4e  %.4e  %.2e   %s\n",
+                   nthreads[t], (long long) sweeps, res0, res, nonlinres, diff,
+                   (okay ? "ok" : "failed"));
+            magma_zmfree( &L, queue );
+            magma_zmfree( &U, queue );
+            magma_zmfree( &UT, queue );
+            magma_zmfree( &LU, queue );
+        }
+        magma_zmfree( &Acoo, queue );
+        magma_zmfree( &L0, queue );
+        magma_zmfree( &U0, queue );
+        magma_zmfree( &Lr, queue );
+        magma_zmfree( &Ur, queue );
+        magma_zmfree( &AT, queue );
+
+        // ParIC on the real part of A, which is symmetric positive definite
+        // for the Laplace matrices: L = tril(A), and A in COO is tril(A)
+        TESTING_CHECK( magma_zmtransfer( A, &B, Magma_CPU, Magma_CPU, queue ));
+        for( magma_int_t k=0; k < B.nnz; k++ ) {
+            B.val[k] = MAGMA_Z_MAKE( MAGMA_Z_REAL( B.val[k] ), 0.0 );
+        }
+        TESTING_CHECK( magma_zmatrix_tril( B, &L0, queue ));
+        TESTING_CHECK( magma_zmconvert( L0, &Acoo, Magma_CSR, Magma_CSRCOO, queue ));
+
+        TESTING_CHECK( magma_zmtransfer( L0, &Lr, Magma_CPU, Magma_CPU, queue ));
+        for( magma_int_t s=0; s < maxsweeps; s++ ) {
+            TESTING_CHECK( magma_zparic_sweep( Acoo, &Lr, queue ));
+        }
+
+        for( int t=0; t < 3; t++ ) {
+            #ifdef _OPENMP
+            omp_set_num_threads( nthreads[t] );
+            #endif
+            TESTING_CHECK( magma_zmtransfer( L0, &L, Magma_CPU, Magma_CPU, queue ));
+            TESTING_CHECK( magma_zparic_sweep_async( Acoo, &L, maxsweeps, 0.0, rtol,
+                                                     &sweeps, &res0, &res, queue ));
+            tol = rtol * res0;
+            diff = zdiff_values( L, Lr );
+            bool okay = ( sweeps < maxsweeps && res <= tol && diff <= 100*rtol );
+            status += ! okay;
+            printf("  ParIC   %7d  %6lld   %.4e  %.4e  %-10s  %.2e   %s\n",
+                   nthreads[t], (long long) sweeps, res0, res, "", diff,
+                   (okay ? "ok" : "failed"));
+            magma_zmfree( &L, queue );
+        }
+        #ifdef _OPENMP
+        omp_set_num_threads( num_threads );
+        #endif
+
+        magma_zmfree( &Acoo, queue );
+        magma_zmfree( &L0, queue );
+        magma_zmfree( &Lr, queue );
+        magma_zmfree( &B, queue );
+        magma_zmfree( &A, queue );
+        i++;
+    }
+
+    magma_queue_destroy( queue );
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
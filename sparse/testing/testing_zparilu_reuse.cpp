@@ -0,0 +1,186 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- relative difference of the values of X and Y, which have the same pattern,
+      after copying both to the CPU
+*/
+static double
+zdiff_factors( magma_z_matrix X, magma_z_matrix Y, magma_queue_t queue )
+{
+    magma_z_matrix hX={Magma_CSR}, hY={Magma_CSR};
+    double diff = 0.0, nrm = 0.0;
+    if ( X.nnz != Y.nnz ) {
+        return 1.0;
+    }
+    magma_zmtransfer( X, &hX, X.memory_location, Magma_CPU, queue );
+    magma_zmtransfer( Y, &hY, Y.memory_location, Magma_CPU, queue );
+    for( magma_int_t k=0; k < hX.nnz; k++ ) {
+        double d = MAGMA_Z_ABS( MAGMA_Z_SUB( hX.val[k], hY.val[k] ));
+        double y = MAGMA_Z_ABS( hY.val[k] );
+        diff += d*d;
+        nrm  += y*y;
+    }
+    magma_zmfree( &hX, queue );
+    magma_zmfree( &hY, queue );
+    return ( nrm > 0.0 ? sqrt( diff / nrm ) : sqrt( diff ));
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- B = A without the off-diagonal entries of the first row and column
+*/
+static void
+zdrop_first( magma_z_matrix A, magma_z_matrix *B, magma_queue_t queue )
+{
+    magma_index_t nnz = 0;
+    TESTING_CHECK( magma_zmtransfer( A, B, Magma_CPU, Magma_CPU, queue ));
+    for( magma_int_t i=0; i < A.num_rows; i++ ) {
+        B->row[i] = nnz;
+        for( magma_index_t k=A.row[i]; k < A.row[i+1]; k++ ) {
+            if ( A.col[k] == i || ( i != 0 && A.col[k] != 0 )) {
+                B->col[nnz] = A.col[k];
+                B->val[nnz] = A.val[k];
+                nnz++;
+            }
+        }
+    }
+    B->row[A.num_rows] = nnz;
+    B->nnz = nnz;
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing the refactorization of ParILU and ParIC on the CPU with
+      precond->reuse set: for a matrix with the same pattern, the stored
+      pattern and device factors are kept and updated, for a matrix with a
+      different pattern, the full setup is done; the factors have to match
+      those of a setup without reuse
+*/
+int main(  int argc, char** argv )
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_zopts zopts, zopts0;
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    magma_z_matrix A={Magma_CSR}, b={Magma_CSR};
+    magma_z_matrix C[3] = { {Magma_CSR}, {Magma_CSR}, {Magma_CSR} };
+    magma_solver_type solver[2] = { Magma_PARILU, Magma_PARIC };
+    const char *solvername[2] = { "ParILU", "ParIC" };
+    const char *casename[3] = { "first", "same pattern", "new pattern" };
+    const double rtol = 1000 * lapackf77_dlamch("E");
+    magma_index_t *hArow;
+    magmaDoubleComplex *Ldval;
+    double diff;
+    int status = 0;
+
+    int i=1;
+    TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
+    zopts.precond_par.sweeps = 200;
+    zopts.precond_par.atol = 0.0;
+    zopts.precond_par.rtol = rtol;
+    zopts0 = zopts;
+    zopts.precond_par.reuse = MagmaTrue;
+    zopts0.precond_par.reuse = MagmaFalse;
+
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
+        }
+
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros\n\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz );
+
+        // the real part of A, which is symmetric positive definite for the
+        // Laplace matrices, without the off-diagonal entries of the first
+        // row and column, then 2 times this, as in time stepping, and the
+        // real part of A, which has a pattern that does not fit the first
+        TESTING_CHECK( magma_zmtransfer( A, &C[2], Magma_CPU, Magma_CPU, queue ));
+        for( magma_int_t k=0; k < C[2].nnz; k++ ) {
+            C[2].val[k] = MAGMA_Z_MAKE( MAGMA_Z_REAL( C[2].val[k] ), 0.0 );
+        }
+        zdrop_first( C[2], &C[0], queue );
+        TESTING_CHECK( magma_zmtransfer( C[0], &C[1], Magma_CPU, Magma_CPU, queue ));
+        for( magma_int_t k=0; k < C[1].nnz; k++ ) {
+            C[1].val[k] = MAGMA_Z_MUL( C[1].val[k], MAGMA_Z_MAKE( 2.0, 0.0 ));
+        }
+        TESTING_CHECK( magma_zvinit( &b, Magma_CPU, A.num_rows, 1, MAGMA_Z_ONE, queue ));
+
+        printf("%% precond   matrix          sweeps   kept   ||(L,U)-(L0,U0)||\n");
+        printf("%%=========================================================%%\n");
+        for( int s=0; s < 2; s++ ) {
+            zopts.precond_par.solver = solver[s];
+            zopts0.precond_par.solver = solver[s];
+            TESTING_CHECK( magma_zsolverinfo_init( &zopts.solver_par, &zopts.precond_par, queue ));
+            hArow = NULL;
+            Ldval = NULL;
+            for( int c=0; c < 3; c++ ) {
+                // with reuse, and the reference setup without
+                TESTING_CHECK( magma_zsolverinfo_init( &zopts0.solver_par, &zopts0.precond_par, queue ));
+                if ( solver[s] == Magma_PARILU ) {
+                    TESTING_CHECK( magma_zparilu_cpu( C[c], b, &zopts.precond_par, queue ));
+                    TESTING_CHECK( magma_zparilu_cpu( C[c], b, &zopts0.precond_par, queue ));
+                } else {
+                    TESTING_CHECK( magma_zparic_cpu( C[c], b, &zopts.precond_par, queue ));
+                    TESTING_CHECK( magma_zparic_cpu( C[c], b, &zopts0.precond_par, queue ));
+                }
+                diff = max( zdiff_factors( zopts.precond_par.L, zopts0.precond_par.L, queue ),
+                            zdiff_factors( zopts.precond_par.U, zopts0.precond_par.U, queue ));
+
+                // the stored pattern and the device factors are kept only
+                // for the same pattern
+                bool kept = ( zopts.precond_par.hA.row == hArow
+                              && zopts.precond_par.L.dval == Ldval );
+                bool okay = ( diff <= 100*rtol && kept == (c == 1)
+                              && zopts0.precond_par.hA.val == NULL );
+                status += ! okay;
+                printf("  %-8s  %-14s  %6lld   %-4s   %.2e    %s\n",
+                       solvername[s], casename[c],
+                       (long long) zopts.precond_par.numiter, (kept ? "yes" : "no"),
+                       diff, (okay ? "ok" : "failed"));
+                hArow = zopts.precond_par.hA.row;
+                Ldval = zopts.precond_par.L.dval;
+                magma_zsolverinfo_free( &zopts0.solver_par, &zopts0.precond_par, queue );
+            }
+            magma_zsolverinfo_free( &zopts.solver_par, &zopts.precond_par, queue );
+        }
+
+        for( int c=0; c < 3; c++ ) {
+            magma_zmfree( &C[c], queue );
+        }
+        magma_zmfree( &b, queue );
+        magma_zmfree( &A, queue );
+        i++;
+    }
+
+    magma_queue_destroy( queue );
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
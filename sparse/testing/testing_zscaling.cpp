@@ -0,0 +1,211 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- largest deviation of the row and column max norms of A from 1
+*/
+static double
+zmaxnorm_dev( magma_z_matrix A )
+{
+    double *colmax = NULL, dev = 0.0;
+    magma_dmalloc_cpu( &colmax, A.num_cols );
+    for( magma_int_t j=0; j < A.num_cols; j++ ) {
+        colmax[j] = 0.0;
+    }
+    for( magma_int_t i=0; i < A.num_rows; i++ ) {
+        double rowmax = 0.0;
+        for( magma_index_t k=A.row[i]; k < A.row[i+1]; k++ ) {
+            rowmax = max( rowmax, MAGMA_Z_ABS( A.val[k] ));
+            colmax[ A.col[k] ] = max( colmax[ A.col[k] ], MAGMA_Z_ABS( A.val[k] ));
+        }
+        dev = max( dev, fabs( rowmax - 1.0 ));
+    }
+    for( magma_int_t j=0; j < A.num_cols; j++ ) {
+        dev = max( dev, fabs( colmax[j] - 1.0 ));
+    }
+    magma_free_cpu( colmax );
+    return dev;
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- relative difference of B and diag( dr ) * A * diag( dc ), which have
+      the same pattern; dr or dc NULL means no scaling
+*/
+static double
+zscaled_diff( magma_z_matrix A, magma_z_matrix B,
+              magmaDoubleComplex *dr, magmaDoubleComplex *dc )
+{
+    double diff = 0.0, nrm = 0.0;
+    for( magma_int_t i=0; i < A.num_rows; i++ ) {
+        for( magma_index_t k=A.row[i]; k < A.row[i+1]; k++ ) {
+            magmaDoubleComplex s = A.val[k];
+            if ( dr != NULL ) {
+                s = MAGMA_Z_MUL( s, dr[i] );
+            }
+            if ( dc != NULL ) {
+                s = MAGMA_Z_MUL( s, dc[ A.col[k] ] );
+            }
+            double d = MAGMA_Z_ABS( MAGMA_Z_SUB( B.val[k], s ));
+            diff += d*d;
+            nrm  += MAGMA_Z_ABS( s ) * MAGMA_Z_ABS( s );
+        }
+    }
+    return ( nrm > 0.0 ? sqrt( diff / nrm ) : sqrt( diff ));
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing the scaling object: magma_zscaling_create, _apply, _vector and
+      _free for the scaling types and sides, and the Ruiz equilibration
+*/
+int main(  int argc, char** argv )
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    magma_z_matrix A={Magma_CSR}, A2={Magma_CSR}, B={Magma_CSR};
+    magma_z_matrix x={Magma_CSR}, y={Magma_CSR}, b={Magma_CSR}, By={Magma_CSR};
+    magma_z_matrix dy={Magma_CSR};
+    magma_z_scaling S;
+    magma_scale_t scalings[4] = { Magma_UNITROW, Magma_UNITDIAG, Magma_UNITCOL, Magma_RUIZ };
+    const char *scalename[4] = { "UNITROW", "UNITDIAG", "UNITCOL", "RUIZ" };
+    magma_side_t sides[3] = { MagmaLeft, MagmaRight, MagmaBothSides };
+    const char *sidename[3] = { "left", "right", "both" };
+    double tol = 100 * lapackf77_dlamch("E");
+    double dA, dA2, dx, dev;
+    magma_int_t ione = 1, ISEED[4] = {0,0,0,1};
+    int status = 0;
+
+    int i=1;
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
+        }
+        magma_int_t n = A.num_rows;
+
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros\n\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz );
+
+        // A2 = 2 A has the same pattern, as in time stepping
+        TESTING_CHECK( magma_zmtransfer( A, &A2, Magma_CPU, Magma_CPU, queue ));
+        for( magma_int_t k=0; k < A2.nnz; k++ ) {
+            A2.val[k] = MAGMA_Z_MUL( A2.val[k], MAGMA_Z_MAKE( 2.0, 0.0 ));
+        }
+
+        printf("%% scaling   side    ||B-DrADc||  ||B2-DrA2Dc||  ||By-Dr(A(Dc y))||\n");
+        printf("%%=================================================================%%\n");
+        for( int sc=0; sc < 4; sc++ ) {
+            for( int sd=0; sd < 3; sd++ ) {
+                TESTING_CHECK( magma_zscaling_create( A, scalings[sc], sides[sd], &S, queue ));
+
+                // the factors scale A, and later matrices with the same pattern
+                TESTING_CHECK( magma_zmtransfer( A, &B, Magma_CPU, Magma_CPU, queue ));
+                TESTING_CHECK( magma_zscaling_apply( S, &B, queue ));
+                dA = zscaled_diff( A, B, S.dr.val, S.dc.val );
+                magma_zmfree( &B, queue );
+                TESTING_CHECK( magma_zmtransfer( A2, &B, Magma_CPU, Magma_CPU, queue ));
+                TESTING_CHECK( magma_zscaling_apply( S, &B, queue ));
+                dA2 = zscaled_diff( A2, B, S.dr.val, S.dc.val );
+
+                // the scaled system B y = Dr b, for b = A x, has solution
+                // y with x = Dc y; y is scaled on the device
+                TESTING_CHECK( magma_zvinit( &y, Magma_CPU, n, 1, c_zero, queue ));
+                magma_zlarnv( ione, ISEED, n, y.val );
+                TESTING_CHECK( magma_zmtransfer( y, &x, Magma_CPU, Magma_CPU, queue ));
+                TESTING_CHECK( magma_zmtransfer( y, &dy, Magma_CPU, Magma_DEV, queue ));
+                TESTING_CHECK( magma_zscaling_vector( S, MagmaRight, &dy, queue ));
+                magma_zmfree( &x, queue );
+                TESTING_CHECK( magma_zmtransfer( dy, &x, Magma_DEV, Magma_CPU, queue ));
+                TESTING_CHECK( magma_zvinit( &b, Magma_CPU, n, 1, c_zero, queue ));
+                TESTING_CHECK( magma_zvinit( &By, Magma_CPU, n, 1, c_zero, queue ));
+                TESTING_CHECK( magma_z_spmv( c_one, A, x, c_zero, b, queue ));
+                TESTING_CHECK( magma_zscaling_vector( S, MagmaLeft, &b, queue ));
+                magma_zmfree( &B, queue );
+                TESTING_CHECK( magma_zmtransfer( A, &B, Magma_CPU, Magma_CPU, queue ));
+                TESTING_CHECK( magma_zscaling_apply( S, &B, queue ));
+                TESTING_CHECK( magma_z_spmv( c_one, B, y, c_zero, By, queue ));
+                blasf77_zaxpy( &n, &c_neg_one, b.val, &ione, By.val, &ione );
+                dx = magma_cblas_dznrm2( n, By.val, 1 ) / magma_cblas_dznrm2( n, b.val, 1 );
+
+                // free clears the factors, and a second free is harmless
+                TESTING_CHECK( magma_zscaling_free( &S, queue ));
+                TESTING_CHECK( magma_zscaling_free( &S, queue ));
+                bool okay = ( dA <= tol && dA2 <= tol && dx <= tol
+                              && S.dr.val == NULL && S.dc.val == NULL
+                              && S.scaling == Magma_NOSCALE );
+                status += ! okay;
+                printf("  %-8s  %-5s   %.2e     %.2e       %.2e            %s\n",
+                       scalename[sc], sidename[sd], dA, dA2, dx,
+                       (okay ? "ok" : "failed"));
+
+                magma_zmfree( &B, queue );
+                magma_zmfree( &x, queue );
+                magma_zmfree( &y, queue );
+                magma_zmfree( &dy, queue );
+                magma_zmfree( &b, queue );
+                magma_zmfree( &By, queue );
+            }
+        }
+
+        // Ruiz equilibration: the rows and columns of the scaled matrix
+        // have max norm near 1, with the factors of the scaling object
+        // and with magma_zmscale
+        TESTING_CHECK( magma_zscaling_create( A, Magma_RUIZ, MagmaBothSides, &S, queue ));
+        TESTING_CHECK( magma_zmtransfer( A, &B, Magma_CPU, Magma_CPU, queue ));
+        TESTING_CHECK( magma_zscaling_apply( S, &B, queue ));
+        dev = zmaxnorm_dev( B );
+        bool okay = ( dev <= 0.1 );
+        status += ! okay;
+        printf("%% Ruiz, magma_zscaling_apply: max | max norm - 1 | = %.2e   %s\n",
+               dev, (okay ? "ok" : "failed"));
+        TESTING_CHECK( magma_zscaling_free( &S, queue ));
+        magma_zmfree( &B, queue );
+
+        TESTING_CHECK( magma_zmtransfer( A, &B, Magma_CPU, Magma_CPU, queue ));
+        TESTING_CHECK( magma_zmscale( &B, Magma_RUIZ, queue ));
+        dev = zmaxnorm_dev( B );
+        okay = ( dev <= 0.1 );
+        status += ! okay;
+        printf("%% Ruiz, magma_zmscale:        max | max norm - 1 | = %.2e   %s\n",
+               dev, (okay ? "ok" : "failed"));
+        magma_zmfree( &B, queue );
+
+        magma_zmfree( &A2, queue );
+        magma_zmfree( &A, queue );
+        i++;
+    }
+
+    magma_queue_destroy( queue );
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
@@ -0,0 +1,111 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing the restricted additive Schwarz preconditioner on the CPU:
+      PBiCGSTAB with ILU(0) and ParILUT subdomain factors has to converge,
+      and a zero pivot has to be rejected by the setup
+*/
+int main(  int argc, char** argv )
+{
+    magma_int_t info = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_zopts zopts;
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    magma_z_matrix A={Magma_CSR}, A0={Magma_CSR}, b={Magma_CSR}, x={Magma_CSR};
+    magma_solver_type subsolver[2] = { Magma_ILU, Magma_PARILUT };
+    const char *subname[2] = { "ILU", "PARILUT" };
+    double nrmb, res;
+    int status = 0;
+
+    int i=1;
+    TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
+    zopts.solver_par.solver = Magma_PBICGSTABMERGE;
+    zopts.precond_par.solver = Magma_SCHWARZ;
+    TESTING_CHECK( magma_zsolverinfo_init( &zopts.solver_par, &zopts.precond_par, queue ));
+
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+        } else if ( strcmp("LAPLACE3D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_7stencil(  laplace_size, &A, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
+        }
+
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros\n\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz );
+
+        TESTING_CHECK( magma_zvinit( &b, Magma_CPU, A.num_rows, 1, MAGMA_Z_ONE, queue ));
+        nrmb = magma_cblas_dznrm2( A.num_rows, b.val, 1 );
+
+        printf("%% subsolver   overlap   iters   ||b-Ax|| / ||b||\n");
+        printf("%%================================================%%\n");
+        for( int s=0; s < 2; s++ ) {
+            zopts.precond_par.subsolver = subsolver[s];
+            TESTING_CHECK( magma_zvinit( &x, Magma_CPU, A.num_cols, 1, MAGMA_Z_ZERO, queue ));
+            info = magma_zpbicgstab_cpu( A, b, &x, &zopts.solver_par, &zopts.precond_par, queue );
+            res = zopts.solver_par.final_res / nrmb;
+            bool okay = ( info == 0 && res < 10*zopts.solver_par.rtol );
+            status += ! okay;
+            printf("  %-9s  %7lld  %6lld   %8.2e   %s\n",
+                   subname[s], (long long) zopts.precond_par.pattern,
+                   (long long) zopts.solver_par.numiter, res,
+                   (okay ? "ok" : "failed"));
+            magma_zmfree( &x, queue );
+        }
+
+        // zero the first diagonal entry; each subdomain factor has to be rejected
+        TESTING_CHECK( magma_zmtransfer( A, &A0, Magma_CPU, Magma_CPU, queue ));
+        for( magma_index_t e=A0.row[0]; e < A0.row[1]; e++ ) {
+            if ( A0.col[e] == 0 ) {
+                A0.val[e] = MAGMA_Z_ZERO;
+            }
+        }
+        for( int s=0; s < 2; s++ ) {
+            zopts.precond_par.subsolver = subsolver[s];
+            info = magma_zschwarz_setup_cpu( A0, &zopts.precond_par, queue );
+            bool okay = ( info == MAGMA_ERR_BADPRECOND );
+            status += ! okay;
+            printf("%% zero pivot, %-7s: %s\n", subname[s], (okay ? "ok" : "failed"));
+        }
+        info = 0;
+
+        magma_zmfree( &A0, queue );
+        magma_zmfree( &A, queue );
+        magma_zmfree( &b, queue );
+        i++;
+    }
+
+    magma_zsolverinfo_free( &zopts.solver_par, &zopts.precond_par, queue );
+    magma_queue_destroy( queue );
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
@@ -18,11 +18,218 @@
 // includes, project
 #include "magma_v2.h"
 #include "magmasparse.h"
+#include "magma_lapack.h"
 #include "testings.h"
 
 
 /* ////////////////////////////////////////////////////////////////////////////
-   -- testing any solver
+   -- x = the solution of S x = b with the options zopts on the CPU, from a
+      zero initial guess; a copy of zopts is used, as freeing the solver
+      info resets the preconditioner. Returns the solver info and sets iters
+*/
+static magma_int_t
+zsolve_cpu( magma_z_matrix S, magma_z_matrix b, magma_z_matrix *x,
+            magma_zopts zopts, magma_int_t *iters, magma_queue_t queue )
+{
+    TESTING_CHECK( magma_zsolverinfo_init( &zopts.solver_par, &zopts.precond_par, queue ));
+    TESTING_CHECK( magma_zvinit( x, Magma_CPU, S.num_rows, b.num_cols, MAGMA_Z_ZERO, queue ));
+    x->major = b.major;
+    magma_int_t info = magma_z_solver( S, b, x, &zopts, queue );
+    *iters = zopts.solver_par.numiter;
+    magma_zsolverinfo_free( &zopts.solver_par, &zopts.precond_par, queue );
+    return info;
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- the solver of zopts on the CPU for 4 right-hand sides at once, ones and
+      random columns, in column- and row-major order: each column has to
+      reach the requested residual, and the block solve has to take the
+      iterations of its slowest column solved on its own. For CG and PCG,
+      a column that breaks down may not lose the others: for diag( 1, -1 )
+      and [ e1, e2 ], x has to be [ e1, 0 ], with MAGMA_NONSPD.
+      Returns the number of failed checks.
+*/
+static int
+zsolver_block_cpu( magma_z_matrix S, magma_zopts *zopts, bool hpd, magma_queue_t queue )
+{
+    magma_z_matrix B={Magma_CSR}, b={Magma_CSR}, x={Magma_CSR}, T={Magma_CSR};
+    magma_order_t major[2] = { MagmaColMajor, MagmaRowMajor };
+    const char *majorname[2] = { "column", "row" };
+    const magma_int_t nrhs = 4;
+    magma_int_t info, iters, maxiters = 0, n = S.num_rows;
+    magma_int_t ione = 1, ISEED[4] = {0,0,0,1};
+    double res[nrhs], maxres;
+    int status = 0;
+
+    TESTING_CHECK( magma_zvinit( &B, Magma_CPU, n, nrhs, MAGMA_Z_ONE, queue ));
+    for( magma_int_t j=1; j < nrhs; j++ ) {
+        magma_zlarnv( ione, ISEED, n, B.val + j*n );
+    }
+
+    // the iterations of the slowest column, solved on its own
+    for( magma_int_t j=0; j < nrhs; j++ ) {
+        TESTING_CHECK( magma_zvinit( &b, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+        blasf77_zcopy( &n, B.val + j*n, &ione, b.val, &ione );
+        zsolve_cpu( S, b, &x, *zopts, &iters, queue );
+        maxiters = max( maxiters, iters );
+        magma_zmfree( &x, queue );
+        magma_zmfree( &b, queue );
+    }
+
+    for( int m=0; m < 2; m++ ) {
+        // column j of a row-major block starts at entry j, with stride nrhs
+        TESTING_CHECK( magma_zvinit( &b, Magma_CPU, n, nrhs, MAGMA_Z_ZERO, queue ));
+        b.major = major[m];
+        for( magma_int_t j=0; j < nrhs; j++ ) {
+            if ( major[m] == MagmaRowMajor ) {
+                blasf77_zcopy( &n, B.val + j*n, &ione, b.val + j, &nrhs );
+            }
+            else {
+                blasf77_zcopy( &n, B.val + j*n, &ione, b.val + j*n, &ione );
+            }
+        }
+        info = zsolve_cpu( S, b, &x, *zopts, &iters, queue );
+        TESTING_CHECK( magma_zresidual( S, b, x, res, queue ));
+        maxres = 0.0;
+        for( magma_int_t j=0; j < nrhs; j++ ) {
+            maxres = max( maxres, res[j] / magma_cblas_dznrm2( n, B.val + j*n, 1 ));
+        }
+        bool okay = ( info == 0 && maxres < 10*zopts->solver_par.rtol && iters == maxiters );
+        status += ! okay;
+        printf("%% %lld right-hand sides, %s-major: %lld iterations (slowest column %lld), "
+               "max ||b-Ax|| / ||b|| = %8.2e   %s\n",
+               (long long) nrhs, majorname[m], (long long) iters, (long long) maxiters,
+               maxres, (okay ? "ok" : "failed"));
+        magma_zmfree( &x, queue );
+        magma_zmfree( &b, queue );
+    }
+
+    if ( hpd ) {
+        magma_index_t row[3] = { 0, 1, 2 }, col[2] = { 0, 1 };
+        magmaDoubleComplex val[2] = { MAGMA_Z_ONE, MAGMA_Z_NEG_ONE };
+        TESTING_CHECK( magma_zcsrset( 2, 2, row, col, val, &T, queue ));
+        TESTING_CHECK( magma_zvinit( &b, Magma_CPU, 2, 2, MAGMA_Z_ZERO, queue ));
+        b.val[0] = b.val[3] = MAGMA_Z_ONE;
+        info = zsolve_cpu( T, b, &x, *zopts, &iters, queue );
+        bool okay = ( info == MAGMA_NONSPD && MAGMA_Z_EQUAL( x.val[0], MAGMA_Z_ONE )
+                      && MAGMA_Z_EQUAL( x.val[1], MAGMA_Z_ZERO )
+                      && MAGMA_Z_EQUAL( x.val[2], MAGMA_Z_ZERO )
+                      && MAGMA_Z_EQUAL( x.val[3], MAGMA_Z_ZERO ));
+        status += ! okay;
+        printf("%% breakdown of one column for diag( 1, -1 ), x = [ e1, 0 ]: %s\n",
+               (okay ? "ok" : "failed"));
+        magma_zmfree( &x, queue );
+        magma_zmfree( &b, queue );
+    }
+
+    magma_zmfree( &B, queue );
+    return status;
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- the solver of zopts on the CPU, for b = ones: it has to reach the
+      requested residual, checked as ||b - A x|| / ||b||. PCG with Jacobi
+      has to be invariant under diagonal scaling: for the badly scaled
+      D A D and D b, it has to find D^{-1} x after the same iterations,
+      which CG does not. CG, PCG, and BiCGSTAB are also checked with several
+      right-hand sides, see zsolver_block_cpu. CG and PCG solve with the
+      real part of A, which is symmetric positive definite for the Laplace
+      matrices. Returns the number of failed checks.
+*/
+static int
+zsolver_cpu( magma_z_matrix A, magma_zopts *zopts, magma_queue_t queue )
+{
+    magma_z_matrix S={Magma_CSR}, DS={Magma_CSR}, b={Magma_CSR}, Db={Magma_CSR};
+    magma_z_matrix x={Magma_CSR}, xs={Magma_CSR};
+    double *d = NULL;
+    magma_solver_type solver = zopts->solver_par.solver;
+    bool hpd = ( solver == Magma_CG  || solver == Magma_CGMERGE ||
+                 solver == Magma_PCG || solver == Magma_PCGMERGE );
+    magma_int_t info, iters, n = A.num_rows;
+    double res, dpcg, dcg;
+    int status = 0;
+
+    TESTING_CHECK( magma_zmtransfer( A, &S, Magma_CPU, Magma_CPU, queue ));
+    if ( hpd ) {
+        for( magma_int_t k=0; k < S.nnz; k++ ) {
+            S.val[k] = MAGMA_Z_MAKE( MAGMA_Z_REAL( S.val[k] ), 0.0 );
+        }
+    }
+    TESTING_CHECK( magma_zvinit( &b, Magma_CPU, n, 1, MAGMA_Z_ONE, queue ));
+
+    info = zsolve_cpu( S, b, &x, *zopts, &iters, queue );
+    TESTING_CHECK( magma_zresidual( S, b, x, &res, queue ));
+    res /= magma_cblas_dznrm2( n, b.val, 1 );
+    bool okay = ( info == 0 && res < 10*zopts->solver_par.rtol );
+    status += ! okay;
+    printf("%% solver on the CPU: %lld iterations, ||b-Ax|| / ||b|| = %8.2e   %s\n",
+           (long long) iters, res, (okay ? "ok" : "failed"));
+    magma_zmfree( &x, queue );
+
+    if ( hpd || solver == Magma_BICGSTAB || solver == Magma_BICGSTABMERGE ) {
+        status += zsolver_block_cpu( S, zopts, hpd, queue );
+    }
+
+    if ( hpd && zopts->precond_par.solver == Magma_JACOBI ) {
+        // D spans three orders of magnitude; half the iterations keep
+        // the iterates away from the solution
+        magma_int_t k = max( 1, iters/2 );
+        magma_zopts opts = *zopts;
+        opts.solver_par.maxiter = k;
+        opts.solver_par.atol = 0.0;
+        opts.solver_par.rtol = 0.0;
+        TESTING_CHECK( magma_zmtransfer( S, &DS, Magma_CPU, Magma_CPU, queue ));
+        TESTING_CHECK( magma_zmtransfer( b, &Db, Magma_CPU, Magma_CPU, queue ));
+        TESTING_CHECK( magma_dmalloc_cpu( &d, n ));
+        for( magma_int_t r=0; r < n; r++ ) {
+            d[r] = pow( 10., (r % 7) / 2. );
+        }
+        for( magma_int_t r=0; r < n; r++ ) {
+            for( magma_index_t j=DS.row[r]; j < DS.row[r+1]; j++ ) {
+                DS.val[j] = MAGMA_Z_MUL( DS.val[j], MAGMA_Z_MAKE( d[r] * d[ DS.col[j] ], 0.0 ));
+            }
+            Db.val[r] = MAGMA_Z_MUL( Db.val[r], MAGMA_Z_MAKE( d[r], 0.0 ));
+        }
+
+        opts.solver_par.solver = Magma_PCG;
+        zsolve_cpu( S, b, &x, opts, &iters, queue );
+        double xnrm = magma_cblas_dznrm2( n, x.val, 1 );
+        zsolve_cpu( DS, Db, &xs, opts, &iters, queue );
+        for( magma_int_t r=0; r < n; r++ ) {
+            xs.val[r] = MAGMA_Z_SUB( MAGMA_Z_MUL( xs.val[r], MAGMA_Z_MAKE( d[r], 0.0 )), x.val[r] );
+        }
+        dpcg = magma_cblas_dznrm2( n, xs.val, 1 ) / xnrm;
+        magma_zmfree( &xs, queue );
+        opts.solver_par.solver = Magma_CG;
+        zsolve_cpu( DS, Db, &xs, opts, &iters, queue );
+        for( magma_int_t r=0; r < n; r++ ) {
+            xs.val[r] = MAGMA_Z_SUB( MAGMA_Z_MUL( xs.val[r], MAGMA_Z_MAKE( d[r], 0.0 )), x.val[r] );
+        }
+        dcg = magma_cblas_dznrm2( n, xs.val, 1 ) / xnrm;
+
+        okay = ( dpcg < sqrt( lapackf77_dlamch("E") ) && dcg > 100*dpcg );
+        status += ! okay;
+        printf("%% %lld iterations for D A D: ||D x_pcg - x|| / ||x|| = %8.2e, "
+               "||D x_cg - x|| / ||x|| = %8.2e   %s\n",
+               (long long) k, dpcg, dcg, (okay ? "ok" : "failed"));
+        magma_free_cpu( d );
+        magma_zmfree( &xs, queue );
+        magma_zmfree( &x, queue );
+        magma_zmfree( &Db, queue );
+        magma_zmfree( &DS, queue );
+    }
+
+    magma_zmfree( &b, queue );
+    magma_zmfree( &S, queue );
+    return status;
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing any solver; with --cpu, the CG, PCG, BiCGSTAB, and PBiCGSTAB
+      on the host are checked, see zsolver_cpu
 */
 int main(  int argc, char** argv )
 {
@@ -37,29 +244,46 @@ int main(  int argc, char** argv )
     // magmaDoubleComplex zero = MAGMA_Z_MAKE(0.0, 0.0);
     magma_z_matrix A={Magma_CSR}, B={Magma_CSR}, dB={Magma_CSR};
     magma_z_matrix x={Magma_CSR}, b={Magma_CSR};
+    int status = 0;
     
     int i=1;
     TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
     B.blocksize = zopts.blocksize;
     B.alignment = zopts.alignment;
 
-    TESTING_CHECK( magma_zsolverinfo_init( &zopts.solver_par, &zopts.precond_par, queue ));
+    // on the CPU, each solve initializes its own solver info
+    if ( zopts.compute_location != Magma_CPU ) {
+        TESTING_CHECK( magma_zsolverinfo_init( &zopts.solver_par, &zopts.precond_par, queue ));
+    }
 
     while( i < argc ) {
         if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
             i++;
             magma_int_t laplace_size = atoi( argv[i] );
             TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+        } else if ( strcmp("LAPLACE3D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_7stencil(  laplace_size, &A, queue ));
         } else {                        // file-matrix test
             TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
         }
 
+        // scale matrix
+        TESTING_CHECK( magma_zmscale( &A, zopts.scaling, queue ));
+
+        if ( zopts.compute_location == Magma_CPU ) {
+            printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros\n\n",
+                    (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz );
+            status += zsolver_cpu( A, &zopts, queue );
+            magma_zmfree(&A, queue );
+            i++;
+            continue;
+        }
+
         // for the eigensolver case
         zopts.solver_par.ev_length = A.num_cols;
         TESTING_CHECK( magma_zeigensolverinfo_init( &zopts.solver_par, queue ));
-
-        // scale matrix
-        TESTING_CHECK( magma_zmscale( &A, zopts.scaling, queue ));
         
         // preconditioner
         if ( zopts.solver_par.solver != Magma_ITERREF ) {
@@ -118,5 +342,5 @@ int main(  int argc, char** argv )
 
     magma_queue_destroy( queue );
     TESTING_CHECK( magma_finalize() );
-    return info;
+    return ( status != 0 ? status : info );
 }
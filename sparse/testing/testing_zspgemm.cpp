@@ -0,0 +1,185 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- relative difference of C and alpha * A * B, accumulated row by row in
+      a dense row; 1 if the pattern of C is not the structural pattern of
+      A * B with sorted columns
+*/
+static double
+zspgemm_diff( magmaDoubleComplex alpha, magma_z_matrix A, magma_z_matrix B,
+              magma_z_matrix C )
+{
+    magmaDoubleComplex *w = NULL;
+    magma_index_t *mark = NULL;
+    double diff = 0.0, nrm = 0.0;
+    bool pattern = ( C.num_rows == A.num_rows && C.num_cols == B.num_cols );
+
+    TESTING_CHECK( magma_zmalloc_cpu( &w, B.num_cols ));
+    TESTING_CHECK( magma_index_malloc_cpu( &mark, B.num_cols ));
+    for( magma_int_t j=0; j < B.num_cols; j++ ) {
+        mark[j] = -1;
+    }
+    for( magma_int_t i=0; pattern && i < A.num_rows; i++ ) {
+        magma_int_t count = 0;
+        for( magma_index_t j=A.row[i]; j < A.row[i+1]; j++ ) {
+            magmaDoubleComplex a = MAGMA_Z_MUL( alpha, A.val[j] );
+            for( magma_index_t l=B.row[ A.col[j] ]; l < B.row[ A.col[j]+1 ]; l++ ) {
+                magma_index_t col = B.col[l];
+                if ( mark[col] != i ) {
+                    mark[col] = i;
+                    w[col] = MAGMA_Z_ZERO;
+                    count++;
+                }
+                w[col] = MAGMA_Z_ADD( w[col], MAGMA_Z_MUL( a, B.val[l] ));
+            }
+        }
+        pattern = ( C.row[i+1] - C.row[i] == count );
+        for( magma_index_t p=C.row[i]; pattern && p < C.row[i+1]; p++ ) {
+            magma_index_t col = C.col[p];
+            pattern = ( mark[col] == i && ( p == C.row[i] || col > C.col[p-1] ));
+            double d = MAGMA_Z_ABS( MAGMA_Z_SUB( C.val[p], w[col] ));
+            diff += d*d;
+            nrm  += MAGMA_Z_ABS( w[col] ) * MAGMA_Z_ABS( w[col] );
+        }
+    }
+    magma_free_cpu( w );
+    magma_free_cpu( mark );
+    if ( ! pattern ) {
+        return 1.0;
+    }
+    return ( nrm > 0.0 ? sqrt( diff / nrm ) : sqrt( diff ));
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing the host SpGEMM: magma_zspgemm_cpu and magma_z_spmm for CPU
+      matrices against a dense-row reference, the numeric phase for matrices
+      with the pattern of the symbolic phase, and the numeric phase for a
+      product that does not fit the pattern, which has to be rejected
+*/
+int main(  int argc, char** argv )
+{
+    magma_int_t info = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    magmaDoubleComplex alpha = MAGMA_Z_MAKE( 0.5, -1.0 );
+    magma_z_matrix A={Magma_CSR}, A2={Magma_CSR}, R={Magma_CSR}, L={Magma_CSR};
+    magma_z_matrix U={Magma_CSR}, C={Magma_CSR};
+    magma_z_matrix X[2], Y[2];
+    const char *casename[2] = { "A * R", "L * U" };
+    double tol = 100 * lapackf77_dlamch("E");
+    double dC, dspmm, dC2;
+    magma_int_t ione = 1, ISEED[4] = {0,0,0,1};
+    int status = 0;
+
+    int i=1;
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+        } else if ( strcmp("LAPLACE3D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_7stencil(  laplace_size, &A, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
+        }
+
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros\n\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz );
+
+        // R has the pattern of A and random values; L = tril(R) and
+        // U = tril(R)^T have the patterns of incomplete LU factors;
+        // A2 = 2 A has the same pattern as A
+        TESTING_CHECK( magma_zmtransfer( A, &R, Magma_CPU, Magma_CPU, queue ));
+        magma_zlarnv( ione, ISEED, R.nnz, R.val );
+        TESTING_CHECK( magma_zmatrix_tril( R, &L, queue ));
+        TESTING_CHECK( magma_zmtranspose( L, &U, queue ));
+        TESTING_CHECK( magma_zmtransfer( A, &A2, Magma_CPU, Magma_CPU, queue ));
+        for( magma_int_t k=0; k < A2.nnz; k++ ) {
+            A2.val[k] = MAGMA_Z_MUL( A2.val[k], MAGMA_Z_MAKE( 2.0, 0.0 ));
+        }
+        X[0] = A;  Y[0] = R;
+        X[1] = L;  Y[1] = U;
+
+        printf("%% product     nnz(C)    ||C-aXY||   spmm        numeric, 2X\n");
+        printf("%%==========================================================%%\n");
+        for( int c=0; c < 2; c++ ) {
+            TESTING_CHECK( magma_zspgemm_cpu( alpha, X[c], Y[c], &C, queue ));
+            dC = zspgemm_diff( alpha, X[c], Y[c], C );
+            magma_int_t nnzC = C.nnz;
+            magma_zmfree( &C, queue );
+
+            TESTING_CHECK( magma_z_spmm( alpha, X[c], Y[c], &C, queue ));
+            dspmm = zspgemm_diff( alpha, X[c], Y[c], C );
+            magma_zmfree( &C, queue );
+
+            // the pattern is computed once, the values again for 2 X
+            TESTING_CHECK( magma_zspgemm_symbolic_cpu( X[c], Y[c], &C, queue ));
+            TESTING_CHECK( magma_zspgemm_numeric_cpu( alpha, X[c], Y[c], &C, queue ));
+            if ( c == 0 ) {
+                TESTING_CHECK( magma_zspgemm_numeric_cpu( alpha, A2, Y[c], &C, queue ));
+                dC2 = zspgemm_diff( alpha, A2, Y[c], C );
+            }
+            else {
+                for( magma_int_t k=0; k < L.nnz; k++ ) {
+                    L.val[k] = MAGMA_Z_MUL( L.val[k], MAGMA_Z_MAKE( 2.0, 0.0 ));
+                }
+                TESTING_CHECK( magma_zspgemm_numeric_cpu( alpha, L, U, &C, queue ));
+                dC2 = zspgemm_diff( alpha, L, U, C );
+            }
+            magma_zmfree( &C, queue );
+
+            bool okay = ( dC <= tol && dspmm <= tol && dC2 <= tol );
+            status += ! okay;
+            printf("  %-9s  %8lld    %.2e    %.2e    %.2e    %s\n",
+                   casename[c], (long long) nnzC, dC, dspmm, dC2,
+                   (okay ? "ok" : "failed"));
+        }
+
+        // A * R has entries outside the pattern of L * U
+        TESTING_CHECK( magma_zspgemm_symbolic_cpu( L, U, &C, queue ));
+        info = magma_zspgemm_numeric_cpu( alpha, A, R, &C, queue );
+        bool okay = ( info == MAGMA_ERR_ILLEGAL_VALUE );
+        status += ! okay;
+        printf("%% A * R outside the pattern of L * U: %s\n", (okay ? "ok" : "failed"));
+        info = 0;
+
+        magma_zmfree( &C, queue );
+        magma_zmfree( &U, queue );
+        magma_zmfree( &L, queue );
+        magma_zmfree( &R, queue );
+        magma_zmfree( &A2, queue );
+        magma_zmfree( &A, queue );
+        i++;
+    }
+
+    magma_queue_destroy( queue );
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
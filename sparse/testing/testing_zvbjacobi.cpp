@@ -0,0 +1,220 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- A with each node i of the real part of B expanded to 1 + i % 4
+      unknowns, as in a multiphysics problem: node i starts at row
+      nodestart[i]; the diagonal blocks are dense and Hermitian, with
+      B_ii + 2 on the diagonal, and the coupling of nodes i and j is
+      B_ij / (bs_i bs_j) for all their unknowns, so A is Hermitian positive
+      definite for the Laplace matrices and its rows of a node have the same
+      pattern
+*/
+static void
+zblock_expand( magma_z_matrix B, magma_z_matrix *A, magma_index_t *nodestart,
+               magma_queue_t queue )
+{
+    magma_index_t *row = NULL, *col = NULL;
+    magmaDoubleComplex *val = NULL;
+    magmaDoubleComplex h = MAGMA_Z_MAKE( 0.5, 0.25 );
+    magma_int_t nnz = 0;
+
+    nodestart[0] = 0;
+    for( magma_int_t i=0; i < B.num_rows; i++ ) {
+        nodestart[i+1] = nodestart[i] + 1 + i % 4;
+    }
+    for( magma_int_t i=0; i < B.num_rows; i++ ) {
+        for( magma_index_t k=B.row[i]; k < B.row[i+1]; k++ ) {
+            nnz += (1 + i % 4) * (1 + B.col[k] % 4);
+        }
+    }
+    magma_int_t n = nodestart[ B.num_rows ];
+    TESTING_CHECK( magma_index_malloc_cpu( &row, n+1 ));
+    TESTING_CHECK( magma_index_malloc_cpu( &col, nnz ));
+    TESTING_CHECK( magma_zmalloc_cpu( &val, nnz ));
+
+    nnz = 0;
+    for( magma_int_t i=0; i < B.num_rows; i++ ) {
+        magma_int_t bsi = 1 + i % 4;
+        for( magma_int_t r=0; r < bsi; r++ ) {
+            row[ nodestart[i] + r ] = nnz;
+            for( magma_index_t k=B.row[i]; k < B.row[i+1]; k++ ) {
+                magma_index_t j = B.col[k];
+                magma_int_t bsj = 1 + j % 4;
+                double bij = MAGMA_Z_REAL( B.val[k] );
+                for( magma_int_t c=0; c < bsj; c++ ) {
+                    col[nnz] = nodestart[j] + c;
+                    if ( j != i ) {
+                        val[nnz] = MAGMA_Z_MAKE( bij / (bsi * bsj), 0.0 );
+                    } else if ( r == c ) {
+                        val[nnz] = MAGMA_Z_MAKE( bij + 2.0, 0.0 );
+                    } else {
+                        val[nnz] = ( r < c ? h : MAGMA_Z_CONJ( h ));
+                    }
+                    nnz++;
+                }
+            }
+        }
+    }
+    row[n] = nnz;
+
+    magma_z_matrix T={Magma_CSR};
+    TESTING_CHECK( magma_zcsrset( n, n, row, col, val, &T, queue ));
+    TESTING_CHECK( magma_zmtransfer( T, A, Magma_CPU, Magma_CPU, queue ));
+    magma_free_cpu( row );
+    magma_free_cpu( col );
+    magma_free_cpu( val );
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing the variable-block Jacobi preconditioner on the CPU: the setup
+      has to form diagonal blocks of whole nodes, and applying it to D x,
+      for D the diagonal blocks of A, has to give x; PCG and PBiCGSTAB with
+      it have to converge, checked as ||b - A x|| / ||b||
+*/
+int main(  int argc, char** argv )
+{
+    magma_int_t info = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_zopts zopts;
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    magma_z_matrix A0={Magma_CSR}, A={Magma_CSR}, b={Magma_CSR}, x={Magma_CSR};
+    magma_z_matrix y={Magma_CSR}, z={Magma_CSR};
+    magma_solver_type solver[3] = { Magma_PCG, Magma_PCG, Magma_PBICGSTAB };
+    magma_solver_type precond[3] = { Magma_JACOBI, Magma_VBJACOBI, Magma_VBJACOBI };
+    const char *solvername[3] = { "PCG", "PCG", "PBICGSTAB" };
+    const char *precondname[3] = { "JACOBI", "VBJACOBI", "VBJACOBI" };
+    magma_index_t *nodestart = NULL;
+    magma_int_t ione = 1, ISEED[4] = {0,0,0,1};
+    double tol = 100 * lapackf77_dlamch("E");
+    double dx, res;
+    int status = 0;
+
+    int i=1;
+    TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
+
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A0, queue ));
+        } else if ( strcmp("LAPLACE3D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_7stencil(  laplace_size, &A0, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A0,  argv[i], queue ));
+        }
+        TESTING_CHECK( magma_index_malloc_cpu( &nodestart, A0.num_rows+1 ));
+        zblock_expand( A0, &A, nodestart, queue );
+        magma_int_t n = A.num_rows;
+
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros, %lld nodes\n\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz,
+                (long long) A0.num_rows );
+
+        // the blocks are whole nodes, packed up to the largest block size,
+        // and M (D x) = x for D the diagonal blocks of A in the pattern of M
+        zopts.precond_par.solver = Magma_VBJACOBI;
+        TESTING_CHECK( magma_zsolverinfo_init( &zopts.solver_par, &zopts.precond_par, queue ));
+        TESTING_CHECK( magma_zvbjacobisetup_cpu( A, &zopts.precond_par, queue ));
+        magma_z_matrix M = zopts.precond_par.M;
+        bool blocks = true;
+        for( magma_int_t r=0, k=0; r < n; r++ ) {
+            magma_index_t start = M.col[ M.row[r] ], bs = M.row[r+1] - M.row[r];
+            blocks = blocks && bs <= 8 && start <= r && r < start + bs;
+            if ( r == start ) {
+                while ( nodestart[k] < r ) {
+                    k++;
+                }
+                blocks = blocks && nodestart[k] == r;
+            }
+        }
+
+        TESTING_CHECK( magma_zvinit( &x, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+        TESTING_CHECK( magma_zvinit( &y, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+        TESTING_CHECK( magma_zvinit( &z, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+        magma_zlarnv( ione, ISEED, n, x.val );
+        for( magma_int_t r=0; r < n; r++ ) {
+            magma_index_t start = M.col[ M.row[r] ], bs = M.row[r+1] - M.row[r];
+            for( magma_index_t e=A.row[r]; e < A.row[r+1]; e++ ) {
+                if ( A.col[e] >= start && A.col[e] < start + bs ) {
+                    y.val[r] = MAGMA_Z_ADD( y.val[r], MAGMA_Z_MUL( A.val[e], x.val[ A.col[e] ] ));
+                }
+            }
+        }
+        TESTING_CHECK( magma_zvbjacobiapply_cpu( y, &z, &zopts.precond_par, queue ));
+        for( magma_int_t k=0; k < n; k++ ) {
+            z.val[k] = MAGMA_Z_SUB( z.val[k], x.val[k] );
+        }
+        dx = magma_cblas_dznrm2( n, z.val, 1 ) / magma_cblas_dznrm2( n, x.val, 1 );
+        magma_int_t nblocks = M.numblocks;
+        magma_zsolverinfo_free( &zopts.solver_par, &zopts.precond_par, queue );
+        magma_zmfree( &x, queue );
+        magma_zmfree( &y, queue );
+        magma_zmfree( &z, queue );
+
+        bool okay = ( blocks && dx <= tol );
+        status += ! okay;
+        printf("%% %lld blocks of whole nodes: %s;  ||M D x - x|| / ||x|| = %.2e   %s\n",
+               (long long) nblocks,
+               (blocks ? "ok" : "wrong"), dx, (okay ? "ok" : "failed"));
+
+        // the solvers set up the preconditioner themselves
+        TESTING_CHECK( magma_zvinit( &b, Magma_CPU, n, 1, MAGMA_Z_ONE, queue ));
+        printf("%% solver      precond    iters   ||b-Ax|| / ||b||\n");
+        printf("%%================================================%%\n");
+        for( int s=0; s < 3; s++ ) {
+            zopts.solver_par.solver = solver[s];
+            zopts.precond_par.solver = precond[s];
+            TESTING_CHECK( magma_zsolverinfo_init( &zopts.solver_par, &zopts.precond_par, queue ));
+            TESTING_CHECK( magma_zvinit( &x, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+            info = magma_z_solver( A, b, &x, &zopts, queue );
+            TESTING_CHECK( magma_zresidual( A, b, x, &res, queue ));
+            res /= magma_cblas_dznrm2( n, b.val, 1 );
+            okay = ( info == 0 && res < 10*zopts.solver_par.rtol );
+            status += ! okay;
+            printf("  %-10s  %-9s  %6lld   %8.2e   %s\n",
+                   solvername[s], precondname[s],
+                   (long long) zopts.solver_par.numiter, res,
+                   (okay ? "ok" : "failed"));
+            magma_zmfree( &x, queue );
+            magma_zsolverinfo_free( &zopts.solver_par, &zopts.precond_par, queue );
+        }
+
+        magma_zmfree( &b, queue );
+        magma_free_cpu( nodestart );
+        magma_zmfree( &A, queue );
+        magma_zmfree( &A0, queue );
+        i++;
+    }
+
+    magma_queue_destroy( queue );
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
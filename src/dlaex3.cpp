@@ -316,8 +316,10 @@ magma_dlaex3(
     // -------------------------------------------------------------------------
     // openmp implementation
     // -------------------------------------------------------------------------
-    //magma_timer_t time = 0;
-    //timer_start( time );
+    magma_timer_t time = 0;
+    magma_counters_t counters;
+    timer_start( time );
+    counters_start( counters );
 
     #pragma omp parallel private(i, j, tmp, temp)
     {
@@ -432,15 +434,18 @@ magma_dlaex3(
     if (*info != 0)
         return *info;
 
-    //timer_stop( time );
-    //timer_printf( "eigenvalues/vector D+zzT = %6.2f\n", time );
+    counters_stop( counters );
+    timer_stop( time );
+    counters_printf( "eigenvalues/vector D+zzT", counters, time );
 
 #else
     // -------------------------------------------------------------------------
     // Non openmp implementation
     // -------------------------------------------------------------------------
-    // magma_timer_t time = 0;
-    // timer_start( time );
+    magma_timer_t time = 0;
+    magma_counters_t counters;
+    timer_start( time );
+    counters_start( counters );
 
     for (i = 0; i < k; ++i)
         dlamda[i] = lapackf77_dlamc3(&dlamda[i], &dlamda[i]) - dlamda[i];
@@ -514,13 +519,15 @@ magma_dlaex3(
         }
     }
 
-    //timer_stop( time );
-    //timer_printf( "eigenvalues/vector D+zzT = %6.2f\n", time );
+    counters_stop( counters );
+    timer_stop( time );
+    counters_printf( "eigenvalues/vector D+zzT", counters, time );
 
 #endif // _OPENMP
     // Compute the updated eigenvectors.
 
-    //timer_start( time );
+    timer_start( time );
+    counters_start( counters );
     //magma_queue_sync( queue );  // previously, needed to setvector finished. Now all on same queue, so not needed?
 
     if (rk != 0) {
@@ -562,8 +569,9 @@ magma_dlaex3(
             lapackf77_dlaset("A", &n1, &rk, &d_zero, &d_zero, Q(0,iil-1), &ldq);
         }
     }
-    //timer_stop( time );
-    //timer_printf( "gemms = %6.2f\n", time );
+    counters_stop( counters );
+    timer_stop( time );
+    counters_printf( "gemms", counters, time );
 
     return *info;
 } /* magma_dlaex3 */
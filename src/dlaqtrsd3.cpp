@@ -0,0 +1,757 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal d -> s
+*/
+#include "magma_internal.h"
+
+// Block size for the diagonal blocks. Blocks are extended by one row
+// where needed so that 2x2 diagonal blocks of T are never split.
+#define NB 64
+
+/***************************************************************************//**
+    Computes a scaling factor s in (0, 1] such that
+        s * (C - A*B)
+    cannot overflow, where anorm, bnorm, cnorm are upper bounds on the
+    infinity-norms of A, B, and C. Same as LAPACK dlarmm.
+*******************************************************************************/
+static double
+dlaqtrsd3_rmm( double anorm, double bnorm, double cnorm )
+{
+    double smlnum = lapackf77_dlamch( "Safe minimum" ) / lapackf77_dlamch( "Precision" );
+    double bignum = (1. / smlnum) / 4.;
+
+    if ( bnorm <= 1. ) {
+        if ( anorm * bnorm > bignum - cnorm ) {
+            return 0.5;
+        }
+    }
+    else {
+        if ( anorm > (bignum - cnorm) / bnorm ) {
+            return 0.5 / bnorm;
+        }
+    }
+    return 1.;
+}
+
+
+/***************************************************************************//**
+    Solves the diagonal block T(ja:jb-1, ja:jb-1) of the quasi-triangular
+    system (T - (wr + i*wi)*I) * x = s*b, or its transpose, in place in
+    rows ja:jb-1 of x. This is the inner loop of dlaqtrsd, restricted to one
+    block. Only rows ja:jb-1 of x are referenced or scaled.
+    x has one column if wi == 0, otherwise two (real and imaginary parts).
+    cnorm(j) is the 1-norm of T(ja:j-1, j).
+
+    @return the scaling factor s applied to rows ja:jb-1 of x.
+*******************************************************************************/
+static double
+dlaqtrsd3_diag(
+    magma_int_t notran, magma_int_t ja, magma_int_t jb,
+    const double *T, magma_int_t ldt,
+    double wr, double wi, double smin, double bignum,
+    double *x, magma_int_t ldx,
+    const double *cnorm )
+{
+#define T(i,j)  (T + (i) + (j)*ldt)
+#define x(i,j)  (x + (i) + (j)*ldx)
+#define W(i,j)  (W + (i) + (j)*2)
+
+    const magma_int_t c_false = false;
+    const magma_int_t c_true  = true;
+    const magma_int_t ione = 1;
+    const magma_int_t itwo = 2;
+    const double c_zero = 0.;
+    const double c_one  = 1.;
+
+    magma_int_t ierr, j, j1, j2, jnxt, len;
+    double beta, rec, s, scale, vcrit, vmax, xnorm, tmp;
+    double W[4];
+
+    magma_int_t cplx = (wi != c_zero);
+    magma_int_t nx   = (cplx ? 2 : 1);
+    magma_int_t nrow = jb - ja;
+
+    s = c_one;
+    if ( notran ) {
+        // Solve upper quasi-triangular system, bottom to top:
+        // [ T(ja:jb-1,ja:jb-1) - (wr + i*wi) ]*x = s*b
+        jnxt = jb-1;
+        for( j=jb-1; j >= ja; --j ) {
+            if ( j > jnxt ) {
+                continue;
+            }
+            j1 = j;
+            j2 = j;
+            jnxt = j - 1;
+            if ( j > ja ) {
+                if ( *T(j,j-1) != c_zero ) {
+                    j1   = j - 1;
+                    jnxt = j - 2;
+                }
+            }
+
+            if ( j1 == j2 ) {
+                // 1-by-1 diagonal block
+                magma_dlaln2(
+                    c_false, ione, nx, smin, c_one,
+                    T(j,j), ldt, c_one, c_one, x(j,0), ldx,
+                    wr, wi, W, itwo, &scale, &xnorm, &ierr );
+
+                // Scale W to avoid overflow when updating
+                // the right-hand side.
+                if ( xnorm > 1. ) {
+                    if ( cnorm[j] > bignum / xnorm ) {
+                        *W(0,0) /= xnorm;
+                        *W(0,1) /= xnorm;
+                        scale   /= xnorm;
+                    }
+                }
+
+                // Scale if necessary
+                if ( scale != 1. ) {
+                    blasf77_dscal( &nrow, &scale, x(ja,0), &ione );
+                    if ( cplx ) {
+                        blasf77_dscal( &nrow, &scale, x(ja,1), &ione );
+                    }
+                    s *= scale;
+                }
+                *x(j,0) = *W(0,0);
+                if ( cplx ) {
+                    *x(j,1) = *W(0,1);
+                }
+
+                // Update right-hand side
+                len = j - ja;
+                tmp = -(*W(0,0));  blasf77_daxpy( &len, &tmp, T(ja,j), &ione, x(ja,0), &ione );
+                if ( cplx ) {
+                    tmp = -(*W(0,1));  blasf77_daxpy( &len, &tmp, T(ja,j), &ione, x(ja,1), &ione );
+                }
+            }
+            else {
+                // 2-by-2 diagonal block
+                magma_dlaln2(
+                    c_false, itwo, nx, smin, c_one,
+                    T(j-1,j-1), ldt, c_one, c_one, x(j-1,0), ldx,
+                    wr, wi, W, itwo, &scale, &xnorm, &ierr );
+
+                // Scale W to avoid overflow when updating
+                // the right-hand side.
+                if ( xnorm > 1. ) {
+                    beta = max( cnorm[j-1], cnorm[j] );
+                    if ( beta > bignum / xnorm ) {
+                        rec = c_one / xnorm;
+                        *W(0,0) *= rec;
+                        *W(0,1) *= rec;
+                        *W(1,0) *= rec;
+                        *W(1,1) *= rec;
+                        scale   *= rec;
+                    }
+                }
+
+                // Scale if necessary
+                if ( scale != 1. ) {
+                    blasf77_dscal( &nrow, &scale, x(ja,0), &ione );
+                    if ( cplx ) {
+                        blasf77_dscal( &nrow, &scale, x(ja,1), &ione );
+                    }
+                    s *= scale;
+                }
+                *x(j-1,0) = *W(0,0);
+                *x(j,  0) = *W(1,0);
+                if ( cplx ) {
+                    *x(j-1,1) = *W(0,1);
+                    *x(j,  1) = *W(1,1);
+                }
+
+                // Update right-hand side
+                len = j - 1 - ja;
+                tmp = -(*W(0,0));  blasf77_daxpy( &len, &tmp, T(ja,j-1), &ione, x(ja,0), &ione );
+                tmp = -(*W(1,0));  blasf77_daxpy( &len, &tmp, T(ja,j  ), &ione, x(ja,0), &ione );
+                if ( cplx ) {
+                    tmp = -(*W(0,1));  blasf77_daxpy( &len, &tmp, T(ja,j-1), &ione, x(ja,1), &ione );
+                    tmp = -(*W(1,1));  blasf77_daxpy( &len, &tmp, T(ja,j  ), &ione, x(ja,1), &ione );
+                }
+            }
+        }
+    }
+    else {
+        // Solve transposed quasi-triangular system, top to bottom:
+        // [ T(ja:jb-1,ja:jb-1) - (wr - i*wi) ]**T * x = s*b
+        vmax = c_one;
+        vcrit = bignum;
+
+        jnxt = ja;
+        for( j=ja; j < jb; ++j ) {
+            if ( j < jnxt ) {
+                continue;
+            }
+            j1 = j;
+            j2 = j;
+            jnxt = j + 1;
+            if ( j < jb-1 ) {
+                if ( *T(j+1,j) != c_zero ) {
+                    j2   = j + 1;
+                    jnxt = j + 2;
+                }
+            }
+
+            // Scale if necessary to avoid overflow when forming
+            // the right-hand side.
+            beta = cnorm[j];
+            if ( j1 != j2 ) {
+                beta = max( cnorm[j], cnorm[j+1] );
+            }
+            if ( beta > vcrit ) {
+                rec = c_one / vmax;
+                blasf77_dscal( &nrow, &rec, x(ja,0), &ione );
+                if ( cplx ) {
+                    blasf77_dscal( &nrow, &rec, x(ja,1), &ione );
+                }
+                s *= rec;
+                vmax = c_one;
+                vcrit = bignum;
+            }
+
+            len = j - ja;
+            *x(j,0) -= magma_cblas_ddot( len, T(ja,j), ione, x(ja,0), ione );
+            if ( cplx ) {
+                *x(j,1) -= magma_cblas_ddot( len, T(ja,j), ione, x(ja,1), ione );
+            }
+            if ( j1 != j2 ) {
+                *x(j+1,0) -= magma_cblas_ddot( len, T(ja,j+1), ione, x(ja,0), ione );
+                if ( cplx ) {
+                    *x(j+1,1) -= magma_cblas_ddot( len, T(ja,j+1), ione, x(ja,1), ione );
+                }
+            }
+
+            // Solve [ T(j1:j2,j1:j2) - (wr - i*wi) ]**T * x = scale*b
+            tmp = -wi;
+            magma_dlaln2(
+                (j1 == j2 ? c_false : c_true), j2-j1+1, nx, smin, c_one,
+                T(j,j), ldt, c_one, c_one, x(j,0), ldx,
+                wr, tmp, W, itwo, &scale, &xnorm, &ierr );
+
+            // Scale if necessary
+            if ( scale != 1. ) {
+                blasf77_dscal( &nrow, &scale, x(ja,0), &ione );
+                if ( cplx ) {
+                    blasf77_dscal( &nrow, &scale, x(ja,1), &ione );
+                }
+                s *= scale;
+            }
+            *x(j,0) = *W(0,0);
+            vmax = max( fabs(*W(0,0)), vmax );
+            if ( cplx ) {
+                *x(j,1) = *W(0,1);
+                vmax = max( fabs(*W(0,1)), vmax );
+            }
+            if ( j1 != j2 ) {
+                *x(j+1,0) = *W(1,0);
+                vmax = max( fabs(*W(1,0)), vmax );
+                if ( cplx ) {
+                    *x(j+1,1) = *W(1,1);
+                    vmax = max( fabs(*W(1,1)), vmax );
+                }
+            }
+            vcrit = bignum / vmax;
+        }
+    }
+    return s;
+
+#undef T
+#undef x
+#undef W
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    DLAQTRSD3 is used by DTREVC3 to solve a panel of the (singular)
+    quasi-triangular systems of DLAQTRSD together,
+        (T - lambda(k)*I)    * x(k) = 0  or
+        (T - lambda(k)*I)**T * x(k) = 0,
+    for k = 0, ..., nv-1, with scaling to prevent overflow. Here T is an
+    upper quasi-triangular matrix with 1x1 or 2x2 diagonal blocks, and the
+    eigenvalue lambda(k) is taken from the diagonal block of T at row kv(k).
+    It does not modify T during the computation.
+
+    This is a blocked, Level 3 BLAS version of DLAQTRSD, following the
+    approach of LAPACK's DLATRS3. The diagonal blocks are solved one
+    eigenvector at a time, keeping a local scaling factor for every block
+    row of every eigenvector; the off-diagonal updates are done for all
+    eigenvectors at once with DGEMM, after rescaling the affected blocks so
+    that the update cannot overflow. The local scaling factors are
+    reconciled at the end. Each eigenvector is equal, up to rounding and
+    a positive scaling, to the one computed by DLAQTRSD.
+
+    If trans = MagmaNoTrans, kv(k) is the last row of the diagonal block of
+    lambda(k), and x(k) is computed as by dlaqtrsd( MagmaNoTrans, kv(k)+1, T, ... ).
+    Rows kv(k)+1:n-1 of x(k) are set to zero.
+
+    If trans = MagmaTrans, kv(k) is the first row of the diagonal block of
+    lambda(k), and x(k) is computed as by dlaqtrsd( MagmaTrans, n-kv(k), T(kv(k),kv(k)), ... ),
+    stored in rows kv(k):n-1. Rows 0:kv(k)-1 of x(k) are set to zero.
+
+    Arguments
+    ---------
+    @param[in]
+    trans   magma_trans_t
+            Specifies the operation applied to T.
+      -     = MagmaNoTrans:    Solve (T - lambda*I)    * x = 0  (No transpose)
+      -     = MagmaTrans:      Solve (T - lambda*I)**T * x = 0  (Transpose)
+
+    @param[in]
+    n       INTEGER
+            The order of the matrix T.  N >= 0.
+
+    @param[in]
+    T       DOUBLE PRECISION array, dimension (LDT,N)
+            The upper quasi-triangular matrix T, in Schur canonical form.
+
+    @param[in]
+    ldt     INTEGER
+            The leading dimension of the array T.  LDT >= max (1,N).
+
+    @param[in]
+    nv      INTEGER
+            The number of eigenvectors to compute.  NV >= 0.
+
+    @param[in]
+    kv      INTEGER array, dimension (NV)
+            The rows of T identifying the eigenvalues, as described above.
+            A complex conjugate pair is listed once.
+
+    @param[out]
+    X       DOUBLE PRECISION array, dimension (LDX,NCOL)
+            On exit, the eigenvectors, stored consecutively in the order of kv:
+            a real eigenvector occupies one column, a complex eigenvector
+            two columns, with the real part in the first and the imaginary
+            part in the second. NCOL is the total number of columns.
+
+    @param[in]
+    ldx     INTEGER
+            The leading dimension of the array X.  LDX >= max(1,N).
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -k, the k-th argument had an illegal value
+
+    @ingroup magma_laqtrsd
+*******************************************************************************/
+extern "C"
+magma_int_t magma_dlaqtrsd3(
+    magma_trans_t trans, magma_int_t n,
+    const double *T, magma_int_t ldt,
+    magma_int_t nv, const magma_int_t *kv,
+    double *X,       magma_int_t ldx,
+    magma_int_t *info)
+{
+#define    T(i_,j_) (T    + (i_) + (j_)*ldt)
+#define    X(i_,j_) (X    + (i_) + (j_)*ldx)
+#define anrm(i_,j_) (anrm + (i_) + (j_)*nba)
+#define  loc(i_,k_) (loc  + (i_) + (k_)*nba)
+#define xblk(i_,k_) (xblk + (i_) + (k_)*4)
+
+    // constants
+    const magma_int_t ione = 1;
+    const double c_zero = 0.;
+    const double c_one  = 1.;
+    const double c_neg_one = -1.;
+
+    // .. Local Scalars ..
+    magma_int_t notran, cplx;
+    magma_int_t c, i, ii, i1, i2, j, j1, j2, ja, jb, k, e1, e2, len, nb, nba, nbamax, ncol, jfirst, jlast, jinc;
+    double bignum, ovfl, s, scal, scaloc, scamin, bnrm, smlnum, ulp, unfl, wr, wi, tmp;
+
+    double *rwork = NULL, *anrm, *loc, *xnrm, *cnorm, *wrk, *wik, *smin, *xblk;
+    magma_int_t *iwork = NULL, *bnd, *col, *lo, *hi, *blk;
+
+    // Decode and test the input parameters
+    notran = (trans == MagmaNoTrans);
+
+    *info = 0;
+    if ( ! notran && trans != MagmaTrans ) {
+        *info = -1;
+    }
+    else if ( n < 0 ) {
+        *info = -2;
+    }
+    else if ( ldt < max(1,n) ) {
+        *info = -4;
+    }
+    else if ( nv < 0 ) {
+        *info = -5;
+    }
+    else if ( ldx < max(1,n) ) {
+        *info = -8;
+    }
+    else {
+        for( k=0; k < nv; ++k ) {
+            if ( kv[k] < 0 || kv[k] >= n ) {
+                *info = -6;
+                break;
+            }
+        }
+    }
+
+    if ( *info != 0 ) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    // Quick return if possible.
+    if ( n == 0 || nv == 0 ) {
+        return *info;
+    }
+
+    nb = min( NB, n );
+    nbamax = magma_ceildiv( n, nb );
+
+    // Workspace:
+    // anrm   nba*nba   norms of the off-diagonal blocks of op(T)
+    // loc    nba*nv    local scaling factors of each block of each eigenvector
+    // xnrm   nv        norms of the current block of each eigenvector
+    // cnorm  n         1-norms of columns within the diagonal blocks
+    // wr, wi, smin, xblk (4 per eigenvector) per-eigenvector data
+    // iwork: block boundaries, and column, active rows, block row per eigenvector
+    if ( MAGMA_SUCCESS != magma_dmalloc_cpu( &rwork, nbamax*nbamax + nbamax*nv + nv + n + 7*nv ) ||
+         MAGMA_SUCCESS != magma_imalloc_cpu( &iwork, nbamax + 1 + 5*nv ))
+    {
+        *info = MAGMA_ERR_HOST_ALLOC;
+        goto cleanup;
+    }
+    anrm  = rwork;
+    loc   = anrm  + nbamax*nbamax;
+    xnrm  = loc   + nbamax*nv;
+    cnorm = xnrm  + nv;
+    wrk   = cnorm + n;
+    wik   = wrk   + nv;
+    smin  = wik   + nv;
+    xblk  = smin  + nv;
+    bnd   = iwork;
+    col   = bnd   + nbamax + 1;
+    lo    = col   + nv;
+    hi    = lo    + nv;
+    blk   = hi    + nv;
+
+    // Set the constants to control overflow.
+    unfl = lapackf77_dlamch( "Safe minimum" );
+    ovfl = 1. / unfl;
+    lapackf77_dlabad( &unfl, &ovfl );
+    ulp = lapackf77_dlamch( "Precision" );
+    smlnum = unfl*( n / ulp );
+    bignum = (1. - ulp) / smlnum;
+
+    // Split T into block rows, without splitting 2x2 diagonal blocks.
+    nba = 0;
+    bnd[0] = 0;
+    while ( bnd[nba] < n ) {
+        j = min( bnd[nba] + nb, n );
+        if ( j < n && *T(j,j-1) != c_zero ) {
+            j += 1;
+        }
+        nba += 1;
+        bnd[nba] = j;
+    }
+
+    // ------------------------------------------------------------
+    // Form the right-hand sides, as in dlaqtrsd.
+    // The values in the eigenvalue's own diagonal block are saved in xblk
+    // and zeroed in X, so only the active rows take part in the solve.
+    ncol = 0;
+    for( k=0; k < nv; ++k ) {
+        if ( notran ) {
+            e2 = kv[k];
+            e1 = e2;
+            if ( e2 > 0 && *T(e2,e2-1) != c_zero ) {
+                e1 = e2 - 1;
+            }
+        }
+        else {
+            e1 = kv[k];
+            e2 = e1;
+            if ( e1 < n-1 && *T(e1+1,e1) != c_zero ) {
+                e2 = e1 + 1;
+            }
+        }
+        cplx = (e1 != e2);
+        wr = *T(e2,e2);
+        wi = c_zero;
+        if ( cplx ) {
+            wi = sqrt( fabs(*T(e2,e1)) ) * sqrt( fabs(*T(e1,e2)) );
+        }
+        c = ncol;
+        col[k] = c;
+        ncol += (cplx ? 2 : 1);
+        wrk[k]  = wr;
+        wik[k]  = wi;
+        smin[k] = max( ulp*(fabs(wr) + fabs(wi)), smlnum );
+        for( i=0; i < 4; ++i ) {
+            *xblk(i,k) = c_zero;
+        }
+
+        // the eigenvalue's own block, in column-major 2x2 xblk(row + 2*re/im)
+        if ( ! cplx ) {
+            *xblk(0,k) = c_one;
+        }
+        else if ( notran ) {
+            if ( fabs(*T(e1,e2)) >= fabs(*T(e2,e1)) ) {
+                *xblk(0,k) = c_one;
+                *xblk(3,k) = wi / *T(e1,e2);
+            }
+            else {
+                *xblk(0,k) = -wi / *T(e2,e1);
+                *xblk(3,k) = c_one;
+            }
+        }
+        else {
+            if ( fabs(*T(e1,e2)) >= fabs(*T(e2,e1)) ) {
+                *xblk(0,k) = wi / *T(e1,e2);
+                *xblk(3,k) = c_one;
+            }
+            else {
+                *xblk(0,k) = c_one;
+                *xblk(3,k) = -wi / *T(e2,e1);
+            }
+        }
+
+        for( i=0; i < n; ++i ) {
+            *X(i,c) = c_zero;
+            if ( cplx ) {
+                *X(i,c+1) = c_zero;
+            }
+        }
+        if ( notran ) {
+            // right-hand side -T(0:e1-1, e1:e2) * xblk
+            lo[k] = 0;
+            hi[k] = e1;
+            for( i=0; i < e1; ++i ) {
+                if ( ! cplx ) {
+                    *X(i,c) = -(*T(i,e2));
+                }
+                else {
+                    *X(i,c  ) = -(*xblk(0,k)) * (*T(i,e1));
+                    *X(i,c+1) = -(*xblk(3,k)) * (*T(i,e2));
+                }
+            }
+        }
+        else {
+            // right-hand side -T(e1:e2, e2+1:n-1)**T * xblk
+            lo[k] = e2 + 1;
+            hi[k] = n;
+            for( i=e2+1; i < n; ++i ) {
+                if ( ! cplx ) {
+                    *X(i,c) = -(*T(e1,i));
+                }
+                else {
+                    *X(i,c  ) = -(*xblk(0,k)) * (*T(e1,i));
+                    *X(i,c+1) = -(*xblk(3,k)) * (*T(e2,i));
+                }
+            }
+        }
+        blk[k] = e1;  // first row of the eigenvalue's block
+    }
+
+    // Compute norms of blocks of op(T) used in the updates.
+    // anrm(i,j) bounds the infinity-norm of the block of op(T)
+    // that updates block row i using block row j.
+    for( j=0; j < nba; ++j ) {
+        j1 = bnd[j];
+        len = bnd[j+1] - j1;
+        for( i=0; i < nba; ++i ) {
+            i1 = bnd[i];
+            ii = bnd[i+1] - i1;
+            *anrm(i,j) = c_zero;
+            if ( notran && i < j ) {
+                *anrm(i,j) = lapackf77_dlange( "I", &ii, &len, T(i1,j1), &ldt, cnorm );
+            }
+            else if ( ! notran && i > j ) {
+                *anrm(i,j) = lapackf77_dlange( "1", &len, &ii, T(j1,i1), &ldt, cnorm );
+            }
+        }
+    }
+    for( k=0; k < nv; ++k ) {
+        for( i=0; i < nba; ++i ) {
+            *loc(i,k) = c_one;
+        }
+    }
+
+    if ( notran ) {
+        jfirst = nba - 1;
+        jlast  = -1;
+        jinc   = -1;
+    }
+    else {
+        jfirst = 0;
+        jlast  = nba;
+        jinc   = 1;
+    }
+
+    for( j = jfirst; j != jlast; j += jinc ) {
+        j1  = bnd[j];
+        j2  = bnd[j+1];
+        len = j2 - j1;
+
+        // 1-norms of columns within the diagonal block
+        for( i=j1; i < j2; ++i ) {
+            cnorm[i] = c_zero;
+            for( ii=j1; ii < i; ++ii ) {
+                cnorm[i] += fabs( *T(ii,i) );
+            }
+        }
+
+        // --------------------
+        // Solve the diagonal block for each eigenvector.
+        for( k=0; k < nv; ++k ) {
+            c  = col[k];
+            ja = max( j1, lo[k] );
+            jb = min( j2, hi[k] );
+            xnrm[k] = c_zero;
+            if ( ja >= jb ) {
+                continue;
+            }
+            ii = jb - ja;
+            cplx = (wik[k] != c_zero);
+
+            scaloc = dlaqtrsd3_diag( notran, ja, jb, T, ldt,
+                                     wrk[k], wik[k], smin[k], bignum,
+                                     X(0,c), ldx, cnorm );
+
+            if ( scaloc * (*loc(j,k)) == c_zero ) {
+                // Valid scaling factor, but combined with the current
+                // scaling it underflows. Set loc(j,k) to the smallest valid
+                // scaling factor and rescale x, if it was overestimated.
+                scal = *loc(j,k) / unfl;
+                scaloc *= scal;
+                *loc(j,k) = unfl;
+                s = c_one / scaloc;
+                blasf77_dscal( &ii, &s, X(ja,c), &ione );
+                if ( cplx ) {
+                    blasf77_dscal( &ii, &s, X(ja,c+1), &ione );
+                }
+                scaloc = c_one;
+            }
+            *loc(j,k) *= scaloc;
+            for( i=ja; i < jb; ++i ) {
+                tmp = fabs( *X(i,c) );
+                if ( cplx ) {
+                    tmp += fabs( *X(i,c+1) );
+                }
+                xnrm[k] = max( xnrm[k], tmp );
+            }
+        }
+
+        // --------------------
+        // Update the remaining block rows with GEMM.
+        for( i = j + jinc; i != jlast; i += jinc ) {
+            i1 = bnd[i];
+            i2 = bnd[i+1];
+            ii = i2 - i1;
+
+            // Rescale X(I,k) and X(J,k) to a consistent scaling
+            // that also survives the update.
+            for( k=0; k < nv; ++k ) {
+                if ( xnrm[k] == c_zero ) {
+                    continue;
+                }
+                c = col[k];
+                cplx = (wik[k] != c_zero);
+                scamin = min( *loc(i,k), *loc(j,k) );
+                bnrm = c_zero;
+                for( ja=i1; ja < i2; ++ja ) {
+                    tmp = fabs( *X(ja,c) );
+                    if ( cplx ) {
+                        tmp += fabs( *X(ja,c+1) );
+                    }
+                    bnrm = max( bnrm, tmp );
+                }
+                bnrm    *= scamin / *loc(i,k);
+                xnrm[k] *= scamin / *loc(j,k);
+                scaloc = dlaqtrsd3_rmm( *anrm(i,j), xnrm[k], bnrm );
+                if ( scaloc * scamin == c_zero ) {
+                    // Cannot happen with smin > 0, but guard against
+                    // flushing x to zero: keep the smallest scaling.
+                    scaloc = unfl / scamin;
+                }
+                scal = (scamin / *loc(i,k)) * scaloc;
+                if ( scal != c_one ) {
+                    blasf77_dscal( &ii, &scal, X(i1,c), &ione );
+                    if ( cplx ) {
+                        blasf77_dscal( &ii, &scal, X(i1,c+1), &ione );
+                    }
+                    *loc(i,k) = scamin * scaloc;
+                }
+                scal = (scamin / *loc(j,k)) * scaloc;
+                if ( scal != c_one ) {
+                    blasf77_dscal( &len, &scal, X(j1,c), &ione );
+                    if ( cplx ) {
+                        blasf77_dscal( &len, &scal, X(j1,c+1), &ione );
+                    }
+                    *loc(j,k) = scamin * scaloc;
+                }
+                xnrm[k] *= scaloc;
+            }
+
+            if ( notran ) {
+                blasf77_dgemm( "N", "N", &ii, &ncol, &len,
+                               &c_neg_one, T(i1,j1), &ldt,
+                                           X(j1,0),  &ldx,
+                               &c_one,     X(i1,0),  &ldx );
+            }
+            else {
+                blasf77_dgemm( "T", "N", &ii, &ncol, &len,
+                               &c_neg_one, T(j1,i1), &ldt,
+                                           X(j1,0),  &ldx,
+                               &c_one,     X(i1,0),  &ldx );
+            }
+        }
+    }
+
+    // Reconcile the local scaling factors, so each eigenvector has a
+    // single scaling factor, and restore the eigenvalue's own block.
+    for( k=0; k < nv; ++k ) {
+        c = col[k];
+        cplx = (wik[k] != c_zero);
+        s = c_one;
+        for( i=0; i < nba; ++i ) {
+            s = min( s, *loc(i,k) );
+        }
+        for( i=0; i < nba; ++i ) {
+            i1 = bnd[i];
+            ii = bnd[i+1] - i1;
+            scal = s / *loc(i,k);
+            if ( scal != c_one ) {
+                blasf77_dscal( &ii, &scal, X(i1,c), &ione );
+                if ( cplx ) {
+                    blasf77_dscal( &ii, &scal, X(i1,c+1), &ione );
+                }
+            }
+        }
+        e1 = blk[k];
+        *X(e1,c) = s * (*xblk(0,k));
+        if ( cplx ) {
+            *X(e1+1,c  ) = s * (*xblk(1,k));
+            *X(e1,  c+1) = s * (*xblk(2,k));
+            *X(e1+1,c+1) = s * (*xblk(3,k));
+        }
+    }
+
+cleanup:
+    magma_free_cpu( rwork );
+    magma_free_cpu( iwork );
+
+    return *info;
+
+#undef T
+#undef X
+#undef anrm
+#undef loc
+#undef xblk
+} /* end dlaqtrsd3 */
@@ -151,12 +151,17 @@
     info     INTEGER
        -     = 0:  successful exit
        -     < 0:  if info = -i, the i-th argument had an illegal value
+       -     otherwise, the nonzero info from magma_dlaqtrsd3 in the blocked
+                   back-transform
 
     Further Details
     ---------------
     The algorithm used in this program is basically backward (forward)
     substitution, with scaling to make the the code robust against
     possible overflow.
+    When back-transforming with the blocked version, the quasi-triangular
+    systems for a block of nb eigenvectors are solved together by
+    magma_dlaqtrsd3, using Level 3 BLAS, instead of one at a time.
 
     Each eigenvector is normalized so that the element of largest
     magnitude has magnitude 1; here the magnitude of a complex number
@@ -192,14 +197,18 @@ magma_int_t magma_dtrevc3(
     const magma_int_t nbmin = 16, nbmax = 256;
 
     // .. Local Scalars ..
-    magma_int_t allv, bothv, leftv, over, pair, rightv, somev;
+    magma_int_t allv, bothv, leftv, blocked, over, pair, rightv, somev;
     magma_int_t i, ierr, ii, ip, is, j, k, ki, ki2,
-                iv, n2, nb, nb2, version;
+                iv, kmin, n2, nb, nb2, nv, version;
     double emax, remax;
     
     // .. Local Arrays ..
     // since iv is a 1-based index, allocate one extra here
     magma_int_t iscomplex[ nbmax+1 ];
+    // kvec stores ki for the first column of each eigenvector in current block;
+    // kv is the compacted list passed to dlaqtrsd3.
+    magma_int_t kvec[ nbmax+1 ];
+    magma_int_t kv[ nbmax+1 ];
 
     // Decode and test the input parameters
     bothv  = (side == MagmaBothSides);
@@ -290,6 +299,9 @@ magma_int_t magma_dtrevc3(
     else {
         version = 1;
     }
+    // The blocked back-transform solves the quasi-triangular systems of a
+    // block of vectors together with dlaqtrsd3, when the GEMM is done.
+    blocked = (over && version == 2);
 
     // Compute 1-norm of each column of strictly upper triangular
     // part of T to control overflow in triangular solver.
@@ -363,8 +375,10 @@ magma_int_t magma_dtrevc3(
                 // Real right eigenvector
                 // Solve upper quasi-triangular system:
                 // [ T(0:ki-1,0:ki-1) - wr ]*X = -T(0:ki-1,ki)
-                magma_dlaqtrsd( MagmaNoTrans, ki+1, T(0,0), ldt,
-                                work(0,iv), n, work(0,0), &ierr );
+                if ( ! blocked ) {
+                    magma_dlaqtrsd( MagmaNoTrans, ki+1, T(0,0), ldt,
+                                    work(0,iv), n, work(0,0), &ierr );
+                }
                 
                 // Copy the vector x or Q*x to VR and normalize.
                 if ( ! over ) {
@@ -407,7 +421,8 @@ magma_int_t magma_dtrevc3(
                         *work(k,iv) = c_zero;
                     }
                     iscomplex[ iv ] = ip;
-                    // back-transform and normalization is done below
+                    kvec[ iv ] = ki;
+                    // solve, back-transform and normalization is done below
                 }
             }  // end real eigenvector
             else {
@@ -415,8 +430,10 @@ magma_int_t magma_dtrevc3(
                 // Complex right eigenvector
                 // Solve upper quasi-triangular system:
                 // [ T(0:ki-2,0:ki-2) - (wr+i*wi) ]*x = u
-                magma_dlaqtrsd( MagmaNoTrans, ki+1, T(0,0), ldt,
-                                work(0,iv-1), n, work(0,0), &ierr );
+                if ( ! blocked ) {
+                    magma_dlaqtrsd( MagmaNoTrans, ki+1, T(0,0), ldt,
+                                    work(0,iv-1), n, work(0,0), &ierr );
+                }
 
                 // Copy the vector x or Q*x to VR and normalize.
                 if ( ! over ) {
@@ -481,7 +498,8 @@ magma_int_t magma_dtrevc3(
                     iscomplex[ iv-1 ] = -ip;
                     iscomplex[ iv   ] =  ip;
                     iv -= 1;
-                    // back-transform and normalization is done below
+                    kvec[ iv ] = ki;
+                    // solve, back-transform and normalization is done below
                 }
             }  // end real or complex vector
 
@@ -500,6 +518,22 @@ magma_int_t magma_dtrevc3(
                 // When the number of vectors stored reaches nb-1 or nb,
                 // or if this was last vector, do the GEMM
                 if ( (iv <= 2) || (ki2 == 0) ) {
+                    if ( blocked ) {
+                        // Solve the quasi-triangular systems for columns iv:nb.
+                        nv = 0;
+                        for( k=iv; k <= nb; ++k ) {
+                            if ( iscomplex[k] != -1 ) {
+                                kv[ nv++ ] = kvec[k];
+                            }
+                        }
+                        n2 = ki2+nb-iv+1;
+                        magma_dlaqtrsd3( MagmaNoTrans, n2, T(0,0), ldt,
+                                         nv, kv, work(0,iv), n, &ierr );
+                        if ( ierr != 0 ) {
+                            *info = ierr;
+                            return *info;
+                        }
+                    }
                     time_trsv_sum += timer_stop( time_trsv );
                     timer_start( time_gemm );
                     nb2 = nb-iv+1;
@@ -599,8 +633,10 @@ magma_int_t magma_dtrevc3(
                 // Real left eigenvector
                 // Solve transposed quasi-triangular system:
                 // [ T(ki+1:n,ki+1:n) - wr ]**T * X = -T(ki+1:n,ki)
-                magma_dlaqtrsd( MagmaTrans, n-ki, T(ki,ki), ldt,
-                                work(ki,iv), n, work(ki,0), &ierr );
+                if ( ! blocked ) {
+                    magma_dlaqtrsd( MagmaTrans, n-ki, T(ki,ki), ldt,
+                                    work(ki,iv), n, work(ki,0), &ierr );
+                }
 
                 // Copy the vector x or Q*x to VL and normalize.
                 if ( ! over ) {
@@ -640,7 +676,8 @@ magma_int_t magma_dtrevc3(
                         *work(k,iv) = c_zero;
                     }
                     iscomplex[ iv ] = ip;
-                    // back-transform and normalization is done below
+                    kvec[ iv ] = ki;
+                    // solve, back-transform and normalization is done below
                 }
             }  // end real eigenvector
             else {
@@ -648,8 +685,10 @@ magma_int_t magma_dtrevc3(
                 // Complex left eigenvector
                 // Solve transposed quasi-triangular system:
                 // [ T(ki+2:n,ki+2:n)**T - (wr-i*wi) ]*X = V
-                magma_dlaqtrsd( MagmaTrans, n-ki, T(ki,ki), ldt,
-                                work(ki,iv), n, work(ki,0), &ierr );
+                if ( ! blocked ) {
+                    magma_dlaqtrsd( MagmaTrans, n-ki, T(ki,ki), ldt,
+                                    work(ki,iv), n, work(ki,0), &ierr );
+                }
 
                 // Copy the vector x or Q*x to VL and normalize.
                 if ( ! over ) {
@@ -710,8 +749,9 @@ magma_int_t magma_dtrevc3(
                     }
                     iscomplex[ iv   ] =  ip;
                     iscomplex[ iv+1 ] = -ip;
+                    kvec[ iv ] = ki;
                     iv += 1;
-                    // back-transform and normalization is done below
+                    // solve, back-transform and normalization is done below
                 }
             }  // end real or complex eigenvector
 
@@ -730,6 +770,24 @@ magma_int_t magma_dtrevc3(
                 // When the number of vectors stored reaches nb-1 or nb,
                 // or if this was last vector, do the GEMM
                 if ( (iv >= nb-1) || (ki2 == n-1) ) {
+                    if ( blocked ) {
+                        // Solve the quasi-triangular systems for columns 1:iv,
+                        // on the trailing matrix T(kmin:n, kmin:n).
+                        kmin = ki2-iv+1;
+                        nv = 0;
+                        for( k=1; k <= iv; ++k ) {
+                            if ( iscomplex[k] != -1 ) {
+                                kv[ nv++ ] = kvec[k] - kmin;
+                            }
+                        }
+                        n2 = n-kmin;
+                        magma_dlaqtrsd3( MagmaTrans, n2, T(kmin,kmin), ldt,
+                                         nv, kv, work(kmin,1), n, &ierr );
+                        if ( ierr != 0 ) {
+                            *info = ierr;
+                            return *info;
+                        }
+                    }
                     n2 = n-(ki2+1)+iv;
                     blasf77_dgemm( "n", "n", &n, &iv, &n2, &c_one,
                                    VL(0,ki2-iv+1), &ldvl,
@@ -12,6 +12,7 @@
        @precisions normal z -> s d c
 
  */
+#include "thread_pool.hpp"
 #include "magma_internal.h"
 #include "magma_bulge.h"
 #include "magma_zbulge.h"
@@ -45,7 +46,7 @@ typedef struct magma_zapplyQ_data_s {
     magma_int_t ldt;
     magmaDoubleComplex* dE;
     magma_int_t ldde;
-    pthread_barrier_t barrier;
+    magma_barrier* barrier;
 } magma_zapplyQ_data;
 
 
@@ -58,7 +59,8 @@ void magma_zapplyQ_data_init(
     magmaDoubleComplex *V, magma_int_t ldv,
     magmaDoubleComplex *TAU,
     magmaDoubleComplex *T, magma_int_t ldt,
-    magmaDoubleComplex *dE, magma_int_t ldde)
+    magmaDoubleComplex *dE, magma_int_t ldde,
+    magma_barrier* barrier)
 {
     zapplyQ_data->threads_num = threads_num;
     zapplyQ_data->n = n;
@@ -75,21 +77,7 @@ void magma_zapplyQ_data_init(
     zapplyQ_data->ldt = ldt;
     zapplyQ_data->dE = dE;
     zapplyQ_data->ldde = ldde;
-
-    magma_int_t count = zapplyQ_data->threads_num;
-
-    if (zapplyQ_data->threads_num > 1)
-        --count;
-
-    pthread_barrier_init(&(zapplyQ_data->barrier), NULL, (unsigned)count);
-}
-
-
-/******************************************************************************/
-void magma_zapplyQ_data_destroy(
-    magma_zapplyQ_data *zapplyQ_data)
-{
-    pthread_barrier_destroy(&(zapplyQ_data->barrier));
+    zapplyQ_data->barrier = barrier;
 }
 
 
@@ -172,42 +160,28 @@ magma_zbulge_back(
         #ifdef ENABLE_DEBUG
         printf("---> calling GPU + CPU(if N_CPU > 0) to apply V2 to Z with NE %lld     N_GPU %lld   N_CPU %lld\n",ne, n_gpu, ne-n_gpu);
         #endif
+        // ===============================
+        // borrow threads from the persistent pool to apply Q
+        // ===============================
+        magma_thread_pool* pool = magma_thread_pool::get();
+        threads = pool->begin( threads );
+        // threads 1:threads-1 barrier; thread 0 does the GPU part
+        magma_barrier* barrier = pool->barrier( threads > 1 ? threads-1 : 1 );
+
         magma_zapplyQ_data data_applyQ;
-        magma_zapplyQ_data_init(&data_applyQ, threads, n, ne, n_gpu, nb, Vblksiz, Z, ldz, V, ldv, TAU, T, ldt, dZ, lddz);
+        magma_zapplyQ_data_init(&data_applyQ, threads, n, ne, n_gpu, nb, Vblksiz, Z, ldz, V, ldv, TAU, T, ldt, dZ, lddz, barrier);
 
         magma_zapplyQ_id_data* arg;
         magma_malloc_cpu((void**) &arg, threads*sizeof(magma_zapplyQ_id_data));
 
-        pthread_t* thread_id;
-        magma_malloc_cpu((void**) &thread_id, threads*sizeof(pthread_t));
-
-        pthread_attr_t thread_attr;
-
-        // ===============================
-        // relaunch thread to apply Q
-        // ===============================
-        // Set one thread per core
-        pthread_attr_init(&thread_attr);
-        pthread_attr_setscope(&thread_attr, PTHREAD_SCOPE_SYSTEM);
-        pthread_setconcurrency( (unsigned)threads );
-
-        // Launch threads
-        for (magma_int_t thread = 1; thread < threads; thread++) {
+        // Run on pool threads 1, ..., threads-1 and this thread as 0
+        for (magma_int_t thread = 0; thread < threads; thread++) {
             magma_zapplyQ_id_data_init(&(arg[thread]), thread, &data_applyQ);
-            pthread_create(&thread_id[thread], &thread_attr, magma_zapplyQ_parallel_section, &arg[thread]);
         }
-        magma_zapplyQ_id_data_init(&(arg[0]), 0, &data_applyQ);
-        magma_zapplyQ_parallel_section(&arg[0]);
+        pool->run( magma_zapplyQ_parallel_section, arg, sizeof(magma_zapplyQ_id_data) );
+        pool->end();
 
-        // Wait for completion
-        for (magma_int_t thread = 1; thread < threads; thread++) {
-            void *exitcodep;
-            pthread_join(thread_id[thread], &exitcodep);
-        }
-
-        magma_free_cpu(thread_id);
         magma_free_cpu(arg);
-        magma_zapplyQ_data_destroy(&data_applyQ);
 
 
         magma_zsetmatrix( n, ne-n_gpu, Z + n_gpu*ldz, ldz, dZ + n_gpu*ldz, lddz, queue );
@@ -249,7 +223,7 @@ static void *magma_zapplyQ_parallel_section(void *arg)
     magma_int_t ldt            = data -> ldt;
     magmaDoubleComplex *dE     = data -> dE;
     magma_int_t ldde           = data -> ldde;
-    pthread_barrier_t* barrier = &(data -> barrier);
+    magma_barrier* barrier     = data -> barrier;
 
     magma_int_t info;
 
@@ -271,14 +245,17 @@ static void *magma_zapplyQ_parallel_section(void *arg)
 #endif
     cpu_set_t old_set, new_set;
 
-    //store current affinity
-    CPU_ZERO(&old_set);
-    sched_getaffinity( 0, sizeof(old_set), &old_set);
-    //set new affinity
-    // bind threads
-    CPU_ZERO(&new_set);
-    CPU_SET(my_core_id, &new_set);
-    sched_setaffinity( 0, sizeof(new_set), &new_set);
+    // bind the calling thread (id 0);
+    // pool workers were bound once, when created
+    if (my_core_id == 0) {
+        //store current affinity
+        CPU_ZERO(&old_set);
+        sched_getaffinity( 0, sizeof(old_set), &old_set);
+        //set new affinity
+        CPU_ZERO(&new_set);
+        CPU_SET(my_core_id, &new_set);
+        sched_setaffinity( 0, sizeof(new_set), &new_set);
+    }
 #ifdef PRINTAFFINITY
     print_set.print_affinity(my_core_id, "set affinity");
 #endif
@@ -321,7 +298,7 @@ static void *magma_zapplyQ_parallel_section(void *arg)
         n_loc = min(n_loc,n_cpu - n_loc * (my_core_id-1));
 
         magma_ztile_bulge_applyQ(my_core_id, MagmaLeft, n_loc, n, nb, Vblksiz, E_loc, lde, V, ldv, TAU, T, ldt);
-        pthread_barrier_wait(barrier);
+        barrier->wait();
 
         #ifdef ENABLE_TIMER
         if (my_core_id == 1) {
@@ -333,7 +310,9 @@ static void *magma_zapplyQ_parallel_section(void *arg)
 
 #ifndef MAGMA_NOAFFINITY
     //restore old affinity
-    sched_setaffinity(0, sizeof(old_set), &old_set);
+    if (my_core_id == 0) {
+        sched_setaffinity(0, sizeof(old_set), &old_set);
+    }
 #ifdef PRINTAFFINITY
     print_set.print_affinity(my_core_id, "restored_affinity");
 #endif
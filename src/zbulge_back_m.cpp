@@ -12,6 +12,7 @@
        @precisions normal z -> s d c
 
  */
+#include "thread_pool.hpp"
 #include "magma_internal.h"
 #include "magma_bulge.h"
 #include "magma_zbulge.h"
@@ -44,7 +45,8 @@ public:
                          magmaDoubleComplex *E_, magma_int_t lde_,
                          magmaDoubleComplex *V_, magma_int_t ldv_,
                          magmaDoubleComplex *TAU_,
-                         magmaDoubleComplex *T_, magma_int_t ldt_)
+                         magmaDoubleComplex *T_, magma_int_t ldt_,
+                         magma_barrier* barrier_)
     :
     ngpu(ngpu_),
     threads_num(threads_num_),
@@ -59,20 +61,10 @@ public:
     ldv(ldv_),
     TAU(TAU_),
     T(T_),
-    ldt(ldt_)
-    {
-        magma_int_t count = threads_num;
-
-        if (threads_num > 1)
-            --count;
-
-        pthread_barrier_init(&barrier, NULL, (unsigned)count);
-    }
+    ldt(ldt_),
+    barrier(barrier_)
+    {}
 
-    ~magma_zapplyQ_m_data()
-    {
-        pthread_barrier_destroy(&barrier);
-    }
     const magma_int_t ngpu;
     const magma_int_t threads_num;
     const magma_int_t n;
@@ -87,7 +79,7 @@ public:
     magmaDoubleComplex* const TAU;
     magmaDoubleComplex* const T;
     const magma_int_t ldt;
-    pthread_barrier_t barrier;
+    magma_barrier* const barrier;
 
 private:
 
@@ -165,39 +157,26 @@ magma_zbulge_back_m(
         #ifdef ENABLE_DEBUG
         printf("---> calling GPU + CPU(if N_CPU > 0) to apply V2 to Z with NE %lld     N_GPU %lld   N_CPU %lld\n",ne, n_gpu, ne-n_gpu);
         #endif
-        magma_zapplyQ_m_data data_applyQ(ngpu, threads, n, ne, n_gpu, nb, Vblksiz, Z, ldz, V, ldv, TAU, T, ldt);
+        // ===============================
+        // borrow threads from the persistent pool to apply Q
+        // ===============================
+        magma_thread_pool* pool = magma_thread_pool::get();
+        threads = pool->begin( threads );
+        // threads 1:threads-1 barrier; thread 0 does the GPU part
+        magma_barrier* barrier = pool->barrier( threads > 1 ? threads-1 : 1 );
+
+        magma_zapplyQ_m_data data_applyQ(ngpu, threads, n, ne, n_gpu, nb, Vblksiz, Z, ldz, V, ldv, TAU, T, ldt, barrier);
 
         magma_zapplyQ_m_id_data* arg;
         magma_malloc_cpu((void**) &arg, threads*sizeof(magma_zapplyQ_m_id_data));
 
-        pthread_t* thread_id;
-        magma_malloc_cpu((void**) &thread_id, threads*sizeof(pthread_t));
-
-        pthread_attr_t thread_attr;
-
-        // ===============================
-        // relaunch thread to apply Q
-        // ===============================
-        // Set one thread per core
-        pthread_attr_init(&thread_attr);
-        pthread_attr_setscope(&thread_attr, PTHREAD_SCOPE_SYSTEM);
-        pthread_setconcurrency( (unsigned)threads );
-
-        // Launch threads
-        for (magma_int_t thread = 1; thread < threads; thread++) {
+        // Run on pool threads 1, ..., threads-1 and this thread as 0
+        for (magma_int_t thread = 0; thread < threads; thread++) {
             arg[thread] = magma_zapplyQ_m_id_data(thread, &data_applyQ);
-            pthread_create(&thread_id[thread], &thread_attr, magma_zapplyQ_m_parallel_section, &arg[thread]);
         }
-        arg[0] = magma_zapplyQ_m_id_data(0, &data_applyQ);
-        magma_zapplyQ_m_parallel_section(&arg[0]);
+        pool->run( magma_zapplyQ_m_parallel_section, arg, sizeof(magma_zapplyQ_m_id_data) );
+        pool->end();
 
-        // Wait for completion
-        for (magma_int_t thread = 1; thread < threads; thread++) {
-            void *exitcodep;
-            pthread_join(thread_id[thread], &exitcodep);
-        }
-
-        magma_free_cpu(thread_id);
         magma_free_cpu(arg);
 
         /*============================
@@ -234,7 +213,7 @@ static void *magma_zapplyQ_m_parallel_section(void *arg)
     magmaDoubleComplex *TAU       = data -> TAU;
     magmaDoubleComplex *T         = data -> T;
     magma_int_t ldt            = data -> ldt;
-    pthread_barrier_t* barrier = &(data -> barrier);
+    magma_barrier* barrier     = data -> barrier;
 
     magma_int_t info;
 
@@ -256,17 +235,19 @@ static void *magma_zapplyQ_m_parallel_section(void *arg)
 #endif
     affinity_set original_set;
     affinity_set new_set(my_core_id);
-    magma_int_t check  = 0;
+    magma_int_t check  = -1;
     magma_int_t check2 = 0;
-    // bind threads
-    check = original_set.get_affinity();
-    if (check == 0) {
-        check2 = new_set.set_affinity();
-        if (check2 != 0)
-            printf("Error in sched_setaffinity (single cpu)\n");
-    }
-    else {
-        printf("Error in sched_getaffinity\n");
+    // bind the calling thread; pool workers were bound once, when created
+    if (my_core_id == 0) {
+        check = original_set.get_affinity();
+        if (check == 0) {
+            check2 = new_set.set_affinity();
+            if (check2 != 0)
+                printf("Error in sched_setaffinity (single cpu)\n");
+        }
+        else {
+            printf("Error in sched_getaffinity\n");
+        }
     }
 #ifdef PRINTAFFINITY
     print_set.print_affinity(my_core_id, "set affinity");
@@ -303,7 +284,7 @@ static void *magma_zapplyQ_m_parallel_section(void *arg)
         n_loc = min(n_loc,n_cpu - n_loc * (my_core_id-1));
 
         magma_ztile_bulge_applyQ(my_core_id, MagmaLeft, n_loc, n, nb, Vblksiz, E_loc, lde, V, ldv, TAU, T, ldt);
-        pthread_barrier_wait(barrier);
+        barrier->wait();
 
         #ifdef ENABLE_TIMER
         if (my_core_id == 1) {
@@ -314,7 +295,7 @@ static void *magma_zapplyQ_m_parallel_section(void *arg)
     } // END if my_core_id
 
 #ifndef MAGMA_NOAFFINITY
-    // unbind threads
+    // unbind the calling thread
     if (check == 0) {
         check2 = original_set.set_affinity();
         if (check2 != 0)
@@ -0,0 +1,262 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions mixed zc -> ds
+
+*/
+#include "magma_internal.h"
+
+/******************************************************************************/
+// y = M^{-1} x, where M is the single precision LU (ipiv != NULL) or
+// Cholesky (ipiv == NULL) factorization of op(A). x and y may be the same.
+// The vectors are scaled to unit norm by the caller, so converting
+// them to single precision cannot overflow.
+static void
+magma_zcprecond_cpu(
+    magma_trans_t trans, magma_uplo_t uplo, magma_int_t n,
+    const magmaFloatComplex *SA, magma_int_t ldsa, const magma_int_t *ipiv,
+    const magmaDoubleComplex *x, magmaDoubleComplex *y,
+    magmaFloatComplex *sx )
+{
+    const magma_int_t ione = 1;
+    magma_int_t info;
+
+    lapackf77_zlag2c( &n, &ione, x, &n, sx, &n, &info );
+    if (ipiv != NULL) {
+        lapackf77_cgetrs( lapack_trans_const(trans), &n, &ione, SA, &ldsa, ipiv, sx, &n, &info );
+    }
+    else {
+        lapackf77_cpotrs( lapack_uplo_const(uplo), &n, &ione, SA, &ldsa, sx, &n, &info );
+    }
+    lapackf77_clag2z( &n, &ione, sx, &n, y, &n, &info );
+}
+
+
+/******************************************************************************/
+// y = alpha*op(A)*x + beta*y, with A general (ipiv != NULL) or Hermitian.
+static void
+magma_zcmatvec_cpu(
+    magma_trans_t trans, magma_uplo_t uplo, magma_int_t n,
+    magmaDoubleComplex alpha,
+    const magmaDoubleComplex *A, magma_int_t lda, const magma_int_t *ipiv,
+    const magmaDoubleComplex *x,
+    magmaDoubleComplex beta, magmaDoubleComplex *y )
+{
+    const magma_int_t ione = 1;
+    if (ipiv != NULL) {
+        blasf77_zgemv( lapack_trans_const(trans), &n, &n,
+                       &alpha, A, &lda, x, &ione, &beta, y, &ione );
+    }
+    else {
+        blasf77_zhemv( lapack_uplo_const(uplo), &n,
+                       &alpha, A, &lda, x, &ione, &beta, y, &ione );
+    }
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZCFGMRES_CPU solves op(A) * x = b in complex DOUBLE PRECISION with
+    restarted GMRES, right-preconditioned by a complex SINGLE PRECISION
+    factorization of A. It is the correction solver of the GMRES-based
+    iterative refinement (GMRES-IR) in magma_zcgesv and magma_zcposv, which
+    converges for matrices that are too ill-conditioned for classical
+    iterative refinement with the same factorization.
+
+    Arguments
+    ---------
+    @param[in]
+    trans   magma_trans_t
+            The form of the system, op(A) = A, A**T, or A**H.
+            Only MagmaNoTrans is allowed if A is Hermitian (IPIV = NULL).
+
+    @param[in]
+    uplo    magma_uplo_t
+            If A is Hermitian (IPIV = NULL), which triangle of A and SA is
+            stored. Otherwise not referenced.
+
+    @param[in]
+    n       INTEGER
+            The order of the matrix A.  N >= 0.
+
+    @param[in]
+    A       COMPLEX_16 array, dimension (LDA,N)
+            The N-by-N matrix A, general or Hermitian.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of the array A.  LDA >= max(1,N).
+
+    @param[in]
+    SA      COMPLEX array, dimension (LDSA,N)
+            The single precision LU factors (if IPIV != NULL), or Cholesky
+            factor (if IPIV = NULL), of A.
+
+    @param[in]
+    ldsa    INTEGER
+            The leading dimension of the array SA.  LDSA >= max(1,N).
+
+    @param[in]
+    ipiv    INTEGER array, dimension (N), or NULL.
+            The pivot indices of the LU factorization; NULL if A is Hermitian
+            positive definite and SA is its Cholesky factor.
+
+    @param[in]
+    b       COMPLEX_16 array, dimension (N)
+            The right hand side.
+
+    @param[in,out]
+    x       COMPLEX_16 array, dimension (N)
+            On entry, the initial guess. On exit, the solution.
+
+    @param[in]
+    maxiter INTEGER
+            Maximum total number of GMRES iterations.
+
+    @param[in]
+    restrt  INTEGER
+            Krylov subspace dimension before restarting.  1 <= RESTRT <= N.
+
+    @param[in]
+    tol     DOUBLE PRECISION
+            Stop when ||b - op(A)*x||_2 <= tol * ||b - op(A)*x0||_2.
+
+    @param[out]
+    niter   INTEGER
+            The number of GMRES iterations performed.
+
+    @return
+      -     = 0:  converged to the requested tolerance
+      -     = 1:  did not converge in MAXITER iterations
+      -     < 0:  MAGMA_ERR_HOST_ALLOC if workspace allocation failed
+
+    @ingroup magma_gesv
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zcfgmres_cpu(
+    magma_trans_t trans, magma_uplo_t uplo, magma_int_t n,
+    const magmaDoubleComplex *A, magma_int_t lda,
+    const magmaFloatComplex *SA, magma_int_t ldsa, const magma_int_t *ipiv,
+    const magmaDoubleComplex *b, magmaDoubleComplex *x,
+    magma_int_t maxiter, magma_int_t restrt, double tol,
+    magma_int_t *niter )
+{
+    #define V(i_)    (V + (i_)*n)
+    #define H(i_,j_) (H + (i_) + (j_)*ldh)
+
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_zero    = MAGMA_Z_ZERO;
+    const magma_int_t ione = 1;
+
+    magmaDoubleComplex *V, *H, *w, *g, *sn, *h2, alpha;
+    magmaFloatComplex *sx;
+    double *cs, beta, beta0, scal, work[1];
+    magma_int_t i, j, k, ldh, info = 1;
+
+    *niter = 0;
+    if (n == 0) {
+        return 0;
+    }
+    restrt = max( 1, min( restrt, n ));
+    ldh = restrt + 1;
+
+    V = NULL;  H = NULL;  cs = NULL;  sx = NULL;
+    if (MAGMA_SUCCESS != magma_zmalloc_cpu( &V,  n*(restrt + 2) + ldh*(restrt + 3) + restrt ) ||
+        MAGMA_SUCCESS != magma_dmalloc_cpu( &cs, restrt ) ||
+        MAGMA_SUCCESS != magma_cmalloc_cpu( &sx, n ))
+    {
+        info = MAGMA_ERR_HOST_ALLOC;
+        goto cleanup;
+    }
+    w  = V + n*(restrt + 1);  // preconditioned vector, length n
+    H  = w + n;               // Hessenberg matrix, ldh-by-restrt
+    g  = H + ldh*restrt;      // rotated rhs of least squares problem, length ldh
+    sn = g + ldh;             // Givens sines, length restrt
+    h2 = sn + restrt;         // reorthogonalization coefficients, length ldh
+
+    beta0 = -1;
+    while (true) {
+        // V(0) = b - op(A)*x
+        blasf77_zcopy( &n, b, &ione, V(0), &ione );
+        magma_zcmatvec_cpu( trans, uplo, n, c_neg_one, A, lda, ipiv, x, c_one, V(0) );
+        beta = lapackf77_zlange( "F", &n, &ione, V(0), &n, work );
+        if (beta0 < 0) {
+            beta0 = beta;
+        }
+        if (beta <= tol*beta0 || beta == 0) {
+            info = 0;
+            break;
+        }
+        if (*niter >= maxiter) {
+            break;
+        }
+        alpha = MAGMA_Z_MAKE( 1. / beta, 0. );
+        blasf77_zscal( &n, &alpha, V(0), &ione );
+        g[0] = MAGMA_Z_MAKE( beta, 0. );
+
+        // Arnoldi with classical Gram-Schmidt, reorthogonalized once (CGS2)
+        for (i = 0; i < restrt && *niter < maxiter; ++i) {
+            *niter += 1;
+            magma_zcprecond_cpu( trans, uplo, n, SA, ldsa, ipiv, V(i), w, sx );
+            magma_zcmatvec_cpu( trans, uplo, n, c_one, A, lda, ipiv, w, c_zero, V(i+1) );
+            j = i + 1;
+            blasf77_zgemv( "ConjTrans", &n, &j, &c_one,     V,     &n, V(i+1), &ione, &c_zero, H(0,i), &ione );
+            blasf77_zgemv( "NoTrans",   &n, &j, &c_neg_one, V,     &n, H(0,i), &ione, &c_one,  V(i+1), &ione );
+            blasf77_zgemv( "ConjTrans", &n, &j, &c_one,     V,     &n, V(i+1), &ione, &c_zero, h2,     &ione );
+            blasf77_zgemv( "NoTrans",   &n, &j, &c_neg_one, V,     &n, h2,     &ione, &c_one,  V(i+1), &ione );
+            blasf77_zaxpy( &j, &c_one, h2, &ione, H(0,i), &ione );
+            scal = lapackf77_zlange( "F", &n, &ione, V(i+1), &n, work );
+            *H(i+1,i) = MAGMA_Z_MAKE( scal, 0. );
+            if (scal > 0) {
+                alpha = MAGMA_Z_MAKE( 1. / scal, 0. );
+                blasf77_zscal( &n, &alpha, V(i+1), &ione );
+            }
+
+            // apply previous rotations to column i, then compute new rotation
+            for (k = 0; k < i; ++k) {
+                alpha       = cs[k]*(*H(k,i)) + sn[k]*(*H(k+1,i));
+                *H(k+1,i)   = cs[k]*(*H(k+1,i)) - MAGMA_Z_CONJ(sn[k])*(*H(k,i));
+                *H(k,i)     = alpha;
+            }
+            lapackf77_zlartg( H(i,i), H(i+1,i), &cs[i], &sn[i], &alpha );
+            *H(i,i)   = alpha;
+            *H(i+1,i) = c_zero;
+            g[i+1] = -MAGMA_Z_CONJ(sn[i]) * g[i];
+            g[i]   = cs[i] * g[i];
+
+            if (MAGMA_Z_ABS( g[i+1] ) <= tol*beta0) {
+                i += 1;
+                break;
+            }
+        }
+
+        // solve the upper triangular system H(0:i-1, 0:i-1) y = g, y overwrites g,
+        // then x += M^{-1} V(0:i-1) y
+        blasf77_ztrsv( "Upper", "NoTrans", "NonUnit", &i, H, &ldh, g, &ione );
+        blasf77_zgemv( "NoTrans", &n, &i, &c_one, V, &n, g, &ione, &c_zero, w, &ione );
+        scal = lapackf77_zlange( "F", &n, &ione, w, &n, work );
+        if (scal > 0) {
+            // scale to unit norm for the single precision solve
+            alpha = MAGMA_Z_MAKE( 1. / scal, 0. );
+            blasf77_zscal( &n, &alpha, w, &ione );
+            magma_zcprecond_cpu( trans, uplo, n, SA, ldsa, ipiv, w, w, sx );
+            alpha = MAGMA_Z_MAKE( scal, 0. );
+            blasf77_zaxpy( &n, &alpha, w, &ione, x, &ione );
+        }
+    }
+
+cleanup:
+    magma_free_cpu( V );
+    magma_free_cpu( cs );
+    magma_free_cpu( sx );
+    return info;
+
+    #undef V
+    #undef H
+}
@@ -0,0 +1,356 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions mixed zc -> ds
+
+*/
+#include "magma_internal.h"
+
+/******************************************************************************/
+// Returns true if, for all columns j, ||R(:,j)||_inf <= ||X(:,j)||_inf * cte.
+// Sets *ratio to max_j ||R(:,j)||_inf / (||X(:,j)||_inf * cte), used to detect
+// stagnation of the refinement. If done is not NULL, sets done[j] for the
+// columns that satisfy the stopping criterion.
+static bool
+magma_zcgesv_converged(
+    magma_int_t n, magma_int_t nrhs,
+    const magmaDoubleComplex *X, magma_int_t ldx,
+    const magmaDoubleComplex *R, magma_int_t ldr,
+    double cte, double *ratio, bool *done )
+{
+    const magma_int_t ione = 1;
+    double Xnrm, Rnrm, work[1];
+    bool converged = true;
+
+    *ratio = 0;
+    for (magma_int_t j=0; j < nrhs; ++j) {
+        Xnrm = lapackf77_zlange( "M", &n, &ione, X + j*ldx, &ldx, work );
+        Rnrm = lapackf77_zlange( "M", &n, &ione, R + j*ldr, &ldr, work );
+        if (Rnrm > Xnrm*cte) {
+            converged = false;
+            *ratio = max( *ratio, Rnrm / (Xnrm*cte) );
+        }
+        if (done != NULL) {
+            done[j] = (Rnrm <= Xnrm*cte);
+        }
+    }
+    return converged;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZCGESV computes the solution to a complex system of linear equations
+       A * X = B,  A**T * X = B,  or  A**H * X = B,
+    where A is an N-by-N matrix and X and B are N-by-NRHS matrices.
+    This is the CPU interface of magma_zcgesv_gpu.
+
+    ZCGESV first attempts to factorize the matrix in complex SINGLE PRECISION
+    and use this factorization within an iterative refinement procedure
+    to produce a solution with complex DOUBLE PRECISION norm-wise backward error
+    quality (see below). Classical iterative refinement is tried first.
+    If it stagnates, i.e., an iteration does not reduce the backward error
+    by at least half, the method switches to GMRES-based iterative refinement
+    (GMRES-IR), which solves each correction equation with GMRES in complex
+    DOUBLE PRECISION, preconditioned by the SINGLE PRECISION LU factors.
+    GMRES-IR converges for condition numbers up to about 1/EPS rather than
+    about 1/SEPS. If this also fails, the method switches to a complex
+    DOUBLE PRECISION factorization and solve.
+
+    The iterative refinement process is stopped if
+        ITER > ITERMAX
+    or for all the RHS we have:
+        RNRM < SQRT(N)*XNRM*ANRM*EPS*BWDMAX
+    where
+        o ITER is the number of the current iteration in the iterative
+          refinement process
+        o RNRM is the infinity-norm of the residual
+        o XNRM is the infinity-norm of the solution
+        o ANRM is the infinity-operator-norm of the matrix A
+        o EPS is the machine epsilon returned by DLAMCH('Epsilon')
+    The value ITERMAX and BWDMAX are fixed to 30 and 1.0D+00 respectively.
+    Each GMRES-IR step runs at most 50 GMRES iterations per right hand side,
+    with relative tolerance 1.0D-04.
+
+    Arguments
+    ---------
+    @param[in]
+    trans   magma_trans_t
+            Specifies the form of the system of equations:
+      -     = MagmaNoTrans:    A    * X = B  (No transpose)
+      -     = MagmaTrans:      A**T * X = B  (Transpose)
+      -     = MagmaConjTrans:  A**H * X = B  (Conjugate transpose)
+
+    @param[in]
+    n       INTEGER
+            The number of linear equations, i.e., the order of the
+            matrix A.  N >= 0.
+
+    @param[in]
+    nrhs    INTEGER
+            The number of right hand sides, i.e., the number of columns
+            of the matrix B.  NRHS >= 0.
+
+    @param[in,out]
+    A       COMPLEX_16 array, dimension (LDA,N)
+            On entry, the N-by-N coefficient matrix A.
+            On exit, if iterative refinement has been successfully used
+            (info.EQ.0 and ITER.GE.0, see description below), A is
+            unchanged. If double precision factorization has been used
+            (info.EQ.0 and ITER.LT.0, see description below), then the
+            array A contains the factors L and U from the factorization
+            A = P*L*U; the unit diagonal elements of L are not stored.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of the array A.  LDA >= max(1,N).
+
+    @param[out]
+    ipiv    INTEGER array, dimension (N)
+            The pivot indices that define the permutation matrix P;
+            row i of the matrix was interchanged with row IPIV(i).
+            Corresponds either to the single precision factorization
+            (if info.EQ.0 and ITER.GE.0) or the double precision
+            factorization (if info.EQ.0 and ITER.LT.0).
+
+    @param[in]
+    B       COMPLEX_16 array, dimension (LDB,NRHS)
+            The N-by-NRHS right hand side matrix B.
+
+    @param[in]
+    ldb     INTEGER
+            The leading dimension of the array B.  LDB >= max(1,N).
+
+    @param[out]
+    X       COMPLEX_16 array, dimension (LDX,NRHS)
+            If info = 0, the N-by-NRHS solution matrix X.
+
+    @param[in]
+    ldx     INTEGER
+            The leading dimension of the array X.  LDX >= max(1,N).
+
+    @param[out]
+    iter    INTEGER
+      -     < 0: iterative refinement has failed, double precision
+                 factorization has been performed
+        +        -1 : the routine fell back to full precision for
+                      implementation- or machine-specific reasons
+        +        -2 : narrowing the precision induced an overflow,
+                      the routine fell back to full precision
+        +        -3 : failure of CGETRF
+        +        -31: stop the iterative refinement after the 30th iteration
+      -     > 0: iterative refinement has been successfully used.
+                 Returns the number of iterations; if GMRES-IR was used,
+                 this includes the total number of inner GMRES iterations.
+
+    @param[out]
+    info   INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if info = -i, the i-th argument had an illegal value
+      -     > 0:  if info = i, U(i,i) computed in DOUBLE PRECISION is
+                  exactly zero.  The factorization has been completed,
+                  but the factor U is exactly singular, so the solution
+                  could not be computed.
+
+    @ingroup magma_gesv
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zcgesv(
+    magma_trans_t trans, magma_int_t n, magma_int_t nrhs,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magma_int_t *ipiv,
+    magmaDoubleComplex *B, magma_int_t ldb,
+    magmaDoubleComplex *X, magma_int_t ldx,
+    magma_int_t *iter,
+    magma_int_t *info)
+{
+    #define B(i_,j_)  (B + (i_) + (j_)*ldb)
+    #define X(i_,j_)  (X + (i_) + (j_)*ldx)
+    #define R(i_,j_)  (R + (i_) + (j_)*ldr)
+
+    // Constants
+    const double      BWDMAX  = 1.0;
+    const magma_int_t ITERMAX = 30;
+    const magma_int_t GMRES_ITERMAX = 50;
+    const double      GMRES_TOL = 1e-4;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_zero    = MAGMA_Z_ZERO;
+    const magma_int_t ione = 1;
+
+    // Local variables
+    magmaDoubleComplex *R, *D;
+    magmaFloatComplex *SA, *SX;
+    double Anrm, cte, eps, ratio, ratio_old;
+    magma_int_t j, iiter, niter, gmres_iter, ldsa, ldr, iinfo;
+    bool gmres = false, *done;
+
+    /* Check arguments */
+    *iter = 0;
+    *info = 0;
+    if ( trans != MagmaNoTrans && trans != MagmaTrans && trans != MagmaConjTrans )
+        *info = -1;
+    else if ( n < 0 )
+        *info = -2;
+    else if ( nrhs < 0 )
+        *info = -3;
+    else if ( lda < max(1,n))
+        *info = -5;
+    else if ( ldb < max(1,n))
+        *info = -8;
+    else if ( ldx < max(1,n))
+        *info = -10;
+
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    if ( n == 0 || nrhs == 0 )
+        return *info;
+
+    ldsa = n;
+    ldr  = n;
+
+    R = NULL;  SA = NULL;  done = NULL;
+    if (MAGMA_SUCCESS != magma_zmalloc_cpu( &R,  ldr*nrhs + n ) ||
+        MAGMA_SUCCESS != magma_cmalloc_cpu( &SA, ldsa*(n + nrhs) ) ||
+        MAGMA_SUCCESS != magma_malloc_cpu( (void**) &done, nrhs*sizeof(bool) ))
+    {
+        *iter = -1;
+        goto fallback;
+    }
+    D  = R  + ldr*nrhs;
+    SX = SA + ldsa*n;
+
+    eps  = lapackf77_dlamch("Epsilon");
+    Anrm = lapackf77_zlange( "I", &n, &n, A, &lda, (double*) R );
+    cte  = Anrm * eps * magma_dsqrt( (double) n ) * BWDMAX;
+
+    /*
+     * Convert to single precision
+     */
+    lapackf77_zlag2c( &n, &nrhs, B, &ldb, SX, &ldsa, &iinfo );
+    if (iinfo != 0) {
+        *iter = -2;
+        goto fallback;
+    }
+
+    lapackf77_zlag2c( &n, &n, A, &lda, SA, &ldsa, &iinfo );
+    if (iinfo != 0) {
+        *iter = -2;
+        goto fallback;
+    }
+
+    // factor SA in single precision
+    magma_cgetrf( n, n, SA, ldsa, ipiv, &iinfo );
+    if (iinfo != 0) {
+        *iter = -3;
+        goto fallback;
+    }
+
+    // solve SA*SX = B in single precision, convert result to X
+    lapackf77_cgetrs( lapack_trans_const(trans), &n, &nrhs, SA, &ldsa, ipiv, SX, &ldsa, &iinfo );
+    lapackf77_clag2z( &n, &nrhs, SX, &ldsa, X, &ldx, &iinfo );
+
+    // residual R = B - op(A)*X in double precision
+    lapackf77_zlacpy( "Full", &n, &nrhs, B, &ldb, R, &ldr );
+    blasf77_zgemm( lapack_trans_const(trans), "NoTrans", &n, &nrhs, &n,
+                   &c_neg_one, A, &lda,
+                               X, &ldx,
+                   &c_one,     R, &ldr );
+
+    if (magma_zcgesv_converged( n, nrhs, X, ldx, R, ldr, cte, &ratio_old, NULL )) {
+        *iter = 0;
+        goto cleanup;
+    }
+
+    gmres_iter = 0;
+    for( iiter=1; iiter < ITERMAX; ++iiter ) {
+        if (! gmres) {
+            // classical refinement:
+            // convert residual R to single precision SX,
+            // solve SA*SX = R in single precision,
+            // convert result back to double precision R, and add X += R.
+            lapackf77_zlag2c( &n, &nrhs, R, &ldr, SX, &ldsa, &iinfo );
+            if (iinfo != 0) {
+                *iter = -2;
+                goto fallback;
+            }
+            lapackf77_cgetrs( lapack_trans_const(trans), &n, &nrhs, SA, &ldsa, ipiv, SX, &ldsa, &iinfo );
+            lapackf77_clag2z( &n, &nrhs, SX, &ldsa, R, &ldr, &iinfo );
+            for( j=0; j < nrhs; ++j ) {
+                blasf77_zaxpy( &n, &c_one, R(0,j), &ione, X(0,j), &ione );
+            }
+        }
+        else {
+            // GMRES-IR: solve op(A)*D = R(:,j) with GMRES preconditioned
+            // by the single precision LU factors, and add X(:,j) += D,
+            // for each column that has not yet converged.
+            for( j=0; j < nrhs; ++j ) {
+                if (done[j])
+                    continue;
+                lapackf77_zlaset( "Full", &n, &ione, &c_zero, &c_zero, D, &n );
+                iinfo = magma_zcfgmres_cpu( trans, MagmaUpper, n, A, lda, SA, ldsa, ipiv,
+                                            R(0,j), D, GMRES_ITERMAX, GMRES_ITERMAX,
+                                            GMRES_TOL, &niter );
+                if (iinfo < 0) {
+                    *iter = -1;
+                    goto fallback;
+                }
+                gmres_iter += niter;
+                blasf77_zaxpy( &n, &c_one, D, &ione, X(0,j), &ione );
+            }
+        }
+
+        // residual R = B - op(A)*X in double precision
+        lapackf77_zlacpy( "Full", &n, &nrhs, B, &ldb, R, &ldr );
+        blasf77_zgemm( lapack_trans_const(trans), "NoTrans", &n, &nrhs, &n,
+                       &c_neg_one, A, &lda,
+                                   X, &ldx,
+                       &c_one,     R, &ldr );
+
+        /*  Check whether the nrhs normwise backward errors satisfy the
+         *  stopping criterion. If yes, set ITER=IITER > 0 and return. */
+        if (magma_zcgesv_converged( n, nrhs, X, ldx, R, ldr, cte, &ratio, done )) {
+            *iter = iiter + gmres_iter;
+            goto cleanup;
+        }
+
+        // switch to GMRES-IR if classical refinement stagnates
+        if (ratio > 0.5*ratio_old) {
+            gmres = true;
+        }
+        ratio_old = ratio;
+    }
+
+    /* If we are at this place of the code, this is because we have
+     * performed ITER=ITERMAX iterations and never satisified the
+     * stopping criterion. Set up the ITER flag accordingly and follow
+     * up on double precision routine. */
+    *iter = -ITERMAX - 1;
+
+fallback:
+    /* Single-precision iterative refinement failed to converge to a
+     * satisfactory solution, so we resort to double precision. */
+    magma_zgetrf( n, n, A, lda, ipiv, info );
+    if (*info == 0) {
+        lapackf77_zlacpy( "Full", &n, &nrhs, B, &ldb, X, &ldx );
+        lapackf77_zgetrs( lapack_trans_const(trans), &n, &nrhs, A, &lda, ipiv, X, &ldx, info );
+    }
+
+cleanup:
+    magma_free_cpu( R );
+    magma_free_cpu( SA );
+    magma_free_cpu( done );
+    return *info;
+
+    #undef B
+    #undef X
+    #undef R
+}
@@ -0,0 +1,425 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+#include <algorithm>
+
+#include "thread_pool.hpp"
+#include "magma_internal.h"
+
+#define COMPLEX
+
+/******************************************************************************/
+// data shared by all threads of a batch
+typedef struct magma_zheevd_batched_data_s {
+    magma_vec_t jobz;
+    magma_uplo_t uplo;
+    const magma_int_t *n;
+    magmaDoubleComplex * const *A_array;
+    const magma_int_t *lda;
+    double * const *w_array;
+    magma_int_t *info_array;
+    const magma_int_t *order;   // problem indices, largest first; NULL for 0, 1, 2, ...
+    magma_int_t batchCount;
+
+    // per-thread workspace, sized for the largest problem
+    magmaDoubleComplex *work;
+    magma_int_t lwork;
+    #ifdef COMPLEX
+    double *rwork;
+    magma_int_t lrwork;
+    #endif
+    magma_int_t *iwork;
+    magma_int_t liwork;
+
+    magma_int_t next;           // next position in order to solve
+    pthread_mutex_t mutex;      // lock for next
+} magma_zheevd_batched_data;
+
+
+/******************************************************************************/
+typedef struct magma_zheevd_batched_id_data_s {
+    magma_int_t id;
+    magma_zheevd_batched_data* data;
+} magma_zheevd_batched_id_data;
+
+
+/******************************************************************************/
+// Each thread repeatedly takes the next problem and solves it with LAPACK,
+// using its own slice of the workspace for every problem.
+static void* magma_zheevd_batched_parallel_section( void* arg )
+{
+    magma_int_t id                  = ((magma_zheevd_batched_id_data*)arg) -> id;
+    magma_zheevd_batched_data* data = ((magma_zheevd_batched_id_data*)arg) -> data;
+
+    const char* jobz_ = lapack_vec_const( data->jobz );
+    const char* uplo_ = lapack_uplo_const( data->uplo );
+
+    magma_int_t lwork  = data->lwork;
+    magmaDoubleComplex *work = data->work + id*lwork;
+    #ifdef COMPLEX
+    magma_int_t lrwork = data->lrwork;
+    double *rwork = data->rwork + id*lrwork;
+    #endif
+    magma_int_t liwork = data->liwork;
+    magma_int_t *iwork = data->iwork + id*liwork;
+
+    // each problem is solved by one thread
+    magma_set_lapack_numthreads( 1 );
+
+    while (true) {
+        pthread_mutex_lock( &data->mutex );
+        magma_int_t k = data->next;
+        data->next += 1;
+        pthread_mutex_unlock( &data->mutex );
+        if (k >= data->batchCount) {
+            break;
+        }
+
+        magma_int_t i = (data->order == NULL ? k : data->order[k]);
+        magma_int_t n = data->n[i];
+        magma_int_t lda = data->lda[i];
+        lapackf77_zheevd( jobz_, uplo_,
+                          &n, data->A_array[i], &lda,
+                          data->w_array[i], work, &lwork,
+                          #ifdef COMPLEX
+                          rwork, &lrwork,
+                          #endif
+                          iwork, &liwork, &data->info_array[i] );
+    }
+    return NULL;
+}
+
+
+/******************************************************************************/
+// Solves the problems in the given order, across the threads of the pool.
+// Sizes are already checked.
+static magma_int_t
+magma_zheevd_batched_cpu_run(
+    magma_vec_t jobz, magma_uplo_t uplo,
+    const magma_int_t *n, magma_int_t max_n,
+    magmaDoubleComplex * const *A_array, const magma_int_t *lda,
+    double * const *w_array,
+    magma_int_t *info_array, const magma_int_t *order,
+    magma_int_t batchCount )
+{
+    magma_int_t info = 0;
+
+    // workspace query for the largest problem, which suffices for all
+    const char* jobz_ = lapack_vec_const( jobz );
+    const char* uplo_ = lapack_uplo_const( uplo );
+    magma_int_t ineg_one = -1;
+    magmaDoubleComplex aux_work[1];
+    #ifdef COMPLEX
+    double aux_rwork[1];
+    #endif
+    magma_int_t aux_iwork[1];
+    magma_int_t ldq = max( 1, max_n );
+    lapackf77_zheevd( jobz_, uplo_, &max_n, NULL, &ldq, NULL,
+                      aux_work, &ineg_one,
+                      #ifdef COMPLEX
+                      aux_rwork, &ineg_one,
+                      #endif
+                      aux_iwork, &ineg_one, &info );
+
+    magma_zheevd_batched_data data;
+    data.jobz       = jobz;
+    data.uplo       = uplo;
+    data.n          = n;
+    data.A_array    = A_array;
+    data.lda        = lda;
+    data.w_array    = w_array;
+    data.info_array = info_array;
+    data.order      = order;
+    data.batchCount = batchCount;
+    data.lwork      = max( 1, magma_int_t( MAGMA_Z_REAL( aux_work[0] )));
+    #ifdef COMPLEX
+    data.lrwork     = max( 1, magma_int_t( aux_rwork[0] ));
+    #endif
+    data.liwork     = max( 1, aux_iwork[0] );
+    data.next       = 0;
+
+    magma_int_t mklth    = magma_get_lapack_numthreads();
+    magma_int_t nthreads = min( magma_get_parallel_numthreads(), batchCount );
+
+    magma_thread_pool* pool = magma_thread_pool::get();
+    nthreads = pool->begin( nthreads );
+
+    magma_zheevd_batched_id_data* arg = NULL;
+    data.work  = NULL;
+    #ifdef COMPLEX
+    data.rwork = NULL;
+    #endif
+    data.iwork = NULL;
+    if (MAGMA_SUCCESS != magma_zmalloc_cpu( &data.work,  nthreads*data.lwork  ) ||
+        #ifdef COMPLEX
+        MAGMA_SUCCESS != magma_dmalloc_cpu( &data.rwork, nthreads*data.lrwork ) ||
+        #endif
+        MAGMA_SUCCESS != magma_imalloc_cpu( &data.iwork, nthreads*data.liwork ) ||
+        MAGMA_SUCCESS != magma_malloc_cpu( (void**) &arg, nthreads*sizeof(magma_zheevd_batched_id_data) ))
+    {
+        info = MAGMA_ERR_HOST_ALLOC;
+        goto cleanup;
+    }
+
+    pthread_mutex_init( &data.mutex, NULL );
+    for (magma_int_t thread = 0; thread < nthreads; ++thread) {
+        arg[thread].id   = thread;
+        arg[thread].data = &data;
+    }
+    pool->run( magma_zheevd_batched_parallel_section, arg, sizeof(magma_zheevd_batched_id_data) );
+    pthread_mutex_destroy( &data.mutex );
+
+cleanup:
+    pool->end();
+    magma_set_lapack_numthreads( mklth );
+
+    magma_free_cpu( arg );
+    magma_free_cpu( data.work );
+    #ifdef COMPLEX
+    magma_free_cpu( data.rwork );
+    #endif
+    magma_free_cpu( data.iwork );
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZHEEVD_BATCHED_CPU computes all eigenvalues and, optionally, eigenvectors
+    of each matrix in a batch of n-by-n complex Hermitian matrices in host
+    memory.
+
+    It is meant for many small problems, where a single call to magma_zheevd
+    has little work to parallelize. The problems are distributed over the
+    threads of MAGMA's thread pool (see magma_get_parallel_numthreads); each
+    problem is solved on one core by LAPACK's zheevd, and each thread allocates
+    its workspace once and reuses it for all its problems.
+
+    Arguments
+    ---------
+    @param[in]
+    jobz    magma_vec_t
+      -     = MagmaNoVec:  Compute eigenvalues only;
+      -     = MagmaVec:    Compute eigenvalues and eigenvectors.
+
+    @param[in]
+    uplo    magma_uplo_t
+      -     = MagmaUpper:  Upper triangle of each A is stored;
+      -     = MagmaLower:  Lower triangle of each A is stored.
+
+    @param[in]
+    n       INTEGER
+            The order of each matrix A.  N >= 0.
+
+    @param[in,out]
+    A_array Array of pointers, dimension (batchCount).
+            Each is a COMPLEX_16 array, dimension (LDA, N), in host memory.
+            On entry, the Hermitian matrix A, as in magma_zheevd.
+            On exit, if JOBZ = MagmaVec, then if INFO = 0, A contains the
+            orthonormal eigenvectors of the matrix A.
+            If JOBZ = MagmaNoVec, the triangle of A selected by UPLO,
+            including the diagonal, is destroyed.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of each array A.  LDA >= max(1,N).
+
+    @param[out]
+    w_array Array of pointers, dimension (batchCount).
+            Each is a DOUBLE PRECISION array, dimension (N).
+            If INFO = 0, the eigenvalues of A in ascending order.
+
+    @param[out]
+    info_array  Array of INTEGERs, dimension (batchCount).
+            The INFO from zheevd for each matrix:
+      -     = 0:  successful exit
+      -     > 0:  the algorithm failed to converge, as in magma_zheevd.
+
+    @param[in]
+    batchCount  INTEGER
+            The number of matrices to operate on.
+
+    @return
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+                  or another error occured, such as memory allocation failed.
+
+    @ingroup magma_heevd
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zheevd_batched_cpu(
+    magma_vec_t jobz, magma_uplo_t uplo, magma_int_t n,
+    magmaDoubleComplex **A_array, magma_int_t lda,
+    double **w_array,
+    magma_int_t *info_array, magma_int_t batchCount )
+{
+    magma_int_t info = 0;
+    if (jobz != MagmaVec && jobz != MagmaNoVec) {
+        info = -1;
+    } else if (uplo != MagmaLower && uplo != MagmaUpper) {
+        info = -2;
+    } else if (n < 0) {
+        info = -3;
+    } else if (lda < max(1,n)) {
+        info = -5;
+    } else if (batchCount < 0) {
+        info = -8;
+    }
+
+    if (info != 0) {
+        magma_xerbla( __func__, -(info) );
+        return info;
+    }
+
+    /* Quick return if possible */
+    if (batchCount == 0) {
+        return info;
+    }
+    if (n == 0) {
+        for (magma_int_t i = 0; i < batchCount; ++i) {
+            info_array[i] = 0;
+        }
+        return info;
+    }
+
+    magma_int_t *n_array, *lda_array;
+    if (MAGMA_SUCCESS != magma_imalloc_cpu( &n_array, 2*batchCount )) {
+        info = MAGMA_ERR_HOST_ALLOC;
+        return info;
+    }
+    lda_array = n_array + batchCount;
+    for (magma_int_t i = 0; i < batchCount; ++i) {
+        n_array[i]   = n;
+        lda_array[i] = lda;
+    }
+
+    info = magma_zheevd_batched_cpu_run( jobz, uplo, n_array, n, A_array, lda_array,
+                                         w_array, info_array, NULL, batchCount );
+
+    magma_free_cpu( n_array );
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZHEEVD_VBATCHED_CPU computes all eigenvalues and, optionally, eigenvectors
+    of each matrix in a batch of complex Hermitian matrices of varying sizes
+    in host memory.
+
+    As in magma_zheevd_batched_cpu, each problem is solved on one core by
+    LAPACK's zheevd, with per-thread workspace sized for the largest problem.
+    Problems are grouped by size and handed out largest first, which balances
+    the load across threads.
+
+    Arguments
+    ---------
+    @param[in]
+    jobz    magma_vec_t
+      -     = MagmaNoVec:  Compute eigenvalues only;
+      -     = MagmaVec:    Compute eigenvalues and eigenvectors.
+
+    @param[in]
+    uplo    magma_uplo_t
+      -     = MagmaUpper:  Upper triangle of each A is stored;
+      -     = MagmaLower:  Lower triangle of each A is stored.
+
+    @param[in]
+    n       Array of INTEGERs, dimension (batchCount).
+            Each is the order of the corresponding matrix A.  N[i] >= 0.
+
+    @param[in,out]
+    A_array Array of pointers, dimension (batchCount).
+            Each is a COMPLEX_16 array, dimension (LDA[i], N[i]), in host memory.
+            See magma_zheevd_batched_cpu.
+
+    @param[in]
+    lda     Array of INTEGERs, dimension (batchCount).
+            Each is the leading dimension of the corresponding array A.
+            LDA[i] >= max(1,N[i]).
+
+    @param[out]
+    w_array Array of pointers, dimension (batchCount).
+            Each is a DOUBLE PRECISION array, dimension (N[i]).
+            If INFO = 0, the eigenvalues of A in ascending order.
+
+    @param[out]
+    info_array  Array of INTEGERs, dimension (batchCount).
+            The INFO from zheevd for each matrix, as in magma_zheevd_batched_cpu.
+
+    @param[in]
+    batchCount  INTEGER
+            The number of matrices to operate on.
+
+    @return
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+                  or another error occured, such as memory allocation failed.
+
+    @ingroup magma_heevd
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zheevd_vbatched_cpu(
+    magma_vec_t jobz, magma_uplo_t uplo, magma_int_t *n,
+    magmaDoubleComplex **A_array, magma_int_t *lda,
+    double **w_array,
+    magma_int_t *info_array, magma_int_t batchCount )
+{
+    magma_int_t info = 0;
+    magma_int_t max_n = 0;
+    if (jobz != MagmaVec && jobz != MagmaNoVec) {
+        info = -1;
+    } else if (uplo != MagmaLower && uplo != MagmaUpper) {
+        info = -2;
+    } else if (batchCount < 0) {
+        info = -8;
+    } else {
+        for (magma_int_t i = 0; i < batchCount; ++i) {
+            if (n[i] < 0) {
+                info = -3;
+                break;
+            } else if (lda[i] < max(1,n[i])) {
+                info = -5;
+                break;
+            }
+            max_n = max( max_n, n[i] );
+        }
+    }
+
+    if (info != 0) {
+        magma_xerbla( __func__, -(info) );
+        return info;
+    }
+
+    /* Quick return if possible */
+    if (batchCount == 0) {
+        return info;
+    }
+
+    // group problems by size, largest first
+    magma_int_t *order;
+    if (MAGMA_SUCCESS != magma_imalloc_cpu( &order, batchCount )) {
+        info = MAGMA_ERR_HOST_ALLOC;
+        return info;
+    }
+    for (magma_int_t i = 0; i < batchCount; ++i) {
+        order[i] = i;
+    }
+    std::stable_sort( order, order + batchCount,
+        [n]( magma_int_t i, magma_int_t j ) { return n[i] > n[j]; } );
+
+    info = magma_zheevd_batched_cpu_run( jobz, uplo, n, max_n, A_array, lda,
+                                         w_array, info_array, order, batchCount );
+
+    magma_free_cpu( order );
+    return info;
+}
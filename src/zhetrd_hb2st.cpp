@@ -12,9 +12,11 @@
        @precisions normal z -> s d c
 
 */
+#include "thread_pool.hpp"
 #include "magma_internal.h"
 #include "magma_bulge.h"
 #include "magma_zbulge.h"
+#include "magma_timer.h"
 
 #ifndef MAGMA_NOAFFINITY
 #include "affinity.h"
@@ -30,7 +32,7 @@ static void magma_ztile_bulge_parallel(
     magmaDoubleComplex *V, magma_int_t ldv,
     magmaDoubleComplex *TAU, magma_int_t n, magma_int_t nb, magma_int_t nbtiles,
     magma_int_t grsiz, magma_int_t Vblksiz, magma_int_t wantz, 
-    volatile magma_int_t *prog, pthread_barrier_t* myptbarrier);
+    volatile magma_int_t *prog, magma_barrier* myptbarrier);
 
 static void magma_ztile_bulge_computeT_parallel(
     magma_int_t my_core_id, magma_int_t cores_num,
@@ -56,7 +58,7 @@ typedef struct magma_zbulge_data_s {
     magmaDoubleComplex* T;
     magma_int_t ldt;
     volatile magma_int_t *prog;
-    pthread_barrier_t myptbarrier;
+    magma_barrier* myptbarrier;
 } magma_zbulge_data;
 
 
@@ -68,7 +70,7 @@ void magma_zbulge_data_init(
     magmaDoubleComplex *A, magma_int_t lda,
     magmaDoubleComplex *V, magma_int_t ldv, magmaDoubleComplex *TAU,
     magmaDoubleComplex *T, magma_int_t ldt,
-    volatile magma_int_t* prog)
+    volatile magma_int_t* prog, magma_barrier* myptbarrier)
 {
     zbulge_data_S->threads_num = threads_num;
     zbulge_data_S->n = n;
@@ -85,15 +87,7 @@ void magma_zbulge_data_init(
     zbulge_data_S->T = T;
     zbulge_data_S->ldt = ldt;
     zbulge_data_S->prog = prog;
-
-    pthread_barrier_init(&(zbulge_data_S->myptbarrier), NULL, (unsigned) zbulge_data_S->threads_num);
-}
-
-
-/******************************************************************************/
-void magma_zbulge_data_destroy(magma_zbulge_data *zbulge_data_S)
-{
-    pthread_barrier_destroy(&(zbulge_data_S->myptbarrier));
+    zbulge_data_S->myptbarrier = myptbarrier;
 }
 
 
@@ -194,6 +188,7 @@ magma_zhetrd_hb2st(
 {
     #ifdef ENABLE_TIMER
     real_Double_t timeblg=0.0;
+    magma_counters_t counters;
     #endif
 
     magma_int_t parallel_threads = magma_get_parallel_numthreads();
@@ -211,6 +206,11 @@ magma_zhetrd_hb2st(
     memset(TAU, 0, sizTAU2*sizeof(magmaDoubleComplex));
     memset(V,   0, sizV2*sizeof(magmaDoubleComplex));
 
+    // borrow workers from the persistent thread pool;
+    // it may grant fewer threads, e.g., if called from within a pool thread.
+    magma_thread_pool* pool = magma_thread_pool::get();
+    parallel_threads = pool->begin( parallel_threads );
+
     magma_int_t INgrsiz=1;
     magma_int_t nbtiles = magma_ceildiv(n, nb);
     volatile magma_int_t* prog;
@@ -220,48 +220,33 @@ magma_zhetrd_hb2st(
     magma_zbulge_id_data* arg;
     magma_malloc_cpu((void**) &arg, parallel_threads*sizeof(magma_zbulge_id_data));
 
-    pthread_t* thread_id;
-    magma_malloc_cpu((void**) &thread_id, parallel_threads*sizeof(pthread_t));
-    pthread_attr_t thread_attr;
-
     magma_zbulge_data data_bulge;
     magma_zbulge_data_init(&data_bulge, parallel_threads, n, nb, nbtiles, INgrsiz, Vblksiz, wantz,
-                                 A, lda, V, ldv, TAU, T, ldt, prog);
-
-    // Set one thread per core
-    pthread_attr_init(&thread_attr);
-    pthread_attr_setscope(&thread_attr, PTHREAD_SCOPE_SYSTEM);
-    pthread_setconcurrency( (unsigned)parallel_threads );
+                                 A, lda, V, ldv, TAU, T, ldt, prog,
+                                 pool->barrier( parallel_threads ));
 
     //timing
     #ifdef ENABLE_TIMER
+    counters_start( counters );
     timeblg = magma_wtime();
     #endif
 
-    // Launch threads
-    for (magma_int_t thread = 1; thread < parallel_threads; thread++) {
+    // Run on pool threads 1, ..., parallel_threads-1 and this thread as 0
+    for (magma_int_t thread = 0; thread < parallel_threads; thread++) {
         magma_zbulge_id_data_init(&(arg[thread]), thread, &data_bulge);
-        pthread_create(&thread_id[thread], &thread_attr, magma_zhetrd_hb2st_parallel_section, &arg[thread]);
-    }
-    magma_zbulge_id_data_init(&(arg[0]), 0, &data_bulge);
-    magma_zhetrd_hb2st_parallel_section(&arg[0]);
-
-    // Wait for completion
-    for (magma_int_t thread = 1; thread < parallel_threads; thread++) {
-        void *exitcodep;
-        pthread_join(thread_id[thread], &exitcodep);
     }
+    pool->run( magma_zhetrd_hb2st_parallel_section, arg, sizeof(magma_zbulge_id_data) );
+    pool->end();
 
     // timing
     #ifdef ENABLE_TIMER
     timeblg = magma_wtime()-timeblg;
-    printf("  time BULGE+T = %f\n", timeblg);
+    counters_stop( counters );
+    counters_printf( "  time BULGE+T", counters, timeblg );
     #endif
 
-    magma_free_cpu(thread_id);
     magma_free_cpu(arg);
     magma_free_cpu((void *) prog);
-    magma_zbulge_data_destroy(&data_bulge);
 
     magma_set_omp_numthreads(ompth);
     magma_set_lapack_numthreads(mklth);
@@ -338,7 +323,7 @@ static void *magma_zhetrd_hb2st_parallel_section(void *arg)
     magma_int_t ldt            = data -> ldt;
     volatile magma_int_t* prog = data -> prog;
 
-    pthread_barrier_t* myptbarrier = &(data -> myptbarrier);
+    magma_barrier* myptbarrier = data -> myptbarrier;
 
     //magma_int_t sys_corenbr    = 1;
 
@@ -373,17 +358,19 @@ static void *magma_zhetrd_hb2st_parallel_section(void *arg)
 #endif
     affinity_set original_set;
     affinity_set new_set(my_core_id);
-    magma_int_t check  = 0;
+    magma_int_t check  = -1;
     magma_int_t check2 = 0;
-    // bind threads
-    check = original_set.get_affinity();
-    if (check == 0) {
-        check2 = new_set.set_affinity();
-        if (check2 != 0)
-            printf("Error in sched_setaffinity (single cpu)\n");
-    }
-    else {
-        printf("Error in sched_getaffinity\n");
+    // bind the calling thread; pool workers were bound once, when created
+    if (my_core_id == 0) {
+        check = original_set.get_affinity();
+        if (check == 0) {
+            check2 = new_set.set_affinity();
+            if (check2 != 0)
+                printf("Error in sched_setaffinity (single cpu)\n");
+        }
+        else {
+            printf("Error in sched_getaffinity\n");
+        }
     }
 #ifdef PRINTAFFINITY
     print_set.print_affinity(my_core_id, "set affinity");
@@ -404,7 +391,7 @@ static void *magma_zhetrd_hb2st_parallel_section(void *arg)
     #endif
 
     magma_ztile_bulge_parallel(my_core_id, allcores_num, A, lda, V, ldv, TAU, n, nb, nbtiles, grsiz, Vblksiz, wantz, prog, myptbarrier);
-    if (allcores_num > 1) pthread_barrier_wait(myptbarrier);
+    if (allcores_num > 1) myptbarrier->wait();
 
     #ifdef ENABLE_TIMER
     if (my_core_id == 0) {
@@ -423,7 +410,7 @@ static void *magma_zhetrd_hb2st_parallel_section(void *arg)
         #endif
        
         magma_ztile_bulge_computeT_parallel(my_core_id, allcores_num, V, ldv, TAU, T, ldt, n, nb, Vblksiz);
-        if (allcores_num > 1) pthread_barrier_wait(myptbarrier);
+        if (allcores_num > 1) myptbarrier->wait();
        
         #ifdef ENABLE_TIMER
         if (my_core_id == 0) {
@@ -434,7 +421,7 @@ static void *magma_zhetrd_hb2st_parallel_section(void *arg)
     }
 
 #ifndef MAGMA_NOAFFINITY
-    // unbind threads
+    // unbind the calling thread
     if (check == 0) {
         check2 = original_set.set_affinity();
         if (check2 != 0)
@@ -512,12 +499,12 @@ do { \
         magma_malloc_cpu((void**) &prog,  (m) * sizeof(magma_int_t)); \
         memset((magma_int_t*)prog, 0, (m)); \
     } \
-    pthread_barrier_wait(myptbarrier); \
+    myptbarrier->wait(); \
 } while(0)
 
 #define myss_finalize() \
 do { \
-    pthread_barrier_wait(myptbarrier); \
+    myptbarrier->wait(); \
     if (my_core_id == 0) { \
         magma_free_cpu((void *) prog); \
     } \
@@ -531,7 +518,7 @@ static void magma_ztile_bulge_parallel(
     magmaDoubleComplex *V, magma_int_t ldv,
     magmaDoubleComplex *TAU, magma_int_t n, magma_int_t nb, magma_int_t nbtiles,
     magma_int_t grsiz, magma_int_t Vblksiz, magma_int_t wantz, 
-    volatile magma_int_t *prog, pthread_barrier_t* myptbarrier)
+    volatile magma_int_t *prog, magma_barrier* myptbarrier)
 {
     magma_int_t sweepid, myid, shift, stt, st, ed, stind, edind;
     magma_int_t blklastind, colpt;
@@ -0,0 +1,499 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c
+*/
+#include "magma_internal.h"
+
+// Block size for the diagonal blocks. The off-diagonal updates are done
+// with GEMM on (nb x nb) x (nb x nrhs) blocks.
+#define NB 64
+
+/***************************************************************************//**
+    Computes a scaling factor s in (0, 1] such that
+        s * (C - A*B)
+    cannot overflow, where anorm, bnorm, cnorm are upper bounds on the
+    infinity-norms of A, B, and C. Same as LAPACK dlarmm.
+*******************************************************************************/
+static double
+zlatrsd3_rmm( double anorm, double bnorm, double cnorm )
+{
+    double smlnum = lapackf77_dlamch( "Safe minimum" ) / lapackf77_dlamch( "Precision" );
+    double bignum = (1. / smlnum) / 4.;
+
+    if ( bnorm <= 1. ) {
+        if ( anorm * bnorm > bignum - cnorm ) {
+            return 0.5;
+        }
+    }
+    else {
+        if ( anorm > (bignum - cnorm) / bnorm ) {
+            return 0.5 / bnorm;
+        }
+    }
+    return 1.;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZLATRSD3 solves one of the sets of triangular systems with modified diagonal
+       (A - lambda(k)*I)    * X(:,k) = scale(k)*B(:,k),
+       (A - lambda(k)*I)**T * X(:,k) = scale(k)*B(:,k),  or
+       (A - lambda(k)*I)**H * X(:,k) = scale(k)*B(:,k),
+    for k = 0, ..., nrhs-1, with scaling to prevent overflow. Here A is an
+    upper or lower triangular matrix, and each right-hand side has its own
+    shift lambda(k) and scaling factor scale(k).
+
+    This is a blocked, Level 3 BLAS version of ZLATRSD, following the
+    approach of LAPACK's ZLATRS3. The diagonal blocks are solved column by
+    column with ZLATRSD, keeping a local scaling factor for every block
+    row of every right-hand side; the off-diagonal updates are done for all
+    right-hand sides at once with ZGEMM, after rescaling the affected blocks
+    so that the update cannot overflow. The local scaling factors are
+    reconciled at the end.
+
+    As in ztrevc, diagonal entries with |A(j,j) - lambda(k)| < smin(k) are
+    replaced by smin(k) = max( ulp*|lambda(k)|, unfl*(n/ulp) ), so the
+    systems are never exactly singular when lambda(k) is an eigenvalue of A.
+    It does not modify A during the computation.
+
+    Arguments
+    ---------
+    @param[in]
+    uplo    magma_uplo_t
+            Specifies whether the matrix A is upper or lower triangular.
+      -     = MagmaUpper:  Upper triangular
+      -     = MagmaLower:  Lower triangular
+
+    @param[in]
+    trans   magma_trans_t
+            Specifies the operation applied to A.
+      -     = MagmaNoTrans:    Solve (A - lambda*I)    * x = s*b  (No transpose)
+      -     = MagmaTrans:      Solve (A - lambda*I)**T * x = s*b  (Transpose)
+      -     = MagmaConjTrans:  Solve (A - lambda*I)**H * x = s*b  (Conjugate transpose)
+
+    @param[in]
+    diag    magma_diag_t
+            Specifies whether or not the matrix A is unit triangular.
+      -     = MagmaNonUnit:  Non-unit triangular
+      -     = MagmaUnit:     Unit triangular
+
+    @param[in]
+    n       INTEGER
+            The order of the matrix A.  N >= 0.
+
+    @param[in]
+    nrhs    INTEGER
+            The number of right-hand sides.  NRHS >= 0.
+
+    @param[in]
+    A       COMPLEX_16 array, dimension (LDA,N)
+            The triangular matrix A, as in ZLATRSD.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of the array A.  LDA >= max (1,N).
+
+    @param[in]
+    lambda  COMPLEX_16 array, dimension (NRHS)
+            Shift to subtract from the diagonal of A for each right-hand side.
+
+    @param[in]
+    order   INTEGER array, dimension (NRHS), or NULL.
+            If not NULL, right-hand side k is solved with the principal
+            submatrix of order order(k), 0 <= order(k) <= N, that is the
+            first one to be solved for:
+            the leading submatrix if (uplo = MagmaUpper and trans = MagmaNoTrans)
+            or (uplo = MagmaLower and trans != MagmaNoTrans),
+            otherwise the trailing submatrix.
+            Entries of X(:,k) outside that submatrix are set to zero.
+            This allows solving the systems of several eigenvectors of
+            different order, as in ztrevc, in a single call.
+            If NULL, all right-hand sides use the full matrix.
+
+    @param[in,out]
+    X       COMPLEX_16 array, dimension (LDX,NRHS)
+            On entry, the right hand sides B of the triangular systems.
+            On exit, X is overwritten by the solutions.
+
+    @param[in]
+    ldx     INTEGER
+            The leading dimension of the array X.  LDX >= max (1,N).
+
+    @param[out]
+    scale   DOUBLE PRECISION array, dimension (NRHS)
+            The scaling factors s(k) for the triangular systems.
+            If scale(k) = 0, the k-th system is singular or badly scaled;
+            if it is singular, X(:,k) is an exact or approximate solution
+            to (A - lambda(k)*I)*x = 0.
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -k, the k-th argument had an illegal value
+
+    @ingroup magma_latrsd
+*******************************************************************************/
+extern "C"
+magma_int_t magma_zlatrsd3(
+    magma_uplo_t uplo, magma_trans_t trans, magma_diag_t diag,
+    magma_int_t n, magma_int_t nrhs,
+    const magmaDoubleComplex *A, magma_int_t lda,
+    const magmaDoubleComplex *lambda,
+    const magma_int_t *order,
+    magmaDoubleComplex *X, magma_int_t ldx,
+    double *scale,
+    magma_int_t *info)
+{
+    #define    A(i_,j_) (A    + (i_) + (j_)*lda)
+    #define    X(i_,j_) (X    + (i_) + (j_)*ldx)
+    #define Ablk(i_,j_) (Ablk + (i_) + (j_)*nb)
+    #define anrm(i_,j_) (anrm + (i_) + (j_)*nba)
+    #define  loc(i_,k_) (loc  + (i_) + (k_)*nba)
+
+    /* constants */
+    const magma_int_t ione = 1;
+    const magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    const magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+
+    /* Local variables */
+    magma_int_t i, j, k, ii, i1, i2, j1, j2, ja, jb, len, iinfo;
+    magma_int_t nb, nba, jfirst, jlast, jinc, forward;
+    double s, scaloc, scamin, scal, bnrm, smin, tjj, unfl, ulp, smlnum, bignum, smlnum_trevc;
+    magmaDoubleComplex tjjs;
+
+    double *rwork = NULL, *anrm, *loc, *xnrm, *cnorm, *nwork;
+    magma_int_t *lo = NULL, *hi;
+    magmaDoubleComplex *Ablk = NULL;
+
+    /* Function Body */
+    *info = 0;
+    magma_int_t upper  = (uplo  == MagmaUpper);
+    magma_int_t notran = (trans == MagmaNoTrans);
+    magma_int_t nounit = (diag  == MagmaNonUnit);
+
+    /* Test the input parameters. */
+    if ( ! upper && uplo != MagmaLower ) {
+        *info = -1;
+    }
+    else if (! notran &&
+             trans != MagmaTrans &&
+             trans != MagmaConjTrans) {
+        *info = -2;
+    }
+    else if ( ! nounit && diag != MagmaUnit ) {
+        *info = -3;
+    }
+    else if ( n < 0 ) {
+        *info = -4;
+    }
+    else if ( nrhs < 0 ) {
+        *info = -5;
+    }
+    else if ( lda < max(1,n) ) {
+        *info = -7;
+    }
+    else if ( ldx < max(1,n) ) {
+        *info = -11;
+    }
+    else if ( order != NULL ) {
+        for( k = 0; k < nrhs; ++k ) {
+            if ( order[k] < 0 || order[k] > n ) {
+                *info = -9;
+                break;
+            }
+        }
+    }
+    if ( *info != 0 ) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    /* Quick return if possible */
+    for( k = 0; k < nrhs; ++k ) {
+        scale[k] = 1.;
+    }
+    if ( n == 0 || nrhs == 0 ) {
+        return *info;
+    }
+
+    /* Forward substitution goes from the first block row to the last;
+       backward substitution from the last to the first.
+       Each right-hand side uses the rows [lo(k), hi(k)), which are
+       the leading rows for backward and the trailing rows for forward
+       substitution. */
+    forward = (upper && ! notran) || (! upper && notran);
+
+    nb  = min( NB, n );
+    nba = magma_ceildiv( n, nb );
+
+    /* Workspace:
+       anrm  nba*nba    norms of the off-diagonal blocks of op(A)
+       loc   nba*nrhs   local scaling factors of each block of X
+       xnrm  nrhs       norms of the current block of X
+       cnorm n          norms of columns within the diagonal blocks
+       nwork nb         work for zlange */
+    if ( MAGMA_SUCCESS != magma_dmalloc_cpu( &rwork, nba*nba + nba*nrhs + nrhs + n + nb ) ||
+         MAGMA_SUCCESS != magma_imalloc_cpu( &lo, 2*nrhs ) ||
+         MAGMA_SUCCESS != magma_zmalloc_cpu( &Ablk, nb*nb ))
+    {
+        *info = MAGMA_ERR_HOST_ALLOC;
+        goto cleanup;
+    }
+    anrm  = rwork;
+    loc   = anrm + nba*nba;
+    xnrm  = loc  + nba*nrhs;
+    cnorm = xnrm + nrhs;
+    nwork = cnorm + n;
+    hi    = lo + nrhs;
+
+    /* Determine machine dependent parameters to control overflow. */
+    unfl   = lapackf77_dlamch( "Safe minimum" );
+    ulp    = lapackf77_dlamch( "Precision" );
+    smlnum = unfl;
+    bignum = lapackf77_dlamch( "Overflow" );
+    smlnum_trevc = unfl*( n / ulp );
+
+    /* Set active rows and zero X outside them. */
+    for( k = 0; k < nrhs; ++k ) {
+        len = (order == NULL ? n : order[k]);
+        if ( forward ) {
+            lo[k] = n - len;
+            hi[k] = n;
+        }
+        else {
+            lo[k] = 0;
+            hi[k] = len;
+        }
+        for( i = 0; i < lo[k]; ++i ) {
+            *X(i,k) = c_zero;
+        }
+        for( i = hi[k]; i < n; ++i ) {
+            *X(i,k) = c_zero;
+        }
+        for( i = 0; i < nba; ++i ) {
+            *loc(i,k) = 1.;
+        }
+    }
+
+    /* Compute norms of blocks of op(A) used in the updates.
+       anrm(i,j) bounds the infinity-norm of the block of op(A)
+       that updates block row i using block row j. */
+    for( j = 0; j < nba; ++j ) {
+        j1 = j*nb;
+        j2 = min( j1 + nb, n );
+        len = j2 - j1;
+        for( i = 0; i < nba; ++i ) {
+            i1 = i*nb;
+            i2 = min( i1 + nb, n );
+            ii = i2 - i1;
+            *anrm(i,j) = 0.;
+            if ( (forward && i > j) || (! forward && i < j) ) {
+                if ( notran ) {
+                    *anrm(i,j) = lapackf77_zlange( "I", &ii, &len, A(i1,j1), &lda, nwork );
+                }
+                else {
+                    *anrm(i,j) = lapackf77_zlange( "1", &len, &ii, A(j1,i1), &lda, nwork );
+                }
+            }
+        }
+    }
+
+    if ( forward ) {
+        jfirst = 0;
+        jlast  = nba;
+        jinc   = 1;
+    }
+    else {
+        jfirst = nba - 1;
+        jlast  = -1;
+        jinc   = -1;
+    }
+
+    for( j = jfirst; j != jlast; j += jinc ) {
+        j1  = j*nb;
+        j2  = min( j1 + nb, n );
+        len = j2 - j1;
+
+        /* Copy the diagonal block; the diagonal is set for each
+           right-hand side below. Compute the 1-norms of the off-diagonal
+           part of each column within the block. */
+        lapackf77_zlacpy( (upper ? "Upper" : "Lower"), &len, &len, A(j1,j1), &lda, Ablk, &nb );
+        for( i = 0; i < len; ++i ) {
+            if ( upper ) {
+                cnorm[j1+i] = magma_cblas_dzasum( i, Ablk(0,i), ione );
+            }
+            else {
+                cnorm[j1+i] = magma_cblas_dzasum( len-i-1, Ablk(i+1,i), ione );
+            }
+        }
+
+        /* --------------------
+           Solve the diagonal block for each right-hand side. */
+        for( k = 0; k < nrhs; ++k ) {
+            ja = max( j1, lo[k] );
+            jb = min( j2, hi[k] );
+            xnrm[k] = 0.;
+            if ( ja >= jb ) {
+                continue;
+            }
+
+            smin = max( ulp*MAGMA_Z_ABS1( lambda[k] ), smlnum_trevc );
+            for( i = ja; i < jb; ++i ) {
+                tjjs = (nounit ? *A(i,i) : c_one) - lambda[k];
+                tjj  = MAGMA_Z_ABS1( tjjs );
+                if ( tjj < smin ) {
+                    tjjs = MAGMA_Z_MAKE( smin, 0. );
+                }
+                *Ablk(i-j1,i-j1) = tjjs;
+            }
+
+            ii = jb - ja;
+            magma_zlatrsd( uplo, trans, MagmaNonUnit, MagmaTrue, ii,
+                           Ablk(ja-j1,ja-j1), nb, c_zero, X(ja,k),
+                           &scaloc, &cnorm[ja], &iinfo );
+
+            if ( scaloc == 0. ) {
+                /* A is singular through the diagonal block.
+                   zlatrsd computed a solution of op(A_JJ)*x = 0;
+                   extend it by zeros and solve op(A)*x = 0. */
+                scale[k] = 0.;
+                for( i = 0; i < ja; ++i ) {
+                    *X(i,k) = c_zero;
+                }
+                for( i = jb; i < n; ++i ) {
+                    *X(i,k) = c_zero;
+                }
+                for( i = 0; i < nba; ++i ) {
+                    *loc(i,k) = 1.;
+                }
+                scaloc = 1.;
+            }
+            else if ( scaloc * (*loc(j,k)) == 0. ) {
+                /* zlatrsd computed a valid scaling factor, but combined
+                   with the current scaling it underflows.
+                   Set loc(j,k) to the smallest valid scaling factor and
+                   increase scaloc accordingly. */
+                scal = *loc(j,k) / smlnum;
+                scaloc *= scal;
+                *loc(j,k) = smlnum;
+                /* If zlatrsd overestimated the growth, x may be rescaled
+                   to preserve a valid combined scaling factor. */
+                s = 1. / scaloc;
+                if ( lapackf77_zlange( "I", &ii, &ione, X(ja,k), &ldx, nwork ) * s <= bignum ) {
+                    blasf77_zdscal( &ii, &s, X(ja,k), &ione );
+                    scaloc = 1.;
+                }
+                else {
+                    /* The system is badly scaled and its solution cannot be
+                       represented as (1/scale)*x. Set x to zero. */
+                    scale[k] = 0.;
+                    for( i = 0; i < n; ++i ) {
+                        *X(i,k) = c_zero;
+                    }
+                    for( i = 0; i < nba; ++i ) {
+                        *loc(i,k) = 1.;
+                    }
+                    scaloc = 1.;
+                }
+            }
+            *loc(j,k) *= scaloc;
+            xnrm[k] = lapackf77_zlange( "I", &ii, &ione, X(ja,k), &ldx, nwork );
+        }
+
+        /* --------------------
+           Update the remaining block rows with GEMM. */
+        for( i = j + jinc; i != jlast; i += jinc ) {
+            i1 = i*nb;
+            i2 = min( i1 + nb, n );
+            ii = i2 - i1;
+
+            /* Rescale X(I,k) and X(J,k) to a consistent scaling
+               that also survives the update. */
+            for( k = 0; k < nrhs; ++k ) {
+                if ( xnrm[k] == 0. ) {
+                    continue;
+                }
+                scamin  = min( *loc(i,k), *loc(j,k) );
+                bnrm    = lapackf77_zlange( "I", &ii, &ione, X(i1,k), &ldx, nwork );
+                bnrm   *= scamin / *loc(i,k);
+                xnrm[k] *= scamin / *loc(j,k);
+                scaloc  = zlatrsd3_rmm( *anrm(i,j), xnrm[k], bnrm );
+                if ( scaloc * scamin == 0. ) {
+                    /* The solution cannot be represented; set x to zero. */
+                    scale[k] = 0.;
+                    for( ja = 0; ja < n; ++ja ) {
+                        *X(ja,k) = c_zero;
+                    }
+                    for( ja = 0; ja < nba; ++ja ) {
+                        *loc(ja,k) = 1.;
+                    }
+                    xnrm[k] = 0.;
+                    continue;
+                }
+                scal = (scamin / *loc(i,k)) * scaloc;
+                if ( scal != 1. ) {
+                    blasf77_zdscal( &ii, &scal, X(i1,k), &ione );
+                    *loc(i,k) = scamin * scaloc;
+                }
+                scal = (scamin / *loc(j,k)) * scaloc;
+                if ( scal != 1. ) {
+                    blasf77_zdscal( &len, &scal, X(j1,k), &ione );
+                    *loc(j,k) = scamin * scaloc;
+                }
+                xnrm[k] *= scaloc;
+            }
+
+            if ( notran ) {
+                blasf77_zgemm( "N", "N", &ii, &nrhs, &len,
+                               &c_neg_one, A(i1,j1), &lda,
+                                           X(j1,0),  &ldx,
+                               &c_one,     X(i1,0),  &ldx );
+            }
+            else {
+                blasf77_zgemm( lapack_trans_const( trans ), "N", &ii, &nrhs, &len,
+                               &c_neg_one, A(j1,i1), &lda,
+                                           X(j1,0),  &ldx,
+                               &c_one,     X(i1,0),  &ldx );
+            }
+        }
+    }
+
+    /* Reconcile the local scaling factors, so each column of X has a
+       single scaling factor. */
+    for( k = 0; k < nrhs; ++k ) {
+        s = 1.;
+        for( i = 0; i < nba; ++i ) {
+            s = min( s, *loc(i,k) );
+        }
+        for( i = 0; i < nba; ++i ) {
+            i1 = i*nb;
+            ii = min( i1 + nb, n ) - i1;
+            scal = s / *loc(i,k);
+            if ( scal != 1. ) {
+                blasf77_zdscal( &ii, &scal, X(i1,k), &ione );
+            }
+        }
+        scale[k] *= s;
+    }
+
+cleanup:
+    magma_free_cpu( rwork );
+    magma_free_cpu( lo );
+    magma_free_cpu( Ablk );
+
+    return *info;
+
+    #undef A
+    #undef X
+    #undef Ablk
+    #undef anrm
+    #undef loc
+} /* end zlatrsd3 */
@@ -10,12 +10,232 @@
        
        @precisions normal z -> c
 */
+#include <vector>
+
+#include "thread_queue.hpp"
 #include "magma_timer.h"
 
-#include "magma_internal.h"
+#include "magma_internal.h"  // after thread.hpp, so max, min are defined
 
 #define COMPLEX
 
+// ---------------------------------------------
+// Computes one block of eigenvectors for the parallel back-transform:
+// forms the right-hand sides for eigenvectors k1:k1+nk-1, solves them
+// together with zlatrsd3, back-transforms with GEMM, Y = Q*X,
+// and normalizes the columns of Y.
+// X and Y are n-by-nk workspaces owned by the task; Q is read only.
+// The info returned by zlatrsd3 is stored in *pinfo.
+class magma_ztrevc3_block_task: public magma_task
+{
+public:
+    magma_ztrevc3_block_task(
+        magma_side_t in_side, magma_int_t in_n,
+        const magmaDoubleComplex *in_T, magma_int_t in_ldt,
+        const magmaDoubleComplex *in_Q, magma_int_t in_ldq,
+        magma_int_t in_k1, magma_int_t in_nk,
+        magmaDoubleComplex *in_X, magmaDoubleComplex *in_Y,
+        magma_int_t *in_info
+    ):
+        side( in_side ),
+        n   ( in_n    ),
+        T   ( in_T    ),
+        ldt ( in_ldt  ),
+        Q   ( in_Q    ),
+        ldq ( in_ldq  ),
+        k1  ( in_k1   ),
+        nk  ( in_nk   ),
+        X   ( in_X    ),
+        Y   ( in_Y    ),
+        pinfo( in_info )
+    {}
+    
+    virtual void run()
+    {
+        #define T(i,j)  (T + (i) + (j)*ldt)
+        #define Q(i,j)  (Q + (i) + (j)*ldq)
+        #define X(i,j)  (X + (i) + (j)*n)
+        #define Y(i,j)  (Y + (i) + (j)*n)
+        
+        const magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+        const magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+        const magma_int_t ione = 1;
+        
+        magma_int_t c, ii, k, ki, kmin, n2, info = 0;
+        double remax;
+        magmaDoubleComplex lambda[ nbmax ];
+        magma_int_t order[ nbmax ];
+        double scale[ nbmax ];
+        
+        lapackf77_zlaset( "F", &n, &nk, &c_zero, &c_zero, X, &n );
+        if ( side == MagmaRight ) {
+            // Right eigenvectors: [ T(0:ki-1,0:ki-1) - T(ki,ki) ]*x = scale*b
+            for( c=0; c < nk; ++c ) {
+                ki = k1 + c;
+                for( k=0; k < ki; ++k ) {
+                    *X(k,c) = -(*T(k,ki));
+                }
+                lambda[c] = *T(ki,ki);
+                order[c]  = ki;
+            }
+            n2 = k1 + nk - 1;
+            magma_zlatrsd3( MagmaUpper, MagmaNoTrans, MagmaNonUnit,
+                            n2, nk, T, ldt, lambda, order,
+                            X, n, scale, &info );
+            for( c=0; c < nk; ++c ) {
+                *X(k1+c,c) = MAGMA_Z_MAKE( scale[c], 0. );
+            }
+            n2 = k1 + nk;
+            blasf77_zgemm( "n", "n", &n, &nk, &n2, &c_one,
+                           Q, &ldq,
+                           X, &n, &c_zero,
+                           Y, &n );
+        }
+        else {
+            // Left eigenvectors: [ T(ki+1:n,ki+1:n) - T(ki,ki) ]**H * x = scale*b
+            kmin = k1;
+            for( c=0; c < nk; ++c ) {
+                ki = k1 + c;
+                for( k = ki + 1; k < n; ++k ) {
+                    *X(k,c) = -MAGMA_Z_CONJ( *T(ki,k) );
+                }
+                lambda[c] = *T(ki,ki);
+                order[c]  = n-ki-1;
+            }
+            n2 = n-kmin-1;
+            magma_zlatrsd3( MagmaUpper, MagmaConjTrans, MagmaNonUnit,
+                            n2, nk, T(kmin+1,kmin+1), ldt, lambda, order,
+                            X(kmin+1,0), n, scale, &info );
+            for( c=0; c < nk; ++c ) {
+                *X(k1+c,c) = MAGMA_Z_MAKE( scale[c], 0. );
+            }
+            n2 = n-kmin;
+            blasf77_zgemm( "n", "n", &n, &nk, &n2, &c_one,
+                           Q(0,kmin), &ldq,
+                           X(kmin,0), &n, &c_zero,
+                           Y, &n );
+        }
+        *pinfo = info;
+        
+        // normalize vectors
+        for( c=0; c < nk; ++c ) {
+            ii = blasf77_izamax( &n, Y(0,c), &ione ) - 1;
+            remax = 1. / MAGMA_Z_ABS1( *Y(ii,c) );
+            blasf77_zdscal( &n, &remax, Y(0,c), &ione );
+        }
+        
+        #undef T
+        #undef Q
+        #undef X
+        #undef Y
+    }
+    
+    static const magma_int_t nbmax = 128;
+    
+private:
+    magma_side_t  side;
+    magma_int_t   n;
+    const magmaDoubleComplex *T;
+    magma_int_t   ldt;
+    const magmaDoubleComplex *Q;
+    magma_int_t   ldq;
+    magma_int_t   k1;
+    magma_int_t   nk;
+    magmaDoubleComplex *X;
+    magmaDoubleComplex *Y;
+    magma_int_t *pinfo;
+};
+
+
+/***************************************************************************//**
+    Parallel back-transform for ztrevc3 with howmany = MagmaBacktransVec.
+    Splits the eigenvectors into blocks of nb, each computed by one
+    magma_ztrevc3_block_task, with nthread tasks running at a time.
+    
+    For right eigenvectors, block [k1,k2) reads VR(:,0:k2-1) and overwrites
+    VR(:,k1:k2-1), so blocks are done from the last to the first, nthread at a
+    time, and results are copied to VR only after all tasks in that wave are
+    done. Left eigenvectors go from the first to the last block likewise.
+    
+    pwork has 2*n*nb*nthread entries, for X and Y of each thread.
+    Returns 0, or the first nonzero info from zlatrsd3.
+*******************************************************************************/
+static magma_int_t
+magma_ztrevc3_parallel(
+    magma_int_t rightv, magma_int_t leftv, magma_int_t n,
+    const magmaDoubleComplex *T, magma_int_t ldt,
+    magmaDoubleComplex *VL, magma_int_t ldvl,
+    magmaDoubleComplex *VR, magma_int_t ldvr,
+    magma_int_t nb, magma_int_t nthread,
+    magmaDoubleComplex *pwork )
+{
+    #define VL(i,j)  (VL + (i) + (j)*ldvl)
+    #define VR(i,j)  (VR + (i) + (j)*ldvr)
+    #define X(t)     (pwork + (t)*2*n*nb)
+    #define Y(t)     (pwork + (t)*2*n*nb + n*nb)
+    
+    magma_int_t k1, k2, kend, nk, t, info = 0;
+    std::vector<magma_int_t> tinfo( nthread, 0 );
+    
+    // launch threads -- each single-threaded MKL
+    magma_int_t lapack_nthread = magma_get_lapack_numthreads();
+    magma_set_lapack_numthreads( 1 );
+    magma_thread_queue queue;
+    queue.launch( nthread );
+    
+    if ( rightv ) {
+        kend = n;
+        while ( kend > 0 ) {
+            for( t=0; t < nthread && kend - t*nb > 0; ++t ) {
+                k2 = kend - t*nb;
+                k1 = max( 0, k2 - nb );
+                queue.push_task( new magma_ztrevc3_block_task(
+                    MagmaRight, n, T, ldt, VR, ldvr, k1, k2-k1, X(t), Y(t), &tinfo[t] ));
+            }
+            queue.sync();
+            for( t=0; t < nthread && kend - t*nb > 0; ++t ) {
+                k2 = kend - t*nb;
+                k1 = max( 0, k2 - nb );
+                nk = k2 - k1;
+                info = ( info != 0 ? info : tinfo[t] );
+                lapackf77_zlacpy( "F", &n, &nk, Y(t), &n, VR(0,k1), &ldvr );
+            }
+            kend = max( 0, kend - nthread*nb );
+        }
+    }
+    
+    if ( leftv ) {
+        kend = 0;
+        while ( kend < n ) {
+            for( t=0; t < nthread && kend + t*nb < n; ++t ) {
+                k1 = kend + t*nb;
+                k2 = min( n, k1 + nb );
+                queue.push_task( new magma_ztrevc3_block_task(
+                    MagmaLeft, n, T, ldt, VL, ldvl, k1, k2-k1, X(t), Y(t), &tinfo[t] ));
+            }
+            queue.sync();
+            for( t=0; t < nthread && kend + t*nb < n; ++t ) {
+                k1 = kend + t*nb;
+                k2 = min( n, k1 + nb );
+                nk = k2 - k1;
+                info = ( info != 0 ? info : tinfo[t] );
+                lapackf77_zlacpy( "F", &n, &nk, Y(t), &n, VL(0,k1), &ldvl );
+            }
+            kend = min( n, kend + nthread*nb );
+        }
+    }
+    
+    queue.quit();
+    magma_set_lapack_numthreads( lapack_nthread );
+    
+    #undef VL
+    #undef VR
+    #undef X
+    #undef Y
+    
+    return info;
+}
+
 /***************************************************************************//**
     Purpose
     -------
@@ -140,12 +360,22 @@
     info     INTEGER
        -     = 0:  successful exit
        -     < 0:  if info = -i, the i-th argument had an illegal value
+       -     otherwise, the nonzero info from magma_zlatrsd3 in the blocked
+                   back-transform, e.g., MAGMA_ERR_HOST_ALLOC
 
     Further Details
     ---------------
     The algorithm used in this program is basically backward (forward)
     substitution, with scaling to make the the code robust against
     possible overflow.
+    When back-transforming with the blocked version, the triangular
+    systems for a block of nb eigenvectors are solved together by
+    magma_zlatrsd3, using Level 3 BLAS, instead of one at a time by zlatrs.
+    If magma_get_ztrevc3_nthread( n ) > 1, the blocks are computed and
+    back-transformed in parallel by that many threads, which needs an
+    extra 2*n*nb*nthread workspace, allocated internally; if it cannot be
+    allocated, the single-threaded path is used.
+    See also magma_ztrevc3_mt, which always uses multiple threads.
     
     Each eigenvector is normalized so that the element of largest
     magnitude has magnitude 1; here the magnitude of a complex number
@@ -180,10 +410,16 @@ magma_int_t magma_ztrevc3(
     const magma_int_t  ione = 1;
     
     // .. Local Scalars ..
-    magma_int_t            allv, bothv, leftv, over, rightv, somev;
-    magma_int_t            i, ii, is, j, k, ki, iv, n2, nb, nb2, version;
+    magma_int_t            allv, bothv, leftv, over, rightv, somev, blocked;
+    magma_int_t            i, ii, iinfo, is, j, k, ki, iv, n2, nb, nb2, nthread, version;
     double                 ovfl, remax, scale, smin, smlnum, ulp, unfl;
     
+    // Eigenvalues, orders, and scale factors for the block of
+    // triangular systems solved by zlatrsd3 (blocked version).
+    magmaDoubleComplex     lambda[nbmax+1];
+    magma_int_t            order[nbmax+1];
+    double                 scalev[nbmax+1];
+    
     // Decode and test the input parameters
     bothv  = (side == MagmaBothSides);
     rightv = (side == MagmaRight) || bothv;
@@ -250,6 +486,25 @@ magma_int_t magma_ztrevc3(
     else {
         version = 1;
     }
+    // The blocked back-transform solves the triangular systems of a block
+    // of vectors together with zlatrsd3, when the GEMM is done.
+    blocked = (over && version == 2);
+
+    // Parallel blocked back-transform, if there are enough eigenvectors.
+    nthread = 1;
+    if ( blocked ) {
+        nthread = min( magma_get_ztrevc3_nthread( n ), magma_ceildiv( n, nb ));
+    }
+    if ( nthread > 1 ) {
+        magmaDoubleComplex *pwork;
+        if ( MAGMA_SUCCESS == magma_zmalloc_cpu( &pwork, 2*n*nb*nthread )) {
+            *info = magma_ztrevc3_parallel( rightv, leftv, n, T, ldt, VL, ldvl, VR, ldvr,
+                                            nb, nthread, pwork );
+            magma_free_cpu( pwork );
+            return *info;
+        }
+        // else fall back to single-threaded version
+    }
 
     // Set the constants to control overflow.
     unfl = lapackf77_dlamch( "Safe minimum" );
@@ -304,20 +559,27 @@ magma_int_t magma_ztrevc3(
                 *work(k,iv) = -(*T(k,ki));
             }
 
-            // Solve upper triangular system:
-            // [ T(1:ki-1,1:ki-1) - T(ki,ki) ]*X = scale*work.
-            for( k=0; k < ki; ++k ) {
-                *T(k,k) = *T(k, k) - *T(ki,ki);
-                if ( MAGMA_Z_ABS1( *T(k,k) ) < smin ) {
-                    *T(k,k) = MAGMA_Z_MAKE( smin, 0. );
-                }
+            if ( blocked ) {
+                // Defer the solve to zlatrsd3, below.
+                lambda[iv] = *T(ki,ki);
+                order[iv]  = ki;
             }
+            else {
+                // Solve upper triangular system:
+                // [ T(1:ki-1,1:ki-1) - T(ki,ki) ]*X = scale*work.
+                for( k=0; k < ki; ++k ) {
+                    *T(k,k) = *T(k, k) - *T(ki,ki);
+                    if ( MAGMA_Z_ABS1( *T(k,k) ) < smin ) {
+                        *T(k,k) = MAGMA_Z_MAKE( smin, 0. );
+                    }
+                }
 
-            if ( ki > 0 ) {
-                lapackf77_zlatrs( "Upper", "No transpose", "Non-unit", "Y",
-                                  &ki, T, &ldt,
-                                  work(0,iv), &scale, rwork, info );
-                *work(ki,iv) = MAGMA_Z_MAKE( scale, 0. );
+                if ( ki > 0 ) {
+                    lapackf77_zlatrs( "Upper", "No transpose", "Non-unit", "Y",
+                                      &ki, T, &ldt,
+                                      work(0,iv), &scale, rwork, info );
+                    *work(ki,iv) = MAGMA_Z_MAKE( scale, 0. );
+                }
             }
 
             // Copy the vector x or Q*x to VR and normalize.
@@ -364,9 +626,24 @@ magma_int_t magma_ztrevc3(
                 // When the number of vectors stored reaches nb,
                 // or if this was last vector, do the GEMM
                 if ( (iv == 1) || (ki == 0) ) {
+                    // Solve the triangular systems for columns iv:nb:
+                    // [ T(1:k-1,1:k-1) - T(k,k) ]*X = scale*work,
+                    // where k = order(iv:nb) = ki:ki+nb-iv.
+                    nb2 = nb-iv+1;
+                    n2  = ki+nb-iv;
+                    magma_zlatrsd3( MagmaUpper, MagmaNoTrans, MagmaNonUnit,
+                                    n2, nb2, T, ldt, &lambda[iv], &order[iv],
+                                    work(0,iv), n, &scalev[iv], &iinfo );
+                    if ( iinfo != 0 ) {
+                        *info = iinfo;
+                        return *info;
+                    }
+                    for( k = iv; k <= nb; ++k ) {
+                        *work(order[k],k) = MAGMA_Z_MAKE( scalev[k], 0. );
+                    }
+                    
                     time_trsv_sum += timer_stop( time_trsv );
                     timer_start( time_gemm );
-                    nb2 = nb-iv+1;
                     n2  = ki+nb-iv+1;
                     blasf77_zgemm( "n", "n", &n, &nb2, &n2, &c_one,
                                    VR, &ldvr,
@@ -391,8 +668,10 @@ magma_int_t magma_ztrevc3(
             } // blocked back-transform
 
             // Restore the original diagonal elements of T.
-            for( k=0; k <= ki - 1; ++k ) {
-                *T(k,k) = *work(k,0);
+            if ( ! blocked ) {
+                for( k=0; k <= ki - 1; ++k ) {
+                    *T(k,k) = *work(k,0);
+                }
             }
 
             is -= 1;
@@ -430,21 +709,28 @@ magma_int_t magma_ztrevc3(
                 *work(k,iv) = -MAGMA_Z_CONJ( *T(ki,k) );
             }
 
-            // Solve conjugate-transposed triangular system:
-            // [ T(ki+1:n,ki+1:n) - T(ki,ki) ]**H * X = scale*work.
-            for( k = ki + 1; k < n; ++k ) {
-                *T(k,k) = *T(k, k) - *T(ki,ki);
-                if ( MAGMA_Z_ABS1( *T(k,k) ) < smin ) {
-                    *T(k,k) = MAGMA_Z_MAKE( smin, 0. );
-                }
+            if ( blocked ) {
+                // Defer the solve to zlatrsd3, below.
+                lambda[iv] = *T(ki,ki);
+                order[iv]  = n-ki-1;
             }
+            else {
+                // Solve conjugate-transposed triangular system:
+                // [ T(ki+1:n,ki+1:n) - T(ki,ki) ]**H * X = scale*work.
+                for( k = ki + 1; k < n; ++k ) {
+                    *T(k,k) = *T(k, k) - *T(ki,ki);
+                    if ( MAGMA_Z_ABS1( *T(k,k) ) < smin ) {
+                        *T(k,k) = MAGMA_Z_MAKE( smin, 0. );
+                    }
+                }
 
-            if ( ki < n-1 ) {
-                n2 = n-ki-1;
-                lapackf77_zlatrs( "Upper", "Conjugate transpose", "Non-unit", "Y",
-                                  &n2, T(ki+1,ki+1), &ldt,
-                                  work(ki+1,iv), &scale, rwork, info );
-                *work(ki,iv) = MAGMA_Z_MAKE( scale, 0. );
+                if ( ki < n-1 ) {
+                    n2 = n-ki-1;
+                    lapackf77_zlatrs( "Upper", "Conjugate transpose", "Non-unit", "Y",
+                                      &n2, T(ki+1,ki+1), &ldt,
+                                      work(ki+1,iv), &scale, rwork, info );
+                    *work(ki,iv) = MAGMA_Z_MAKE( scale, 0. );
+                }
             }
 
             // Copy the vector x or Q*x to VL and normalize.
@@ -489,6 +775,22 @@ magma_int_t magma_ztrevc3(
                 // When the number of vectors stored reaches nb,
                 // or if this was last vector, do the GEMM
                 if ( (iv == nb) || (ki == n-1) ) {
+                    // Solve the conjugate-transposed triangular systems
+                    // for columns 1:iv:
+                    // [ T(k+1:n,k+1:n) - T(k,k) ]**H * X = scale*work,
+                    // where k = ki-iv+1:ki, in one call on T(ki-iv+2:n, ki-iv+2:n).
+                    n2 = n-(ki-iv+1)-1;
+                    magma_zlatrsd3( MagmaUpper, MagmaConjTrans, MagmaNonUnit,
+                                    n2, iv, T(ki-iv+2,ki-iv+2), ldt, &lambda[1], &order[1],
+                                    work(ki-iv+2,1), n, &scalev[1], &iinfo );
+                    if ( iinfo != 0 ) {
+                        *info = iinfo;
+                        return *info;
+                    }
+                    for( k=1; k <= iv; ++k ) {
+                        *work(n-order[k]-1,k) = MAGMA_Z_MAKE( scalev[k], 0. );
+                    }
+                    
                     n2 = n-(ki+1)+iv;
                     blasf77_zgemm( "n", "n", &n, &iv, &n2, &c_one,
                                    VL(0,ki-iv+1), &ldvl,
@@ -509,8 +811,10 @@ magma_int_t magma_ztrevc3(
             } // blocked back-transform
 
             // Restore the original diagonal elements of T.
-            for( k = ki + 1; k < n; ++k ) {
-                *T(k,k) = *work(k,0);
+            if ( ! blocked ) {
+                for( k = ki + 1; k < n; ++k ) {
+                    *T(k,k) = *work(k,0);
+                }
             }
 
             is += 1;
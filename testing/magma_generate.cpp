@@ -15,11 +15,16 @@
 #include <vector>
 #include <limits>
 
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>  // getpid
+
 #include "magma_v2.h"
 #include "magma_lapack.hpp"  // experimental C++ bindings
 #include "magma_operators.h"
 
 #include "magma_matrix.hpp"
+#include "../control/magma_philox.h"  // magma_philox_next_seed
 
 // last (defines macros that conflict with std headers)
 #include "testings.h"
@@ -50,6 +55,7 @@ enum class MatrixType {
     heev,
     geev,
     geevx,
+    cached,     // loaded from opts.matrix_cache
 };
 
 enum class Dist {
@@ -98,6 +104,224 @@ inline bool contains( std::string const &str, std::string const &pattern )
 }
 
 
+/******************************************************************************/
+// larnv_skip overloads, for templates.
+inline void magma_larnv_skip(
+    magma_int_t idist, const magma_int_t iseed[4],
+    magma_int_t offset, magma_int_t n, float* x )
+{
+    magma_slarnv_skip( idist, iseed, offset, n, x );
+}
+
+inline void magma_larnv_skip(
+    magma_int_t idist, const magma_int_t iseed[4],
+    magma_int_t offset, magma_int_t n, double* x )
+{
+    magma_dlarnv_skip( idist, iseed, offset, n, x );
+}
+
+inline void magma_larnv_skip(
+    magma_int_t idist, const magma_int_t iseed[4],
+    magma_int_t offset, magma_int_t n, magmaFloatComplex* x )
+{
+    magma_clarnv_skip( idist, iseed, offset, n, x );
+}
+
+inline void magma_larnv_skip(
+    magma_int_t idist, const magma_int_t iseed[4],
+    magma_int_t offset, magma_int_t n, magmaDoubleComplex* x )
+{
+    magma_zlarnv_skip( idist, iseed, offset, n, x );
+}
+
+/******************************************************************************/
+// Fills m-by-n A with random entries, in parallel, and advances iseed.
+// idist is as in larnv: 1 uniform (0, 1), 2 uniform (-1, 1), 3 normal (0, 1).
+// Entry (i, j) is element i + j*m of the magma_zlarnv stream, so the result
+// does not depend on lda or the number of threads, but differs from LAPACK.
+template< typename FloatT >
+void magma_generate_rand_fill(
+    magma_int_t idist, magma_int_t iseed[4],
+    magma_int_t m, magma_int_t n, FloatT* A, magma_int_t lda )
+{
+    if (lda == m) {
+        magma_larnv_skip( idist, iseed, 0, m*n, A );
+    }
+    else {
+        for (magma_int_t j = 0; j < n; ++j) {
+            magma_larnv_skip( idist, iseed, j*m, m, &A[ j*lda ] );
+        }
+    }
+    magma_philox_next_seed( iseed );
+}
+
+/******************************************************************************/
+// Generates k random Householder vectors in m-by-k U, with scalars in tau,
+// so Q = H_1 ... H_k is a random unitary matrix (Stewart, 1980).
+// Just makes each random column into a Householder vector;
+// no need to update subsequent columns (as in geqrf), so columns are
+// independent and generated in parallel.
+template< typename FloatT >
+void magma_generate_householder(
+    magma_opts& opts,
+    Matrix<FloatT>& U,
+    Vector<FloatT>& tau )
+{
+    magma_generate_rand_fill( idist_randn, opts.iseed, U.m, U.n, U(0,0), U.ld );
+
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (magma_int_t j = 0; j < U.n; ++j) {
+        magma_int_t mj = U.m - j;
+        lapack::larfg( mj, U(j,j), U(j+1,j), 1, tau(j) );
+    }
+}
+
+/******************************************************************************/
+// Computes A = Q A P^H, where Q = H_1 ... H_k is given by Householder vectors
+// in U and tauU, P likewise by V and tauV, and on input A is diagonal (A is
+// m-by-n, U is m-by-k, V is n-by-k). For heev, V and U are the same.
+//
+// Applies blocks of nb reflectors on both sides from the innermost block
+// out, i.e., A = B_1 (... (B_last A B_last^H) ...) B_1^H, using larfb.
+// As A starts diagonal, block j only touches the trailing matrix
+// A(j:m, j:n), which takes about 2/3 the flops of two full unmqr.
+template< typename FloatT >
+void magma_generate_apply(
+    Matrix<FloatT>& U, Vector<FloatT>& tauU,
+    Matrix<FloatT>& V, Vector<FloatT>& tauV,
+    Matrix<FloatT>& A )
+{
+    const magma_int_t nb = 128;
+
+    magma_int_t m = A.m;
+    magma_int_t n = A.n;
+    magma_int_t k = U.n;
+    magma_int_t ldwork = max( m, n );
+    Matrix<FloatT> T( nb, nb );
+    Matrix<FloatT> work( ldwork, nb );
+
+    for (magma_int_t j = ((k - 1) / nb) * nb; j >= 0; j -= nb) {
+        magma_int_t jb = min( nb, k - j );
+
+        // A(j:m, j:n) = B_j A(j:m, j:n), from the left with U
+        lapack::larft( "Forward", "Columnwise", m - j, jb,
+                       U(j,j), U.ld, tauU(j), T(0,0), T.ld );
+        lapack::larfb( "Left", "NoTrans", "Forward", "Columnwise",
+                       m - j, n - j, jb, U(j,j), U.ld, T(0,0), T.ld,
+                       A(j,j), A.ld, work(0,0), ldwork );
+
+        // A(j:m, j:n) = A(j:m, j:n) C_j^H, from the right with V
+        lapack::larft( "Forward", "Columnwise", n - j, jb,
+                       V(j,j), V.ld, tauV(j), T(0,0), T.ld );
+        lapack::larfb( "Right", "ConjTrans", "Forward", "Columnwise",
+                       m - j, n - j, jb, V(j,j), V.ld, T(0,0), T.ld,
+                       A(j,j), A.ld, work(0,0), ldwork );
+    }
+}
+
+/******************************************************************************/
+// Cache file for a generated matrix, in opts.matrix_cache. The name holds the
+// key (matrix type, size, cond, condD, seed on entry, precision); the file
+// holds a header, sigma, then the m-by-n matrix column by column.
+struct cache_header {
+    char    magic[8];   // "MAGMAGEN"
+    int64_t m, n, elem_size;
+    int64_t iseed[4];   // seed after generation
+};
+
+template< typename FloatT >
+std::string magma_generate_cache_name(
+    magma_opts& opts, magma_int_t m, magma_int_t n )
+{
+    typedef typename blas::traits<FloatT>::real_t real_t;
+    bool is_complex = (sizeof(FloatT) == 2*sizeof(real_t));
+    char precision = (sizeof(real_t) == sizeof(float)
+                      ? (is_complex ? 'c' : 's')
+                      : (is_complex ? 'z' : 'd'));
+    char buf[ 1024 ];
+    snprintf( buf, sizeof(buf), "%s/%s_%lldx%lld_cond%.6g_condD%.6g_seed%lld-%lld-%lld-%lld.%c",
+              opts.matrix_cache.c_str(), opts.matrix.c_str(),
+              (long long) m, (long long) n, opts.cond, opts.condD,
+              (long long) opts.iseed[0], (long long) opts.iseed[1],
+              (long long) opts.iseed[2], (long long) opts.iseed[3], precision );
+    return buf;
+}
+
+/******************************************************************************/
+// Reads A and sigma from the cache file, and sets opts.iseed as if the matrix
+// were generated. Returns false if the file is missing or doesn't match.
+template< typename FloatT >
+bool magma_generate_cache_read(
+    magma_opts& opts, const std::string& filename,
+    Matrix<FloatT>& A,
+    Vector< typename blas::traits<FloatT>::real_t >& sigma )
+{
+    typedef typename blas::traits<FloatT>::real_t real_t;
+
+    FILE* file = fopen( filename.c_str(), "rb" );
+    if (file == NULL) {
+        return false;
+    }
+    cache_header header;
+    bool okay = (fread( &header, sizeof(header), 1, file ) == 1
+                 && memcmp( header.magic, "MAGMAGEN", 8 ) == 0
+                 && header.m == A.m && header.n == A.n
+                 && header.elem_size == int64_t( sizeof(FloatT) ));
+    if (okay) {
+        okay = (fread( sigma(0), sizeof(real_t), sigma.n, file ) == size_t( sigma.n ));
+    }
+    for (magma_int_t j = 0; okay && j < A.n; ++j) {
+        okay = (fread( A(0,j), sizeof(FloatT), A.m, file ) == size_t( A.m ));
+    }
+    fclose( file );
+    if (okay) {
+        for (int i = 0; i < 4; ++i) {
+            opts.iseed[i] = magma_int_t( header.iseed[i] );
+        }
+    }
+    return okay;
+}
+
+/******************************************************************************/
+// Writes A, sigma, and opts.iseed to the cache file. Writes a temporary file
+// and renames it, so concurrent testers never read a partial file.
+template< typename FloatT >
+void magma_generate_cache_write(
+    magma_opts& opts, const std::string& filename,
+    Matrix<FloatT>& A,
+    Vector< typename blas::traits<FloatT>::real_t >& sigma )
+{
+    typedef typename blas::traits<FloatT>::real_t real_t;
+
+    std::string tmp = filename + ".tmp" + std::to_string( (long long) getpid() );
+    FILE* file = fopen( tmp.c_str(), "wb" );
+    if (file == NULL) {
+        fprintf( stderr, "%sWarning: cannot write matrix cache %s%s\n",
+                 ansi_red, tmp.c_str(), ansi_normal );
+        return;
+    }
+    cache_header header;
+    memcpy( header.magic, "MAGMAGEN", 8 );
+    header.m = A.m;
+    header.n = A.n;
+    header.elem_size = sizeof(FloatT);
+    for (int i = 0; i < 4; ++i) {
+        header.iseed[i] = opts.iseed[i];
+    }
+    bool okay = (fwrite( &header, sizeof(header), 1, file ) == 1);
+    okay = okay && (fwrite( sigma(0), sizeof(real_t), sigma.n, file ) == size_t( sigma.n ));
+    for (magma_int_t j = 0; okay && j < A.n; ++j) {
+        okay = (fwrite( A(0,j), sizeof(FloatT), A.m, file ) == size_t( A.m ));
+    }
+    okay = (fclose( file ) == 0) && okay;
+    if (! okay || rename( tmp.c_str(), filename.c_str() ) != 0) {
+        fprintf( stderr, "%sWarning: cannot write matrix cache %s%s\n",
+                 ansi_red, filename.c_str(), ansi_normal );
+        remove( tmp.c_str() );
+    }
+}
+
+
 /******************************************************************************/
 template< typename FloatT >
 void magma_generate_sigma(
@@ -291,31 +515,13 @@ void magma_generate_svd(
     typedef typename blas::traits<FloatT>::real_t real_t;
 
     // locals
-    FloatT tmp;
     magma_int_t m = A.m;
     magma_int_t n = A.n;
-    magma_int_t maxmn = max( m, n );
     magma_int_t minmn = min( m, n );
-    magma_int_t sizeU;
-    magma_int_t info = 0;
-    Matrix<FloatT> U( maxmn, minmn );
-    Vector<FloatT> tau( minmn );
-
-    // query for workspace
-    magma_int_t lwork = -1;
-    lapack::unmqr( "Left", "NoTrans", A.m, A.n, minmn,
-                   U(0,0), U.ld, tau(0), A(0,0), A.ld,
-                   &tmp, lwork, &info );
-    assert( info == 0 );
-    lwork = magma_int_t( real( tmp ));
-    magma_int_t lwork2 = -1;
-    lapack::unmqr( "Right", "ConjTrans", A.m, A.n, minmn,
-                   U(0,0), U.ld, tau(0), A(0,0), A.ld,
-                   &tmp, lwork2, &info );
-    assert( info == 0 );
-    lwork2 = magma_int_t( real( tmp ));
-    lwork = max( lwork, lwork2 );
-    Vector<FloatT> work( lwork );
+    Matrix<FloatT> U( m, minmn );
+    Matrix<FloatT> V( n, minmn );
+    Vector<FloatT> tauU( minmn );
+    Vector<FloatT> tauV( minmn );
 
     // ----------
     magma_generate_sigma( opts, dist, false, cond, sigma_max, A, sigma );
@@ -332,34 +538,12 @@ void magma_generate_svd(
         }
     }
 
-    // random U, m-by-minmn
-    // just make each random column into a Householder vector;
-    // no need to update subsequent columns (as in geqrf).
-    sizeU = U.size();
-    lapack::larnv( idist_randn, opts.iseed, sizeU, U(0,0) );
-    for (magma_int_t j = 0; j < minmn; ++j) {
-        magma_int_t mj = m - j;
-        lapack::larfg( mj, U(j,j), U(j+1,j), 1, tau(j) );
-    }
-
-    // A = U*A
-    lapack::unmqr( "Left", "NoTrans", A.m, A.n, minmn,
-                   U(0,0), U.ld, tau(0), A(0,0), A.ld,
-                   work(0), lwork, &info );
-    assert( info == 0 );
+    // random U, m-by-minmn, and V, n-by-minmn
+    magma_generate_householder( opts, U, tauU );
+    magma_generate_householder( opts, V, tauV );
 
-    // random V, n-by-minmn (stored column-wise in U)
-    lapack::larnv( idist_randn, opts.iseed, sizeU, U(0,0) );
-    for (magma_int_t j = 0; j < minmn; ++j) {
-        magma_int_t nj = n - j;
-        lapack::larfg( nj, U(j,j), U(j+1,j), 1, tau(j) );
-    }
-
-    // A = A*V^H
-    lapack::unmqr( "Right", "ConjTrans", A.m, A.n, minmn,
-                   U(0,0), U.ld, tau(0), A(0,0), A.ld,
-                   work(0), lwork, &info );
-    assert( info == 0 );
+    // A = U*A*V^H
+    magma_generate_apply( U, tauU, V, tauV, A );
 
     if (condD != 1) {
         // A = A*W, W orthogonal, such that A has unit column norms
@@ -406,53 +590,18 @@ void magma_generate_heev(
     assert( A.m == A.n );
 
     // locals
-    FloatT tmp;
     magma_int_t n = A.n;
-    magma_int_t sizeU;
-    magma_int_t info = 0;
     Matrix<FloatT> U( n, n );
     Vector<FloatT> tau( n );
 
-    // query for workspace
-    magma_int_t lwork = -1;
-    lapack::unmqr( "Left", "NoTrans", n, n, n,
-                   U(0,0), U.ld, tau(0), A(0,0), A.ld,
-                   &tmp, lwork, &info );
-    assert( info == 0 );
-    lwork = magma_int_t( real( tmp ));
-    magma_int_t lwork2 = -1;
-    lapack::unmqr( "Right", "ConjTrans", n, n, n,
-                   U(0,0), U.ld, tau(0), A(0,0), A.ld,
-                   &tmp, lwork2, &info );
-    assert( info == 0 );
-    lwork2 = magma_int_t( real( tmp ));
-    lwork = max( lwork, lwork2 );
-    Vector<FloatT> work( lwork );
-
     // ----------
     magma_generate_sigma( opts, dist, rand_sign, cond, sigma_max, A, sigma );
 
     // random U, n-by-n
-    // just make each random column into a Householder vector;
-    // no need to update subsequent columns (as in geqrf).
-    sizeU = U.size();
-    lapack::larnv( idist_randn, opts.iseed, sizeU, U(0,0) );
-    for (magma_int_t j = 0; j < n; ++j) {
-        magma_int_t nj = n - j;
-        lapack::larfg( nj, U(j,j), U(j+1,j), 1, tau(j) );
-    }
-
-    // A = U*A
-    lapack::unmqr( "Left", "NoTrans", n, n, n,
-                   U(0,0), U.ld, tau(0), A(0,0), A.ld,
-                   work(0), lwork, &info );
-    assert( info == 0 );
-
-    // A = A*U^H
-    lapack::unmqr( "Right", "ConjTrans", n, n, n,
-                   U(0,0), U.ld, tau(0), A(0,0), A.ld,
-                   work(0), lwork, &info );
-    assert( info == 0 );
+    magma_generate_householder( opts, U, tau );
+
+    // A = U*A*U^H
+    magma_generate_apply( U, tau, U, tau, A );
 
     // make diagonal real
     // usually LAPACK ignores imaginary part anyway, but Matlab doesn't
@@ -609,6 +758,15 @@ void magma_generate_geevx(
     contains the singular or eigenvalues of A0, not of A.
     See: Demmel and Veselic, Jacobi's method is more accurate than QR, 1992.
 
+    Random entries (rand*, and U and V) come from a counter-based generator
+    seeded by opts.iseed and are generated in parallel; the matrix is the
+    same for any number of threads. U and V are applied in blocks, using
+    that Sigma is diagonal.
+
+    If opts.matrix_cache is set (--matrix-cache), svd, poev, and heev matrices
+    are saved there, keyed by matrix name, size, cond, condD, opts.iseed, and
+    precision, and loaded instead of generated on later runs.
+
     @ingroup testing
 *******************************************************************************/
 template< typename FloatT >
@@ -731,6 +889,19 @@ void magma_generate_matrix(
     else if (contains( name, "_ufl"    )) { sigma_max = ufl; }
     else if (contains( name, "_ofl"    )) { sigma_max = ofl; }
 
+    // ----- load from cache; only for types that are expensive to generate
+    std::string cache_name;
+    if (! opts.matrix_cache.empty()
+        && (type == MatrixType::svd
+            || type == MatrixType::poev
+            || type == MatrixType::heev))
+    {
+        cache_name = magma_generate_cache_name<FloatT>( opts, A.m, A.n );
+        if (magma_generate_cache_read( opts, cache_name, A, sigma )) {
+            type = MatrixType::cached;
+        }
+    }
+
     // ----- generate matrix
     switch (type) {
         case MatrixType::zero:
@@ -764,11 +935,12 @@ void magma_generate_matrix(
         case MatrixType::rands:
         case MatrixType::randn: {
             magma_int_t idist = (magma_int_t) type;
-            magma_int_t sizeA = A.ld * A.n;
-            lapack::larnv( idist, opts.iseed, sizeA, A(0,0) );
+            magma_generate_rand_fill( idist, opts.iseed, A.m, A.n, A(0,0), A.ld );
             if (sigma_max != 1) {
                 FloatT scale = blas::traits<FloatT>::make( sigma_max, 0 );
-                blas::scal( sizeA, scale, A(0,0), 1 );
+                for (magma_int_t j = 0; j < A.n; ++j) {
+                    blas::scal( A.m, scale, A(0,j), 1 );
+                }
             }
             break;
         }
@@ -796,6 +968,13 @@ void magma_generate_matrix(
         case MatrixType::geevx:
             magma_generate_geevx( opts, dist, cond, condD, sigma_max, A, sigma );
             break;
+
+        case MatrixType::cached:
+            break;
+    }
+
+    if (! cache_name.empty() && type != MatrixType::cached) {
+        magma_generate_cache_write( opts, cache_name, A, sigma );
     }
 
     if (contains( name, "_dominant" )) {
@@ -0,0 +1,431 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       Timing statistics and machine-readable (JSON, CSV) output for testers.
+*/
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(MAGMA_WITH_MKL)
+#include <mkl_service.h>
+#endif
+
+#include "magma_v2.h"
+#include "testings.h"
+
+#include "../control/magma_threadsetting.h"  // internal header
+
+
+// =============================================================================
+// magma_timing
+
+// -----------------------------------------------------------------------------
+double magma_timing::minimum() const
+{
+    if ( times.empty() )
+        return NAN;
+    return *std::min_element( times.begin(), times.end() );
+}
+
+// -----------------------------------------------------------------------------
+double magma_timing::median() const
+{
+    if ( times.empty() )
+        return NAN;
+    std::vector< double > sorted( times );
+    std::sort( sorted.begin(), sorted.end() );
+    size_t n = sorted.size();
+    return (n % 2 == 1 ? sorted[ n/2 ] : 0.5*(sorted[ n/2 - 1 ] + sorted[ n/2 ]));
+}
+
+// -----------------------------------------------------------------------------
+double magma_timing::mean() const
+{
+    if ( times.empty() )
+        return NAN;
+    double sum = 0;
+    for( size_t i = 0; i < times.size(); ++i ) {
+        sum += times[i];
+    }
+    return sum / times.size();
+}
+
+// -----------------------------------------------------------------------------
+// sample standard deviation; 0 for a single run
+double magma_timing::stddev() const
+{
+    if ( times.size() < 2 )
+        return 0;
+    double avg = mean();
+    double sum = 0;
+    for( size_t i = 0; i < times.size(); ++i ) {
+        sum += (times[i] - avg) * (times[i] - avg);
+    }
+    return sqrt( sum / (times.size() - 1) );
+}
+
+// -----------------------------------------------------------------------------
+const magma_counters_t* magma_timing::fastest_counters() const
+{
+    if ( counters.size() != times.size() || times.empty() )
+        return NULL;
+    size_t i = std::min_element( times.begin(), times.end() ) - times.begin();
+    return &counters[ i ];
+}
+
+
+// =============================================================================
+// magma_results
+
+// -----------------------------------------------------------------------------
+// Returns str with JSON escapes for quotes, backslashes, and control characters.
+static std::string json_escape( const std::string& str )
+{
+    std::string out;
+    for( size_t i = 0; i < str.size(); ++i ) {
+        char c = str[i];
+        if ( c == '"' || c == '\\' ) {
+            out += '\\';
+            out += c;
+        }
+        else if ( (unsigned char) c < 0x20 ) {
+            char buf[8];
+            snprintf( buf, sizeof(buf), "\\u%04x", (unsigned char) c );
+            out += buf;
+        }
+        else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// Returns str quoted for CSV if it contains a comma, quote, or newline.
+static std::string csv_escape( const std::string& str )
+{
+    if ( str.find_first_of( ",\"\n" ) == std::string::npos )
+        return str;
+    std::string out = "\"";
+    for( size_t i = 0; i < str.size(); ++i ) {
+        if ( str[i] == '"' )
+            out += '"';
+        out += str[i];
+    }
+    out += '"';
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// Returns CPU model name from /proc/cpuinfo, or "unknown".
+static std::string cpu_model()
+{
+    std::string model = "unknown";
+    FILE* f = fopen( "/proc/cpuinfo", "r" );
+    if ( f != NULL ) {
+        char line[ 1024 ];
+        while( fgets( line, sizeof(line), f ) != NULL ) {
+            if ( strncmp( line, "model name", 10 ) == 0 ) {
+                char* val = strchr( line, ':' );
+                if ( val != NULL ) {
+                    val += 1;
+                    while( *val == ' ' || *val == '\t' ) {
+                        val += 1;
+                    }
+                    val[ strcspn( val, "\n" ) ] = '\0';
+                    model = val;
+                }
+                break;
+            }
+        }
+        fclose( f );
+    }
+    return model;
+}
+
+// -----------------------------------------------------------------------------
+// Returns name of the GPU device, or "unknown".
+static std::string device_name( magma_int_t device )
+{
+    std::string name = "unknown";
+    #if defined(MAGMA_HAVE_CUDA)
+        cudaDeviceProp prop;
+        if ( cudaGetDeviceProperties( &prop, int(device) ) == cudaSuccess ) {
+            name = prop.name;
+        }
+    #elif defined(MAGMA_HAVE_HIP)
+        hipDeviceProp_t prop;
+        if ( hipGetDeviceProperties( &prop, int(device) ) == hipSuccess ) {
+            name = prop.name;
+        }
+    #endif
+    return name;
+}
+
+// -----------------------------------------------------------------------------
+// Returns BLAS library and version, as in magma_print_environment.
+static std::string blas_vendor()
+{
+    char buf[ 128 ];
+    #if defined(MAGMA_WITH_MKL)
+        MKLVersion mkl_version;
+        mkl_get_version( &mkl_version );
+        snprintf( buf, sizeof(buf), "MKL %d.%d.%d",
+                  mkl_version.MajorVersion,
+                  mkl_version.MinorVersion,
+                  mkl_version.UpdateVersion );
+    #elif defined(MAGMA_WITH_ACML)
+        int acml_major, acml_minor, acml_patch, acml_build;
+        acmlversion( &acml_major, &acml_minor, &acml_patch, &acml_build );
+        snprintf( buf, sizeof(buf), "ACML %d.%d.%d.%d",
+                  acml_major, acml_minor, acml_patch, acml_build );
+    #else
+        snprintf( buf, sizeof(buf), "unknown" );
+    #endif
+    return buf;
+}
+
+
+// -----------------------------------------------------------------------------
+// Opens opts.output_file and writes the metadata. For --output text, does nothing.
+magma_results::magma_results( magma_opts& opts, const char* routine_ ):
+    output( opts.output ),
+    counters( opts.counters ),
+    file( NULL ),
+    routine( routine_ ),
+    nrows( 0 )
+{
+    if ( output == MagmaOutputText )
+        return;
+
+    file = fopen( opts.output_file.c_str(), "w" );
+    if ( file == NULL ) {
+        fprintf( stderr, "error: cannot open %s for --output\n",
+                 opts.output_file.c_str() );
+        exit(1);
+    }
+    write_header( opts );
+}
+
+
+// -----------------------------------------------------------------------------
+// Closes the JSON array and object, and the file.
+magma_results::~magma_results()
+{
+    if ( file == NULL )
+        return;
+
+    if ( output == MagmaOutputJson ) {
+        fprintf( file, "%s  ]\n}\n", (nrows > 0 ? "\n" : "") );
+    }
+    fclose( file );
+}
+
+
+// -----------------------------------------------------------------------------
+void magma_results::write_header( magma_opts& opts )
+{
+    magma_int_t major, minor, micro;
+    magma_version( &major, &minor, &micro );
+    char version[ 64 ];
+    snprintf( version, sizeof(version), "%lld.%lld.%lld %s",
+              (long long) major, (long long) minor, (long long) micro,
+              MAGMA_VERSION_STAGE );
+
+    int omp_threads = 1;
+    #ifdef _OPENMP
+        omp_threads = omp_get_max_threads();
+    #endif
+
+    time_t now = time( NULL );
+    char date[ 64 ];
+    strftime( date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime( &now ));
+
+    char ints[ 32 ];
+    snprintf( ints, sizeof(ints), "%lld", (long long) (8*sizeof(magma_int_t)) );
+
+    // key, value, quoted
+    const int nmeta = 10;
+    std::string meta[ nmeta ][ 2 ] = {
+        { "magma_version",  version },
+        { "platform",       g_platform_str },
+        { "device",         device_name( opts.device ) },
+        { "cpu",            cpu_model() },
+        { "omp_threads",    std::to_string( omp_threads ) },
+        { "lapack_threads", std::to_string( magma_get_lapack_numthreads() ) },
+        { "blas",           blas_vendor() },
+        { "int_bits",       ints },
+        { "repeat",         std::to_string( (long long) opts.repeat ) },
+        { "date",           date },
+    };
+    bool numeric[ nmeta ] = { false, false, false, false, true, true, false, true, true, false };
+
+    if ( output == MagmaOutputJson ) {
+        fprintf( file, "{\n  \"routine\": \"%s\",\n  \"command\": \"%s\",\n  \"host\": {\n",
+                 json_escape( routine ).c_str(),
+                 json_escape( opts.command ).c_str() );
+        for( int i = 0; i < nmeta; ++i ) {
+            if ( numeric[i] ) {
+                fprintf( file, "    \"%s\": %s", meta[i][0].c_str(), meta[i][1].c_str() );
+            }
+            else {
+                fprintf( file, "    \"%s\": \"%s\"", meta[i][0].c_str(),
+                         json_escape( meta[i][1] ).c_str() );
+            }
+            fprintf( file, "%s\n", (i < nmeta-1 ? "," : "") );
+        }
+        fprintf( file, "  },\n  \"results\": [" );
+    }
+    else {
+        fprintf( file, "# routine: %s\n# command: %s\n",
+                 routine.c_str(), opts.command.c_str() );
+        for( int i = 0; i < nmeta; ++i ) {
+            fprintf( file, "# %s: %s\n", meta[i][0].c_str(), meta[i][1].c_str() );
+        }
+    }
+    fflush( file );
+}
+
+
+// -----------------------------------------------------------------------------
+void magma_results::add_entry( const char* key, const std::string& value, bool quoted )
+{
+    if ( file == NULL )
+        return;
+    entry e = { key, value, quoted };
+    row.push_back( e );
+}
+
+// -----------------------------------------------------------------------------
+void magma_results::add( const char* key, magma_int_t value )
+{
+    add_entry( key, std::to_string( (long long) value ), false );
+}
+
+// -----------------------------------------------------------------------------
+// nan and inf aren't valid JSON numbers; they are written as null.
+void magma_results::add( const char* key, double value )
+{
+    char buf[ 32 ];
+    if ( std::isfinite( value ) ) {
+        snprintf( buf, sizeof(buf), "%.6e", value );
+    }
+    else {
+        snprintf( buf, sizeof(buf), "%s", (output == MagmaOutputJson ? "null" : "nan") );
+    }
+    add_entry( key, buf, false );
+}
+
+// -----------------------------------------------------------------------------
+void magma_results::add( const char* key, const char* value )
+{
+    add_entry( key, value, true );
+}
+
+// -----------------------------------------------------------------------------
+void magma_results::add( const char* key, const magma_timing& timing, double gflop )
+{
+    const magma_counters_t* c = (counters ? timing.fastest_counters() : NULL);
+    if ( c != NULL ) {
+        // without fp_ops, bytes/flop uses the tester's flop count
+        magma_counters_t rates = *c;
+        if ( rates.fp_ops < 0 && gflop != 0 ) {
+            rates.fp_ops = (long long)( gflop * 1e9 );
+        }
+        char buf[ 256 ];
+        magma_counters_snprintf( buf, sizeof(buf), &rates, timing.minimum() );
+        counter_lines.push_back( std::string( "    " ) + key + ": " + buf );
+    }
+
+    if ( file == NULL )
+        return;
+    std::string k( key );
+    add( (k + "_nrepeat"    ).c_str(), timing.count()   );
+    add( (k + "_time_min"   ).c_str(), timing.minimum() );
+    add( (k + "_time_median").c_str(), timing.median()  );
+    add( (k + "_time_mean"  ).c_str(), timing.mean()    );
+    add( (k + "_time_stddev").c_str(), timing.stddev()  );
+    if ( gflop != 0 ) {
+        add( (k + "_gflops_max"   ).c_str(), gflop / timing.minimum() );
+        add( (k + "_gflops_median").c_str(), gflop / timing.median()  );
+    }
+    if ( c != NULL ) {
+        // -1 for unavailable counters; may exceed 32-bit magma_int_t
+        add_entry( (k + "_cycles"      ).c_str(), std::to_string( c->cycles       ), false );
+        add_entry( (k + "_instructions").c_str(), std::to_string( c->instructions ), false );
+        add_entry( (k + "_llc_misses"  ).c_str(), std::to_string( c->llc_misses   ), false );
+        add_entry( (k + "_fp_ops"      ).c_str(), std::to_string( c->fp_ops       ), false );
+        double flops = (c->fp_ops >= 0 ? double( c->fp_ops ) : gflop * 1e9);
+        add( (k + "_hw_gflops").c_str(),
+             (c->fp_ops >= 0 ? c->fp_ops / timing.minimum() * 1e-9 : NAN) );
+        add( (k + "_bytes_per_flop").c_str(),
+             (c->llc_misses >= 0 && flops > 0 ? 64. * c->llc_misses / flops : NAN) );
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Writes the current row and clears it.
+// With --counters, prints the counter rates below the tester's row.
+void magma_results::end_row()
+{
+    for( size_t i = 0; i < counter_lines.size(); ++i ) {
+        printf( "%s\n", counter_lines[i].c_str() );
+    }
+    counter_lines.clear();
+
+    if ( file == NULL )
+        return;
+
+    if ( output == MagmaOutputJson ) {
+        fprintf( file, "%s\n    { ", (nrows > 0 ? "," : "") );
+        for( size_t i = 0; i < row.size(); ++i ) {
+            if ( row[i].quoted ) {
+                fprintf( file, "\"%s\": \"%s\"", json_escape( row[i].key ).c_str(),
+                         json_escape( row[i].value ).c_str() );
+            }
+            else {
+                fprintf( file, "\"%s\": %s", json_escape( row[i].key ).c_str(),
+                         row[i].value.c_str() );
+            }
+            fprintf( file, "%s", (i < row.size()-1 ? ", " : " }") );
+        }
+        if ( row.empty() ) {
+            fprintf( file, "}" );
+        }
+    }
+    else {
+        // the header is the keys of the first row; later rows are written
+        // in header order, with empty fields for missing keys
+        if ( nrows == 0 ) {
+            for( size_t i = 0; i < row.size(); ++i ) {
+                keys.push_back( row[i].key );
+                fprintf( file, "%s%s", (i > 0 ? "," : ""), csv_escape( row[i].key ).c_str() );
+            }
+            fprintf( file, "\n" );
+        }
+        for( size_t k = 0; k < keys.size(); ++k ) {
+            std::string value;
+            for( size_t i = 0; i < row.size(); ++i ) {
+                if ( row[i].key == keys[k] ) {
+                    value = row[i].value;
+                    break;
+                }
+            }
+            fprintf( file, "%s%s", (k > 0 ? "," : ""), csv_escape( value ).c_str() );
+        }
+        fprintf( file, "\n" );
+    }
+    fflush( file );
+    nrows += 1;
+    row.clear();
+}
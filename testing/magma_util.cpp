@@ -37,6 +37,9 @@
 #elif defined(MAGMA_HAVE_HIP)
     const char* g_platform_str = "HIP";
 
+#elif defined(MAGMA_HAVE_HOST)
+    const char* g_platform_str = "host";
+
 #else
     #error "unknown platform"
 #endif
@@ -109,6 +112,18 @@ const char *usage =
 "                   (Some testers take --ngpu -1 to run the multi-GPU code with 1 GPU.\n"
 "  --nsub x         Number of submatrices, default 1.\n"
 "  --niter x        Number of iterations to repeat each test, default 1.\n"
+"  --repeat x       Number of timed runs per test, default 1. The table shows the\n"
+"                   fastest run; --output json|csv also records median, mean, stddev.\n"
+"                   With --warmup, one extra run is done first and discarded.\n"
+"                   --repeat, --[no]flush, --counters, and --output apply to gemm and the\n"
+"                   getrf, potrf, geqrf, gelqf, geqlf, geqp3, gesv, posv, gels, getri,\n"
+"                   and potri testers; the other testers ignore them.\n"
+"  --[no]flush      Whether to flush the cache (see --cache) before each timed run,\n"
+"                   default no; gemm, which always flushed, defaults to yes.\n"
+"  --counters       Read hardware counters (Linux perf_event) in each timed run, and print\n"
+"                   achieved Gflop/s, bytes/flop, and IPC of the fastest run.\n"
+"  --output fmt     Also write results in machine-readable form; fmt is text*, json, or csv.\n"
+"  --output-file f  File for --output json|csv, default <tester>.json or <tester>.csv.\n"
 "  --nthread x      Number of CPU threads for some experimental codes, default 1.\n"
 "                   (For most testers, set $OMP_NUM_THREADS or $MKL_NUM_THREADS\n"
 "                    to control the number of CPU threads.)\n"
@@ -149,6 +164,9 @@ const char *usage =
 "                   or 'rand_dominant' if SPD required (e.g., for posv).\n"
 "  --cond   kA      where applicable, condition number for test matrix, default sqrt( 1/eps ); see magma_generate_matrix.\n"
 "  --condD  kD      where applicable, condition number for scaling test matrix, default 1; see magma_generate_matrix.\n"
+"  --matrix-cache d directory to save generated svd, heev, and poev matrices in, and load them from\n"
+"                   on later runs with the same matrix, size, cond, condD, and seed.\n"
+"                   Also set with $MAGMA_MATRIX_CACHE. Default none.\n"
 "\n"
 "                   * default values\n";
 
@@ -174,6 +192,7 @@ magma_opts::magma_opts( magma_opts_t flag )
     this->itype    = 1;
     this->version  = 1;
     this->verbose  = 0;
+    this->repeat   = 1;
 
     this->fraction_lo = 0.;
     this->fraction_up = 1.;
@@ -187,6 +206,9 @@ magma_opts::magma_opts( magma_opts_t flag )
     this->magma     = true;
     this->lapack    = (getenv("MAGMA_RUN_LAPACK")     != NULL);
     this->warmup    = (getenv("MAGMA_WARMUP")         != NULL);
+    this->flush     = false;
+    this->counters  = false;
+    this->output    = MagmaOutputText;
 
     this->uplo      = MagmaLower;      // potrf, etc.
     this->transA    = MagmaNoTrans;    // gemm, etc.
@@ -206,6 +228,10 @@ magma_opts::magma_opts( magma_opts_t flag )
     this->iseed[2]  = 0;
     this->iseed[3]  = 1;
 
+    if ( getenv("MAGMA_MATRIX_CACHE") != NULL ) {
+        this->matrix_cache = getenv("MAGMA_MATRIX_CACHE");
+    }
+
     if ( flag == MagmaOptsBatched ) {
         // 32, 64, ..., 512
         this->default_nstart = 32;
@@ -405,6 +431,24 @@ void magma_opts::parse_opts( int argc, char** argv )
             magma_assert( this->niter > 0,
                           "error: --niter %s is invalid; ensure niter > 0.\n", argv[i] );
         }
+        else if ( strcmp("--repeat",  argv[i]) == 0 && i+1 < argc ) {
+            this->repeat = atoi( argv[++i] );
+            magma_assert( this->repeat > 0,
+                          "error: --repeat %s is invalid; ensure repeat > 0.\n", argv[i] );
+        }
+        else if ( strcmp("--output",  argv[i]) == 0 && i+1 < argc ) {
+            i++;
+            if      ( strcmp( argv[i], "text" ) == 0 ) { this->output = MagmaOutputText; }
+            else if ( strcmp( argv[i], "json" ) == 0 ) { this->output = MagmaOutputJson; }
+            else if ( strcmp( argv[i], "csv"  ) == 0 ) { this->output = MagmaOutputCsv;  }
+            else {
+                fprintf( stderr, "error: --output %s is invalid; ensure output is text, json, or csv.\n", argv[i] );
+                exit(1);
+            }
+        }
+        else if ( strcmp("--output-file", argv[i]) == 0 && i+1 < argc ) {
+            this->output_file = argv[++i];
+        }
         else if ( strcmp("--nthread", argv[i]) == 0 && i+1 < argc ) {
             this->nthread = atoi( argv[++i] );
             magma_assert( this->nthread > 0,
@@ -487,6 +531,10 @@ void magma_opts::parse_opts( int argc, char** argv )
         else if ( strcmp("--warmup",   argv[i]) == 0 ) { this->warmup = true;  }
         else if ( strcmp("--nowarmup", argv[i]) == 0 ) { this->warmup = false; }
 
+        else if ( strcmp("--flush",    argv[i]) == 0 ) { this->flush  = true;  }
+        else if ( strcmp("--noflush",  argv[i]) == 0 ) { this->flush  = false; }
+        else if ( strcmp("--counters", argv[i]) == 0 ) { this->counters = true; }
+
         //else if ( strcmp("--all",      argv[i]) == 0 ) { this->all    = true;  }
         //else if ( strcmp("--notall",   argv[i]) == 0 ) { this->all    = false; }
 
@@ -595,6 +643,10 @@ void magma_opts::parse_opts( int argc, char** argv )
             magma_assert( this->condD >= 1,
                           "error: --condD %s is invalid; ensure condD >= 1.\n", argv[i] );
         }
+        else if ( strcmp("--matrix-cache", argv[i]) == 0 && i+1 < argc) {
+            i += 1;
+            this->matrix_cache = argv[i];
+        }
 
         // ----- usage
         else if ( strcmp("-h",     argv[i]) == 0 ||
@@ -609,6 +661,20 @@ void magma_opts::parse_opts( int argc, char** argv )
     }
 
     // default values
+    this->command = argv[0];
+    for( int i = 1; i < argc; ++i ) {
+        this->command += " ";
+        this->command += argv[i];
+    }
+    if ( this->output != MagmaOutputText && this->output_file.empty() ) {
+        const char* name = strrchr( argv[0], '/' );
+        this->output_file = (name ? name+1 : argv[0]);
+        this->output_file += (this->output == MagmaOutputJson ? ".json" : ".csv");
+    }
+    if ( this->counters && magma_counters_init() != MAGMA_SUCCESS ) {
+        fprintf( stderr, "warning: --counters: no hardware counters available"
+                 " (check /proc/sys/kernel/perf_event_paranoid)\n" );
+    }
     if ( this->svd_work.size() == 0 ) {
         this->svd_work.push_back( MagmaSVD_query );
     }
@@ -650,6 +716,8 @@ void magma_opts::parse_opts( int argc, char** argv )
     #elif defined(MAGMA_HAVE_CUDA)
         // handle for directly calling cublas
         this->handle = magma_queue_get_cublas_handle( this->queue );
+    #elif defined(MAGMA_HAVE_HOST)
+        // no vendor BLAS handle; the host queue calls BLAS directly
     #else
         #error "unknown platform"
     #endif
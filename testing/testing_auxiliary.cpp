@@ -306,6 +306,44 @@ void test_indices()
 }
 
 
+/******************************************************************************/
+// magma_free_cpu passes memory from malloc to free; the large size is
+// mmap'd by glibc, so reading in front of it would fault
+void test_free_cpu()
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+    magma_mem_stats_t stats0, stats1;
+    magma_mem_stats_cpu( &stats0 );
+
+    size_t sizes[] = { 8, 1000, 100000, 16 << 20 };
+    for (int i = 0; i < 4; ++i) {
+        void* ptr = malloc( sizes[i] );
+        warn( ptr != NULL );
+        warn( magma_free_cpu( ptr ) == MAGMA_SUCCESS );
+
+        warn( magma_malloc_cpu( &ptr, sizes[i] ) == MAGMA_SUCCESS );
+        warn( ptr != NULL );
+        warn( magma_free_cpu( ptr ) == MAGMA_SUCCESS );
+    }
+
+    #if ! defined(_WIN32)
+    // foreign pointers aligned like the pool's, and page aligned
+    size_t aligns[] = { 64, 4096 };
+    for (int i = 0; i < 2; ++i) {
+        void* ptr = NULL;
+        warn( posix_memalign( &ptr, aligns[i], 8192 ) == 0 );
+        warn( magma_free_cpu( ptr ) == MAGMA_SUCCESS );
+    }
+    #endif
+
+    // only the pool's blocks are counted
+    magma_mem_stats_cpu( &stats1 );
+    warn( stats1.nalloc     == stats0.nalloc + 4 );
+    warn( stats1.nfree      == stats0.nfree  + 4 );
+    warn( stats1.live_bytes == stats0.live_bytes );
+}
+
+
 /******************************************************************************/
 int main( int argc, char** argv )
 {
@@ -315,6 +353,7 @@ int main( int argc, char** argv )
     test_num_threads();
     test_xerbla();
     test_indices();
+    test_free_cpu();
     
     if ( gFailures > 0 ) {
         printf( "\n*** %lld tests failed.\n", (long long) gFailures );
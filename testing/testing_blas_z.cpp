@@ -92,9 +92,9 @@ int main( int argc, char** argv )
         
         // initialize matrices
         size = maxn*maxn;
-        lapackf77_zlarnv( &ione, ISEED, &size, A  );
-        lapackf77_zlarnv( &ione, ISEED, &size, B  );
-        lapackf77_zlarnv( &ione, ISEED, &size, C  );
+        magma_zlarnv( ione, ISEED, size, A  );
+        magma_zlarnv( ione, ISEED, size, B  );
+        magma_zlarnv( ione, ISEED, size, C  );
         
         printf( "%%========= Level 1 BLAS ==========\n" );
         
@@ -182,8 +182,8 @@ int main( int argc, char** argv )
         TESTING_CHECK( magma_zmalloc_cpu( &B, size ));
         
         // initialize matrices
-        lapackf77_zlarnv( &ione, ISEED, &size, A );
-        lapackf77_zlarnv( &ione, ISEED, &size, B );
+        magma_zlarnv( ione, ISEED, size, A );
+        magma_zlarnv( ione, ISEED, size, B );
         
         // ----- test DZASUM
         for( int iincx = 0; iincx < ninc; ++iincx ) {
@@ -289,9 +289,9 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_malloc( (void**)&dC, lddc*N *sizeof(magmaHalf)  ));
 
             /* Initialize the matrices */
-            lapackf77_slarnv( &ione, ISEED, &sizeA, hA );
-            lapackf77_slarnv( &ione, ISEED, &sizeB, hB );
-            lapackf77_slarnv( &ione, ISEED, &sizeC, hC );
+            magma_slarnv( ione, ISEED, sizeA, hA );
+            magma_slarnv( ione, ISEED, sizeB, hB );
+            magma_slarnv( ione, ISEED, sizeC, hC );
 
             /* Convert the matrices to half precision */
             preprocess_matrix( Am, An, hA, lda, dA, ldda, opts.queue );
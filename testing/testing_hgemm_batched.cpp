@@ -357,9 +357,9 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_malloc( (void**) &dC_array, batchCount * sizeof(magmaHalf*) ));
 
             /* Initialize the matrices */
-            lapackf77_slarnv( &ione, ISEED, &sizeA, hA );
-            lapackf77_slarnv( &ione, ISEED, &sizeB, hB );
-            lapackf77_slarnv( &ione, ISEED, &sizeC, hC );
+            magma_slarnv( ione, ISEED, sizeA, hA );
+            magma_slarnv( ione, ISEED, sizeB, hB );
+            magma_slarnv( ione, ISEED, sizeC, hC );
 
             /* preprocessing assumes one big matrix */
             preprocess_matrix(Am, batchCount*An, hA, lda, dA, ldda, opts.queue );
@@ -78,8 +78,8 @@ int main(int argc, char **argv)
             TESTING_CHECK( magma_zmalloc( &dY, size ));
             
             /* Initialize the matrix */
-            lapackf77_zlarnv( &ione, ISEED, &size, X );
-            lapackf77_zlarnv( &ione, ISEED, &size, Y );
+            magma_zlarnv( ione, ISEED, size, X );
+            magma_zlarnv( ione, ISEED, size, Y );
             
             // for error checks
             double Xnorm = lapackf77_zlange( "F", &M, &N, X, &lda, work );
@@ -110,7 +110,7 @@ int main( int argc, char** argv)
             
             // make random RHS
             size = ldb*nrhs;
-            lapackf77_zlarnv( &ione, ISEED, &size, h_B );
+            magma_zlarnv( ione, ISEED, size, h_B );
             lapackf77_zlacpy( MagmaFullStr, &M, &nrhs, h_B, &ldb, h_R, &ldb );
             
             magma_zsetmatrix( M, N,    h_A, lda, d_A, ldda, opts.queue );
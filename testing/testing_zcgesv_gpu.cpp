@@ -93,7 +93,7 @@ int main(int argc, char **argv)
             /* Initialize matrices */
             magma_generate_matrix( opts, N, N, h_A, lda );
             size = ldb * nrhs;
-            lapackf77_zlarnv( &ione, ISEED, &size, h_B );
+            magma_zlarnv( ione, ISEED, size, h_B );
             lapackf77_zlacpy( MagmaFullStr, &N, &nrhs, h_B, &ldb, h_X, &ldx);
             
             magma_zsetmatrix( N, N,    h_A, lda, d_A, ldda, opts.queue );
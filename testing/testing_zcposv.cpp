@@ -0,0 +1,146 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions mixed zc -> ds
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "flops.h"
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing zcposv, CPU interface, compared to magma_zposv.
+      Use e.g. --matrix svd_geo --cond 1e8 to exercise the GMRES-IR path.
+*/
+int main(int argc, char **argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    real_Double_t   gflops, cpu_perf, cpu_time, mp_perf, mp_time;
+    double          error, dp_error, Rnorm, Anorm, Xnorm;
+    magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    magmaDoubleComplex *h_A, *h_A2, *h_B, *h_X, *h_R;
+    double          *h_workd;
+    magma_int_t lda, ldb, ldx;
+    magma_int_t N, nrhs, iter, info, size;
+    magma_int_t ione     = 1;
+    magma_int_t ISEED[4] = {0,0,0,1};
+
+    printf("%% Epsilon(double): %8.6e\n"
+           "%% Epsilon(single): %8.6e\n\n",
+           lapackf77_dlamch("Epsilon"), lapackf77_slamch("Epsilon") );
+    int status = 0;
+
+    magma_opts opts;
+    opts.parse_opts( argc, argv );
+
+    double tol = opts.tolerance * lapackf77_dlamch("E");
+
+    nrhs = opts.nrhs;
+
+    printf("%% uplo = %s\n", lapack_uplo_const(opts.uplo) );
+    printf("%%   N  NRHS   DP Gflop/s (sec)   MP Gflop/s (sec)   Iter   |b-Ax|/N|A||x|\n");
+    printf("%%                                                            DP       MP  \n");
+    printf("%%========================================================================\n");
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int itry = 0; itry < opts.niter; ++itry ) {
+            N = opts.nsize[itest];
+            ldb = ldx = lda = N;
+            gflops = ( FLOPS_ZPOTRF( N ) + FLOPS_ZPOTRS( N, nrhs ) ) / 1e9;
+
+            TESTING_CHECK( magma_zmalloc_cpu( &h_A,     lda*N    ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_A2,    lda*N    ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_B,     ldb*nrhs ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_X,     ldx*nrhs ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_R,     ldb*nrhs ));
+            TESTING_CHECK( magma_dmalloc_cpu( &h_workd, N        ));
+
+            /* Initialize matrices */
+            magma_generate_matrix( opts, N, N, h_A, lda );
+            magma_zmake_hpd( N, h_A, lda );
+            size = ldb * nrhs;
+            magma_zlarnv( ione, ISEED, size, h_B );
+            Anorm = lapackf77_zlange( "I", &N, &N, h_A, &lda, h_workd );
+
+            //=====================================================================
+            //              MIXED precision
+            //=====================================================================
+            lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_A2, &lda );
+            mp_time = magma_wtime();
+            magma_zcposv( opts.uplo, N, nrhs, h_A2, lda, h_B, ldb, h_X, ldx,
+                          &iter, &info );
+            mp_time = magma_wtime() - mp_time;
+            mp_perf = gflops / mp_time;
+            if (info != 0) {
+                printf("magma_zcposv returned error %lld: %s.\n",
+                       (long long) info, magma_strerror( info ));
+            }
+
+            // |b - A x| / (N |A| |x|)
+            lapackf77_zlacpy( MagmaFullStr, &N, &nrhs, h_B, &ldb, h_R, &ldb );
+            blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &N, &nrhs, &N,
+                           &c_one,     h_A, &lda,
+                                       h_X, &ldx,
+                           &c_neg_one, h_R, &ldb );
+            Rnorm = lapackf77_zlange( "I", &N, &nrhs, h_R, &ldb, h_workd );
+            Xnorm = lapackf77_zlange( "I", &N, &nrhs, h_X, &ldx, h_workd );
+            error = Rnorm / (N*Anorm*Xnorm);
+
+            //=====================================================================
+            //              DOUBLE precision
+            //=====================================================================
+            lapackf77_zlacpy( MagmaFullStr, &N, &N,    h_A, &lda, h_A2, &lda );
+            lapackf77_zlacpy( MagmaFullStr, &N, &nrhs, h_B, &ldb, h_X,  &ldx );
+            cpu_time = magma_wtime();
+            magma_zposv( opts.uplo, N, nrhs, h_A2, lda, h_X, ldx, &info );
+            cpu_time = magma_wtime() - cpu_time;
+            cpu_perf = gflops / cpu_time;
+            if (info != 0) {
+                printf("magma_zposv returned error %lld: %s.\n",
+                       (long long) info, magma_strerror( info ));
+            }
+
+            lapackf77_zlacpy( MagmaFullStr, &N, &nrhs, h_B, &ldb, h_R, &ldb );
+            blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &N, &nrhs, &N,
+                           &c_one,     h_A, &lda,
+                                       h_X, &ldx,
+                           &c_neg_one, h_R, &ldb );
+            Rnorm = lapackf77_zlange( "I", &N, &nrhs, h_R, &ldb, h_workd );
+            Xnorm = lapackf77_zlange( "I", &N, &nrhs, h_X, &ldx, h_workd );
+            dp_error = Rnorm / (N*Anorm*Xnorm);
+
+            bool okay = (error < tol);
+            status += ! okay;
+            printf("%5lld %5lld   %7.2f (%7.4f)   %7.2f (%7.4f)   %4lld   %8.2e %8.2e   %s\n",
+                   (long long) N, (long long) nrhs,
+                   cpu_perf, cpu_time, mp_perf, mp_time,
+                   (long long) iter, dp_error, error, (okay ? "ok" : "failed"));
+
+            magma_free_cpu( h_A     );
+            magma_free_cpu( h_A2    );
+            magma_free_cpu( h_B     );
+            magma_free_cpu( h_X     );
+            magma_free_cpu( h_R     );
+            magma_free_cpu( h_workd );
+            fflush( stdout );
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
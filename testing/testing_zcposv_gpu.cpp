@@ -78,7 +78,7 @@ int main(int argc, char **argv)
             magma_generate_matrix( opts, N, N, h_A, lda );
             
             size = ldb * nrhs;
-            lapackf77_zlarnv( &ione, ISEED, &size, h_B );
+            magma_zlarnv( ione, ISEED, size, h_B );
             
             magma_zsetmatrix( N, N,    h_A, lda, d_A, lda, opts.queue );
             magma_zsetmatrix( N, nrhs, h_B, ldb, d_B, ldb, opts.queue );
@@ -73,8 +73,8 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_zmalloc( &d_A, ldda*N ));
             TESTING_CHECK( magma_zmalloc( &d_B, ldda*N ));
             
-            lapackf77_zlarnv( &ione, ISEED, &size, h_A );
-            lapackf77_zlarnv( &ione, ISEED, &size, h_B );
+            magma_zlarnv( ione, ISEED, size, h_A );
+            magma_zlarnv( ione, ISEED, size, h_B );
             
             /* ====================================================================
                Performs operation using MAGMA
@@ -80,8 +80,8 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_malloc( (void**) &dAarray, ntile * sizeof(magmaDoubleComplex*) ));
             TESTING_CHECK( magma_malloc( (void**) &dBarray, ntile * sizeof(magmaDoubleComplex*) ));
             
-            lapackf77_zlarnv( &ione, ISEED, &size, h_A );
-            lapackf77_zlarnv( &ione, ISEED, &size, h_B );
+            magma_zlarnv( ione, ISEED, size, h_A );
+            magma_zlarnv( ione, ISEED, size, h_B );
 
             /* ====================================================================
                Performs operation using MAGMA
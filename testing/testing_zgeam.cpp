@@ -97,8 +97,8 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_zmalloc( &d_B, lddb*Bn ));
             TESTING_CHECK( magma_zmalloc( &d_C, lddc*N  ));
             
-            lapackf77_zlarnv( &ione, ISEED, &size, h_A );
-            lapackf77_zlarnv( &ione, ISEED, &size, h_B );
+            magma_zlarnv( ione, ISEED, size, h_A );
+            magma_zlarnv( ione, ISEED, size, h_B );
             
             // for error checks
             double Anorm = lapackf77_zlange( "F", &Am, &An, h_A, &lda, work );
@@ -61,9 +61,29 @@ double magma_dzlapy2(magmaDoubleComplex x)
     return magma_dlapy2( MAGMA_Z_REAL(x), MAGMA_Z_IMAG(x) );
 }
 
+// Sets MAGMA_NUM_THREADS, or unsets it if value is NULL.
+// magma_get_parallel_numthreads() reads it on every call.
+static void set_magma_num_threads( const char* value )
+{
+    #if defined( _WIN32 ) || defined( _WIN64 )
+        static char env[64];
+        snprintf( env, sizeof(env), "MAGMA_NUM_THREADS=%s", (value ? value : "") );
+        putenv( env );
+    #else
+        if ( value )
+            setenv( "MAGMA_NUM_THREADS", value, true );
+        else
+            unsetenv( "MAGMA_NUM_THREADS" );
+    #endif
+}
+
 
 /* ////////////////////////////////////////////////////////////////////////////
    -- Testing zgeev
+   With --version 2, also benchmarks the ztrevc3 back-transform of right
+   eigenvectors: single-threaded ztrevc3 (MAGMA_NUM_THREADS=1), ztrevc3_mt,
+   and ztrevc3 choosing its thread count automatically, and checks that
+   the _mt and auto eigenvectors match the single-threaded ones.
 */
 int main( int argc, char** argv)
 {
@@ -74,6 +94,7 @@ int main( int argc, char** argv)
     magmaDoubleComplex *h_A, *h_R, *VL, *VR, *h_work, *w1, *w2;
     magmaDoubleComplex *w1copy, *w2copy;
     magmaDoubleComplex  c_neg_one = MAGMA_Z_NEG_ONE;
+    magmaDoubleComplex  c_zero    = MAGMA_Z_ZERO;
     double *rwork;
     double tnrm, result[9];
     magma_int_t N, n2, lda, nb, lwork, lwork2, info;
@@ -482,6 +503,68 @@ int main( int argc, char** argv)
                 }
             }
             
+            /* =====================================================================
+               Benchmark ztrevc3: single-threaded, _mt, and auto.
+               Uses the upper triangle of A as T, and A as Q.
+               Check | VR - VR_single | / | VR_single |, saving VR_single in VL.
+               =================================================================== */
+            if ( opts.version == 2 ) {
+                real_Double_t trevc_time[3];
+                double trevc_err[3] = { 0, 0, 0 }, vnorm = 0;
+                magma_int_t mout, Nm1 = N-1;
+                const char* env = getenv( "MAGMA_NUM_THREADS" );
+                std::string env_save = (env ? env : "");
+                
+                lapackf77_zlacpy( MagmaUpperStr, &N, &N, h_A, &lda, h_R, &lda );
+                if ( N > 1 ) {
+                    lapackf77_zlaset( MagmaLowerStr, &Nm1, &Nm1, &c_zero, &c_zero, &h_R[1], &lda );
+                }
+                for( int ver = 0; ver < 3; ++ver ) {
+                    lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, VR, &lda );
+                    if ( ver == 0 ) {
+                        set_magma_num_threads( "1" );
+                    }
+                    trevc_time[ver] = magma_wtime();
+                    if ( ver == 1 ) {
+                        magma_ztrevc3_mt( MagmaRight, MagmaBacktransVec, NULL, N, h_R, lda,
+                                          NULL, 1, VR, lda, N, &mout,
+                                          h_work, lwork, rwork, &info );
+                    }
+                    else {
+                        magma_ztrevc3( MagmaRight, MagmaBacktransVec, NULL, N, h_R, lda,
+                                       NULL, 1, VR, lda, N, &mout,
+                                       h_work, lwork, rwork, &info );
+                    }
+                    trevc_time[ver] = magma_wtime() - trevc_time[ver];
+                    if ( ver == 0 ) {
+                        set_magma_num_threads( env ? env_save.c_str() : NULL );
+                    }
+                    if (info != 0) {
+                        printf("magma_ztrevc3 returned error %lld: %s.\n",
+                               (long long) info, magma_strerror( info ));
+                    }
+                    if ( ver == 0 ) {
+                        lapackf77_zlacpy( MagmaFullStr, &N, &N, VR, &lda, VL, &lda );
+                        vnorm = lapackf77_zlange( "F", &N, &N, VL, &lda, rwork );
+                    }
+                    else {
+                        for( int j = 0; j < N; ++j ) {
+                            blasf77_zaxpy( &N, &c_neg_one, &VL[j*lda], &ione, &VR[j*lda], &ione );
+                        }
+                        trevc_err[ver] = lapackf77_zlange( "F", &N, &N, VR, &lda, rwork )
+                                       / max( vnorm, tol );
+                    }
+                }
+                printf("        ztrevc3 (sec): single %7.2f,   mt %7.2f,   auto (%lld threads) %7.2f\n",
+                       trevc_time[0], trevc_time[1],
+                       (long long) magma_get_ztrevc3_nthread( N ), trevc_time[2] );
+                // the vectors differ by rounding in the triangular solves, which grows with N
+                bool okay = (trevc_err[1] < N*tol && trevc_err[2] < N*tol);
+                status += ! okay;
+                printf("        | VR - VR_single | / | VR_single |: mt %8.2e,   auto %8.2e   %s\n",
+                       trevc_err[1], trevc_err[2], (okay ? "ok" : "failed") );
+            }
+            
             magma_free_cpu( w1copy );
             magma_free_cpu( w2copy );
             magma_free_cpu( w1     );
@@ -45,6 +45,7 @@ int main( int argc, char** argv)
 
     magma_opts opts;
     opts.parse_opts( argc, argv );
+    magma_results results( opts, "zgelqf_gpu" );
 
     double tol = opts.tolerance * lapackf77_dlamch("E");
     
@@ -60,6 +61,8 @@ int main( int argc, char** argv)
             n2     = lda*N;
             nb     = magma_get_zgeqrf_nb( M, N );
             gflops = FLOPS_ZGELQF( M, N ) / 1e9;
+            results.add( "M", M );
+            results.add( "N", N );
             
             // query for workspace size
             lwork = -1;
@@ -77,16 +80,20 @@ int main( int argc, char** argv)
             
             /* Initialize the matrix */
             magma_generate_matrix( opts, M, N, h_A, lda );
-            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda );
             
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
-            magma_zsetmatrix( M, N, h_R, lda, d_A, ldda, opts.queue );
-            gpu_time = magma_wtime();
-            magma_zgelqf_gpu( M, N, d_A, ldda, tau, h_work, lwork, &info);
-            gpu_time = magma_wtime() - gpu_time;
+            magma_timing gpu_times = magma_repeat( opts,
+                [&]() { magma_zsetmatrix( M, N, h_A, lda, d_A, ldda, opts.queue ); },
+                [&]() {
+                    real_Double_t time = magma_wtime();
+                    magma_zgelqf_gpu( M, N, d_A, ldda, tau, h_work, lwork, &info);
+                    return magma_wtime() - time;
+                });
+            gpu_time = gpu_times.minimum();
             gpu_perf = gflops / gpu_time;
+            results.add( "magma", gpu_times, gflops );
             if (info != 0) {
                 printf("magma_zgelqf_gpu returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -141,10 +148,16 @@ int main( int argc, char** argv)
                Performs operation using LAPACK
                =================================================================== */
             if ( opts.lapack ) {
-                cpu_time = magma_wtime();
-                lapackf77_zgelqf( &M, &N, h_A, &lda, tau, h_work, &lwork, &info );
-                cpu_time = magma_wtime() - cpu_time;
+                magma_timing cpu_times = magma_repeat( opts,
+                    [&]() { lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda ); },
+                    [&]() {
+                        real_Double_t time = magma_wtime();
+                        lapackf77_zgelqf( &M, &N, h_R, &lda, tau, h_work, &lwork, &info );
+                        return magma_wtime() - time;
+                    });
+                cpu_time = cpu_times.minimum();
                 cpu_perf = gflops / cpu_time;
+                results.add( "cpu", cpu_times, gflops );
                 if (info != 0) {
                     printf("lapack_zgelqf returned error %lld: %s.\n",
                            (long long) info, magma_strerror( info ));
@@ -166,6 +179,9 @@ int main( int argc, char** argv)
                 bool okay = (error < tol && error2 < tol);
                 status += ! okay;
                 printf( "%11.2e   %11.2e   %s\n", error, error2, (okay ? "ok" : "failed") );
+                results.add( "error", error );
+                results.add( "ortho_error", error2 );
+                results.add( "status", (okay ? "ok" : "failed") );
                 //printf( "error %.4g, error2 %.4g, tol %.4g, okay %d\n", error, error2, tol, okay );
             }
             else {
@@ -179,6 +195,7 @@ int main( int argc, char** argv)
             magma_free_pinned( h_work );
             
             magma_free( d_A );
+            results.end_row();
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
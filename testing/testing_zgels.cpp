@@ -42,6 +42,7 @@ int main( int argc, char** argv )
 
     magma_opts opts;
     opts.parse_opts( argc, argv );
+    magma_results results( opts, "zgels" );
  
     int status = 0;
     double tol = opts.tolerance * lapackf77_dlamch("E");
@@ -65,6 +66,9 @@ int main( int argc, char** argv )
             ldb    = max_mn;
             nb     = magma_get_zgeqrf_nb( M, N );
             gflops = (FLOPS_ZGEQRF( M, N ) + FLOPS_ZGEQRS( M, N, nrhs )) / 1e9;
+            results.add( "M", M );
+            results.add( "N", N );
+            results.add( "nrhs", nrhs );
             
             // query for workspace size
             lhwork = -1;
@@ -86,22 +90,30 @@ int main( int argc, char** argv )
             
             /* Initialize the matrices */
             magma_generate_matrix( opts, M, N, h_A, lda );
-            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_A2, &lda );
             
             // make random RHS
             size = ldb*nrhs;
-            lapackf77_zlarnv( &ione, ISEED, &size, h_B );
+            magma_zlarnv( ione, ISEED, size, h_B );
             lapackf77_zlacpy( MagmaFullStr, &M, &nrhs, h_B, &ldb, h_R , &ldb );
-            lapackf77_zlacpy( MagmaFullStr, &M, &nrhs, h_B, &ldb, h_B2, &ldb );
+            
+            auto copy_AB = [&]() {
+                lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_A2, &lda );
+                lapackf77_zlacpy( MagmaFullStr, &M, &nrhs, h_B, &ldb, h_B2, &ldb );
+            };
             
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
-            gpu_time = magma_wtime();
-            magma_zgels( MagmaNoTrans, M, N, nrhs, h_A2, lda,
-                         h_B2, ldb, h_work, lhwork, &info );
-            gpu_time = magma_wtime() - gpu_time;
+            magma_timing gpu_times = magma_repeat( opts, copy_AB,
+                [&]() {
+                    real_Double_t time = magma_wtime();
+                    magma_zgels( MagmaNoTrans, M, N, nrhs, h_A2, lda,
+                                 h_B2, ldb, h_work, lhwork, &info );
+                    return magma_wtime() - time;
+                });
+            gpu_time = gpu_times.minimum();
             gpu_perf = gflops / gpu_time;
+            results.add( "magma", gpu_times, gflops );
             if (info != 0) {
                 printf("magma_zgels_gpu returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -117,14 +129,16 @@ int main( int argc, char** argv )
             /* =====================================================================
                Performs operation using LAPACK
                =================================================================== */
-            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_A2, &lda );
-            lapackf77_zlacpy( MagmaFullStr, &M, &nrhs, h_B, &ldb, h_B2, &ldb );
-            
-            cpu_time = magma_wtime();
-            lapackf77_zgels( MagmaNoTransStr, &M, &N, &nrhs,
-                             h_A2, &lda, h_B2, &ldb, h_work, &lhwork, &info );
-            cpu_time = magma_wtime() - cpu_time;
+            magma_timing cpu_times = magma_repeat( opts, copy_AB,
+                [&]() {
+                    real_Double_t time = magma_wtime();
+                    lapackf77_zgels( MagmaNoTransStr, &M, &N, &nrhs,
+                                     h_A2, &lda, h_B2, &ldb, h_work, &lhwork, &info );
+                    return magma_wtime() - time;
+                });
+            cpu_time = cpu_times.minimum();
             cpu_perf = gflops / cpu_time;
+            results.add( "cpu", cpu_times, gflops );
             if (info != 0) {
                 printf("lapackf77_zgels returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -146,14 +160,19 @@ int main( int argc, char** argv )
             printf("%5lld %5lld %5lld   %7.2f (%7.2f)   %7.2f (%7.2f)   %8.2e   %8.2e   %8.2e",
                    (long long) M, (long long) N, (long long) nrhs,
                    cpu_perf, cpu_time, gpu_perf, gpu_time, cpu_error, gpu_error, error );
+            results.add( "cpu_error", cpu_error );
+            results.add( "gpu_error", gpu_error );
+            results.add( "error", error );
             
             if ( M == N ) {
                 printf( "   %s\n", (gpu_error < tol && error < tol ? "ok" : "failed"));
                 status += ! (gpu_error < tol && error < tol);
+                results.add( "status", (gpu_error < tol && error < tol ? "ok" : "failed") );
             }
             else {
                 printf( "   %s\n", (error < tol ? "ok" : "failed"));
                 status += ! (error < tol);
+                results.add( "status", (error < tol ? "ok" : "failed") );
             }
 
             magma_free_cpu( tau    );
@@ -164,6 +183,7 @@ int main( int argc, char** argv )
             magma_free_cpu( h_R    );
             magma_free_cpu( h_work );
             
+            results.end_row();
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
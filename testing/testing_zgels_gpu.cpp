@@ -43,6 +43,7 @@ int main( int argc, char** argv )
 
     magma_opts opts;
     opts.parse_opts( argc, argv );
+    magma_results results( opts, "zgels_gpu" );
  
     int status = 0;
     double tol = opts.tolerance * lapackf77_dlamch("E");
@@ -68,6 +69,9 @@ int main( int argc, char** argv )
             lddb   = magma_roundup( max_mn, opts.align );  // multiple of 32 by default
             nb     = magma_get_zgeqrf_nb( M, N );
             gflops = (FLOPS_ZGEQRF( M, N ) + FLOPS_ZGEQRS( M, N, nrhs )) / 1e9;
+            results.add( "M", M );
+            results.add( "N", N );
+            results.add( "nrhs", nrhs );
             
             lworkgpu = (M - N + nb)*(nrhs + nb) + nrhs*nb;
             
@@ -93,16 +97,15 @@ int main( int argc, char** argv )
             
             /* Initialize the matrices */
             magma_generate_matrix( opts, M, N, h_A, lda );
-            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_A2, &lda );
             
             // make random RHS
             size = ldb*nrhs;
-            lapackf77_zlarnv( &ione, ISEED, &size, h_B );
+            magma_zlarnv( ione, ISEED, size, h_B );
             lapackf77_zlacpy( MagmaFullStr, &M, &nrhs, h_B, &ldb, h_R, &ldb );
             
             // make consistent RHS
             //size = N*nrhs;
-            //lapackf77_zlarnv( &ione, ISEED, &size, h_X );
+            //magma_zlarnv( ione, ISEED, size, h_X );
             //blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &M, &nrhs, &N,
             //               &c_one,  h_A, &lda,
             //                        h_X, &ldb,
@@ -112,14 +115,20 @@ int main( int argc, char** argv )
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
-            magma_zsetmatrix( M, N,    h_A, lda, d_A, ldda, opts.queue );
-            magma_zsetmatrix( M, nrhs, h_B, ldb, d_B, lddb, opts.queue );
-            
-            gpu_time = magma_wtime();
-            magma_zgels_gpu( MagmaNoTrans, M, N, nrhs, d_A, ldda,
-                             d_B, lddb, h_work, lworkgpu, &info );
-            gpu_time = magma_wtime() - gpu_time;
+            magma_timing gpu_times = magma_repeat( opts,
+                [&]() {
+                    magma_zsetmatrix( M, N,    h_A, lda, d_A, ldda, opts.queue );
+                    magma_zsetmatrix( M, nrhs, h_B, ldb, d_B, lddb, opts.queue );
+                },
+                [&]() {
+                    real_Double_t time = magma_wtime();
+                    magma_zgels_gpu( MagmaNoTrans, M, N, nrhs, d_A, ldda,
+                                     d_B, lddb, h_work, lworkgpu, &info );
+                    return magma_wtime() - time;
+                });
+            gpu_time = gpu_times.minimum();
             gpu_perf = gflops / gpu_time;
+            results.add( "magma", gpu_times, gflops );
             if (info != 0) {
                 printf("magma_zgels_gpu returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -136,20 +145,27 @@ int main( int argc, char** argv )
             /* =====================================================================
                Performs operation using LAPACK
                =================================================================== */
-            lapackf77_zlacpy( MagmaFullStr, &M, &nrhs, h_B, &ldb, h_X, &ldb );
-            
-            cpu_time = magma_wtime();
-            lapackf77_zgels( MagmaNoTransStr, &M, &N, &nrhs,
-                             h_A, &lda, h_X, &ldb, h_work, &lhwork, &info );
-            cpu_time = magma_wtime() - cpu_time;
+            magma_timing cpu_times = magma_repeat( opts,
+                [&]() {
+                    lapackf77_zlacpy( MagmaFullStr, &M, &N,    h_A, &lda, h_A2, &lda );
+                    lapackf77_zlacpy( MagmaFullStr, &M, &nrhs, h_B, &ldb, h_X,  &ldb );
+                },
+                [&]() {
+                    real_Double_t time = magma_wtime();
+                    lapackf77_zgels( MagmaNoTransStr, &M, &N, &nrhs,
+                                     h_A2, &lda, h_X, &ldb, h_work, &lhwork, &info );
+                    return magma_wtime() - time;
+                });
+            cpu_time = cpu_times.minimum();
             cpu_perf = gflops / cpu_time;
+            results.add( "cpu", cpu_times, gflops );
             if (info != 0) {
                 printf("lapackf77_zgels returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
             }
             
             blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &M, &nrhs, &N,
-                           &c_neg_one, h_A2, &lda,
+                           &c_neg_one, h_A,  &lda,
                                        h_X,  &ldb,
                            &c_one,     h_B,  &ldb );
             
@@ -164,6 +180,9 @@ int main( int argc, char** argv )
             printf("%5lld %5lld %5lld   %7.2f (%7.2f)   %7.2f (%7.2f)   %8.2e   %8.2e   %8.2e",
                    (long long) M, (long long) N, (long long) nrhs,
                    cpu_perf, cpu_time, gpu_perf, gpu_time, cpu_error, gpu_error, error );
+            results.add( "cpu_error", cpu_error );
+            results.add( "gpu_error", gpu_error );
+            results.add( "error", error );
             
             bool okay;
             if ( M == N ) {
@@ -174,6 +193,7 @@ int main( int argc, char** argv )
             }
             status += ! okay;
             printf( "   %s\n", (okay ? "ok" : "failed"));
+            results.add( "status", (okay ? "ok" : "failed") );
 
             magma_free_cpu( tau    );
             magma_free_cpu( h_A    );
@@ -185,6 +205,7 @@ int main( int argc, char** argv )
             
             magma_free( d_A    );
             magma_free( d_B    );
+            results.end_row();
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
@@ -60,8 +60,12 @@ int main( int argc, char** argv)
     MAGMA_UNUSED( magma_time );
     MAGMA_UNUSED( magma_error );
     
+    // gemm flushed the cache before each run before --flush existed;
+    // --noflush turns it off
     magma_opts opts;
+    opts.flush = true;
     opts.parse_opts( argc, argv );
+    magma_results results( opts, "zgemm" );
     
     // Allow 3*eps; complex needs 2*sqrt(2) factor; see Higham, 2002, sec. 3.6.
     double eps = lapackf77_dlamch("E");
@@ -93,6 +97,9 @@ int main( int argc, char** argv)
             N = opts.nsize[itest];
             K = opts.ksize[itest];
             gflops = FLOPS_ZGEMM( M, N, K ) / 1e9;
+            results.add( "M", M );
+            results.add( "N", N );
+            results.add( "K", K );
 
             if ( opts.transA == MagmaNoTrans ) {
                 lda = Am = M;
@@ -130,9 +137,9 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_zmalloc( &dC, lddc*N  ));
             
             /* Initialize the matrices */
-            lapackf77_zlarnv( &ione, ISEED, &sizeA, hA );
-            lapackf77_zlarnv( &ione, ISEED, &sizeB, hB );
-            lapackf77_zlarnv( &ione, ISEED, &sizeC, hC );
+            magma_zlarnv( ione, ISEED, sizeA, hA );
+            magma_zlarnv( ione, ISEED, sizeB, hB );
+            magma_zlarnv( ione, ISEED, sizeC, hC );
             
             magma_zsetmatrix( Am, An, hA, lda, dA(0,0), ldda, opts.queue );
             magma_zsetmatrix( Bm, Bn, hB, ldb, dB(0,0), lddb, opts.queue );
@@ -146,17 +153,22 @@ int main( int argc, char** argv)
                Performs operation using MAGMABLAS (currently only with CUDA)
                =================================================================== */
             #if defined(MAGMA_HAVE_CUDA) || defined(MAGMA_HAVE_HIP)
-                magma_zsetmatrix( M, N, hC, ldc, dC, lddc, opts.queue );
-                
-                magma_flush_cache( opts.cache );
-                magma_time = magma_sync_wtime( opts.queue );
-                magmablas_zgemm( opts.transA, opts.transB, M, N, K,
-                                 alpha, dA, ldda,
-                                        dB, lddb,
-                                 beta,  dC, lddc,
-                                 opts.queue );
-                magma_time = magma_sync_wtime( opts.queue ) - magma_time;
+                magma_timing magma_times = magma_repeat( opts,
+                    [&]() {
+                        magma_zsetmatrix( M, N, hC, ldc, dC, lddc, opts.queue );
+                    },
+                    [&]() {
+                        real_Double_t time = magma_sync_wtime( opts.queue );
+                        magmablas_zgemm( opts.transA, opts.transB, M, N, K,
+                                         alpha, dA, ldda,
+                                                dB, lddb,
+                                         beta,  dC, lddc,
+                                         opts.queue );
+                        return magma_sync_wtime( opts.queue ) - time;
+                    });
+                magma_time = magma_times.minimum();
                 magma_perf = gflops / magma_time;
+                results.add( "magma", magma_times, gflops );
                 
                 magma_zgetmatrix( M, N, dC, lddc, hCmagma, ldc, opts.queue );
             #endif
@@ -164,16 +176,21 @@ int main( int argc, char** argv)
             /* =====================================================================
                Performs operation using CUBLAS / clBLAS / Xeon Phi MKL
                =================================================================== */
-            magma_zsetmatrix( M, N, hC, ldc, dC(0,0), lddc, opts.queue );
-            
-            magma_flush_cache( opts.cache );
-            dev_time = magma_sync_wtime( opts.queue );
-            magma_zgemm( opts.transA, opts.transB, M, N, K,
-                         alpha, dA(0,0), ldda,
-                                dB(0,0), lddb,
-                         beta,  dC(0,0), lddc, opts.queue );
-            dev_time = magma_sync_wtime( opts.queue ) - dev_time;
+            magma_timing dev_times = magma_repeat( opts,
+                [&]() {
+                    magma_zsetmatrix( M, N, hC, ldc, dC(0,0), lddc, opts.queue );
+                },
+                [&]() {
+                    real_Double_t time = magma_sync_wtime( opts.queue );
+                    magma_zgemm( opts.transA, opts.transB, M, N, K,
+                                 alpha, dA(0,0), ldda,
+                                        dB(0,0), lddb,
+                                 beta,  dC(0,0), lddc, opts.queue );
+                    return magma_sync_wtime( opts.queue ) - time;
+                });
+            dev_time = dev_times.minimum();
             dev_perf = gflops / dev_time;
+            results.add( "dev", dev_times, gflops );
             
             magma_zgetmatrix( M, N, dC(0,0), lddc, hCdev, ldc, opts.queue );
             
@@ -181,14 +198,30 @@ int main( int argc, char** argv)
                Performs operation using CPU BLAS
                =================================================================== */
             if ( opts.lapack ) {
-                magma_flush_cache( opts.cache );
-                cpu_time = magma_wtime();
-                blasf77_zgemm( lapack_trans_const(opts.transA), lapack_trans_const(opts.transB), &M, &N, &K,
-                               &alpha, hA, &lda,
-                                       hB, &ldb,
-                               &beta,  hC, &ldc );
-                cpu_time = magma_wtime() - cpu_time;
+                // hC is overwritten, so runs after the first use a copy of it;
+                // the last run leaves the result in hC for the check
+                magma_int_t run = 0;
+                magmaDoubleComplex *hCsave;
+                TESTING_CHECK( magma_zmalloc_cpu( &hCsave, ldc*N ));
+                lapackf77_zlacpy( "F", &M, &N, hC, &ldc, hCsave, &ldc );
+                magma_timing cpu_times = magma_repeat( opts,
+                    [&]() {
+                        if ( run++ > 0 ) {
+                            lapackf77_zlacpy( "F", &M, &N, hCsave, &ldc, hC, &ldc );
+                        }
+                    },
+                    [&]() {
+                        real_Double_t time = magma_wtime();
+                        blasf77_zgemm( lapack_trans_const(opts.transA), lapack_trans_const(opts.transB), &M, &N, &K,
+                                       &alpha, hA, &lda,
+                                               hB, &ldb,
+                                       &beta,  hC, &ldc );
+                        return magma_wtime() - time;
+                    });
+                magma_free_cpu( hCsave );
+                cpu_time = cpu_times.minimum();
                 cpu_perf = gflops / cpu_time;
+                results.add( "cpu", cpu_times, gflops );
             }
             
             /* =====================================================================
@@ -216,6 +249,9 @@ int main( int argc, char** argv)
                     
                     bool okay = (magma_error < tol && dev_error < tol);
                     status += ! okay;
+                    results.add( "magma_error", magma_error );
+                    results.add( "dev_error", dev_error );
+                    results.add( "status", okay ? "ok" : "failed" );
                     printf("%5lld %5lld %5lld   %7.2f (%7.2f)    %7.2f (%7.2f)   %7.2f (%7.2f)    %8.2e     %8.2e   %s\n",
                            (long long) M, (long long) N, (long long) K,
                            magma_perf,  1000.*magma_time,
@@ -226,6 +262,8 @@ int main( int argc, char** argv)
                 #else
                     bool okay = (dev_error < tol);
                     status += ! okay;
+                    results.add( "dev_error", dev_error );
+                    results.add( "status", okay ? "ok" : "failed" );
                     printf("%5lld %5lld %5lld   %7.2f (%7.2f)   %7.2f (%7.2f)    %8.2e   %s\n",
                            (long long) M, (long long) N, (long long) K,
                            dev_perf,    1000.*dev_time,
@@ -244,6 +282,8 @@ int main( int argc, char** argv)
                     
                     bool okay = (magma_error < tol);
                     status += ! okay;
+                    results.add( "magma_error", magma_error );
+                    results.add( "status", okay ? "ok" : "failed" );
                     printf("%5lld %5lld %5lld   %7.2f (%7.2f)    %7.2f (%7.2f)     ---   (  ---  )    %8.2e        ---    %s\n",
                            (long long) M, (long long) N, (long long) K,
                            magma_perf,  1000.*magma_time,
@@ -266,6 +306,7 @@ int main( int argc, char** argv)
             magma_free( dA );
             magma_free( dB );
             magma_free( dC );
+            results.end_row();
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
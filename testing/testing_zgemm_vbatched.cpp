@@ -188,9 +188,9 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_zmalloc(&d_C, total_size_C_dev) );
             
             /* Initialize the matrices */
-            lapackf77_zlarnv( &ione, ISEED, &total_size_A_cpu, h_A );
-            lapackf77_zlarnv( &ione, ISEED, &total_size_B_cpu, h_B );
-            lapackf77_zlarnv( &ione, ISEED, &total_size_C_cpu, h_C );
+            magma_zlarnv( ione, ISEED, total_size_A_cpu, h_A );
+            magma_zlarnv( ione, ISEED, total_size_B_cpu, h_B );
+            magma_zlarnv( ione, ISEED, total_size_C_cpu, h_C );
 
             // Compute norms for error
             h_A_tmp = h_A;
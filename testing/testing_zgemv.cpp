@@ -105,9 +105,9 @@ int main(int argc, char **argv)
             TESTING_CHECK( magma_zmalloc( &dY, sizeY  ));
             
             /* Initialize the matrix */
-            lapackf77_zlarnv( &ione, ISEED, &sizeA, A );
-            lapackf77_zlarnv( &ione, ISEED, &sizeX, X );
-            lapackf77_zlarnv( &ione, ISEED, &sizeY, Y );
+            magma_zlarnv( ione, ISEED, sizeA, A );
+            magma_zlarnv( ione, ISEED, sizeX, X );
+            magma_zlarnv( ione, ISEED, sizeY, Y );
             
             // for error checks
             double Anorm = lapackf77_zlange( "F", &M, &N, A, &lda, work );
@@ -108,9 +108,9 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_malloc( (void**) &d_Y_array, batchCount * sizeof(magmaDoubleComplex*) ));
 
             /* Initialize the matrices */
-            lapackf77_zlarnv( &ione, ISEED, &sizeA, h_A );
-            lapackf77_zlarnv( &ione, ISEED, &sizeX, h_X );
-            lapackf77_zlarnv( &ione, ISEED, &sizeY, h_Y );
+            magma_zlarnv( ione, ISEED, sizeA, h_A );
+            magma_zlarnv( ione, ISEED, sizeX, h_X );
+            magma_zlarnv( ione, ISEED, sizeY, h_Y );
             
             // Compute norms for error
             for (int s = 0; s < batchCount; ++s) {
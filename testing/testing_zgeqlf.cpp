@@ -44,6 +44,7 @@ int main( int argc, char** argv)
 
     magma_opts opts;
     opts.parse_opts( argc, argv );
+    magma_results results( opts, "zgeqlf" );
 
     double tol = opts.tolerance * lapackf77_dlamch("E");
     
@@ -58,6 +59,8 @@ int main( int argc, char** argv)
             n2     = lda*N;
             nb     = magma_get_zgeqlf_nb( M, N );
             gflops = FLOPS_ZGEQLF( M, N ) / 1e9;
+            results.add( "M", M );
+            results.add( "N", N );
             
             // query for workspace size
             lwork = -1;
@@ -74,15 +77,22 @@ int main( int argc, char** argv)
             
             /* Initialize the matrix */
             magma_generate_matrix( opts, M, N, h_A, lda );
-            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda );
+            auto copy_A = [&]() {
+                lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda );
+            };
             
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
-            gpu_time = magma_wtime();
-            magma_zgeqlf( M, N, h_R, lda, tau, h_work, lwork, &info);
-            gpu_time = magma_wtime() - gpu_time;
+            magma_timing gpu_times = magma_repeat( opts, copy_A,
+                [&]() {
+                    real_Double_t time = magma_wtime();
+                    magma_zgeqlf( M, N, h_R, lda, tau, h_work, lwork, &info);
+                    return magma_wtime() - time;
+                });
+            gpu_time = gpu_times.minimum();
             gpu_perf = gflops / gpu_time;
+            results.add( "magma", gpu_times, gflops );
             if (info != 0) {
                 printf("magma_zgeqlf returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -158,10 +168,15 @@ int main( int argc, char** argv)
                Performs operation using LAPACK
                =================================================================== */
             if ( opts.lapack ) {
-                cpu_time = magma_wtime();
-                lapackf77_zgeqlf( &M, &N, h_A, &lda, tau, h_work, &lwork, &info );
-                cpu_time = magma_wtime() - cpu_time;
+                magma_timing cpu_times = magma_repeat( opts, copy_A,
+                    [&]() {
+                        real_Double_t time = magma_wtime();
+                        lapackf77_zgeqlf( &M, &N, h_R, &lda, tau, h_work, &lwork, &info );
+                        return magma_wtime() - time;
+                    });
+                cpu_time = cpu_times.minimum();
                 cpu_perf = gflops / cpu_time;
+                results.add( "cpu", cpu_times, gflops );
                 if (info != 0) {
                     printf("lapack_zgeqlf returned error %lld: %s.\n",
                            (long long) info, magma_strerror( info ));
@@ -183,6 +198,9 @@ int main( int argc, char** argv)
                 bool okay = (error < tol && error2 < tol);
                 status += ! okay;
                 printf( "%11.2e   %11.2e   %s\n", error, error2, (okay ? "ok" : "failed") );
+                results.add( "error", error );
+                results.add( "ortho_error", error2 );
+                results.add( "status", (okay ? "ok" : "failed") );
             }
             else {
                 printf( "    ---\n" );
@@ -193,6 +211,7 @@ int main( int argc, char** argv)
             magma_free_cpu( h_work );
             
             magma_free_pinned( h_R    );
+            results.end_row();
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
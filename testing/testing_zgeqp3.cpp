@@ -39,6 +39,7 @@ int main( int argc, char** argv)
     
     magma_opts opts;
     opts.parse_opts( argc, argv );
+    magma_results results( opts, "zgeqp3" );
 
     double tol = opts.tolerance * lapackf77_dlamch("E");
     
@@ -53,6 +54,8 @@ int main( int argc, char** argv)
             n2     = lda*N;
             nb     = magma_get_zgeqp3_nb( M, N );
             gflops = FLOPS_ZGEQRF( M, N ) / 1e9;
+            results.add( "M", M );
+            results.add( "N", N );
             
             lwork = ( N+1 )*nb;
             #ifdef REAL
@@ -74,23 +77,29 @@ int main( int argc, char** argv)
             
             /* Initialize the matrix */
             magma_generate_matrix( opts, M, N, h_A, lda );
-            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda );
+            auto copy_A = [&]() {
+                lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda );
+                for( j = 0; j < N; j++)
+                    jpvt[j] = 0;
+            };
             
             /* =====================================================================
                Performs operation using LAPACK
                =================================================================== */
             if ( opts.lapack ) {
-                for( j = 0; j < N; j++)
-                    jpvt[j] = 0;
-                
-                cpu_time = magma_wtime();
-                lapackf77_zgeqp3( &M, &N, h_R, &lda, jpvt, tau, h_work, &lwork,
-                                  #ifdef COMPLEX
-                                  rwork,
-                                  #endif
-                                  &info );
-                cpu_time = magma_wtime() - cpu_time;
+                magma_timing cpu_times = magma_repeat( opts, copy_A,
+                    [&]() {
+                        real_Double_t time = magma_wtime();
+                        lapackf77_zgeqp3( &M, &N, h_R, &lda, jpvt, tau, h_work, &lwork,
+                                          #ifdef COMPLEX
+                                          rwork,
+                                          #endif
+                                          &info );
+                        return magma_wtime() - time;
+                    });
+                cpu_time = cpu_times.minimum();
                 cpu_perf = gflops / cpu_time;
+                results.add( "cpu", cpu_times, gflops );
                 if (info != 0) {
                     printf("lapack_zgeqp3 returned error %lld: %s.\n",
                            (long long) info, magma_strerror( info ));
@@ -100,18 +109,19 @@ int main( int argc, char** argv)
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
-            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda );
-            for( j = 0; j < N; j++)
-                jpvt[j] = 0;
-            
-            gpu_time = magma_wtime();
-            magma_zgeqp3( M, N, h_R, lda, jpvt, tau, h_work, lwork,
-                          #ifdef COMPLEX
-                          rwork,
-                          #endif
-                          &info );
-            gpu_time = magma_wtime() - gpu_time;
+            magma_timing gpu_times = magma_repeat( opts, copy_A,
+                [&]() {
+                    real_Double_t time = magma_wtime();
+                    magma_zgeqp3( M, N, h_R, lda, jpvt, tau, h_work, lwork,
+                                  #ifdef COMPLEX
+                                  rwork,
+                                  #endif
+                                  &info );
+                    return magma_wtime() - time;
+                });
+            gpu_time = gpu_times.minimum();
             gpu_perf = gflops / gpu_time;
+            results.add( "magma", gpu_times, gflops );
             if (info != 0) {
                 printf("magma_zgeqp3 returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -138,6 +148,8 @@ int main( int argc, char** argv)
                 error *= ulp;
                 printf("   %8.2e   %s\n", error, (error < tol ? "ok" : "failed"));
                 status += ! (error < tol);
+                results.add( "error", error );
+                results.add( "status", (error < tol ? "ok" : "failed") );
             }
             else {
                 printf("     ---  \n");
@@ -152,6 +164,7 @@ int main( int argc, char** argv)
             
             magma_free_pinned( h_R    );
             magma_free_pinned( h_work );
+            results.end_row();
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
@@ -40,6 +40,7 @@ int main( int argc, char** argv)
     
     magma_opts opts;
     opts.parse_opts( argc, argv );
+    magma_results results( opts, "zgeqp3_gpu" );
 
     double tol = opts.tolerance * lapackf77_dlamch("E");
     
@@ -61,6 +62,9 @@ int main( int argc, char** argv)
             n2     = lda*N;
             nb     = magma_get_zgeqp3_nb( M, N );
             gflops = FLOPS_ZGEQRF( M, N ) / 1e9;
+            results.add( "M", M );
+            results.add( "N", N );
+            results.add( "K", K );
             
             lwork = ( N+1 )*nb;
             #ifdef REAL
@@ -95,23 +99,29 @@ int main( int argc, char** argv)
             blasf77_zgemm("N", "N", &M, &N, &K, &alpha, h_R, &lda, h_R, &lda,
                           &beta, h_A, &lda);
 
-            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda );
             
             /* =====================================================================
                Performs operation using LAPACK
                =================================================================== */
             if ( opts.lapack ) {
-                for( j = 0; j < N; j++)
-                    jpvt[j] = 0;
-                
-                cpu_time = magma_wtime();
-                lapackf77_zgeqp3( &M, &N, h_R, &lda, jpvt, tau, h_work, &lwork,
-                                  #ifdef COMPLEX
-                                  rwork,
-                                  #endif
-                                  &info );
-                cpu_time = magma_wtime() - cpu_time;
+                magma_timing cpu_times = magma_repeat( opts,
+                    [&]() {
+                        lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda );
+                        for( j = 0; j < N; j++)
+                            jpvt[j] = 0;
+                    },
+                    [&]() {
+                        real_Double_t time = magma_wtime();
+                        lapackf77_zgeqp3( &M, &N, h_R, &lda, jpvt, tau, h_work, &lwork,
+                                          #ifdef COMPLEX
+                                          rwork,
+                                          #endif
+                                          &info );
+                        return magma_wtime() - time;
+                    });
+                cpu_time = cpu_times.minimum();
                 cpu_perf = gflops / cpu_time;
+                results.add( "cpu", cpu_times, gflops );
                 if (info != 0) {
                     printf("lapack_zgeqp3 returned error %lld: %s.\n",
                            (long long) info, magma_strerror( info ));
@@ -121,27 +131,30 @@ int main( int argc, char** argv)
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
-            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda );
-            for( j = 0; j < N; j++)
-                jpvt[j] = 0;
-            
-            /* copy A to gpu */
-            magma_zsetmatrix( M, N, h_R, lda, d_A, lda, opts.queue );
-
-            /* call gpu-interface */
-            gpu_time = magma_wtime();
-            magma_zgeqp3_gpu( M, N, d_A, lda, jpvt, dtau, d_work, lwork,
-                              #ifdef COMPLEX
-                              drwork,
-                              #endif
-                              &info );
-            gpu_time = magma_wtime() - gpu_time;
+            /* copy A to gpu, then call gpu-interface */
+            magma_timing gpu_times = magma_repeat( opts,
+                [&]() {
+                    magma_zsetmatrix( M, N, h_A, lda, d_A, lda, opts.queue );
+                    for( j = 0; j < N; j++)
+                        jpvt[j] = 0;
+                },
+                [&]() {
+                    real_Double_t time = magma_wtime();
+                    magma_zgeqp3_gpu( M, N, d_A, lda, jpvt, dtau, d_work, lwork,
+                                      #ifdef COMPLEX
+                                      drwork,
+                                      #endif
+                                      &info );
+                    return magma_wtime() - time;
+                });
+            gpu_time = gpu_times.minimum();
             
             /* copy outputs to cpu */
             magma_zgetmatrix( M, N, d_A, lda, h_R, lda, opts.queue );
             magma_zgetvector( min_mn, dtau, 1, tau, 1, opts.queue );
             
             gpu_perf = gflops / gpu_time;
+            results.add( "magma", gpu_times, gflops );
             if (info != 0) {
                 printf("magma_zgeqp3 returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -168,6 +181,8 @@ int main( int argc, char** argv)
                 error *= ulp;
                 printf("   %8.2e   %s\n", error, (error < tol ? "ok" : "failed"));
                 status += ! (error < tol);
+                results.add( "error", error );
+                results.add( "status", (error < tol ? "ok" : "failed") );
             }
             else {
                 printf("     ---  \n");
@@ -187,6 +202,7 @@ int main( int argc, char** argv)
             magma_free( dtau   );
             magma_free( d_A    );
             magma_free( d_work );
+            results.end_row();
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
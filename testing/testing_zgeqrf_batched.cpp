@@ -154,7 +154,7 @@ int main( int argc, char** argv)
 
             column = N * batchCount;
             /* Initialize the matrix */
-            lapackf77_zlarnv( &ione, ISEED, &n2, h_A );
+            magma_zlarnv( ione, ISEED, n2, h_A );
             lapackf77_zlacpy( MagmaFullStr, &M, &column, h_A, &lda, h_R, &lda );
        
             /* ====================================================================
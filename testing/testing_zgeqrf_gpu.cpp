@@ -43,6 +43,7 @@ int main( int argc, char** argv)
     
     magma_opts opts;
     opts.parse_opts( argc, argv );
+    magma_results results( opts, "zgeqrf_gpu" );
     
     int status = 0;
     double tol = opts.tolerance * lapackf77_dlamch("E");
@@ -76,6 +77,8 @@ int main( int argc, char** argv)
             ldda   = magma_roundup( M, opts.align );  // multiple of 32 by default
             nb     = magma_get_zgeqrf_nb( M, N );
             gflops = FLOPS_ZGEQRF( M, N ) / 1e9;
+            results.add( "M", M );
+            results.add( "N", N );
             
             // query for workspace size
             lwork = -1;
@@ -98,35 +101,43 @@ int main( int argc, char** argv)
             
             /* Initialize the matrix */
             magma_generate_matrix( opts, M, N, h_A, lda );
-            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda );
-            magma_zsetmatrix( M, N, h_R, lda, d_A, ldda, opts.queue );
             
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
             nb = magma_get_zgeqrf_nb( M, N );
             
-            gpu_time = magma_wtime();
-            if ( opts.version == 1 ) {
-                // stores dT, V blocks have zeros, R blocks inverted & stored in dT
-                magma_zgeqrf_gpu( M, N, d_A, ldda, tau, dT, &info );
-            }
-            else if ( opts.version == 2 ) {
-                // LAPACK complaint arguments
-                magma_zgeqrf2_gpu( M, N, d_A, ldda, tau, &info );
-            }
+            bool known = (opts.version == 1 || opts.version == 2);
             #if defined(MAGMA_HAVE_CUDA) || defined(MAGMA_HAVE_HIP)
-            else if ( opts.version == 3 ) {
-                // stores dT, V blocks have zeros, R blocks stored in dT
-                magma_zgeqrf3_gpu( M, N, d_A, ldda, tau, dT, &info );
-            }
+            known = known || (opts.version == 3);
             #endif
-            else {
+            if ( ! known ) {
                 printf( "Unknown version %lld\n", (long long) opts.version );
                 return -1;
             }
-            gpu_time = magma_wtime() - gpu_time;
+            magma_timing gpu_times = magma_repeat( opts,
+                [&]() { magma_zsetmatrix( M, N, h_A, lda, d_A, ldda, opts.queue ); },
+                [&]() {
+                    real_Double_t time = magma_wtime();
+                    if ( opts.version == 1 ) {
+                        // stores dT, V blocks have zeros, R blocks inverted & stored in dT
+                        magma_zgeqrf_gpu( M, N, d_A, ldda, tau, dT, &info );
+                    }
+                    else if ( opts.version == 2 ) {
+                        // LAPACK complaint arguments
+                        magma_zgeqrf2_gpu( M, N, d_A, ldda, tau, &info );
+                    }
+                    #if defined(MAGMA_HAVE_CUDA) || defined(MAGMA_HAVE_HIP)
+                    else if ( opts.version == 3 ) {
+                        // stores dT, V blocks have zeros, R blocks stored in dT
+                        magma_zgeqrf3_gpu( M, N, d_A, ldda, tau, dT, &info );
+                    }
+                    #endif
+                    return magma_wtime() - time;
+                });
+            gpu_time = gpu_times.minimum();
             gpu_perf = gflops / gpu_time;
+            results.add( "magma", gpu_times, gflops );
             if (info != 0) {
                 printf("magma_zgeqrf returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -198,7 +209,7 @@ int main( int argc, char** argv)
                 // initialize RHS, b = A*random
                 TESTING_CHECK( magma_zmalloc_cpu( &x, N ));
                 TESTING_CHECK( magma_zmalloc_cpu( &b, M ));
-                lapackf77_zlarnv( &ione, ISEED, &N, x );
+                magma_zlarnv( ione, ISEED, N, x );
                 blasf77_zgemv( "Notrans", &M, &N, &c_one, h_A, &lda, x, &ione, &c_zero, b, &ione );
                 // copy to GPU
                 TESTING_CHECK( magma_zmalloc( &d_B, M ));
@@ -268,10 +279,16 @@ int main( int argc, char** argv)
                Performs operation using LAPACK
                =================================================================== */
             if ( opts.lapack ) {
-                cpu_time = magma_wtime();
-                lapackf77_zgeqrf( &M, &N, h_A, &lda, tau, h_work, &lwork, &info );
-                cpu_time = magma_wtime() - cpu_time;
+                magma_timing cpu_times = magma_repeat( opts,
+                    [&]() { lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda ); },
+                    [&]() {
+                        real_Double_t time = magma_wtime();
+                        lapackf77_zgeqrf( &M, &N, h_R, &lda, tau, h_work, &lwork, &info );
+                        return magma_wtime() - time;
+                    });
+                cpu_time = cpu_times.minimum();
                 cpu_perf = gflops / cpu_time;
+                results.add( "cpu", cpu_times, gflops );
                 if (info != 0) {
                     printf("lapackf77_zgeqrf returned error %lld: %s.\n",
                            (long long) info, magma_strerror( info ));
@@ -293,12 +310,17 @@ int main( int argc, char** argv)
                 bool okay = (error < tol && error2 < tol);
                 status += ! okay;
                 printf( "%11.2e   %11.2e   %s\n", error, error2, (okay ? "ok" : "failed") );
+                results.add( "error", error );
+                results.add( "ortho_error", error2 );
+                results.add( "status", (okay ? "ok" : "failed") );
             }
             else if ( opts.check == 2 ) {
                 if ( M >= N ) {
                     bool okay = (error < tol);
                     status += ! okay;
                     printf( "%10.2e   %s\n", error, (okay ? "ok" : "failed") );
+                    results.add( "error", error );
+                    results.add( "status", (okay ? "ok" : "failed") );
                 }
                 else {
                     printf( "(error check only for M >= N)\n" );
@@ -320,6 +342,7 @@ int main( int argc, char** argv)
                 magma_free( dT );
             }
             
+            results.end_row();
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
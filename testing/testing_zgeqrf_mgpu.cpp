@@ -43,6 +43,7 @@ int main( int argc, char** argv )
     magma_opts opts;
     opts.parse_opts( argc, argv );
     opts.ngpu = abs( opts.ngpu );  // always uses multi-GPU code
+    magma_results results( opts, "zgeqrf_mgpu" );
  
     int status = 0;
     double tol = opts.tolerance * lapackf77_dlamch("E");
@@ -65,6 +66,8 @@ int main( int argc, char** argv )
             ldda   = magma_roundup( M, opts.align );  // multiple of 32 by default
             nb     = magma_get_zgeqrf_nb( M, N );
             gflops = FLOPS_ZGEQRF( M, N ) / 1e9;
+            results.add( "M", M );
+            results.add( "N", N );
             
             // ngpu must be at least the number of blocks
             ngpu = min( opts.ngpu, magma_ceildiv(N,nb) );
@@ -98,17 +101,20 @@ int main( int argc, char** argv )
             
             /* Initialize the matrix */
             magma_generate_matrix( opts, M, N, h_A, lda );
-            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda );
             
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
-            magma_zsetmatrix_1D_col_bcyclic( ngpu, M, N, nb, h_R, lda, d_lA, ldda, queues );
-
-            gpu_time = magma_wtime();
-            magma_zgeqrf2_mgpu( ngpu, M, N, d_lA, ldda, tau, &info );
-            gpu_time = magma_wtime() - gpu_time;
+            magma_timing gpu_times = magma_repeat( opts,
+                [&]() { magma_zsetmatrix_1D_col_bcyclic( ngpu, M, N, nb, h_A, lda, d_lA, ldda, queues ); },
+                [&]() {
+                    real_Double_t time = magma_wtime();
+                    magma_zgeqrf2_mgpu( ngpu, M, N, d_lA, ldda, tau, &info );
+                    return magma_wtime() - time;
+                });
+            gpu_time = gpu_times.minimum();
             gpu_perf = gflops / gpu_time;
+            results.add( "magma", gpu_times, gflops );
             if (info != 0) {
                 printf("magma_zgeqrf2_mgpu returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -163,10 +169,16 @@ int main( int argc, char** argv )
                Performs operation using LAPACK
                =================================================================== */
             if ( opts.lapack ) {
-                cpu_time = magma_wtime();
-                lapackf77_zgeqrf( &M, &N, h_A, &lda, tau, h_work, &lwork, &info );
-                cpu_time = magma_wtime() - cpu_time;
+                magma_timing cpu_times = magma_repeat( opts,
+                    [&]() { lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda ); },
+                    [&]() {
+                        real_Double_t time = magma_wtime();
+                        lapackf77_zgeqrf( &M, &N, h_R, &lda, tau, h_work, &lwork, &info );
+                        return magma_wtime() - time;
+                    });
+                cpu_time = cpu_times.minimum();
                 cpu_perf = gflops / cpu_time;
+                results.add( "cpu", cpu_times, gflops );
                 if (info != 0) {
                     printf("lapackf77_zgeqrf returned error %lld: %s.\n",
                            (long long) info, magma_strerror( info ));
@@ -188,6 +200,9 @@ int main( int argc, char** argv )
                 bool okay = (error < tol && error2 < tol);
                 status += ! okay;
                 printf( "%11.2e   %11.2e   %s\n", error, error2, (okay ? "ok" : "failed") );
+                results.add( "error", error );
+                results.add( "ortho_error", error2 );
+                results.add( "status", (okay ? "ok" : "failed") );
             }
             else {
                 printf( "    ---\n" );
@@ -203,6 +218,7 @@ int main( int argc, char** argv )
                 magma_setdevice( dev );
                 magma_free( d_lA[dev] );
             }
+            results.end_row();
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
@@ -41,6 +41,7 @@ int main(int argc, char **argv)
     
     magma_opts opts;
     opts.parse_opts( argc, argv );
+    magma_results results( opts, "zgesv" );
     
     double tol = opts.tolerance * lapackf77_dlamch("E");
     
@@ -60,6 +61,8 @@ int main(int argc, char **argv)
             lda    = N;
             ldb    = lda;
             gflops = ( FLOPS_ZGETRF( N, N ) + FLOPS_ZGETRS( N, nrhs ) ) / 1e9;
+            results.add( "N", N );
+            results.add( "nrhs", nrhs );
             
             TESTING_CHECK( magma_zmalloc_cpu( &h_A,  lda*N    ));
             TESTING_CHECK( magma_zmalloc_cpu( &h_LU, lda*N    ));
@@ -73,20 +76,27 @@ int main(int argc, char **argv)
             //sizeA = lda*N;
             sizeB = ldb*nrhs;
             magma_generate_matrix( opts, N, N, h_A, lda );
-            lapackf77_zlarnv( &ione, ISEED, &sizeB, h_B );
+            magma_zlarnv( ione, ISEED, sizeB, h_B );
             
-            // copy A to LU and B to X; save A and B for residual
-            lapackf77_zlacpy( "F", &N, &N,    h_A, &lda, h_LU, &lda );
-            lapackf77_zlacpy( "F", &N, &nrhs, h_B, &ldb, h_X,  &ldb );
+            // save A and B for residual; each run copies A to LU and B to X
             lapackf77_zlacpy( "F", &N, &nrhs, h_B, &ldb, h_B0, &ldb );
+            auto copy_AB = [&]() {
+                lapackf77_zlacpy( "F", &N, &N,    h_A,  &lda, h_LU, &lda );
+                lapackf77_zlacpy( "F", &N, &nrhs, h_B0, &ldb, h_X,  &ldb );
+            };
             
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
-            gpu_time = magma_wtime();
-            magma_zgesv( N, nrhs, h_LU, lda, ipiv, h_X, ldb, &info );
-            gpu_time = magma_wtime() - gpu_time;
+            magma_timing gpu_times = magma_repeat( opts, copy_AB,
+                [&]() {
+                    real_Double_t time = magma_wtime();
+                    magma_zgesv( N, nrhs, h_LU, lda, ipiv, h_X, ldb, &info );
+                    return magma_wtime() - time;
+                });
+            gpu_time = gpu_times.minimum();
             gpu_perf = gflops / gpu_time;
+            results.add( "magma", gpu_times, gflops );
             if (info != 0) {
                 printf("magma_zgesv returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -107,18 +117,22 @@ int main(int argc, char **argv)
             error = Rnorm/(N*Anorm*Xnorm);
             bool okay = (error < tol);
             status += ! okay;
+            results.add( "error", error );
+            results.add( "status", (okay ? "ok" : "failed") );
             
             /* ====================================================================
                Performs operation using LAPACK
                =================================================================== */
             if ( opts.lapack ) {
-                lapackf77_zlacpy( "F", &N, &N,    h_A,  &lda, h_LU, &lda );
-                lapackf77_zlacpy( "F", &N, &nrhs, h_B0, &ldb, h_X,  &ldb );
-
-                cpu_time = magma_wtime();
-                lapackf77_zgesv( &N, &nrhs, h_LU, &lda, ipiv, h_X, &ldb, &info );
-                cpu_time = magma_wtime() - cpu_time;
+                magma_timing cpu_times = magma_repeat( opts, copy_AB,
+                    [&]() {
+                        real_Double_t time = magma_wtime();
+                        lapackf77_zgesv( &N, &nrhs, h_LU, &lda, ipiv, h_X, &ldb, &info );
+                        return magma_wtime() - time;
+                    });
+                cpu_time = cpu_times.minimum();
                 cpu_perf = gflops / cpu_time;
+                results.add( "cpu", cpu_times, gflops );
                 if (info != 0) {
                     printf("lapackf77_zgesv returned error %lld: %s.\n",
                            (long long) info, magma_strerror( info ));
@@ -134,6 +148,7 @@ int main(int argc, char **argv)
                 Rnorm = lapackf77_zlange("I", &N, &nrhs, h_B0, &ldb, work);
                 lerror = Rnorm/(N*Anorm*Xnorm);
                 bool lokay = (lerror < tol);
+                results.add( "cpu_error", lerror );
                 printf( "%5lld %5lld   %7.2f (%7.2f)   %7.2f (%7.2f)   %8.2e   %-6s           %8.2e   %s\n",
                         (long long) N, (long long) nrhs, cpu_perf, cpu_time, gpu_perf, gpu_time,
                         error, (okay ? "ok" : "failed"),
@@ -152,6 +167,7 @@ int main(int argc, char **argv)
             magma_free_cpu( h_X  );
             magma_free_cpu( work );
             magma_free_cpu( ipiv );
+            results.end_row();
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
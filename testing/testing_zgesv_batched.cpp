@@ -93,8 +93,8 @@ int main(int argc, char **argv)
             TESTING_CHECK( magma_malloc( (void**) &dipiv_array, batchCount * sizeof(magma_int_t*) ));
 
             /* Initialize the matrices */
-            lapackf77_zlarnv( &ione, ISEED, &sizeA, h_A );
-            lapackf77_zlarnv( &ione, ISEED, &sizeB, h_B );
+            magma_zlarnv( ione, ISEED, sizeA, h_A );
+            magma_zlarnv( ione, ISEED, sizeB, h_B );
 
             magma_zsetmatrix( N, N*batchCount,    h_A, lda, d_A, ldda, opts.queue );
             magma_zsetmatrix( N, nrhs*batchCount, h_B, ldb, d_B, lddb, opts.queue );
@@ -32,7 +32,7 @@ int main(int argc, char **argv)
     double          error, Rnorm, Anorm, Xnorm, *work;
     magmaDoubleComplex c_one     = MAGMA_Z_ONE;
     magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
-    magmaDoubleComplex *h_A, *h_B, *h_X;
+    magmaDoubleComplex *h_A, *h_B, *h_X, *h_LU;
     magmaDoubleComplex_ptr d_A, d_B;
     magma_int_t *ipiv;
     magma_int_t N, nrhs, lda, ldb, ldda, lddb, info, sizeB;
@@ -42,6 +42,7 @@ int main(int argc, char **argv)
     
     magma_opts opts;
     opts.parse_opts( argc, argv );
+    magma_results results( opts, "zgesv_gpu" );
     
     double tol = opts.tolerance * lapackf77_dlamch("E");
     
@@ -57,8 +58,11 @@ int main(int argc, char **argv)
             ldda   = magma_roundup( N, opts.align );  // multiple of 32 by default
             lddb   = ldda;
             gflops = ( FLOPS_ZGETRF( N, N ) + FLOPS_ZGETRS( N, nrhs ) ) / 1e9;
+            results.add( "N", N );
+            results.add( "nrhs", nrhs );
             
             TESTING_CHECK( magma_zmalloc_cpu( &h_A, lda*N    ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_LU, lda*N   ));
             TESTING_CHECK( magma_zmalloc_cpu( &h_B, ldb*nrhs ));
             TESTING_CHECK( magma_zmalloc_cpu( &h_X, ldb*nrhs ));
             TESTING_CHECK( magma_dmalloc_cpu( &work, N ));
@@ -71,18 +75,25 @@ int main(int argc, char **argv)
             //sizeA = lda*N;
             sizeB = ldb*nrhs;
             magma_generate_matrix( opts, N, N, h_A, lda );
-            lapackf77_zlarnv( &ione, ISEED, &sizeB, h_B );
-            
-            magma_zsetmatrix( N, N,    h_A, lda, d_A, ldda, opts.queue );
-            magma_zsetmatrix( N, nrhs, h_B, ldb, d_B, lddb, opts.queue );
+            magma_zlarnv( ione, ISEED, sizeB, h_B );
             
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
-            gpu_time = magma_wtime();
-            magma_zgesv_gpu( N, nrhs, d_A, ldda, ipiv, d_B, lddb, &info );
-            gpu_time = magma_wtime() - gpu_time;
+            // each run solves with fresh copies of A and B
+            magma_timing gpu_times = magma_repeat( opts,
+                [&]() {
+                    magma_zsetmatrix( N, N,    h_A, lda, d_A, ldda, opts.queue );
+                    magma_zsetmatrix( N, nrhs, h_B, ldb, d_B, lddb, opts.queue );
+                },
+                [&]() {
+                    real_Double_t time = magma_wtime();
+                    magma_zgesv_gpu( N, nrhs, d_A, ldda, ipiv, d_B, lddb, &info );
+                    return magma_wtime() - time;
+                });
+            gpu_time = gpu_times.minimum();
             gpu_perf = gflops / gpu_time;
+            results.add( "magma", gpu_times, gflops );
             if (info != 0) {
                 printf("magma_zgesv_gpu returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -104,15 +115,26 @@ int main(int argc, char **argv)
             Rnorm = lapackf77_zlange("I", &N, &nrhs, h_B, &ldb, work);
             error = Rnorm/(N*Anorm*Xnorm);
             status += ! (error < tol);
+            results.add( "error", error );
+            results.add( "status", (error < tol ? "ok" : "failed") );
             
             /* ====================================================================
                Performs operation using LAPACK
                =================================================================== */
             if ( opts.lapack ) {
-                cpu_time = magma_wtime();
-                lapackf77_zgesv( &N, &nrhs, h_A, &lda, ipiv, h_B, &ldb, &info );
-                cpu_time = magma_wtime() - cpu_time;
+                magma_timing cpu_times = magma_repeat( opts,
+                    [&]() {
+                        lapackf77_zlacpy( MagmaFullStr, &N, &N,    h_A, &lda, h_LU, &lda );
+                        lapackf77_zlacpy( MagmaFullStr, &N, &nrhs, h_B, &ldb, h_X,  &ldb );
+                    },
+                    [&]() {
+                        real_Double_t time = magma_wtime();
+                        lapackf77_zgesv( &N, &nrhs, h_LU, &lda, ipiv, h_X, &ldb, &info );
+                        return magma_wtime() - time;
+                    });
+                cpu_time = cpu_times.minimum();
                 cpu_perf = gflops / cpu_time;
+                results.add( "cpu", cpu_times, gflops );
                 if (info != 0) {
                     printf("lapackf77_zgesv returned error %lld: %s.\n",
                            (long long) info, magma_strerror( info ));
@@ -129,6 +151,7 @@ int main(int argc, char **argv)
             }
             
             magma_free_cpu( h_A );
+            magma_free_cpu( h_LU );
             magma_free_cpu( h_B );
             magma_free_cpu( h_X );
             magma_free_cpu( work );
@@ -136,6 +159,7 @@ int main(int argc, char **argv)
             
             magma_free( d_A );
             magma_free( d_B );
+            results.end_row();
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
@@ -82,8 +82,8 @@ int main(int argc, char **argv)
             /* Initialize the matrices */
             sizeA = n2;
             sizeB = ldb*nrhs*batchCount;
-            lapackf77_zlarnv( &ione, ISEED, &sizeA, h_A );
-            lapackf77_zlarnv( &ione, ISEED, &sizeB, h_B );
+            magma_zlarnv( ione, ISEED, sizeA, h_A );
+            magma_zlarnv( ione, ISEED, sizeB, h_B );
             // make A diagonally dominant, to not need pivoting
             for( int s=0; s < batchCount; ++s ) {
                 for( int i=0; i < N; ++i ) {
@@ -130,7 +130,7 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_malloc( (void**) &dipiv_array, batchCount * sizeof(magma_int_t*) ));
 
             /* Initialize the matrix */
-            lapackf77_zlarnv( &ione, ISEED, &n2, h_A );
+            magma_zlarnv( ione, ISEED, n2, h_A );
             columns = N * batchCount;
             lapackf77_zlacpy( MagmaFullStr, &M, &columns, h_A, &lda, h_R, &lda );
             
@@ -72,7 +72,7 @@ double get_residual(
     // initialize RHS
     TESTING_CHECK( magma_zmalloc_cpu( &x, n ));
     TESTING_CHECK( magma_zmalloc_cpu( &b, n ));
-    lapackf77_zlarnv( &ione, ISEED, &n, b );
+    magma_zlarnv( ione, ISEED, n, b );
     blasf77_zcopy( &n, b, &ione, x, &ione );
     
     // solve Ax = b
@@ -177,6 +177,7 @@ int main( int argc, char** argv)
 
     magma_opts opts;
     opts.parse_opts( argc, argv );
+    magma_results results( opts, "zgetrf_gpu" );
 
     double tol = opts.tolerance * lapackf77_dlamch("E");
     
@@ -197,6 +198,8 @@ int main( int argc, char** argv)
             n2     = lda*N;
             ldda   = magma_roundup( M, opts.align );  // multiple of 32 by default
             gflops = FLOPS_ZGETRF( M, N ) / 1e9;
+            results.add( "M", M );
+            results.add( "N", N );
             
             TESTING_CHECK( magma_imalloc_cpu( &ipiv, min_mn ));
             TESTING_CHECK( magma_zmalloc_cpu( &h_A,  n2     ));
@@ -206,12 +209,16 @@ int main( int argc, char** argv)
                Performs operation using LAPACK
                =================================================================== */
             if ( opts.lapack ) {
-                init_matrix( opts, M, N, h_A, lda );
-                
-                cpu_time = magma_wtime();
-                lapackf77_zgetrf( &M, &N, h_A, &lda, ipiv, &info );
-                cpu_time = magma_wtime() - cpu_time;
+                magma_timing cpu_times = magma_repeat( opts,
+                    [&]() { init_matrix( opts, M, N, h_A, lda ); },
+                    [&]() {
+                        real_Double_t time = magma_wtime();
+                        lapackf77_zgetrf( &M, &N, h_A, &lda, ipiv, &info );
+                        return magma_wtime() - time;
+                    });
+                cpu_time = cpu_times.minimum();
                 cpu_perf = gflops / cpu_time;
+                results.add( "cpu", cpu_times, gflops );
                 if (info != 0) {
                     printf("lapackf77_zgetrf returned error %lld: %s.\n",
                            (long long) info, magma_strerror( info ));
@@ -221,27 +228,34 @@ int main( int argc, char** argv)
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
-            init_matrix( opts, M, N, h_A, lda );
             if ( opts.version == 2 ) {
                 // no pivoting versions, so set ipiv to identity
                 for (magma_int_t i=0; i < min_mn; ++i ) {
                     ipiv[i] = i+1;
                 }
             }
-            magma_zsetmatrix( M, N, h_A, lda, d_A, ldda, opts.queue );
             
-            gpu_time = magma_wtime();
-            if ( opts.version == 1 ) {
-                magma_zgetrf_gpu( M, N, d_A, ldda, ipiv, &info);
-            }
-            else if ( opts.version == 2 ) {
-                magma_zgetrf_nopiv_gpu( M, N, d_A, ldda, &info);
-            }
-            else if ( opts.version == 3 ) {
-                magma_zgetrf_native( M, N, d_A, ldda, ipiv, &info);
-            }
-            gpu_time = magma_wtime() - gpu_time;
+            magma_timing gpu_times = magma_repeat( opts,
+                [&]() {
+                    init_matrix( opts, M, N, h_A, lda );
+                    magma_zsetmatrix( M, N, h_A, lda, d_A, ldda, opts.queue );
+                },
+                [&]() {
+                    real_Double_t time = magma_wtime();
+                    if ( opts.version == 1 ) {
+                        magma_zgetrf_gpu( M, N, d_A, ldda, ipiv, &info);
+                    }
+                    else if ( opts.version == 2 ) {
+                        magma_zgetrf_nopiv_gpu( M, N, d_A, ldda, &info);
+                    }
+                    else if ( opts.version == 3 ) {
+                        magma_zgetrf_native( M, N, d_A, ldda, ipiv, &info);
+                    }
+                    return magma_wtime() - time;
+                });
+            gpu_time = gpu_times.minimum();
             gpu_perf = gflops / gpu_time;
+            results.add( "magma", gpu_times, gflops );
             if (info != 0) {
                 printf("magma_zgetrf_gpu returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -263,12 +277,16 @@ int main( int argc, char** argv)
                 error = get_residual( opts, M, N, h_A, lda, ipiv );
                 printf("   %8.2e   %s\n", error, (error < tol ? "ok" : "failed"));
                 status += ! (error < tol);
+                results.add( "error", error );
+                results.add( "status", (error < tol ? "ok" : "failed") );
             }
             else if ( opts.check ) {
                 magma_zgetmatrix( M, N, d_A, ldda, h_A, lda, opts.queue );
                 error = get_LU_error( opts, M, N, h_A, lda, ipiv );
                 printf("   %8.2e   %s\n", error, (error < tol ? "ok" : "failed"));
                 status += ! (error < tol);
+                results.add( "error", error );
+                results.add( "status", (error < tol ? "ok" : "failed") );
             }
             else {
                 printf("     ---  \n");
@@ -277,6 +295,7 @@ int main( int argc, char** argv)
             magma_free_cpu( ipiv );
             magma_free_cpu( h_A );
             magma_free( d_A );
+            results.end_row();
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
@@ -72,7 +72,7 @@ double get_residual(
     // initialize RHS
     TESTING_CHECK( magma_zmalloc_cpu( &x, n ));
     TESTING_CHECK( magma_zmalloc_cpu( &b, n ));
-    lapackf77_zlarnv( &ione, ISEED, &n, b );
+    magma_zlarnv( ione, ISEED, n, b );
     blasf77_zcopy( &n, b, &ione, x, &ione );
     
     // solve Ax = b
@@ -179,6 +179,7 @@ int main( int argc, char** argv )
     magma_opts opts;
     opts.parse_opts( argc, argv );
     opts.ngpu = abs( opts.ngpu );  // always uses multi-GPU code
+    magma_results results( opts, "zgetrf_mgpu" );
     
     double tol = opts.tolerance * lapackf77_dlamch("E");
 
@@ -205,6 +206,8 @@ int main( int argc, char** argv )
             ldda   = magma_roundup( M, opts.align );  // multiple of 32 by default
             nb     = magma_get_zgetrf_nb( M, N );
             gflops = FLOPS_ZGETRF( M, N ) / 1e9;
+            results.add( "M", M );
+            results.add( "N", N );
             
             // ngpu must be at least the number of blocks
             ngpu = min( opts.ngpu, magma_ceildiv(N,nb) );
@@ -232,12 +235,16 @@ int main( int argc, char** argv )
                Performs operation using LAPACK
                =================================================================== */
             if ( opts.lapack ) {
-                init_matrix( opts, M, N, h_A, lda );
-                
-                cpu_time = magma_wtime();
-                lapackf77_zgetrf( &M, &N, h_A, &lda, ipiv, &info );
-                cpu_time = magma_wtime() - cpu_time;
+                magma_timing cpu_times = magma_repeat( opts,
+                    [&]() { init_matrix( opts, M, N, h_A, lda ); },
+                    [&]() {
+                        real_Double_t time = magma_wtime();
+                        lapackf77_zgetrf( &M, &N, h_A, &lda, ipiv, &info );
+                        return magma_wtime() - time;
+                    });
+                cpu_time = cpu_times.minimum();
                 cpu_perf = gflops / cpu_time;
+                results.add( "cpu", cpu_times, gflops );
                 if (info != 0) {
                     printf("lapackf77_zgetrf returned error %lld: %s.\n",
                            (long long) info, magma_strerror( info ));
@@ -247,13 +254,19 @@ int main( int argc, char** argv )
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
-            init_matrix( opts, M, N, h_A, lda );
-            magma_zsetmatrix_1D_col_bcyclic( ngpu, M, N, nb, h_A, lda, d_lA, ldda, queues );
-
-            gpu_time = magma_wtime();
-            magma_zgetrf_mgpu( ngpu, M, N, d_lA, ldda, ipiv, &info );
-            gpu_time = magma_wtime() - gpu_time;
+            magma_timing gpu_times = magma_repeat( opts,
+                [&]() {
+                    init_matrix( opts, M, N, h_A, lda );
+                    magma_zsetmatrix_1D_col_bcyclic( ngpu, M, N, nb, h_A, lda, d_lA, ldda, queues );
+                },
+                [&]() {
+                    real_Double_t time = magma_wtime();
+                    magma_zgetrf_mgpu( ngpu, M, N, d_lA, ldda, ipiv, &info );
+                    return magma_wtime() - time;
+                });
+            gpu_time = gpu_times.minimum();
             gpu_perf = gflops / gpu_time;
+            results.add( "magma", gpu_times, gflops );
             if (info != 0) {
                 printf("magma_zgetrf_mgpu returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -276,11 +289,15 @@ int main( int argc, char** argv )
                 error = get_residual( opts, M, N, h_A, lda, ipiv );
                 printf("   %8.2e   %s\n", error, (error < tol ? "ok" : "failed"));
                 status += ! (error < tol);
+                results.add( "error", error );
+                results.add( "status", (error < tol ? "ok" : "failed") );
             }
             else if ( opts.check ) {
                 error = get_LU_error( opts, M, N, h_A, lda, ipiv );
                 printf("   %8.2e   %s\n", error, (error < tol ? "ok" : "failed"));
                 status += ! (error < tol);
+                results.add( "error", error );
+                results.add( "status", (error < tol ? "ok" : "failed") );
             }
             else {
                 printf( "     ---\n" );
@@ -292,6 +309,7 @@ int main( int argc, char** argv )
                 magma_setdevice( dev );
                 magma_free( d_lA[dev] );
             }
+            results.end_row();
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
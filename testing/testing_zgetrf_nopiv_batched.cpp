@@ -123,7 +123,7 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_malloc( (void**) &dipiv_array, batchCount * sizeof(magma_int_t*) ));
 
             /* Initialize the matrix */
-            lapackf77_zlarnv( &ione, ISEED, &n2, h_A );
+            magma_zlarnv( ione, ISEED, n2, h_A );
             // make A diagonally dominant, to not need pivoting
             for( int s=0; s < batchCount; ++s ) {
                 for( int i=0; i < min_mn; ++i ) {
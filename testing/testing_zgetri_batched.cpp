@@ -103,7 +103,7 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_imalloc( &dinfo_array, batchCount ));
             
             /* Initialize the matrix */
-            lapackf77_zlarnv( &ione, ISEED, &n2, h_A );
+            magma_zlarnv( ione, ISEED, n2, h_A );
             columns = N * batchCount;
             lapackf77_zlacpy( MagmaFullStr, &N, &columns, h_A, &lda, h_R,  &lda );
             lapackf77_zlacpy( MagmaFullStr, &N, &columns, h_A, &lda, h_Ainv, &lda );
@@ -44,6 +44,7 @@ int main( int argc, char** argv )
     
     magma_opts opts;
     opts.parse_opts( argc, argv );
+    magma_results results( opts, "zgetri_gpu" );
     
     double tol = opts.tolerance * lapackf77_dlamch("E");
     
@@ -57,6 +58,7 @@ int main( int argc, char** argv )
             ldda   = magma_roundup( N, opts.align );  // multiple of 32 by default
             ldwork = N * magma_get_zgetri_nb( N );
             gflops = FLOPS_ZGETRI( N ) / 1e9;
+            results.add( "N", N );
             
             // query for workspace size
             lwork = -1;
@@ -81,8 +83,9 @@ int main( int argc, char** argv )
             
             /* Factor the matrix. Both MAGMA and LAPACK will use this factor. */
             magma_zsetmatrix( N, N, h_A, lda, d_A, ldda, opts.queue );
+            // The factor is kept in h_R; each run inverts a fresh copy of it.
             magma_zgetrf_gpu( N, N, d_A, ldda, ipiv, &info );
-            magma_zgetmatrix( N, N, d_A, ldda, h_Ainv, lda, opts.queue );
+            magma_zgetmatrix( N, N, d_A, ldda, h_R, lda, opts.queue );
             if (info != 0) {
                 printf("magma_zgetrf_gpu returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -95,10 +98,16 @@ int main( int argc, char** argv )
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
-            gpu_time = magma_wtime();
-            magma_zgetri_gpu( N, d_A, ldda, ipiv, dwork, ldwork, &info );
-            gpu_time = magma_wtime() - gpu_time;
+            magma_timing gpu_times = magma_repeat( opts,
+                [&]() { magma_zsetmatrix( N, N, h_R, lda, d_A, ldda, opts.queue ); },
+                [&]() {
+                    real_Double_t time = magma_wtime();
+                    magma_zgetri_gpu( N, d_A, ldda, ipiv, dwork, ldwork, &info );
+                    return magma_wtime() - time;
+                });
+            gpu_time = gpu_times.minimum();
             gpu_perf = gflops / gpu_time;
+            results.add( "magma", gpu_times, gflops );
             if (info != 0) {
                 printf("magma_zgetri_gpu returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -108,10 +117,16 @@ int main( int argc, char** argv )
                Performs operation using LAPACK
                =================================================================== */
             if ( opts.lapack ) {
-                cpu_time = magma_wtime();
-                lapackf77_zgetri( &N, h_Ainv, &lda, ipiv, work, &lwork, &info );
-                cpu_time = magma_wtime() - cpu_time;
+                magma_timing cpu_times = magma_repeat( opts,
+                    [&]() { lapackf77_zlacpy( MagmaFullStr, &N, &N, h_R, &lda, h_Ainv, &lda ); },
+                    [&]() {
+                        real_Double_t time = magma_wtime();
+                        lapackf77_zgetri( &N, h_Ainv, &lda, ipiv, work, &lwork, &info );
+                        return magma_wtime() - time;
+                    });
+                cpu_time = cpu_times.minimum();
                 cpu_perf = gflops / cpu_time;
+                results.add( "cpu", cpu_times, gflops );
                 if (info != 0) {
                     printf("lapackf77_zgetri returned error %lld: %s.\n",
                            (long long) info, magma_strerror( info ));
@@ -154,6 +169,8 @@ int main( int argc, char** argv )
                 
                 bool okay = (error < tol);
                 status += ! okay;
+                results.add( "error", error );
+                results.add( "status", (okay ? "ok" : "failed") );
                 printf( "   %8.2e   %s\n",
                         error, (okay ? "ok" : "failed"));
             }
@@ -169,6 +186,7 @@ int main( int argc, char** argv )
             
             magma_free( d_A    );
             magma_free( dwork  );
+            results.end_row();
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
@@ -0,0 +1,275 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "magma_operators.h"
+#include "testings.h"
+#include "../control/magma_threadsetting.h"  // internal header
+
+#define COMPLEX
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing zheevd_batched_cpu and zheevd_vbatched_cpu
+      --version 1: batch of N-by-N matrices       (magma_zheevd_batched_cpu)
+      --version 2: batch of sizes random in [1, N] (magma_zheevd_vbatched_cpu)
+      LAPACK time is a loop calling lapackf77_zheevd for each matrix.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    /* Constants */
+    const magma_int_t izero = 0;
+    const magma_int_t ione  = 1;
+    const magma_int_t ineg_one = -1;
+
+    /* Local variables */
+    real_Double_t   magma_time, cpu_time;
+    magmaDoubleComplex *h_A, *h_R, *h_work, aux_work[1], unused[1];
+    #ifdef COMPLEX
+    double *rwork, aux_rwork[1];
+    magma_int_t lrwork;
+    #endif
+    double *w1, *w2, result[2], eps, runused[1];
+    magma_int_t *iwork, aux_iwork[1];
+    magma_int_t N, max_N, info, lwork, liwork, total;
+    magma_int_t ISEED[4] = {0,0,0,1};
+    eps = lapackf77_dlamch( "E" );
+    int status = 0;
+
+    magma_opts opts( MagmaOptsBatched );
+    opts.parse_opts( argc, argv );
+    opts.lapack |= opts.check;  // check (-c) implies lapack (-l)
+
+    magma_int_t batchCount = opts.batchcount;
+    double tol    = opts.tolerance * lapackf77_dlamch("E");
+    double tolulp = opts.tolerance * lapackf77_dlamch("P");
+
+    magma_int_t *h_N, *h_lda, *hinfo_magma;
+    magmaDoubleComplex **h_A_array, **h_R_array;
+    double **w1_array;
+    TESTING_CHECK( magma_imalloc_cpu( &h_N,         batchCount ));
+    TESTING_CHECK( magma_imalloc_cpu( &h_lda,       batchCount ));
+    TESTING_CHECK( magma_imalloc_cpu( &hinfo_magma, batchCount ));
+    TESTING_CHECK( magma_malloc_cpu( (void**) &h_A_array, batchCount*sizeof(magmaDoubleComplex*) ));
+    TESTING_CHECK( magma_malloc_cpu( (void**) &h_R_array, batchCount*sizeof(magmaDoubleComplex*) ));
+    TESTING_CHECK( magma_malloc_cpu( (void**) &w1_array,  batchCount*sizeof(double*) ));
+
+    printf("%% jobz = %s, uplo = %s, version %lld (%s sizes), threads %lld\n",
+           lapack_vec_const(opts.jobz), lapack_uplo_const(opts.uplo),
+           (long long) opts.version, (opts.version == 2 ? "variable" : "fixed"),
+           (long long) magma_get_parallel_numthreads() );
+
+    printf("%% BatchCount   N   CPU (ms)   MAGMA (ms)   MAGMA matrices/s   |S-S_lapack|   |A-USU^H|   |I-U^H U|\n");
+    printf("%%=====================================================================================================\n");
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int iter = 0; iter < opts.niter; ++iter ) {
+            N = opts.nsize[itest];
+
+            srand(1000);  // guarantee reproducible sizes
+            max_N = 0;
+            total = 0;
+            for (magma_int_t s=0; s < batchCount; s++) {
+                h_N[s]   = (opts.version == 2 ? 1 + (rand() % N) : N);
+                h_lda[s] = max( 1, h_N[s] );
+                max_N    = max( max_N, h_N[s] );
+                total   += h_lda[s] * h_N[s];
+            }
+
+            // query for workspace sizes for the largest matrix
+            magma_int_t ldq = max( 1, max_N );
+            lapackf77_zheevd( lapack_vec_const(opts.jobz), lapack_uplo_const(opts.uplo),
+                              &max_N, NULL, &ldq, NULL,
+                              aux_work,  &ineg_one,
+                              #ifdef COMPLEX
+                              aux_rwork, &ineg_one,
+                              #endif
+                              aux_iwork, &ineg_one,
+                              &info );
+            lwork  = max( 2*max_N*max_N, (magma_int_t) MAGMA_Z_REAL( aux_work[0] ));  // zhet21 needs 2*N*N
+            #ifdef COMPLEX
+            lrwork = max( max_N, (magma_int_t) aux_rwork[0] );
+            #endif
+            liwork = aux_iwork[0];
+
+            /* Allocate host memory for the matrices */
+            TESTING_CHECK( magma_zmalloc_cpu( &h_A,    total  ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_R,    total  ));
+            TESTING_CHECK( magma_dmalloc_cpu( &w1,     max_N*batchCount ));
+            TESTING_CHECK( magma_dmalloc_cpu( &w2,     max_N*batchCount ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_work, lwork  ));
+            #ifdef COMPLEX
+            TESTING_CHECK( magma_dmalloc_cpu( &rwork,  lrwork ));
+            #endif
+            TESTING_CHECK( magma_imalloc_cpu( &iwork,  liwork ));
+
+            /* Initialize the matrices; only the uplo triangle is referenced */
+            magma_zlarnv( ione, ISEED, total, h_A );
+            lapackf77_zlacpy( MagmaFullStr, &total, &ione, h_A, &total, h_R, &total );
+            h_A_array[0] = h_A;
+            h_R_array[0] = h_R;
+            for (magma_int_t s=1; s < batchCount; s++) {
+                h_A_array[s] = h_A_array[s-1] + h_lda[s-1] * h_N[s-1];
+                h_R_array[s] = h_R_array[s-1] + h_lda[s-1] * h_N[s-1];
+            }
+            for (magma_int_t s=0; s < batchCount; s++) {
+                w1_array[s] = w1 + s*max_N;
+            }
+
+            /* ====================================================================
+               Performs operation using MAGMA
+               =================================================================== */
+            magma_time = magma_wtime();
+            if (opts.version == 2) {
+                info = magma_zheevd_vbatched_cpu( opts.jobz, opts.uplo, h_N,
+                                                  h_R_array, h_lda, w1_array,
+                                                  hinfo_magma, batchCount );
+            }
+            else {
+                info = magma_zheevd_batched_cpu( opts.jobz, opts.uplo, N,
+                                                 h_R_array, h_lda[0], w1_array,
+                                                 hinfo_magma, batchCount );
+            }
+            magma_time = magma_wtime() - magma_time;
+            if (info != 0) {
+                printf("magma_zheevd_batched_cpu returned error %lld: %s.\n",
+                       (long long) info, magma_strerror( info ));
+            }
+            for (magma_int_t s=0; s < batchCount; s++) {
+                if (hinfo_magma[s] != 0) {
+                    printf("magma_zheevd_batched_cpu matrix %lld returned error %lld.\n",
+                           (long long) s, (long long) hinfo_magma[s] );
+                }
+            }
+
+            bool okay = (info == 0);
+            result[0] = 0;
+            result[1] = 0;
+            if ( opts.check && opts.jobz != MagmaNoVec ) {
+                /* =====================================================================
+                   Check the results following the LAPACK's [zcds]drvst routine,
+                   for each matrix, and take the max:
+                   (1)    | A - U S U^H | / ( |A| N )
+                   (2)    | I - U^H U   | / ( N )
+                   =================================================================== */
+                for (magma_int_t s=0; s < batchCount; s++) {
+                    double res[2] = { 0, 0 };
+                    if (h_N[s] == 0) {
+                        continue;
+                    }
+                    lapackf77_zhet21( &ione, lapack_uplo_const(opts.uplo), &h_N[s], &izero,
+                                      h_A_array[s], &h_lda[s],
+                                      w1_array[s], runused,
+                                      h_R_array[s], &h_lda[s],
+                                      h_R_array[s], &h_lda[s],
+                                      unused, h_work,
+                                      #ifdef COMPLEX
+                                      rwork,
+                                      #endif
+                                      res );
+                    result[0] = max( result[0], res[0]*eps );
+                    result[1] = max( result[1], res[1]*eps );
+                }
+            }
+
+            /* =====================================================================
+               Performs operation using LAPACK, one matrix per call
+               =================================================================== */
+            if ( opts.lapack ) {
+                cpu_time = magma_wtime();
+                for (magma_int_t s=0; s < batchCount; s++) {
+                    lapackf77_zheevd( lapack_vec_const(opts.jobz), lapack_uplo_const(opts.uplo),
+                                      &h_N[s], h_A_array[s], &h_lda[s], w2 + s*max_N,
+                                      h_work, &lwork,
+                                      #ifdef COMPLEX
+                                      rwork, &lrwork,
+                                      #endif
+                                      iwork, &liwork,
+                                      &info );
+                    if (info != 0) {
+                        printf("lapackf77_zheevd matrix %lld returned error %lld: %s.\n",
+                               (long long) s, (long long) info, magma_strerror( info ));
+                    }
+                }
+                cpu_time = magma_wtime() - cpu_time;
+
+                // compare eigenvalues
+                double error = 0;
+                for (magma_int_t s=0; s < batchCount; s++) {
+                    double maxw=0, diff=0;
+                    for( int j=0; j < h_N[s]; j++ ) {
+                        maxw = max(maxw, fabs(w1[s*max_N + j]));
+                        maxw = max(maxw, fabs(w2[s*max_N + j]));
+                        diff = max(diff, fabs(w1[s*max_N + j] - w2[s*max_N + j]));
+                    }
+                    if (maxw > 0) {
+                        error = max( error, diff / (h_N[s]*maxw) );
+                    }
+                }
+
+                okay = okay && (error < tolulp);
+                printf("%10lld %5lld   %9.2f   %9.2f   %13.0f      %8.2e  ",
+                       (long long) batchCount, (long long) N, cpu_time*1000., magma_time*1000.,
+                       batchCount / magma_time, error );
+            }
+            else {
+                printf("%10lld %5lld      ---     %9.2f   %13.0f         ---     ",
+                       (long long) batchCount, (long long) N, magma_time*1000.,
+                       batchCount / magma_time );
+            }
+
+            // print error checks
+            if ( opts.check && opts.jobz != MagmaNoVec ) {
+                okay = okay && (result[0] < tol) && (result[1] < tol);
+                printf("    %8.2e    %8.2e", result[0], result[1] );
+            }
+            else {
+                printf("      ---         ---   ");
+            }
+            printf("   %s\n", (okay ? "ok" : "failed"));
+            status += ! okay;
+
+            magma_free_cpu( h_A    );
+            magma_free_cpu( h_R    );
+            magma_free_cpu( w1     );
+            magma_free_cpu( w2     );
+            magma_free_cpu( h_work );
+            #ifdef COMPLEX
+            magma_free_cpu( rwork  );
+            #endif
+            magma_free_cpu( iwork  );
+            fflush( stdout );
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    magma_free_cpu( h_N );
+    magma_free_cpu( h_lda );
+    magma_free_cpu( hinfo_magma );
+    magma_free_cpu( h_A_array );
+    magma_free_cpu( h_R_array );
+    magma_free_cpu( w1_array );
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
@@ -107,9 +107,9 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_zmalloc(&dC, lddc*N ) );
 
             /* Initialize the matrices */
-            lapackf77_zlarnv( &ione, ISEED, &sizeA, hA );
-            lapackf77_zlarnv( &ione, ISEED, &sizeB, hB );
-            lapackf77_zlarnv( &ione, ISEED, &sizeC, hC );
+            magma_zlarnv( ione, ISEED, sizeA, hA );
+            magma_zlarnv( ione, ISEED, sizeB, hB );
+            magma_zlarnv( ione, ISEED, sizeC, hC );
 
             Anorm = safe_lapackf77_zlanhe( "F", lapack_uplo_const(opts.uplo), &An, hA, &lda, work );
             Bnorm = lapackf77_zlange( "F", &M, &N, hB, &ldb, work );
@@ -117,9 +117,9 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_zmalloc(&d_C, lddc*N*batchCount) );
             
             /* Initialize the matrices */
-            lapackf77_zlarnv( &ione, ISEED, &sizeA, h_A );
-            lapackf77_zlarnv( &ione, ISEED, &sizeB, h_B );
-            lapackf77_zlarnv( &ione, ISEED, &sizeC, h_C );
+            magma_zlarnv( ione, ISEED, sizeA, h_A );
+            magma_zlarnv( ione, ISEED, sizeB, h_B );
+            magma_zlarnv( ione, ISEED, sizeC, h_C );
             
             // Compute norms for error
             for (int s = 0; s < batchCount; ++s) {
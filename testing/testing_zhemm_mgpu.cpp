@@ -144,7 +144,7 @@ int main( int argc, char** argv)
                 gflops = FLOPS_ZHEMM( MagmaLeft, Moff, Noff ) / 1e9;
                 
                 size = lda*K;
-                lapackf77_zlarnv( &ione, iseed, &size, hA );
+                magma_zlarnv( ione, iseed, size, hA );
                 // set opposite triangle to NAN to ensure we don't use it.
                 magma_int_t K1 = K - 1;
                 if (opts.uplo == MagmaLower) 
@@ -153,9 +153,9 @@ int main( int argc, char** argv)
                     lapackf77_zlaset( "Lower", &K1, &K1, &MAGMA_Z_NAN, &MAGMA_Z_NAN, hA + 1,   &lda );
                 
                 size = ldb*N;
-                lapackf77_zlarnv( &ione, iseed, &size, hB );
+                magma_zlarnv( ione, iseed, size, hB );
                 size = ldc*N;
-                lapackf77_zlarnv( &ione, iseed, &size, hC );
+                magma_zlarnv( ione, iseed, size, hC );
                 lapackf77_zlacpy( "Full", &M, &N, hC, &ldc, hR, &ldc );
                 
                 // for error checks
@@ -99,9 +99,9 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_zmalloc( &d_Y, sizeY ));
 
             /* Initialize the matrices */
-            lapackf77_zlarnv( &ione, ISEED, &sizeA, h_A );
-            lapackf77_zlarnv( &ione, ISEED, &sizeX, h_X );
-            lapackf77_zlarnv( &ione, ISEED, &sizeY, h_Y );
+            magma_zlarnv( ione, ISEED, sizeA, h_A );
+            magma_zlarnv( ione, ISEED, sizeX, h_X );
+            magma_zlarnv( ione, ISEED, sizeY, h_Y );
             
             /* set the opposite triangular part to NAN to check */
             magma_int_t N1 = N-1;
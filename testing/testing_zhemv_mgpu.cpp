@@ -133,11 +133,11 @@ int main(int argc, char **argv)
             //////////////////////////////////////////////////////////////////////////
             
             /* Initialize the matrix */
-            lapackf77_zlarnv( &ione, ISEED, &matsize, A );
+            magma_zlarnv( ione, ISEED, matsize, A );
             magma_zmake_hermitian( Noffset, A, lda );
             
-            lapackf77_zlarnv( &ione, ISEED, &vecsize, X );
-            lapackf77_zlarnv( &ione, ISEED, &vecsize, Y );
+            magma_zlarnv( ione, ISEED, vecsize, X );
+            magma_zlarnv( ione, ISEED, vecsize, Y );
             
             /* =====================================================================
                Performs operation using cuBLAS / clBLAS
@@ -148,9 +148,9 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_zmalloc(&d_Y, total_size_Y) );
 
             /* Initialize the matrices */
-            lapackf77_zlarnv( &ione, ISEED, &total_size_A_cpu, h_A );
-            lapackf77_zlarnv( &ione, ISEED, &total_size_X, h_X );
-            lapackf77_zlarnv( &ione, ISEED, &total_size_Y, h_Y );
+            magma_zlarnv( ione, ISEED, total_size_A_cpu, h_A );
+            magma_zlarnv( ione, ISEED, total_size_X, h_X );
+            magma_zlarnv( ione, ISEED, total_size_Y, h_Y );
             
             /* set the opposite triangular part to NAN to check */
             magmaDoubleComplex* hAi = h_A;
@@ -123,9 +123,9 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_zmalloc( &dC, lddc*N  ));
             
             /* Initialize the matrices */
-            lapackf77_zlarnv( &ione, ISEED, &sizeA, hA );
-            lapackf77_zlarnv( &ione, ISEED, &sizeB, hB );
-            lapackf77_zlarnv( &ione, ISEED, &sizeC, hC );
+            magma_zlarnv( ione, ISEED, sizeA, hA );
+            magma_zlarnv( ione, ISEED, sizeB, hB );
+            magma_zlarnv( ione, ISEED, sizeC, hC );
             
             // for error checks
             double Anorm = lapackf77_zlange( "F", &An, &Ak, hA, &lda, work );
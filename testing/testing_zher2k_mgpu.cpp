@@ -99,10 +99,10 @@ int main( int argc, char** argv)
                 }
                 
                 size = lda*n;
-                lapackf77_zlarnv( &ione, ISEED, &size, hC );
+                magma_zlarnv( ione, ISEED, size, hC );
                 size = lda*k;
-                lapackf77_zlarnv( &ione, ISEED, &size, hA );
-                lapackf77_zlarnv( &ione, ISEED, &size, hB );
+                magma_zlarnv( ione, ISEED, size, hA );
+                magma_zlarnv( ione, ISEED, size, hB );
             
                 // for error checks
                 double Anorm = lapackf77_zlange( "F", &n, &k, hA, &lda, work );
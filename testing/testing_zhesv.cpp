@@ -127,7 +127,7 @@ int main( int argc, char** argv)
                 TESTING_CHECK( magma_zmalloc_cpu( &work, lwork ));
 
                 init_matrix( opts, N, N, h_A, lda );
-                lapackf77_zlarnv( &ione, ISEED, &sizeB, h_B );
+                magma_zlarnv( ione, ISEED, sizeB, h_B );
                 lapackf77_zlacpy( MagmaFullStr, &N, &opts.nrhs, h_B, &ldb, h_X, &ldb );
 
                 cpu_time = magma_wtime();
@@ -148,7 +148,7 @@ int main( int argc, char** argv)
                Performs operation using MAGMA
                =================================================================== */
             init_matrix( opts, N, N, h_A, lda );
-            lapackf77_zlarnv( &ione, ISEED, &sizeB, h_B );
+            magma_zlarnv( ione, ISEED, sizeB, h_B );
             lapackf77_zlacpy( MagmaFullStr, &N, &opts.nrhs, h_B, &ldb, h_X, &ldb );
 
             magma_setdevice(0);
@@ -71,7 +71,7 @@ double get_residual(
     // initialize RHS
     TESTING_CHECK( magma_zmalloc_cpu( &x, n ));
     TESTING_CHECK( magma_zmalloc_cpu( &b, n ));
-    lapackf77_zlarnv( &ione, ISEED, &n, b );
+    magma_zlarnv( ione, ISEED, n, b );
     blasf77_zcopy( &n, b, &ione, x, &ione );
     
     // solve Ax = b
@@ -157,7 +157,7 @@ double get_residual_gpu(
     TESTING_CHECK( magma_zmalloc_cpu( &x, n ));
     TESTING_CHECK( magma_zmalloc_cpu( &b, n ));
     TESTING_CHECK( magma_zmalloc( &dx, n ));
-    lapackf77_zlarnv( &ione, ISEED, &n, b );
+    magma_zlarnv( ione, ISEED, n, b );
     blasf77_zcopy( &n, b, &ione, x, &ione );
 
     // solve Ax = v on the CPU and measure the time in time[1]
@@ -239,7 +239,7 @@ double get_residual_aasen(
     // initialize RHS
     TESTING_CHECK( magma_zmalloc_cpu( &x, n ));
     TESTING_CHECK( magma_zmalloc_cpu( &b, n ));
-    lapackf77_zlarnv( &ione, ISEED, &n, b );
+    magma_zlarnv( ione, ISEED, n, b );
     blasf77_zcopy( &n, b, &ione, x, &ione );
     // pivot..
     for (i=0; i < n; i++) {
@@ -93,8 +93,8 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_malloc_cpu( (void**) &hB_array, batchCount * sizeof(magmaDoubleComplex*) ));
 
 
-            lapackf77_zlarnv( &ione, ISEED, &sizeA, h_A );
-            lapackf77_zlarnv( &ione, ISEED, &sizeB, h_B );
+            magma_zlarnv( ione, ISEED, sizeA, h_A );
+            magma_zlarnv( ione, ISEED, sizeB, h_B );
 
             /* ====================================================================
                Performs operation using MAGMA
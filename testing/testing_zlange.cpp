@@ -81,7 +81,7 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_dmalloc( &d_work, lwork ));
             
             /* Initialize the matrix */
-            lapackf77_zlarnv( &idist, ISEED, &n2, h_A );
+            magma_zlarnv( idist, ISEED, n2, h_A );
             magma_zsetmatrix( M, N, h_A, lda, d_A, ldda, opts.queue );
             
             /* ====================================================================
@@ -116,7 +116,7 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_dmalloc( &d_work, N ));
             
             /* Initialize the matrix */
-            lapackf77_zlarnv( &idist, ISEED, &n2, h_A );
+            magma_zlarnv( idist, ISEED, n2, h_A );
             
             magma_zsetmatrix( N, N, h_A, lda, d_A, ldda, opts.queue );
             
@@ -98,7 +98,7 @@ int main( int argc, char** argv )
             
             // C is M x N.
             size = ldc*N;
-            lapackf77_zlarnv( &ione, ISEED, &size, C );
+            magma_zlarnv( ione, ISEED, size, C );
             //printf( "C=" );  magma_zprint( M, N, C, ldc );
             
             // V is ldv x nv. See larfb docs for description.
@@ -107,7 +107,7 @@ int main( int argc, char** argv )
             // if row-wise and left,     K x M
             // if row-wise and right,    K x N
             size = ldv*nv;
-            lapackf77_zlarnv( &ione, ISEED, &size, V );
+            magma_zlarnv( ione, ISEED, size, V );
             if ( storev[istor] == MagmaColumnwise ) {
                 if ( direct[idir] == MagmaForward ) {
                     lapackf77_zlaset( MagmaUpperStr, &K, &K, &c_zero, &c_one, V, &ldv );
@@ -132,7 +132,7 @@ int main( int argc, char** argv )
             // T is K x K, upper triangular for forward, and lower triangular for backward
             magma_int_t k1 = K-1;
             size = ldt*K;
-            lapackf77_zlarnv( &ione, ISEED, &size, T );
+            magma_zlarnv( ione, ISEED, size, T );
             if ( direct[idir] == MagmaForward ) {
                 lapackf77_zlaset( MagmaLowerStr, &k1, &k1, &c_zero, &c_zero, &T[1], &ldt );
             }
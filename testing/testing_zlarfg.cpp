@@ -62,7 +62,7 @@ int main( int argc, char** argv)
             
             /* Initialize the vectors */
             size = N*nb;
-            lapackf77_zlarnv( &ione, ISEED, &size, h_x );
+            magma_zlarnv( ione, ISEED, size, h_x );
             
             /* =====================================================================
                Performs operation using MAGMABLAS
@@ -87,7 +87,7 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_zmalloc( &d_A, ldda*N ));
             
             /* Initialize the matrix */
-            lapackf77_zlarnv( &ione, ISEED, &size, h_A );
+            magma_zlarnv( ione, ISEED, size, h_A );
             
             if ( 0 ) {
                 // test that the over/underflow algorithm is working (but slower)
@@ -71,8 +71,8 @@ int main( int argc, char** argv )
             TESTING_CHECK( magma_cmalloc( &dSA, size ));
             TESTING_CHECK( magma_zmalloc( &dA, size ));
             
-            lapackf77_zlarnv( &ione, ISEED, &size,  A );
-            lapackf77_clarnv( &ione, ISEED, &size, SA );
+            magma_zlarnv( ione, ISEED, size,  A );
+            magma_clarnv( ione, ISEED, size, SA );
             
             magma_zsetmatrix( n, n, A,  lda, dA,  ldda, opts.queue );
             magma_csetmatrix( n, n, SA, lda, dSA, ldda, opts.queue );
@@ -127,8 +127,8 @@ int main( int argc, char** argv )
             /* =====================================================================
                Reset matrices
                =================================================================== */
-            lapackf77_zlarnv( &ione, ISEED, &size,  A );
-            lapackf77_clarnv( &ione, ISEED, &size, SA );
+            magma_zlarnv( ione, ISEED, size,  A );
+            magma_clarnv( ione, ISEED, size, SA );
             
             magma_zsetmatrix( n, n, A,  lda, dA,  ldda, opts.queue );
             magma_csetmatrix( n, n, SA, lda, dSA, ldda, opts.queue );
@@ -146,7 +146,7 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_zmalloc( &dA, ldda*N ));
             
             /* Initialize the matrix */
-            lapackf77_zlarnv( &ione, ISEED, &size, hA );
+            magma_zlarnv( ione, ISEED, size, hA );
             
             // up to 25% of matrix is NAN, and
             // up to 25% of matrix is INF.
@@ -212,6 +212,28 @@ int main( int argc, char** argv)
             magma_int_t c_cpu2 = magma_znan_inf    ( uplo[iuplo], M, N, hA, lda,  NULL, NULL );
             magma_int_t c_gpu2 = magma_znan_inf_gpu( uplo[iuplo], M, N, dA, ldda, NULL, NULL, opts.queue );
             
+            magma_int_t c_any  = magma_znan_inf_any( uplo[iuplo], M, N, hA, lda );
+            
+            // counts per nb-by-nb tile should sum to the totals
+            magma_int_t nb = (opts.nb > 0 ? opts.nb : 64);
+            magma_int_t mt = magma_ceildiv( M, nb );
+            magma_int_t nt = magma_ceildiv( N, nb );
+            magma_int_t ldt = max( 1, mt );
+            magma_int_t *tile_nan, *tile_inf;
+            TESTING_CHECK( magma_imalloc_cpu( &tile_nan, ldt*max( 1, nt ) ));
+            TESTING_CHECK( magma_imalloc_cpu( &tile_inf, ldt*max( 1, nt ) ));
+            magma_int_t c_tiles = magma_znan_inf_tiles( uplo[iuplo], M, N, hA, lda, nb, nb,
+                                                        tile_nan, tile_inf, ldt );
+            magma_int_t c_tiles_nan = 0, c_tiles_inf = 0;
+            for( j=0; j < nt; ++j ) {
+                for( i=0; i < mt; ++i ) {
+                    c_tiles_nan += tile_nan[ i + j*ldt ];
+                    c_tiles_inf += tile_inf[ i + j*ldt ];
+                }
+            }
+            magma_free_cpu( tile_nan );
+            magma_free_cpu( tile_inf );
+            
             /* =====================================================================
                Check the result
                =================================================================== */
@@ -223,7 +245,11 @@ int main( int argc, char** argv)
                      && ( c_cpu_nan == cnt_nan )
                      && ( c_cpu_inf == cnt_inf )
                      && ( c_gpu_nan == cnt_nan )
-                     && ( c_gpu_inf == cnt_inf );
+                     && ( c_gpu_inf == cnt_inf )
+                     && ( c_any == (total > 0) )
+                     && ( c_tiles == total )
+                     && ( c_tiles_nan == cnt_nan )
+                     && ( c_tiles_inf == cnt_inf );
             
             printf( "%4c %5lld %5lld   %10lld + %-10lld   %10lld + %-10lld   %10lld + %-10lld  %s\n",
                     lapacke_uplo_const( uplo[iuplo] ), (long long) M, (long long) N,
@@ -42,6 +42,7 @@ int main( int argc, char** argv)
     magma_opts opts;
     opts.matrix = "rand_dominant";  // default
     opts.parse_opts( argc, argv );
+    magma_results results( opts, "zposv" );
     
     double tol = opts.tolerance * lapackf77_dlamch("E");
     
@@ -53,6 +54,8 @@ int main( int argc, char** argv)
             N   = opts.nsize[itest];
             lda = ldb = N;
             gflops = ( FLOPS_ZPOTRF( N ) + FLOPS_ZPOTRS( N, opts.nrhs ) ) / 1e9;
+            results.add( "N", N );
+            results.add( "nrhs", opts.nrhs );
             
             TESTING_CHECK( magma_zmalloc_cpu( &h_A, lda*N         ));
             TESTING_CHECK( magma_zmalloc_cpu( &h_R, lda*N         ));
@@ -66,11 +69,13 @@ int main( int argc, char** argv)
                =================================================================== */
             sizeB = ldb*opts.nrhs;
             magma_generate_matrix( opts, N, N, h_A, lda, sigma );
-            lapackf77_zlarnv( &ione, opts.iseed, &sizeB, h_B );
+            magma_zlarnv( ione, opts.iseed, sizeB, h_B );
             
-            // copy A to R and B to X; save A and B for residual
-            lapackf77_zlacpy( MagmaFullStr, &N, &N,         h_A, &lda, h_R, &lda );
-            lapackf77_zlacpy( MagmaFullStr, &N, &opts.nrhs, h_B, &ldb, h_X, &ldb );
+            // each run copies A to R and B to X; A and B are kept for the residual
+            auto copy_AB = [&]() {
+                lapackf77_zlacpy( MagmaFullStr, &N, &N,         h_A, &lda, h_R, &lda );
+                lapackf77_zlacpy( MagmaFullStr, &N, &opts.nrhs, h_B, &ldb, h_X, &ldb );
+            };
             
             if (opts.verbose) {
                 printf( "A = " ); magma_zprint( N, N, h_A, lda );
@@ -81,10 +86,15 @@ int main( int argc, char** argv)
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
-            gpu_time = magma_wtime();
-            magma_zposv( opts.uplo, N, opts.nrhs, h_R, lda, h_X, ldb, &info );
-            gpu_time = magma_wtime() - gpu_time;
+            magma_timing gpu_times = magma_repeat( opts, copy_AB,
+                [&]() {
+                    real_Double_t time = magma_wtime();
+                    magma_zposv( opts.uplo, N, opts.nrhs, h_R, lda, h_X, ldb, &info );
+                    return magma_wtime() - time;
+                });
+            gpu_time = gpu_times.minimum();
             gpu_perf = gflops / gpu_time;
+            results.add( "magma", gpu_times, gflops );
             if (info != 0) {
                 printf("magma_zposv returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -109,23 +119,30 @@ int main( int argc, char** argv)
             Rnorm = lapackf77_zlange("I", &N, &opts.nrhs, h_B, &ldb, work);
             error = Rnorm/(N*Anorm*Xnorm);
             status += ! (error < tol);
+            results.add( "error", error );
+            results.add( "status", (error < tol ? "ok" : "failed") );
             
             /* ====================================================================
                Performs operation using LAPACK
                =================================================================== */
             if ( opts.lapack ) {
-                cpu_time = magma_wtime();
-                lapackf77_zposv( lapack_uplo_const(opts.uplo), &N, &opts.nrhs, h_A, &lda, h_B, &ldb, &info );
-                cpu_time = magma_wtime() - cpu_time;
+                magma_timing cpu_times = magma_repeat( opts, copy_AB,
+                    [&]() {
+                        real_Double_t time = magma_wtime();
+                        lapackf77_zposv( lapack_uplo_const(opts.uplo), &N, &opts.nrhs, h_R, &lda, h_X, &ldb, &info );
+                        return magma_wtime() - time;
+                    });
+                cpu_time = cpu_times.minimum();
                 cpu_perf = gflops / cpu_time;
+                results.add( "cpu", cpu_times, gflops );
                 if (info != 0) {
                     printf("lapackf77_zposv returned error %lld: %s.\n",
                            (long long) info, magma_strerror( info ));
                 }
                 
                 if (opts.verbose) {
-                    printf( "Lref = " ); magma_zprint( N, N, h_A, lda );
-                    printf( "Xref = " ); magma_zprint( N, opts.nrhs, h_B, ldb );
+                    printf( "Lref = " ); magma_zprint( N, N, h_R, lda );
+                    printf( "Xref = " ); magma_zprint( N, opts.nrhs, h_X, ldb );
                 }
                 
                 printf( "%5lld %5lld   %7.2f (%7.2f)   %7.2f (%7.2f)   %8.2e   %s\n",
@@ -144,6 +161,7 @@ int main( int argc, char** argv)
             magma_free_cpu( h_X );
             magma_free_cpu( work );
             magma_free_cpu( sigma );
+            results.end_row();
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
@@ -91,8 +91,8 @@ int main(int argc, char **argv)
             TESTING_CHECK( magma_malloc( (void**) &dB_array, batchCount * sizeof(magmaDoubleComplex*) ));
 
             /* Initialize the matrices */
-            lapackf77_zlarnv( &ione, ISEED, &sizeA, h_A );
-            lapackf77_zlarnv( &ione, ISEED, &sizeB, h_B );
+            magma_zlarnv( ione, ISEED, sizeA, h_A );
+            magma_zlarnv( ione, ISEED, sizeB, h_B );
 
             for (int i=0; i < batchCount; i++)
             {
@@ -35,7 +35,7 @@ int main( int argc, char** argv)
     // locals
     real_Double_t   gflops, cpu_perf, cpu_time, gpu_perf, gpu_time;
     double          error, Rnorm, Anorm, Xnorm, *work, *sigma;
-    magmaDoubleComplex *h_A, *h_B, *h_X;
+    magmaDoubleComplex *h_A, *h_B, *h_X, *h_R;
     magmaDoubleComplex_ptr d_A, d_B;
     magma_int_t N, lda, ldb, ldda, lddb, info, sizeB;
     int status = 0;
@@ -43,6 +43,7 @@ int main( int argc, char** argv)
     magma_opts opts;
     opts.matrix = "rand_dominant";  // default
     opts.parse_opts( argc, argv );
+    magma_results results( opts, "zposv_gpu" );
     
     double tol = opts.tolerance * lapackf77_dlamch("E");
     
@@ -56,8 +57,11 @@ int main( int argc, char** argv)
             ldda = magma_roundup( N, opts.align );  // multiple of 32 by default
             lddb = ldda;
             gflops = ( FLOPS_ZPOTRF( N ) + FLOPS_ZPOTRS( N, opts.nrhs ) ) / 1e9;
+            results.add( "N", N );
+            results.add( "nrhs", opts.nrhs );
             
             TESTING_CHECK( magma_zmalloc_cpu( &h_A, lda*N         ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_R, lda*N         ));
             TESTING_CHECK( magma_zmalloc_cpu( &h_B, ldb*opts.nrhs ));
             TESTING_CHECK( magma_zmalloc_cpu( &h_X, ldb*opts.nrhs ));
             TESTING_CHECK( magma_dmalloc_cpu( &work, N ));
@@ -71,19 +75,26 @@ int main( int argc, char** argv)
                =================================================================== */
             sizeB = ldb*opts.nrhs;
             magma_generate_matrix( opts, N, N, h_A, lda, sigma );
-            lapackf77_zlarnv( &ione, opts.iseed, &sizeB, h_B );
+            magma_zlarnv( ione, opts.iseed, sizeB, h_B );
             magma_zmake_hpd( N, h_A, lda );
             
-            magma_zsetmatrix( N, N,         h_A, lda, d_A, ldda, opts.queue );
-            magma_zsetmatrix( N, opts.nrhs, h_B, lda, d_B, lddb, opts.queue );
-            
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
-            gpu_time = magma_wtime();
-            magma_zposv_gpu( opts.uplo, N, opts.nrhs, d_A, ldda, d_B, lddb, &info );
-            gpu_time = magma_wtime() - gpu_time;
+            // each run solves with fresh copies of A and B
+            magma_timing gpu_times = magma_repeat( opts,
+                [&]() {
+                    magma_zsetmatrix( N, N,         h_A, lda, d_A, ldda, opts.queue );
+                    magma_zsetmatrix( N, opts.nrhs, h_B, lda, d_B, lddb, opts.queue );
+                },
+                [&]() {
+                    real_Double_t time = magma_wtime();
+                    magma_zposv_gpu( opts.uplo, N, opts.nrhs, d_A, ldda, d_B, lddb, &info );
+                    return magma_wtime() - time;
+                });
+            gpu_time = gpu_times.minimum();
             gpu_perf = gflops / gpu_time;
+            results.add( "magma", gpu_times, gflops );
             if (info != 0) {
                 printf("magma_zpotrf_gpu returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -105,15 +116,26 @@ int main( int argc, char** argv)
             Rnorm = lapackf77_zlange("I", &N, &opts.nrhs, h_B, &ldb, work);
             error = Rnorm/(N*Anorm*Xnorm);
             status += ! (error < tol);
+            results.add( "error", error );
+            results.add( "status", (error < tol ? "ok" : "failed") );
             
             /* ====================================================================
                Performs operation using LAPACK
                =================================================================== */
             if ( opts.lapack ) {
-                cpu_time = magma_wtime();
-                lapackf77_zposv( lapack_uplo_const(opts.uplo), &N, &opts.nrhs, h_A, &lda, h_B, &ldb, &info );
-                cpu_time = magma_wtime() - cpu_time;
+                magma_timing cpu_times = magma_repeat( opts,
+                    [&]() {
+                        lapackf77_zlacpy( MagmaFullStr, &N, &N,         h_A, &lda, h_R, &lda );
+                        lapackf77_zlacpy( MagmaFullStr, &N, &opts.nrhs, h_B, &ldb, h_X, &ldb );
+                    },
+                    [&]() {
+                        real_Double_t time = magma_wtime();
+                        lapackf77_zposv( lapack_uplo_const(opts.uplo), &N, &opts.nrhs, h_R, &lda, h_X, &ldb, &info );
+                        return magma_wtime() - time;
+                    });
+                cpu_time = cpu_times.minimum();
                 cpu_perf = gflops / cpu_time;
+                results.add( "cpu", cpu_times, gflops );
                 if (info != 0) {
                     printf("lapackf77_zposv returned error %lld: %s.\n",
                            (long long) info, magma_strerror( info ));
@@ -130,6 +152,7 @@ int main( int argc, char** argv)
             }
             
             magma_free_cpu( h_A  );
+            magma_free_cpu( h_R  );
             magma_free_cpu( h_B  );
             magma_free_cpu( h_X  );
             magma_free_cpu( work );
@@ -137,6 +160,7 @@ int main( int argc, char** argv)
             
             magma_free( d_A  );
             magma_free( d_B  );
+            results.end_row();
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
@@ -39,7 +39,7 @@ int main( int argc, char** argv)
     
     // locals
     real_Double_t   gflops, gpu_perf, gpu_time, cpu_perf, cpu_time;
-    magmaDoubleComplex *h_A, *h_R;
+    magmaDoubleComplex *h_A, *h_R, *h_L;
     magma_int_t N, n2, lda, info;
     double      Anorm, error, work[1], *sigma;
     int status = 0;
@@ -48,6 +48,7 @@ int main( int argc, char** argv)
     opts.matrix = "rand_dominant";  // default
     opts.parse_opts( argc, argv );
     opts.lapack |= opts.check;  // check (-c) implies lapack (-l)
+    magma_results results( opts, "zpotrf" );
     
     double tol = opts.tolerance * lapackf77_dlamch("E");
     
@@ -60,14 +61,15 @@ int main( int argc, char** argv)
             lda   = N;
             n2    = lda*N;
             gflops = FLOPS_ZPOTRF( N ) / 1e9;
+            results.add( "N", N );
             
             TESTING_CHECK( magma_zmalloc_cpu( &h_A, n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_L, n2 ));
             TESTING_CHECK( magma_dmalloc_cpu( &sigma, N ));
             TESTING_CHECK( magma_zmalloc_pinned( &h_R, n2 ));
             
             /* Initialize the matrix */
             magma_generate_matrix( opts, N, N, h_A, lda, sigma );
-            lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_R, &lda );
             if (opts.verbose) {
                 printf( "A = " ); magma_zprint( N, N, h_A, lda );
             }
@@ -75,10 +77,19 @@ int main( int argc, char** argv)
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
+            // each run factors a fresh copy of A
+            auto copy_A = [&]( magmaDoubleComplex* h_X ) {
+                lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_X, &lda );
+            };
+            magma_timing gpu_times;
             if (opts.version == 1) {
-                gpu_time = magma_wtime();
-                magma_zpotrf( opts.uplo, N, h_R, lda, &info );
-                gpu_time = magma_wtime() - gpu_time;
+                gpu_times = magma_repeat( opts,
+                    [&]() { copy_A( h_R ); },
+                    [&]() {
+                        real_Double_t time = magma_wtime();
+                        magma_zpotrf( opts.uplo, N, h_R, lda, &info );
+                        return magma_wtime() - time;
+                    });
             } 
             else {
                 magmaDoubleComplex_ptr dA = NULL;
@@ -92,16 +103,22 @@ int main( int argc, char** argv)
                 magma_queue_create( cdev, &queues[0] );
                 magma_queue_create( cdev, &queues[1] );
                 
-                gpu_time = magma_wtime();
-                magma_zpotrf_expert(opts.uplo, N, h_R, lda, dA, ldda, &info, queues );
-                gpu_time = magma_wtime() - gpu_time;
+                gpu_times = magma_repeat( opts,
+                    [&]() { copy_A( h_R ); },
+                    [&]() {
+                        real_Double_t time = magma_wtime();
+                        magma_zpotrf_expert(opts.uplo, N, h_R, lda, dA, ldda, &info, queues );
+                        return magma_wtime() - time;
+                    });
 
                 magma_queue_destroy( queues[0] );
                 magma_queue_destroy( queues[1] );
 
                 magma_free( dA );
             }
+            gpu_time = gpu_times.minimum();
             gpu_perf = gflops / gpu_time;
+            results.add( "magma", gpu_times, gflops );
             if (info != 0) {
                 printf("magma_zpotrf returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -111,10 +128,16 @@ int main( int argc, char** argv)
                 /* =====================================================================
                    Performs operation using LAPACK
                    =================================================================== */
-                cpu_time = magma_wtime();
-                lapackf77_zpotrf( lapack_uplo_const(opts.uplo), &N, h_A, &lda, &info );
-                cpu_time = magma_wtime() - cpu_time;
+                magma_timing cpu_times = magma_repeat( opts,
+                    [&]() { copy_A( h_L ); },
+                    [&]() {
+                        real_Double_t time = magma_wtime();
+                        lapackf77_zpotrf( lapack_uplo_const(opts.uplo), &N, h_L, &lda, &info );
+                        return magma_wtime() - time;
+                    });
+                cpu_time = cpu_times.minimum();
                 cpu_perf = gflops / cpu_time;
+                results.add( "cpu", cpu_times, gflops );
                 if (info != 0) {
                     printf("lapackf77_zpotrf returned error %lld: %s.\n",
                            (long long) info, magma_strerror( info ));
@@ -123,15 +146,15 @@ int main( int argc, char** argv)
                 /* =====================================================================
                    Check the result compared to LAPACK
                    =================================================================== */
-                blasf77_zaxpy(&n2, &c_neg_one, h_A, &ione, h_R, &ione);
+                blasf77_zaxpy(&n2, &c_neg_one, h_L, &ione, h_R, &ione);
                 #ifndef MAGMA_HAVE_HIP
-                Anorm = lapackf77_zlange("f", &N, &N, h_A, &lda, work);
+                Anorm = lapackf77_zlange("f", &N, &N, h_L, &lda, work);
                 error = lapackf77_zlange("f", &N, &N, h_R, &lda, work) / Anorm;
                 #else
                 // TODO: use zlange when the herk/syrk implementations are standardized. 
                 // For HIP, the current herk/syrk routines overwrite the entire diagonal
                 // blocks of the matrix, so using zlange causes the error check to fail
-                Anorm = safe_lapackf77_zlanhe( "f", lapack_uplo_const(opts.uplo), &N, h_A, &lda, work );
+                Anorm = safe_lapackf77_zlanhe( "f", lapack_uplo_const(opts.uplo), &N, h_L, &lda, work );
                 error = safe_lapackf77_zlanhe( "f", lapack_uplo_const(opts.uplo), &N, h_R, &lda, work ) / Anorm;
                 #endif
                 
@@ -139,14 +162,18 @@ int main( int argc, char** argv)
                        (long long) N, cpu_perf, cpu_time, gpu_perf, gpu_time,
                        error, (error < tol ? "ok" : "failed") );
                 status += ! (error < tol);
+                results.add( "error", error );
+                results.add( "status", (error < tol ? "ok" : "failed") );
             }
             else {
                 printf("%5lld     ---   (  ---  )   %7.2f (%7.2f)     ---  \n",
                        (long long) N, gpu_perf, gpu_time );
             }
             magma_free_cpu( h_A );
+            magma_free_cpu( h_L );
             magma_free_cpu( sigma );
             magma_free_pinned( h_R );
+            results.end_row();
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
@@ -79,7 +79,7 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_malloc( (void**) &d_A_array, batchCount * sizeof(magmaDoubleComplex*) ));
 
             /* Initialize the matrix */
-            lapackf77_zlarnv( &ione, ISEED, &n2, h_A );
+            magma_zlarnv( ione, ISEED, n2, h_A );
             for (int i=0; i < batchCount; i++)
             {
                 magma_zmake_hpd( N, h_A + i * lda * N, lda ); // need modification
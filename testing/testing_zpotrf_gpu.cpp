@@ -33,7 +33,7 @@ int main( int argc, char** argv)
     
     // locals
     real_Double_t   gflops, gpu_perf, gpu_time, cpu_perf, cpu_time;
-    magmaDoubleComplex *h_A, *h_R;
+    magmaDoubleComplex *h_A, *h_R, *h_L;
     magmaDoubleComplex_ptr d_A;
     magma_int_t N, n2, lda, ldda, info;
     double      Anorm, error, work[1], *sigma;
@@ -43,6 +43,7 @@ int main( int argc, char** argv)
     opts.matrix = "rand_dominant";  // default
     opts.parse_opts( argc, argv );
     opts.lapack |= opts.check;  // check (-c) implies lapack (-l)
+    magma_results results( opts, "zpotrf_gpu" );
     
     double tol = opts.tolerance * lapackf77_dlamch("E");
     
@@ -56,29 +57,36 @@ int main( int argc, char** argv)
             n2  = lda*N;
             ldda = magma_roundup( N, opts.align );  // multiple of 32 by default
             gflops = FLOPS_ZPOTRF( N ) / 1e9;
+            results.add( "N", N );
             
             TESTING_CHECK( magma_zmalloc_cpu( &h_A, n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_L, n2 ));
             TESTING_CHECK( magma_dmalloc_cpu( &sigma, N ));
             TESTING_CHECK( magma_zmalloc_pinned( &h_R, n2 ));
             TESTING_CHECK( magma_zmalloc( &d_A, ldda*N ));
             
             /* Initialize the matrix */
             magma_generate_matrix( opts, N, N, h_A, lda, sigma );
-            lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_R, &lda );
-            magma_zsetmatrix( N, N, h_A, lda, d_A, ldda, opts.queue );
             
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
-            gpu_time = magma_wtime();
-            if(opts.version == 1){
-                magma_zpotrf_gpu( opts.uplo, N, d_A, ldda, &info );
-            }
-            else if(opts.version == 2){
-                magma_zpotrf_native(opts.uplo, N, d_A, ldda, &info );
-            }
-            gpu_time = magma_wtime() - gpu_time;
+            // each run factors a fresh copy of A
+            magma_timing gpu_times = magma_repeat( opts,
+                [&]() { magma_zsetmatrix( N, N, h_A, lda, d_A, ldda, opts.queue ); },
+                [&]() {
+                    real_Double_t time = magma_wtime();
+                    if(opts.version == 1){
+                        magma_zpotrf_gpu( opts.uplo, N, d_A, ldda, &info );
+                    }
+                    else if(opts.version == 2){
+                        magma_zpotrf_native(opts.uplo, N, d_A, ldda, &info );
+                    }
+                    return magma_wtime() - time;
+                });
+            gpu_time = gpu_times.minimum();
             gpu_perf = gflops / gpu_time;
+            results.add( "magma", gpu_times, gflops );
             if (info != 0) {
                 printf("magma_zpotrf_gpu returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -88,10 +96,16 @@ int main( int argc, char** argv)
                 /* =====================================================================
                    Performs operation using LAPACK
                    =================================================================== */
-                cpu_time = magma_wtime();
-                lapackf77_zpotrf( lapack_uplo_const(opts.uplo), &N, h_A, &lda, &info );
-                cpu_time = magma_wtime() - cpu_time;
+                magma_timing cpu_times = magma_repeat( opts,
+                    [&]() { lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_L, &lda ); },
+                    [&]() {
+                        real_Double_t time = magma_wtime();
+                        lapackf77_zpotrf( lapack_uplo_const(opts.uplo), &N, h_L, &lda, &info );
+                        return magma_wtime() - time;
+                    });
+                cpu_time = cpu_times.minimum();
                 cpu_perf = gflops / cpu_time;
+                results.add( "cpu", cpu_times, gflops );
                 if (info != 0) {
                     printf("lapackf77_zpotrf returned error %lld: %s.\n",
                            (long long) info, magma_strerror( info ));
@@ -101,15 +115,15 @@ int main( int argc, char** argv)
                    Check the result compared to LAPACK
                    =================================================================== */
                 magma_zgetmatrix( N, N, d_A, ldda, h_R, lda, opts.queue );
-                blasf77_zaxpy(&n2, &c_neg_one, h_A, &ione, h_R, &ione);
+                blasf77_zaxpy(&n2, &c_neg_one, h_L, &ione, h_R, &ione);
                 #ifndef MAGMA_HAVE_HIP
-                Anorm = lapackf77_zlange("f", &N, &N, h_A, &lda, work);
+                Anorm = lapackf77_zlange("f", &N, &N, h_L, &lda, work);
                 error = lapackf77_zlange("f", &N, &N, h_R, &lda, work) / Anorm;
                 #else
                 // TODO: use zlange when the herk/syrk implementations are standardized. 
                 // For HIP, the current herk/syrk routines overwrite the entire diagonal
                 // blocks of the matrix, so using zlange causes the error check to fail
-                Anorm = safe_lapackf77_zlanhe( "f", lapack_uplo_const(opts.uplo), &N, h_A, &lda, work );
+                Anorm = safe_lapackf77_zlanhe( "f", lapack_uplo_const(opts.uplo), &N, h_L, &lda, work );
                 error = safe_lapackf77_zlanhe( "f", lapack_uplo_const(opts.uplo), &N, h_R, &lda, work ) / Anorm;
                 #endif
 
@@ -117,15 +131,19 @@ int main( int argc, char** argv)
                        (long long) N, cpu_perf, cpu_time, gpu_perf, gpu_time,
                        error, (error < tol ? "ok" : "failed") );
                 status += ! (error < tol);
+                results.add( "error", error );
+                results.add( "status", (error < tol ? "ok" : "failed") );
             }
             else {
                 printf("%5lld     ---   (  ---  )   %7.2f (%7.2f)     ---  \n",
                        (long long) N, gpu_perf, gpu_time );
             }
             magma_free_cpu( h_A );
+            magma_free_cpu( h_L );
             magma_free_cpu( sigma );
             magma_free_pinned( h_R );
             magma_free( d_A );
+            results.end_row();
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
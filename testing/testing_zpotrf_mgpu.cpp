@@ -42,6 +42,7 @@ int main( int argc, char** argv )
     opts.parse_opts( argc, argv );
     opts.ngpu = abs( opts.ngpu );  // always uses multi-GPU code
     opts.lapack |= opts.check;  // check (-c) implies lapack (-l)
+    magma_results results( opts, "zpotrf_mgpu" );
     
     double tol = opts.tolerance * lapackf77_dlamch("E");
     
@@ -60,6 +61,7 @@ int main( int argc, char** argv )
             n2     = lda*N;
             nb     = magma_get_zpotrf_nb( N );
             gflops = FLOPS_ZPOTRF( N ) / 1e9;
+            results.add( "N", N );
             
             // ngpu must be at least the number of blocks
             ngpu = min( opts.ngpu, magma_ceildiv(N,nb) );
@@ -89,10 +91,16 @@ int main( int argc, char** argv )
                Performs operation using LAPACK
                =================================================================== */
             if ( opts.lapack ) {
-                cpu_time = magma_wtime();
-                lapackf77_zpotrf( lapack_uplo_const(opts.uplo), &N, h_A, &lda, &info );
-                cpu_time = magma_wtime() - cpu_time;
+                magma_timing cpu_times = magma_repeat( opts,
+                    [&]() { lapackf77_zlacpy( MagmaFullStr, &N, &N, h_R, &lda, h_A, &lda ); },
+                    [&]() {
+                        real_Double_t time = magma_wtime();
+                        lapackf77_zpotrf( lapack_uplo_const(opts.uplo), &N, h_A, &lda, &info );
+                        return magma_wtime() - time;
+                    });
+                cpu_time = cpu_times.minimum();
                 cpu_perf = gflops / cpu_time;
+                results.add( "cpu", cpu_times, gflops );
                 if (info != 0) {
                     printf("lapackf77_zpotrf returned error %lld: %s.\n",
                            (long long) info, magma_strerror( info ));
@@ -102,19 +110,25 @@ int main( int argc, char** argv )
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
-            if ( opts.uplo == MagmaUpper ) {
-                ldda = magma_roundup( N, nb );
-                magma_zsetmatrix_1D_col_bcyclic( ngpu, N, N, nb, h_R, lda, d_lA, ldda, queues );
-            }
-            else {
-                ldda = (1+N/(nb*ngpu))*nb;
-                magma_zsetmatrix_1D_row_bcyclic( ngpu, N, N, nb, h_R, lda, d_lA, ldda, queues );
-            }
+            ldda = ( opts.uplo == MagmaUpper ? magma_roundup( N, nb ) : (1+N/(nb*ngpu))*nb );
+            auto set_A = [&]() {
+                if ( opts.uplo == MagmaUpper ) {
+                    magma_zsetmatrix_1D_col_bcyclic( ngpu, N, N, nb, h_R, lda, d_lA, ldda, queues );
+                }
+                else {
+                    magma_zsetmatrix_1D_row_bcyclic( ngpu, N, N, nb, h_R, lda, d_lA, ldda, queues );
+                }
+            };
 
-            gpu_time = magma_wtime();
-            magma_zpotrf_mgpu( ngpu, opts.uplo, N, d_lA, ldda, &info );
-            gpu_time = magma_wtime() - gpu_time;
+            magma_timing gpu_times = magma_repeat( opts, set_A,
+                [&]() {
+                    real_Double_t time = magma_wtime();
+                    magma_zpotrf_mgpu( ngpu, opts.uplo, N, d_lA, ldda, &info );
+                    return magma_wtime() - time;
+                });
+            gpu_time = gpu_times.minimum();
             gpu_perf = gflops / gpu_time;
+            results.add( "magma", gpu_times, gflops );
             if (info != 0) {
                 printf("magma_zpotrf_mgpu returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -139,6 +153,8 @@ int main( int argc, char** argv )
                        (long long) N, cpu_perf, cpu_time, gpu_perf, gpu_time,
                        error, (error < tol ? "ok" : "failed") );
                 status += ! (error < tol);
+                results.add( "error", error );
+                results.add( "status", (error < tol ? "ok" : "failed") );
             }
             else {
                 printf("%5lld     ---   (  ---  )   %7.2f (%7.2f)     ---\n",
@@ -151,6 +167,7 @@ int main( int argc, char** argv )
                 magma_setdevice( dev );
                 magma_free( d_lA[dev] );
             }
+            results.end_row();
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
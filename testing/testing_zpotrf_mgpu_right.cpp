@@ -89,11 +89,11 @@ int main( int argc, char** argv)
 
             /* Initialize the matrix */
             if (opts.check) {
-                lapackf77_zlarnv( &ione, ISEED, &n2, h_A );
+                magma_zlarnv( ione, ISEED, n2, h_A );
                 magma_zmake_hpd( N, h_A, lda );
                 lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_R, &lda );
             } else {
-                lapackf77_zlarnv( &ione, ISEED, &n2, h_A );
+                magma_zlarnv( ione, ISEED, n2, h_A );
                 magma_zmake_hpd( N, h_A, lda );
             }
 
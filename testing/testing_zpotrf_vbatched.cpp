@@ -94,7 +94,7 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_zmalloc(&d_A, total_size_dev) );
 
             /* Initialize the matrix */
-            lapackf77_zlarnv( &ione, ISEED, &total_size_cpu, h_A );
+            magma_zlarnv( ione, ISEED, total_size_cpu, h_A );
             h_A_tmp = h_A; 
             for (int s=0; s < batchCount; s++){
                 magma_zmake_hpd( h_N[s], h_A_tmp, h_lda[s]); // need modification
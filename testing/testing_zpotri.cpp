@@ -33,7 +33,7 @@ int main( int argc, char** argv)
     
     // locals
     real_Double_t   gflops, gpu_perf, gpu_time, cpu_perf, cpu_time;
-    magmaDoubleComplex *h_A, *h_R;
+    magmaDoubleComplex *h_A, *h_R, *h_L;
     magma_int_t N, n2, lda, info;
     double      Anorm, error, work[1], *sigma;
     int status = 0;
@@ -42,6 +42,7 @@ int main( int argc, char** argv)
     opts.matrix = "rand_dominant";  // default
     opts.parse_opts( argc, argv );
     opts.lapack |= opts.check;  // check (-c) implies lapack (-l)
+    magma_results results( opts, "zpotri" );
     
     double tol = opts.tolerance * lapackf77_dlamch("E");
     
@@ -54,8 +55,10 @@ int main( int argc, char** argv)
             lda    = N;
             n2     = lda*N;
             gflops = FLOPS_ZPOTRI( N ) / 1e9;
+            results.add( "N", N );
             
             TESTING_CHECK( magma_zmalloc_cpu( &h_A, n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_L, n2 ));
             TESTING_CHECK( magma_dmalloc_cpu( &sigma, N ));
             TESTING_CHECK( magma_zmalloc_pinned( &h_R, n2 ));
             
@@ -63,27 +66,28 @@ int main( int argc, char** argv)
                Initialize the matrix
                =================================================================== */
             magma_generate_matrix( opts, N, N, h_A, lda, sigma );
-            lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_R, &lda );
+            lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_L, &lda );
             
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
-            if ( opts.warmup ) {
-                magma_zpotrf( opts.uplo, N, h_R, lda, &info );
-                magma_zpotri( opts.uplo, N, h_R, lda, &info );
-                lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_R, &lda );
-            }
-            
-            /* factorize matrix */
-            magma_zpotrf( opts.uplo, N, h_R, lda, &info );
+            /* factorize matrix. Both MAGMA and LAPACK will use this factor;
+               each run inverts a fresh copy of it. */
+            magma_zpotrf( opts.uplo, N, h_L, lda, &info );
             
             // check for exact singularity
-            //h_R[ 10 + 10*lda ] = MAGMA_Z_MAKE( 0.0, 0.0 );
+            //h_L[ 10 + 10*lda ] = MAGMA_Z_MAKE( 0.0, 0.0 );
             
-            gpu_time = magma_wtime();
-            magma_zpotri( opts.uplo, N, h_R, lda, &info );
-            gpu_time = magma_wtime() - gpu_time;
+            magma_timing gpu_times = magma_repeat( opts,
+                [&]() { lapackf77_zlacpy( MagmaFullStr, &N, &N, h_L, &lda, h_R, &lda ); },
+                [&]() {
+                    real_Double_t time = magma_wtime();
+                    magma_zpotri( opts.uplo, N, h_R, lda, &info );
+                    return magma_wtime() - time;
+                });
+            gpu_time = gpu_times.minimum();
             gpu_perf = gflops / gpu_time;
+            results.add( "magma", gpu_times, gflops );
             if (info != 0) {
                 printf("magma_zpotri returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -93,12 +97,16 @@ int main( int argc, char** argv)
                Performs operation using LAPACK
                =================================================================== */
             if ( opts.lapack ) {
-                lapackf77_zpotrf( lapack_uplo_const(opts.uplo), &N, h_A, &lda, &info );
-                
-                cpu_time = magma_wtime();
-                lapackf77_zpotri( lapack_uplo_const(opts.uplo), &N, h_A, &lda, &info );
-                cpu_time = magma_wtime() - cpu_time;
+                magma_timing cpu_times = magma_repeat( opts,
+                    [&]() { lapackf77_zlacpy( MagmaFullStr, &N, &N, h_L, &lda, h_A, &lda ); },
+                    [&]() {
+                        real_Double_t time = magma_wtime();
+                        lapackf77_zpotri( lapack_uplo_const(opts.uplo), &N, h_A, &lda, &info );
+                        return magma_wtime() - time;
+                    });
+                cpu_time = cpu_times.minimum();
                 cpu_perf = gflops / cpu_time;
+                results.add( "cpu", cpu_times, gflops );
                 if (info != 0) {
                     printf("lapackf77_zpotri returned error %lld: %s.\n",
                            (long long) info, magma_strerror( info ));
@@ -114,6 +122,8 @@ int main( int argc, char** argv)
                        (long long) N, cpu_perf, cpu_time, gpu_perf, gpu_time,
                        error, (error < tol ? "ok" : "failed") );
                 status += ! (error < tol);
+                results.add( "error", error );
+                results.add( "status", (error < tol ? "ok" : "failed") );
             }
             else {
                 printf("%5lld     ---   (  ---  )   %7.2f (%7.2f)     ---\n",
@@ -121,8 +131,10 @@ int main( int argc, char** argv)
             }
             
             magma_free_cpu( h_A );
+            magma_free_cpu( h_L );
             magma_free_cpu( sigma );
             magma_free_pinned( h_R );
+            results.end_row();
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
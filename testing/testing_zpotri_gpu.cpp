@@ -28,7 +28,7 @@ int main( int argc, char** argv)
     magma_print_environment();
 
     real_Double_t   gflops, gpu_perf, gpu_time, cpu_perf, cpu_time;
-    magmaDoubleComplex *h_A, *h_R;
+    magmaDoubleComplex *h_A, *h_R, *h_L;
     magmaDoubleComplex_ptr d_A;
     magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
     magma_int_t N, n2, lda, ldda, info;
@@ -40,6 +40,7 @@ int main( int argc, char** argv)
     opts.matrix = "rand_dominant";  // default
     opts.parse_opts( argc, argv );
     opts.lapack |= opts.check;  // check (-c) implies lapack (-l)
+    magma_results results( opts, "zpotri_gpu" );
     
     double tol = opts.tolerance * lapackf77_dlamch("E");
     
@@ -53,31 +54,38 @@ int main( int argc, char** argv)
             n2     = lda*N;
             ldda   = magma_roundup( N, opts.align );  // multiple of 32 by default
             gflops = FLOPS_ZPOTRI( N ) / 1e9;
+            results.add( "N", N );
             
             TESTING_CHECK( magma_zmalloc_cpu( &h_A, n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_L, n2 ));
             TESTING_CHECK( magma_zmalloc_pinned( &h_R, n2 ));
             TESTING_CHECK( magma_zmalloc( &d_A, ldda*N ));
             
             /* Initialize the matrix */
             magma_generate_matrix( opts, N, N, h_A, lda );
-            lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_R, &lda );
             
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
-            /* factorize matrix */
+            /* factorize matrix. Both MAGMA and LAPACK will use this factor,
+               kept in h_L; each run inverts a fresh copy of it. */
             magma_zsetmatrix( N, N, h_A, lda, d_A, ldda, opts.queue );
             magma_zpotrf_gpu( opts.uplo, N, d_A, ldda, &info );
+            magma_zgetmatrix( N, N, d_A, ldda, h_L, lda, opts.queue );
             
             // check for exact singularity
-            //magma_zgetmatrix( N, N, d_A, ldda, h_R, lda, opts.queue );
-            //h_R[ 10 + 10*lda ] = MAGMA_Z_MAKE( 0.0, 0.0 );
-            //magma_zsetmatrix( N, N, h_R, lda, d_A, ldda, opts.queue );
+            //h_L[ 10 + 10*lda ] = MAGMA_Z_MAKE( 0.0, 0.0 );
             
-            gpu_time = magma_wtime();
-            magma_zpotri_gpu( opts.uplo, N, d_A, ldda, &info );
-            gpu_time = magma_wtime() - gpu_time;
+            magma_timing gpu_times = magma_repeat( opts,
+                [&]() { magma_zsetmatrix( N, N, h_L, lda, d_A, ldda, opts.queue ); },
+                [&]() {
+                    real_Double_t time = magma_wtime();
+                    magma_zpotri_gpu( opts.uplo, N, d_A, ldda, &info );
+                    return magma_wtime() - time;
+                });
+            gpu_time = gpu_times.minimum();
             gpu_perf = gflops / gpu_time;
+            results.add( "magma", gpu_times, gflops );
             if (info != 0) {
                 printf("magma_zpotri_gpu returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -87,12 +95,16 @@ int main( int argc, char** argv)
                Performs operation using LAPACK
                =================================================================== */
             if ( opts.lapack ) {
-                lapackf77_zpotrf( lapack_uplo_const(opts.uplo), &N, h_A, &lda, &info );
-                
-                cpu_time = magma_wtime();
-                lapackf77_zpotri( lapack_uplo_const(opts.uplo), &N, h_A, &lda, &info );
-                cpu_time = magma_wtime() - cpu_time;
+                magma_timing cpu_times = magma_repeat( opts,
+                    [&]() { lapackf77_zlacpy( MagmaFullStr, &N, &N, h_L, &lda, h_A, &lda ); },
+                    [&]() {
+                        real_Double_t time = magma_wtime();
+                        lapackf77_zpotri( lapack_uplo_const(opts.uplo), &N, h_A, &lda, &info );
+                        return magma_wtime() - time;
+                    });
+                cpu_time = cpu_times.minimum();
                 cpu_perf = gflops / cpu_time;
+                results.add( "cpu", cpu_times, gflops );
                 if (info != 0) {
                     printf("lapackf77_zpotri returned error %lld: %s.\n",
                            (long long) info, magma_strerror( info ));
@@ -109,6 +121,8 @@ int main( int argc, char** argv)
                        (long long) N, cpu_perf, cpu_time, gpu_perf, gpu_time,
                        error, (error < tol ? "ok" : "failed") );
                 status += ! (error < tol);
+                results.add( "error", error );
+                results.add( "status", (error < tol ? "ok" : "failed") );
             }
             else {
                 printf("%5lld     ---   (  ---  )   %7.2f (%7.2f)     ---\n",
@@ -116,8 +130,10 @@ int main( int argc, char** argv)
             }
             
             magma_free_cpu( h_A );
+            magma_free_cpu( h_L );
             magma_free_pinned( h_R );
             magma_free( d_A );
+            results.end_row();
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
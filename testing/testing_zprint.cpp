@@ -65,7 +65,7 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_zmalloc_cpu( &hA, lda *N ));
             TESTING_CHECK( magma_zmalloc( &dA, ldda*N ));
         
-            //lapackf77_zlarnv( &ione, ISEED, &size, hA );
+            //magma_zlarnv( ione, ISEED, size, hA );
             for( int j = 0; j < N; ++j ) {
                 for( int i = 0; i < M; ++i ) {
                     hA[i + j*lda] = MAGMA_Z_MAKE( i + j*0.01, 0. );
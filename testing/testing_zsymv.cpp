@@ -96,7 +96,7 @@ int main(int argc, char **argv)
             magmablas_zlaset( MagmaFull, ldda,   N, MAGMA_Z_NAN, MAGMA_Z_NAN, dA(0,0),  ldda,   opts.queue );
             
             /* Initialize the matrix */
-            lapackf77_zlarnv( &ione, ISEED, &sizeA, A );
+            magma_zlarnv( ione, ISEED, sizeA, A );
             magma_zmake_hermitian( N, A, lda );
             
             // should not use data from the opposite triangle -- fill with NAN to check
@@ -108,8 +108,8 @@ int main(int argc, char **argv)
                 lapackf77_zlaset( "Upper", &N1, &N1, &MAGMA_Z_NAN, &MAGMA_Z_NAN, &A[lda], &lda );
             }
             
-            lapackf77_zlarnv( &ione, ISEED, &sizeX, X );
-            lapackf77_zlarnv( &ione, ISEED, &sizeY, Y );
+            magma_zlarnv( ione, ISEED, sizeX, X );
+            magma_zlarnv( ione, ISEED, sizeY, Y );
             
             // for error checks
             // lanhe and lansy should be same
@@ -99,25 +99,15 @@ int main( int argc, char** argv)
             magma_zsetmatrix( N, M, h_B, ldb, d_B(0,0), lddb, opts.queue );
             
             /* =====================================================================
-               Performs operation using naive out-of-place algorithm
+               Performs operation using MAGMA's cache-oblivious CPU algorithm
                (LAPACK doesn't implement transpose)
                =================================================================== */
             cpu_time = magma_wtime();
-            //for( int j = 1; j < N-1; ++j ) {      // inset by 1 row & col
-            //    for( int i = 1; i < M-1; ++i ) {  // inset by 1 row & col
             if ( trans[itran] == MagmaTrans ) {
-                for( int j = 0; j < N; ++j ) {
-                    for( int i = 0; i < M; ++i ) {
-                        h_B[j + i*ldb] = h_A[i + j*lda];
-                    }
-                }
+                magma_ztranspose_cpu( M, N, h_A, lda, h_B, ldb );
             }
             else {
-                for( int j = 0; j < N; ++j ) {
-                    for( int i = 0; i < M; ++i ) {
-                        h_B[j + i*ldb] = conj( h_A[i + j*lda] );
-                    }
-                }
+                magma_ztranspose_conj_cpu( M, N, h_A, lda, h_B, ldb );
             }
             cpu_time = magma_wtime() - cpu_time;
             cpu_perf = gbytes / cpu_time;
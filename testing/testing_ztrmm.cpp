@@ -106,8 +106,8 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_zmalloc( &dB, lddb*N  ));
 
             /* Initialize the matrices */
-            lapackf77_zlarnv( &ione, ISEED, &sizeA, hA );
-            lapackf77_zlarnv( &ione, ISEED, &sizeB, hB );
+            magma_zlarnv( ione, ISEED, sizeA, hA );
+            magma_zlarnv( ione, ISEED, sizeB, hB );
 
             // for error checks
             double Anorm = lapackf77_zlantr( "F", lapack_uplo_const(opts.uplo),
@@ -110,8 +110,8 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_zmalloc( &d_B, lddb*N*batchCount  ) );
             
             /* Initialize the matrices */
-            lapackf77_zlarnv( &ione, ISEED, &sizeA, h_A );
-            lapackf77_zlarnv( &ione, ISEED, &sizeB, h_B );
+            magma_zlarnv( ione, ISEED, sizeA, h_A );
+            magma_zlarnv( ione, ISEED, sizeB, h_B );
 
             // Compute norms for error
             for (int s = 0; s < batchCount; ++s) {
@@ -157,8 +157,8 @@ int main( int argc, char** argv)
             magma_setvector(batchCount, sizeof(magma_int_t), h_lddb, 1, d_lddb, 1, opts.queue);
             
             /* Initialize the matrices */
-            lapackf77_zlarnv( &ione, ISEED, &total_sizeA_cpu, h_A );
-            lapackf77_zlarnv( &ione, ISEED, &total_sizeB_cpu, h_B );
+            magma_zlarnv( ione, ISEED, total_sizeA_cpu, h_A );
+            magma_zlarnv( ione, ISEED, total_sizeB_cpu, h_B );
 
             // Compute norms for error
             h_A_tmp = h_A;
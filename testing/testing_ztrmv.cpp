@@ -88,8 +88,8 @@ int main( int argc, char** argv)
             TESTING_CHECK( magma_zmalloc( &dx, N       ));
 
             /* Initialize the matrices */
-            lapackf77_zlarnv( &ione, ISEED, &sizeA, hA );
-            lapackf77_zlarnv( &ione, ISEED, &N, hx );
+            magma_zlarnv( ione, ISEED, sizeA, hA );
+            magma_zlarnv( ione, ISEED, N, hx );
 
             // for error checks
             double Anorm = lapackf77_zlange( "F", &N, &N,    hA, &lda, work );
@@ -122,7 +122,7 @@ int main( int argc, char** argv)
             lapackf77_zpotrf( lapack_uplo_const(opts.uplo), &Ak, hA, &lda, &info );
             assert( info == 0 );
 
-            lapackf77_zlarnv( &ione, ISEED, &sizeB, hB );
+            magma_zlarnv( ione, ISEED, sizeB, hB );
             lapackf77_zlacpy( MagmaFullStr, &M, &N, hB, &ldb, hBlapack, &lda );
             magma_zsetmatrix( Ak, Ak, hA, lda, dA(0,0), ldda, opts.queue );
 
@@ -149,7 +149,7 @@ int main( int argc, char** argv)
             /* Factor A into LU to get well-conditioned triangular matrix.
              * Copy L to U, since L seems okay when used with non-unit diagonal
              * (i.e., from U), while U fails when used with unit diagonal. */
-            lapackf77_zlarnv( &ione, ISEED, &sizeA, h_A );
+            magma_zlarnv( ione, ISEED, sizeA, h_A );
 
             for (int s=0; s < batchCount; s++) {
                 lapackf77_zgetrf( &Ak, &Ak, h_A + s*lda*Ak, &lda, ipiv, &info );
@@ -160,7 +160,7 @@ int main( int argc, char** argv)
                 }
             }
 
-            lapackf77_zlarnv( &ione, ISEED, &sizeB, h_B );
+            magma_zlarnv( ione, ISEED, sizeB, h_B );
             memcpy( h_Blapack, h_B, sizeB*sizeof(magmaDoubleComplex) );
 
             /* =====================================================================
@@ -228,7 +228,7 @@ int main( int argc, char** argv)
             /* Factor A into LU to get well-conditioned triangular matrix.
              * Copy L to U, since L seems okay when used with non-unit diagonal
              * (i.e., from U), while U fails when used with unit diagonal. */
-            lapackf77_zlarnv( &ione, ISEED, &total_size_A_cpu, h_A );
+            magma_zlarnv( ione, ISEED, total_size_A_cpu, h_A );
             h_A_tmp = h_A;
             for (int k=0; k < batchCount; k++) {
                 lapackf77_zgetrf( &Ak[k], &Ak[k], h_A_tmp, &h_lda[k], ipiv, &info );
@@ -239,7 +239,7 @@ int main( int argc, char** argv)
                 }
                 h_A_tmp += Ak[k] * h_lda[k];
             }
-            lapackf77_zlarnv( &ione, ISEED, &total_size_B_cpu, h_B );
+            magma_zlarnv( ione, ISEED, total_size_B_cpu, h_B );
             memcpy( h_Blapack, h_B, total_size_B_cpu*sizeof(magmaDoubleComplex) );
 
             /* =====================================================================
@@ -96,7 +96,7 @@ int main( int argc, char** argv)
             lapackf77_zpotrf( lapack_uplo_const(opts.uplo), &N, hA, &lda, &info );
             assert( info == 0 );
 
-            lapackf77_zlarnv( &ione, ISEED, &N, hb );
+            magma_zlarnv( ione, ISEED, N, hb );
             blasf77_zcopy( &N, hb, &ione, hx, &ione );
 
             /* =====================================================================
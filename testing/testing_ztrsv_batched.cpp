@@ -115,7 +115,7 @@ int main( int argc, char** argv)
             /* Factor A into LU to get well-conditioned triangular matrix.
              * Copy L to U, since L seems okay when used with non-unit diagonal
              * (i.e., from U), while U fails when used with unit diagonal. */
-            lapackf77_zlarnv( &ione, ISEED, &sizeA, h_A );
+            magma_zlarnv( ione, ISEED, sizeA, h_A );
 
             for (s=0; s < batchCount; s++) {
                 magmaDoubleComplex* hAs = h_A + s * lda * Ak;
@@ -127,7 +127,7 @@ int main( int argc, char** argv)
                 }
             }
 
-            lapackf77_zlarnv( &ione, ISEED, &sizeB, h_b );
+            magma_zlarnv( ione, ISEED, sizeB, h_b );
             memcpy( h_blapack, h_b, sizeB*sizeof(magmaDoubleComplex) );
 
             /* =====================================================================
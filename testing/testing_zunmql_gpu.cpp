@@ -99,7 +99,7 @@ int main( int argc, char** argv )
             
             // C is full, m x n
             size = ldc*n;
-            lapackf77_zlarnv( &ione, ISEED, &size, C );
+            magma_zlarnv( ione, ISEED, size, C );
             magma_zsetmatrix( m, n, C, ldc, dC, ldc, opts.queue );
             
             // A is mm x k
@@ -31,6 +31,7 @@
 #include "magma_lapack.h"
 #include "magma_lapack.hpp"  // C++ bindings; need traits
 #include "magma_matrix.hpp"  // experimental Matrix and Vector classes
+#include "../control/magma_timer.h"  // internal header; magma_counters_t
 #include "testing_s.h"
 #include "testing_d.h"
 #include "testing_c.h"
@@ -163,6 +164,12 @@ typedef enum {
     MagmaSVD_max
 } magma_svd_work_t;
 
+typedef enum {
+    MagmaOutputText,   // hand-formatted table only (default)
+    MagmaOutputJson,   // also write results as JSON to opts.output_file
+    MagmaOutputCsv     // also write results as CSV  to opts.output_file
+} magma_output_t;
+
 class magma_opts
 {
 public:
@@ -211,6 +218,7 @@ public:
     magma_int_t version;
     magma_int_t check;
     magma_int_t verbose;
+    magma_int_t repeat;    // timed runs per test; see magma_repeat
     
     // ranges for eigen/singular values (gesvdx, heevdx, ...)
     double      fraction_lo;
@@ -226,6 +234,13 @@ public:
     bool magma;
     bool lapack;
     bool warmup;
+    bool flush;       // flush cache before each timed run in magma_repeat; default false
+    bool counters;    // read hardware counters in magma_repeat; see magma_counters_t
+
+    // machine-readable output; see magma_results
+    magma_output_t  output;
+    std::string     output_file;
+    std::string     command;     // command line, for the results metadata
     
     // lapack options
     magma_uplo_t    uplo;
@@ -247,6 +262,7 @@ public:
     double      cond;
     double      condD;
     magma_int_t iseed[4];
+    std::string matrix_cache;  // directory for generated svd, heev, poev matrices
 
     // queue for default device
     magma_queue_t   queue;
@@ -262,6 +278,164 @@ public:
 
 extern const char* g_platform_str;
 
+
+/***************************************************************************//**
+    Timings of the repeated runs of one test, with their statistics, and
+    with --counters, the hardware counters of each run.
+    Filled by magma_repeat; reported by magma_results.
+*******************************************************************************/
+class magma_timing
+{
+public:
+    void add( double time ) { times.push_back( time ); }
+
+    void add( double time, const magma_counters_t& c )
+    {
+        times.push_back( time );
+        counters.push_back( c );
+    }
+
+    magma_int_t count() const { return magma_int_t( times.size() ); }
+    double minimum() const;
+    double median()  const;
+    double mean()    const;
+    double stddev()  const;
+
+    // counters of the fastest run, or NULL without --counters
+    const magma_counters_t* fastest_counters() const;
+
+    std::vector< double > times;
+    std::vector< magma_counters_t > counters;
+};
+
+
+/***************************************************************************//**
+    Runs a test opts.repeat times and returns the timings.
+    Before each run, setup() restores the inputs (untimed), then the cache is
+    flushed if opts.flush; run() does the timed operation and returns its time
+    in seconds. With opts.warmup, one extra run is done first and discarded.
+    With opts.counters, hardware counters are also read around each run().
+
+    Only gemm and the dense factorization and solve testers (getrf, potrf,
+    geqrf, gelqf, geqlf, geqp3, gesv, posv, gels, getri, potri, and their
+    _gpu and _mgpu variants) use magma_repeat and magma_results; the other
+    testers time one run and ignore --repeat, --flush, --counters, and
+    --output.
+
+    Example, for a factorization that overwrites A:
+
+        magma_timing t = magma_repeat( opts,
+            [&]() { init_matrix( opts, M, N, h_A, lda ); },
+            [&]() {
+                real_Double_t time = magma_wtime();
+                magma_zgetrf( M, N, h_A, lda, ipiv, &info );
+                return magma_wtime() - time;
+            });
+*******************************************************************************/
+template< typename Setup, typename Run >
+magma_timing magma_repeat( magma_opts& opts, Setup setup, Run run )
+{
+    magma_timing timing;
+    magma_int_t nruns = opts.repeat + (opts.warmup ? 1 : 0);
+    for( magma_int_t r = 0; r < nruns; ++r ) {
+        setup();
+        if ( opts.flush ) {
+            magma_flush_cache( opts.cache );
+        }
+        magma_counters_t c = { -1, -1, -1, -1 };
+        if ( opts.counters ) {
+            magma_counters_read( &c );
+        }
+        double time = run();
+        if ( opts.counters ) {
+            magma_counters_t end;
+            magma_counters_read( &end );
+            magma_counters_sub( c, end );
+        }
+        if ( ! (opts.warmup && r == 0) ) {
+            if ( opts.counters )
+                timing.add( time, c );
+            else
+                timing.add( time );
+        }
+    }
+    return timing;
+}
+
+// for operations that don't overwrite their inputs
+template< typename Run >
+magma_timing magma_repeat( magma_opts& opts, Run run )
+{
+    return magma_repeat( opts, [](){}, run );
+}
+
+
+/***************************************************************************//**
+    Shared emitter for machine-readable results, used by the BLAS, dense
+    factorization, and solve testers so runs can be diffed automatically. With --output json or csv, each row of the
+    tester's table is also written to opts.output_file, along with host
+    metadata (MAGMA version, platform, device, CPU model, threads, BLAS).
+    With the default --output text, all calls are no-ops, except that with
+    --counters, end_row() prints the hardware counter rates of each timing
+    below the tester's row.
+
+    Usage, once per row:
+
+        magma_results results( opts, "zgetrf" );
+        ...
+        results.add( "M", M );
+        results.add( "N", N );
+        results.add( "magma", magma_timing, gflops );  // time and Gflop/s stats
+        results.add( "error", error );
+        results.add( "status", okay ? "ok" : "failed" );
+        results.end_row();
+
+    The JSON file is a single object, { "routine", "command", "host", "results" },
+    where results is an array of one object per row. The CSV file starts with
+    the metadata as "# key: value" comment lines, followed by a header taken
+    from the keys of the first row.
+*******************************************************************************/
+class magma_results
+{
+public:
+    magma_results( magma_opts& opts, const char* routine );
+    ~magma_results();
+
+    void add( const char* key, magma_int_t value );
+    void add( const char* key, double value );
+    void add( const char* key, const char* value );
+
+    // adds key_time_{min,median,mean,stddev} in seconds, key_nrepeat, and
+    // key_gflops_{max,median}, i.e., Gflop/s of the fastest and median run.
+    // If gflop is 0, the Gflop/s entries are omitted.
+    // With --counters, also adds the fastest run's counters,
+    // key_{cycles,instructions,llc_misses,fp_ops}, and the rates
+    // key_hw_gflops (from fp_ops) and key_bytes_per_flop (LLC miss traffic
+    // per flop; uses gflop if fp_ops is unavailable).
+    void add( const char* key, const magma_timing& timing, double gflop=0 );
+
+    void end_row();
+
+private:
+    struct entry {
+        std::string key;
+        std::string value;
+        bool        quoted;   // string value, vs. number
+    };
+
+    void add_entry( const char* key, const std::string& value, bool quoted );
+    void write_header( magma_opts& opts );
+
+    magma_output_t output;
+    bool  counters;
+    FILE* file;
+    std::string routine;
+    magma_int_t nrows;
+    std::vector< std::string > keys;    // CSV header, from the first row
+    std::vector< entry > row;
+    std::vector< std::string > counter_lines;  // printed by end_row
+};
+
 // -----------------------------------------------------------------------------
 template< typename FloatT >
 void magma_generate_matrix(
@@ -624,6 +624,8 @@ subs = {
     ('sptfqmr',        'dptfqmr',        'cptfqmr',        'zptfqmr'         ),
     ('spcg',           'dpcg',           'cpcg',           'zpcg'            ),
     ('sbpcg',          'dbpcg',          'cbpcg',          'zbpcg'           ),
+    ('sbcg',           'dbcg',           'cbcg',           'zbcg'            ),
+    ('sbbicgstab',     'dbbicgstab',     'cbbicgstab',     'zbbicgstab'      ),
     ('spbicg',         'dpbicg',         'cpbicg',         'zpbicg'          ),
     ('spgmres',        'dpgmres',        'cpgmres',        'zpgmres'         ),
     ('sfgmres',        'dfgmres',        'cfgmres',        'zfgmres'         ),
@@ -647,6 +649,7 @@ subs = {
     ('scustom',        'dcustom',        'ccustom',        'zcustom'         ),
     ('sparilu',        'dparilu',        'cparilu',        'zparilu'         ),
     ('sparic',         'dparic',         'cparic',         'zparic'          ),
+    ('sschwarz',       'dschwarz',       'cschwarz',       'zschwarz'        ),
 
     # ----- SPARSE Iterative Eigensolvers
     ('slobpcg',        'dlobpcg',        'clobpcg',        'zlobpcg'         ),
@@ -660,6 +663,7 @@ subs = {
     # ----- SPARSE auxiliary tools
     ('matrix_s',       'matrix_d',       'matrix_c',       'matrix_z'        ),
     ('svjacobi',       'dvjacobi',       'cvjacobi',       'zvjacobi'        ),
+    ('svbjacobi',      'dvbjacobi',      'cvbjacobi',      'zvbjacobi'       ),
     ('s_csr2array',    'd_csr2array',    'c_csr2array',    'z_csr2array'     ),
     ('s_array2csr',    'd_array2csr',    'c_array2csr',    'z_array2csr'     ),
     ('read_s_csr',     'read_d_csr',     'read_c_csr',     'read_z_csr'      ),